@@ -1,5 +1,6 @@
 ﻿using System;
 using System.IO;
+using System.Buffers;
 using System.Text;
 using System.Reflection;
 using System.Security.Cryptography;
@@ -228,6 +229,41 @@ namespace GlitchedPolygons.CeciesSharp
             ref ulong outputLength
         );
 
+        private delegate int CeciesContextCreateDelegate(
+            out IntPtr context,
+            byte[] publicKey,
+            UIntPtr publicKeyLength,
+            byte[] privateKey,
+            UIntPtr privateKeyLength,
+            [MarshalAs(UnmanagedType.I4)] int headerFlags
+        );
+
+        internal delegate void CeciesContextFreeDelegate(IntPtr context);
+
+        internal delegate UIntPtr CeciesContextGetEncryptedSizeDelegate(IntPtr context, UIntPtr dataLength);
+
+        internal delegate UIntPtr CeciesContextGetDecryptedSizeDelegate(IntPtr context, ref byte encryptedData, UIntPtr encryptedDataLength);
+
+        internal delegate int CeciesContextIntoDelegate(
+            IntPtr context,
+            ref byte input,
+            UIntPtr inputLength,
+            ref byte output,
+            UIntPtr outputSize,
+            out UIntPtr outputLength
+        );
+
+        internal delegate int CeciesContextBatchDelegate(
+            IntPtr context,
+            ref byte input,
+            ref UIntPtr inputLengths,
+            UIntPtr count,
+            ref byte output,
+            UIntPtr outputSize,
+            ref UIntPtr outputLengths,
+            ref int results
+        );
+
         private CeciesFreeDelegate ceciesFreeDelegate;
         private CeciesEnableFprintfDelegate ceciesEnableFprintfDelegate;
         private CeciesDisableFprintfDelegate ceciesDisableFprintfDelegate;
@@ -240,6 +276,15 @@ namespace GlitchedPolygons.CeciesSharp
         private CeciesGenerateKeypairCurve448Delegate ceciesGenerateKeypairCurve448Delegate;
         private CeciesEncryptCurve448Delegate ceciesEncryptCurve448Delegate;
         private CeciesDecryptCurve448Delegate ceciesDecryptCurve448Delegate;
+        private CeciesContextCreateDelegate ceciesContextCreateCurve25519Delegate;
+        private CeciesContextCreateDelegate ceciesContextCreateCurve448Delegate;
+        internal CeciesContextFreeDelegate ceciesContextFreeDelegate;
+        internal CeciesContextGetEncryptedSizeDelegate ceciesContextGetEncryptedSizeDelegate;
+        internal CeciesContextGetDecryptedSizeDelegate ceciesContextGetDecryptedSizeDelegate;
+        internal CeciesContextIntoDelegate ceciesContextEncryptIntoDelegate;
+        internal CeciesContextIntoDelegate ceciesContextDecryptIntoDelegate;
+        internal CeciesContextBatchDelegate ceciesContextEncryptBatchDelegate;
+        internal CeciesContextBatchDelegate ceciesContextDecryptBatchDelegate;
 
         #endregion
 
@@ -251,6 +296,11 @@ namespace GlitchedPolygons.CeciesSharp
         /// </summary>
         public string LoadedLibraryPath { get; }
 
+        /// <summary>
+        /// Whether the loaded CECIES shared library exports the key context API (<see cref="CreateKeyContextCurve25519"/> and <see cref="CreateKeyContextCurve448"/>). Older builds of the library don't.
+        /// </summary>
+        public bool KeyContextsSupported { get; }
+
         /// <summary>
         /// Creates a new CeciesSharp instance. <para> </para>
         /// Make sure to create one only once and cache it as needed, since loading the DLLs into memory could be, well, not so performant.
@@ -396,6 +446,27 @@ namespace GlitchedPolygons.CeciesSharp
                 goto hell;
             }
 
+            // The key context API (interop.h) is newer than the rest: shared libraries built before it was added don't export it, and that's fine as long as no key contexts are used.
+            IntPtr ctxCreate25519 = TryGetProcAddress("cecies_curve25519_context_create");
+            IntPtr ctxCreate448 = TryGetProcAddress("cecies_curve448_context_create");
+            IntPtr ctxFree = TryGetProcAddress("cecies_context_free");
+            IntPtr ctxEncryptedSize = TryGetProcAddress("cecies_context_get_encrypted_size");
+            IntPtr ctxDecryptedSize = TryGetProcAddress("cecies_context_get_decrypted_size");
+            IntPtr ctxEncryptInto = TryGetProcAddress("cecies_context_encrypt_into");
+            IntPtr ctxDecryptInto = TryGetProcAddress("cecies_context_decrypt_into");
+            IntPtr ctxEncryptBatch = TryGetProcAddress("cecies_context_encrypt_batch");
+            IntPtr ctxDecryptBatch = TryGetProcAddress("cecies_context_decrypt_batch");
+
+            KeyContextsSupported = ctxCreate25519 != IntPtr.Zero
+                && ctxCreate448 != IntPtr.Zero
+                && ctxFree != IntPtr.Zero
+                && ctxEncryptedSize != IntPtr.Zero
+                && ctxDecryptedSize != IntPtr.Zero
+                && ctxEncryptInto != IntPtr.Zero
+                && ctxDecryptInto != IntPtr.Zero
+                && ctxEncryptBatch != IntPtr.Zero
+                && ctxDecryptBatch != IntPtr.Zero;
+
             ceciesFreeDelegate = Marshal.GetDelegateForFunctionPointer<CeciesFreeDelegate>(free);
             ceciesEnableFprintfDelegate = Marshal.GetDelegateForFunctionPointer<CeciesEnableFprintfDelegate>(enableFprintf);
             ceciesDisableFprintfDelegate = Marshal.GetDelegateForFunctionPointer<CeciesDisableFprintfDelegate>(disableFprintf);
@@ -408,6 +479,18 @@ namespace GlitchedPolygons.CeciesSharp
             ceciesGenerateKeypairCurve448Delegate = Marshal.GetDelegateForFunctionPointer<CeciesGenerateKeypairCurve448Delegate>(gen448);
             ceciesEncryptCurve448Delegate = Marshal.GetDelegateForFunctionPointer<CeciesEncryptCurve448Delegate>(enc448);
             ceciesDecryptCurve448Delegate = Marshal.GetDelegateForFunctionPointer<CeciesDecryptCurve448Delegate>(dec448);
+            if (KeyContextsSupported)
+            {
+                ceciesContextCreateCurve25519Delegate = Marshal.GetDelegateForFunctionPointer<CeciesContextCreateDelegate>(ctxCreate25519);
+                ceciesContextCreateCurve448Delegate = Marshal.GetDelegateForFunctionPointer<CeciesContextCreateDelegate>(ctxCreate448);
+                ceciesContextFreeDelegate = Marshal.GetDelegateForFunctionPointer<CeciesContextFreeDelegate>(ctxFree);
+                ceciesContextGetEncryptedSizeDelegate = Marshal.GetDelegateForFunctionPointer<CeciesContextGetEncryptedSizeDelegate>(ctxEncryptedSize);
+                ceciesContextGetDecryptedSizeDelegate = Marshal.GetDelegateForFunctionPointer<CeciesContextGetDecryptedSizeDelegate>(ctxDecryptedSize);
+                ceciesContextEncryptIntoDelegate = Marshal.GetDelegateForFunctionPointer<CeciesContextIntoDelegate>(ctxEncryptInto);
+                ceciesContextDecryptIntoDelegate = Marshal.GetDelegateForFunctionPointer<CeciesContextIntoDelegate>(ctxDecryptInto);
+                ceciesContextEncryptBatchDelegate = Marshal.GetDelegateForFunctionPointer<CeciesContextBatchDelegate>(ctxEncryptBatch);
+                ceciesContextDecryptBatchDelegate = Marshal.GetDelegateForFunctionPointer<CeciesContextBatchDelegate>(ctxDecryptBatch);
+            }
 
             EnableConsoleLogging();
 
@@ -417,6 +500,18 @@ namespace GlitchedPolygons.CeciesSharp
             throw new Exception($"Failed to load one or more functions from the CECIES shared library \"{LoadedLibraryPath}\"!");
         }
 
+        private IntPtr TryGetProcAddress(string name)
+        {
+            try
+            {
+                return loadUtils.GetProcAddress(lib, name);
+            }
+            catch (Exception)
+            {
+                return IntPtr.Zero;
+            }
+        }
+
         /// <summary>
         /// Frees unmanaged resources (unloads the CECIES shared lib/dll).
         /// </summary>
@@ -620,6 +715,182 @@ namespace GlitchedPolygons.CeciesSharp
             ceciesFreeDelegate(output);
             return o;
         }
+
+        private CeciesSharpKeyContext CreateKeyContext(CeciesContextCreateDelegate create, string publicKey, string privateKey, int headerFlags)
+        {
+            if (!KeyContextsSupported)
+            {
+                throw new NotSupportedException($"The CECIES shared library \"{LoadedLibraryPath}\" doesn't export the key context API (cecies_*_context_*): please update it to a build that does.");
+            }
+
+            byte[] pub = publicKey is null ? null : Encoding.ASCII.GetBytes(publicKey);
+            byte[] prv = privateKey is null ? null : Encoding.ASCII.GetBytes(privateKey);
+
+            int r = create(out IntPtr context, pub, (UIntPtr)(pub?.Length ?? 0), prv, (UIntPtr)(prv?.Length ?? 0), headerFlags);
+
+            if (prv != null)
+            {
+                Array.Clear(prv, 0, prv.Length);
+            }
+
+            return r == 0 ? new CeciesSharpKeyContext(this, context) : null;
+        }
+
+        /// <summary>
+        /// Creates a reusable Curve25519 key context: the keys are parsed and validated only once, and the context's methods en-/decrypt directly from and into your own (<see cref="Span{T}"/>) memory without any copying or allocating. <para> </para>
+        /// A key context is NOT thread-safe: use one per thread.
+        /// </summary>
+        /// <param name="publicKey">[OPTIONAL] The public key to encrypt with (hex-formatted). Pass <c>null</c> for a decryption-only context.</param>
+        /// <param name="privateKey">[OPTIONAL] The private key to decrypt with (hex-formatted). Pass <c>null</c> for an encryption-only context.</param>
+        /// <param name="headerFlags">Which optional fields to embed into the extended header of the ciphertexts (<c>0x02</c> for the key ID and/or <c>0x04</c> for a key commitment value), or <c>0</c> for the plain ciphertext format.</param>
+        /// <returns><c>null</c> if the context couldn't be created (check the stderr console output in this case for more details); the key context otherwise (don't forget to dispose it!).</returns>
+        /// <exception cref="NotSupportedException">The loaded shared library doesn't export the key context API (see <see cref="KeyContextsSupported"/>).</exception>
+        public CeciesSharpKeyContext CreateKeyContextCurve25519(string publicKey, string privateKey, int headerFlags = 0)
+        {
+            return CreateKeyContext(ceciesContextCreateCurve25519Delegate, publicKey, privateKey, headerFlags);
+        }
+
+        /// <summary>
+        /// Creates a reusable Curve448 key context: the keys are parsed and validated only once, and the context's methods en-/decrypt directly from and into your own (<see cref="Span{T}"/>) memory without any copying or allocating. <para> </para>
+        /// A key context is NOT thread-safe: use one per thread.
+        /// </summary>
+        /// <param name="publicKey">[OPTIONAL] The public key to encrypt with (hex-formatted). Pass <c>null</c> for a decryption-only context.</param>
+        /// <param name="privateKey">[OPTIONAL] The private key to decrypt with (hex-formatted). Pass <c>null</c> for an encryption-only context.</param>
+        /// <param name="headerFlags">Which optional fields to embed into the extended header of the ciphertexts (<c>0x02</c> for the key ID and/or <c>0x04</c> for a key commitment value), or <c>0</c> for the plain ciphertext format.</param>
+        /// <returns><c>null</c> if the context couldn't be created (check the stderr console output in this case for more details); the key context otherwise (don't forget to dispose it!).</returns>
+        /// <exception cref="NotSupportedException">The loaded shared library doesn't export the key context API (see <see cref="KeyContextsSupported"/>).</exception>
+        public CeciesSharpKeyContext CreateKeyContextCurve448(string publicKey, string privateKey, int headerFlags = 0)
+        {
+            return CreateKeyContext(ceciesContextCreateCurve448Delegate, publicKey, privateKey, headerFlags);
+        }
+    }
+
+    /// <summary>
+    /// Parsed CECIES keys for en-/decrypting many messages in a row (wraps the native <c>cecies_context</c> from <c>interop.h</c>). <para> </para>
+    /// Create one using <see cref="CeciesSharpContext.CreateKeyContextCurve25519"/> or <see cref="CeciesSharpContext.CreateKeyContextCurve448"/>.
+    /// The ciphertexts are binary and not compressed; decryption returns the payload as-is (so don't use it for ciphertexts that were compressed).
+    /// </summary>
+    public class CeciesSharpKeyContext : IDisposable
+    {
+        private readonly CeciesSharpContext cecies;
+        private IntPtr context;
+
+        internal CeciesSharpKeyContext(CeciesSharpContext cecies, IntPtr context)
+        {
+            this.cecies = cecies;
+            this.context = context;
+        }
+
+        /// <summary>
+        /// Frees the native context (and wipes the keys it holds).
+        /// </summary>
+        public void Dispose()
+        {
+            if (context != IntPtr.Zero)
+            {
+                cecies.ceciesContextFreeDelegate(context);
+                context = IntPtr.Zero;
+            }
+        }
+
+        /// <summary>
+        /// Gets the exact ciphertext length for a message of the given length. The per-message overhead is constant: <c>GetEncryptedSize(0)</c>.
+        /// </summary>
+        public int GetEncryptedSize(int dataLength)
+        {
+            return (int)cecies.ceciesContextGetEncryptedSizeDelegate(context, (UIntPtr)dataLength);
+        }
+
+        /// <summary>
+        /// Gets the exact plaintext length of the given ciphertext (only the header is parsed), or <c>0</c> if the ciphertext is invalid.
+        /// </summary>
+        public int GetDecryptedSize(ReadOnlySpan<byte> encryptedData)
+        {
+            return (int)cecies.ceciesContextGetDecryptedSizeDelegate(context, ref MemoryMarshal.GetReference(encryptedData), (UIntPtr)encryptedData.Length);
+        }
+
+        /// <summary>
+        /// Encrypts <paramref name="data"/> straight into <paramref name="output"/> (which needs to be at least <see cref="GetEncryptedSize"/> bytes big).
+        /// </summary>
+        /// <returns><c>0</c> on success (<paramref name="written"/> then holds the ciphertext length); a CECIES/MbedTLS error code otherwise.</returns>
+        public int EncryptInto(ReadOnlySpan<byte> data, Span<byte> output, out int written)
+        {
+            int r = cecies.ceciesContextEncryptIntoDelegate(context, ref MemoryMarshal.GetReference(data), (UIntPtr)data.Length, ref MemoryMarshal.GetReference(output), (UIntPtr)output.Length, out UIntPtr olen);
+            written = r == 0 ? (int)olen : 0;
+            return r;
+        }
+
+        /// <summary>
+        /// Decrypts <paramref name="encryptedData"/> straight into <paramref name="output"/> (which needs to be at least <see cref="GetDecryptedSize"/> bytes big).
+        /// </summary>
+        /// <returns><c>0</c> on success (<paramref name="written"/> then holds the plaintext length); a CECIES/MbedTLS error code otherwise.</returns>
+        public int DecryptInto(ReadOnlySpan<byte> encryptedData, Span<byte> output, out int written)
+        {
+            int r = cecies.ceciesContextDecryptIntoDelegate(context, ref MemoryMarshal.GetReference(encryptedData), (UIntPtr)encryptedData.Length, ref MemoryMarshal.GetReference(output), (UIntPtr)output.Length, out UIntPtr olen);
+            written = r == 0 ? (int)olen : 0;
+            return r;
+        }
+
+        /// <summary>
+        /// Encrypts a whole batch of messages with one native call. <para> </para>
+        /// The messages are read back to back from <paramref name="input"/> and their ciphertexts are written back to back into <paramref name="output"/>
+        /// (for everything to fit, that's <c>input.Length + inputLengths.Length * GetEncryptedSize(0)</c> bytes). A failing message gets an output length of <c>0</c> and its error code in <paramref name="results"/>.
+        /// </summary>
+        /// <returns><c>0</c> if all messages were encrypted; the error code of the first failed message otherwise.</returns>
+        public int EncryptBatch(ReadOnlySpan<byte> input, ReadOnlySpan<int> inputLengths, Span<byte> output, Span<int> outputLengths, Span<int> results)
+        {
+            return Batch(cecies.ceciesContextEncryptBatchDelegate, input, inputLengths, output, outputLengths, results);
+        }
+
+        /// <summary>
+        /// Decrypts a whole batch of ciphertexts with one native call. <para> </para>
+        /// The ciphertexts are read back to back from <paramref name="input"/> and their plaintexts are written back to back into <paramref name="output"/>
+        /// (<c>input.Length</c> bytes are always enough). A failing ciphertext gets an output length of <c>0</c> and its error code in <paramref name="results"/>.
+        /// </summary>
+        /// <returns><c>0</c> if all ciphertexts were decrypted; the error code of the first failed ciphertext otherwise.</returns>
+        public int DecryptBatch(ReadOnlySpan<byte> input, ReadOnlySpan<int> inputLengths, Span<byte> output, Span<int> outputLengths, Span<int> results)
+        {
+            return Batch(cecies.ceciesContextDecryptBatchDelegate, input, inputLengths, output, outputLengths, results);
+        }
+
+        private int Batch(CeciesSharpContext.CeciesContextBatchDelegate batch, ReadOnlySpan<byte> input, ReadOnlySpan<int> inputLengths, Span<byte> output, Span<int> outputLengths, Span<int> results)
+        {
+            int count = inputLengths.Length;
+
+            if (count == 0)
+            {
+                return 0;
+            }
+
+            if (outputLengths.Length < count || results.Length < count)
+            {
+                throw new ArgumentException("The outputLengths and results spans need as many entries as there are inputLengths.");
+            }
+
+            // size_t on the native side: converted through pooled arrays, so that batching doesn't allocate either.
+            UIntPtr[] lengths = ArrayPool<UIntPtr>.Shared.Rent(count * 2);
+
+            try
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    lengths[i] = (UIntPtr)inputLengths[i];
+                }
+
+                int r = batch(context, ref MemoryMarshal.GetReference(input), ref lengths[0], (UIntPtr)count, ref MemoryMarshal.GetReference(output), (UIntPtr)output.Length, ref lengths[count], ref MemoryMarshal.GetReference(results));
+
+                for (int i = 0; i < count; ++i)
+                {
+                    outputLengths[i] = (int)lengths[count + i];
+                }
+
+                return r;
+            }
+            finally
+            {
+                ArrayPool<UIntPtr>.Shared.Return(lengths);
+            }
+        }
     }
 
     //  --------------------------------------------------------------------
@@ -661,6 +932,18 @@ namespace GlitchedPolygons.CeciesSharp
             Console.WriteLine($"Decrypt Curve25519: {decStr25519}");
             Console.WriteLine($"Decrypt Curve448: {decStr448}");
 
+            // Key contexts parse the keys only once and work on spans (e.g. pooled or stackalloc'ed buffers): nothing gets allocated or copied per message.
+            using (CeciesSharpKeyContext keyContext = cecies.CreateKeyContextCurve448(keyPair448.Item1, keyPair448.Item2))
+            {
+                Span<byte> ciphertext = stackalloc byte[keyContext.GetEncryptedSize(plaintext.Length)];
+                Span<byte> decrypted = stackalloc byte[plaintext.Length];
+
+                if (keyContext.EncryptInto(plaintext, ciphertext, out int ciphertextLength) == 0 && keyContext.DecryptInto(ciphertext.Slice(0, ciphertextLength), decrypted, out int decryptedLength) == 0)
+                {
+                    Console.WriteLine($"Key context roundtrip (Curve448): {Encoding.UTF8.GetString(decrypted.Slice(0, decryptedLength))}");
+                }
+            }
+
             cecies.DisableConsoleLogging();
 
             Console.WriteLine("Allow fprintf: " + cecies.IsConsoleLoggingEnabled());
@@ -0,0 +1,90 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/**
+ *  @file alloc.h
+ *  @author Raphael Beck
+ *  @brief Custom allocator hooks, a built-in per-thread pool allocator and allocation counters.
+ */
+
+#ifndef CECIES_ALLOC_H
+#define CECIES_ALLOC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "types.h"
+
+/**
+ * Allocation counters of the calling thread (see cecies_get_alloc_stats()).
+ */
+typedef struct cecies_alloc_stats
+{
+    /** How many allocations were made. */
+    uint64_t allocations;
+
+    /** How many allocations were freed. */
+    uint64_t frees;
+
+    /** How many bytes were requested in total (over all allocations, not the amount currently in use). */
+    uint64_t bytes_allocated;
+} cecies_alloc_stats;
+
+/**
+ * Replaces the functions that CECIES uses for all of its heap allocations: the output buffers it returns, its internal buffers, zlib's state
+ * and, if MbedTLS was built with <c>MBEDTLS_PLATFORM_MEMORY</c> (the default when building MbedTLS as part of CECIES), MbedTLS' own allocations too (e.g. the MPI limbs during scalar multiplication). <p>
+ * Buffers that CECIES returns while a custom allocator is set must be freed using cecies_free() (not <c>free()</c>): CECIES keeps track of those blocks,
+ * so switching allocators while buffers are still alive is fine (cecies_free() hands each block back to the free function of the allocator that allocated it).
+ * The first call routes MbedTLS' allocations through CECIES for the rest of the process; blocks that MbedTLS allocated before that are still freed using <c>free()</c>.
+ * The functions need to be thread-safe if CECIES is used from multiple threads.
+ * @param malloc_func Replacement for <c>malloc()</c>.
+ * @param calloc_func Replacement for <c>calloc()</c>.
+ * @param free_func Replacement for <c>free()</c>.
+ * If any of these is <c>NULL</c>, the C standard library's allocator is restored.
+ */
+CECIES_API void cecies_set_allocator(void* (*malloc_func)(size_t), void* (*calloc_func)(size_t, size_t), void (*free_func)(void*));
+
+/**
+ * Makes CECIES use its built-in pool allocator (see cecies_set_allocator() for when to call this). <p>
+ * Every thread keeps its own free lists of size classes (16 bytes up to 64 KiB), so allocations don't contend on a global heap lock.
+ * Blocks are carved out of 256 KiB slabs; freed blocks go back to the freeing thread's free list, surplus ones (and those of exited threads) to a shared depot. Slabs are never returned to the OS. <p>
+ * Bigger allocations are passed through to the system allocator.
+ * @param lock_pages If not \c 0, slabs and big allocations are locked into RAM (<c>mlock()</c> or <c>VirtualLock()</c>, as far as the process' limits allow)
+ * so that secret material never gets swapped to disk, and blocks are wiped when they're freed.
+ */
+CECIES_API void cecies_use_pool_allocator(int lock_pages);
+
+/**
+ * Gets the allocation counters of the calling thread: reset them using cecies_reset_alloc_stats() before an operation and read them afterwards to see what that operation allocated. <p>
+ * Allocations made on worker threads (see cecies_set_parallel_gcm() and cecies_set_parallel_compression()) are counted on those threads.
+ * @param stats Where to write the counters into.
+ */
+CECIES_API void cecies_get_alloc_stats(cecies_alloc_stats* stats);
+
+/**
+ * Resets the allocation counters of the calling thread to zero.
+ */
+CECIES_API void cecies_reset_alloc_stats(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // CECIES_ALLOC_H
@@ -0,0 +1,213 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/**
+ *  @file async.h
+ *  @author Raphael Beck
+ *  @brief Asynchronous en-/decryption: jobs are submitted to a worker pool without blocking and signal their completion through callbacks, polling or an eventfd.
+ */
+
+#ifndef CECIES_ASYNC_H
+#define CECIES_ASYNC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "types.h"
+#include "constants.h"
+
+/**
+ * Opaque worker pool handle. Jobs are handed to the workers through a lock-free bounded multi-producer/multi-consumer queue,
+ * so any amount of threads can submit jobs concurrently without ever blocking on each other.
+ */
+typedef struct cecies_async_pool cecies_async_pool;
+
+/**
+ * Opaque handle to a submitted job.
+ */
+typedef struct cecies_async_job cecies_async_job;
+
+/**
+ * Completion callback: invoked on the worker thread that ran the job, right after it completed (successfully or not). <p>
+ * Use cecies_async_job_get_result() inside the callback to get the job's result and to take over its output buffer. Don't free the job from within its callback!
+ * @param job The job that completed.
+ * @param user_data The \p user_data pointer that was passed when submitting the job.
+ */
+typedef void (*cecies_async_callback)(cecies_async_job* job, void* user_data);
+
+/**
+ * Creates a worker pool.
+ * @param out_pool Where to write the pool handle into. Free it using cecies_async_pool_free() once you're done!
+ * @param thread_count How many worker threads to start. Pass <c>0</c> to start one per CPU core.
+ * @param queue_capacity How many jobs can be queued up at most (rounded up to the next power of 2). Pass <c>0</c> for #CECIES_ASYNC_DEFAULT_QUEUE_CAPACITY.
+ * @param notify_fd [POSIX only] A file descriptor (e.g. from <c>eventfd()</c>) to which an 8-byte <c>1</c> counter value is written every time a job completes, so that an event loop can wait on it. Pass <c>-1</c> if you don't need this.
+ * @return <c>0</c> on success; <c>CECIES_ASYNC_ERROR_CODE_*</c> error codes otherwise.
+ */
+CECIES_API int cecies_async_pool_create(cecies_async_pool** out_pool, size_t thread_count, size_t queue_capacity, int notify_fd);
+
+/**
+ * Completes all jobs that are still queued up, then stops the workers and frees the pool.
+ * @param pool The pool to free (passing <c>NULL</c> is a no-op).
+ */
+CECIES_API void cecies_async_pool_free(cecies_async_pool* pool);
+
+/**
+ * Submits an encryption job (ECIES over Curve25519 and AES256-GCM, exactly as cecies_curve25519_encrypt_ext() does it).
+ * @param pool The pool to run the job on.
+ * @param data The data to encrypt. This is NOT copied: it must stay valid (and unchanged) until the job has completed!
+ * @param data_length The length of the data array.
+ * @param compress Compression level between [0; 9] (\c 0 for no compression).
+ * @param public_key The public key to encrypt the data with (hex-string format).
+ * @param header_flags Extended header flags (see cecies_curve25519_encrypt_ext()). Pass \c 0 for the plain format.
+ * @param output_base64 Should the output be base64-encoded? Pass \c 0 for \c false, anything else for \c true.
+ * @param callback [OPTIONAL] Completion callback. Pass <c>NULL</c> if you'd rather poll or wait.
+ * @param user_data [OPTIONAL] Passed on to the \p callback as-is.
+ * @param out_job [OPTIONAL] Where to write the job handle into (free it using cecies_async_job_free() once you're done with it). If you pass <c>NULL</c>, the job frees itself right after its callback returned.
+ * @return <c>0</c> if the job was submitted; #CECIES_ASYNC_ERROR_CODE_QUEUE_FULL if the queue is full (try again later); other <c>CECIES_ASYNC_ERROR_CODE_*</c> error codes otherwise.
+ */
+CECIES_API int cecies_curve25519_encrypt_async(cecies_async_pool* pool, const uint8_t* data, size_t data_length, int compress, cecies_curve25519_key public_key, int header_flags, int output_base64, cecies_async_callback callback, void* user_data, cecies_async_job** out_job);
+
+/**
+ * Submits an encryption job (ECIES over Curve448 and AES256-GCM, exactly as cecies_curve448_encrypt_ext() does it).
+ * @param pool The pool to run the job on.
+ * @param data The data to encrypt. This is NOT copied: it must stay valid (and unchanged) until the job has completed!
+ * @param data_length The length of the data array.
+ * @param compress Compression level between [0; 9] (\c 0 for no compression).
+ * @param public_key The public key to encrypt the data with (hex-string format).
+ * @param header_flags Extended header flags (see cecies_curve448_encrypt_ext()). Pass \c 0 for the plain format.
+ * @param output_base64 Should the output be base64-encoded? Pass \c 0 for \c false, anything else for \c true.
+ * @param callback [OPTIONAL] Completion callback. Pass <c>NULL</c> if you'd rather poll or wait.
+ * @param user_data [OPTIONAL] Passed on to the \p callback as-is.
+ * @param out_job [OPTIONAL] Where to write the job handle into (free it using cecies_async_job_free() once you're done with it). If you pass <c>NULL</c>, the job frees itself right after its callback returned.
+ * @return <c>0</c> if the job was submitted; #CECIES_ASYNC_ERROR_CODE_QUEUE_FULL if the queue is full (try again later); other <c>CECIES_ASYNC_ERROR_CODE_*</c> error codes otherwise.
+ */
+CECIES_API int cecies_curve448_encrypt_async(cecies_async_pool* pool, const uint8_t* data, size_t data_length, int compress, cecies_curve448_key public_key, int header_flags, int output_base64, cecies_async_callback callback, void* user_data, cecies_async_job** out_job);
+
+/**
+ * Submits a decryption job (exactly as cecies_curve25519_decrypt() does it).
+ * @param pool The pool to run the job on.
+ * @param encrypted_data The data to decrypt. This is NOT copied: it must stay valid (and unchanged) until the job has completed!
+ * @param encrypted_data_length The length of the data array.
+ * @param encrypted_data_base64 Is the input \p encrypted_data base64-encoded? Pass \c 0 for \c false, anything else for \c true.
+ * @param private_key The private key to decrypt the data with (hex-string format). This is passed by value and will be destroyed after usage!
+ * @param callback [OPTIONAL] Completion callback. Pass <c>NULL</c> if you'd rather poll or wait.
+ * @param user_data [OPTIONAL] Passed on to the \p callback as-is.
+ * @param out_job [OPTIONAL] Where to write the job handle into (free it using cecies_async_job_free() once you're done with it). If you pass <c>NULL</c>, the job frees itself right after its callback returned.
+ * @return <c>0</c> if the job was submitted; #CECIES_ASYNC_ERROR_CODE_QUEUE_FULL if the queue is full (try again later); other <c>CECIES_ASYNC_ERROR_CODE_*</c> error codes otherwise.
+ */
+CECIES_API int cecies_curve25519_decrypt_async(cecies_async_pool* pool, const uint8_t* encrypted_data, size_t encrypted_data_length, int encrypted_data_base64, cecies_curve25519_key private_key, cecies_async_callback callback, void* user_data, cecies_async_job** out_job);
+
+/**
+ * Submits a decryption job (exactly as cecies_curve448_decrypt() does it).
+ * @param pool The pool to run the job on.
+ * @param encrypted_data The data to decrypt. This is NOT copied: it must stay valid (and unchanged) until the job has completed!
+ * @param encrypted_data_length The length of the data array.
+ * @param encrypted_data_base64 Is the input \p encrypted_data base64-encoded? Pass \c 0 for \c false, anything else for \c true.
+ * @param private_key The private key to decrypt the data with (hex-string format). This is passed by value and will be destroyed after usage!
+ * @param callback [OPTIONAL] Completion callback. Pass <c>NULL</c> if you'd rather poll or wait.
+ * @param user_data [OPTIONAL] Passed on to the \p callback as-is.
+ * @param out_job [OPTIONAL] Where to write the job handle into (free it using cecies_async_job_free() once you're done with it). If you pass <c>NULL</c>, the job frees itself right after its callback returned.
+ * @return <c>0</c> if the job was submitted; #CECIES_ASYNC_ERROR_CODE_QUEUE_FULL if the queue is full (try again later); other <c>CECIES_ASYNC_ERROR_CODE_*</c> error codes otherwise.
+ */
+CECIES_API int cecies_curve448_decrypt_async(cecies_async_pool* pool, const uint8_t* encrypted_data, size_t encrypted_data_length, int encrypted_data_base64, cecies_curve448_key private_key, cecies_async_callback callback, void* user_data, cecies_async_job** out_job);
+
+/**
+ * Submits a job that encrypts a whole file into another file (binary, uncompressed; same format as cecies_curve25519_encrypt_ext() with <c>compress</c> set to \c 0). <p>
+ * The file is processed in chunks of #CECIES_ASYNC_FILE_CHUNK_SIZE bytes: on Linux, reading the next chunks and writing the previous ones overlaps with the encryption of the current one using io_uring
+ * (falling back to plain positional reads and writes where io_uring isn't available). The job has no output buffer: check its result code.
+ * @param pool The pool to run the job on.
+ * @param input_path The file to encrypt (it must not be empty).
+ * @param output_path Where to write the ciphertext to (an existing file is overwritten; if encryption fails, the output file is deleted).
+ * @param public_key The public key to encrypt the data with (hex-string format).
+ * @param header_flags Extended header flags (see cecies_curve25519_encrypt_ext()). Pass \c 0 for the plain format.
+ * @param callback [OPTIONAL] Completion callback. Pass <c>NULL</c> if you'd rather poll or wait.
+ * @param user_data [OPTIONAL] Passed on to the \p callback as-is.
+ * @param out_job [OPTIONAL] Where to write the job handle into (free it using cecies_async_job_free() once you're done with it). If you pass <c>NULL</c>, the job frees itself right after its callback returned.
+ * @return <c>0</c> if the job was submitted; #CECIES_ASYNC_ERROR_CODE_QUEUE_FULL if the queue is full (try again later); other <c>CECIES_ASYNC_ERROR_CODE_*</c> error codes otherwise.
+ */
+CECIES_API int cecies_curve25519_encrypt_file_async(cecies_async_pool* pool, const char* input_path, const char* output_path, cecies_curve25519_key public_key, int header_flags, cecies_async_callback callback, void* user_data, cecies_async_job** out_job);
+
+/**
+ * Submits a job that encrypts a whole file into another file (binary, uncompressed; same format as cecies_curve448_encrypt_ext() with <c>compress</c> set to \c 0). <p>
+ * The file is processed in chunks of #CECIES_ASYNC_FILE_CHUNK_SIZE bytes: on Linux, reading the next chunks and writing the previous ones overlaps with the encryption of the current one using io_uring
+ * (falling back to plain positional reads and writes where io_uring isn't available). The job has no output buffer: check its result code.
+ * @param pool The pool to run the job on.
+ * @param input_path The file to encrypt (it must not be empty).
+ * @param output_path Where to write the ciphertext to (an existing file is overwritten; if encryption fails, the output file is deleted).
+ * @param public_key The public key to encrypt the data with (hex-string format).
+ * @param header_flags Extended header flags (see cecies_curve448_encrypt_ext()). Pass \c 0 for the plain format.
+ * @param callback [OPTIONAL] Completion callback. Pass <c>NULL</c> if you'd rather poll or wait.
+ * @param user_data [OPTIONAL] Passed on to the \p callback as-is.
+ * @param out_job [OPTIONAL] Where to write the job handle into (free it using cecies_async_job_free() once you're done with it). If you pass <c>NULL</c>, the job frees itself right after its callback returned.
+ * @return <c>0</c> if the job was submitted; #CECIES_ASYNC_ERROR_CODE_QUEUE_FULL if the queue is full (try again later); other <c>CECIES_ASYNC_ERROR_CODE_*</c> error codes otherwise.
+ */
+CECIES_API int cecies_curve448_encrypt_file_async(cecies_async_pool* pool, const char* input_path, const char* output_path, cecies_curve448_key public_key, int header_flags, cecies_async_callback callback, void* user_data, cecies_async_job** out_job);
+
+/**
+ * Checks whether a job has completed, without blocking.
+ * @param job The job.
+ * @return \c 1 if the job has completed; \c 0 if it's still queued up or running.
+ */
+CECIES_API int cecies_async_job_is_done(const cecies_async_job* job);
+
+/**
+ * Blocks until a job has completed.
+ * @param job The job to wait for.
+ * @return The job's result code (see cecies_async_job_get_result()).
+ */
+CECIES_API int cecies_async_job_wait(cecies_async_job* job);
+
+/**
+ * Gets the result of a completed job and takes over its output buffer.
+ * @param job The job.
+ * @param output [OPTIONAL] Where to write the output buffer into. You take over ownership of it: DO NOT FORGET TO FREE IT YOURSELF! Use #cecies_free() for freeing. Afterwards, the job doesn't hold an output anymore. Pass <c>NULL</c> to leave the output inside the job (it's freed along with it).
+ * @param output_length [OPTIONAL] Where to write the output length into.
+ * @return #CECIES_ASYNC_ERROR_CODE_IN_PROGRESS if the job hasn't completed yet; otherwise the return code of the en-/decryption (<c>0</c> on success).
+ */
+CECIES_API int cecies_async_job_get_result(cecies_async_job* job, uint8_t** output, size_t* output_length);
+
+/**
+ * Requests a job to be cancelled. This never blocks and can be called from any thread, as long as the job hasn't been freed or released. <p>
+ * A job that hasn't started running yet completes with #CECIES_ASYNC_ERROR_CODE_CANCELLED without doing any work (its callback is still invoked);
+ * a running file encryption job stops at the next chunk (and deletes its output file); a running in-memory en-/decryption is too short to be interrupted and completes normally.
+ * @param job The job to cancel.
+ * @return <c>0</c> if the cancellation was requested (check the job's result to see whether it took effect); #CECIES_ASYNC_ERROR_CODE_NULL_ARG if \p job is <c>NULL</c>.
+ */
+CECIES_API int cecies_async_job_cancel(cecies_async_job* job);
+
+/**
+ * Gives up ownership of a job without waiting for it: the job (and its output buffer, unless that was taken over using cecies_async_job_get_result()) is freed as soon as the worker is done with it,
+ * or right away if it already is. <p>
+ * Unlike cecies_async_job_free(), this never blocks, so it can also be called from within the job's own callback (e.g. to resume a coroutine inline on the worker thread).
+ * @param job The job to release (passing <c>NULL</c> is a no-op). Don't touch it afterwards!
+ */
+CECIES_API void cecies_async_job_release(cecies_async_job* job);
+
+/**
+ * Waits for a job to complete (if it hasn't yet) and frees it, along with its output buffer unless that was taken over using cecies_async_job_get_result().
+ * @param job The job to free (passing <c>NULL</c> is a no-op).
+ */
+CECIES_API void cecies_async_job_free(cecies_async_job* job);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // CECIES_ASYNC_H
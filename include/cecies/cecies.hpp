@@ -0,0 +1,926 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/**
+ *  @file cecies.hpp
+ *  @author Raphael Beck
+ *  @brief Header-only C++17 wrapper around the CECIES C API: RAII key, buffer and context types, span inputs and output into caller-provided buffers or <c>std::pmr</c> memory resources. <p>
+ *  Nothing in here throws: errors are reported through cecies::result (the same error codes as the C API), so this also works with <c>-fno-exceptions</c>.
+ */
+
+#ifndef CECIES_HPP
+#define CECIES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <string_view>
+#include <type_traits>
+
+#if __cplusplus >= 202002L && defined(__has_include)
+#if __has_include(<span>)
+#include <span>
+#define CECIES_HPP_STD_SPAN 1
+#endif
+#endif
+
+#if defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <vector>
+#include <memory_resource>
+#define CECIES_HPP_PMR 1
+#endif
+#endif
+
+#include "types.h"
+#include "constants.h"
+#include "util.h"
+#include "keygen.h"
+#include "encrypt.h"
+#include "decrypt.h"
+#include "stream.h"
+
+namespace cecies
+{
+
+#ifdef CECIES_HPP_STD_SPAN
+/**
+ * Contiguous view over a sequence of \p T (<c>std::span</c> when compiling as C++20).
+ */
+template <typename T>
+using span = std::span<T>;
+#else
+/**
+ * Contiguous view over a sequence of \p T (a minimal stand-in for C++20's <c>std::span</c>).
+ */
+template <typename T>
+class span
+{
+public:
+    constexpr span() noexcept = default;
+
+    constexpr span(T* data, const std::size_t size) noexcept
+        : data_(data)
+        , size_(size)
+    {
+    }
+
+    template <typename Container, typename = std::enable_if_t<std::is_convertible_v<decltype(std::declval<Container&>().data()), T*>>>
+    constexpr span(Container& container) noexcept
+        : data_(container.data())
+        , size_(container.size())
+    {
+    }
+
+    template <std::size_t N>
+    constexpr span(T (&array)[N]) noexcept
+        : data_(array)
+        , size_(N)
+    {
+    }
+
+    constexpr T* data() const noexcept
+    {
+        return data_;
+    }
+
+    constexpr std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    constexpr bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    constexpr T* begin() const noexcept
+    {
+        return data_;
+    }
+
+    constexpr T* end() const noexcept
+    {
+        return data_ + size_;
+    }
+
+    constexpr T& operator[](const std::size_t index) const noexcept
+    {
+        return data_[index];
+    }
+
+    constexpr span subspan(const std::size_t offset, const std::size_t count) const noexcept
+    {
+        return span(data_ + offset, count);
+    }
+
+private:
+    T* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+#endif
+
+/** Read-only bytes (plaintext or ciphertext input). */
+using byte_span = span<const std::uint8_t>;
+
+/** Caller-provided output buffer. */
+using mutable_byte_span = span<std::uint8_t>;
+
+/**
+ * Views the characters of a string as bytes (no copy).
+ * @param string The string.
+ * @return A byte_span over the string's characters (without NUL-terminator).
+ */
+inline byte_span as_bytes(const std::string_view string) noexcept
+{
+    return byte_span(reinterpret_cast<const std::uint8_t*>(string.data()), string.size());
+}
+
+namespace detail
+{
+    /*
+     * Wipes memory in a way that the compiler can't optimize away (same idea as mbedtls_platform_zeroize(), without needing the MbedTLS headers).
+     */
+    inline void wipe(void* memory, std::size_t length) noexcept
+    {
+        volatile unsigned char* p = static_cast<volatile unsigned char*>(memory);
+        while (length--)
+        {
+            *p++ = 0x00;
+        }
+    }
+
+    inline bool is_hex(const std::string_view string) noexcept
+    {
+        for (const char c : string)
+        {
+            if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F')))
+                return false;
+        }
+        return true;
+    }
+} // namespace detail
+
+/**
+ * Either a value or an error code (the same error codes as the C API returns). Never throws.
+ * @tparam T The value type (must be default-constructible).
+ */
+template <typename T>
+class result
+{
+public:
+    /**
+     * A successful result.
+     */
+    result(T value) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : value_(std::move(value))
+    {
+    }
+
+    /**
+     * A failed result.
+     * @param error The (non-zero) error code.
+     */
+    static result failure(const int error) noexcept(std::is_nothrow_default_constructible_v<T>)
+    {
+        result r;
+        r.error_ = error;
+        return r;
+    }
+
+    /** @return Whether this holds a value. */
+    bool ok() const noexcept
+    {
+        return error_ == 0;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return ok();
+    }
+
+    /** @return <c>0</c> on success; the error code otherwise. */
+    int error() const noexcept
+    {
+        return error_;
+    }
+
+    /** @return The value (only meaningful if ok()). */
+    T& value() & noexcept
+    {
+        return value_;
+    }
+
+    const T& value() const& noexcept
+    {
+        return value_;
+    }
+
+    T&& value() && noexcept
+    {
+        return std::move(value_);
+    }
+
+    T* operator->() noexcept
+    {
+        return &value_;
+    }
+
+    const T* operator->() const noexcept
+    {
+        return &value_;
+    }
+
+    T& operator*() & noexcept
+    {
+        return value_;
+    }
+
+    const T& operator*() const& noexcept
+    {
+        return value_;
+    }
+
+private:
+    result() noexcept(std::is_nothrow_default_constructible_v<T>) = default;
+
+    T value_{};
+    int error_ = 0;
+};
+
+/**
+ * Owns a buffer that was allocated by CECIES (e.g. the output of an encryption): released using cecies_free(), after wiping it. Move-only.
+ */
+class buffer
+{
+public:
+    buffer() noexcept = default;
+
+    /**
+     * Takes over a buffer that was allocated by CECIES.
+     */
+    buffer(std::uint8_t* data, const std::size_t size) noexcept
+        : data_(data)
+        , size_(size)
+    {
+    }
+
+    buffer(buffer&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+    {
+    }
+
+    buffer& operator=(buffer&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    buffer(const buffer&) = delete;
+    buffer& operator=(const buffer&) = delete;
+
+    ~buffer()
+    {
+        reset();
+    }
+
+    /**
+     * Wipes and frees the buffer.
+     */
+    void reset() noexcept
+    {
+        if (data_ != nullptr)
+        {
+            detail::wipe(data_, size_);
+            cecies_free(data_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    /**
+     * Gives up ownership of the buffer: free it yourself using cecies_free()!
+     */
+    std::uint8_t* release() noexcept
+    {
+        size_ = 0;
+        return std::exchange(data_, nullptr);
+    }
+
+    std::uint8_t* data() noexcept
+    {
+        return data_;
+    }
+
+    const std::uint8_t* data() const noexcept
+    {
+        return data_;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    byte_span bytes() const noexcept
+    {
+        return byte_span(data_, size_);
+    }
+
+    /**
+     * Views the buffer as characters (e.g. base64-encoded ciphertext).
+     */
+    std::string_view as_string_view() const noexcept
+    {
+        return std::string_view(reinterpret_cast<const char*>(data_), size_);
+    }
+
+private:
+    std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+/**
+ * Curve25519 traits: selects the matching C functions for the key, keypair and en-/decryption templates.
+ */
+struct curve25519
+{
+    using c_key = cecies_curve25519_key;
+    using c_keypair = cecies_curve25519_keypair;
+
+    static constexpr std::size_t key_size = CECIES_X25519_KEY_SIZE;
+
+    static std::size_t calc_output_buffer_needed_size(const std::size_t data_length) noexcept
+    {
+        return cecies_curve25519_calc_output_buffer_needed_size(data_length);
+    }
+
+    static int generate_keypair(c_keypair* output, const std::uint8_t* additional_entropy, const std::size_t additional_entropy_length) noexcept
+    {
+        return cecies_generate_curve25519_keypair(output, additional_entropy, additional_entropy_length);
+    }
+
+    static int encrypt(const std::uint8_t* data, const std::size_t data_length, const int compress, const c_key& public_key, const int header_flags, std::uint8_t** output, std::size_t* output_length, const int output_base64) noexcept
+    {
+        return cecies_curve25519_encrypt_ext(data, data_length, compress, public_key, header_flags, output, output_length, output_base64);
+    }
+
+    static int encrypt_to_buffer(const std::uint8_t* data, const std::size_t data_length, const c_key& public_key, const int header_flags, std::uint8_t* output, const std::size_t output_size, std::size_t* output_length) noexcept
+    {
+        return cecies_curve25519_encrypt_to_buffer(data, data_length, public_key, header_flags, output, output_size, output_length);
+    }
+
+    static int decrypt(const std::uint8_t* encrypted_data, const std::size_t encrypted_data_length, const int encrypted_data_base64, const c_key& private_key, std::uint8_t** output, std::size_t* output_length) noexcept
+    {
+        return cecies_curve25519_decrypt(encrypted_data, encrypted_data_length, encrypted_data_base64, private_key, output, output_length);
+    }
+
+    static int decrypt_to_buffer(const std::uint8_t* encrypted_data, const std::size_t encrypted_data_length, const c_key& private_key, std::uint8_t* output, const std::size_t output_size, std::size_t* output_length) noexcept
+    {
+        return cecies_curve25519_decrypt_to_buffer(encrypted_data, encrypted_data_length, private_key, output, output_size, output_length);
+    }
+
+    static int verify(const std::uint8_t* encrypted_data, const std::size_t encrypted_data_length, const int encrypted_data_base64, const c_key& private_key) noexcept
+    {
+        return cecies_curve25519_verify(encrypted_data, encrypted_data_length, encrypted_data_base64, private_key);
+    }
+
+    static int encrypt_stream_init(cecies_encrypt_stream** out_stream, const c_key& public_key, const int header_flags, std::uint8_t* header, const std::size_t header_size, std::size_t* header_length) noexcept
+    {
+        return cecies_curve25519_encrypt_stream_init(out_stream, public_key, header_flags, header, header_size, header_length);
+    }
+};
+
+/**
+ * Curve448 traits: selects the matching C functions for the key, keypair and en-/decryption templates.
+ */
+struct curve448
+{
+    using c_key = cecies_curve448_key;
+    using c_keypair = cecies_curve448_keypair;
+
+    static constexpr std::size_t key_size = CECIES_X448_KEY_SIZE;
+
+    static std::size_t calc_output_buffer_needed_size(const std::size_t data_length) noexcept
+    {
+        return cecies_curve448_calc_output_buffer_needed_size(data_length);
+    }
+
+    static int generate_keypair(c_keypair* output, const std::uint8_t* additional_entropy, const std::size_t additional_entropy_length) noexcept
+    {
+        return cecies_generate_curve448_keypair(output, additional_entropy, additional_entropy_length);
+    }
+
+    static int encrypt(const std::uint8_t* data, const std::size_t data_length, const int compress, const c_key& public_key, const int header_flags, std::uint8_t** output, std::size_t* output_length, const int output_base64) noexcept
+    {
+        return cecies_curve448_encrypt_ext(data, data_length, compress, public_key, header_flags, output, output_length, output_base64);
+    }
+
+    static int encrypt_to_buffer(const std::uint8_t* data, const std::size_t data_length, const c_key& public_key, const int header_flags, std::uint8_t* output, const std::size_t output_size, std::size_t* output_length) noexcept
+    {
+        return cecies_curve448_encrypt_to_buffer(data, data_length, public_key, header_flags, output, output_size, output_length);
+    }
+
+    static int decrypt(const std::uint8_t* encrypted_data, const std::size_t encrypted_data_length, const int encrypted_data_base64, const c_key& private_key, std::uint8_t** output, std::size_t* output_length) noexcept
+    {
+        return cecies_curve448_decrypt(encrypted_data, encrypted_data_length, encrypted_data_base64, private_key, output, output_length);
+    }
+
+    static int decrypt_to_buffer(const std::uint8_t* encrypted_data, const std::size_t encrypted_data_length, const c_key& private_key, std::uint8_t* output, const std::size_t output_size, std::size_t* output_length) noexcept
+    {
+        return cecies_curve448_decrypt_to_buffer(encrypted_data, encrypted_data_length, private_key, output, output_size, output_length);
+    }
+
+    static int verify(const std::uint8_t* encrypted_data, const std::size_t encrypted_data_length, const int encrypted_data_base64, const c_key& private_key) noexcept
+    {
+        return cecies_curve448_verify(encrypted_data, encrypted_data_length, encrypted_data_base64, private_key);
+    }
+
+    static int encrypt_stream_init(cecies_encrypt_stream** out_stream, const c_key& public_key, const int header_flags, std::uint8_t* header, const std::size_t header_size, std::size_t* header_length) noexcept
+    {
+        return cecies_curve448_encrypt_stream_init(out_stream, public_key, header_flags, header, header_size, header_length);
+    }
+};
+
+namespace detail
+{
+    /*
+     * Shared implementation of the public and private key types: holds the C API's hex-string key struct.
+     */
+    template <typename Curve>
+    class key_base
+    {
+    public:
+        using c_key = typename Curve::c_key;
+
+        key_base() noexcept
+        {
+            std::memset(&key_, 0x00, sizeof(key_));
+        }
+
+        explicit key_base(const c_key& key) noexcept
+            : key_(key)
+        {
+        }
+
+        key_base(key_base&& other) noexcept
+            : key_(other.key_)
+        {
+            detail::wipe(&other.key_, sizeof(other.key_));
+        }
+
+        key_base& operator=(key_base&& other) noexcept
+        {
+            if (this != &other)
+            {
+                key_ = other.key_;
+                detail::wipe(&other.key_, sizeof(other.key_));
+            }
+            return *this;
+        }
+
+        key_base(const key_base&) = delete;
+        key_base& operator=(const key_base&) = delete;
+
+        ~key_base()
+        {
+            detail::wipe(&key_, sizeof(key_));
+        }
+
+        /** @return The key as hex-string (empty if this key was moved from). */
+        std::string_view hex() const noexcept
+        {
+            return std::string_view(key_.hexstring, std::strlen(key_.hexstring));
+        }
+
+        /** @return The C API key struct. */
+        const c_key& c() const noexcept
+        {
+            return key_;
+        }
+
+    protected:
+        static int parse_hex(const std::string_view hex, c_key* out) noexcept
+        {
+            if (hex.size() != Curve::key_size * 2 || !detail::is_hex(hex))
+                return CECIES_KEYGEN_ERROR_CODE_INVALID_ARG;
+
+            std::memcpy(out->hexstring, hex.data(), hex.size());
+            out->hexstring[hex.size()] = '\0';
+            return 0;
+        }
+
+        static int parse_bytes(const byte_span bytes, c_key* out) noexcept
+        {
+            if (bytes.size() != Curve::key_size)
+                return CECIES_KEYGEN_ERROR_CODE_INVALID_ARG;
+
+            return cecies_bin2hexstr(bytes.data(), bytes.size(), out->hexstring, sizeof(out->hexstring), nullptr, 0) == 0 ? 0 : CECIES_KEYGEN_ERROR_CODE_INVALID_ARG;
+        }
+
+        c_key key_;
+    };
+} // namespace detail
+
+/**
+ * A public key for the given curve (cecies::curve25519 or cecies::curve448). Move-only (use clone() for explicit copies).
+ */
+template <typename Curve>
+class public_key : public detail::key_base<Curve>
+{
+    using base = detail::key_base<Curve>;
+
+public:
+    using base::base;
+
+    /**
+     * Parses a hex-encoded public key (as is the output of the keygen functions).
+     */
+    static result<public_key> from_hex(const std::string_view hex) noexcept
+    {
+        public_key key;
+        const int r = base::parse_hex(hex, &key.key_);
+        return r == 0 ? result<public_key>(std::move(key)) : result<public_key>::failure(r);
+    }
+
+    /**
+     * Creates a public key from its raw bytes (32 for Curve25519, 56 for Curve448).
+     */
+    static result<public_key> from_bytes(const byte_span bytes) noexcept
+    {
+        public_key key;
+        const int r = base::parse_bytes(bytes, &key.key_);
+        return r == 0 ? result<public_key>(std::move(key)) : result<public_key>::failure(r);
+    }
+
+    public_key clone() const noexcept
+    {
+        return public_key(this->key_);
+    }
+};
+
+/**
+ * A private key for the given curve (cecies::curve25519 or cecies::curve448). Move-only (use clone() for explicit copies); wiped on destruction.
+ */
+template <typename Curve>
+class private_key : public detail::key_base<Curve>
+{
+    using base = detail::key_base<Curve>;
+
+public:
+    using base::base;
+
+    /**
+     * Parses a hex-encoded private key (as is the output of the keygen functions).
+     */
+    static result<private_key> from_hex(const std::string_view hex) noexcept
+    {
+        private_key key;
+        const int r = base::parse_hex(hex, &key.key_);
+        return r == 0 ? result<private_key>(std::move(key)) : result<private_key>::failure(r);
+    }
+
+    /**
+     * Creates a private key from its raw bytes (32 for Curve25519, 56 for Curve448).
+     */
+    static result<private_key> from_bytes(const byte_span bytes) noexcept
+    {
+        private_key key;
+        const int r = base::parse_bytes(bytes, &key.key_);
+        return r == 0 ? result<private_key>(std::move(key)) : result<private_key>::failure(r);
+    }
+
+    private_key clone() const noexcept
+    {
+        return private_key(this->key_);
+    }
+};
+
+/**
+ * A freshly generated keypair. Move-only.
+ */
+template <typename Curve>
+struct keypair
+{
+    ::cecies::public_key<Curve> public_key;
+    ::cecies::private_key<Curve> private_key;
+};
+
+/**
+ * Generates a new keypair.
+ * @tparam Curve cecies::curve25519 or cecies::curve448
+ * @param additional_entropy [OPTIONAL] Additional entropy bytes for the CSPRNG.
+ * @return The new keypair, or the error code of the C API's keygen function.
+ */
+template <typename Curve>
+result<keypair<Curve>> generate_keypair(const byte_span additional_entropy = byte_span()) noexcept
+{
+    typename Curve::c_keypair c_keypair;
+    const int r = Curve::generate_keypair(&c_keypair, additional_entropy.data(), additional_entropy.size());
+
+    if (r != 0)
+    {
+        detail::wipe(&c_keypair, sizeof(c_keypair));
+        return result<keypair<Curve>>::failure(r);
+    }
+
+    keypair<Curve> k{ public_key<Curve>(c_keypair.public_key), private_key<Curve>(c_keypair.private_key) };
+    detail::wipe(&c_keypair, sizeof(c_keypair));
+    return result<keypair<Curve>>(std::move(k));
+}
+
+/**
+ * Encryption options (see the <c>cecies_*_encrypt_ext</c> functions).
+ */
+struct encrypt_options
+{
+    /** Compression level between [0; 9] (\c 0 for no compression). */
+    int compress = 0;
+
+    /** <c>CECIES_HEADER_FLAG_*</c> flags (\c 0 for the plain ciphertext format). */
+    int header_flags = 0;
+};
+
+/**
+ * Encrypts data into a buffer that's allocated by the C core (no extra copy).
+ * @param data The data to encrypt.
+ * @param key The recipient's public key.
+ * @param options Compression level and header flags.
+ * @return The binary ciphertext, or the C API's error code.
+ */
+template <typename Curve>
+result<buffer> encrypt(const byte_span data, const public_key<Curve>& key, const encrypt_options& options = encrypt_options()) noexcept
+{
+    std::uint8_t* output = nullptr;
+    std::size_t output_length = 0;
+    const int r = Curve::encrypt(data.data(), data.size(), options.compress, key.c(), options.header_flags, &output, &output_length, 0);
+    return r == 0 ? result<buffer>(buffer(output, output_length)) : result<buffer>::failure(r);
+}
+
+/**
+ * Encrypts data and base64-encodes the ciphertext.
+ * @param data The data to encrypt.
+ * @param key The recipient's public key.
+ * @param options Compression level and header flags.
+ * @return The base64-encoded ciphertext (use buffer::as_string_view()), or the C API's error code.
+ */
+template <typename Curve>
+result<buffer> encrypt_base64(const byte_span data, const public_key<Curve>& key, const encrypt_options& options = encrypt_options()) noexcept
+{
+    std::uint8_t* output = nullptr;
+    std::size_t output_length = 0;
+    const int r = Curve::encrypt(data.data(), data.size(), options.compress, key.c(), options.header_flags, &output, &output_length, 1);
+    return r == 0 ? result<buffer>(buffer(output, output_length)) : result<buffer>::failure(r);
+}
+
+/**
+ * Gets the exact size of the binary ciphertext that encrypt_to() produces.
+ * @param data_length How many bytes are encrypted.
+ * @param header_flags The header flags that are passed to encrypt_to().
+ * @return The ciphertext length.
+ */
+template <typename Curve>
+std::size_t encrypted_size(const std::size_t data_length, const int header_flags = 0) noexcept
+{
+    return Curve::calc_output_buffer_needed_size(data_length) + cecies_calc_ext_header_length(header_flags);
+}
+
+/**
+ * Encrypts data (uncompressed, binary) straight into a caller-provided buffer, without any heap allocation (see the <c>cecies_*_encrypt_to_buffer</c> functions).
+ * @param data The data to encrypt.
+ * @param key The recipient's public key.
+ * @param output Where to write the ciphertext into: at least encrypted_size() bytes.
+ * @param header_flags <c>CECIES_HEADER_FLAG_*</c> flags (\c 0 for the plain ciphertext format).
+ * @return The amount of bytes written into \p output, or the C API's error code.
+ */
+template <typename Curve>
+result<std::size_t> encrypt_to(const byte_span data, const public_key<Curve>& key, const mutable_byte_span output, const int header_flags = 0) noexcept
+{
+    std::size_t output_length = 0;
+    const int r = Curve::encrypt_to_buffer(data.data(), data.size(), key.c(), header_flags, output.data(), output.size(), &output_length);
+    return r == 0 ? result<std::size_t>(output_length) : result<std::size_t>::failure(r);
+}
+
+/**
+ * Decrypts a binary ciphertext into a buffer that's allocated by the C core (compressed plaintexts are decompressed).
+ * @param encrypted_data The binary ciphertext.
+ * @param key The private key to decrypt with.
+ * @return The plaintext, or the C API's error code.
+ */
+template <typename Curve>
+result<buffer> decrypt(const byte_span encrypted_data, const private_key<Curve>& key) noexcept
+{
+    std::uint8_t* output = nullptr;
+    std::size_t output_length = 0;
+    const int r = Curve::decrypt(encrypted_data.data(), encrypted_data.size(), 0, key.c(), &output, &output_length);
+    return r == 0 ? result<buffer>(buffer(output, output_length)) : result<buffer>::failure(r);
+}
+
+/**
+ * Decrypts a base64-encoded ciphertext (compressed plaintexts are decompressed).
+ * @param encrypted_data_base64 The base64-encoded ciphertext.
+ * @param key The private key to decrypt with.
+ * @return The plaintext, or the C API's error code.
+ */
+template <typename Curve>
+result<buffer> decrypt_base64(const std::string_view encrypted_data_base64, const private_key<Curve>& key) noexcept
+{
+    std::uint8_t* output = nullptr;
+    std::size_t output_length = 0;
+    const byte_span bytes = as_bytes(encrypted_data_base64);
+    const int r = Curve::decrypt(bytes.data(), bytes.size(), 1, key.c(), &output, &output_length);
+    return r == 0 ? result<buffer>(buffer(output, output_length)) : result<buffer>::failure(r);
+}
+
+/**
+ * Decrypts a binary ciphertext straight into a caller-provided buffer, without any heap allocation (see the <c>cecies_*_decrypt_to_buffer</c> functions). <p>
+ * Compressed payloads aren't decompressed: they fail with #CECIES_DECRYPT_ERROR_CODE_COMPRESSED (use cecies::decrypt() for those).
+ * @param encrypted_data The binary ciphertext.
+ * @param key The private key to decrypt with.
+ * @param output Where to write the plaintext into (<c>encrypted_data.size()</c> bytes are always enough).
+ * @return The amount of bytes written into \p output, or the C API's error code.
+ */
+template <typename Curve>
+result<std::size_t> decrypt_to(const byte_span encrypted_data, const private_key<Curve>& key, const mutable_byte_span output) noexcept
+{
+    std::size_t output_length = 0;
+    const int r = Curve::decrypt_to_buffer(encrypted_data.data(), encrypted_data.size(), key.c(), output.data(), output.size(), &output_length);
+    return r == 0 ? result<std::size_t>(output_length) : result<std::size_t>::failure(r);
+}
+
+/**
+ * Checks whether a ciphertext is authentic and was encrypted for \p key, without decrypting it.
+ * @param encrypted_data The binary ciphertext.
+ * @param key The private key.
+ * @return <c>0</c> if the ciphertext is authentic; the C API's error code otherwise.
+ */
+template <typename Curve>
+int verify(const byte_span encrypted_data, const private_key<Curve>& key) noexcept
+{
+    return Curve::verify(encrypted_data.data(), encrypted_data.size(), 0, key.c());
+}
+
+#ifdef CECIES_HPP_PMR
+
+/**
+ * Encrypts data (uncompressed, binary) into a vector that's allocated from the given memory resource: the ciphertext is written into it directly.
+ * @param data The data to encrypt.
+ * @param key The recipient's public key.
+ * @param resource The memory resource to allocate the output from (allocation failures behave as the resource does).
+ * @param header_flags <c>CECIES_HEADER_FLAG_*</c> flags (\c 0 for the plain ciphertext format).
+ * @return The ciphertext, or the C API's error code.
+ */
+template <typename Curve>
+result<std::pmr::vector<std::uint8_t>> encrypt(const byte_span data, const public_key<Curve>& key, std::pmr::memory_resource* resource, const int header_flags = 0)
+{
+    std::pmr::vector<std::uint8_t> output(encrypted_size<Curve>(data.size(), header_flags), resource);
+
+    const result<std::size_t> r = encrypt_to(data, key, mutable_byte_span(output.data(), output.size()), header_flags);
+    if (!r)
+        return result<std::pmr::vector<std::uint8_t>>::failure(r.error());
+
+    output.resize(*r);
+    return result<std::pmr::vector<std::uint8_t>>(std::move(output));
+}
+
+/**
+ * Decrypts a binary ciphertext into a vector that's allocated from the given memory resource: the plaintext is written into it directly. The plaintext is NOT decompressed.
+ * @param encrypted_data The binary ciphertext.
+ * @param key The private key to decrypt with.
+ * @param resource The memory resource to allocate the output from (allocation failures behave as the resource does).
+ * @return The plaintext, or the C API's error code.
+ */
+template <typename Curve>
+result<std::pmr::vector<std::uint8_t>> decrypt(const byte_span encrypted_data, const private_key<Curve>& key, std::pmr::memory_resource* resource)
+{
+    std::pmr::vector<std::uint8_t> output(encrypted_data.size(), resource);
+
+    const result<std::size_t> r = decrypt_to(encrypted_data, key, mutable_byte_span(output.data(), output.size()));
+    if (!r)
+    {
+        detail::wipe(output.data(), output.size());
+        return result<std::pmr::vector<std::uint8_t>>::failure(r.error());
+    }
+
+    output.resize(*r);
+    return result<std::pmr::vector<std::uint8_t>>(std::move(output));
+}
+
+#endif // CECIES_HPP_PMR
+
+/**
+ * Incremental encryption context (wraps cecies_encrypt_stream). Move-only. <p>
+ * Write header() to the beginning of your output, followed by everything that update() produces and finally the output of finish().
+ * Then overwrite the header with header() once more: finish() back-patches the authentication tag into it.
+ */
+class encrypt_stream
+{
+public:
+    encrypt_stream() noexcept = default;
+
+    encrypt_stream(encrypt_stream&& other) noexcept
+        : stream_(std::exchange(other.stream_, nullptr))
+        , header_length_(std::exchange(other.header_length_, 0))
+    {
+        std::memcpy(header_, other.header_, sizeof(header_));
+    }
+
+    encrypt_stream& operator=(encrypt_stream&& other) noexcept
+    {
+        if (this != &other)
+        {
+            cecies_encrypt_stream_free(stream_);
+            stream_ = std::exchange(other.stream_, nullptr);
+            header_length_ = std::exchange(other.header_length_, 0);
+            std::memcpy(header_, other.header_, sizeof(header_));
+        }
+        return *this;
+    }
+
+    encrypt_stream(const encrypt_stream&) = delete;
+    encrypt_stream& operator=(const encrypt_stream&) = delete;
+
+    ~encrypt_stream()
+    {
+        cecies_encrypt_stream_free(stream_);
+    }
+
+    /**
+     * Starts an incremental encryption.
+     * @param key The recipient's public key.
+     * @param header_flags <c>CECIES_HEADER_FLAG_*</c> flags (\c 0 for the plain ciphertext format).
+     * @return The context, or the C API's error code.
+     */
+    template <typename Curve>
+    static result<encrypt_stream> create(const public_key<Curve>& key, const int header_flags = 0) noexcept
+    {
+        encrypt_stream s;
+        const int r = Curve::encrypt_stream_init(&s.stream_, key.c(), header_flags, s.header_, sizeof(s.header_), &s.header_length_);
+        return r == 0 ? result<encrypt_stream>(std::move(s)) : result<encrypt_stream>::failure(r);
+    }
+
+    /** @return The ciphertext header (its tag slot is only filled in after finish()). */
+    byte_span header() const noexcept
+    {
+        return byte_span(header_, header_length_);
+    }
+
+    /**
+     * Encrypts the next piece of data.
+     * @param data The next piece of plaintext.
+     * @param output Where to write the ciphertext into (<c>data.size() + 15</c> bytes are always enough).
+     * @return The amount of bytes written into \p output, or the C API's error code.
+     */
+    result<std::size_t> update(const byte_span data, const mutable_byte_span output) noexcept
+    {
+        std::size_t output_length = 0;
+        const int r = cecies_encrypt_stream_update(stream_, data.data(), data.size(), output.data(), output.size(), &output_length);
+        return r == 0 ? result<std::size_t>(output_length) : result<std::size_t>::failure(r);
+    }
+
+    /**
+     * Finishes the encryption and back-patches the authentication tag into header().
+     * @param output Where to write the remaining ciphertext bytes into (16 bytes are always enough).
+     * @return The amount of bytes written into \p output, or the C API's error code.
+     */
+    result<std::size_t> finish(const mutable_byte_span output) noexcept
+    {
+        std::size_t output_length = 0;
+        const int r = cecies_encrypt_stream_finish(stream_, output.data(), output.size(), &output_length, header_);
+        return r == 0 ? result<std::size_t>(output_length) : result<std::size_t>::failure(r);
+    }
+
+private:
+    cecies_encrypt_stream* stream_ = nullptr;
+    std::uint8_t header_[CECIES_MAX_HEADER_SIZE] = { 0 };
+    std::size_t header_length_ = 0;
+};
+
+} // namespace cecies
+
+#endif // CECIES_HPP
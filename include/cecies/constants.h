@@ -62,6 +62,86 @@ extern "C" {
  */
 #define CECIES_X448_KEY_SIZE 56
 
+/**
+ * Size (in bytes) of a key ID (the truncated SHA2-512 fingerprint of a raw public key). <p>
+ * Key IDs are used for indexing keyrings and can optionally be embedded into the extended ciphertext header as a hint for the recipient.
+ */
+#define CECIES_KEY_ID_SIZE 8
+
+/**
+ * Size (in bytes) of the magic byte sequence that marks the beginning of an extended ciphertext header.
+ */
+#define CECIES_EXT_HEADER_MAGIC_SIZE 8
+
+/**
+ * Size (in bytes) of the key commitment value that can optionally be embedded into the extended ciphertext header.
+ */
+#define CECIES_KEY_COMMITMENT_SIZE 16
+
+/**
+ * Maximum possible length (in bytes) of a ciphertext header: the extended header with all optional fields, IV, salt, a Curve448 ephemeral public key and the tag.
+ */
+#define CECIES_MAX_HEADER_SIZE (CECIES_EXT_HEADER_MAGIC_SIZE + 1 + CECIES_KEY_ID_SIZE + CECIES_KEY_COMMITMENT_SIZE + 16 + 32 + CECIES_X448_KEY_SIZE + 16)
+
+/**
+ * Default payload size (in bytes) from which on AES-GCM en-/decryption is spread across multiple threads (see cecies_set_parallel_gcm()).
+ */
+#define CECIES_PARALLEL_GCM_DEFAULT_THRESHOLD (4 * 1024 * 1024)
+
+/**
+ * Default input size (in bytes) from which on compression (if enabled) is spread across multiple threads (see cecies_set_parallel_compression()).
+ */
+#define CECIES_PARALLEL_COMPRESSION_DEFAULT_THRESHOLD (1024 * 1024)
+
+/**
+ * Default amount of payload bytes that cecies_restartable_step() en-/decrypts per step.
+ */
+#define CECIES_RESTARTABLE_DEFAULT_GCM_CHUNK_SIZE (64 * 1024)
+
+/**
+ * Default capacity of an async worker pool's job queue (see cecies_async_pool_create()).
+ */
+#define CECIES_ASYNC_DEFAULT_QUEUE_CAPACITY 1024
+
+/**
+ * Size (in bytes) of the chunks in which the <c>cecies_*_encrypt_file_async</c> jobs read, encrypt and write files.
+ */
+#define CECIES_ASYNC_FILE_CHUNK_SIZE (1024 * 1024)
+
+#ifndef CECIES_STACK_ARENA_SIZE
+/**
+ * Size (in bytes) of the stack buffer that the <c>cecies_*_encrypt_to_buffer</c> and <c>cecies_*_decrypt_to_buffer</c> functions serve MbedTLS' allocations from. <p>
+ * Define this yourself (e.g. via the CMake cache variable <c>cecies_STACK_ARENA_SIZE</c>) to tune it for your stack budget; \c 0 turns the stack arena off (allocations then go to the regular allocator).
+ */
+#define CECIES_STACK_ARENA_SIZE (8 * 1024)
+#endif
+
+/**
+ * Set inside the extended ciphertext header's flags byte if the ciphertext was encrypted using Curve448 (otherwise Curve25519).
+ * You don't need to pass this yourself: the encryption functions set this flag automatically.
+ */
+#define CECIES_HEADER_FLAG_CURVE448 0x01
+
+/**
+ * Pass this flag to the <c>cecies_*_encrypt_ext</c> functions to embed the recipient's key ID into the extended ciphertext header. <p>
+ * Decryption via a keyring can then look up the right private key directly instead of having to guess it.
+ */
+#define CECIES_HEADER_FLAG_KEY_ID 0x02
+
+/**
+ * Pass this flag to the <c>cecies_*_encrypt_ext</c> functions to embed a key commitment value (derived from the shared secret alongside the AES key) into the extended ciphertext header. <p>
+ * Decryption with a wrong private key then fails right after the key exchange (#CECIES_DECRYPT_ERROR_CODE_WRONG_KEY) instead of only after processing the whole ciphertext,
+ * and the ciphertext can't be crafted to successfully decrypt under more than one key (which plain AES-GCM doesn't guarantee).
+ */
+#define CECIES_HEADER_FLAG_KEY_COMMITMENT 0x04
+
+/**
+ * Set inside the extended ciphertext header's flags byte if the payload was compressed before encryption (and is thus inflated again after decryption). Payloads of ciphertexts that have an extended header without this flag are never inflated, even if they start with a zlib header. <p>
+ * You don't need to (and can't) pass this yourself: the encryption functions set it automatically when compressing into a ciphertext that has an extended header anyway. <p>
+ * Plain ciphertexts don't have room for it, so for those it's unknown whether the payload is compressed (see cecies_inspect()).
+ */
+#define CECIES_HEADER_FLAG_COMPRESSED 0x08
+
 /*
  * Some error codes:
  */
@@ -71,15 +151,64 @@ extern "C" {
 #define CECIES_ENCRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE 1002
 #define CECIES_ENCRYPT_ERROR_CODE_OUT_OF_MEMORY 1003
 #define CECIES_ENCRYPT_ERROR_CODE_COMPRESSION_FAILED 1004
+#define CECIES_ENCRYPT_ERROR_CODE_FILE_ACCESS_FAILED 1005
 
 #define CECIES_DECRYPT_ERROR_CODE_NULL_ARG 2000
 #define CECIES_DECRYPT_ERROR_CODE_INVALID_ARG 2001
 #define CECIES_DECRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE 2002
 #define CECIES_DECRYPT_ERROR_CODE_OUT_OF_MEMORY 2003
+#define CECIES_DECRYPT_ERROR_CODE_KEY_NOT_FOUND 2004
+#define CECIES_DECRYPT_ERROR_CODE_VERIFICATION_FAILED 2005
+#define CECIES_DECRYPT_ERROR_CODE_WRONG_KEY 2006
+
+/**
+ * Returned if the extended header flags the payload as compressed (#CECIES_HEADER_FLAG_COMPRESSED) but it doesn't inflate.
+ * Legacy ciphertexts without an extended header can't say whether they're compressed: a payload that only starts with a zlib header is returned as it is.
+ */
+#define CECIES_DECRYPT_ERROR_CODE_DECOMPRESSION_FAILED 2007
+
+/**
+ * Returned by the <c>cecies_*_decrypt_to_buffer</c> functions if the decrypted payload is compressed: they can't inflate it without heap memory, so the output holds the compressed payload.
+ */
+#define CECIES_DECRYPT_ERROR_CODE_COMPRESSED 2008
+
+#define CECIES_KEYRING_ERROR_CODE_NULL_ARG 3000
+#define CECIES_KEYRING_ERROR_CODE_INVALID_ARG 3001
+#define CECIES_KEYRING_ERROR_CODE_OUT_OF_MEMORY 3002
+#define CECIES_KEYRING_ERROR_CODE_FILE_ACCESS_FAILED 3003
+#define CECIES_KEYRING_ERROR_CODE_INVALID_FILE 3004
+#define CECIES_KEYRING_ERROR_CODE_KEY_NOT_FOUND 3005
 
 #define CECIES_KEYGEN_ERROR_CODE_NULL_ARG 7000
 #define CECIES_KEYGEN_ERROR_CODE_INVALID_ARG 7001
 
+/**
+ * Returned by cecies_restartable_step() when the operation isn't complete yet (this is not an error).
+ */
+#define CECIES_RESTARTABLE_IN_PROGRESS 8000
+
+#define CECIES_ASYNC_ERROR_CODE_NULL_ARG 9000
+#define CECIES_ASYNC_ERROR_CODE_INVALID_ARG 9001
+#define CECIES_ASYNC_ERROR_CODE_OUT_OF_MEMORY 9002
+#define CECIES_ASYNC_ERROR_CODE_QUEUE_FULL 9003
+#define CECIES_ASYNC_ERROR_CODE_FILE_ACCESS_FAILED 9004
+#define CECIES_ASYNC_ERROR_CODE_IN_PROGRESS 9005
+#define CECIES_ASYNC_ERROR_CODE_CANCELLED 9006
+
+#define CECIES_CONTEXT_ERROR_CODE_NULL_ARG 10000
+#define CECIES_CONTEXT_ERROR_CODE_INVALID_ARG 10001
+#define CECIES_CONTEXT_ERROR_CODE_OUT_OF_MEMORY 10002
+
+#define CECIES_ED25519_ERROR_CODE_NULL_ARG 11000
+#define CECIES_ED25519_ERROR_CODE_INVALID_ARG 11001
+#define CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE 11002
+#define CECIES_ED25519_ERROR_CODE_OUT_OF_MEMORY 11003
+
+/**
+ * Not returned anymore (the Ed25519 functions now also work without 128-bit integer support); kept so that code checking for it still compiles.
+ */
+#define CECIES_ED25519_ERROR_CODE_UNSUPPORTED 11004
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
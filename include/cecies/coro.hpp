@@ -0,0 +1,594 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/**
+ *  @file coro.hpp
+ *  @author Raphael Beck
+ *  @brief C++20 coroutine interface on top of async.h: <c>co_await cecies::encrypt(context, data, key)</c> suspends the calling coroutine while the ECDH and AES-GCM work runs on a cecies::async_pool,
+ *  then resumes it through the context's executor (so that e.g. the threads of a coroutine-based server never block on the expensive scalar multiplication). <p>
+ *  Single and batched en-/decryption awaitables are provided; they can be cancelled through a <c>std::stop_token</c>. Like cecies.hpp, nothing in here throws (errors are reported through cecies::result),
+ *  except for <c>std::bad_alloc</c> out of the batch awaitables' bookkeeping vectors.
+ */
+
+#ifndef CECIES_CORO_HPP
+#define CECIES_CORO_HPP
+
+#include <atomic>
+#include <vector>
+#include <optional>
+#include <coroutine>
+#include <stop_token>
+
+#include "cecies.hpp"
+#include "async.h"
+
+namespace cecies
+{
+
+/**
+ * Owns a CECIES worker pool (see cecies_async_pool_create()). Move-only: destroying it completes all queued jobs first, then joins the workers.
+ */
+class async_pool
+{
+public:
+    async_pool() noexcept = default;
+
+    /**
+     * Starts a worker pool.
+     * @param thread_count How many worker threads to start. Pass <c>0</c> to start one per CPU core.
+     * @param queue_capacity How many jobs can be queued up at most. Pass <c>0</c> for #CECIES_ASYNC_DEFAULT_QUEUE_CAPACITY.
+     * @return The pool, or a <c>CECIES_ASYNC_ERROR_CODE_*</c> error code.
+     */
+    static result<async_pool> create(const std::size_t thread_count = 0, const std::size_t queue_capacity = 0) noexcept
+    {
+        async_pool pool;
+        const int r = cecies_async_pool_create(&pool.pool_, thread_count, queue_capacity, -1);
+        return r == 0 ? result<async_pool>(std::move(pool)) : result<async_pool>::failure(r);
+    }
+
+    async_pool(async_pool&& other) noexcept
+        : pool_(std::exchange(other.pool_, nullptr))
+    {
+    }
+
+    async_pool& operator=(async_pool&& other) noexcept
+    {
+        if (this != &other)
+        {
+            cecies_async_pool_free(pool_);
+            pool_ = std::exchange(other.pool_, nullptr);
+        }
+        return *this;
+    }
+
+    async_pool(const async_pool&) = delete;
+    async_pool& operator=(const async_pool&) = delete;
+
+    ~async_pool()
+    {
+        cecies_async_pool_free(pool_);
+    }
+
+    /** @return The underlying C pool handle (to mix the coroutine and the plain C async API on the same workers). */
+    cecies_async_pool* c() const noexcept
+    {
+        return pool_;
+    }
+
+private:
+    cecies_async_pool* pool_ = nullptr;
+};
+
+/**
+ * Non-owning, type-erased reference to the executor that resumes a coroutine once its job completed:
+ * any object with a <c>post(std::coroutine_handle<>)</c> member function (e.g. a wrapper around the event loop of the thread that awaits). <p>
+ * A default-constructed executor_ref resumes the coroutine inline, on the worker thread that ran the job.
+ */
+class executor_ref
+{
+public:
+    executor_ref() noexcept = default;
+
+    template <typename Executor>
+        requires(!std::is_same_v<std::remove_cv_t<Executor>, executor_ref>) && requires(Executor& executor, std::coroutine_handle<> handle) { executor.post(handle); }
+    executor_ref(Executor& executor) noexcept
+        : context_(&executor)
+        , post_([](void* context, const std::coroutine_handle<> handle) { static_cast<Executor*>(context)->post(handle); })
+    {
+    }
+
+    /**
+     * Hands a coroutine over to the executor (or resumes it right away if there is none).
+     */
+    void post(const std::coroutine_handle<> handle) const
+    {
+        if (post_ != nullptr)
+        {
+            post_(context_, handle);
+        }
+        else
+        {
+            handle.resume();
+        }
+    }
+
+private:
+    void* context_ = nullptr;
+    void (*post_)(void* context, std::coroutine_handle<> handle) = nullptr;
+};
+
+/**
+ * Where and how the coroutine awaitables run their jobs.
+ */
+struct async_context
+{
+    /** The pool to run the jobs on (e.g. cecies::async_pool::c()). Must outlive every job that's submitted to it. */
+    cecies_async_pool* pool = nullptr;
+
+    /** Where to resume the awaiting coroutine (default: inline, on the worker thread). */
+    executor_ref executor;
+
+    /** [OPTIONAL] Requesting a stop cancels the jobs: the ones that haven't started running yet complete with #CECIES_ASYNC_ERROR_CODE_CANCELLED. */
+    std::stop_token stop_token;
+};
+
+namespace detail
+{
+    template <typename Curve>
+    struct async_traits;
+
+    template <>
+    struct async_traits<curve25519>
+    {
+        static int encrypt(cecies_async_pool* pool, const byte_span data, const encrypt_options& options, const curve25519::c_key& public_key, cecies_async_callback callback, void* user_data, cecies_async_job** out_job) noexcept
+        {
+            return cecies_curve25519_encrypt_async(pool, data.data(), data.size(), options.compress, public_key, options.header_flags, 0, callback, user_data, out_job);
+        }
+
+        static int decrypt(cecies_async_pool* pool, const byte_span encrypted_data, const curve25519::c_key& private_key, cecies_async_callback callback, void* user_data, cecies_async_job** out_job) noexcept
+        {
+            return cecies_curve25519_decrypt_async(pool, encrypted_data.data(), encrypted_data.size(), 0, private_key, callback, user_data, out_job);
+        }
+    };
+
+    template <>
+    struct async_traits<curve448>
+    {
+        static int encrypt(cecies_async_pool* pool, const byte_span data, const encrypt_options& options, const curve448::c_key& public_key, cecies_async_callback callback, void* user_data, cecies_async_job** out_job) noexcept
+        {
+            return cecies_curve448_encrypt_async(pool, data.data(), data.size(), options.compress, public_key, options.header_flags, 0, callback, user_data, out_job);
+        }
+
+        static int decrypt(cecies_async_pool* pool, const byte_span encrypted_data, const curve448::c_key& private_key, cecies_async_callback callback, void* user_data, cecies_async_job** out_job) noexcept
+        {
+            return cecies_curve448_decrypt_async(pool, encrypted_data.data(), encrypted_data.size(), 0, private_key, callback, user_data, out_job);
+        }
+    };
+
+    struct job_canceller
+    {
+        cecies_async_job* job;
+
+        void operator()() const noexcept
+        {
+            cecies_async_job_cancel(job);
+        }
+    };
+
+    /*
+     * State shared by the single-job awaitables. The completion callback and await_suspend() both count down "pending":
+     * whoever gets to zero resumes the coroutine, so that it's never resumed while await_suspend() still touches the awaiter.
+     */
+    class job_awaiter
+    {
+    public:
+        job_awaiter(const job_awaiter&) = delete;
+        job_awaiter& operator=(const job_awaiter&) = delete;
+
+        bool await_ready() const noexcept
+        {
+            return error_ != 0;
+        }
+
+        result<buffer> await_resume() noexcept
+        {
+            finish();
+            buffer output(output_, output_length_);
+            output_ = nullptr;
+            return error_ == 0 ? result<buffer>(std::move(output)) : result<buffer>::failure(error_);
+        }
+
+    protected:
+        explicit job_awaiter(const async_context& context) noexcept
+            : context_(context)
+        {
+            if (context_.pool == nullptr)
+            {
+                error_ = CECIES_ASYNC_ERROR_CODE_NULL_ARG;
+            }
+            else if (context_.stop_token.stop_requested())
+            {
+                error_ = CECIES_ASYNC_ERROR_CODE_CANCELLED;
+            }
+        }
+
+        ~job_awaiter()
+        {
+            finish();
+            buffer discard(output_, output_length_);
+        }
+
+        template <typename Submit>
+        bool start(const std::coroutine_handle<> handle, Submit&& submit) noexcept
+        {
+            handle_ = handle;
+
+            const int r = submit(context_.pool, &on_complete, this, &job_);
+            if (r != 0)
+            {
+                error_ = r;
+                return false;
+            }
+
+            if (context_.stop_token.stop_possible())
+            {
+                stop_callback_.emplace(context_.stop_token, job_canceller{ job_ });
+            }
+
+            return pending_.fetch_sub(1, std::memory_order_acq_rel) != 1;
+        }
+
+    private:
+        static void on_complete(cecies_async_job* job, void* user_data) noexcept
+        {
+            job_awaiter* self = static_cast<job_awaiter*>(user_data);
+            self->error_ = cecies_async_job_get_result(job, &self->output_, &self->output_length_);
+
+            if (self->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                self->context_.executor.post(self->handle_);
+            }
+        }
+
+        void finish() noexcept
+        {
+            // No cancellation may be in flight anymore once the job is let go of.
+            stop_callback_.reset();
+
+            // This may run inside the job's own callback (inline executor): releasing doesn't block on the worker.
+            cecies_async_job_release(std::exchange(job_, nullptr));
+        }
+
+        async_context context_;
+        std::coroutine_handle<> handle_;
+        cecies_async_job* job_ = nullptr;
+        std::atomic<int> pending_{ 2 };
+        std::optional<std::stop_callback<job_canceller>> stop_callback_;
+
+        int error_ = 0;
+        std::uint8_t* output_ = nullptr;
+        std::size_t output_length_ = 0;
+    };
+
+    /*
+     * Same as job_awaiter, for a batch of jobs: the coroutine resumes once all of them completed.
+     */
+    class batch_awaiter
+    {
+    public:
+        batch_awaiter(const batch_awaiter&) = delete;
+        batch_awaiter& operator=(const batch_awaiter&) = delete;
+
+        bool await_ready() const noexcept
+        {
+            return count_ == 0;
+        }
+
+        std::vector<result<buffer>> await_resume()
+        {
+            finish();
+
+            std::vector<result<buffer>> results;
+            results.reserve(count_);
+
+            for (item& it : items_)
+            {
+                buffer output(std::exchange(it.output, nullptr), it.output_length);
+                results.push_back(it.error == 0 ? result<buffer>(std::move(output)) : result<buffer>::failure(it.error));
+            }
+
+            return results;
+        }
+
+    protected:
+        batch_awaiter(const async_context& context, const std::size_t count) noexcept
+            : context_(context)
+            , count_(count)
+        {
+            if (context_.pool == nullptr)
+            {
+                error_ = CECIES_ASYNC_ERROR_CODE_NULL_ARG;
+            }
+            else if (context_.stop_token.stop_requested())
+            {
+                error_ = CECIES_ASYNC_ERROR_CODE_CANCELLED;
+            }
+        }
+
+        ~batch_awaiter()
+        {
+            finish();
+            for (item& it : items_)
+            {
+                buffer discard(it.output, it.output_length);
+            }
+        }
+
+        template <typename Submit>
+        bool start(const std::coroutine_handle<> handle, Submit&& submit)
+        {
+            handle_ = handle;
+            items_.resize(count_);
+            pending_.store(count_ + 1, std::memory_order_relaxed);
+
+            for (std::size_t i = 0; i < count_; ++i)
+            {
+                item& it = items_[i];
+                it.owner = this;
+
+                // A job that can't be submitted (e.g. the queue is full) simply completes with that error.
+                // Once it is submitted, only the completion callback writes the item's result.
+                const int r = error_ != 0 ? error_ : submit(context_.pool, i, &on_complete, &it, &it.job);
+                if (r != 0)
+                {
+                    it.error = r;
+                    pending_.fetch_sub(1, std::memory_order_relaxed);
+                }
+            }
+
+            if (context_.stop_token.stop_possible())
+            {
+                stop_callback_.emplace(context_.stop_token, batch_canceller{ this });
+            }
+
+            return pending_.fetch_sub(1, std::memory_order_acq_rel) != 1;
+        }
+
+    private:
+        struct item
+        {
+            batch_awaiter* owner = nullptr;
+            cecies_async_job* job = nullptr;
+            int error = 0;
+            std::uint8_t* output = nullptr;
+            std::size_t output_length = 0;
+        };
+
+        struct batch_canceller
+        {
+            batch_awaiter* self;
+
+            void operator()() const noexcept
+            {
+                for (item& it : self->items_)
+                {
+                    if (it.job != nullptr)
+                    {
+                        cecies_async_job_cancel(it.job);
+                    }
+                }
+            }
+        };
+
+        static void on_complete(cecies_async_job* job, void* user_data) noexcept
+        {
+            item* it = static_cast<item*>(user_data);
+            batch_awaiter* self = it->owner;
+            it->error = cecies_async_job_get_result(job, &it->output, &it->output_length);
+
+            if (self->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                self->context_.executor.post(self->handle_);
+            }
+        }
+
+        void finish() noexcept
+        {
+            stop_callback_.reset();
+
+            for (item& it : items_)
+            {
+                cecies_async_job_release(std::exchange(it.job, nullptr));
+            }
+        }
+
+        async_context context_;
+        std::coroutine_handle<> handle_;
+        std::size_t count_ = 0;
+        int error_ = 0;
+        std::vector<item> items_;
+        std::atomic<std::size_t> pending_{ 0 };
+        std::optional<std::stop_callback<batch_canceller>> stop_callback_;
+    };
+} // namespace detail
+
+/**
+ * Awaitable returned by the coroutine overload of cecies::encrypt(). Yields a <c>result<buffer></c> with the binary ciphertext.
+ */
+template <typename Curve>
+class encrypt_awaitable : public detail::job_awaiter
+{
+public:
+    encrypt_awaitable(const async_context& context, const byte_span data, const public_key<Curve>& key, const encrypt_options& options) noexcept
+        : job_awaiter(context)
+        , data_(data)
+        , key_(&key)
+        , options_(options)
+    {
+    }
+
+    bool await_suspend(const std::coroutine_handle<> handle) noexcept
+    {
+        return start(handle, [this](cecies_async_pool* pool, cecies_async_callback callback, void* user_data, cecies_async_job** out_job) { //
+            return detail::async_traits<Curve>::encrypt(pool, data_, options_, key_->c(), callback, user_data, out_job);
+        });
+    }
+
+private:
+    byte_span data_;
+    const public_key<Curve>* key_;
+    encrypt_options options_;
+};
+
+/**
+ * Awaitable returned by the coroutine overload of cecies::decrypt(). Yields a <c>result<buffer></c> with the plaintext.
+ */
+template <typename Curve>
+class decrypt_awaitable : public detail::job_awaiter
+{
+public:
+    decrypt_awaitable(const async_context& context, const byte_span encrypted_data, const private_key<Curve>& key) noexcept
+        : job_awaiter(context)
+        , encrypted_data_(encrypted_data)
+        , key_(&key)
+    {
+    }
+
+    bool await_suspend(const std::coroutine_handle<> handle) noexcept
+    {
+        return start(handle, [this](cecies_async_pool* pool, cecies_async_callback callback, void* user_data, cecies_async_job** out_job) { //
+            return detail::async_traits<Curve>::decrypt(pool, encrypted_data_, key_->c(), callback, user_data, out_job);
+        });
+    }
+
+private:
+    byte_span encrypted_data_;
+    const private_key<Curve>* key_;
+};
+
+/**
+ * Awaitable returned by cecies::encrypt_batch(). Yields one <c>result<buffer></c> per input, in the same order.
+ */
+template <typename Curve>
+class encrypt_batch_awaitable : public detail::batch_awaiter
+{
+public:
+    encrypt_batch_awaitable(const async_context& context, const span<const byte_span> data, const public_key<Curve>& key, const encrypt_options& options) noexcept
+        : batch_awaiter(context, data.size())
+        , data_(data)
+        , key_(&key)
+        , options_(options)
+    {
+    }
+
+    bool await_suspend(const std::coroutine_handle<> handle)
+    {
+        return start(handle, [this](cecies_async_pool* pool, const std::size_t i, cecies_async_callback callback, void* user_data, cecies_async_job** out_job) { //
+            return detail::async_traits<Curve>::encrypt(pool, data_[i], options_, key_->c(), callback, user_data, out_job);
+        });
+    }
+
+private:
+    span<const byte_span> data_;
+    const public_key<Curve>* key_;
+    encrypt_options options_;
+};
+
+/**
+ * Awaitable returned by cecies::decrypt_batch(). Yields one <c>result<buffer></c> per ciphertext, in the same order.
+ */
+template <typename Curve>
+class decrypt_batch_awaitable : public detail::batch_awaiter
+{
+public:
+    decrypt_batch_awaitable(const async_context& context, const span<const byte_span> encrypted_data, const private_key<Curve>& key) noexcept
+        : batch_awaiter(context, encrypted_data.size())
+        , encrypted_data_(encrypted_data)
+        , key_(&key)
+    {
+    }
+
+    bool await_suspend(const std::coroutine_handle<> handle)
+    {
+        return start(handle, [this](cecies_async_pool* pool, const std::size_t i, cecies_async_callback callback, void* user_data, cecies_async_job** out_job) { //
+            return detail::async_traits<Curve>::decrypt(pool, encrypted_data_[i], key_->c(), callback, user_data, out_job);
+        });
+    }
+
+private:
+    span<const byte_span> encrypted_data_;
+    const private_key<Curve>* key_;
+};
+
+/**
+ * Encrypts data on the context's worker pool: <c>co_await</c> the returned awaitable to get the binary ciphertext (or the error code). <p>
+ * The data and the key are referenced, not copied: they must stay valid until the <c>co_await</c> completes (which they do when awaiting the call's result directly).
+ * @param context The pool to run the job on, where to resume the coroutine and an optional stop token.
+ * @param data The data to encrypt.
+ * @param key The recipient's public key.
+ * @param options Compression level and header flags.
+ * @return The awaitable.
+ */
+template <typename Curve>
+encrypt_awaitable<Curve> encrypt(const async_context& context, const byte_span data, const public_key<Curve>& key, const encrypt_options& options = encrypt_options()) noexcept
+{
+    return encrypt_awaitable<Curve>(context, data, key, options);
+}
+
+/**
+ * Decrypts a binary ciphertext on the context's worker pool: <c>co_await</c> the returned awaitable to get the plaintext (or the error code). <p>
+ * The ciphertext and the key are referenced, not copied: they must stay valid until the <c>co_await</c> completes.
+ * @param context The pool to run the job on, where to resume the coroutine and an optional stop token.
+ * @param encrypted_data The binary ciphertext.
+ * @param key The private key to decrypt with.
+ * @return The awaitable.
+ */
+template <typename Curve>
+decrypt_awaitable<Curve> decrypt(const async_context& context, const byte_span encrypted_data, const private_key<Curve>& key) noexcept
+{
+    return decrypt_awaitable<Curve>(context, encrypted_data, key);
+}
+
+/**
+ * Encrypts a batch of messages for the same recipient, one job per message (spread over all of the pool's workers). The coroutine is resumed once, after the last job completed.
+ * @param context The pool to run the jobs on, where to resume the coroutine and an optional stop token.
+ * @param data The messages to encrypt (the span and the messages must stay valid until the <c>co_await</c> completes).
+ * @param key The recipient's public key.
+ * @param options Compression level and header flags.
+ * @return The awaitable: it yields one result per message (e.g. #CECIES_ASYNC_ERROR_CODE_QUEUE_FULL for the ones that didn't fit into the pool's queue).
+ */
+template <typename Curve>
+encrypt_batch_awaitable<Curve> encrypt_batch(const async_context& context, const span<const byte_span> data, const public_key<Curve>& key, const encrypt_options& options = encrypt_options()) noexcept
+{
+    return encrypt_batch_awaitable<Curve>(context, data, key, options);
+}
+
+/**
+ * Decrypts a batch of binary ciphertexts with the same private key, one job per ciphertext. The coroutine is resumed once, after the last job completed.
+ * @param context The pool to run the jobs on, where to resume the coroutine and an optional stop token.
+ * @param encrypted_data The ciphertexts (the span and the ciphertexts must stay valid until the <c>co_await</c> completes).
+ * @param key The private key to decrypt with.
+ * @return The awaitable: it yields one result per ciphertext.
+ */
+template <typename Curve>
+decrypt_batch_awaitable<Curve> decrypt_batch(const async_context& context, const span<const byte_span> encrypted_data, const private_key<Curve>& key) noexcept
+{
+    return decrypt_batch_awaitable<Curve>(context, encrypted_data, key);
+}
+
+} // namespace cecies
+
+#endif // CECIES_CORO_HPP
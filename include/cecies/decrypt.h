@@ -55,6 +55,98 @@ CECIES_API int cecies_curve25519_decrypt(const uint8_t* encrypted_data, size_t e
  */
 CECIES_API int cecies_curve448_decrypt(const uint8_t* encrypted_data, size_t encrypted_data_length, int encrypted_data_base64, cecies_curve448_key private_key, uint8_t** output, size_t* output_length);
 
+/**
+ * Checks whether the given data (encrypted using Curve25519) is authentic and decryptable with the given private key, without actually decrypting it. <p>
+ * Only the key exchange and the GCM authentication tag are computed: no output buffer is allocated, no keystream is generated and nothing is decompressed.
+ * @param encrypted_data The data to verify.
+ * @param encrypted_data_length The length of the data array.
+ * @param encrypted_data_base64 Is the input \p encrypted_data base64-encoded? Pass \c 0 for \c false, anything else for \c true.
+ * @param private_key The private key to verify the data with (hex-string, as is the output of cecies_generate_curve25519_keypair()). This is passed by value and will be destroyed after usage!
+ * @return <c>0</c> if the data is authentic; #CECIES_DECRYPT_ERROR_CODE_VERIFICATION_FAILED if it was tampered with or encrypted for another key; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_curve25519_verify(const uint8_t* encrypted_data, size_t encrypted_data_length, int encrypted_data_base64, cecies_curve25519_key private_key);
+
+/**
+ * Checks whether the given data (encrypted using Curve448) is authentic and decryptable with the given private key, without actually decrypting it. <p>
+ * Only the key exchange and the GCM authentication tag are computed: no output buffer is allocated, no keystream is generated and nothing is decompressed.
+ * @param encrypted_data The data to verify.
+ * @param encrypted_data_length The length of the data array.
+ * @param encrypted_data_base64 Is the input \p encrypted_data base64-encoded? Pass \c 0 for \c false, anything else for \c true.
+ * @param private_key The private key to verify the data with (hex-string, as is the output of cecies_generate_curve448_keypair()). This is passed by value and will be destroyed after usage!
+ * @return <c>0</c> if the data is authentic; #CECIES_DECRYPT_ERROR_CODE_VERIFICATION_FAILED if it was tampered with or encrypted for another key; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_curve448_verify(const uint8_t* encrypted_data, size_t encrypted_data_length, int encrypted_data_base64, cecies_curve448_key private_key);
+
+/**
+ * Decrypts the given data (encrypted using Curve25519) by trying out a whole set of candidate private keys, for when you don't know which one the data was encrypted for. <p>
+ * The ciphertext header (including the ephemeral public key) is parsed only once, the candidates are tried in parallel,
+ * and for each candidate only the key exchange and the GCM authentication tag are computed: the payload itself is decrypted only once, using the matching key.
+ * @param encrypted_data The data to decrypt.
+ * @param encrypted_data_length The length of the data array.
+ * @param encrypted_data_base64 Is the input \p encrypted_data base64-encoded? Pass \c 0 for \c false, anything else for \c true.
+ * @param private_keys The candidate private keys (hex-strings, as is the output of cecies_generate_curve25519_keypair()). Malformed keys are skipped.
+ * @param private_keys_count How many keys there are in the \p private_keys array.
+ * @param thread_count How many threads to use (including the calling thread). Pass <c>0</c> to use one thread per CPU core, or <c>1</c> to stay on the calling thread.
+ * @param out_key_index Where to write the index of the matching key inside the \p private_keys array into.
+ * @param output Where to write the decrypted output into (this will ONLY be allocated if decryption succeeds; if the procedure fails in any way this is left untouched). On success: DO NOT FORGET TO FREE THIS YOURSELF! Use #cecies_free() for freeing.
+ * @param output_length Where to write the output buffer length into (how many bytes were written into it).
+ * @return <c>0</c> if decryption succeeded; #CECIES_DECRYPT_ERROR_CODE_KEY_NOT_FOUND if none of the keys matches; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_curve25519_decrypt_trial(const uint8_t* encrypted_data, size_t encrypted_data_length, int encrypted_data_base64, const cecies_curve25519_key* private_keys, size_t private_keys_count, size_t thread_count, size_t* out_key_index, uint8_t** output, size_t* output_length);
+
+/**
+ * Decrypts the given data (encrypted using Curve448) by trying out a whole set of candidate private keys, for when you don't know which one the data was encrypted for. <p>
+ * The ciphertext header (including the ephemeral public key) is parsed only once, the candidates are tried in parallel,
+ * and for each candidate only the key exchange and the GCM authentication tag are computed: the payload itself is decrypted only once, using the matching key.
+ * @param encrypted_data The data to decrypt.
+ * @param encrypted_data_length The length of the data array.
+ * @param encrypted_data_base64 Is the input \p encrypted_data base64-encoded? Pass \c 0 for \c false, anything else for \c true.
+ * @param private_keys The candidate private keys (hex-strings, as is the output of cecies_generate_curve448_keypair()). Malformed keys are skipped.
+ * @param private_keys_count How many keys there are in the \p private_keys array.
+ * @param thread_count How many threads to use (including the calling thread). Pass <c>0</c> to use one thread per CPU core, or <c>1</c> to stay on the calling thread.
+ * @param out_key_index Where to write the index of the matching key inside the \p private_keys array into.
+ * @param output Where to write the decrypted output into (this will ONLY be allocated if decryption succeeds; if the procedure fails in any way this is left untouched). On success: DO NOT FORGET TO FREE THIS YOURSELF! Use #cecies_free() for freeing.
+ * @param output_length Where to write the output buffer length into (how many bytes were written into it).
+ * @return <c>0</c> if decryption succeeded; #CECIES_DECRYPT_ERROR_CODE_KEY_NOT_FOUND if none of the keys matches; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_curve448_decrypt_trial(const uint8_t* encrypted_data, size_t encrypted_data_length, int encrypted_data_base64, const cecies_curve448_key* private_keys, size_t private_keys_count, size_t thread_count, size_t* out_key_index, uint8_t** output, size_t* output_length);
+
+/**
+ * Decrypts the given binary ciphertext (encrypted using Curve25519) into a caller-provided buffer, without any heap allocation (see below for the conditions). <p>
+ * The MbedTLS bignum arithmetic is served from a stack buffer of #CECIES_STACK_ARENA_SIZE bytes. That only works if MbedTLS is built with <c>MBEDTLS_PLATFORM_MEMORY</c>
+ * but without <c>MBEDTLS_PLATFORM_CALLOC_MACRO</c>/<c>MBEDTLS_PLATFORM_FREE_MACRO</c>, and if #CECIES_STACK_ARENA_SIZE isn't \c 0: otherwise, MbedTLS' allocations go to the heap just like they do everywhere else.
+ * The first call routes MbedTLS' allocations through CECIES for the rest of the process (see cecies_set_allocator()). <p>
+ * Compressed payloads can't be inflated without heap memory, so this is meant for ciphertexts that were encrypted without compression (e.g. by cecies_curve25519_encrypt_to_buffer()):
+ * if the payload is compressed (according to the #CECIES_HEADER_FLAG_COMPRESSED flag, or for plain ciphertexts if it starts with a zlib header), #CECIES_DECRYPT_ERROR_CODE_COMPRESSED is returned.
+ * The (authenticated) compressed payload is still written to \p output in that case, so you can inflate it yourself (or decrypt using cecies_curve25519_decrypt() instead).
+ * @param encrypted_data The binary (non-base64) data to decrypt.
+ * @param encrypted_data_length The length of the data array.
+ * @param private_key The private key to decrypt the data with (hex-string, as is the output of cecies_generate_curve25519_keypair()). This is passed by value and will be destroyed after usage!
+ * @param output Where to write the decrypted output into. On failure, its contents are undefined (but never unauthenticated plaintext).
+ * @param output_size Size of the \p output buffer: the plaintext is as long as the ciphertext minus its header, so \p encrypted_data_length is always enough.
+ * @param output_length Where to write the decrypted output length into.
+ * @return <c>0</c> if decryption succeeded; #CECIES_DECRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE if \p output is too small; #CECIES_DECRYPT_ERROR_CODE_COMPRESSED if the payload is compressed; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_curve25519_decrypt_to_buffer(const uint8_t* encrypted_data, size_t encrypted_data_length, cecies_curve25519_key private_key, uint8_t* output, size_t output_size, size_t* output_length);
+
+/**
+ * Decrypts the given binary ciphertext (encrypted using Curve448) into a caller-provided buffer, without any heap allocation (see below for the conditions). <p>
+ * The MbedTLS bignum arithmetic is served from a stack buffer of #CECIES_STACK_ARENA_SIZE bytes. That only works if MbedTLS is built with <c>MBEDTLS_PLATFORM_MEMORY</c>
+ * but without <c>MBEDTLS_PLATFORM_CALLOC_MACRO</c>/<c>MBEDTLS_PLATFORM_FREE_MACRO</c>, and if #CECIES_STACK_ARENA_SIZE isn't \c 0: otherwise, MbedTLS' allocations go to the heap just like they do everywhere else.
+ * The first call routes MbedTLS' allocations through CECIES for the rest of the process (see cecies_set_allocator()). <p>
+ * Compressed payloads can't be inflated without heap memory, so this is meant for ciphertexts that were encrypted without compression (e.g. by cecies_curve448_encrypt_to_buffer()):
+ * if the payload is compressed (according to the #CECIES_HEADER_FLAG_COMPRESSED flag, or for plain ciphertexts if it starts with a zlib header), #CECIES_DECRYPT_ERROR_CODE_COMPRESSED is returned.
+ * The (authenticated) compressed payload is still written to \p output in that case, so you can inflate it yourself (or decrypt using cecies_curve448_decrypt() instead).
+ * @param encrypted_data The binary (non-base64) data to decrypt.
+ * @param encrypted_data_length The length of the data array.
+ * @param private_key The private key to decrypt the data with (hex-string, as is the output of cecies_generate_curve448_keypair()). This is passed by value and will be destroyed after usage!
+ * @param output Where to write the decrypted output into. On failure, its contents are undefined (but never unauthenticated plaintext).
+ * @param output_size Size of the \p output buffer: the plaintext is as long as the ciphertext minus its header, so \p encrypted_data_length is always enough.
+ * @param output_length Where to write the decrypted output length into.
+ * @return <c>0</c> if decryption succeeded; #CECIES_DECRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE if \p output is too small; #CECIES_DECRYPT_ERROR_CODE_COMPRESSED if the payload is compressed; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_curve448_decrypt_to_buffer(const uint8_t* encrypted_data, size_t encrypted_data_length, cecies_curve448_key private_key, uint8_t* output, size_t output_size, size_t* output_length);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,118 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/**
+ *  @file ed25519.h
+ *  @author Raphael Beck
+ *  @brief Ed25519 signatures (RFC 8032) using raw binary keys, including batch verification.
+ */
+
+#ifndef CECIES_ED25519_H
+#define CECIES_ED25519_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "util.h"
+#include "constants.h"
+
+/**
+ * Length of an Ed25519 seed (the actual secret that a key pair is derived from).
+ */
+#define CECIES_ED25519_SEED_SIZE 32
+
+/**
+ * Length of an Ed25519 public key.
+ */
+#define CECIES_ED25519_PUBLIC_KEY_SIZE 32
+
+/**
+ * Length of an Ed25519 private key: the seed followed by the public key (the same layout libsodium uses, so keys can be exchanged with it).
+ */
+#define CECIES_ED25519_PRIVATE_KEY_SIZE 64
+
+/**
+ * Length of an Ed25519 signature.
+ */
+#define CECIES_ED25519_SIGNATURE_SIZE 64
+
+/**
+ * Derives an Ed25519 key pair from a seed.
+ * @param seed The #CECIES_ED25519_SEED_SIZE bytes of seed.
+ * @param public_key Where to write the #CECIES_ED25519_PUBLIC_KEY_SIZE bytes of public key into.
+ * @param private_key Where to write the #CECIES_ED25519_PRIVATE_KEY_SIZE bytes of private key into.
+ * @return <c>0</c> on success; error codes as defined inside the header file otherwise.
+ */
+CECIES_API int cecies_ed25519_keypair_from_seed(const uint8_t seed[CECIES_ED25519_SEED_SIZE], uint8_t public_key[CECIES_ED25519_PUBLIC_KEY_SIZE], uint8_t private_key[CECIES_ED25519_PRIVATE_KEY_SIZE]);
+
+/**
+ * Generates a random Ed25519 key pair.
+ * @param public_key Where to write the #CECIES_ED25519_PUBLIC_KEY_SIZE bytes of public key into.
+ * @param private_key Where to write the #CECIES_ED25519_PRIVATE_KEY_SIZE bytes of private key into.
+ * @param additional_entropy [OPTIONAL] Additional entropy bytes for the CSPRNG. Can be set to <c>NULL</c> if you wish not to add custom entropy.
+ * @param additional_entropy_length [OPTIONAL] Length of the \p additional_entropy array. If \p additional_entropy is <c>NULL</c>, this value is ignored.
+ * @return <c>0</c> on success; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_generate_ed25519_keypair(uint8_t public_key[CECIES_ED25519_PUBLIC_KEY_SIZE], uint8_t private_key[CECIES_ED25519_PRIVATE_KEY_SIZE], const uint8_t* additional_entropy, size_t additional_entropy_length);
+
+/**
+ * Signs a message using Ed25519 (the signatures are deterministic: the same key and message always give the same signature).
+ * @param message The message to sign (may be <c>NULL</c> if \p message_length is <c>0</c>).
+ * @param message_length Length of the \p message.
+ * @param private_key The signer's #CECIES_ED25519_PRIVATE_KEY_SIZE bytes of private key.
+ * @param signature Where to write the #CECIES_ED25519_SIGNATURE_SIZE bytes of signature into.
+ * @return <c>0</c> on success; error codes as defined inside the header file otherwise.
+ */
+CECIES_API int cecies_ed25519_sign(const uint8_t* message, size_t message_length, const uint8_t private_key[CECIES_ED25519_PRIVATE_KEY_SIZE], uint8_t signature[CECIES_ED25519_SIGNATURE_SIZE]);
+
+/**
+ * Verifies an Ed25519 signature. <p>
+ * Just like libsodium's <c>crypto_sign_ed25519_verify_detached()</c>, this rejects non-canonical S values, non-canonical and small-order public keys and small-order R values. <p>
+ * Unlike libsodium though, the signature is then checked with the cofactored equation [8]R == [8]([S]B - [k]A) that RFC 8032 specifies, instead of comparing R against [S]B - [k]A:
+ * the two only disagree on signatures whose R or public key has a small-order component (which honest signers never produce), and the cofactored one is what makes
+ * cecies_ed25519_verify_batch() agree with this function without having to check every signature for such components.
+ * @param message The signed message (may be <c>NULL</c> if \p message_length is <c>0</c>).
+ * @param message_length Length of the \p message.
+ * @param signature The #CECIES_ED25519_SIGNATURE_SIZE bytes of signature to verify.
+ * @param public_key The signer's #CECIES_ED25519_PUBLIC_KEY_SIZE bytes of public key.
+ * @return <c>0</c> if the signature is valid; #CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE if it isn't, or another error code as defined inside the header file.
+ */
+CECIES_API int cecies_ed25519_verify(const uint8_t* message, size_t message_length, const uint8_t signature[CECIES_ED25519_SIGNATURE_SIZE], const uint8_t public_key[CECIES_ED25519_PUBLIC_KEY_SIZE]);
+
+/**
+ * Verifies a batch of Ed25519 signatures at once, accepting and rejecting exactly the same signatures as calling cecies_ed25519_verify() for each one of them would. <p>
+ * All signatures are checked together through one random linear combination of their verification equations, evaluated as a single multi-scalar multiplication.
+ * If that fails, the signatures are verified one by one to find out which of them are invalid. <p>
+ * Like cecies_ed25519_verify(), the combined equation is multiplied by the cofactor 8, so both of them accept the same signatures (except with a negligible probability of 2^-128 per batch
+ * that an invalid one slips through the random linear combination). Batches of 16 signatures verify about twice as fast as one at a time, batches of 1024 about three times as fast (run <c>cecies_ed25519_benchmark</c> to compare the two on your machine).
+ * @param messages The signed messages.
+ * @param message_lengths The lengths of the \p messages.
+ * @param signatures The #CECIES_ED25519_SIGNATURE_SIZE-byte signatures to verify.
+ * @param public_keys The #CECIES_ED25519_PUBLIC_KEY_SIZE-byte public keys of the signers.
+ * @param count How many signatures to verify (the length of each of the above arrays).
+ * @param results [OPTIONAL] Where to write the per-signature results into (<c>0</c> or #CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE; <c>count</c> entries). If this is <c>NULL</c>, the one-by-one verification after a failed batch is skipped.
+ * @return <c>0</c> if all signatures are valid; #CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE if at least one of them isn't, or another error code as defined inside the header file.
+ */
+CECIES_API int cecies_ed25519_verify_batch(const uint8_t* const* messages, const size_t* message_lengths, const uint8_t* const* signatures, const uint8_t* const* public_keys, size_t count, int* results);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // CECIES_ED25519_H
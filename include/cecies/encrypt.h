@@ -30,6 +30,7 @@ extern "C" {
 #include <stddef.h>
 #include <stdint.h>
 #include "types.h"
+#include "constants.h"
 
 /**
  * Encrypts the given data using ECIES over Curve25519 and AES256-GCM.
@@ -57,6 +58,74 @@ CECIES_API int cecies_curve25519_encrypt(const uint8_t* data, size_t data_length
  */
 CECIES_API int cecies_curve448_encrypt(const uint8_t* data, size_t data_length, int compress, cecies_curve448_key public_key, uint8_t** output, size_t* output_length, int output_base64);
 
+/**
+ * Encrypts the given data using ECIES over Curve25519 and AES256-GCM, prefixing the ciphertext with an extended header. <p>
+ * The extended header starts with #CECIES_EXT_HEADER_MAGIC_SIZE magic bytes and a flags byte, followed by the fields requested through \p header_flags (it is authenticated along with the ciphertext). <p>
+ * The regular cecies_curve25519_decrypt() function detects and handles this header automatically.
+ * @param data The data to encrypt.
+ * @param data_length The length of the data array.
+ * @param compress Should the \p data be compressed before being encrypted? Pass any integer value between [0; 9] (where \c 0 is no compression at all and \c 9 is highest but slowest compression).
+ * @param public_key The public key to encrypt the data with (hex-string format, as is the output of cecies_generate_curve25519_keypair()).
+ * @param header_flags Which optional fields to embed into the extended header (#CECIES_HEADER_FLAG_KEY_ID and/or #CECIES_HEADER_FLAG_KEY_COMMITMENT). Passing \c 0 produces exactly the same output format as cecies_curve25519_encrypt().
+ * @param output Where to write the encrypted output into (this will ONLY be allocated if encryption succeeds; if the procedure fails in any way this is left untouched). On success: DO NOT FORGET TO FREE THIS YOURSELF! Use #cecies_free() for freeing.
+ * @param output_length Where to write the output buffer length into.
+ * @param output_base64 Should the encrypted output bytes be base64-encoded for easy transmission over e.g. email? If you decide to base64-encode the encrypted data buffer, please be aware that a NUL-terminator is appended at the end to allow usage as a C-string but it will not be counted in \p output_length. Pass \c 0 for \c false, anything else for \c true.
+ * @return <c>0</c> if encryption succeeded;  error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_curve25519_encrypt_ext(const uint8_t* data, size_t data_length, int compress, cecies_curve25519_key public_key, int header_flags, uint8_t** output, size_t* output_length, int output_base64);
+
+/**
+ * Encrypts the given data using ECIES over Curve448 and AES256-GCM, prefixing the ciphertext with an extended header. <p>
+ * The extended header starts with #CECIES_EXT_HEADER_MAGIC_SIZE magic bytes and a flags byte, followed by the fields requested through \p header_flags (it is authenticated along with the ciphertext). <p>
+ * The regular cecies_curve448_decrypt() function detects and handles this header automatically.
+ * @param data The data to encrypt.
+ * @param data_length The length of the data array.
+ * @param compress Should the \p data be compressed before being encrypted? Pass any integer value between [0; 9] (where \c 0 is no compression at all and \c 9 is highest but slowest compression).
+ * @param public_key The public key to encrypt the data with (hex-string format, as is the output of cecies_generate_curve448_keypair()).
+ * @param header_flags Which optional fields to embed into the extended header (#CECIES_HEADER_FLAG_KEY_ID and/or #CECIES_HEADER_FLAG_KEY_COMMITMENT). Passing \c 0 produces exactly the same output format as cecies_curve448_encrypt().
+ * @param output Where to write the encrypted output into (this will ONLY be allocated if encryption succeeds; if the procedure fails in any way this is left untouched). On success: DO NOT FORGET TO FREE THIS YOURSELF! Use #cecies_free() for freeing.
+ * @param output_length Where to write the output buffer length into.
+ * @param output_base64 Should the encrypted output bytes be base64-encoded for easy transmission over e.g. email? If you decide to base64-encode the encrypted data buffer, please be aware that a NUL-terminator is appended at the end to allow usage as a C-string but it will not be counted in \p output_length. Pass \c 0 for \c false, anything else for \c true.
+ * @return <c>0</c> if encryption succeeded;  error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_curve448_encrypt_ext(const uint8_t* data, size_t data_length, int compress, cecies_curve448_key public_key, int header_flags, uint8_t** output, size_t* output_length, int output_base64);
+
+/**
+ * Encrypts the given data using ECIES over Curve25519 and AES256-GCM into a caller-provided buffer, without any heap allocation (see below for the conditions). <p>
+ * The MbedTLS bignum arithmetic is served from a stack buffer of #CECIES_STACK_ARENA_SIZE bytes. That only works if MbedTLS is built with <c>MBEDTLS_PLATFORM_MEMORY</c> (the CMake option <c>cecies_MBEDTLS_PLATFORM_MEMORY</c> takes care of that)
+ * but without <c>MBEDTLS_PLATFORM_CALLOC_MACRO</c>/<c>MBEDTLS_PLATFORM_FREE_MACRO</c> (which compile a fixed allocator into MbedTLS), and if #CECIES_STACK_ARENA_SIZE isn't \c 0:
+ * otherwise, MbedTLS' allocations go to the heap (or the allocator set using cecies_set_allocator()) just like they do everywhere else.
+ * The first call routes MbedTLS' allocations through CECIES for the rest of the process (see cecies_set_allocator()). <p>
+ * The output is always binary and never compressed (it's the same format as cecies_curve25519_encrypt_ext() produces with <c>compress</c> set to \c 0).
+ * @param data The data to encrypt.
+ * @param data_length The length of the data array.
+ * @param public_key The public key to encrypt the data with (hex-string format, as is the output of cecies_generate_curve25519_keypair()).
+ * @param header_flags Which optional fields to embed into the extended header (#CECIES_HEADER_FLAG_KEY_ID and/or #CECIES_HEADER_FLAG_KEY_COMMITMENT), or \c 0 for the plain ciphertext format.
+ * @param output Where to write the ciphertext into.
+ * @param output_size Size of the \p output buffer: at least cecies_curve25519_calc_output_buffer_needed_size() + cecies_calc_ext_header_length() bytes.
+ * @param output_length Where to write the ciphertext length into.
+ * @return <c>0</c> if encryption succeeded; #CECIES_ENCRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE if \p output is too small; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_curve25519_encrypt_to_buffer(const uint8_t* data, size_t data_length, cecies_curve25519_key public_key, int header_flags, uint8_t* output, size_t output_size, size_t* output_length);
+
+/**
+ * Encrypts the given data using ECIES over Curve448 and AES256-GCM into a caller-provided buffer, without any heap allocation (see below for the conditions). <p>
+ * The MbedTLS bignum arithmetic is served from a stack buffer of #CECIES_STACK_ARENA_SIZE bytes. That only works if MbedTLS is built with <c>MBEDTLS_PLATFORM_MEMORY</c> (the CMake option <c>cecies_MBEDTLS_PLATFORM_MEMORY</c> takes care of that)
+ * but without <c>MBEDTLS_PLATFORM_CALLOC_MACRO</c>/<c>MBEDTLS_PLATFORM_FREE_MACRO</c> (which compile a fixed allocator into MbedTLS), and if #CECIES_STACK_ARENA_SIZE isn't \c 0:
+ * otherwise, MbedTLS' allocations go to the heap (or the allocator set using cecies_set_allocator()) just like they do everywhere else.
+ * The first call routes MbedTLS' allocations through CECIES for the rest of the process (see cecies_set_allocator()). <p>
+ * The output is always binary and never compressed (it's the same format as cecies_curve448_encrypt_ext() produces with <c>compress</c> set to \c 0).
+ * @param data The data to encrypt.
+ * @param data_length The length of the data array.
+ * @param public_key The public key to encrypt the data with (hex-string format, as is the output of cecies_generate_curve448_keypair()).
+ * @param header_flags Which optional fields to embed into the extended header (#CECIES_HEADER_FLAG_KEY_ID and/or #CECIES_HEADER_FLAG_KEY_COMMITMENT), or \c 0 for the plain ciphertext format.
+ * @param output Where to write the ciphertext into.
+ * @param output_size Size of the \p output buffer: at least cecies_curve448_calc_output_buffer_needed_size() + cecies_calc_ext_header_length() bytes.
+ * @param output_length Where to write the ciphertext length into.
+ * @return <c>0</c> if encryption succeeded; #CECIES_ENCRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE if \p output is too small; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_curve448_encrypt_to_buffer(const uint8_t* data, size_t data_length, cecies_curve448_key public_key, int header_flags, uint8_t* output, size_t output_size, size_t* output_length);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
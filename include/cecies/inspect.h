@@ -0,0 +1,119 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/**
+ *  @file inspect.h
+ *  @author Raphael Beck
+ *  @brief Ciphertext header inspection (no crypto, no heap allocations).
+ */
+
+#ifndef CECIES_INSPECT_H
+#define CECIES_INSPECT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "types.h"
+#include "constants.h"
+
+/**
+ * Metadata about a CECIES ciphertext, as parsed by cecies_inspect(). <p>
+ * All offsets and lengths refer to the binary form of the ciphertext (so after base64-decoding, if it was base64-encoded).
+ */
+typedef struct cecies_ciphertext_info
+{
+    /** <c>0</c> for Curve25519, <c>1</c> for Curve448. */
+    int curve;
+
+    /** The <c>CECIES_HEADER_FLAG_*</c> flags of the extended header (<c>0</c> if the ciphertext doesn't have one). */
+    int header_flags;
+
+    /** Total length of the binary ciphertext. */
+    size_t binary_length;
+
+    /** Length of the extended header (<c>0</c> if there is none). */
+    size_t ext_header_length;
+
+    /** Offset of the 16 bytes long AES IV. */
+    size_t iv_offset;
+
+    /** Offset of the 32 bytes long HKDF salt. */
+    size_t salt_offset;
+
+    /** Offset of the ephemeral public key R. */
+    size_t ephemeral_public_key_offset;
+
+    /** Offset of the 16 bytes long AES-GCM tag. */
+    size_t tag_offset;
+
+    /** Offset of the encrypted payload. */
+    size_t payload_offset;
+
+    /** Length of the encrypted payload. */
+    size_t payload_length;
+
+    /** The ephemeral public key R (raw bytes, only the first #ephemeral_public_key_length bytes are used). */
+    uint8_t ephemeral_public_key[CECIES_X448_KEY_SIZE];
+
+    /** Length of the ephemeral public key (#CECIES_X25519_KEY_SIZE or #CECIES_X448_KEY_SIZE). */
+    size_t ephemeral_public_key_length;
+
+    /** Does the extended header contain a key ID hint? */
+    int has_key_id;
+
+    /** The recipient's key ID (only valid if #has_key_id is set). */
+    uint8_t key_id[CECIES_KEY_ID_SIZE];
+
+    /** Does the extended header contain a key commitment value? */
+    int has_key_commitment;
+
+    /**
+     * Was the plaintext compressed before encryption? <p>
+     * <c>1</c> if it was, <c>0</c> if it wasn't, and <c>-1</c> if that's unknown (plain ciphertexts have no header flags to tell).
+     */
+    int is_compressed;
+
+    /**
+     * Upper bound for the size of the decrypted plaintext. <p>
+     * This is the exact plaintext length if #is_compressed is <c>0</c>, otherwise <c>SIZE_MAX</c>:
+     * compressed plaintexts are inflated after decryption, so their size can't be known without decrypting (deflate can expand up to ~1032x).
+     */
+    size_t plaintext_length_bound;
+} cecies_ciphertext_info;
+
+/**
+ * Parses a ciphertext's header and layout without doing any crypto and without allocating anything. <p>
+ * For base64-encoded ciphertexts, only the leading characters that contain the header are decoded. <p>
+ * Plain (non-extended) ciphertexts don't record which curve they were encrypted with, so for those you need to pass the \p curve yourself;
+ * ciphertexts with an extended header are always inspected according to the curve stored inside the header.
+ * @param encrypted_data The ciphertext to inspect.
+ * @param encrypted_data_length The length of the \p encrypted_data array.
+ * @param encrypted_data_base64 Is the input \p encrypted_data base64-encoded? Pass \c 0 for \c false, anything else for \c true.
+ * @param curve <c>0</c> for Curve25519, <c>1</c> for Curve448 or <c>-1</c> if unknown (in that case only ciphertexts with an extended header can be inspected).
+ * @param out_info Where to write the parsed ciphertext metadata into.
+ * @return <c>0</c> on success; #CECIES_DECRYPT_ERROR_CODE_NULL_ARG or #CECIES_DECRYPT_ERROR_CODE_INVALID_ARG if the arguments or the ciphertext are invalid (or if the curve is unknown).
+ */
+CECIES_API int cecies_inspect(const uint8_t* encrypted_data, size_t encrypted_data_length, int encrypted_data_base64, int curve, cecies_ciphertext_info* out_info);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // CECIES_INSPECT_H
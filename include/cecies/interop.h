@@ -0,0 +1,162 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/**
+ *  @file interop.h
+ *  @author Raphael Beck
+ *  @brief Context-based en-/decryption for language bindings (P/Invoke, FFI, etc...): keys are parsed once, output goes straight into caller-owned (e.g. pinned) memory and whole batches of messages are handled in one call.
+ */
+
+#ifndef CECIES_INTEROP_H
+#define CECIES_INTEROP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "types.h"
+#include "constants.h"
+
+/**
+ * Opaque handle to a set of parsed and validated keys (a public key for encrypting and/or a private key for decrypting), plus the seeded PRNG and curve parameters that every operation needs. <p>
+ * Create one using cecies_curve25519_context_create() or cecies_curve448_context_create() and reuse it for as many messages as you like: none of the key parsing and setup is then repeated per message. <p>
+ * A context is NOT thread-safe (every operation draws from its PRNG): use one context per thread.
+ */
+typedef struct cecies_context cecies_context;
+
+/**
+ * Creates a Curve25519 en-/decryption context. <p>
+ * Keys can be passed either raw (#CECIES_X25519_KEY_SIZE bytes) or hex-encoded (twice that many characters, no NUL-terminator needed): the format is told apart by the length.
+ * @param out_context Where to write the context handle into (only on success). Free it using cecies_context_free() once you're done!
+ * @param public_key [OPTIONAL] The recipient's public key for encrypting. Pass <c>NULL</c> for a decryption-only context.
+ * @param public_key_length The length of the \p public_key array.
+ * @param private_key [OPTIONAL] The private key for decrypting. Pass <c>NULL</c> for an encryption-only context. This is copied into the context (and wiped again on cecies_context_free()), so you can wipe your copy right away.
+ * @param private_key_length The length of the \p private_key array.
+ * @param header_flags Which optional fields to embed into the extended header of the ciphertexts that this context produces (#CECIES_HEADER_FLAG_KEY_ID and/or #CECIES_HEADER_FLAG_KEY_COMMITMENT), or \c 0 for the plain ciphertext format.
+ * @return <c>0</c> on success; #CECIES_CONTEXT_ERROR_CODE_INVALID_ARG if no key was passed or a key has the wrong length or hex format; MbedTLS error codes if a key is not a valid point/scalar on the curve; other <c>CECIES_CONTEXT_ERROR_CODE_*</c> error codes otherwise.
+ */
+CECIES_API int cecies_curve25519_context_create(cecies_context** out_context, const uint8_t* public_key, size_t public_key_length, const uint8_t* private_key, size_t private_key_length, int header_flags);
+
+/**
+ * Creates a Curve448 en-/decryption context. <p>
+ * Keys can be passed either raw (#CECIES_X448_KEY_SIZE bytes) or hex-encoded (twice that many characters, no NUL-terminator needed): the format is told apart by the length.
+ * @param out_context Where to write the context handle into (only on success). Free it using cecies_context_free() once you're done!
+ * @param public_key [OPTIONAL] The recipient's public key for encrypting. Pass <c>NULL</c> for a decryption-only context.
+ * @param public_key_length The length of the \p public_key array.
+ * @param private_key [OPTIONAL] The private key for decrypting. Pass <c>NULL</c> for an encryption-only context. This is copied into the context (and wiped again on cecies_context_free()), so you can wipe your copy right away.
+ * @param private_key_length The length of the \p private_key array.
+ * @param header_flags Which optional fields to embed into the extended header of the ciphertexts that this context produces (#CECIES_HEADER_FLAG_KEY_ID and/or #CECIES_HEADER_FLAG_KEY_COMMITMENT), or \c 0 for the plain ciphertext format.
+ * @return <c>0</c> on success; #CECIES_CONTEXT_ERROR_CODE_INVALID_ARG if no key was passed or a key has the wrong length or hex format; MbedTLS error codes if a key is not a valid point/scalar on the curve; other <c>CECIES_CONTEXT_ERROR_CODE_*</c> error codes otherwise.
+ */
+CECIES_API int cecies_curve448_context_create(cecies_context** out_context, const uint8_t* public_key, size_t public_key_length, const uint8_t* private_key, size_t private_key_length, int header_flags);
+
+/**
+ * Frees a context and wipes the keys it holds.
+ * @param context The context to free (passing <c>NULL</c> is a no-op).
+ */
+CECIES_API void cecies_context_free(cecies_context* context);
+
+/**
+ * Gets the curve of a context.
+ * @param context The context.
+ * @return <c>0</c> for Curve25519, <c>1</c> for Curve448 and <c>-1</c> if \p context is <c>NULL</c>.
+ */
+CECIES_API int cecies_context_get_curve(const cecies_context* context);
+
+/**
+ * Gets the exact size of the ciphertext that cecies_context_encrypt_into() produces for a message of the given length (the output is binary and not compressed). <p>
+ * The per-message overhead is constant, so <c>cecies_context_get_encrypted_size(context, 0)</c> gives you the amount of bytes to add per message when sizing the output of a whole batch.
+ * @param context The context to encrypt with.
+ * @param data_length The length of the message.
+ * @return The ciphertext length in bytes (<c>0</c> if \p context is <c>NULL</c>).
+ */
+CECIES_API size_t cecies_context_get_encrypted_size(const cecies_context* context, size_t data_length);
+
+/**
+ * Gets the exact size of the plaintext that cecies_context_decrypt_into() will produce for the given ciphertext (only the header is parsed: nothing is decrypted or authenticated yet).
+ * @param context The context to decrypt with.
+ * @param encrypted_data The (binary) ciphertext.
+ * @param encrypted_data_length The length of the \p encrypted_data array.
+ * @return The plaintext length in bytes, or <c>0</c> if the ciphertext is invalid or meant for the other curve.
+ */
+CECIES_API size_t cecies_context_get_decrypted_size(const cecies_context* context, const uint8_t* encrypted_data, size_t encrypted_data_length);
+
+/**
+ * Encrypts a message into a caller-provided buffer (e.g. pinned managed memory), using the context's public key. <p>
+ * The output is binary and not compressed (the same format as the <c>cecies_*_encrypt_ext</c> functions produce with <c>compress</c> set to \c 0, using the context's header flags).
+ * @param context The context to encrypt with (it needs a public key).
+ * @param data The data to encrypt.
+ * @param data_length The length of the data array.
+ * @param output Where to write the ciphertext into.
+ * @param output_size How big the \p output buffer is (must be at least cecies_context_get_encrypted_size() bytes).
+ * @param output_length Where to write the amount of bytes written into \p output into.
+ * @return <c>0</c> if encryption succeeded; #CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG if the context has no public key; other <c>CECIES_ENCRYPT_ERROR_CODE_*</c> or MbedTLS error codes otherwise.
+ */
+CECIES_API int cecies_context_encrypt_into(cecies_context* context, const uint8_t* data, size_t data_length, uint8_t* output, size_t output_size, size_t* output_length);
+
+/**
+ * Decrypts a (binary) ciphertext into a caller-provided buffer (e.g. pinned managed memory), using the context's private key. <p>
+ * The decrypted payload is returned as-is: ciphertexts that were compressed before encryption need to be decompressed afterwards (or decrypted using the allocating decryption functions).
+ * @param context The context to decrypt with (it needs a private key).
+ * @param encrypted_data The data to decrypt.
+ * @param encrypted_data_length The length of the \p encrypted_data array.
+ * @param output Where to write the plaintext into.
+ * @param output_size How big the \p output buffer is (must be at least cecies_context_get_decrypted_size() bytes).
+ * @param output_length Where to write the amount of bytes written into \p output into.
+ * @return <c>0</c> if decryption succeeded; #CECIES_DECRYPT_ERROR_CODE_INVALID_ARG if the context has no private key or the ciphertext is invalid; other <c>CECIES_DECRYPT_ERROR_CODE_*</c> or MbedTLS error codes otherwise.
+ */
+CECIES_API int cecies_context_decrypt_into(cecies_context* context, const uint8_t* encrypted_data, size_t encrypted_data_length, uint8_t* output, size_t output_size, size_t* output_length);
+
+/**
+ * Encrypts a whole batch of messages in one call. <p>
+ * The messages are read back to back from \p input, and their ciphertexts are written back to back into \p output (in the same order). <p>
+ * A message that fails doesn't stop the batch: its result is recorded, its output length is set to \c 0 and the next ciphertext is written where it would have started.
+ * @param context The context to encrypt with (it needs a public key).
+ * @param input All of the messages, one after another.
+ * @param input_lengths The length of each message (\p count entries).
+ * @param count The amount of messages.
+ * @param output Where to write the ciphertexts into.
+ * @param output_size How big the \p output buffer is. If every message should fit, that's the total input length plus \p count times <c>cecies_context_get_encrypted_size(context, 0)</c>.
+ * @param output_lengths Where to write each ciphertext's length into (\p count entries).
+ * @param results [OPTIONAL] Where to write each message's result code into (\p count entries): the same as cecies_context_encrypt_into() would have returned for it. Pass <c>NULL</c> if you don't need them.
+ * @return <c>0</c> if all messages were encrypted; otherwise the error code of the first message that failed (or #CECIES_ENCRYPT_ERROR_CODE_NULL_ARG if the arguments themselves are invalid).
+ */
+CECIES_API int cecies_context_encrypt_batch(cecies_context* context, const uint8_t* input, const size_t* input_lengths, size_t count, uint8_t* output, size_t output_size, size_t* output_lengths, int* results);
+
+/**
+ * Decrypts a whole batch of (binary) ciphertexts in one call. <p>
+ * The ciphertexts are read back to back from \p input, and their plaintexts are written back to back into \p output (in the same order). <p>
+ * A ciphertext that fails doesn't stop the batch: its result is recorded, its output length is set to \c 0 and the next plaintext is written where it would have started.
+ * @param context The context to decrypt with (it needs a private key).
+ * @param input All of the ciphertexts, one after another.
+ * @param input_lengths The length of each ciphertext (\p count entries).
+ * @param count The amount of ciphertexts.
+ * @param output Where to write the plaintexts into.
+ * @param output_size How big the \p output buffer is. The total input length is always enough (or sum up cecies_context_get_decrypted_size() for an exact fit).
+ * @param output_lengths Where to write each plaintext's length into (\p count entries).
+ * @param results [OPTIONAL] Where to write each ciphertext's result code into (\p count entries): the same as cecies_context_decrypt_into() would have returned for it. Pass <c>NULL</c> if you don't need them.
+ * @return <c>0</c> if all ciphertexts were decrypted; otherwise the error code of the first ciphertext that failed (or #CECIES_DECRYPT_ERROR_CODE_NULL_ARG if the arguments themselves are invalid).
+ */
+CECIES_API int cecies_context_decrypt_batch(cecies_context* context, const uint8_t* input, const size_t* input_lengths, size_t count, uint8_t* output, size_t output_size, size_t* output_lengths, int* results);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // CECIES_INTEROP_H
@@ -0,0 +1,119 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/**
+ *  @file iovec.h
+ *  @author Raphael Beck
+ *  @brief Scatter-gather encryption and decryption: plaintext and ciphertext can be spread over multiple non-contiguous buffer segments.
+ */
+
+#ifndef CECIES_IOVEC_H
+#define CECIES_IOVEC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "types.h"
+#include "constants.h"
+
+/**
+ * One buffer segment. <p>
+ * This has the same members (and layout) as POSIX' <c>struct iovec</c>, so arrays of those can be passed in using a simple cast.
+ */
+typedef struct cecies_iovec
+{
+    /** Start of the segment. */
+    void* iov_base;
+
+    /** Length of the segment in bytes (empty segments are fine). */
+    size_t iov_len;
+} cecies_iovec;
+
+/**
+ * Encrypts data that's spread over multiple segments (e.g. a message header, a slice of a ring buffer and a trailer) using Curve25519,
+ * writing the ciphertext straight into multiple output segments (e.g. network buffers) without assembling either side into one contiguous buffer first. <p>
+ * The ciphertext is binary and has exactly the same format as the output of cecies_curve25519_encrypt_ext(). The output segments are filled in order,
+ * so the ciphertext is the concatenation of the first \p output_length bytes of them. <p>
+ * If compression is enabled, the data is deflated directly into the output segments and then encrypted in place.
+ * Should the compressed payload not be smaller than the data or not fit into the output segments, the data is encrypted uncompressed instead.
+ * @param data The segments to encrypt (in order).
+ * @param data_count How many segments there are in \p data.
+ * @param compress Should the input data be compressed before encryption? Pass <c>0</c> for no compression, or a compression level from <c>1</c> to <c>9</c>.
+ * @param public_key The public key to encrypt the data with (hex-string format).
+ * @param header_flags Which optional fields to embed into the extended header (see cecies_curve25519_encrypt_ext()). Pass \c 0 for the plain format.
+ * @param output The segments to write the ciphertext into: their total size must be at least <c>cecies_curve25519_calc_output_buffer_needed_size(total data length)</c> (plus the extended header length if \p header_flags isn't \c 0).
+ * @param output_count How many segments there are in \p output.
+ * @param output_length Where to write the ciphertext length into (how many bytes were written into the output segments).
+ * @return <c>0</c> on success; #CECIES_ENCRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE if the output segments are too small; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_curve25519_encrypt_iov(const cecies_iovec* data, size_t data_count, int compress, cecies_curve25519_key public_key, int header_flags, const cecies_iovec* output, size_t output_count, size_t* output_length);
+
+/**
+ * Encrypts data that's spread over multiple segments (e.g. a message header, a slice of a ring buffer and a trailer) using Curve448,
+ * writing the ciphertext straight into multiple output segments (e.g. network buffers) without assembling either side into one contiguous buffer first. <p>
+ * The ciphertext is binary and has exactly the same format as the output of cecies_curve448_encrypt_ext(). The output segments are filled in order,
+ * so the ciphertext is the concatenation of the first \p output_length bytes of them. <p>
+ * If compression is enabled, the data is deflated directly into the output segments and then encrypted in place.
+ * Should the compressed payload not be smaller than the data or not fit into the output segments, the data is encrypted uncompressed instead.
+ * @param data The segments to encrypt (in order).
+ * @param data_count How many segments there are in \p data.
+ * @param compress Should the input data be compressed before encryption? Pass <c>0</c> for no compression, or a compression level from <c>1</c> to <c>9</c>.
+ * @param public_key The public key to encrypt the data with (hex-string format).
+ * @param header_flags Which optional fields to embed into the extended header (see cecies_curve448_encrypt_ext()). Pass \c 0 for the plain format.
+ * @param output The segments to write the ciphertext into: their total size must be at least <c>cecies_curve448_calc_output_buffer_needed_size(total data length)</c> (plus the extended header length if \p header_flags isn't \c 0).
+ * @param output_count How many segments there are in \p output.
+ * @param output_length Where to write the ciphertext length into (how many bytes were written into the output segments).
+ * @return <c>0</c> on success; #CECIES_ENCRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE if the output segments are too small; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_curve448_encrypt_iov(const cecies_iovec* data, size_t data_count, int compress, cecies_curve448_key public_key, int header_flags, const cecies_iovec* output, size_t output_count, size_t* output_length);
+
+/**
+ * Decrypts a binary ciphertext that's spread over multiple segments using Curve25519, writing the plaintext into multiple output segments. <p>
+ * The plaintext is decrypted straight into the output segments and wiped from them again if the authentication tag doesn't match.
+ * Compressed plaintexts are inflated into the output segments chunk by chunk while they're being decrypted (without ever copying the whole compressed payload).
+ * @param encrypted_data The segments that contain the ciphertext (in order).
+ * @param encrypted_data_count How many segments there are in \p encrypted_data.
+ * @param private_key The private key to decrypt the data with (hex-string, as is the output of cecies_generate_curve25519_keypair()). This is passed by value and will be destroyed after usage!
+ * @param output The segments to write the plaintext into: their total size must be at least the ciphertext's payload length (see cecies_inspect()) or, for compressed plaintexts, the decompressed length.
+ * @param output_count How many segments there are in \p output.
+ * @param output_length Where to write the plaintext length into (how many bytes were written into the output segments).
+ * @return <c>0</c> on success; #CECIES_DECRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE if the output segments are too small; #CECIES_DECRYPT_ERROR_CODE_VERIFICATION_FAILED if the ciphertext isn't authentic; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_curve25519_decrypt_iov(const cecies_iovec* encrypted_data, size_t encrypted_data_count, cecies_curve25519_key private_key, const cecies_iovec* output, size_t output_count, size_t* output_length);
+
+/**
+ * Decrypts a binary ciphertext that's spread over multiple segments using Curve448, writing the plaintext into multiple output segments. <p>
+ * The plaintext is decrypted straight into the output segments and wiped from them again if the authentication tag doesn't match.
+ * Compressed plaintexts are inflated into the output segments chunk by chunk while they're being decrypted (without ever copying the whole compressed payload).
+ * @param encrypted_data The segments that contain the ciphertext (in order).
+ * @param encrypted_data_count How many segments there are in \p encrypted_data.
+ * @param private_key The private key to decrypt the data with (hex-string, as is the output of cecies_generate_curve448_keypair()). This is passed by value and will be destroyed after usage!
+ * @param output The segments to write the plaintext into: their total size must be at least the ciphertext's payload length (see cecies_inspect()) or, for compressed plaintexts, the decompressed length.
+ * @param output_count How many segments there are in \p output.
+ * @param output_length Where to write the plaintext length into (how many bytes were written into the output segments).
+ * @return <c>0</c> on success; #CECIES_DECRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE if the output segments are too small; #CECIES_DECRYPT_ERROR_CODE_VERIFICATION_FAILED if the ciphertext isn't authentic; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_curve448_decrypt_iov(const cecies_iovec* encrypted_data, size_t encrypted_data_count, cecies_curve448_key private_key, const cecies_iovec* output, size_t output_count, size_t* output_length);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // CECIES_IOVEC_H
@@ -0,0 +1,97 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/**
+ *  @file kem.h
+ *  @author Raphael Beck
+ *  @brief Key encapsulation: just the ECIES key agreement and key derivation, without the AES256-GCM part (for callers that bring their own cipher).
+ */
+
+#ifndef CECIES_KEM_H
+#define CECIES_KEM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "types.h"
+#include "constants.h"
+
+/**
+ * Length of the HKDF salt that goes along with an encapsulated key.
+ */
+#define CECIES_KEM_SALT_SIZE 32
+
+/**
+ * Length of the derived symmetric key.
+ */
+#define CECIES_KEM_KEY_SIZE 32
+
+/**
+ * Generates an ephemeral Curve25519 key pair and a random salt, performs the key exchange with the recipient's public key and derives a symmetric key from the shared secret. <p>
+ * This is exactly the key that cecies_curve25519_encrypt() would use for AES256-GCM (HKDF-SHA512 over the shared secret with the salt), handed out instead of used:
+ * send the \p ephemeral_public_key and \p salt along with whatever the key protects, so that the recipient can get the same key back using cecies_curve25519_decapsulate(). <p>
+ * Never reuse an encapsulated key with a nonce-based cipher without making sure the nonces are unique!
+ * @param public_key The recipient's public key (hex-string format, as is the output of cecies_generate_curve25519_keypair()).
+ * @param ephemeral_public_key Where to write the #CECIES_X25519_KEY_SIZE bytes of the ephemeral public key into.
+ * @param salt Where to write the #CECIES_KEM_SALT_SIZE bytes of random HKDF salt into.
+ * @param key Where to write the #CECIES_KEM_KEY_SIZE bytes of the derived key into.
+ * @return <c>0</c> on success; error codes as defined inside the header file or MbedTLS otherwise (in that case the output buffers are zeroed).
+ */
+CECIES_API int cecies_curve25519_encapsulate(cecies_curve25519_key public_key, uint8_t ephemeral_public_key[CECIES_X25519_KEY_SIZE], uint8_t salt[CECIES_KEM_SALT_SIZE], uint8_t key[CECIES_KEM_KEY_SIZE]);
+
+/**
+ * Generates an ephemeral Curve448 key pair and a random salt, performs the key exchange with the recipient's public key and derives a symmetric key from the shared secret. <p>
+ * This is exactly the key that cecies_curve448_encrypt() would use for AES256-GCM (HKDF-SHA512 over the shared secret with the salt), handed out instead of used:
+ * send the \p ephemeral_public_key and \p salt along with whatever the key protects, so that the recipient can get the same key back using cecies_curve448_decapsulate(). <p>
+ * Never reuse an encapsulated key with a nonce-based cipher without making sure the nonces are unique!
+ * @param public_key The recipient's public key (hex-string format, as is the output of cecies_generate_curve448_keypair()).
+ * @param ephemeral_public_key Where to write the #CECIES_X448_KEY_SIZE bytes of the ephemeral public key into.
+ * @param salt Where to write the #CECIES_KEM_SALT_SIZE bytes of random HKDF salt into.
+ * @param key Where to write the #CECIES_KEM_KEY_SIZE bytes of the derived key into.
+ * @return <c>0</c> on success; error codes as defined inside the header file or MbedTLS otherwise (in that case the output buffers are zeroed).
+ */
+CECIES_API int cecies_curve448_encapsulate(cecies_curve448_key public_key, uint8_t ephemeral_public_key[CECIES_X448_KEY_SIZE], uint8_t salt[CECIES_KEM_SALT_SIZE], uint8_t key[CECIES_KEM_KEY_SIZE]);
+
+/**
+ * Recovers a key encapsulated using cecies_curve25519_encapsulate(): performs the key exchange with the ephemeral public key and derives the symmetric key from the shared secret and the salt. <p>
+ * There is nothing to authenticate here: a wrong private key (or a tampered-with ephemeral key or salt) just yields a different key, so make sure that whatever cipher it's used with authenticates its data!
+ * @param private_key The recipient's private key (hex-string, as is the output of cecies_generate_curve25519_keypair()). This is passed by value and will be destroyed after usage!
+ * @param ephemeral_public_key The #CECIES_X25519_KEY_SIZE bytes of ephemeral public key that cecies_curve25519_encapsulate() returned.
+ * @param salt The #CECIES_KEM_SALT_SIZE bytes of salt that cecies_curve25519_encapsulate() returned.
+ * @param key Where to write the #CECIES_KEM_KEY_SIZE bytes of the derived key into.
+ * @return <c>0</c> on success; error codes as defined inside the header file or MbedTLS otherwise (in that case \p key is zeroed).
+ */
+CECIES_API int cecies_curve25519_decapsulate(cecies_curve25519_key private_key, const uint8_t ephemeral_public_key[CECIES_X25519_KEY_SIZE], const uint8_t salt[CECIES_KEM_SALT_SIZE], uint8_t key[CECIES_KEM_KEY_SIZE]);
+
+/**
+ * Recovers a key encapsulated using cecies_curve448_encapsulate(): performs the key exchange with the ephemeral public key and derives the symmetric key from the shared secret and the salt. <p>
+ * There is nothing to authenticate here: a wrong private key (or a tampered-with ephemeral key or salt) just yields a different key, so make sure that whatever cipher it's used with authenticates its data!
+ * @param private_key The recipient's private key (hex-string, as is the output of cecies_generate_curve448_keypair()). This is passed by value and will be destroyed after usage!
+ * @param ephemeral_public_key The #CECIES_X448_KEY_SIZE bytes of ephemeral public key that cecies_curve448_encapsulate() returned.
+ * @param salt The #CECIES_KEM_SALT_SIZE bytes of salt that cecies_curve448_encapsulate() returned.
+ * @param key Where to write the #CECIES_KEM_KEY_SIZE bytes of the derived key into.
+ * @return <c>0</c> on success; error codes as defined inside the header file or MbedTLS otherwise (in that case \p key is zeroed).
+ */
+CECIES_API int cecies_curve448_decapsulate(cecies_curve448_key private_key, const uint8_t ephemeral_public_key[CECIES_X448_KEY_SIZE], const uint8_t salt[CECIES_KEM_SALT_SIZE], uint8_t key[CECIES_KEM_KEY_SIZE]);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // CECIES_KEM_H
@@ -0,0 +1,123 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/**
+ *  @file keyring.h
+ *  @author Raphael Beck
+ *  @brief Memory-mapped keyring files: many binary private keys, indexed by key ID for O(1) lookup during decryption.
+ */
+
+#ifndef CECIES_KEYRING_H
+#define CECIES_KEYRING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "types.h"
+#include "constants.h"
+
+/**
+ * Opaque handle to a keyring file that was mapped into memory (read-only) using cecies_keyring_open(). <p>
+ * The mapping is shared with the OS page cache, so multiple worker processes opening the same keyring file don't duplicate it in RAM.
+ * A keyring handle is immutable after opening and can thus be used concurrently from multiple threads.
+ */
+typedef struct cecies_keyring cecies_keyring;
+
+/**
+ * Writes a keyring file containing the given Curve25519 keys. <p>
+ * The keys are stored in binary form together with a hash index over their key IDs (the truncated SHA2-512 of the public key).
+ * The public keys themselves are only needed to compute the key IDs and are NOT checked against the private keys, so make sure they match! <p>
+ * <strong>The keyring file contains the private keys in plaintext:</strong> on POSIX systems it is created with permissions <c>0600</c>, but please protect it accordingly.
+ * @param file_path Where to write the keyring file to (an existing file will be overwritten).
+ * @param keypairs The key pairs to store.
+ * @param keypairs_count How many key pairs there are in the \p keypairs array.
+ * @return <c>0</c> on success; <c>CECIES_KEYRING_ERROR_CODE_*</c> error codes otherwise (#CECIES_KEYRING_ERROR_CODE_INVALID_ARG if a key is invalid or two public keys share the same key ID).
+ */
+CECIES_API int cecies_curve25519_keyring_write(const char* file_path, const cecies_curve25519_keypair* keypairs, size_t keypairs_count);
+
+/**
+ * Writes a keyring file containing the given Curve448 keys. <p>
+ * The keys are stored in binary form together with a hash index over their key IDs (the truncated SHA2-512 of the public key).
+ * The public keys themselves are only needed to compute the key IDs and are NOT checked against the private keys, so make sure they match! <p>
+ * <strong>The keyring file contains the private keys in plaintext:</strong> on POSIX systems it is created with permissions <c>0600</c>, but please protect it accordingly.
+ * @param file_path Where to write the keyring file to (an existing file will be overwritten).
+ * @param keypairs The key pairs to store.
+ * @param keypairs_count How many key pairs there are in the \p keypairs array.
+ * @return <c>0</c> on success; <c>CECIES_KEYRING_ERROR_CODE_*</c> error codes otherwise (#CECIES_KEYRING_ERROR_CODE_INVALID_ARG if a key is invalid or two public keys share the same key ID).
+ */
+CECIES_API int cecies_curve448_keyring_write(const char* file_path, const cecies_curve448_keypair* keypairs, size_t keypairs_count);
+
+/**
+ * Maps a keyring file (as written by cecies_curve25519_keyring_write() or cecies_curve448_keyring_write()) read-only into memory. <p>
+ * Nothing is parsed or copied: opening is instant regardless of the amount of keys in the file.
+ * @param file_path The keyring file to open.
+ * @param out_keyring Where to write the keyring handle into. Close it using cecies_keyring_close() once you're done!
+ * @return <c>0</c> on success; <c>CECIES_KEYRING_ERROR_CODE_*</c> error codes otherwise.
+ */
+CECIES_API int cecies_keyring_open(const char* file_path, cecies_keyring** out_keyring);
+
+/**
+ * Unmaps a keyring and frees its handle.
+ * @param keyring The keyring to close (passing <c>NULL</c> is a no-op).
+ */
+CECIES_API void cecies_keyring_close(cecies_keyring* keyring);
+
+/**
+ * Gets the curve of the keys inside a keyring.
+ * @param keyring The keyring.
+ * @return <c>0</c> for Curve25519, <c>1</c> for Curve448 and <c>-1</c> if \p keyring is <c>NULL</c>.
+ */
+CECIES_API int cecies_keyring_get_curve(const cecies_keyring* keyring);
+
+/**
+ * Gets the amount of keys that are stored inside a keyring.
+ * @param keyring The keyring.
+ * @return The number of keys inside the keyring (<c>0</c> if \p keyring is <c>NULL</c>).
+ */
+CECIES_API size_t cecies_keyring_get_key_count(const cecies_keyring* keyring);
+
+/**
+ * Looks up a private key by its key ID.
+ * @param keyring The keyring to search.
+ * @param key_id The #CECIES_KEY_ID_SIZE bytes long key ID to look for.
+ * @param out_private_key Where to write the pointer to the raw private key bytes into. This points into the read-only keyring mapping and is valid until the keyring is closed: don't free it!
+ * @param out_private_key_length [OPTIONAL] Where to write the private key length into (#CECIES_X25519_KEY_SIZE or #CECIES_X448_KEY_SIZE). Pass <c>NULL</c> if you don't need it.
+ * @return <c>0</c> if the key was found; #CECIES_KEYRING_ERROR_CODE_KEY_NOT_FOUND if not; other <c>CECIES_KEYRING_ERROR_CODE_*</c> error codes on failure.
+ */
+CECIES_API int cecies_keyring_find(const cecies_keyring* keyring, const uint8_t* key_id, const uint8_t** out_private_key, size_t* out_private_key_length);
+
+/**
+ * Decrypts a ciphertext using the private key from the keyring that matches the key ID hint embedded in the ciphertext's extended header. <p>
+ * The ciphertext must have been encrypted using the #CECIES_HEADER_FLAG_KEY_ID header flag (see cecies_curve25519_encrypt_ext() or cecies_curve448_encrypt_ext()).
+ * @param keyring The keyring that contains the recipient's private key.
+ * @param encrypted_data The data to decrypt.
+ * @param encrypted_data_length The length of the data array.
+ * @param encrypted_data_base64 Is the input \p encrypted_data base64-encoded? Pass \c 0 for \c false, anything else for \c true.
+ * @param output Where to write the decrypted output into (this will ONLY be allocated if decryption succeeds; if the procedure fails in any way this is left untouched). On success: DO NOT FORGET TO FREE THIS YOURSELF! Use #cecies_free() for freeing.
+ * @param output_length Where to write the output buffer length into (how many bytes were written into it).
+ * @return <c>0</c> if decryption succeeded; #CECIES_KEYRING_ERROR_CODE_KEY_NOT_FOUND if the ciphertext has no key ID hint or its key isn't in the keyring; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_keyring_decrypt(const cecies_keyring* keyring, const uint8_t* encrypted_data, size_t encrypted_data_length, int encrypted_data_base64, uint8_t** output, size_t* output_length);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // CECIES_KEYRING_H
@@ -0,0 +1,90 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/**
+ *  @file reader.h
+ *  @author Raphael Beck
+ *  @brief Pull-based reading of decrypted payloads: compressed plaintexts are only inflated as far as they're actually read.
+ */
+
+#ifndef CECIES_READER_H
+#define CECIES_READER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "types.h"
+#include "constants.h"
+
+/**
+ * Opaque plaintext reader handle. Create one using cecies_curve25519_decrypt_reader() or cecies_curve448_decrypt_reader(). <p>
+ * A reader holds the decrypted (still compressed) payload and inflates it piece by piece into whatever buffer is passed to cecies_reader_read(),
+ * so peak memory usage is the compressed plaintext plus one read buffer instead of the whole decompressed plaintext.
+ * Consumers that only need the beginning of a plaintext can stop reading at any time and skip the rest of the decompression work.
+ */
+typedef struct cecies_reader cecies_reader;
+
+/**
+ * Decrypts and authenticates a ciphertext using a Curve25519 private key and returns a reader for its plaintext. <p>
+ * The GCM authentication tag is verified <strong>before</strong> the reader is returned: everything read from it is authentic.
+ * @param encrypted_data The data to decrypt.
+ * @param encrypted_data_length The length of the data array.
+ * @param encrypted_data_base64 Is the input \p encrypted_data base64-encoded? Pass \c 0 for \c false, anything else for \c true.
+ * @param private_key The private key to decrypt the data with (hex-string format).
+ * @param out_reader Where to write the reader handle into (only on success). Free it using cecies_reader_free() once you're done!
+ * @return <c>0</c> if decryption succeeded; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_curve25519_decrypt_reader(const uint8_t* encrypted_data, size_t encrypted_data_length, int encrypted_data_base64, cecies_curve25519_key private_key, cecies_reader** out_reader);
+
+/**
+ * Decrypts and authenticates a ciphertext using a Curve448 private key and returns a reader for its plaintext. <p>
+ * The GCM authentication tag is verified <strong>before</strong> the reader is returned: everything read from it is authentic.
+ * @param encrypted_data The data to decrypt.
+ * @param encrypted_data_length The length of the data array.
+ * @param encrypted_data_base64 Is the input \p encrypted_data base64-encoded? Pass \c 0 for \c false, anything else for \c true.
+ * @param private_key The private key to decrypt the data with (hex-string format).
+ * @param out_reader Where to write the reader handle into (only on success). Free it using cecies_reader_free() once you're done!
+ * @return <c>0</c> if decryption succeeded; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_curve448_decrypt_reader(const uint8_t* encrypted_data, size_t encrypted_data_length, int encrypted_data_base64, cecies_curve448_key private_key, cecies_reader** out_reader);
+
+/**
+ * Reads the next piece of plaintext, decompressing only as much as is needed to fill \p output. <p>
+ * Plaintexts that weren't compressed are simply copied out. Just like cecies_curve25519_decrypt() does, a plaintext that starts like a zlib stream
+ * but can't be inflated right away is treated as uncompressed.
+ * @param reader The reader.
+ * @param output Where to write the plaintext into.
+ * @param output_size How many bytes to read at most (the size of the \p output buffer). Every call fills the whole buffer unless the end of the plaintext is reached.
+ * @param output_length Where to write the number of bytes that were read into: <c>0</c> means that the end of the plaintext was reached.
+ * @return <c>0</c> on success; #CECIES_DECRYPT_ERROR_CODE_DECOMPRESSION_FAILED if the compressed plaintext turns out to be corrupt further in (including an Adler-32 mismatch at its end); other error codes as defined inside the header file otherwise.
+ */
+CECIES_API int cecies_reader_read(cecies_reader* reader, uint8_t* output, size_t output_size, size_t* output_length);
+
+/**
+ * Frees a reader (wiping the plaintext it holds). Remaining plaintext doesn't need to be read first.
+ * @param reader The reader to free (passing <c>NULL</c> is a no-op).
+ */
+CECIES_API void cecies_reader_free(cecies_reader* reader);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // CECIES_READER_H
@@ -0,0 +1,128 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/**
+ *  @file restartable.h
+ *  @author Raphael Beck
+ *  @brief Restartable en-/decryption: the work is split into bounded steps, so that it can be interleaved with other work on a single thread (e.g. an event loop).
+ */
+
+#ifndef CECIES_RESTARTABLE_H
+#define CECIES_RESTARTABLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "types.h"
+#include "constants.h"
+
+/**
+ * Opaque handle to a restartable encryption or decryption operation. <p>
+ * Create one using one of the <c>cecies_*_encrypt_restartable_init</c> or <c>cecies_*_decrypt_restartable_init</c> functions,
+ * then call cecies_restartable_step() until it stops returning #CECIES_RESTARTABLE_IN_PROGRESS. <p>
+ * One step performs at most one of the following stages (or a bounded part of it):
+ * <ul>
+ * <li>Setup (PRNG seeding, key parsing and validation)</li>
+ * <li>Ephemeral key generation (encryption only), \p ecp_max_bits scalar bits at a time</li>
+ * <li>ECDH (the scalar multiplication that computes the shared secret), \p ecp_max_bits scalar bits at a time</li>
+ * <li>Key derivation (HKDF-SHA512)</li>
+ * <li>AES-GCM, \p gcm_chunk_size bytes at a time</li>
+ * <li>Decompression (decryption of compressed payloads only), \p gcm_chunk_size bytes of output at a time</li>
+ * </ul>
+ * The scalar multiplications run CECIES' own constant-time Montgomery ladder (RFC 7748), which spends about the same time on every scalar bit:
+ * a Curve25519 multiplication has 255 of them and a Curve448 one 448. The budget belongs to the handle, so concurrent operations don't affect each other.
+ */
+typedef struct cecies_restartable cecies_restartable;
+
+/**
+ * Prepares a restartable encryption using ECIES over Curve25519 and AES256-GCM. Nothing expensive happens here: all of the work is done by cecies_restartable_step(). <p>
+ * The output is binary and not compressed (it's the same format as cecies_curve25519_encrypt_ext() produces with <c>compress</c> set to \c 0).
+ * @param out_ctx Where to write the handle into (only on success). Free it using cecies_restartable_free() once you're done!
+ * @param data The data to encrypt. This is NOT copied: it must stay valid (and unchanged) until the operation has completed!
+ * @param data_length The length of the data array.
+ * @param public_key The public key to encrypt the data with (hex-string format, as is the output of cecies_generate_curve25519_keypair()).
+ * @param header_flags Which optional fields to embed into the extended header (#CECIES_HEADER_FLAG_KEY_ID and/or #CECIES_HEADER_FLAG_KEY_COMMITMENT), or \c 0 for the plain ciphertext format.
+ * @param gcm_chunk_size How many bytes of payload to en-/decrypt per step (rounded down to a multiple of 16). Pass <c>0</c> for #CECIES_RESTARTABLE_DEFAULT_GCM_CHUNK_SIZE.
+ * @param ecp_max_bits Maximum amount of scalar bits per step to run the scalar multiplications over (see #cecies_restartable). Pass <c>0</c> to do each one in a single step.
+ * @return <c>0</c> on success; error codes as defined inside the header file otherwise.
+ */
+CECIES_API int cecies_curve25519_encrypt_restartable_init(cecies_restartable** out_ctx, const uint8_t* data, size_t data_length, cecies_curve25519_key public_key, int header_flags, size_t gcm_chunk_size, unsigned int ecp_max_bits);
+
+/**
+ * Prepares a restartable encryption using ECIES over Curve448 and AES256-GCM. Nothing expensive happens here: all of the work is done by cecies_restartable_step(). <p>
+ * The output is binary and not compressed (it's the same format as cecies_curve448_encrypt_ext() produces with <c>compress</c> set to \c 0).
+ * @param out_ctx Where to write the handle into (only on success). Free it using cecies_restartable_free() once you're done!
+ * @param data The data to encrypt. This is NOT copied: it must stay valid (and unchanged) until the operation has completed!
+ * @param data_length The length of the data array.
+ * @param public_key The public key to encrypt the data with (hex-string format, as is the output of cecies_generate_curve448_keypair()).
+ * @param header_flags Which optional fields to embed into the extended header (#CECIES_HEADER_FLAG_KEY_ID and/or #CECIES_HEADER_FLAG_KEY_COMMITMENT), or \c 0 for the plain ciphertext format.
+ * @param gcm_chunk_size How many bytes of payload to en-/decrypt per step (rounded down to a multiple of 16). Pass <c>0</c> for #CECIES_RESTARTABLE_DEFAULT_GCM_CHUNK_SIZE.
+ * @param ecp_max_bits Maximum amount of scalar bits per step to run the scalar multiplications over (see #cecies_restartable). Pass <c>0</c> to do each one in a single step.
+ * @return <c>0</c> on success; error codes as defined inside the header file otherwise.
+ */
+CECIES_API int cecies_curve448_encrypt_restartable_init(cecies_restartable** out_ctx, const uint8_t* data, size_t data_length, cecies_curve448_key public_key, int header_flags, size_t gcm_chunk_size, unsigned int ecp_max_bits);
+
+/**
+ * Prepares a restartable decryption of a binary ciphertext that was encrypted using Curve25519. Nothing expensive happens here: all of the work is done by cecies_restartable_step(). <p>
+ * If the decrypted payload turns out to be compressed, the final steps also decompress it.
+ * @param out_ctx Where to write the handle into (only on success). Free it using cecies_restartable_free() once you're done!
+ * @param encrypted_data The binary (non-base64) data to decrypt. This is NOT copied: it must stay valid (and unchanged) until the operation has completed!
+ * @param encrypted_data_length The length of the data array.
+ * @param private_key The private key to decrypt the data with (hex-string format). This is passed by value and will be destroyed after usage!
+ * @param gcm_chunk_size How many bytes of payload to decrypt per step (rounded down to a multiple of 16). Pass <c>0</c> for #CECIES_RESTARTABLE_DEFAULT_GCM_CHUNK_SIZE.
+ * @param ecp_max_bits Maximum amount of scalar bits per step to run the scalar multiplications over (see #cecies_restartable). Pass <c>0</c> to do each one in a single step.
+ * @return <c>0</c> on success; error codes as defined inside the header file otherwise.
+ */
+CECIES_API int cecies_curve25519_decrypt_restartable_init(cecies_restartable** out_ctx, const uint8_t* encrypted_data, size_t encrypted_data_length, cecies_curve25519_key private_key, size_t gcm_chunk_size, unsigned int ecp_max_bits);
+
+/**
+ * Prepares a restartable decryption of a binary ciphertext that was encrypted using Curve448. Nothing expensive happens here: all of the work is done by cecies_restartable_step(). <p>
+ * If the decrypted payload turns out to be compressed, the final steps also decompress it.
+ * @param out_ctx Where to write the handle into (only on success). Free it using cecies_restartable_free() once you're done!
+ * @param encrypted_data The binary (non-base64) data to decrypt. This is NOT copied: it must stay valid (and unchanged) until the operation has completed!
+ * @param encrypted_data_length The length of the data array.
+ * @param private_key The private key to decrypt the data with (hex-string format). This is passed by value and will be destroyed after usage!
+ * @param gcm_chunk_size How many bytes of payload to decrypt per step (rounded down to a multiple of 16). Pass <c>0</c> for #CECIES_RESTARTABLE_DEFAULT_GCM_CHUNK_SIZE.
+ * @param ecp_max_bits Maximum amount of scalar bits per step to run the scalar multiplications over (see #cecies_restartable). Pass <c>0</c> to do each one in a single step.
+ * @return <c>0</c> on success; error codes as defined inside the header file otherwise.
+ */
+CECIES_API int cecies_curve448_decrypt_restartable_init(cecies_restartable** out_ctx, const uint8_t* encrypted_data, size_t encrypted_data_length, cecies_curve448_key private_key, size_t gcm_chunk_size, unsigned int ecp_max_bits);
+
+/**
+ * Performs the next bounded piece of work of a restartable operation.
+ * @param ctx The restartable operation.
+ * @param output Where to write the output (ciphertext or plaintext) into once the operation completes. On success: DO NOT FORGET TO FREE THIS YOURSELF! Use #cecies_free() for freeing.
+ * @param output_length Where to write the output length into once the operation completes.
+ * @return #CECIES_RESTARTABLE_IN_PROGRESS if there is more work to do (call this again later); <c>0</c> once the operation has completed (and \p output was written); error codes as defined inside the header file or MbedTLS otherwise.
+ * Once a step failed, all further steps fail with the same error code.
+ */
+CECIES_API int cecies_restartable_step(cecies_restartable* ctx, uint8_t** output, size_t* output_length);
+
+/**
+ * Frees a restartable operation handle (wiping all keys and intermediate secrets). The operation doesn't need to be complete: this is also how you cancel one.
+ * @param ctx The handle to free (passing <c>NULL</c> is a no-op).
+ */
+CECIES_API void cecies_restartable_free(cecies_restartable* ctx);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // CECIES_RESTARTABLE_H
@@ -0,0 +1,174 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/**
+ *  @file stream.h
+ *  @author Raphael Beck
+ *  @brief Incremental (init/update/finish) encryption and decryption that produces and consumes the exact same ciphertext format as the one-shot functions.
+ */
+
+#ifndef CECIES_STREAM_H
+#define CECIES_STREAM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "types.h"
+#include "constants.h"
+
+/**
+ * Opaque incremental encryption context. Create one using cecies_curve25519_encrypt_stream_init() or cecies_curve448_encrypt_stream_init().
+ */
+typedef struct cecies_encrypt_stream cecies_encrypt_stream;
+
+/**
+ * Opaque incremental decryption context. Create one using cecies_curve25519_decrypt_stream_init() or cecies_curve448_decrypt_stream_init().
+ */
+typedef struct cecies_decrypt_stream cecies_decrypt_stream;
+
+/**
+ * Starts an incremental Curve25519 encryption. <p>
+ * The ciphertext header is written into \p header right away, but its authentication tag slot stays zeroed until cecies_encrypt_stream_finish() back-patches it:
+ * so write the header to the beginning of your (seekable) output buffer or file, followed by the output of each cecies_encrypt_stream_update() call. <p>
+ * The output is exactly the same format as the one of cecies_curve25519_encrypt_ext() (without compression and base64-encoding, which aren't available incrementally).
+ * @param out_stream Where to write the new encryption context into. Free it using cecies_encrypt_stream_free() once you're done!
+ * @param public_key The public key to encrypt the data with (hex-string format).
+ * @param header_flags Which optional fields to embed into the extended header (see cecies_curve25519_encrypt_ext()). Pass \c 0 for the plain format.
+ * @param header Where to write the ciphertext header into.
+ * @param header_size Size of the \p header buffer (#CECIES_MAX_HEADER_SIZE is always enough).
+ * @param header_length Where to write the header length into (how many bytes were written into \p header).
+ * @return <c>0</c> on success; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_curve25519_encrypt_stream_init(cecies_encrypt_stream** out_stream, cecies_curve25519_key public_key, int header_flags, uint8_t* header, size_t header_size, size_t* header_length);
+
+/**
+ * Starts an incremental Curve448 encryption. <p>
+ * The ciphertext header is written into \p header right away, but its authentication tag slot stays zeroed until cecies_encrypt_stream_finish() back-patches it:
+ * so write the header to the beginning of your (seekable) output buffer or file, followed by the output of each cecies_encrypt_stream_update() call. <p>
+ * The output is exactly the same format as the one of cecies_curve448_encrypt_ext() (without compression and base64-encoding, which aren't available incrementally).
+ * @param out_stream Where to write the new encryption context into. Free it using cecies_encrypt_stream_free() once you're done!
+ * @param public_key The public key to encrypt the data with (hex-string format).
+ * @param header_flags Which optional fields to embed into the extended header (see cecies_curve448_encrypt_ext()). Pass \c 0 for the plain format.
+ * @param header Where to write the ciphertext header into.
+ * @param header_size Size of the \p header buffer (#CECIES_MAX_HEADER_SIZE is always enough).
+ * @param header_length Where to write the header length into (how many bytes were written into \p header).
+ * @return <c>0</c> on success; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_curve448_encrypt_stream_init(cecies_encrypt_stream** out_stream, cecies_curve448_key public_key, int header_flags, uint8_t* header, size_t header_size, size_t* header_length);
+
+/**
+ * Encrypts the next piece of data. <p>
+ * Up to 15 bytes of input may be held back internally until more data arrives (or until cecies_encrypt_stream_finish() is called).
+ * @param stream The encryption context.
+ * @param data The next piece of plaintext.
+ * @param data_length Length of the \p data array.
+ * @param output Where to write the ciphertext bytes into.
+ * @param output_size Size of the \p output buffer: <c>data_length + 15</c> is always enough.
+ * @param output_length Where to write the amount of ciphertext bytes that were written into \p output.
+ * @return <c>0</c> on success; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_encrypt_stream_update(cecies_encrypt_stream* stream, const uint8_t* data, size_t data_length, uint8_t* output, size_t output_size, size_t* output_length);
+
+/**
+ * Finishes an incremental encryption: flushes the remaining ciphertext bytes and back-patches the authentication tag into the header.
+ * @param stream The encryption context. After this, it can only be freed.
+ * @param output Where to write the remaining ciphertext bytes into (they come after everything that cecies_encrypt_stream_update() produced).
+ * @param output_size Size of the \p output buffer (16 bytes are always enough).
+ * @param output_length Where to write the amount of bytes that were written into \p output.
+ * @param header The header that was written by the init function (e.g. the beginning of your output buffer): its tag slot is filled in.
+ * @return <c>0</c> on success; #CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG if no data at all was encrypted; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_encrypt_stream_finish(cecies_encrypt_stream* stream, uint8_t* output, size_t output_size, size_t* output_length, uint8_t* header);
+
+/**
+ * Finishes an incremental encryption into a file: the remaining ciphertext bytes are written at the current file position,
+ * then the authentication tag is back-patched into the header (which was written at \p header_position) and the file position is restored to the end of the ciphertext.
+ * @param stream The encryption context. After this, it can only be freed.
+ * @param file The (seekable) file that the header and the output of all cecies_encrypt_stream_update() calls were written into.
+ * @param header_position The file position where the header was written to (e.g. <c>0</c> if the ciphertext starts at the beginning of the file).
+ * @return <c>0</c> on success; #CECIES_ENCRYPT_ERROR_CODE_FILE_ACCESS_FAILED if writing or seeking failed; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_encrypt_stream_finish_file(cecies_encrypt_stream* stream, FILE* file, long header_position);
+
+/**
+ * Frees an encryption context (and wipes the key material inside it).
+ * @param stream The encryption context to free (passing <c>NULL</c> is a no-op).
+ */
+CECIES_API void cecies_encrypt_stream_free(cecies_encrypt_stream* stream);
+
+/**
+ * Starts an incremental Curve25519 decryption. Feed it the binary ciphertext piece by piece using cecies_decrypt_stream_update().
+ * @param out_stream Where to write the new decryption context into. Free it using cecies_decrypt_stream_free() once you're done!
+ * @param private_key The private key to decrypt the data with (hex-string, as is the output of cecies_generate_curve25519_keypair()). This is passed by value and will be destroyed after usage!
+ * @return <c>0</c> on success; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_curve25519_decrypt_stream_init(cecies_decrypt_stream** out_stream, cecies_curve25519_key private_key);
+
+/**
+ * Starts an incremental Curve448 decryption. Feed it the binary ciphertext piece by piece using cecies_decrypt_stream_update().
+ * @param out_stream Where to write the new decryption context into. Free it using cecies_decrypt_stream_free() once you're done!
+ * @param private_key The private key to decrypt the data with (hex-string, as is the output of cecies_generate_curve448_keypair()). This is passed by value and will be destroyed after usage!
+ * @return <c>0</c> on success; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_curve448_decrypt_stream_init(cecies_decrypt_stream** out_stream, cecies_curve448_key private_key);
+
+/**
+ * Tells the decryption context how long the whole (binary) ciphertext is going to be (e.g. the size of the file that you're decrypting). <p>
+ * The plaintext is collected until the authentication tag is verified: with this hint, it's decrypted into one exactly sized buffer
+ * instead of one that keeps growing (and being copied over) as cecies_decrypt_stream_update() is fed more data.
+ * A wrong hint doesn't break anything; it only costs extra memory (too long) or brings back the growing buffer (too short).
+ * @param stream The decryption context. This must be called before any payload was decrypted (best right after the init function).
+ * @param encrypted_data_length The total length of the binary ciphertext, header included.
+ * @return <c>0</c> on success; #CECIES_DECRYPT_ERROR_CODE_NULL_ARG if \p stream is <c>NULL</c>; #CECIES_DECRYPT_ERROR_CODE_INVALID_ARG if it's too late to give a hint.
+ */
+CECIES_API int cecies_decrypt_stream_set_length_hint(cecies_decrypt_stream* stream, size_t encrypted_data_length);
+
+/**
+ * Processes the next piece of the (binary) ciphertext. <p>
+ * The ciphertext is decrypted right away, but the plaintext is only released by cecies_decrypt_stream_finish() after the authentication tag was verified
+ * (if you know the total ciphertext length up front, pass it to cecies_decrypt_stream_set_length_hint() to avoid reallocations).
+ * @param stream The decryption context.
+ * @param encrypted_data The next piece of ciphertext (arbitrary piece sizes are fine, including pieces that split the header).
+ * @param encrypted_data_length The length of the \p encrypted_data array.
+ * @return <c>0</c> on success; error codes as defined inside the header file or MbedTLS otherwise (e.g. #CECIES_DECRYPT_ERROR_CODE_WRONG_KEY as soon as the header's key commitment doesn't match).
+ */
+CECIES_API int cecies_decrypt_stream_update(cecies_decrypt_stream* stream, const uint8_t* encrypted_data, size_t encrypted_data_length);
+
+/**
+ * Finishes an incremental decryption: verifies the authentication tag and, if the ciphertext is authentic, releases the plaintext.
+ * @param stream The decryption context. After this, it can only be freed.
+ * @param output Where to write the decrypted output into (this will ONLY be allocated if decryption succeeds; if the procedure fails in any way this is left untouched). On success: DO NOT FORGET TO FREE THIS YOURSELF! Use #cecies_free() for freeing.
+ * @param output_length Where to write the output buffer length into (how many bytes were written into it).
+ * @return <c>0</c> if decryption succeeded; #CECIES_DECRYPT_ERROR_CODE_VERIFICATION_FAILED if the tag doesn't match; error codes as defined inside the header file or MbedTLS otherwise.
+ */
+CECIES_API int cecies_decrypt_stream_finish(cecies_decrypt_stream* stream, uint8_t** output, size_t* output_length);
+
+/**
+ * Frees a decryption context (and wipes the key material and any unreleased plaintext inside it).
+ * @param stream The decryption context to free (passing <c>NULL</c> is a no-op).
+ */
+CECIES_API void cecies_decrypt_stream_free(cecies_decrypt_stream* stream);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // CECIES_STREAM_H
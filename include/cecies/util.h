@@ -104,6 +104,28 @@ static inline size_t cecies_curve448_calc_output_buffer_needed_size(const size_t
     return cecies_calc_output_buffer_needed_size(input_buffer_length, CECIES_X448_KEY_SIZE);
 }
 
+/**
+ * Gets the length of the extended ciphertext header that is prepended to the ciphertext when encrypting using a given set of header flags. <p>
+ * The extended header consists of #CECIES_EXT_HEADER_MAGIC_SIZE magic bytes, one flags byte and then the optional fields requested by the flags (in the order of the flags' bit values).
+ * @param header_flags The <c>CECIES_HEADER_FLAG_*</c> flags that you'd pass to one of the <c>cecies_*_encrypt_ext</c> functions.
+ * @return The extended header length in bytes; <c>0</c> if the flags don't request any extended header field (in that case the plain, backwards-compatible ciphertext format is used).
+ */
+static inline size_t cecies_calc_ext_header_length(const int header_flags)
+{
+    if ((header_flags & ~CECIES_HEADER_FLAG_CURVE448) == 0)
+    {
+        return 0;
+    }
+
+    //     1                              2   3                                                                 4
+    return CECIES_EXT_HEADER_MAGIC_SIZE + 1 + ((header_flags & CECIES_HEADER_FLAG_KEY_ID) ? CECIES_KEY_ID_SIZE : 0) + ((header_flags & CECIES_HEADER_FLAG_KEY_COMMITMENT) ? CECIES_KEY_COMMITMENT_SIZE : 0);
+
+    // 1:  Magic bytes
+    // 2:  Flags
+    // 3:  Key ID (optional)
+    // 4:  Key commitment (optional)
+}
+
 /**
  * Calculates the output length in bytes after base64-encoding \p data_length bytes (includes +1 for a NUL-terminator character)..
  * @param data_length The number of bytes you'd base64-encode.
@@ -185,6 +207,96 @@ CECIES_API void cecies_disable_fprintf();
 /** @private */
 #define cecies_fprintf cecies_fprintf_fptr
 
+/**
+ * Global performance settings: which code paths CECIES uses for the work (multi-threading and SIMD). <p>
+ * None of these change any output: ciphertexts, keys and signatures are bit-identical either way (except for the compressed payloads of parallel compression, which are a few bytes bigger but just as standard), so they only affect speed. <p>
+ * The settings are process-wide and every field is stored atomically, so changing them while other threads are en-/decrypting is safe:
+ * each operation reads the settings it needs once when it starts, so operations that are already running finish with the values they saw back then.
+ */
+typedef struct cecies_config
+{
+    /** AES-GCM en-/decryption of payloads of at least this many bytes is spread across multiple threads (default: #CECIES_PARALLEL_GCM_DEFAULT_THRESHOLD). \c 0 always uses the single-threaded path. */
+    size_t parallel_gcm_threshold;
+
+    /** The maximum number of threads (including the calling thread) for parallel AES-GCM. \c 0 uses one per CPU core (the default). */
+    size_t parallel_gcm_thread_count;
+
+    /**
+     * Inputs of at least this many bytes are compressed (if requested when encrypting) using multiple threads (default: #CECIES_PARALLEL_COMPRESSION_DEFAULT_THRESHOLD). \c 0 always compresses single-threaded. <p>
+     * The parallel compressor deflates blocks of the input independently (each one primed with the tail of the previous block) and stitches them together into one standard zlib stream,
+     * so decryption doesn't need to know about it.
+     */
+    size_t parallel_compression_threshold;
+
+    /** The maximum number of threads (including the calling thread) for parallel compression. \c 0 uses one per CPU core (the default). */
+    size_t parallel_compression_thread_count;
+
+    /**
+     * Use the multi-buffer AES-GCM kernel, which en-/decrypts several independent messages in lockstep whenever CECIES gets them all at once
+     * (e.g. cecies_context_encrypt_batch() and cecies_context_decrypt_batch())? It needs AES-NI and PCLMULQDQ (checked at runtime); without those, MbedTLS handles one message after the other anyway.
+     * \c 0 always hands messages to MbedTLS one at a time; anything else uses the kernel where available (the default).
+     */
+    int multi_buffer_gcm;
+
+    /**
+     * Use the multi-buffer SHA-512, which derives the keys (HKDF-SHA512) of several messages at once whenever CECIES gets them all at once:
+     * 8 at a time with AVX-512, 4 at a time with AVX2 (checked at runtime). Without either, MbedTLS derives one message's keys after the other.
+     * \c 0 always derives keys through MbedTLS; anything else uses the multi-buffer SHA-512 where available (the default).
+     */
+    int multi_buffer_sha512;
+
+    /**
+     * The SIMD width limit of the multi-lane X25519 implementation, which computes the Curve25519 key agreements (and ephemeral keys) of several messages at once whenever CECIES gets them all at once:
+     * 8 at a time with AVX-512, 4 at a time with AVX2 (checked at runtime); without either, MbedTLS handles one key agreement after the other.
+     * \c 8 allows AVX-512 (the default), \c 4 sticks to AVX2 (e.g. where AVX-512 lowers the clock speed too much) and \c 0 always uses MbedTLS.
+     */
+    size_t simd_x25519_max_lanes;
+} cecies_config;
+
+/**
+ * Gets the current global settings (see #cecies_config).
+ * @param config Where to write the settings into.
+ */
+CECIES_API void cecies_get_config(cecies_config* config);
+
+/**
+ * Replaces all global settings at once (see #cecies_config): to only change some of them, get them using cecies_get_config() first and pass them back in modified.
+ * @param config The new settings, or <c>NULL</c> to restore the defaults.
+ */
+CECIES_API void cecies_set_config(const cecies_config* config);
+
+/**
+ * Sets #cecies_config::parallel_gcm_threshold and #cecies_config::parallel_gcm_thread_count, leaving all other settings as they are.
+ * @param threshold Payloads of at least this many bytes are en-/decrypted in parallel (\c 0 to never do that).
+ * @param thread_count The maximum number of threads to use (\c 0 for one per CPU core).
+ */
+CECIES_API void cecies_set_parallel_gcm(size_t threshold, size_t thread_count);
+
+/**
+ * Sets #cecies_config::multi_buffer_gcm, leaving all other settings as they are.
+ * @param enabled \c 0 to disable the multi-buffer AES-GCM kernel; anything else to enable it.
+ */
+CECIES_API void cecies_set_multi_buffer_gcm(int enabled);
+
+/**
+ * Sets #cecies_config::multi_buffer_sha512, leaving all other settings as they are.
+ * @param enabled \c 0 to disable the multi-buffer SHA-512; anything else to enable it.
+ */
+CECIES_API void cecies_set_multi_buffer_sha512(int enabled);
+
+/**
+ * Sets #cecies_config::simd_x25519_max_lanes, leaving all other settings as they are.
+ * @param max_lanes \c 8, \c 4 or \c 0 (see #cecies_config::simd_x25519_max_lanes).
+ */
+CECIES_API void cecies_set_simd_x25519(size_t max_lanes);
+
+/**
+ * Sets #cecies_config::parallel_compression_threshold and #cecies_config::parallel_compression_thread_count, leaving all other settings as they are.
+ * @param threshold Inputs of at least this many bytes are compressed in parallel (\c 0 to never do that).
+ * @param thread_count The maximum number of threads to use (\c 0 for one per CPU core).
+ */
+CECIES_API void cecies_set_parallel_compression(size_t threshold, size_t thread_count);
+
 /**
  * Gets a random big integer. This only features very limited randomness due to usage of <c>rand()</c>! <p>
  * **DO NOT USE THIS FOR ANY TYPE OF KEY GENERATION!** <p>
@@ -207,7 +319,8 @@ CECIES_API void cecies_dev_urandom(uint8_t* output_buffer, size_t output_buffer_
 
 /**
  * Free memory that was allocated by CECIES. <p>
- * Wraps the <c>free()</c> function (mainly useful for C# interop).
+ * Wraps the <c>free()</c> function, or whatever allocator was set using cecies_set_allocator() when the block was allocated (also useful for C# interop).
+ * As long as no custom allocator is set, the buffers that CECIES returns are plain <c>malloc()</c> blocks, so passing them to <c>free()</c> is fine too.
  * @param mem The pointer to the memory to free.
  */
 CECIES_API void cecies_free(void* mem);
@@ -0,0 +1,242 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <cecies/util.h>
+#include <cecies/keygen.h>
+#include <cecies/encrypt.h>
+#include <cecies/async.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+static double now()
+{
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+#endif
+}
+
+static int encrypt_file_sync(const char* input_path, const char* output_path, const cecies_curve25519_key public_key)
+{
+    FILE* file = fopen(input_path, "rb");
+    if (file == NULL)
+    {
+        return -1;
+    }
+
+    fseek(file, 0, SEEK_END);
+    const long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    uint8_t* data = length > 0 ? malloc((size_t)length) : NULL;
+    if (data == NULL || fread(data, 1, (size_t)length, file) != (size_t)length)
+    {
+        fclose(file);
+        free(data);
+        return -1;
+    }
+
+    fclose(file);
+
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+
+    int r = cecies_curve25519_encrypt(data, (size_t)length, 0, public_key, &encrypted, &encrypted_length, 0);
+    free(data);
+
+    if (r != 0)
+    {
+        return r;
+    }
+
+    file = fopen(output_path, "wb");
+    r = file == NULL || fwrite(encrypted, 1, encrypted_length, file) != encrypted_length ? -1 : 0;
+
+    if (file != NULL)
+    {
+        fclose(file);
+    }
+
+    cecies_free(encrypted);
+    return r;
+}
+
+int main(const int argc, const char* argv[])
+{
+    if (argc == 1 || (argc == 2 && strcmp(argv[1], "--help") == 0))
+    {
+        fprintf(stdout, "cecies_async_benchmark:  Compare encrypting a batch of files one after another (read, cecies_curve25519_encrypt, write) with submitting them as async file jobs (io_uring on Linux). Call this program with the directory to create the test files in; optionally pass the file count (default: 32), the file size in MiB (default: 64) and the worker thread count (default: one per CPU core).\n");
+        return 0;
+    }
+
+    const char* dir = argv[1];
+    const size_t file_count = argc > 2 ? (size_t)strtoull(argv[2], NULL, 10) : 32;
+    const size_t mib = argc > 3 ? (size_t)strtoull(argv[3], NULL, 10) : 64;
+    const size_t thread_count = argc > 4 ? (size_t)strtoull(argv[4], NULL, 10) : 0;
+
+    if (file_count == 0 || mib == 0)
+    {
+        fprintf(stderr, "cecies_async_benchmark: Invalid file count or size! Check out \"cecies_async_benchmark --help\" for more details about how to use this!\n");
+        return 1;
+    }
+
+    const size_t length = mib * 1024 * 1024;
+    const size_t path_size = strlen(dir) + 64;
+
+    char* paths = malloc(3 * file_count * path_size);
+    uint8_t* payload = malloc(length);
+    cecies_async_job** jobs = malloc(file_count * sizeof(cecies_async_job*));
+
+    if (paths == NULL || payload == NULL || jobs == NULL)
+    {
+        fprintf(stderr, "cecies_async_benchmark: OUT OF MEMORY!\n");
+        free(paths);
+        free(payload);
+        free(jobs);
+        return 1;
+    }
+
+#define INPUT_PATH(i) (paths + (3 * (i)) * path_size)
+#define SYNC_OUTPUT_PATH(i) (paths + (3 * (i) + 1) * path_size)
+#define ASYNC_OUTPUT_PATH(i) (paths + (3 * (i) + 2) * path_size)
+
+    int r = 0;
+    cecies_dev_urandom(payload, length);
+
+    for (size_t i = 0; i < file_count && r == 0; ++i)
+    {
+        snprintf(INPUT_PATH(i), path_size, "%s/cecies_async_benchmark_%zu.bin", dir, i);
+        snprintf(SYNC_OUTPUT_PATH(i), path_size, "%s/cecies_async_benchmark_%zu.sync", dir, i);
+        snprintf(ASYNC_OUTPUT_PATH(i), path_size, "%s/cecies_async_benchmark_%zu.async", dir, i);
+
+        FILE* file = fopen(INPUT_PATH(i), "wb");
+        if (file == NULL || fwrite(payload, 1, length, file) != length)
+        {
+            fprintf(stderr, "cecies_async_benchmark: Couldn't write the test file \"%s\"!\n", INPUT_PATH(i));
+            r = 1;
+        }
+
+        if (file != NULL)
+        {
+            fclose(file);
+        }
+    }
+
+    cecies_curve25519_keypair keypair;
+    if (r == 0 && cecies_generate_curve25519_keypair(&keypair, NULL, 0) != 0)
+    {
+        fprintf(stderr, "cecies_async_benchmark: Key generation failed!\n");
+        r = 1;
+    }
+
+    if (r == 0)
+    {
+        fprintf(stdout, "Files: %zu x %zu MiB\n\n%-10s %10s %12s\n", file_count, mib, "mode", "seconds", "MB/s");
+
+        const double t0 = now();
+
+        for (size_t i = 0; i < file_count && r == 0; ++i)
+        {
+            r = encrypt_file_sync(INPUT_PATH(i), SYNC_OUTPUT_PATH(i), keypair.public_key);
+        }
+
+        const double t1 = now();
+
+        if (r != 0)
+        {
+            fprintf(stderr, "cecies_async_benchmark: Synchronous encryption failed! (%d)\n", r);
+        }
+        else
+        {
+            fprintf(stdout, "%-10s %10.3f %12.1f\n", "sync", t1 - t0, (double)(length * file_count) / 1e6 / (t1 - t0));
+        }
+    }
+
+    if (r == 0)
+    {
+        cecies_async_pool* pool = NULL;
+
+        const double t0 = now();
+
+        size_t submitted = 0;
+        r = cecies_async_pool_create(&pool, thread_count, file_count, -1);
+
+        for (; submitted < file_count && r == 0; ++submitted)
+        {
+            r = cecies_curve25519_encrypt_file_async(pool, INPUT_PATH(submitted), ASYNC_OUTPUT_PATH(submitted), keypair.public_key, 0, NULL, NULL, &jobs[submitted]);
+            if (r != 0)
+            {
+                fprintf(stderr, "cecies_async_benchmark: Submitting job #%zu failed! (%d)\n", submitted, r);
+                break;
+            }
+        }
+
+        for (size_t i = 0; i < submitted; ++i)
+        {
+            const int jr = cecies_async_job_wait(jobs[i]);
+            if (jr != 0)
+            {
+                fprintf(stderr, "cecies_async_benchmark: Async encryption of \"%s\" failed! (%d)\n", INPUT_PATH(i), jr);
+                r = jr;
+            }
+        }
+
+        const double t1 = now();
+
+        for (size_t i = 0; i < submitted; ++i)
+        {
+            cecies_async_job_free(jobs[i]);
+        }
+
+        if (r == 0)
+        {
+            fprintf(stdout, "%-10s %10.3f %12.1f\n", "async", t1 - t0, (double)(length * file_count) / 1e6 / (t1 - t0));
+        }
+
+        cecies_async_pool_free(pool);
+    }
+
+    for (size_t i = 0; i < file_count; ++i)
+    {
+        remove(INPUT_PATH(i));
+        remove(SYNC_OUTPUT_PATH(i));
+        remove(ASYNC_OUTPUT_PATH(i));
+    }
+
+#undef INPUT_PATH
+#undef SYNC_OUTPUT_PATH
+#undef ASYNC_OUTPUT_PATH
+
+    free(jobs);
+    free(payload);
+    free(paths);
+    return r == 0 ? 0 : 1;
+}
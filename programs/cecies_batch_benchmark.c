@@ -0,0 +1,160 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <cecies/util.h>
+#include <cecies/keygen.h>
+#include <cecies/interop.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+static double now()
+{
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+#endif
+}
+
+int main(const int argc, const char* argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "--help") == 0)
+    {
+        fprintf(stdout, "cecies_batch_benchmark:  Measure Curve25519 batch encryption and decryption of small messages (64 B, 256 B and 1 KiB) in messages per second, one at a time vs. through the multi-buffer AES-GCM kernel (and then also the multi-lane X25519 key agreement and the multi-buffer SHA-512 HKDF). Optionally pass the amount of messages per batch (default: 1024).\n");
+        return 0;
+    }
+
+    static const size_t message_sizes[] = { 64, 256, 1024 };
+
+    const size_t count = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 1024;
+
+    if (count == 0)
+    {
+        fprintf(stderr, "cecies_batch_benchmark: Invalid message count! Check out \"cecies_batch_benchmark --help\" for more details about how to use this!\n");
+        return 1;
+    }
+
+    cecies_curve25519_keypair keypair;
+    if (cecies_generate_curve25519_keypair(&keypair, NULL, 0) != 0)
+    {
+        fprintf(stderr, "cecies_batch_benchmark: Key generation failed!\n");
+        return 1;
+    }
+
+    cecies_context* context = NULL;
+    if (cecies_curve25519_context_create(&context, (const uint8_t*)keypair.public_key.hexstring, CECIES_X25519_KEY_SIZE * 2, (const uint8_t*)keypair.private_key.hexstring, CECIES_X25519_KEY_SIZE * 2, 0) != 0)
+    {
+        fprintf(stderr, "cecies_batch_benchmark: Context creation failed!\n");
+        return 1;
+    }
+
+    const size_t max_input_size = count * message_sizes[sizeof(message_sizes) / sizeof(message_sizes[0]) - 1];
+    const size_t max_output_size = max_input_size + count * cecies_context_get_encrypted_size(context, 0);
+
+    uint8_t* input = malloc(max_input_size);
+    uint8_t* encrypted = malloc(max_output_size);
+    uint8_t* decrypted = malloc(max_output_size);
+    size_t* input_lengths = malloc(count * sizeof(size_t));
+    size_t* encrypted_lengths = malloc(count * sizeof(size_t));
+    size_t* decrypted_lengths = malloc(count * sizeof(size_t));
+
+    int ret = 1;
+
+    if (input == NULL || encrypted == NULL || decrypted == NULL || input_lengths == NULL || encrypted_lengths == NULL || decrypted_lengths == NULL)
+    {
+        fprintf(stderr, "cecies_batch_benchmark: OUT OF MEMORY!\n");
+        goto exit;
+    }
+
+    cecies_dev_urandom(input, max_input_size);
+
+    fprintf(stdout, "Messages per batch: %zu\n\n%8s %14s %16s %16s %10s\n", count, "size", "mode", "encrypt msg/s", "decrypt msg/s", "speedup");
+
+    for (size_t s = 0; s < sizeof(message_sizes) / sizeof(message_sizes[0]); ++s)
+    {
+        double baseline = 0;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            input_lengths[i] = message_sizes[s];
+        }
+
+        // 0: everything one at a time, 1: multi-buffer AES-GCM, 2: + multi-lane X25519, 3: + multi-buffer SHA-512.
+        for (int mode = 0; mode < 4; ++mode)
+        {
+            cecies_set_multi_buffer_gcm(mode >= 1);
+            cecies_set_simd_x25519(mode >= 2 ? 8 : 0);
+            cecies_set_multi_buffer_sha512(mode >= 3);
+
+            const double t0 = now();
+            int r = cecies_context_encrypt_batch(context, input, input_lengths, count, encrypted, max_output_size, encrypted_lengths, NULL);
+            const double t1 = now();
+
+            if (r == 0)
+            {
+                r = cecies_context_decrypt_batch(context, encrypted, encrypted_lengths, count, decrypted, max_output_size, decrypted_lengths, NULL);
+            }
+
+            const double t2 = now();
+
+            if (r != 0 || memcmp(decrypted, input, count * message_sizes[s]) != 0)
+            {
+                fprintf(stderr, "cecies_batch_benchmark: Round-trip failed! (%d)\n", r);
+                goto exit;
+            }
+
+            const double encrypt_rate = (double)count / (t1 - t0);
+            const double decrypt_rate = (double)count / (t2 - t1);
+
+            if (mode == 0)
+            {
+                baseline = encrypt_rate + decrypt_rate;
+            }
+
+            static const char* mode_names[] = { "one-at-a-time", "multi-buffer", "+ x25519 simd", "+ sha512 simd" };
+            fprintf(stdout, "%8zu %14s %16.0f %16.0f %9.2fx\n", message_sizes[s], mode_names[mode], encrypt_rate, decrypt_rate, (encrypt_rate + decrypt_rate) / baseline);
+        }
+    }
+
+    ret = 0;
+
+exit:
+    cecies_set_multi_buffer_gcm(1);
+    cecies_set_simd_x25519(8);
+    cecies_set_multi_buffer_sha512(1);
+    cecies_context_free(context);
+    free(input);
+    free(encrypted);
+    free(decrypted);
+    free(input_lengths);
+    free(encrypted_lengths);
+    free(decrypted_lengths);
+    return ret;
+}
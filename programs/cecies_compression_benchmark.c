@@ -0,0 +1,212 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <ccrush.h>
+#include <cecies/util.h>
+#include <cecies/keygen.h>
+#include <cecies/encrypt.h>
+#include <cecies/decrypt.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define ROUNDS 3
+
+static double now()
+{
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+#endif
+}
+
+static uint8_t* read_file(const char* path, size_t* length)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    uint8_t* data = size > 0 ? malloc((size_t)size) : NULL;
+    if (data != NULL && fread(data, 1, (size_t)size, file) != (size_t)size)
+    {
+        free(data);
+        data = NULL;
+    }
+
+    fclose(file);
+    *length = data != NULL ? (size_t)size : 0;
+    return data;
+}
+
+static uint8_t* synthetic_logs(size_t* length)
+{
+    static const char* levels[] = { "INFO", "DEBUG", "WARN", "ERROR" };
+    static const char* messages[] = { "request handled", "cache miss for key", "connection reset by peer", "retrying upload", "user session refreshed" };
+
+    const size_t size = 64 * 1024 * 1024;
+    char* data = malloc(size);
+    if (data == NULL)
+    {
+        return NULL;
+    }
+
+    size_t offset = 0;
+    uint32_t state = 0x12345678;
+
+    while (offset < size - 256)
+    {
+        state = state * 1103515245 + 12345;
+        offset += (size_t)snprintf(data + offset, 256, "2020-11-%02u 12:%02u:%02u.%03u [%s] worker-%u: %s %08x\n", 1 + (state >> 27), (state >> 21) % 60, (state >> 15) % 60, (state >> 5) % 1000, levels[(state >> 9) & 3], (state >> 3) & 15, messages[(state >> 11) % 5], state);
+    }
+
+    *length = offset;
+    return (uint8_t*)data;
+}
+
+static int benchmark(const char* name, const uint8_t* data, const size_t length, const cecies_curve25519_keypair* keypair)
+{
+    double ccrush_compress_time = 1e9, ccrush_decompress_time = 1e9, encrypt_time = 1e9, decrypt_time = 1e9, plain_decrypt_time = 1e9;
+    size_t compressed_length = 0;
+
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        uint8_t* compressed = NULL;
+        uint8_t* decompressed = NULL;
+        size_t decompressed_length = 0;
+        uint8_t* encrypted = NULL;
+        size_t encrypted_length = 0;
+        uint8_t* decrypted = NULL;
+        size_t decrypted_length = 0;
+        uint8_t* plain_encrypted = NULL;
+        size_t plain_encrypted_length = 0;
+        uint8_t* plain_decrypted = NULL;
+        size_t plain_decrypted_length = 0;
+
+        const double t0 = now();
+        int r = ccrush_compress(data, length, 256, 6, &compressed, &compressed_length);
+        const double t1 = now();
+        r |= r == 0 ? ccrush_decompress(compressed, compressed_length, 256, &decompressed, &decompressed_length) : 0;
+        const double t2 = now();
+        r |= r == 0 ? cecies_curve25519_encrypt(data, length, 6, keypair->public_key, &encrypted, &encrypted_length, 0) : 0;
+        const double t3 = now();
+        r |= r == 0 ? cecies_curve25519_decrypt(encrypted, encrypted_length, 0, keypair->private_key, &decrypted, &decrypted_length) : 0;
+        const double t4 = now();
+
+        // The same data encrypted without compression tells how long decrypting costs per byte: whatever the compressed ciphertext takes beyond that is inflating.
+        r |= r == 0 ? cecies_curve25519_encrypt(data, length, 0, keypair->public_key, &plain_encrypted, &plain_encrypted_length, 0) : 0;
+        const double t5 = now();
+        r |= r == 0 ? cecies_curve25519_decrypt(plain_encrypted, plain_encrypted_length, 0, keypair->private_key, &plain_decrypted, &plain_decrypted_length) : 0;
+        const double t6 = now();
+
+        const int ok = r == 0 && decrypted_length == length && memcmp(decrypted, data, length) == 0 && plain_decrypted_length == length;
+
+        ccrush_free(compressed);
+        ccrush_free(decompressed);
+        cecies_free(encrypted);
+        cecies_free(decrypted);
+        cecies_free(plain_encrypted);
+        cecies_free(plain_decrypted);
+
+        if (!ok)
+        {
+            fprintf(stderr, "cecies_compression_benchmark: Round-trip of \"%s\" failed! (%d)\n", name, r);
+            return 1;
+        }
+
+        ccrush_compress_time = CECIES_MIN(ccrush_compress_time, t1 - t0);
+        ccrush_decompress_time = CECIES_MIN(ccrush_decompress_time, t2 - t1);
+        encrypt_time = CECIES_MIN(encrypt_time, t3 - t2);
+        decrypt_time = CECIES_MIN(decrypt_time, t4 - t3);
+        plain_decrypt_time = CECIES_MIN(plain_decrypt_time, (t6 - t5) * (double)encrypted_length / (double)plain_encrypted_length);
+    }
+
+    const double mb = (double)length / 1e6;
+    const double inflate_share = decrypt_time > plain_decrypt_time ? 100.0 * (decrypt_time - plain_decrypt_time) / decrypt_time : 0.0;
+    fprintf(stdout, "%-32.32s %10.1f %7.3f %12.1f %12.1f %12.1f %12.1f %10.0f%%\n", name, mb, (double)compressed_length / (double)length, mb / ccrush_compress_time, mb / encrypt_time, mb / ccrush_decompress_time, mb / decrypt_time, inflate_share);
+    return 0;
+}
+
+int main(const int argc, const char* argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "--help") == 0)
+    {
+        fprintf(stdout, "cecies_compression_benchmark:  Compare plain ccrush compression/decompression throughput against CECIES encryption/decryption with compression (level 6) over a corpus, and show how much of the decryption time goes into inflating (compared to decrypting the same data encrypted without compression). Pass the corpus files as arguments (e.g. the Silesia corpus); without arguments, 64 MB of synthetic log lines are used.\n");
+        return 0;
+    }
+
+    cecies_curve25519_keypair keypair;
+    if (cecies_generate_curve25519_keypair(&keypair, NULL, 0) != 0)
+    {
+        fprintf(stderr, "cecies_compression_benchmark: Key generation failed!\n");
+        return 1;
+    }
+
+    fprintf(stdout, "Throughput in MB/s of uncompressed data (best of %d rounds). \"inflate\" is the share of the decryption time spent decompressing.\n\n", ROUNDS);
+    fprintf(stdout, "%-32s %10s %7s %12s %12s %12s %12s %11s\n", "file", "MB", "ratio", "ccrush comp", "encrypt", "ccrush dec", "decrypt", "inflate");
+
+    int ret = 0;
+
+    if (argc < 2)
+    {
+        size_t length = 0;
+        uint8_t* data = synthetic_logs(&length);
+        if (data == NULL)
+        {
+            fprintf(stderr, "cecies_compression_benchmark: OUT OF MEMORY!\n");
+            return 1;
+        }
+
+        ret = benchmark("(synthetic logs)", data, length, &keypair);
+        free(data);
+        return ret;
+    }
+
+    for (int i = 1; i < argc; ++i)
+    {
+        size_t length = 0;
+        uint8_t* data = read_file(argv[i], &length);
+        if (data == NULL)
+        {
+            fprintf(stderr, "cecies_compression_benchmark: Couldn't read \"%s\" (or it's empty); skipping it...\n", argv[i]);
+            continue;
+        }
+
+        ret |= benchmark(argv[i], data, length, &keypair);
+        free(data);
+    }
+
+    return ret;
+}
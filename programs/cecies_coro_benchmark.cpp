@@ -0,0 +1,274 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <exception>
+#include <condition_variable>
+
+#include <cecies/cecies.hpp>
+#include <cecies/coro.hpp>
+
+using benchmark_clock = std::chrono::steady_clock;
+
+static double seconds_since(const benchmark_clock::time_point t0)
+{
+    return std::chrono::duration<double>(benchmark_clock::now() - t0).count();
+}
+
+/*
+ * Stands in for a coroutine-based server's event loop: the thread that calls run() is the "server thread".
+ * It keeps track of how long it was actually busy resuming coroutines (as opposed to idly waiting for completions).
+ */
+class run_loop
+{
+public:
+    void post(const std::coroutine_handle<> handle)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(handle);
+        cv_.notify_one();
+    }
+
+    void run(const std::size_t& remaining)
+    {
+        while (remaining > 0)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return !queue_.empty(); });
+            const std::coroutine_handle<> handle = queue_.front();
+            queue_.pop_front();
+            lock.unlock();
+
+            const benchmark_clock::time_point t0 = benchmark_clock::now();
+            handle.resume();
+            busy += seconds_since(t0);
+        }
+    }
+
+    double busy = 0;
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::coroutine_handle<>> queue_;
+};
+
+struct task
+{
+    struct promise_type
+    {
+        task get_return_object() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void() noexcept
+        {
+        }
+
+        void unhandled_exception() noexcept
+        {
+            std::terminate();
+        }
+    };
+};
+
+struct benchmark_state
+{
+    cecies::byte_span plaintext;
+    const cecies::public_key<cecies::curve25519>* key = nullptr;
+
+    std::size_t total = 0;
+    std::size_t next = 0;
+    std::size_t errors = 0;
+    std::size_t remaining = 0;
+    std::vector<double> latencies;
+};
+
+/*
+ * One "connection": keeps handling requests until there are none left.
+ */
+static task connection(const cecies::async_context context, benchmark_state& state)
+{
+    while (state.next < state.total)
+    {
+        ++state.next;
+
+        const benchmark_clock::time_point t0 = benchmark_clock::now();
+        const cecies::result<cecies::buffer> encrypted = co_await cecies::encrypt(context, state.plaintext, *state.key);
+        state.latencies.push_back(seconds_since(t0));
+        state.errors += !encrypted.ok();
+    }
+
+    --state.remaining;
+}
+
+/*
+ * Handles the requests in batches of \p batch_size: one suspension per batch.
+ */
+static task batches(const cecies::async_context context, benchmark_state& state, const std::size_t batch_size)
+{
+    const std::vector<cecies::byte_span> batch(batch_size, state.plaintext);
+
+    while (state.next < state.total)
+    {
+        const std::size_t n = std::min(batch_size, state.total - state.next);
+        state.next += n;
+
+        const benchmark_clock::time_point t0 = benchmark_clock::now();
+        const std::vector<cecies::result<cecies::buffer>> encrypted = co_await cecies::encrypt_batch(context, cecies::span<const cecies::byte_span>(batch.data(), n), *state.key);
+        const double latency = seconds_since(t0);
+
+        for (const cecies::result<cecies::buffer>& e : encrypted)
+        {
+            state.latencies.push_back(latency);
+            state.errors += !e.ok();
+        }
+    }
+
+    --state.remaining;
+}
+
+static void report(const char* mode, const double seconds, const double busy, benchmark_state& state)
+{
+    std::sort(state.latencies.begin(), state.latencies.end());
+
+    const auto percentile = [&state](const double p) { //
+        return state.latencies.empty() ? 0.0 : state.latencies[std::min(state.latencies.size() - 1, (std::size_t)(p * (double)state.latencies.size()))] * 1e3;
+    };
+
+    std::printf("%-10s %10.3f %12.1f %12.3f %12.3f %14.1f%%\n", mode, seconds, (double)state.total / seconds, percentile(0.5), percentile(0.99), 100.0 * busy / seconds);
+
+    if (state.errors != 0)
+    {
+        std::fprintf(stderr, "cecies_coro_benchmark: %zu requests failed!\n", state.errors);
+    }
+}
+
+int main(const int argc, const char* argv[])
+{
+    if (argc == 2 && std::strcmp(argv[1], "--help") == 0)
+    {
+        std::printf("cecies_coro_benchmark:  Compare handling encryption requests (Curve25519, 1 KiB each) on a single \"server thread\" with blocking calls against co_awaiting them on a CECIES worker pool (one by one from many concurrent coroutines, and in batches). Optionally pass the request count (default: 4096), the amount of requests in flight (default: 64) and the worker thread count (default: one per CPU core).\n");
+        return 0;
+    }
+
+    const std::size_t request_count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4096;
+    const std::size_t in_flight = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 64;
+    const std::size_t thread_count = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 0;
+
+    if (request_count == 0 || in_flight == 0)
+    {
+        std::fprintf(stderr, "cecies_coro_benchmark: Invalid request count or concurrency! Check out \"cecies_coro_benchmark --help\" for more details about how to use this!\n");
+        return 1;
+    }
+
+    cecies::result<cecies::keypair<cecies::curve25519>> keypair = cecies::generate_keypair<cecies::curve25519>();
+    cecies::result<cecies::async_pool> pool = cecies::async_pool::create(thread_count, in_flight);
+
+    if (!keypair.ok() || !pool.ok())
+    {
+        std::fprintf(stderr, "cecies_coro_benchmark: Initialization failed! (%d, %d)\n", keypair.error(), pool.error());
+        return 1;
+    }
+
+    std::vector<std::uint8_t> plaintext(1024);
+    cecies_dev_urandom(plaintext.data(), plaintext.size());
+
+    std::printf("Requests: %zu, in flight: %zu\n\n%-10s %10s %12s %12s %12s %15s\n", request_count, in_flight, "mode", "seconds", "requests/s", "p50 ms", "p99 ms", "server busy");
+
+    // Blocking: the server thread does all of the work itself, one request after another.
+    {
+        benchmark_state state;
+        state.plaintext = plaintext;
+        state.total = request_count;
+
+        const benchmark_clock::time_point t0 = benchmark_clock::now();
+
+        for (std::size_t i = 0; i < request_count; ++i)
+        {
+            const benchmark_clock::time_point r0 = benchmark_clock::now();
+            const cecies::result<cecies::buffer> encrypted = cecies::encrypt(plaintext, keypair->public_key);
+            state.latencies.push_back(seconds_since(r0));
+            state.errors += !encrypted.ok();
+        }
+
+        const double seconds = seconds_since(t0);
+        report("blocking", seconds, seconds, state);
+    }
+
+    // Coroutines: the server thread only submits and resumes, the workers do the crypto.
+    {
+        run_loop loop;
+        benchmark_state state;
+        state.plaintext = plaintext;
+        state.key = &keypair->public_key;
+        state.total = request_count;
+        state.remaining = in_flight;
+
+        const cecies::async_context context{ pool->c(), cecies::executor_ref(loop), {} };
+        const benchmark_clock::time_point t0 = benchmark_clock::now();
+
+        for (std::size_t i = 0; i < in_flight; ++i)
+        {
+            const benchmark_clock::time_point s0 = benchmark_clock::now();
+            connection(context, state);
+            loop.busy += seconds_since(s0);
+        }
+
+        loop.run(state.remaining);
+        report("co_await", seconds_since(t0), loop.busy, state);
+    }
+
+    // Batches: one suspension (and one resumption on the server thread) per batch.
+    {
+        run_loop loop;
+        benchmark_state state;
+        state.plaintext = plaintext;
+        state.key = &keypair->public_key;
+        state.total = request_count;
+        state.remaining = 1;
+
+        const cecies::async_context context{ pool->c(), cecies::executor_ref(loop), {} };
+        const benchmark_clock::time_point t0 = benchmark_clock::now();
+
+        batches(context, state, in_flight);
+        loop.busy += seconds_since(t0);
+
+        loop.run(state.remaining);
+        report("batch", seconds_since(t0), loop.busy, state);
+    }
+
+    return 0;
+}
@@ -0,0 +1,168 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <cecies/util.h>
+#include <cecies/ed25519.h>
+#include <mbedtls/platform_util.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define MESSAGE_SIZE 64
+
+static double now()
+{
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+#endif
+}
+
+int main(const int argc, const char* argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "--help") == 0)
+    {
+        fprintf(stdout, "cecies_ed25519_benchmark:  Measure Ed25519 signing and verification of 64 B messages in signatures per second, verifying one at a time vs. in batches of 4 up to 1024 signatures (each batch is checked with one multi-scalar multiplication). Optionally pass the total amount of signatures (default: 4096).\n");
+        return 0;
+    }
+
+    static const size_t batch_sizes[] = { 4, 16, 64, 256, 1024 };
+
+    const size_t count = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 4096;
+
+    if (count == 0)
+    {
+        fprintf(stderr, "cecies_ed25519_benchmark: Invalid signature count! Check out \"cecies_ed25519_benchmark --help\" for more details about how to use this!\n");
+        return 1;
+    }
+
+    uint8_t* messages = malloc(count * MESSAGE_SIZE);
+    uint8_t* signatures = malloc(count * CECIES_ED25519_SIGNATURE_SIZE);
+    uint8_t* public_keys = malloc(count * CECIES_ED25519_PUBLIC_KEY_SIZE);
+    uint8_t* private_keys = malloc(count * CECIES_ED25519_PRIVATE_KEY_SIZE);
+    const uint8_t** message_pointers = malloc(count * sizeof(uint8_t*));
+    const uint8_t** signature_pointers = malloc(count * sizeof(uint8_t*));
+    const uint8_t** public_key_pointers = malloc(count * sizeof(uint8_t*));
+    size_t* message_lengths = malloc(count * sizeof(size_t));
+
+    int ret = 1;
+
+    if (messages == NULL || signatures == NULL || public_keys == NULL || private_keys == NULL || message_pointers == NULL || signature_pointers == NULL || public_key_pointers == NULL || message_lengths == NULL)
+    {
+        fprintf(stderr, "cecies_ed25519_benchmark: OUT OF MEMORY!\n");
+        goto exit;
+    }
+
+    cecies_dev_urandom(messages, count * MESSAGE_SIZE);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (cecies_generate_ed25519_keypair(public_keys + i * CECIES_ED25519_PUBLIC_KEY_SIZE, private_keys + i * CECIES_ED25519_PRIVATE_KEY_SIZE, NULL, 0) != 0)
+        {
+            fprintf(stderr, "cecies_ed25519_benchmark: Key generation failed!\n");
+            goto exit;
+        }
+
+        message_pointers[i] = messages + i * MESSAGE_SIZE;
+        signature_pointers[i] = signatures + i * CECIES_ED25519_SIGNATURE_SIZE;
+        public_key_pointers[i] = public_keys + i * CECIES_ED25519_PUBLIC_KEY_SIZE;
+        message_lengths[i] = MESSAGE_SIZE;
+    }
+
+    double t0 = now();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (cecies_ed25519_sign(message_pointers[i], MESSAGE_SIZE, private_keys + i * CECIES_ED25519_PRIVATE_KEY_SIZE, signatures + i * CECIES_ED25519_SIGNATURE_SIZE) != 0)
+        {
+            fprintf(stderr, "cecies_ed25519_benchmark: Signing failed!\n");
+            goto exit;
+        }
+    }
+
+    double t1 = now();
+
+    fprintf(stdout, "Signatures: %zu\n\nsign: %.0f sig/s\n\n%14s %16s %10s\n", count, (double)count / (t1 - t0), "batch size", "verify sig/s", "speedup");
+
+    t0 = now();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (cecies_ed25519_verify(message_pointers[i], MESSAGE_SIZE, signature_pointers[i], public_key_pointers[i]) != 0)
+        {
+            fprintf(stderr, "cecies_ed25519_benchmark: Verification failed!\n");
+            goto exit;
+        }
+    }
+
+    t1 = now();
+
+    const double baseline = (double)count / (t1 - t0);
+    fprintf(stdout, "%14s %16.0f %9.2fx\n", "one-at-a-time", baseline, 1.0);
+
+    for (size_t b = 0; b < sizeof(batch_sizes) / sizeof(batch_sizes[0]); ++b)
+    {
+        t0 = now();
+
+        for (size_t i = 0; i < count; i += batch_sizes[b])
+        {
+            const size_t n = count - i < batch_sizes[b] ? count - i : batch_sizes[b];
+
+            const int r = cecies_ed25519_verify_batch(message_pointers + i, message_lengths + i, signature_pointers + i, public_key_pointers + i, n, NULL);
+            if (r != 0)
+            {
+                fprintf(stderr, "cecies_ed25519_benchmark: Batch verification failed! (%d)\n", r);
+                goto exit;
+            }
+        }
+
+        t1 = now();
+
+        const double rate = (double)count / (t1 - t0);
+        fprintf(stdout, "%14zu %16.0f %9.2fx\n", batch_sizes[b], rate, rate / baseline);
+    }
+
+    ret = 0;
+
+exit:
+    if (private_keys != NULL)
+    {
+        mbedtls_platform_zeroize(private_keys, count * CECIES_ED25519_PRIVATE_KEY_SIZE);
+    }
+    free(messages);
+    free(signatures);
+    free(public_keys);
+    free(private_keys);
+    free(message_pointers);
+    free(signature_pointers);
+    free(public_key_pointers);
+    free(message_lengths);
+    return ret;
+}
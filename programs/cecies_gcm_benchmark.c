@@ -0,0 +1,134 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <cecies/util.h>
+#include <cecies/keygen.h>
+#include <cecies/encrypt.h>
+#include <cecies/decrypt.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+static double now()
+{
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+#endif
+}
+
+int main(const int argc, const char* argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "--help") == 0)
+    {
+        fprintf(stdout, "cecies_gcm_benchmark:  Measure how Curve448 encryption and decryption of a single large payload scale with the number of AES-GCM threads. Optionally pass the payload size in MiB (default: 256) and the maximum thread count to try (default: 16).\n");
+        return 0;
+    }
+
+    const size_t mib = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 256;
+    const size_t max_threads = argc > 2 ? (size_t)strtoull(argv[2], NULL, 10) : 16;
+
+    if (mib == 0 || max_threads == 0)
+    {
+        fprintf(stderr, "cecies_gcm_benchmark: Invalid payload size or thread count! Check out \"cecies_gcm_benchmark --help\" for more details about how to use this!\n");
+        return 1;
+    }
+
+    const size_t length = mib * 1024 * 1024;
+
+    uint8_t* payload = malloc(length);
+    if (payload == NULL)
+    {
+        fprintf(stderr, "cecies_gcm_benchmark: OUT OF MEMORY!\n");
+        return 1;
+    }
+
+    cecies_dev_urandom(payload, length);
+
+    cecies_curve448_keypair keypair;
+    if (cecies_generate_curve448_keypair(&keypair, NULL, 0) != 0)
+    {
+        fprintf(stderr, "cecies_gcm_benchmark: Key generation failed!\n");
+        free(payload);
+        return 1;
+    }
+
+    fprintf(stdout, "Payload: %zu MiB\n\n%8s %14s %14s %10s\n", mib, "threads", "encrypt MB/s", "decrypt MB/s", "speedup");
+
+    double baseline = 0;
+
+    for (size_t thread_count = 1; thread_count <= max_threads; thread_count *= 2)
+    {
+        uint8_t* encrypted = NULL;
+        size_t encrypted_length = 0;
+        uint8_t* decrypted = NULL;
+        size_t decrypted_length = 0;
+
+        // Threshold 0 forces MbedTLS' own single-threaded GCM for the baseline row.
+        cecies_set_parallel_gcm(thread_count == 1 ? 0 : 1, thread_count);
+
+        const double t0 = now();
+        int r = cecies_curve448_encrypt(payload, length, 0, keypair.public_key, &encrypted, &encrypted_length, 0);
+        const double t1 = now();
+
+        if (r == 0)
+        {
+            r = cecies_curve448_decrypt(encrypted, encrypted_length, 0, keypair.private_key, &decrypted, &decrypted_length);
+        }
+
+        const double t2 = now();
+
+        if (r != 0 || decrypted_length != length || memcmp(decrypted, payload, length) != 0)
+        {
+            fprintf(stderr, "cecies_gcm_benchmark: Round-trip failed with %zu threads! (%d)\n", thread_count, r);
+            free(encrypted);
+            free(decrypted);
+            free(payload);
+            return 1;
+        }
+
+        const double encrypt_mbps = (double)length / 1e6 / (t1 - t0);
+        const double decrypt_mbps = (double)length / 1e6 / (t2 - t1);
+
+        if (thread_count == 1)
+        {
+            baseline = encrypt_mbps + decrypt_mbps;
+        }
+
+        fprintf(stdout, "%8zu %14.1f %14.1f %9.2fx\n", thread_count, encrypt_mbps, decrypt_mbps, (encrypt_mbps + decrypt_mbps) / baseline);
+
+        cecies_free(encrypted);
+        cecies_free(decrypted);
+    }
+
+    cecies_set_parallel_gcm(CECIES_PARALLEL_GCM_DEFAULT_THRESHOLD, 0);
+    free(payload);
+    return 0;
+}
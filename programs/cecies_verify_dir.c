@@ -0,0 +1,319 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <cecies/util.h>
+#include <cecies/decrypt.h>
+#include <mbedtls/platform_util.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+static int curve = 0;
+static int base64 = 0;
+static cecies_curve25519_key private_key25519 = { 0x00 };
+static cecies_curve448_key private_key448 = { 0x00 };
+
+static char** files = NULL;
+static size_t files_count = 0;
+static size_t next_file = 0;
+static size_t failed_count = 0;
+
+#ifdef _WIN32
+static CRITICAL_SECTION mutex;
+#define LOCK() EnterCriticalSection(&mutex)
+#define UNLOCK() LeaveCriticalSection(&mutex)
+#else
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+#define LOCK() pthread_mutex_lock(&mutex)
+#define UNLOCK() pthread_mutex_unlock(&mutex)
+#endif
+
+static int add_file(const char* dir, const char* name)
+{
+    if ((files_count & (files_count - 1)) == 0)
+    {
+        char** tmp = realloc(files, (files_count ? files_count * 2 : 64) * sizeof(char*));
+        if (tmp == NULL)
+        {
+            return 1;
+        }
+        files = tmp;
+    }
+
+    const size_t length = strlen(dir) + strlen(name) + 2;
+    char* path = malloc(length);
+    if (path == NULL)
+    {
+        return 1;
+    }
+
+    snprintf(path, length, "%s/%s", dir, name);
+    files[files_count++] = path;
+    return 0;
+}
+
+static int list_files(const char* dir)
+{
+#ifdef _WIN32
+    char pattern[MAX_PATH];
+    snprintf(pattern, sizeof(pattern), "%s\\*", dir);
+
+    WIN32_FIND_DATAA entry;
+    HANDLE find = FindFirstFileA(pattern, &entry);
+    if (find == INVALID_HANDLE_VALUE)
+    {
+        return 1;
+    }
+
+    do
+    {
+        if (!(entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && add_file(dir, entry.cFileName) != 0)
+        {
+            FindClose(find);
+            return 1;
+        }
+    } while (FindNextFileA(find, &entry));
+
+    FindClose(find);
+#else
+    DIR* d = opendir(dir);
+    if (d == NULL)
+    {
+        return 1;
+    }
+
+    struct dirent* entry;
+    while ((entry = readdir(d)) != NULL)
+    {
+        char path[4096];
+        struct stat st;
+        snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+
+        if (stat(path, &st) == 0 && S_ISREG(st.st_mode) && add_file(dir, entry->d_name) != 0)
+        {
+            closedir(d);
+            return 1;
+        }
+    }
+
+    closedir(d);
+#endif
+    return 0;
+}
+
+static int verify_file(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return -1;
+    }
+
+    fseek(file, 0, SEEK_END);
+    const long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    if (length <= 0)
+    {
+        fclose(file);
+        return -1;
+    }
+
+    uint8_t* data = malloc((size_t)length);
+    if (data == NULL)
+    {
+        fclose(file);
+        return -1;
+    }
+
+    const size_t read = fread(data, 1, (size_t)length, file);
+    fclose(file);
+
+    // The verify functions destroy the key copy that's passed to them (by value), so the globals stay intact.
+    const int r = read != (size_t)length ? -1 : curve == 0 ? cecies_curve25519_verify(data, read, base64, private_key25519) : cecies_curve448_verify(data, read, base64, private_key448);
+
+    free(data);
+    return r;
+}
+
+#ifdef _WIN32
+static DWORD WINAPI worker(LPVOID arg)
+#else
+static void* worker(void* arg)
+#endif
+{
+    (void)arg;
+
+    for (;;)
+    {
+        LOCK();
+        const size_t i = next_file++;
+        UNLOCK();
+
+        if (i >= files_count)
+        {
+            break;
+        }
+
+        const int r = verify_file(files[i]);
+
+        LOCK();
+        if (r != 0)
+        {
+            failed_count++;
+            fprintf(stdout, "FAIL %s (%d)\n", files[i], r);
+        }
+        else
+        {
+            fprintf(stdout, "OK   %s\n", files[i]);
+        }
+        UNLOCK();
+    }
+
+    return 0;
+}
+
+int main(const int argc, const char* argv[])
+{
+    if (argc == 1 || (argc == 2 && strcmp(argv[1], "--help") == 0))
+    {
+        fprintf(stdout, "cecies_verify_dir:  Verify the authenticity of all CECIES-encrypted files inside a directory (in parallel, without decrypting them). Call this program using 3 or more arguments;  the first one being the curve (\"25519\" or \"448\"), the second the private key (hex-string) and the third the directory to scan. Optionally pass a thread count (default: one per CPU core) and/or \"--base64\" if the files are base64-encoded.\n");
+        return 0;
+    }
+
+    if (argc < 4 || argc > 6)
+    {
+        fprintf(stderr, "cecies_verify_dir: wrong argument count. Check out \"cecies_verify_dir --help\" for more details about how to use this!\n");
+        return -1;
+    }
+
+    const char* private_key_hexstr = argv[2];
+    const size_t private_key_hexstr_len = strlen(private_key_hexstr);
+
+    if (strcmp(argv[1], "25519") == 0 && private_key_hexstr_len == 64)
+    {
+        curve = 0;
+        memcpy(private_key25519.hexstring, private_key_hexstr, private_key_hexstr_len);
+    }
+    else if (strcmp(argv[1], "448") == 0 && private_key_hexstr_len == 112)
+    {
+        curve = 1;
+        memcpy(private_key448.hexstring, private_key_hexstr, private_key_hexstr_len);
+    }
+    else
+    {
+        fprintf(stderr, "cecies_verify_dir: Invalid curve or private key format/length!\n");
+        return -2;
+    }
+
+    size_t thread_count = 0;
+
+    for (int i = 4; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--base64") == 0)
+        {
+            base64 = 1;
+        }
+        else
+        {
+            thread_count = (size_t)strtoul(argv[i], NULL, 10);
+        }
+    }
+
+    if (thread_count == 0)
+    {
+#ifdef _WIN32
+        SYSTEM_INFO system_info;
+        GetSystemInfo(&system_info);
+        thread_count = system_info.dwNumberOfProcessors;
+#else
+        const long n = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = n > 0 ? (size_t)n : 1;
+#endif
+    }
+
+    if (list_files(argv[3]) != 0)
+    {
+        fprintf(stderr, "cecies_verify_dir: Couldn't list the files inside \"%s\"!\n", argv[3]);
+        return -3;
+    }
+
+#ifdef _WIN32
+    InitializeCriticalSection(&mutex);
+    HANDLE* threads = malloc(thread_count * sizeof(HANDLE));
+#else
+    pthread_t* threads = malloc(thread_count * sizeof(pthread_t));
+#endif
+
+    if (threads == NULL)
+    {
+        return -3;
+    }
+
+    size_t threads_started = 0;
+    for (; threads_started < thread_count; ++threads_started)
+    {
+#ifdef _WIN32
+        threads[threads_started] = CreateThread(NULL, 0, worker, NULL, 0, NULL);
+        if (threads[threads_started] == NULL)
+            break;
+#else
+        if (pthread_create(&threads[threads_started], NULL, worker, NULL) != 0)
+            break;
+#endif
+    }
+
+    if (threads_started == 0)
+    {
+        worker(NULL);
+    }
+
+    for (size_t i = 0; i < threads_started; ++i)
+    {
+#ifdef _WIN32
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], NULL);
+#endif
+    }
+
+    fprintf(stdout, "\nVerified %zu files: %zu OK, %zu FAILED\n", files_count, files_count - failed_count, failed_count);
+
+    for (size_t i = 0; i < files_count; ++i)
+    {
+        free(files[i]);
+    }
+
+    free(files);
+    free(threads);
+
+    mbedtls_platform_zeroize(&private_key25519, sizeof(cecies_curve25519_key));
+    mbedtls_platform_zeroize(&private_key448, sizeof(cecies_curve448_key));
+
+    return failed_count == 0 ? 0 : -4;
+}
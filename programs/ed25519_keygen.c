@@ -18,8 +18,8 @@
 #include <stddef.h>
 #include <string.h>
 #include <cecies/util.h>
+#include <cecies/ed25519.h>
 #include <mbedtls/sha256.h>
-#include <sodium.h>
 
 int main(int argc, const char* argv[])
 {
@@ -49,7 +49,12 @@ int main(int argc, const char* argv[])
         return 1;
     }
 
-    crypto_sign_ed25519_seed_keypair(public_key, private_key, seed);
+    if (cecies_ed25519_keypair_from_seed(seed, public_key, private_key) != 0)
+    {
+        fprintf(stderr, "ed25519_keygen.c: Key generation failed!");
+        memset(seed, 0x00, sizeof(seed));
+        return 2;
+    }
 
     fprintf(stdout, "{\"ed25519_private_key\":\"");
     for (int i = 0; i < sizeof(private_key); ++i)
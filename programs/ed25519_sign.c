@@ -18,7 +18,7 @@
 #include <stddef.h>
 #include <string.h>
 #include <cecies/util.h>
-#include <sodium.h>
+#include <cecies/ed25519.h>
 
 int main(int argc, char* argv[])
 {
@@ -64,9 +64,9 @@ int main(int argc, char* argv[])
         goto exit;
     }
 
-    if (crypto_sign_ed25519_detached(signature, NULL, (const unsigned char*)msg, msg_len, private_key) != 0)
+    if (cecies_ed25519_sign((const unsigned char*)msg, msg_len, private_key, signature) != 0)
     {
-        fprintf(stderr, "ed25519_sign: The generated signature is invalid!\n");
+        fprintf(stderr, "ed25519_sign: Signing failed!\n");
         r = 4;
         goto exit;
     }
@@ -18,7 +18,7 @@
 #include <stddef.h>
 #include <string.h>
 #include <cecies/util.h>
-#include <sodium.h>
+#include <cecies/ed25519.h>
 
 int main(int argc, char* argv[])
 {
@@ -81,7 +81,7 @@ int main(int argc, char* argv[])
         goto exit;
     }
 
-    if (crypto_sign_ed25519_verify_detached(signature, (const unsigned char*)msg, msg_len, public_key) != 0)
+    if (cecies_ed25519_verify((const unsigned char*)msg, msg_len, signature, public_key) != 0)
     {
         fprintf(stderr, "ed25519_verify: Invalid signature!\n");
         r = 4;
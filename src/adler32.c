@@ -0,0 +1,197 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "internal.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CECIES_ADLER32_X86 1
+#include <immintrin.h>
+#endif
+
+/*
+ * Adler-32 (RFC 1950) with SSSE3 and AVX2 kernels that are picked at runtime.
+ * The vectorized loops process 32-byte blocks: s1 is the plain byte sum (psadbw against zero) and s2 the position-weighted sum (pmaddubsw with the weights 32..1),
+ * plus 32 times the value s1 had before each block. Reductions modulo 65521 happen every NMAX bytes, exactly like in zlib.
+ */
+
+#define CECIES_ADLER32_BASE 65521U
+
+/* Largest n such that 255n(n+1)/2 + (n+1)(BASE-1) <= 2^32-1 (see zlib's adler32.c). */
+#define CECIES_ADLER32_NMAX 5552
+
+static uint32_t cecies_adler32_scalar(uint32_t adler, const uint8_t* data, size_t data_length)
+{
+    uint32_t s1 = adler & 0xffff;
+    uint32_t s2 = adler >> 16;
+
+    while (data_length > 0)
+    {
+        size_t n = data_length < CECIES_ADLER32_NMAX ? data_length : CECIES_ADLER32_NMAX;
+        data_length -= n;
+
+        while (n--)
+        {
+            s1 += *data++;
+            s2 += s1;
+        }
+
+        s1 %= CECIES_ADLER32_BASE;
+        s2 %= CECIES_ADLER32_BASE;
+    }
+
+    return s1 | (s2 << 16);
+}
+
+#ifdef CECIES_ADLER32_X86
+
+__attribute__((target("ssse3"))) static uint32_t cecies_adler32_ssse3(uint32_t adler, const uint8_t* data, size_t data_length)
+{
+    uint32_t s1 = adler & 0xffff;
+    uint32_t s2 = adler >> 16;
+
+    size_t blocks = data_length / 32;
+    data_length -= blocks * 32;
+
+    const __m128i tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+    const __m128i tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+
+    while (blocks > 0)
+    {
+        size_t n = CECIES_ADLER32_NMAX / 32;
+        if (n > blocks)
+        {
+            n = blocks;
+        }
+
+        blocks -= n;
+
+        // The s1 that comes in contributes 32 * s1 to s2 for each of the n blocks.
+        __m128i v_ps = _mm_set_epi32(0, 0, 0, (int)(s1 * n));
+        __m128i v_s2 = _mm_set_epi32(0, 0, 0, (int)s2);
+        __m128i v_s1 = _mm_setzero_si128();
+
+        do
+        {
+            const __m128i bytes1 = _mm_loadu_si128((const __m128i*)data);
+            const __m128i bytes2 = _mm_loadu_si128((const __m128i*)(data + 16));
+
+            v_ps = _mm_add_epi32(v_ps, v_s1);
+
+            v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes1, zero));
+            v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes1, tap1), ones));
+
+            v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes2, zero));
+            v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes2, tap2), ones));
+
+            data += 32;
+        } while (--n);
+
+        v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(2, 3, 0, 1)));
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(1, 0, 3, 2)));
+        s1 += (uint32_t)_mm_cvtsi128_si32(v_s1);
+
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(2, 3, 0, 1)));
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(1, 0, 3, 2)));
+        s2 = (uint32_t)_mm_cvtsi128_si32(v_s2);
+
+        s1 %= CECIES_ADLER32_BASE;
+        s2 %= CECIES_ADLER32_BASE;
+    }
+
+    return cecies_adler32_scalar(s1 | (s2 << 16), data, data_length);
+}
+
+__attribute__((target("avx2"))) static uint32_t cecies_adler32_avx2(uint32_t adler, const uint8_t* data, size_t data_length)
+{
+    uint32_t s1 = adler & 0xffff;
+    uint32_t s2 = adler >> 16;
+
+    size_t blocks = data_length / 32;
+    data_length -= blocks * 32;
+
+    const __m256i tap = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi16(1);
+
+    while (blocks > 0)
+    {
+        size_t n = CECIES_ADLER32_NMAX / 32;
+        if (n > blocks)
+        {
+            n = blocks;
+        }
+
+        blocks -= n;
+
+        __m256i v_ps = _mm256_set_epi32(0, 0, 0, 0, 0, 0, 0, (int)(s1 * n));
+        __m256i v_s2 = _mm256_set_epi32(0, 0, 0, 0, 0, 0, 0, (int)s2);
+        __m256i v_s1 = _mm256_setzero_si256();
+
+        do
+        {
+            const __m256i bytes = _mm256_loadu_si256((const __m256i*)data);
+
+            v_ps = _mm256_add_epi32(v_ps, v_s1);
+            v_s1 = _mm256_add_epi32(v_s1, _mm256_sad_epu8(bytes, zero));
+            v_s2 = _mm256_add_epi32(v_s2, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, tap), ones));
+
+            data += 32;
+        } while (--n);
+
+        v_s2 = _mm256_add_epi32(v_s2, _mm256_slli_epi32(v_ps, 5));
+
+        __m128i h1 = _mm_add_epi32(_mm256_castsi256_si128(v_s1), _mm256_extracti128_si256(v_s1, 1));
+        h1 = _mm_add_epi32(h1, _mm_shuffle_epi32(h1, _MM_SHUFFLE(2, 3, 0, 1)));
+        h1 = _mm_add_epi32(h1, _mm_shuffle_epi32(h1, _MM_SHUFFLE(1, 0, 3, 2)));
+        s1 += (uint32_t)_mm_cvtsi128_si32(h1);
+
+        __m128i h2 = _mm_add_epi32(_mm256_castsi256_si128(v_s2), _mm256_extracti128_si256(v_s2, 1));
+        h2 = _mm_add_epi32(h2, _mm_shuffle_epi32(h2, _MM_SHUFFLE(2, 3, 0, 1)));
+        h2 = _mm_add_epi32(h2, _mm_shuffle_epi32(h2, _MM_SHUFFLE(1, 0, 3, 2)));
+        s2 = (uint32_t)_mm_cvtsi128_si32(h2);
+
+        s1 %= CECIES_ADLER32_BASE;
+        s2 %= CECIES_ADLER32_BASE;
+    }
+
+    return cecies_adler32_scalar(s1 | (s2 << 16), data, data_length);
+}
+
+#endif // CECIES_ADLER32_X86
+
+uint32_t cecies_adler32(const uint32_t adler, const uint8_t* data, const size_t data_length)
+{
+#ifdef CECIES_ADLER32_X86
+    if (data_length >= 64)
+    {
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return cecies_adler32_avx2(adler, data, data_length);
+        }
+
+        if (__builtin_cpu_supports("ssse3"))
+        {
+            return cecies_adler32_ssse3(adler, data, data_length);
+        }
+    }
+#endif
+
+    return cecies_adler32_scalar(adler, data, data_length);
+}
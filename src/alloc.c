@@ -0,0 +1,956 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include <mbedtls/platform.h>
+#include <mbedtls/platform_util.h>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+#include "cecies/util.h"
+#include "cecies/alloc.h"
+#include "internal.h"
+
+static void* (*cecies_malloc_func)(size_t) = malloc;
+static void* (*cecies_calloc_func)(size_t, size_t) = calloc;
+static void (*cecies_free_func)(void*) = free;
+
+static CECIES_THREAD_LOCAL cecies_alloc_stats cecies_thread_alloc_stats;
+
+/*
+ * While an arena is pushed, all allocations of the calling thread are served from it instead of the allocator.
+ */
+static CECIES_THREAD_LOCAL cecies_arena* cecies_thread_arena = NULL;
+
+/*
+ * MbedTLS' allocations are only routed through CECIES once they need to be: when a custom allocator is set, or when an arena is pushed (the to_buffer functions rely on that).
+ * Blocks that MbedTLS allocated before that are fine: cecies_free() passes every block it doesn't know to free().
+ */
+static void cecies_route_mbedtls_allocations(void)
+{
+#if defined(MBEDTLS_PLATFORM_MEMORY) && !defined(MBEDTLS_PLATFORM_CALLOC_MACRO) && !defined(MBEDTLS_PLATFORM_FREE_MACRO)
+    static atomic_flag routed = ATOMIC_FLAG_INIT;
+    if (!atomic_flag_test_and_set(&routed))
+    {
+        mbedtls_platform_set_calloc_free(cecies_calloc, cecies_free);
+    }
+#endif
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     OWNERSHIP
+
+/*
+ * cecies_free() finds out where a block came from without storing anything inside of it, so that the blocks of the default allocator stay plain malloc() blocks
+ * (callers may pass the buffers that CECIES returns straight to free(), as they always could). <p>
+ * Arena blocks are recognized by their address (every pushed arena is registered in cecies_live_arenas), and the blocks of custom allocators are looked up
+ * in a side table that maps them to the free function of the allocator that allocated them. Anything else came from the C standard library.
+ */
+typedef struct cecies_owner_entry
+{
+    /* NULL for empty slots. */
+    void* mem;
+    void (*free_func)(void*);
+} cecies_owner_entry;
+
+/*
+ * An open addressing hash table (linear probing); the side table is split into a few of these, each with its own lock, so that threads rarely contend on it.
+ */
+typedef struct cecies_owner_table
+{
+    cecies_mutex mutex;
+    cecies_owner_entry* entries;
+
+    /* A power of 2 (or 0). */
+    size_t capacity;
+    size_t count;
+} cecies_owner_table;
+
+#define CECIES_OWNER_TABLE_COUNT 16
+
+static cecies_owner_table cecies_owner_tables[CECIES_OWNER_TABLE_COUNT];
+
+/* How many blocks the side table holds in total: as long as that's 0, cecies_free() doesn't need to look anything up. */
+static atomic_size_t cecies_owned_blocks = 0;
+
+static cecies_mutex cecies_live_arenas_mutex;
+static cecies_arena* cecies_live_arenas = NULL;
+static atomic_size_t cecies_live_arena_count = 0;
+
+static void cecies_owner_init(void)
+{
+    for (size_t i = 0; i < CECIES_OWNER_TABLE_COUNT; ++i)
+    {
+        cecies_mutex_init(&cecies_owner_tables[i].mutex);
+    }
+
+    cecies_mutex_init(&cecies_live_arenas_mutex);
+}
+
+#ifdef _WIN32
+
+static INIT_ONCE cecies_owner_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK cecies_owner_init_once(PINIT_ONCE once, PVOID param, PVOID* context)
+{
+    (void)once;
+    (void)param;
+    (void)context;
+    cecies_owner_init();
+    return TRUE;
+}
+
+static void cecies_owner_ensure_init(void)
+{
+    InitOnceExecuteOnce(&cecies_owner_once, cecies_owner_init_once, NULL, NULL);
+}
+
+#else
+
+static pthread_once_t cecies_owner_once = PTHREAD_ONCE_INIT;
+
+static void cecies_owner_ensure_init(void)
+{
+    pthread_once(&cecies_owner_once, cecies_owner_init);
+}
+
+#endif
+
+static inline uint64_t cecies_owner_hash(const void* mem)
+{
+    // Blocks are at least 8-byte aligned, so the low bits carry no information.
+    return (uint64_t)((uintptr_t)mem >> 3) * UINT64_C(0x9E3779B97F4A7C15);
+}
+
+static inline cecies_owner_table* cecies_owner_table_of(const void* mem)
+{
+    return &cecies_owner_tables[cecies_owner_hash(mem) >> 60];
+}
+
+static inline size_t cecies_owner_slot(const cecies_owner_table* table, const void* mem)
+{
+    return (size_t)(cecies_owner_hash(mem) >> 16) & (table->capacity - 1);
+}
+
+/*
+ * Doubles the capacity of a table (its entries come from the C standard library, since the table is what keeps track of the custom allocators' blocks). Returns 0 on success.
+ */
+static int cecies_owner_table_grow(cecies_owner_table* table)
+{
+    const size_t capacity = table->capacity == 0 ? 64 : table->capacity * 2;
+
+    cecies_owner_entry* entries = calloc(capacity, sizeof(cecies_owner_entry));
+    if (entries == NULL)
+    {
+        return 1;
+    }
+
+    cecies_owner_entry* old_entries = table->entries;
+    const size_t old_capacity = table->capacity;
+
+    table->entries = entries;
+    table->capacity = capacity;
+
+    for (size_t i = 0; i < old_capacity; ++i)
+    {
+        if (old_entries[i].mem == NULL)
+        {
+            continue;
+        }
+
+        size_t slot = cecies_owner_slot(table, old_entries[i].mem);
+        while (entries[slot].mem != NULL)
+        {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        entries[slot] = old_entries[i];
+    }
+
+    free(old_entries);
+    return 0;
+}
+
+/*
+ * Records that mem has to be freed using free_func. Returns 0 on success.
+ */
+static int cecies_owner_put(void* mem, void (*free_func)(void*))
+{
+    cecies_owner_ensure_init();
+
+    cecies_owner_table* table = cecies_owner_table_of(mem);
+    int ret = 0;
+
+    cecies_mutex_lock(&table->mutex);
+
+    // Keep the table at most half full.
+    if (2 * (table->count + 1) > table->capacity && cecies_owner_table_grow(table) != 0)
+    {
+        ret = 1;
+        goto exit;
+    }
+
+    size_t slot = cecies_owner_slot(table, mem);
+    while (table->entries[slot].mem != NULL)
+    {
+        slot = (slot + 1) & (table->capacity - 1);
+    }
+
+    table->entries[slot].mem = mem;
+    table->entries[slot].free_func = free_func;
+    table->count++;
+
+    atomic_fetch_add_explicit(&cecies_owned_blocks, 1, memory_order_release);
+
+exit:
+    cecies_mutex_unlock(&table->mutex);
+    return ret;
+}
+
+/*
+ * Removes mem from the side table and returns the free function it was recorded with (NULL if it isn't in there).
+ */
+static void (*cecies_owner_take(void* mem))(void*)
+{
+    if (atomic_load_explicit(&cecies_owned_blocks, memory_order_acquire) == 0)
+    {
+        return NULL;
+    }
+
+    cecies_owner_table* table = cecies_owner_table_of(mem);
+    void (*free_func)(void*) = NULL;
+
+    cecies_mutex_lock(&table->mutex);
+
+    if (table->capacity == 0)
+    {
+        goto exit;
+    }
+
+    const size_t mask = table->capacity - 1;
+
+    size_t slot = cecies_owner_slot(table, mem);
+    while (table->entries[slot].mem != NULL && table->entries[slot].mem != mem)
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    if (table->entries[slot].mem == NULL)
+    {
+        goto exit;
+    }
+
+    free_func = table->entries[slot].free_func;
+
+    // Backward shift deletion: move every following entry of the probe sequence that may live in the freed slot (i.e. whose home slot isn't in between) back into it.
+    for (size_t next = (slot + 1) & mask; table->entries[next].mem != NULL; next = (next + 1) & mask)
+    {
+        const size_t home = cecies_owner_slot(table, table->entries[next].mem);
+
+        if (((next - home) & mask) >= ((next - slot) & mask))
+        {
+            table->entries[slot] = table->entries[next];
+            slot = next;
+        }
+    }
+
+    table->entries[slot].mem = NULL;
+    table->entries[slot].free_func = NULL;
+    table->count--;
+
+    atomic_fetch_sub_explicit(&cecies_owned_blocks, 1, memory_order_relaxed);
+
+exit:
+    cecies_mutex_unlock(&table->mutex);
+    return free_func;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     ARENA
+
+/*
+ * Arena blocks: a 16-byte header followed by the (16-byte aligned) payload. Blocks are laid out back to back up to arena->top;
+ * freed blocks are merged with their free neighbours and reused first-fit, and free blocks at the top give their room back to the bump region.
+ */
+typedef struct cecies_arena_header
+{
+    uint64_t size; // Including the header.
+
+    /* Atomic because other threads may free blocks too (see cecies_arena_free()). */
+    atomic_int used;
+    uint32_t reserved;
+} cecies_arena_header;
+
+#define CECIES_ARENA_ALIGN(x) (((x) + 15) & ~(size_t)15)
+
+void cecies_arena_push(cecies_arena* arena, void* buffer, const size_t buffer_size)
+{
+    const size_t padding = CECIES_ARENA_ALIGN((uintptr_t)buffer) - (uintptr_t)buffer;
+
+    arena->buffer = (uint8_t*)buffer + CECIES_MIN(padding, buffer_size);
+    arena->size = (buffer_size - CECIES_MIN(padding, buffer_size)) & ~(size_t)15;
+    arena->top = 0;
+    arena->peak = 0;
+    arena->previous = cecies_thread_arena;
+
+    cecies_owner_ensure_init();
+    cecies_route_mbedtls_allocations();
+
+    cecies_mutex_lock(&cecies_live_arenas_mutex);
+    arena->next_live = cecies_live_arenas;
+    cecies_live_arenas = arena;
+    atomic_fetch_add_explicit(&cecies_live_arena_count, 1, memory_order_release);
+    cecies_mutex_unlock(&cecies_live_arenas_mutex);
+
+    cecies_thread_arena = arena;
+}
+
+void cecies_arena_pop(cecies_arena* arena)
+{
+    cecies_mutex_lock(&cecies_live_arenas_mutex);
+    for (cecies_arena** a = &cecies_live_arenas; *a != NULL; a = &(*a)->next_live)
+    {
+        if (*a == arena)
+        {
+            *a = arena->next_live;
+            atomic_fetch_sub_explicit(&cecies_live_arena_count, 1, memory_order_relaxed);
+            break;
+        }
+    }
+    cecies_mutex_unlock(&cecies_live_arenas_mutex);
+
+    mbedtls_platform_zeroize(arena->buffer, arena->peak);
+    cecies_thread_arena = arena->previous;
+}
+
+static inline int cecies_arena_contains(const cecies_arena* arena, const void* mem)
+{
+    return (const uint8_t*)mem >= arena->buffer && (const uint8_t*)mem < arena->buffer + arena->size;
+}
+
+static void* cecies_arena_alloc(cecies_arena* arena, const size_t size)
+{
+    if (size > arena->size)
+    {
+        return NULL;
+    }
+
+    const size_t needed = sizeof(cecies_arena_header) + CECIES_ARENA_ALIGN(size);
+
+    for (size_t offset = 0; offset < arena->top;)
+    {
+        cecies_arena_header* block = (cecies_arena_header*)(arena->buffer + offset);
+
+        if (!atomic_load_explicit(&block->used, memory_order_acquire) && block->size >= needed)
+        {
+            // Split if the rest is big enough to hold another block.
+            if (block->size - needed >= 2 * sizeof(cecies_arena_header))
+            {
+                cecies_arena_header* rest = (cecies_arena_header*)((uint8_t*)block + needed);
+                rest->size = block->size - needed;
+                atomic_init(&rest->used, 0);
+                block->size = needed;
+            }
+
+            atomic_store_explicit(&block->used, 1, memory_order_relaxed);
+            return block + 1;
+        }
+
+        offset += (size_t)block->size;
+    }
+
+    if (arena->size - arena->top < needed)
+    {
+        cecies_fprintf(stderr, "CECIES: arena exhausted (%zu bytes): consider increasing CECIES_STACK_ARENA_SIZE\n", arena->size);
+        return NULL;
+    }
+
+    cecies_arena_header* block = (cecies_arena_header*)(arena->buffer + arena->top);
+    block->size = needed;
+    atomic_init(&block->used, 1);
+
+    arena->top += needed;
+    arena->peak = CECIES_MAX(arena->peak, arena->top);
+    return block + 1;
+}
+
+/*
+ * Only the thread that pushed an arena allocates from it, but its blocks may be freed anywhere (e.g. a worker thread freeing its start parameters).
+ * Other threads (owned == 0) merely mark the block as free: the owning thread merges and reclaims it the next time it allocates or frees.
+ */
+static void cecies_arena_free(cecies_arena* arena, void* mem, const int owned)
+{
+    atomic_store_explicit(&((cecies_arena_header*)mem - 1)->used, 0, memory_order_release);
+
+    if (!owned)
+    {
+        return;
+    }
+
+    size_t last = SIZE_MAX;
+
+    for (size_t offset = 0; offset < arena->top;)
+    {
+        cecies_arena_header* block = (cecies_arena_header*)(arena->buffer + offset);
+
+        while (!atomic_load_explicit(&block->used, memory_order_acquire) && offset + block->size < arena->top)
+        {
+            cecies_arena_header* next = (cecies_arena_header*)((uint8_t*)block + block->size);
+            if (atomic_load_explicit(&next->used, memory_order_acquire))
+            {
+                break;
+            }
+            block->size += next->size;
+        }
+
+        last = offset;
+        offset += (size_t)block->size;
+    }
+
+    if (last != SIZE_MAX && !atomic_load_explicit(&((cecies_arena_header*)(arena->buffer + last))->used, memory_order_acquire))
+    {
+        arena->top = last;
+    }
+}
+
+/*
+ * Frees mem if it was carved out of an arena (the calling thread's own ones first, then those of other threads). Returns 0 if it wasn't.
+ */
+static int cecies_arena_release(void* mem)
+{
+    for (cecies_arena* a = cecies_thread_arena; a != NULL; a = a->previous)
+    {
+        if (cecies_arena_contains(a, mem))
+        {
+            cecies_arena_free(a, mem, 1);
+            return 1;
+        }
+    }
+
+    if (atomic_load_explicit(&cecies_live_arena_count, memory_order_acquire) == 0)
+    {
+        return 0;
+    }
+
+    int released = 0;
+
+    cecies_mutex_lock(&cecies_live_arenas_mutex);
+    for (cecies_arena* a = cecies_live_arenas; a != NULL; a = a->next_live)
+    {
+        if (cecies_arena_contains(a, mem))
+        {
+            cecies_arena_free(a, mem, 0);
+            released = 1;
+            break;
+        }
+    }
+    cecies_mutex_unlock(&cecies_live_arenas_mutex);
+
+    return released;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     ALLOCATION
+
+static void* cecies_alloc_block(const size_t size, const int zero)
+{
+    cecies_arena* arena = cecies_thread_arena;
+    void* mem = NULL;
+
+    if (arena != NULL)
+    {
+        mem = cecies_arena_alloc(arena, size);
+
+        if (mem != NULL && zero)
+        {
+            memset(mem, 0x00, size);
+        }
+    }
+    else
+    {
+        void (*free_func)(void*) = cecies_free_func;
+
+        mem = zero ? cecies_calloc_func(1, size) : cecies_malloc_func(size);
+
+        // Only the blocks of custom allocators need to be tracked: everything else goes to free().
+        if (mem != NULL && free_func != free && cecies_owner_put(mem, free_func) != 0)
+        {
+            free_func(mem);
+            mem = NULL;
+        }
+    }
+
+    if (mem == NULL)
+    {
+        return NULL;
+    }
+
+    cecies_thread_alloc_stats.allocations++;
+    cecies_thread_alloc_stats.bytes_allocated += size;
+    return mem;
+}
+
+void* cecies_malloc(const size_t size)
+{
+    return cecies_alloc_block(size, 0);
+}
+
+void* cecies_calloc(const size_t count, const size_t size)
+{
+    if (size != 0 && count > SIZE_MAX / size)
+    {
+        return NULL;
+    }
+
+    return cecies_alloc_block(count * size, 1);
+}
+
+void cecies_free(void* mem)
+{
+    if (mem == NULL)
+    {
+        return;
+    }
+
+    cecies_thread_alloc_stats.frees++;
+
+    if (cecies_arena_release(mem))
+    {
+        return;
+    }
+
+    void (*free_func)(void*) = cecies_owner_take(mem);
+    if (free_func != NULL)
+    {
+        free_func(mem);
+        return;
+    }
+
+    free(mem);
+}
+
+void* cecies_zalloc(void* opaque, const unsigned int items, const unsigned int size)
+{
+    (void)opaque;
+    return cecies_malloc((size_t)items * size);
+}
+
+void cecies_zfree(void* opaque, void* address)
+{
+    (void)opaque;
+    cecies_free(address);
+}
+
+void cecies_set_allocator(void* (*malloc_func)(size_t), void* (*calloc_func)(size_t, size_t), void (*free_func)(void*))
+{
+    const int custom = malloc_func != NULL && calloc_func != NULL && free_func != NULL;
+
+    cecies_malloc_func = custom ? malloc_func : malloc;
+    cecies_calloc_func = custom ? calloc_func : calloc;
+    cecies_free_func = custom ? free_func : free;
+
+    cecies_route_mbedtls_allocations();
+}
+
+void cecies_get_alloc_stats(cecies_alloc_stats* stats)
+{
+    if (stats != NULL)
+    {
+        *stats = cecies_thread_alloc_stats;
+    }
+}
+
+void cecies_reset_alloc_stats(void)
+{
+    memset(&cecies_thread_alloc_stats, 0x00, sizeof(cecies_alloc_stats));
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     POOL
+
+#define CECIES_POOL_MIN_CLASS_SHIFT 4
+#define CECIES_POOL_CLASS_COUNT 13
+#define CECIES_POOL_MAX_CLASS_SIZE ((size_t)1 << (CECIES_POOL_MIN_CLASS_SHIFT + CECIES_POOL_CLASS_COUNT - 1))
+
+#define CECIES_POOL_SLAB_SIZE (256 * 1024)
+
+/* A thread keeps up to this many bytes worth of free blocks per size class before handing half of them over to the depot. */
+#define CECIES_POOL_CACHE_LIMIT (256 * 1024)
+
+/* Size class marker for allocations that bypass the pool. */
+#define CECIES_POOL_CLASS_NONE UINT64_MAX
+
+/*
+ * Precedes every allocation (16 bytes, so that the payload stays 16-byte aligned).
+ */
+typedef struct cecies_pool_header
+{
+    uint64_t size_class;
+
+    /* Total mapping size of allocations that bypass the pool (0 if they came from malloc()). */
+    uint64_t mapping_size;
+} cecies_pool_header;
+
+/*
+ * Free blocks are chained through their (unused) payload.
+ */
+typedef struct cecies_pool_block
+{
+    struct cecies_pool_block* next;
+} cecies_pool_block;
+
+typedef struct cecies_pool_list
+{
+    cecies_pool_block* head;
+    size_t count;
+} cecies_pool_list;
+
+typedef struct cecies_pool_cache
+{
+    cecies_pool_list lists[CECIES_POOL_CLASS_COUNT];
+} cecies_pool_cache;
+
+static cecies_pool_list cecies_pool_depot[CECIES_POOL_CLASS_COUNT];
+static cecies_mutex cecies_pool_depot_mutex;
+static int cecies_pool_lock_pages = 0;
+
+static inline size_t cecies_pool_class_size(const size_t size_class)
+{
+    return (size_t)1 << (CECIES_POOL_MIN_CLASS_SHIFT + size_class);
+}
+
+static inline size_t cecies_pool_size_class(const size_t size)
+{
+    size_t size_class = 0;
+    while (cecies_pool_class_size(size_class) < size)
+    {
+        size_class++;
+    }
+    return size_class;
+}
+
+static inline size_t cecies_pool_cache_limit(const size_t size_class)
+{
+    return CECIES_MAX(4, CECIES_POOL_CACHE_LIMIT / cecies_pool_class_size(size_class));
+}
+
+static void* cecies_pool_map(const size_t size)
+{
+#ifdef _WIN32
+    void* mem = VirtualAlloc(NULL, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (mem != NULL && cecies_pool_lock_pages)
+    {
+        VirtualLock(mem, size);
+    }
+    return mem;
+#else
+    void* mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    if (cecies_pool_lock_pages)
+    {
+        // Best effort: RLIMIT_MEMLOCK may not allow it, in which case the memory is still perfectly usable.
+        mlock(mem, size);
+#ifdef MADV_DONTDUMP
+        madvise(mem, size, MADV_DONTDUMP);
+#endif
+    }
+    return mem;
+#endif
+}
+
+static void cecies_pool_unmap(void* mem, const size_t size)
+{
+#ifdef _WIN32
+    (void)size;
+    VirtualFree(mem, 0, MEM_RELEASE);
+#else
+    munmap(mem, size);
+#endif
+}
+
+static void cecies_pool_list_push(cecies_pool_list* list, cecies_pool_block* block)
+{
+    block->next = list->head;
+    list->head = block;
+    list->count++;
+}
+
+static cecies_pool_block* cecies_pool_list_pop(cecies_pool_list* list)
+{
+    cecies_pool_block* block = list->head;
+    if (block != NULL)
+    {
+        list->head = block->next;
+        list->count--;
+    }
+    return block;
+}
+
+/*
+ * Moves up to count blocks from one list to another.
+ */
+static void cecies_pool_list_move(cecies_pool_list* from, cecies_pool_list* to, size_t count)
+{
+    while (count-- > 0 && from->head != NULL)
+    {
+        cecies_pool_list_push(to, cecies_pool_list_pop(from));
+    }
+}
+
+static void cecies_pool_cache_destroy(void* arg)
+{
+    cecies_pool_cache* cache = arg;
+
+    cecies_mutex_lock(&cecies_pool_depot_mutex);
+    for (size_t i = 0; i < CECIES_POOL_CLASS_COUNT; ++i)
+    {
+        cecies_pool_list_move(&cache->lists[i], &cecies_pool_depot[i], SIZE_MAX);
+    }
+    cecies_mutex_unlock(&cecies_pool_depot_mutex);
+
+    free(cache);
+}
+
+/*
+ * The per-thread caches hang off a thread-specific key, because that's what gives us a destructor for handing a thread's free blocks back to the depot when it exits.
+ */
+#ifdef _WIN32
+
+static DWORD cecies_pool_key = FLS_OUT_OF_INDEXES;
+static INIT_ONCE cecies_pool_once = INIT_ONCE_STATIC_INIT;
+
+static VOID NTAPI cecies_pool_fls_callback(PVOID data)
+{
+    if (data != NULL)
+    {
+        cecies_pool_cache_destroy(data);
+    }
+}
+
+static BOOL CALLBACK cecies_pool_init(PINIT_ONCE once, PVOID param, PVOID* context)
+{
+    (void)once;
+    (void)param;
+    (void)context;
+    cecies_mutex_init(&cecies_pool_depot_mutex);
+    cecies_pool_key = FlsAlloc(cecies_pool_fls_callback);
+    return TRUE;
+}
+
+static cecies_pool_cache* cecies_pool_get_cache(void)
+{
+    InitOnceExecuteOnce(&cecies_pool_once, cecies_pool_init, NULL, NULL);
+
+    if (cecies_pool_key == FLS_OUT_OF_INDEXES)
+    {
+        return NULL;
+    }
+
+    cecies_pool_cache* cache = FlsGetValue(cecies_pool_key);
+    if (cache == NULL && (cache = calloc(1, sizeof(cecies_pool_cache))) != NULL)
+    {
+        FlsSetValue(cecies_pool_key, cache);
+    }
+    return cache;
+}
+
+#else
+
+static pthread_key_t cecies_pool_key;
+static int cecies_pool_key_created = 0;
+static pthread_once_t cecies_pool_once = PTHREAD_ONCE_INIT;
+
+static void cecies_pool_init(void)
+{
+    cecies_mutex_init(&cecies_pool_depot_mutex);
+    cecies_pool_key_created = pthread_key_create(&cecies_pool_key, cecies_pool_cache_destroy) == 0;
+}
+
+static cecies_pool_cache* cecies_pool_get_cache(void)
+{
+    pthread_once(&cecies_pool_once, cecies_pool_init);
+
+    if (!cecies_pool_key_created)
+    {
+        return NULL;
+    }
+
+    cecies_pool_cache* cache = pthread_getspecific(cecies_pool_key);
+    if (cache == NULL && (cache = calloc(1, sizeof(cecies_pool_cache))) != NULL)
+    {
+        pthread_setspecific(cecies_pool_key, cache);
+    }
+    return cache;
+}
+
+#endif
+
+/*
+ * Refills a (thread-local) free list: first from the depot, then by carving up a new slab.
+ */
+static void cecies_pool_refill(cecies_pool_list* list, const size_t size_class)
+{
+    cecies_mutex_lock(&cecies_pool_depot_mutex);
+    cecies_pool_list_move(&cecies_pool_depot[size_class], list, cecies_pool_cache_limit(size_class) / 2);
+    cecies_mutex_unlock(&cecies_pool_depot_mutex);
+
+    if (list->head != NULL)
+    {
+        return;
+    }
+
+    uint8_t* slab = cecies_pool_map(CECIES_POOL_SLAB_SIZE);
+    if (slab == NULL)
+    {
+        return;
+    }
+
+    const size_t block_size = sizeof(cecies_pool_header) + cecies_pool_class_size(size_class);
+
+    for (size_t offset = 0; offset + block_size <= CECIES_POOL_SLAB_SIZE; offset += block_size)
+    {
+        cecies_pool_list_push(list, (cecies_pool_block*)(slab + offset + sizeof(cecies_pool_header)));
+    }
+}
+
+static void* cecies_pool_malloc(const size_t size)
+{
+    cecies_pool_header* header = NULL;
+
+    if (size > CECIES_POOL_MAX_CLASS_SIZE)
+    {
+        if (size > SIZE_MAX - sizeof(cecies_pool_header))
+        {
+            return NULL;
+        }
+
+        const size_t total = sizeof(cecies_pool_header) + size;
+
+        header = cecies_pool_lock_pages ? cecies_pool_map(total) : malloc(total);
+        if (header == NULL)
+        {
+            return NULL;
+        }
+
+        header->size_class = CECIES_POOL_CLASS_NONE;
+        header->mapping_size = cecies_pool_lock_pages ? total : 0;
+        return header + 1;
+    }
+
+    const size_t size_class = cecies_pool_size_class(size);
+    cecies_pool_cache* cache = cecies_pool_get_cache();
+
+    if (cache == NULL)
+    {
+        return NULL;
+    }
+
+    cecies_pool_list* list = &cache->lists[size_class];
+
+    if (list->head == NULL)
+    {
+        cecies_pool_refill(list, size_class);
+    }
+
+    cecies_pool_block* block = cecies_pool_list_pop(list);
+    if (block == NULL)
+    {
+        return NULL;
+    }
+
+    header = (cecies_pool_header*)block - 1;
+    header->size_class = size_class;
+    header->mapping_size = 0;
+    return block;
+}
+
+static void* cecies_pool_calloc(const size_t count, const size_t size)
+{
+    if (size != 0 && count > SIZE_MAX / size)
+    {
+        return NULL;
+    }
+
+    void* mem = cecies_pool_malloc(count * size);
+    if (mem != NULL)
+    {
+        memset(mem, 0x00, count * size);
+    }
+    return mem;
+}
+
+static void cecies_pool_free(void* mem)
+{
+    if (mem == NULL)
+    {
+        return;
+    }
+
+    cecies_pool_header* header = (cecies_pool_header*)mem - 1;
+
+    if (header->size_class == CECIES_POOL_CLASS_NONE)
+    {
+        if (header->mapping_size != 0)
+        {
+            mbedtls_platform_zeroize(mem, (size_t)header->mapping_size - sizeof(cecies_pool_header));
+            cecies_pool_unmap(header, (size_t)header->mapping_size);
+        }
+        else
+        {
+            free(header);
+        }
+        return;
+    }
+
+    const size_t size_class = (size_t)header->size_class;
+
+    if (cecies_pool_lock_pages)
+    {
+        mbedtls_platform_zeroize(mem, cecies_pool_class_size(size_class));
+    }
+
+    cecies_pool_cache* cache = cecies_pool_get_cache();
+
+    if (cache == NULL)
+    {
+        cecies_mutex_lock(&cecies_pool_depot_mutex);
+        cecies_pool_list_push(&cecies_pool_depot[size_class], mem);
+        cecies_mutex_unlock(&cecies_pool_depot_mutex);
+        return;
+    }
+
+    cecies_pool_list* list = &cache->lists[size_class];
+    cecies_pool_list_push(list, mem);
+
+    const size_t limit = cecies_pool_cache_limit(size_class);
+
+    if (list->count > limit)
+    {
+        cecies_mutex_lock(&cecies_pool_depot_mutex);
+        cecies_pool_list_move(list, &cecies_pool_depot[size_class], limit / 2);
+        cecies_mutex_unlock(&cecies_pool_depot_mutex);
+    }
+}
+
+void cecies_use_pool_allocator(const int lock_pages)
+{
+    cecies_pool_lock_pages = lock_pages != 0;
+    cecies_set_allocator(cecies_pool_malloc, cecies_pool_calloc, cecies_pool_free);
+}
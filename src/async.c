@@ -0,0 +1,1080 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <mbedtls/platform_util.h>
+
+#include "cecies/util.h"
+#include "cecies/encrypt.h"
+#include "cecies/decrypt.h"
+#include "cecies/stream.h"
+#include "cecies/async.h"
+#include "internal.h"
+
+/*
+ * How many chunks a file job keeps in flight: while one chunk is being encrypted, the following ones are being read and the previous ones written.
+ */
+#define CECIES_ASYNC_FILE_SLOTS 4
+
+enum cecies_async_job_type
+{
+    CECIES_ASYNC_JOB_ENCRYPT = 0,
+    CECIES_ASYNC_JOB_DECRYPT = 1,
+    CECIES_ASYNC_JOB_ENCRYPT_FILE = 2,
+};
+
+enum cecies_async_job_state
+{
+    CECIES_ASYNC_JOB_STATE_PENDING = 0,
+
+    /* The result is available, but the worker is still running the callback. */
+    CECIES_ASYNC_JOB_STATE_COMPLETED = 1,
+
+    /* The worker is done with the job. */
+    CECIES_ASYNC_JOB_STATE_DONE = 2,
+};
+
+struct cecies_async_job
+{
+    cecies_async_pool* pool;
+
+    int type;
+    int curve;
+    int compress;
+    int header_flags;
+    int base64;
+
+    const uint8_t* input;
+    size_t input_length;
+    char* input_path;
+    char* output_path;
+
+    /* Hex-encoded key (wiped as soon as it's used). */
+    char key[CECIES_X448_KEY_SIZE * 2 + 1];
+
+    cecies_async_callback callback;
+    void* user_data;
+    int auto_free;
+
+    int result;
+    uint8_t* output;
+    size_t output_length;
+
+    atomic_int state;
+    atomic_int cancelled;
+
+    /* Set (under the pool's mutex) by whichever of the owner (cecies_async_job_release()) and the worker is done with the job first: the other one frees it. */
+    int released;
+};
+
+/*
+ * Cell of the bounded MPMC queue (Dmitry Vyukov's design): the sequence number tells producers and consumers whose turn it is.
+ */
+typedef struct cecies_async_cell
+{
+    atomic_size_t sequence;
+    cecies_async_job* job;
+} cecies_async_cell;
+
+struct cecies_async_pool
+{
+    cecies_async_cell* cells;
+    size_t mask;
+
+    /* The two hot positions live on separate cache lines, so that producers and consumers don't contend with each other. */
+    uint8_t padding0[64];
+    atomic_size_t enqueue_position;
+    uint8_t padding1[64];
+    atomic_size_t dequeue_position;
+    uint8_t padding2[64];
+
+    /* How many workers are (about to go) asleep: submitting only takes the mutex if this is non-zero. */
+    atomic_size_t sleepers;
+
+    cecies_mutex mutex;
+    cecies_cond work_available;
+    cecies_cond job_done;
+    int shutting_down;
+
+    int notify_fd;
+
+    cecies_thread* threads;
+    size_t thread_count;
+};
+
+static int cecies_async_enqueue(cecies_async_pool* pool, cecies_async_job* job)
+{
+    size_t position = atomic_load_explicit(&pool->enqueue_position, memory_order_relaxed);
+    cecies_async_cell* cell;
+
+    for (;;)
+    {
+        cell = &pool->cells[position & pool->mask];
+        const size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        const intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+        if (difference == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(&pool->enqueue_position, &position, position + 1, memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            return 1; // Full.
+        }
+        else
+        {
+            position = atomic_load_explicit(&pool->enqueue_position, memory_order_relaxed);
+        }
+    }
+
+    cell->job = job;
+    atomic_store_explicit(&cell->sequence, position + 1, memory_order_release);
+    return 0;
+}
+
+static cecies_async_job* cecies_async_dequeue(cecies_async_pool* pool)
+{
+    size_t position = atomic_load_explicit(&pool->dequeue_position, memory_order_relaxed);
+    cecies_async_cell* cell;
+
+    for (;;)
+    {
+        cell = &pool->cells[position & pool->mask];
+        const size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        const intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+
+        if (difference == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(&pool->dequeue_position, &position, position + 1, memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            return NULL; // Empty.
+        }
+        else
+        {
+            position = atomic_load_explicit(&pool->dequeue_position, memory_order_relaxed);
+        }
+    }
+
+    cecies_async_job* job = cell->job;
+    atomic_store_explicit(&cell->sequence, position + pool->mask + 1, memory_order_release);
+    return job;
+}
+
+static void cecies_async_job_destroy(cecies_async_job* job)
+{
+    mbedtls_platform_zeroize(job->key, sizeof(job->key));
+    cecies_free(job->input_path);
+    cecies_free(job->output_path);
+
+    // An output that was never collected may be a decrypted plaintext.
+    if (job->output != NULL)
+    {
+        mbedtls_platform_zeroize(job->output, job->output_length);
+        cecies_free(job->output);
+    }
+
+    cecies_free(job);
+}
+
+static int cecies_async_open_file(const char* path, const int write)
+{
+#ifdef _WIN32
+    return write ? _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE) : _open(path, _O_RDONLY | _O_BINARY);
+#else
+    return write ? open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644) : open(path, O_RDONLY);
+#endif
+}
+
+static void cecies_async_close_file(const int fd)
+{
+    if (fd < 0)
+    {
+        return;
+    }
+#ifdef _WIN32
+    _close(fd);
+#else
+    close(fd);
+#endif
+}
+
+static int cecies_async_file_size(const int fd, uint64_t* size)
+{
+#ifdef _WIN32
+    struct _stat64 st;
+    if (_fstat64(fd, &st) != 0)
+    {
+        return 1;
+    }
+#else
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        return 1;
+    }
+#endif
+    *size = (uint64_t)st.st_size;
+    return 0;
+}
+
+typedef struct cecies_async_file_slot
+{
+    uint8_t* input;
+    uint8_t* output;
+
+    size_t read_length;
+    uint64_t read_offset;
+    int read_done;
+
+    size_t write_length;
+    uint64_t write_offset;
+    int write_pending;
+} cecies_async_file_slot;
+
+/*
+ * Reaps one I/O completion. Short transfers are completed synchronously. Returns 0 on success.
+ */
+static int cecies_async_file_reap(cecies_io* io, cecies_async_file_slot* slots, const int in_fd, const int out_fd)
+{
+    uint64_t tag;
+    int64_t result;
+
+    if (cecies_io_wait(io, &tag, &result) != 0)
+    {
+        return 1;
+    }
+
+    cecies_async_file_slot* slot = &slots[tag >> 1];
+
+    if (tag & 1)
+    {
+        slot->write_pending = 0;
+
+        if (result < 0)
+        {
+            return 1;
+        }
+
+        if ((size_t)result < slot->write_length)
+        {
+            const size_t remaining = slot->write_length - (size_t)result;
+            if (cecies_pwrite_full(out_fd, slot->output + result, remaining, slot->write_offset + (uint64_t)result) != (int64_t)remaining)
+            {
+                return 1;
+            }
+        }
+    }
+    else
+    {
+        slot->read_done = 1;
+
+        if (result < 0)
+        {
+            return 1;
+        }
+
+        if ((size_t)result < slot->read_length)
+        {
+            const size_t remaining = slot->read_length - (size_t)result;
+            if (cecies_pread_full(in_fd, slot->input + result, remaining, slot->read_offset + (uint64_t)result) != (int64_t)remaining)
+            {
+                return 1; // The file shrank while it was being encrypted.
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int cecies_async_encrypt_file(cecies_async_job* job)
+{
+    int ret = 1;
+    int in_fd = -1;
+    int out_fd = -1;
+
+    cecies_io* io = NULL;
+    cecies_encrypt_stream* stream = NULL;
+    uint8_t* buffers = NULL;
+    cecies_async_file_slot slots[CECIES_ASYNC_FILE_SLOTS];
+
+    const size_t chunk_size = CECIES_ASYNC_FILE_CHUNK_SIZE;
+    const size_t slot_size = chunk_size + chunk_size + 16;
+
+    uint8_t header[CECIES_MAX_HEADER_SIZE];
+    size_t header_length = 0;
+
+    uint8_t tail[16];
+    size_t tail_length = 0;
+
+    uint64_t file_size = 0;
+    uint64_t output_offset;
+    uint64_t chunk_count;
+
+    memset(slots, 0x00, sizeof(slots));
+
+    in_fd = cecies_async_open_file(job->input_path, 0);
+    if (in_fd < 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Async file encryption failed: couldn't open the input file \"%s\"!\n", job->input_path);
+        ret = CECIES_ASYNC_ERROR_CODE_FILE_ACCESS_FAILED;
+        goto exit;
+    }
+
+    if (cecies_async_file_size(in_fd, &file_size) != 0)
+    {
+        ret = CECIES_ASYNC_ERROR_CODE_FILE_ACCESS_FAILED;
+        goto exit;
+    }
+
+    if (file_size == 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Async file encryption failed: the input file \"%s\" is empty!\n", job->input_path);
+        ret = CECIES_ASYNC_ERROR_CODE_INVALID_ARG;
+        goto exit;
+    }
+
+    if (job->curve == 0)
+    {
+        cecies_curve25519_key public_key;
+        memcpy(public_key.hexstring, job->key, sizeof(public_key.hexstring));
+        public_key.hexstring[sizeof(public_key.hexstring) - 1] = '\0';
+        ret = cecies_curve25519_encrypt_stream_init(&stream, public_key, job->header_flags, header, sizeof(header), &header_length);
+    }
+    else
+    {
+        cecies_curve448_key public_key;
+        memcpy(public_key.hexstring, job->key, sizeof(public_key.hexstring));
+        public_key.hexstring[sizeof(public_key.hexstring) - 1] = '\0';
+        ret = cecies_curve448_encrypt_stream_init(&stream, public_key, job->header_flags, header, sizeof(header), &header_length);
+    }
+
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    ret = 1;
+
+    buffers = cecies_malloc(CECIES_ASYNC_FILE_SLOTS * slot_size);
+    if (buffers == NULL || cecies_io_init(&io, 2 * CECIES_ASYNC_FILE_SLOTS) != 0)
+    {
+        ret = CECIES_ASYNC_ERROR_CODE_OUT_OF_MEMORY;
+        goto exit;
+    }
+
+    out_fd = cecies_async_open_file(job->output_path, 1);
+    if (out_fd < 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Async file encryption failed: couldn't open the output file \"%s\"!\n", job->output_path);
+        ret = CECIES_ASYNC_ERROR_CODE_FILE_ACCESS_FAILED;
+        goto exit;
+    }
+
+    ret = CECIES_ASYNC_ERROR_CODE_FILE_ACCESS_FAILED;
+
+    chunk_count = (file_size + chunk_size - 1) / chunk_size;
+
+    for (size_t i = 0; i < CECIES_ASYNC_FILE_SLOTS; ++i)
+    {
+        slots[i].input = buffers + i * slot_size;
+        slots[i].output = slots[i].input + chunk_size;
+        slots[i].read_done = 1;
+    }
+
+    // Read ahead as many chunks as there are slots.
+    for (uint64_t chunk = 0; chunk < chunk_count && chunk < CECIES_ASYNC_FILE_SLOTS; ++chunk)
+    {
+        cecies_async_file_slot* slot = &slots[chunk];
+        slot->read_offset = chunk * chunk_size;
+        slot->read_length = (size_t)(file_size - slot->read_offset < chunk_size ? file_size - slot->read_offset : chunk_size);
+        slot->read_done = 0;
+
+        if (cecies_io_submit(io, 0, in_fd, slot->input, slot->read_length, slot->read_offset, chunk << 1) != 0)
+        {
+            slot->read_done = 1;
+            goto exit;
+        }
+    }
+
+    output_offset = header_length;
+
+    for (uint64_t chunk = 0; chunk < chunk_count; ++chunk)
+    {
+        const size_t s = (size_t)(chunk % CECIES_ASYNC_FILE_SLOTS);
+        cecies_async_file_slot* slot = &slots[s];
+
+        if (atomic_load_explicit(&job->cancelled, memory_order_relaxed))
+        {
+            ret = CECIES_ASYNC_ERROR_CODE_CANCELLED;
+            goto exit;
+        }
+
+        while (!slot->read_done || slot->write_pending)
+        {
+            if (cecies_async_file_reap(io, slots, in_fd, out_fd) != 0)
+            {
+                goto exit;
+            }
+        }
+
+        size_t output_length = 0;
+        const int r = cecies_encrypt_stream_update(stream, slot->input, slot->read_length, slot->output, chunk_size + 16, &output_length);
+        if (r != 0)
+        {
+            ret = r;
+            goto exit;
+        }
+
+        if (output_length > 0)
+        {
+            slot->write_length = output_length;
+            slot->write_offset = output_offset;
+            slot->write_pending = 1;
+            output_offset += output_length;
+
+            if (cecies_io_submit(io, 1, out_fd, slot->output, output_length, slot->write_offset, ((uint64_t)s << 1) | 1) != 0)
+            {
+                slot->write_pending = 0;
+                goto exit;
+            }
+        }
+
+        // The plaintext of this chunk is consumed: the slot's input buffer can take the next chunk already.
+        const uint64_t next = chunk + CECIES_ASYNC_FILE_SLOTS;
+        if (next < chunk_count)
+        {
+            slot->read_offset = next * chunk_size;
+            slot->read_length = (size_t)(file_size - slot->read_offset < chunk_size ? file_size - slot->read_offset : chunk_size);
+            slot->read_done = 0;
+
+            if (cecies_io_submit(io, 0, in_fd, slot->input, slot->read_length, slot->read_offset, (uint64_t)s << 1) != 0)
+            {
+                slot->read_done = 1;
+                goto exit;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < CECIES_ASYNC_FILE_SLOTS; ++i)
+    {
+        while (slots[i].write_pending)
+        {
+            if (cecies_async_file_reap(io, slots, in_fd, out_fd) != 0)
+            {
+                goto exit;
+            }
+        }
+    }
+
+    const int r = cecies_encrypt_stream_finish(stream, tail, sizeof(tail), &tail_length, header);
+    if (r != 0)
+    {
+        ret = r;
+        goto exit;
+    }
+
+    if (cecies_pwrite_full(out_fd, tail, tail_length, output_offset) != (int64_t)tail_length //
+        || cecies_pwrite_full(out_fd, header, header_length, 0) != (int64_t)header_length)
+    {
+        goto exit;
+    }
+
+    ret = 0;
+
+exit:
+
+    if (io != NULL)
+    {
+        // Nothing may be freed while the kernel still reads into or writes from it.
+        uint64_t tag;
+        int64_t result;
+        while (cecies_io_wait(io, &tag, &result) == 0)
+        {
+            // Just drain the completions.
+        }
+        cecies_io_free(io);
+    }
+
+    if (buffers != NULL)
+    {
+        mbedtls_platform_zeroize(buffers, CECIES_ASYNC_FILE_SLOTS * slot_size);
+        cecies_free(buffers);
+    }
+
+    cecies_encrypt_stream_free(stream);
+    cecies_async_close_file(in_fd);
+    cecies_async_close_file(out_fd);
+
+    if (ret != 0 && out_fd >= 0)
+    {
+        remove(job->output_path);
+    }
+
+    return ret;
+}
+
+static void cecies_async_run(cecies_async_job* job)
+{
+    if (atomic_load_explicit(&job->cancelled, memory_order_relaxed))
+    {
+        // Cancelled before it even started.
+        job->result = CECIES_ASYNC_ERROR_CODE_CANCELLED;
+        goto completed;
+    }
+
+    switch (job->type)
+    {
+        case CECIES_ASYNC_JOB_ENCRYPT: {
+            if (job->curve == 0)
+            {
+                cecies_curve25519_key public_key;
+                memcpy(public_key.hexstring, job->key, sizeof(public_key.hexstring));
+                public_key.hexstring[sizeof(public_key.hexstring) - 1] = '\0';
+                job->result = cecies_curve25519_encrypt_ext(job->input, job->input_length, job->compress, public_key, job->header_flags, &job->output, &job->output_length, job->base64);
+            }
+            else
+            {
+                cecies_curve448_key public_key;
+                memcpy(public_key.hexstring, job->key, sizeof(public_key.hexstring));
+                public_key.hexstring[sizeof(public_key.hexstring) - 1] = '\0';
+                job->result = cecies_curve448_encrypt_ext(job->input, job->input_length, job->compress, public_key, job->header_flags, &job->output, &job->output_length, job->base64);
+            }
+            break;
+        }
+        case CECIES_ASYNC_JOB_DECRYPT: {
+            if (job->curve == 0)
+            {
+                cecies_curve25519_key private_key;
+                memcpy(private_key.hexstring, job->key, sizeof(private_key.hexstring));
+                private_key.hexstring[sizeof(private_key.hexstring) - 1] = '\0';
+                job->result = cecies_curve25519_decrypt(job->input, job->input_length, job->base64, private_key, &job->output, &job->output_length);
+            }
+            else
+            {
+                cecies_curve448_key private_key;
+                memcpy(private_key.hexstring, job->key, sizeof(private_key.hexstring));
+                private_key.hexstring[sizeof(private_key.hexstring) - 1] = '\0';
+                job->result = cecies_curve448_decrypt(job->input, job->input_length, job->base64, private_key, &job->output, &job->output_length);
+            }
+            break;
+        }
+        case CECIES_ASYNC_JOB_ENCRYPT_FILE: {
+            job->result = cecies_async_encrypt_file(job);
+            break;
+        }
+        default: {
+            job->result = CECIES_ASYNC_ERROR_CODE_INVALID_ARG;
+            break;
+        }
+    }
+
+completed:
+    mbedtls_platform_zeroize(job->key, sizeof(job->key));
+
+    cecies_async_pool* pool = job->pool;
+    const int notify_fd = pool->notify_fd;
+
+    atomic_store_explicit(&job->state, CECIES_ASYNC_JOB_STATE_COMPLETED, memory_order_release);
+
+    if (job->callback != NULL)
+    {
+        job->callback(job, job->user_data);
+    }
+
+    if (job->auto_free)
+    {
+        cecies_async_job_destroy(job);
+    }
+    else
+    {
+        // This is the last time the worker touches the job: the owner may free it as soon as it sees it done.
+        cecies_mutex_lock(&pool->mutex);
+
+        const int released = job->released;
+        job->released = 1;
+
+        if (!released)
+        {
+            atomic_store_explicit(&job->state, CECIES_ASYNC_JOB_STATE_DONE, memory_order_release);
+            cecies_cond_broadcast(&pool->job_done);
+        }
+
+        cecies_mutex_unlock(&pool->mutex);
+
+        if (released)
+        {
+            cecies_async_job_destroy(job);
+        }
+    }
+
+#ifndef _WIN32
+    if (notify_fd >= 0)
+    {
+        const uint64_t one = 1;
+        const ssize_t written = write(notify_fd, &one, sizeof(one));
+        (void)written;
+    }
+#else
+    (void)notify_fd;
+#endif
+}
+
+static void cecies_async_worker(void* arg)
+{
+    cecies_async_pool* pool = arg;
+
+    for (;;)
+    {
+        cecies_async_job* job = cecies_async_dequeue(pool);
+
+        if (job == NULL)
+        {
+            cecies_mutex_lock(&pool->mutex);
+            atomic_fetch_add(&pool->sleepers, 1);
+
+            // Re-checking the queue after announcing the sleeper (and under the mutex) makes sure that no submission can slip through unnoticed.
+            while ((job = cecies_async_dequeue(pool)) == NULL && !pool->shutting_down)
+            {
+                cecies_cond_wait(&pool->work_available, &pool->mutex);
+            }
+
+            atomic_fetch_sub(&pool->sleepers, 1);
+            cecies_mutex_unlock(&pool->mutex);
+
+            if (job == NULL)
+            {
+                return;
+            }
+        }
+
+        cecies_async_run(job);
+    }
+}
+
+int cecies_async_pool_create(cecies_async_pool** out_pool, size_t thread_count, size_t queue_capacity, const int notify_fd)
+{
+    if (out_pool == NULL)
+    {
+        cecies_fprintf(stderr, "CECIES: Async pool creation failed: output pointer argument is NULL!\n");
+        return CECIES_ASYNC_ERROR_CODE_NULL_ARG;
+    }
+
+    if (thread_count == 0)
+    {
+        thread_count = cecies_get_cpu_count();
+    }
+
+    if (queue_capacity == 0)
+    {
+        queue_capacity = CECIES_ASYNC_DEFAULT_QUEUE_CAPACITY;
+    }
+
+    if (queue_capacity > ((size_t)1 << (sizeof(size_t) * 8 - 2)))
+    {
+        cecies_fprintf(stderr, "CECIES: Async pool creation failed: queue capacity too large!\n");
+        return CECIES_ASYNC_ERROR_CODE_INVALID_ARG;
+    }
+
+    size_t capacity = 2;
+    while (capacity < queue_capacity)
+    {
+        capacity <<= 1;
+    }
+
+    cecies_async_pool* pool = cecies_calloc(1, sizeof(cecies_async_pool));
+    if (pool == NULL)
+    {
+        return CECIES_ASYNC_ERROR_CODE_OUT_OF_MEMORY;
+    }
+
+    pool->cells = cecies_calloc(capacity, sizeof(cecies_async_cell));
+    pool->threads = cecies_calloc(thread_count, sizeof(cecies_thread));
+
+    if (pool->cells == NULL || pool->threads == NULL)
+    {
+        cecies_free(pool->cells);
+        cecies_free(pool->threads);
+        cecies_free(pool);
+        return CECIES_ASYNC_ERROR_CODE_OUT_OF_MEMORY;
+    }
+
+    for (size_t i = 0; i < capacity; ++i)
+    {
+        atomic_init(&pool->cells[i].sequence, i);
+    }
+
+    pool->mask = capacity - 1;
+    pool->notify_fd = notify_fd;
+    atomic_init(&pool->enqueue_position, 0);
+    atomic_init(&pool->dequeue_position, 0);
+    atomic_init(&pool->sleepers, 0);
+
+    cecies_mutex_init(&pool->mutex);
+    cecies_cond_init(&pool->work_available);
+    cecies_cond_init(&pool->job_done);
+
+    for (size_t i = 0; i < thread_count; ++i)
+    {
+        if (cecies_thread_create(&pool->threads[i], cecies_async_worker, pool) != 0)
+        {
+            cecies_fprintf(stderr, "CECIES: Async pool creation failed: couldn't start worker thread #%zu!\n", i);
+            cecies_async_pool_free(pool);
+            return CECIES_ASYNC_ERROR_CODE_OUT_OF_MEMORY;
+        }
+        pool->thread_count++;
+    }
+
+    *out_pool = pool;
+    return 0;
+}
+
+void cecies_async_pool_free(cecies_async_pool* pool)
+{
+    if (pool == NULL)
+    {
+        return;
+    }
+
+    cecies_mutex_lock(&pool->mutex);
+    pool->shutting_down = 1;
+    cecies_cond_broadcast(&pool->work_available);
+    cecies_mutex_unlock(&pool->mutex);
+
+    // The workers only exit once the queue is empty, so every submitted job still completes.
+    for (size_t i = 0; i < pool->thread_count; ++i)
+    {
+        cecies_thread_join(pool->threads[i]);
+    }
+
+    cecies_cond_free(&pool->job_done);
+    cecies_cond_free(&pool->work_available);
+    cecies_mutex_free(&pool->mutex);
+
+    cecies_free(pool->threads);
+    cecies_free(pool->cells);
+    cecies_free(pool);
+}
+
+static int cecies_async_submit(cecies_async_pool* pool, cecies_async_job* job, cecies_async_callback callback, void* user_data, cecies_async_job** out_job)
+{
+    job->pool = pool;
+    job->callback = callback;
+    job->user_data = user_data;
+    job->auto_free = out_job == NULL;
+    atomic_init(&job->state, CECIES_ASYNC_JOB_STATE_PENDING);
+    atomic_init(&job->cancelled, 0);
+    job->released = 0;
+
+    if (cecies_async_enqueue(pool, job) != 0)
+    {
+        cecies_async_job_destroy(job);
+        return CECIES_ASYNC_ERROR_CODE_QUEUE_FULL;
+    }
+
+    if (out_job != NULL)
+    {
+        *out_job = job;
+    }
+
+    // Pairs with the sleeper count increment in cecies_async_worker(): either the worker sees the new job, or this sees the sleeper.
+    atomic_thread_fence(memory_order_seq_cst);
+
+    if (atomic_load(&pool->sleepers) > 0)
+    {
+        cecies_mutex_lock(&pool->mutex);
+        cecies_cond_signal(&pool->work_available);
+        cecies_mutex_unlock(&pool->mutex);
+    }
+
+    return 0;
+}
+
+static cecies_async_job* cecies_async_job_new(const int type, const int curve, const char* key, const size_t key_length)
+{
+    cecies_async_job* job = cecies_calloc(1, sizeof(cecies_async_job));
+    if (job == NULL)
+    {
+        return NULL;
+    }
+
+    job->type = type;
+    job->curve = curve;
+    memcpy(job->key, key, key_length);
+    job->key[key_length] = '\0';
+
+    return job;
+}
+
+static char* cecies_async_strdup(const char* string)
+{
+    const size_t length = strlen(string);
+    char* copy = cecies_malloc(length + 1);
+    if (copy != NULL)
+    {
+        memcpy(copy, string, length + 1);
+    }
+    return copy;
+}
+
+static int cecies_encrypt_async(cecies_async_pool* pool, const uint8_t* data, const size_t data_length, const int compress, const int curve, const char* public_key, const size_t public_key_length, const int header_flags, const int output_base64, cecies_async_callback callback, void* user_data, cecies_async_job** out_job)
+{
+    if (pool == NULL || data == NULL)
+    {
+        cecies_fprintf(stderr, "CECIES: Async encryption failed: one or more NULL arguments.\n");
+        return CECIES_ASYNC_ERROR_CODE_NULL_ARG;
+    }
+
+    if (data_length == 0 || compress < 0 || compress > 9)
+    {
+        cecies_fprintf(stderr, "CECIES: Async encryption failed: invalid arguments.\n");
+        return CECIES_ASYNC_ERROR_CODE_INVALID_ARG;
+    }
+
+    cecies_async_job* job = cecies_async_job_new(CECIES_ASYNC_JOB_ENCRYPT, curve, public_key, public_key_length);
+    if (job == NULL)
+    {
+        return CECIES_ASYNC_ERROR_CODE_OUT_OF_MEMORY;
+    }
+
+    job->input = data;
+    job->input_length = data_length;
+    job->compress = compress;
+    job->header_flags = header_flags;
+    job->base64 = output_base64;
+
+    return cecies_async_submit(pool, job, callback, user_data, out_job);
+}
+
+int cecies_curve25519_encrypt_async(cecies_async_pool* pool, const uint8_t* data, const size_t data_length, const int compress, const cecies_curve25519_key public_key, const int header_flags, const int output_base64, cecies_async_callback callback, void* user_data, cecies_async_job** out_job)
+{
+    return cecies_encrypt_async(pool, data, data_length, compress, 0, public_key.hexstring, sizeof(public_key.hexstring) - 1, header_flags, output_base64, callback, user_data, out_job);
+}
+
+int cecies_curve448_encrypt_async(cecies_async_pool* pool, const uint8_t* data, const size_t data_length, const int compress, const cecies_curve448_key public_key, const int header_flags, const int output_base64, cecies_async_callback callback, void* user_data, cecies_async_job** out_job)
+{
+    return cecies_encrypt_async(pool, data, data_length, compress, 1, public_key.hexstring, sizeof(public_key.hexstring) - 1, header_flags, output_base64, callback, user_data, out_job);
+}
+
+static int cecies_decrypt_async(cecies_async_pool* pool, const uint8_t* encrypted_data, const size_t encrypted_data_length, const int encrypted_data_base64, const int curve, char* private_key, const size_t private_key_length, cecies_async_callback callback, void* user_data, cecies_async_job** out_job)
+{
+    int ret;
+
+    if (pool == NULL || encrypted_data == NULL)
+    {
+        cecies_fprintf(stderr, "CECIES: Async decryption failed: one or more NULL arguments.\n");
+        ret = CECIES_ASYNC_ERROR_CODE_NULL_ARG;
+        goto exit;
+    }
+
+    if (encrypted_data_length == 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Async decryption failed: invalid arguments.\n");
+        ret = CECIES_ASYNC_ERROR_CODE_INVALID_ARG;
+        goto exit;
+    }
+
+    cecies_async_job* job = cecies_async_job_new(CECIES_ASYNC_JOB_DECRYPT, curve, private_key, private_key_length);
+    if (job == NULL)
+    {
+        ret = CECIES_ASYNC_ERROR_CODE_OUT_OF_MEMORY;
+        goto exit;
+    }
+
+    job->input = encrypted_data;
+    job->input_length = encrypted_data_length;
+    job->base64 = encrypted_data_base64;
+
+    ret = cecies_async_submit(pool, job, callback, user_data, out_job);
+
+exit:
+    mbedtls_platform_zeroize(private_key, private_key_length);
+    return ret;
+}
+
+int cecies_curve25519_decrypt_async(cecies_async_pool* pool, const uint8_t* encrypted_data, const size_t encrypted_data_length, const int encrypted_data_base64, cecies_curve25519_key private_key, cecies_async_callback callback, void* user_data, cecies_async_job** out_job)
+{
+    return cecies_decrypt_async(pool, encrypted_data, encrypted_data_length, encrypted_data_base64, 0, private_key.hexstring, sizeof(private_key.hexstring) - 1, callback, user_data, out_job);
+}
+
+int cecies_curve448_decrypt_async(cecies_async_pool* pool, const uint8_t* encrypted_data, const size_t encrypted_data_length, const int encrypted_data_base64, cecies_curve448_key private_key, cecies_async_callback callback, void* user_data, cecies_async_job** out_job)
+{
+    return cecies_decrypt_async(pool, encrypted_data, encrypted_data_length, encrypted_data_base64, 1, private_key.hexstring, sizeof(private_key.hexstring) - 1, callback, user_data, out_job);
+}
+
+static int cecies_encrypt_file_async(cecies_async_pool* pool, const char* input_path, const char* output_path, const int curve, const char* public_key, const size_t public_key_length, const int header_flags, cecies_async_callback callback, void* user_data, cecies_async_job** out_job)
+{
+    if (pool == NULL || input_path == NULL || output_path == NULL)
+    {
+        cecies_fprintf(stderr, "CECIES: Async file encryption failed: one or more NULL arguments.\n");
+        return CECIES_ASYNC_ERROR_CODE_NULL_ARG;
+    }
+
+    if (*input_path == '\0' || *output_path == '\0' || strcmp(input_path, output_path) == 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Async file encryption failed: invalid file paths.\n");
+        return CECIES_ASYNC_ERROR_CODE_INVALID_ARG;
+    }
+
+    cecies_async_job* job = cecies_async_job_new(CECIES_ASYNC_JOB_ENCRYPT_FILE, curve, public_key, public_key_length);
+    if (job == NULL)
+    {
+        return CECIES_ASYNC_ERROR_CODE_OUT_OF_MEMORY;
+    }
+
+    job->header_flags = header_flags;
+    job->input_path = cecies_async_strdup(input_path);
+    job->output_path = cecies_async_strdup(output_path);
+
+    if (job->input_path == NULL || job->output_path == NULL)
+    {
+        cecies_async_job_destroy(job);
+        return CECIES_ASYNC_ERROR_CODE_OUT_OF_MEMORY;
+    }
+
+    return cecies_async_submit(pool, job, callback, user_data, out_job);
+}
+
+int cecies_curve25519_encrypt_file_async(cecies_async_pool* pool, const char* input_path, const char* output_path, const cecies_curve25519_key public_key, const int header_flags, cecies_async_callback callback, void* user_data, cecies_async_job** out_job)
+{
+    return cecies_encrypt_file_async(pool, input_path, output_path, 0, public_key.hexstring, sizeof(public_key.hexstring) - 1, header_flags, callback, user_data, out_job);
+}
+
+int cecies_curve448_encrypt_file_async(cecies_async_pool* pool, const char* input_path, const char* output_path, const cecies_curve448_key public_key, const int header_flags, cecies_async_callback callback, void* user_data, cecies_async_job** out_job)
+{
+    return cecies_encrypt_file_async(pool, input_path, output_path, 1, public_key.hexstring, sizeof(public_key.hexstring) - 1, header_flags, callback, user_data, out_job);
+}
+
+int cecies_async_job_is_done(const cecies_async_job* job)
+{
+    return job != NULL && atomic_load_explicit((atomic_int*)&job->state, memory_order_acquire) == CECIES_ASYNC_JOB_STATE_DONE;
+}
+
+int cecies_async_job_wait(cecies_async_job* job)
+{
+    if (job == NULL)
+    {
+        return CECIES_ASYNC_ERROR_CODE_NULL_ARG;
+    }
+
+    if (!cecies_async_job_is_done(job))
+    {
+        // The job isn't done, so its pool can't have been freed yet.
+        cecies_async_pool* pool = job->pool;
+
+        cecies_mutex_lock(&pool->mutex);
+        while (!cecies_async_job_is_done(job))
+        {
+            cecies_cond_wait(&pool->job_done, &pool->mutex);
+        }
+        cecies_mutex_unlock(&pool->mutex);
+    }
+
+    return job->result;
+}
+
+int cecies_async_job_get_result(cecies_async_job* job, uint8_t** output, size_t* output_length)
+{
+    if (job == NULL)
+    {
+        return CECIES_ASYNC_ERROR_CODE_NULL_ARG;
+    }
+
+    if (atomic_load_explicit(&job->state, memory_order_acquire) == CECIES_ASYNC_JOB_STATE_PENDING)
+    {
+        return CECIES_ASYNC_ERROR_CODE_IN_PROGRESS;
+    }
+
+    if (output_length != NULL)
+    {
+        *output_length = job->output_length;
+    }
+
+    if (output != NULL)
+    {
+        *output = job->output;
+        job->output = NULL;
+    }
+
+    return job->result;
+}
+
+void cecies_async_job_free(cecies_async_job* job)
+{
+    if (job == NULL)
+    {
+        return;
+    }
+
+    cecies_async_job_wait(job);
+    cecies_async_job_destroy(job);
+}
+
+int cecies_async_job_cancel(cecies_async_job* job)
+{
+    if (job == NULL)
+    {
+        return CECIES_ASYNC_ERROR_CODE_NULL_ARG;
+    }
+
+    atomic_store_explicit(&job->cancelled, 1, memory_order_relaxed);
+    return 0;
+}
+
+void cecies_async_job_release(cecies_async_job* job)
+{
+    if (job == NULL)
+    {
+        return;
+    }
+
+    if (cecies_async_job_is_done(job))
+    {
+        cecies_async_job_destroy(job);
+        return;
+    }
+
+    // The job isn't done, so its pool can't have been freed yet.
+    cecies_async_pool* pool = job->pool;
+
+    cecies_mutex_lock(&pool->mutex);
+    const int released = job->released;
+    job->released = 1;
+    cecies_mutex_unlock(&pool->mutex);
+
+    if (released)
+    {
+        cecies_async_job_destroy(job);
+    }
+}
@@ -0,0 +1,307 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <zlib.h>
+#include <ccrush.h>
+#include <mbedtls/platform_util.h>
+
+#include "cecies/util.h"
+#include "internal.h"
+
+/*
+ * Compression produces raw deflate data (src/deflate.c) and decompression inflates it (src/inflate.c), with CECIES writing and checking the zlib header and Adler-32 trailer itself:
+ * that way the checksum is computed by the vectorized cecies_adler32() instead of zlib's scalar one, and the output buffers are sized once up front
+ * instead of growing chunk by chunk. The result is an ordinary zlib stream either way (ccrush_decompress() and any other zlib inflate read it just fine).
+ *
+ * For large inputs the compressor works pigz-style: the input is cut into blocks that are deflated independently on worker threads,
+ * each one primed with the last 32 KiB of the previous block as dictionary so that the compression ratio barely suffers.
+ * Every block but the last one ends with a sync flush (which byte-aligns it), so the blocks can simply be concatenated
+ * between the zlib header and the combined Adler-32 of the whole input.
+ *
+ * Both directions are one-shot, which is what makes them faster than zlib's streaming code: see the notes at the top of src/inflate.c and src/deflate.c.
+ * The streaming APIs (reader, restartable, iovec) still go through zlib.
+ */
+
+#define CECIES_PARALLEL_COMPRESSION_BLOCK_SIZE (128 * 1024)
+
+/* Single-threaded compression still splits gigantic inputs, because cecies_deflate_raw() keeps track of input positions in 32 bits. */
+#define CECIES_COMPRESSION_MAX_BLOCK_SIZE (1024 * 1024 * 1024)
+
+#define CECIES_PARALLEL_COMPRESSION_DICTIONARY_SIZE (32 * 1024)
+
+size_t cecies_parallel_compression_get_thread_count(const size_t length)
+{
+    cecies_config config;
+    cecies_get_config(&config);
+
+    if (config.parallel_compression_threshold == 0 || length < config.parallel_compression_threshold)
+    {
+        return 1;
+    }
+
+    const size_t thread_count = config.parallel_compression_thread_count != 0 ? config.parallel_compression_thread_count : cecies_get_cpu_count();
+    return CECIES_MAX(1, CECIES_MIN(thread_count, (length + CECIES_PARALLEL_COMPRESSION_BLOCK_SIZE - 1) / CECIES_PARALLEL_COMPRESSION_BLOCK_SIZE));
+}
+
+typedef struct cecies_compression_block
+{
+    const uint8_t* input;
+    size_t input_length;
+
+    uint8_t* output;
+    size_t output_size;
+    size_t output_length;
+
+    uLong adler;
+    int ret;
+} cecies_compression_block;
+
+typedef struct cecies_compression_context
+{
+    const uint8_t* data;
+    size_t data_length;
+    int level;
+
+    cecies_compression_block* blocks;
+    size_t blocks_count;
+
+    cecies_mutex mutex;
+    size_t next_block;
+} cecies_compression_context;
+
+static int cecies_compress_block(const cecies_compression_context* ctx, const size_t index)
+{
+    cecies_compression_block* block = &ctx->blocks[index];
+    const int last = index == ctx->blocks_count - 1;
+
+    // Every block but the first one is primed with the input that precedes it (the blocks are then concatenated into one raw deflate stream).
+    const size_t dictionary_length = index > 0 ? CECIES_MIN(CECIES_PARALLEL_COMPRESSION_DICTIONARY_SIZE, (size_t)(block->input - ctx->data)) : 0;
+
+    // Non-last blocks end with a sync flush: at most an empty stored block (5 bytes) plus the bits needed to byte-align the output.
+    const size_t output_size = cecies_deflate_bound(block->input_length) + 16;
+
+    block->output = cecies_malloc(output_size);
+    block->output_size = output_size;
+    if (block->output == NULL)
+    {
+        return CCRUSH_ERROR_OUT_OF_MEMORY;
+    }
+
+    const int ret = cecies_deflate_raw(block->input, block->input_length, dictionary_length, ctx->level == Z_DEFAULT_COMPRESSION ? 6 : ctx->level, last, block->output, output_size, &block->output_length);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    block->adler = cecies_adler32(1, block->input, block->input_length);
+    return 0;
+}
+
+static void cecies_compression_worker(void* arg)
+{
+    cecies_compression_context* ctx = (cecies_compression_context*)arg;
+
+    for (;;)
+    {
+        cecies_mutex_lock(&ctx->mutex);
+        const size_t index = ctx->next_block++;
+        cecies_mutex_unlock(&ctx->mutex);
+
+        if (index >= ctx->blocks_count)
+        {
+            return;
+        }
+
+        ctx->blocks[index].ret = cecies_compress_block(ctx, index);
+    }
+}
+
+int cecies_compress(const uint8_t* data, const size_t data_length, int level, size_t thread_count, uint8_t** out_data, size_t* out_data_length)
+{
+    if (data == NULL || data_length == 0 || out_data == NULL || out_data_length == NULL)
+    {
+        return CCRUSH_ERROR_INVALID_ARGS;
+    }
+
+    int ret = 1;
+
+    level = level < 1 ? Z_DEFAULT_COMPRESSION : CECIES_MIN(level, 9);
+
+    cecies_compression_context ctx;
+    memset(&ctx, 0x00, sizeof(ctx));
+
+    ctx.data = data;
+    ctx.data_length = data_length;
+    ctx.level = level;
+
+    const size_t block_size = thread_count > 1 ? CECIES_PARALLEL_COMPRESSION_BLOCK_SIZE : CECIES_COMPRESSION_MAX_BLOCK_SIZE;
+    ctx.blocks_count = (data_length + block_size - 1) / block_size;
+
+    cecies_mutex_init(&ctx.mutex);
+
+    cecies_thread* threads = NULL;
+    size_t threads_started = 0;
+
+    ctx.blocks = cecies_calloc(ctx.blocks_count, sizeof(cecies_compression_block));
+    if (ctx.blocks == NULL)
+    {
+        ret = CCRUSH_ERROR_OUT_OF_MEMORY;
+        goto exit;
+    }
+
+    for (size_t i = 0; i < ctx.blocks_count; ++i)
+    {
+        const size_t offset = i * block_size;
+        ctx.blocks[i].input = data + offset;
+        ctx.blocks[i].input_length = CECIES_MIN(block_size, data_length - offset);
+    }
+
+    thread_count = CECIES_MIN(thread_count, ctx.blocks_count);
+
+    if (thread_count > 1)
+    {
+        threads = cecies_malloc((thread_count - 1) * sizeof(cecies_thread));
+        if (threads == NULL)
+        {
+            ret = CCRUSH_ERROR_OUT_OF_MEMORY;
+            goto exit;
+        }
+
+        for (; threads_started < thread_count - 1; ++threads_started)
+        {
+            if (cecies_thread_create(&threads[threads_started], cecies_compression_worker, &ctx) != 0)
+            {
+                break; // Just continue with the threads we've got.
+            }
+        }
+    }
+
+    // The calling thread participates too.
+    cecies_compression_worker(&ctx);
+
+    for (size_t i = 0; i < threads_started; ++i)
+    {
+        cecies_thread_join(threads[i]);
+    }
+
+    size_t total_length = 2 + 4;
+    uLong adler = 1;
+
+    for (size_t i = 0; i < ctx.blocks_count; ++i)
+    {
+        if (ctx.blocks[i].ret != 0)
+        {
+            ret = ctx.blocks[i].ret;
+            goto exit;
+        }
+
+        total_length += ctx.blocks[i].output_length;
+        adler = adler32_combine(adler, ctx.blocks[i].adler, (z_off_t)ctx.blocks[i].input_length);
+    }
+
+    uint8_t* output = cecies_malloc(total_length);
+    if (output == NULL)
+    {
+        ret = CCRUSH_ERROR_OUT_OF_MEMORY;
+        goto exit;
+    }
+
+    // zlib header: CMF 0x78 (deflate, 32 KiB window), FLG with the same compression level hint that zlib itself would write and FCHECK.
+    const unsigned level_flags = level == Z_DEFAULT_COMPRESSION ? 2 : level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+    unsigned header = (0x78u << 8) | (level_flags << 6);
+    header += 31 - (header % 31);
+
+    output[0] = (uint8_t)(header >> 8);
+    output[1] = (uint8_t)header;
+
+    size_t offset = 2;
+
+    for (size_t i = 0; i < ctx.blocks_count; ++i)
+    {
+        memcpy(output + offset, ctx.blocks[i].output, ctx.blocks[i].output_length);
+        offset += ctx.blocks[i].output_length;
+    }
+
+    output[offset++] = (uint8_t)(adler >> 24);
+    output[offset++] = (uint8_t)(adler >> 16);
+    output[offset++] = (uint8_t)(adler >> 8);
+    output[offset++] = (uint8_t)adler;
+
+    *out_data = output;
+    *out_data_length = total_length;
+    ret = 0;
+
+exit:
+    if (ctx.blocks != NULL)
+    {
+        for (size_t i = 0; i < ctx.blocks_count; ++i)
+        {
+            if (ctx.blocks[i].output != NULL)
+            {
+                mbedtls_platform_zeroize(ctx.blocks[i].output, ctx.blocks[i].output_size);
+                cecies_free(ctx.blocks[i].output);
+            }
+        }
+    }
+
+    cecies_mutex_free(&ctx.mutex);
+
+    cecies_free(ctx.blocks);
+    cecies_free(threads);
+
+    return (ret);
+}
+
+int cecies_decompress(const uint8_t* data, const size_t data_length, uint8_t** out_data, size_t* out_data_length)
+{
+    // zlib header (2 bytes, no preset dictionary) + at least one byte of deflate data + Adler-32 trailer (4 bytes).
+    if (data == NULL || data_length < 7 || out_data == NULL || out_data_length == NULL)
+    {
+        return CCRUSH_ERROR_INVALID_ARGS;
+    }
+
+    if ((data[0] & 0x0f) != Z_DEFLATED || (data[0] >> 4) > 7 || (data[1] & 0x20) != 0 || ((data[0] << 8) | data[1]) % 31 != 0)
+    {
+        return CCRUSH_ERROR_ZLIB;
+    }
+
+    uint8_t* output = NULL;
+    size_t output_length = 0;
+
+    // The deflate data sits between the header and the Adler-32 trailer, and has to end right where the trailer starts.
+    int ret = cecies_inflate_raw(data + 2, data_length - 2 - 4, data_length < SIZE_MAX / 4 ? data_length * 4 : data_length, &output, &output_length);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    const uint8_t* trailer = data + data_length - 4;
+    const uint32_t expected_adler = ((uint32_t)trailer[0] << 24) | ((uint32_t)trailer[1] << 16) | ((uint32_t)trailer[2] << 8) | (uint32_t)trailer[3];
+
+    if (cecies_adler32(1, output, output_length) != expected_adler)
+    {
+        mbedtls_platform_zeroize(output, output_length);
+        cecies_free(output);
+        return CCRUSH_ERROR_ZLIB;
+    }
+
+    *out_data = output;
+    *out_data_length = output_length;
+    return 0;
+}
@@ -0,0 +1,102 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <stdatomic.h>
+
+#include "cecies/util.h"
+
+/*
+ * The global settings (see cecies_config) live here, one atomic per field:
+ * they're read on every en-/decryption, possibly while another thread changes them.
+ * Relaxed ordering is enough because every field is valid on its own (a reader may see one setter's threshold next to another setter's thread count).
+ */
+
+static atomic_size_t cecies_config_parallel_gcm_threshold = CECIES_PARALLEL_GCM_DEFAULT_THRESHOLD;
+static atomic_size_t cecies_config_parallel_gcm_thread_count = 0;
+static atomic_size_t cecies_config_parallel_compression_threshold = CECIES_PARALLEL_COMPRESSION_DEFAULT_THRESHOLD;
+static atomic_size_t cecies_config_parallel_compression_thread_count = 0;
+static atomic_int cecies_config_multi_buffer_gcm = 1;
+static atomic_int cecies_config_multi_buffer_sha512 = 1;
+static atomic_size_t cecies_config_simd_x25519_max_lanes = 8;
+
+void cecies_get_config(cecies_config* config)
+{
+    if (config == NULL)
+    {
+        return;
+    }
+
+    config->parallel_gcm_threshold = atomic_load_explicit(&cecies_config_parallel_gcm_threshold, memory_order_relaxed);
+    config->parallel_gcm_thread_count = atomic_load_explicit(&cecies_config_parallel_gcm_thread_count, memory_order_relaxed);
+    config->parallel_compression_threshold = atomic_load_explicit(&cecies_config_parallel_compression_threshold, memory_order_relaxed);
+    config->parallel_compression_thread_count = atomic_load_explicit(&cecies_config_parallel_compression_thread_count, memory_order_relaxed);
+    config->multi_buffer_gcm = atomic_load_explicit(&cecies_config_multi_buffer_gcm, memory_order_relaxed);
+    config->multi_buffer_sha512 = atomic_load_explicit(&cecies_config_multi_buffer_sha512, memory_order_relaxed);
+    config->simd_x25519_max_lanes = atomic_load_explicit(&cecies_config_simd_x25519_max_lanes, memory_order_relaxed);
+}
+
+void cecies_set_config(const cecies_config* config)
+{
+    static const cecies_config defaults = {
+        .parallel_gcm_threshold = CECIES_PARALLEL_GCM_DEFAULT_THRESHOLD,
+        .parallel_gcm_thread_count = 0,
+        .parallel_compression_threshold = CECIES_PARALLEL_COMPRESSION_DEFAULT_THRESHOLD,
+        .parallel_compression_thread_count = 0,
+        .multi_buffer_gcm = 1,
+        .multi_buffer_sha512 = 1,
+        .simd_x25519_max_lanes = 8,
+    };
+
+    if (config == NULL)
+    {
+        config = &defaults;
+    }
+
+    atomic_store_explicit(&cecies_config_parallel_gcm_threshold, config->parallel_gcm_threshold, memory_order_relaxed);
+    atomic_store_explicit(&cecies_config_parallel_gcm_thread_count, config->parallel_gcm_thread_count, memory_order_relaxed);
+    atomic_store_explicit(&cecies_config_parallel_compression_threshold, config->parallel_compression_threshold, memory_order_relaxed);
+    atomic_store_explicit(&cecies_config_parallel_compression_thread_count, config->parallel_compression_thread_count, memory_order_relaxed);
+    atomic_store_explicit(&cecies_config_multi_buffer_gcm, config->multi_buffer_gcm, memory_order_relaxed);
+    atomic_store_explicit(&cecies_config_multi_buffer_sha512, config->multi_buffer_sha512, memory_order_relaxed);
+    atomic_store_explicit(&cecies_config_simd_x25519_max_lanes, config->simd_x25519_max_lanes, memory_order_relaxed);
+}
+
+void cecies_set_parallel_gcm(const size_t threshold, const size_t thread_count)
+{
+    atomic_store_explicit(&cecies_config_parallel_gcm_threshold, threshold, memory_order_relaxed);
+    atomic_store_explicit(&cecies_config_parallel_gcm_thread_count, thread_count, memory_order_relaxed);
+}
+
+void cecies_set_multi_buffer_gcm(const int enabled)
+{
+    atomic_store_explicit(&cecies_config_multi_buffer_gcm, enabled, memory_order_relaxed);
+}
+
+void cecies_set_multi_buffer_sha512(const int enabled)
+{
+    atomic_store_explicit(&cecies_config_multi_buffer_sha512, enabled, memory_order_relaxed);
+}
+
+void cecies_set_simd_x25519(const size_t max_lanes)
+{
+    atomic_store_explicit(&cecies_config_simd_x25519_max_lanes, max_lanes, memory_order_relaxed);
+}
+
+void cecies_set_parallel_compression(const size_t threshold, const size_t thread_count)
+{
+    atomic_store_explicit(&cecies_config_parallel_compression_threshold, threshold, memory_order_relaxed);
+    atomic_store_explicit(&cecies_config_parallel_compression_thread_count, thread_count, memory_order_relaxed);
+}
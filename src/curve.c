@@ -0,0 +1,59 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <string.h>
+
+#include <mbedtls/gcm.h>
+#include <mbedtls/ecp.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/platform_util.h>
+
+#include "cecies/util.h"
+#include "cecies/encrypt.h"
+#include "cecies/decrypt.h"
+#include "cecies/kem.h"
+#include "internal.h"
+
+#include "cecies/data.txt"
+
+void cecies_key_state_free(cecies_key_state* state)
+{
+    mbedtls_ecp_group_free(&state->ecp_group);
+    mbedtls_entropy_free(&state->entropy);
+    mbedtls_ctr_drbg_free(&state->ctr_drbg);
+    mbedtls_ecp_point_free(&state->QA);
+    mbedtls_mpi_free(&state->dA);
+    mbedtls_platform_zeroize(state, sizeof(cecies_key_state));
+}
+
+/*
+ * The curve-specialized functions are stamped out of curve_impl.h: once per curve, with everything that depends on the curve as compile-time constants.
+ */
+
+#define CECIES_CURVE cecies_curve25519
+#define CECIES_CURVE_ID 0
+#define CECIES_CURVE_KEY cecies_curve25519_key
+#define CECIES_CURVE_KEY_SIZE CECIES_X25519_KEY_SIZE
+#define CECIES_CURVE_GROUP MBEDTLS_ECP_DP_CURVE25519
+#include "curve_impl.h"
+
+#define CECIES_CURVE cecies_curve448
+#define CECIES_CURVE_ID 1
+#define CECIES_CURVE_KEY cecies_curve448_key
+#define CECIES_CURVE_KEY_SIZE CECIES_X448_KEY_SIZE
+#define CECIES_CURVE_GROUP MBEDTLS_ECP_DP_CURVE448
+#include "curve_impl.h"
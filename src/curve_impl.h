@@ -0,0 +1,580 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/*
+ * Curve-specialized implementation template: this file has no include guard on purpose and is included by curve.c once per curve.
+ * Before including it, define:
+ *
+ *   CECIES_CURVE             The function name prefix (e.g. cecies_curve25519).
+ *   CECIES_CURVE_ID          0 for Curve25519, 1 for Curve448 (as in the "curve" arguments throughout the library).
+ *   CECIES_CURVE_KEY         The public key struct type (cecies_curve25519_key or cecies_curve448_key).
+ *   CECIES_CURVE_KEY_SIZE    The raw key size in bytes.
+ *   CECIES_CURVE_GROUP       The MbedTLS ECP group ID.
+ *
+ * Key sizes (and thus all key/secret buffers below) are compile-time constants here, so nothing needs to be sized for the worst case.
+ * All of the above macros are undefined again at the end of this file.
+ */
+
+#define CECIES_CURVE_FN_(prefix, name) prefix##_##name
+#define CECIES_CURVE_FN_EXPAND(prefix, name) CECIES_CURVE_FN_(prefix, name)
+#define CECIES_CURVE_FN(name) CECIES_CURVE_FN_EXPAND(CECIES_CURVE, name)
+
+int CECIES_CURVE_FN(key_state_init)(cecies_key_state* state, const uint8_t* public_key, const uint8_t* private_key)
+{
+    int ret = 1;
+
+    memset(state, 0x00, sizeof(cecies_key_state));
+    state->curve = CECIES_CURVE_ID;
+
+    mbedtls_ecp_group_init(&state->ecp_group);
+    mbedtls_entropy_init(&state->entropy);
+    mbedtls_ctr_drbg_init(&state->ctr_drbg);
+    mbedtls_ecp_point_init(&state->QA);
+    mbedtls_mpi_init(&state->dA);
+
+    ret = cecies_seed_ctr_drbg(&state->ctr_drbg, &state->entropy);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    ret = mbedtls_ecp_group_load(&state->ecp_group, CECIES_CURVE_GROUP);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: MbedTLS ECP group setup failed! mbedtls_ecp_group_load returned %d\n", ret);
+        goto exit;
+    }
+
+    if (public_key != NULL)
+    {
+        ret = mbedtls_ecp_point_read_binary(&state->ecp_group, &state->QA, public_key, CECIES_CURVE_KEY_SIZE);
+        if (ret != 0)
+        {
+            cecies_fprintf(stderr, "CECIES: Parsing recipient's public key failed! mbedtls_ecp_point_read_binary returned %d\n", ret);
+            goto exit;
+        }
+
+        ret = mbedtls_ecp_check_pubkey(&state->ecp_group, &state->QA);
+        if (ret != 0)
+        {
+            cecies_fprintf(stderr, "CECIES: Recipient public key invalid! mbedtls_ecp_check_pubkey returned %d\n", ret);
+            goto exit;
+        }
+
+        memcpy(state->public_key, public_key, CECIES_CURVE_KEY_SIZE);
+        state->has_public_key = 1;
+    }
+
+    if (private_key != NULL)
+    {
+        ret = mbedtls_mpi_read_binary(&state->dA, private_key, CECIES_CURVE_KEY_SIZE);
+        if (ret != 0)
+        {
+            cecies_fprintf(stderr, "CECIES: Parsing decryption private key failed! mbedtls_mpi_read_binary returned %d\n", ret);
+            goto exit;
+        }
+
+        ret = mbedtls_ecp_check_privkey(&state->ecp_group, &state->dA);
+        if (ret != 0)
+        {
+            cecies_fprintf(stderr, "CECIES: Invalid decryption private key! mbedtls_ecp_check_privkey returned %d\n", ret);
+            goto exit;
+        }
+
+        state->has_private_key = 1;
+    }
+
+exit:
+
+    if (ret != 0)
+    {
+        cecies_key_state_free(state);
+    }
+
+    return (ret);
+}
+
+int CECIES_CURVE_FN(encryption_setup_prepare)(cecies_key_state* state, const int header_flags, const uint8_t* R_bytes, cecies_encryption_setup* setup)
+{
+    if ((header_flags & ~CECIES_HEADER_FLAGS_SUPPORTED) != 0 || !state->has_public_key)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    int ret = 1;
+
+    memset(setup, 0x00, sizeof(cecies_encryption_setup));
+    setup->curve = CECIES_CURVE_ID;
+    setup->header_flags = header_flags | (CECIES_CURVE_ID == 0 ? 0 : CECIES_HEADER_FLAG_CURVE448);
+    setup->ext_header_length = cecies_calc_ext_header_length(setup->header_flags);
+    setup->header_length = setup->ext_header_length + 16 + 32 + CECIES_CURVE_KEY_SIZE + 16;
+
+    ret = mbedtls_ctr_drbg_random(&state->ctr_drbg, setup->salt, 32);
+    if (ret != 0 || memcmp(setup->salt, empty32, 32) == 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Salt generation failed! mbedtls_ctr_drbg_random returned %d\n", ret);
+        goto exit;
+    }
+
+    ret = mbedtls_ctr_drbg_random(&state->ctr_drbg, setup->iv, 16);
+    if (ret != 0 || memcmp(setup->iv, empty32, 16) == 0)
+    {
+        cecies_fprintf(stderr, "CECIES: IV generation failed! mbedtls_ctr_drbg_random returned %d\n", ret);
+        goto exit;
+    }
+
+    memcpy(setup->R, R_bytes, CECIES_CURVE_KEY_SIZE);
+
+    if (header_flags & CECIES_HEADER_FLAG_KEY_ID)
+    {
+        cecies_calc_key_id(state->public_key, CECIES_CURVE_KEY_SIZE, setup->key_id);
+    }
+
+exit:
+
+    if (ret != 0)
+    {
+        mbedtls_platform_zeroize(setup, sizeof(cecies_encryption_setup));
+    }
+
+    return (ret);
+}
+
+int CECIES_CURVE_FN(encryption_setup_init_from_secret)(cecies_key_state* state, const int header_flags, const uint8_t* R_bytes, const uint8_t* S_bytes, cecies_encryption_setup* setup)
+{
+    int ret = CECIES_CURVE_FN(encryption_setup_prepare)(state, header_flags, R_bytes, setup);
+    if (ret != 0)
+    {
+        return (ret);
+    }
+
+    ret = cecies_derive_keys(setup->salt, S_bytes, CECIES_CURVE_KEY_SIZE, setup->aes_key, (header_flags & CECIES_HEADER_FLAG_KEY_COMMITMENT) ? setup->key_commitment : NULL);
+
+    return cecies_encryption_setup_check_keys(ret, setup);
+}
+
+int CECIES_CURVE_FN(encryption_setup_init_from_state)(cecies_key_state* state, const int header_flags, cecies_encryption_setup* setup)
+{
+    if ((header_flags & ~CECIES_HEADER_FLAGS_SUPPORTED) != 0 || !state->has_public_key)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    int ret = 1;
+
+    // Variables named after the ECIES illustration on https://asecuritysite.com/encryption/go_ecies
+    mbedtls_mpi r;
+    mbedtls_ecp_point R;
+    mbedtls_ecp_point S;
+
+    mbedtls_mpi_init(&r);
+    mbedtls_ecp_point_init(&R);
+    mbedtls_ecp_point_init(&S);
+
+    uint8_t S_bytes[CECIES_CURVE_KEY_SIZE] = { 0x00 };
+    uint8_t R_bytes[CECIES_CURVE_KEY_SIZE] = { 0x00 };
+
+    size_t R_bytes_length = 0, S_bytes_length = 0;
+
+    ret = cecies_ecp_gen_keypair(&state->ecp_group, &r, &R, mbedtls_ctr_drbg_random, &state->ctr_drbg);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Ephemeral keypair generation failed! cecies_ecp_gen_keypair returned %d\n", ret);
+        goto exit;
+    }
+
+    ret = mbedtls_ecp_check_privkey(&state->ecp_group, &r);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Ephemeral private key invalid! mbedtls_ecp_check_privkey returned %d\n", ret);
+        goto exit;
+    }
+
+    ret = mbedtls_ecp_check_pubkey(&state->ecp_group, &R);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Ephemeral public key invalid! mbedtls_ecp_check_pubkey returned %d\n", ret);
+        goto exit;
+    }
+
+    ret = mbedtls_ecp_mul(&state->ecp_group, &S, &r, &state->QA, mbedtls_ctr_drbg_random, &state->ctr_drbg);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: ECP scalar multiplication failed! mbedtls_ecp_mul returned %d\n", ret);
+        goto exit;
+    }
+
+    ret = mbedtls_ecp_point_write_binary(&state->ecp_group, &S, MBEDTLS_ECP_PF_UNCOMPRESSED, &S_bytes_length, S_bytes, sizeof(S_bytes));
+    if (ret != 0 || S_bytes_length != CECIES_CURVE_KEY_SIZE)
+    {
+        cecies_fprintf(stderr, "CECIES: encryption failed! mbedtls_ecp_point_write_binary returned %d ; or incorrect ECP point binary length.\n", ret);
+        goto exit;
+    }
+
+    ret = mbedtls_ecp_point_write_binary(&state->ecp_group, &R, MBEDTLS_ECP_PF_UNCOMPRESSED, &R_bytes_length, R_bytes, sizeof(R_bytes));
+    if (ret != 0 || R_bytes_length != CECIES_CURVE_KEY_SIZE)
+    {
+        cecies_fprintf(stderr, "CECIES: encryption failed! mbedtls_ecp_point_write_binary returned %d ; or incorrect ephemeral public key length written by mbedtls_ecp_point_write_binary function..\n", ret);
+        goto exit;
+    }
+
+    ret = CECIES_CURVE_FN(encryption_setup_init_from_secret)(state, header_flags, R_bytes, S_bytes, setup);
+
+exit:
+
+    mbedtls_mpi_free(&r);
+    mbedtls_ecp_point_free(&R);
+    mbedtls_ecp_point_free(&S);
+
+    mbedtls_platform_zeroize(S_bytes, sizeof(S_bytes));
+    mbedtls_platform_zeroize(R_bytes, sizeof(R_bytes));
+
+    return (ret);
+}
+
+int CECIES_CURVE_FN(encryption_setup_init)(const char* public_key, const int header_flags, cecies_encryption_setup* setup)
+{
+    if ((header_flags & ~CECIES_HEADER_FLAGS_SUPPORTED) != 0)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    cecies_key_state state;
+
+    // The +1 is for the NUL-terminator that cecies_hexstr2bin() appends.
+    size_t public_key_bytes_length;
+    uint8_t public_key_bytes[CECIES_CURVE_KEY_SIZE + 1] = { 0x00 };
+
+    int ret = cecies_hexstr2bin(public_key, CECIES_CURVE_KEY_SIZE * 2, public_key_bytes, sizeof(public_key_bytes), &public_key_bytes_length);
+    if (ret != 0 || public_key_bytes_length != CECIES_CURVE_KEY_SIZE)
+    {
+        cecies_fprintf(stderr, "CECIES: Parsing recipient's public key failed! Invalid hex string format...\n");
+        mbedtls_platform_zeroize(setup, sizeof(cecies_encryption_setup));
+        return ret != 0 ? ret : CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    ret = CECIES_CURVE_FN(key_state_init)(&state, public_key_bytes, NULL);
+    if (ret != 0)
+    {
+        mbedtls_platform_zeroize(setup, sizeof(cecies_encryption_setup));
+        return (ret);
+    }
+
+    ret = CECIES_CURVE_FN(encryption_setup_init_from_state)(&state, header_flags, setup);
+
+    cecies_key_state_free(&state);
+    return (ret);
+}
+
+int CECIES_CURVE_FN(read_ephemeral_key)(cecies_key_state* state, const cecies_header* header, mbedtls_ecp_point* R)
+{
+    int ret = mbedtls_ecp_point_read_binary(&state->ecp_group, R, header->R, CECIES_CURVE_KEY_SIZE);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Parsing ephemeral public key failed! mbedtls_ecp_point_read_binary returned %d\n", ret);
+        return (ret);
+    }
+
+    ret = mbedtls_ecp_check_pubkey(&state->ecp_group, R);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Ephemeral public key invalid! mbedtls_ecp_check_pubkey returned %d\n", ret);
+    }
+
+    return (ret);
+}
+
+int CECIES_CURVE_FN(derive_header_key_from_state)(cecies_key_state* state, const cecies_header* header, uint8_t aes_key[32])
+{
+    if (!state->has_private_key)
+    {
+        return CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    int ret = 1;
+
+    // Variables named after the ECIES illustration on https://asecuritysite.com/encryption/go_ecies
+    mbedtls_ecp_point R;
+    mbedtls_ecp_point_init(&R);
+
+    ret = CECIES_CURVE_FN(read_ephemeral_key)(state, header, &R);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    ret = cecies_derive_aes_key(&state->ecp_group, &state->ctr_drbg, &state->dA, &R, header, CECIES_CURVE_KEY_SIZE, aes_key);
+    if (ret == CECIES_DECRYPT_ERROR_CODE_WRONG_KEY)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed! The key commitment doesn't match: wrong private key.\n");
+    }
+
+exit:
+
+    mbedtls_ecp_point_free(&R);
+
+    return (ret);
+}
+
+int CECIES_CURVE_FN(derive_header_key)(const cecies_header* header, const uint8_t* private_key, uint8_t aes_key[32])
+{
+    cecies_key_state state;
+
+    int ret = CECIES_CURVE_FN(key_state_init)(&state, NULL, private_key);
+    if (ret != 0)
+    {
+        return (ret);
+    }
+
+    ret = CECIES_CURVE_FN(derive_header_key_from_state)(&state, header, aes_key);
+
+    cecies_key_state_free(&state);
+    return (ret);
+}
+
+int CECIES_CURVE_FN(encrypt_to_buffer)(const uint8_t* data, const size_t data_length, CECIES_CURVE_KEY public_key, const int header_flags, uint8_t* output, const size_t output_size, size_t* output_length)
+{
+    if (data == NULL || output == NULL || output_length == NULL)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    if (data_length == 0 || (header_flags & ~CECIES_HEADER_FLAGS_SUPPORTED) != 0)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    const size_t olen = cecies_calc_ext_header_length(header_flags | (CECIES_CURVE_ID == 0 ? 0 : CECIES_HEADER_FLAG_CURVE448)) + cecies_calc_output_buffer_needed_size(data_length, CECIES_CURVE_KEY_SIZE);
+
+    if (output_size < olen)
+    {
+        cecies_fprintf(stderr, "CECIES: encryption failed: output buffer too small (%zu bytes needed).\n", olen);
+        return CECIES_ENCRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE;
+    }
+
+    int ret = 1;
+
+#if CECIES_STACK_ARENA_SIZE > 0
+    uint8_t arena_buffer[CECIES_STACK_ARENA_SIZE];
+    cecies_arena arena;
+    cecies_arena_push(&arena, arena_buffer, sizeof(arena_buffer));
+#endif
+
+    cecies_encryption_setup setup;
+
+    mbedtls_gcm_context aes_ctx;
+    mbedtls_gcm_init(&aes_ctx);
+
+    ret = CECIES_CURVE_FN(encryption_setup_init)(public_key.hexstring, header_flags, &setup);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    ret = mbedtls_gcm_setkey(&aes_ctx, MBEDTLS_CIPHER_ID_AES, setup.aes_key, 256);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: AES key setup failed! mbedtls_gcm_setkey returned %d\n", ret);
+        goto exit;
+    }
+
+    cecies_encryption_setup_write_header(&setup, output);
+
+    ret = mbedtls_gcm_crypt_and_tag(&aes_ctx, MBEDTLS_GCM_ENCRYPT, data_length, setup.iv, 16, setup.ext_header_length != 0 ? output : NULL, setup.ext_header_length, data, output + setup.header_length, 16, output + setup.header_length - 16);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: AES-GCM encryption failed! mbedtls_gcm_crypt_and_tag returned %d\n", ret);
+        mbedtls_platform_zeroize(output, olen);
+        goto exit;
+    }
+
+    *output_length = olen;
+
+exit:
+
+    mbedtls_gcm_free(&aes_ctx);
+    mbedtls_platform_zeroize(&setup, sizeof(setup));
+    mbedtls_platform_zeroize(&public_key, sizeof(public_key));
+
+#if CECIES_STACK_ARENA_SIZE > 0
+    cecies_arena_pop(&arena);
+#endif
+
+    return (ret);
+}
+
+int CECIES_CURVE_FN(decrypt_to_buffer)(const uint8_t* encrypted_data, const size_t encrypted_data_length, CECIES_CURVE_KEY private_key, uint8_t* output, const size_t output_size, size_t* output_length)
+{
+    if (encrypted_data == NULL || output == NULL || output_length == NULL)
+    {
+        return CECIES_DECRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    cecies_header header;
+
+    int ret = cecies_parse_header(encrypted_data, encrypted_data_length, CECIES_CURVE_ID, &header);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    if (output_size < header.ciphertext_length)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed: output buffer too small (%zu bytes needed).\n", header.ciphertext_length);
+        return CECIES_DECRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE;
+    }
+
+#if CECIES_STACK_ARENA_SIZE > 0
+    uint8_t arena_buffer[CECIES_STACK_ARENA_SIZE];
+    cecies_arena arena;
+    cecies_arena_push(&arena, arena_buffer, sizeof(arena_buffer));
+#endif
+
+    uint8_t aes_key[32] = { 0x00 };
+
+    size_t private_key_bytes_length = 0;
+    uint8_t private_key_bytes[CECIES_CURVE_KEY_SIZE + 1] = { 0x00 };
+
+    mbedtls_gcm_context aes_ctx;
+    mbedtls_gcm_init(&aes_ctx);
+
+    ret = cecies_hexstr2bin(private_key.hexstring, CECIES_CURVE_KEY_SIZE * 2, private_key_bytes, sizeof(private_key_bytes), &private_key_bytes_length);
+    if (ret != 0 || private_key_bytes_length != CECIES_CURVE_KEY_SIZE)
+    {
+        cecies_fprintf(stderr, "CECIES: Parsing decryption private key failed! Invalid hex string format or invalid key length... cecies_hexstr2bin returned %d\n", ret);
+        ret = CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+        goto exit;
+    }
+
+    ret = CECIES_CURVE_FN(derive_header_key)(&header, private_key_bytes, aes_key);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    ret = mbedtls_gcm_setkey(&aes_ctx, MBEDTLS_CIPHER_ID_AES, aes_key, 256);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: AES key setup failed! mbedtls_gcm_setkey returned %d\n", ret);
+        goto exit;
+    }
+
+    ret = mbedtls_gcm_auth_decrypt(&aes_ctx, header.ciphertext_length, header.iv, 16, header.ext, header.ext_length, header.tag, 16, header.ciphertext, output);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed! mbedtls_gcm_auth_decrypt returned %d\n", ret);
+        goto exit;
+    }
+
+    *output_length = header.ciphertext_length;
+
+    // Inflating needs heap memory, so compressed payloads are handed out as they are, but not as if they were the plaintext.
+    // An extended header without the compressed flag means the payload is definitely not compressed; plain ciphertexts can only be sniffed.
+    if (cecies_payload_compression(&header, output, header.ciphertext_length) != CECIES_PAYLOAD_PLAIN)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption succeeded, but the payload is compressed: use the allocating decryption functions to decompress it.\n");
+        ret = CECIES_DECRYPT_ERROR_CODE_COMPRESSED;
+    }
+
+exit:
+
+    mbedtls_gcm_free(&aes_ctx);
+    mbedtls_platform_zeroize(aes_key, sizeof(aes_key));
+    mbedtls_platform_zeroize(private_key_bytes, sizeof(private_key_bytes));
+    mbedtls_platform_zeroize(&private_key, sizeof(private_key));
+
+#if CECIES_STACK_ARENA_SIZE > 0
+    cecies_arena_pop(&arena);
+#endif
+
+    return (ret);
+}
+
+int CECIES_CURVE_FN(encapsulate)(CECIES_CURVE_KEY public_key, uint8_t ephemeral_public_key[CECIES_CURVE_KEY_SIZE], uint8_t salt[CECIES_KEM_SALT_SIZE], uint8_t key[CECIES_KEM_KEY_SIZE])
+{
+    if (ephemeral_public_key == NULL || salt == NULL || key == NULL)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    // The very same setup that an encryption goes through (minus the AES-GCM pass that would use it).
+    cecies_encryption_setup setup;
+
+    const int ret = CECIES_CURVE_FN(encryption_setup_init)(public_key.hexstring, 0, &setup);
+    if (ret != 0)
+    {
+        mbedtls_platform_zeroize(ephemeral_public_key, CECIES_CURVE_KEY_SIZE);
+        mbedtls_platform_zeroize(salt, CECIES_KEM_SALT_SIZE);
+        mbedtls_platform_zeroize(key, CECIES_KEM_KEY_SIZE);
+        return (ret);
+    }
+
+    memcpy(ephemeral_public_key, setup.R, CECIES_CURVE_KEY_SIZE);
+    memcpy(salt, setup.salt, CECIES_KEM_SALT_SIZE);
+    memcpy(key, setup.aes_key, CECIES_KEM_KEY_SIZE);
+
+    mbedtls_platform_zeroize(&setup, sizeof(setup));
+    return 0;
+}
+
+int CECIES_CURVE_FN(decapsulate)(CECIES_CURVE_KEY private_key, const uint8_t ephemeral_public_key[CECIES_CURVE_KEY_SIZE], const uint8_t salt[CECIES_KEM_SALT_SIZE], uint8_t key[CECIES_KEM_KEY_SIZE])
+{
+    if (ephemeral_public_key == NULL || salt == NULL || key == NULL)
+    {
+        return CECIES_DECRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    size_t private_key_bytes_length = 0;
+    uint8_t private_key_bytes[CECIES_CURVE_KEY_SIZE + 1] = { 0x00 };
+
+    // A header without IV, tag or ciphertext: all that the key derivation looks at is R and the salt.
+    cecies_header header;
+    memset(&header, 0x00, sizeof(header));
+    header.R = ephemeral_public_key;
+    header.salt = salt;
+
+    int ret = cecies_hexstr2bin(private_key.hexstring, CECIES_CURVE_KEY_SIZE * 2, private_key_bytes, sizeof(private_key_bytes), &private_key_bytes_length);
+    if (ret != 0 || private_key_bytes_length != CECIES_CURVE_KEY_SIZE)
+    {
+        cecies_fprintf(stderr, "CECIES: Parsing decapsulation private key failed! Invalid hex string format or invalid key length... cecies_hexstr2bin returned %d\n", ret);
+        ret = CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+        goto exit;
+    }
+
+    ret = CECIES_CURVE_FN(derive_header_key)(&header, private_key_bytes, key);
+
+exit:
+
+    if (ret != 0)
+    {
+        mbedtls_platform_zeroize(key, CECIES_KEM_KEY_SIZE);
+    }
+
+    mbedtls_platform_zeroize(private_key_bytes, sizeof(private_key_bytes));
+    mbedtls_platform_zeroize(&private_key, sizeof(private_key));
+
+    return (ret);
+}
+
+#undef CECIES_CURVE_FN
+#undef CECIES_CURVE_FN_EXPAND
+#undef CECIES_CURVE_FN_
+
+#undef CECIES_CURVE
+#undef CECIES_CURVE_ID
+#undef CECIES_CURVE_KEY
+#undef CECIES_CURVE_KEY_SIZE
+#undef CECIES_CURVE_GROUP
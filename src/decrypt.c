@@ -30,136 +30,568 @@
 
 #include "cecies/util.h"
 #include "cecies/decrypt.h"
+#include "internal.h"
 
 #include "cecies/data.txt"
 
-/*
- * This avoids code duplication between the Curve25519 and Curve448 decryption variants (only key length and a few minor things differ).
- * The last "curve" argument determines which curve to use for decryption: pass 0 for Curve25519 and 1 for Curve448!
- */
-static int cecies_decrypt(const uint8_t* encrypted_data, const size_t encrypted_data_length, const int encrypted_data_base64, char* private_key, uint8_t** output, size_t* output_length, const int curve)
+int cecies_decode_input(const uint8_t* encrypted_data, const size_t encrypted_data_length, const int encrypted_data_base64, uint8_t** input, size_t* input_length)
+{
+    if (!encrypted_data_base64)
+    {
+        *input = (uint8_t*)encrypted_data;
+        *input_length = encrypted_data_length;
+        return 0;
+    }
+
+    size_t length = encrypted_data_length;
+
+    uint8_t* decoded = cecies_malloc(length);
+    if (decoded == NULL)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed: OUT OF MEMORY!\n");
+        return CECIES_DECRYPT_ERROR_CODE_OUT_OF_MEMORY;
+    }
+
+    if (encrypted_data[length - 1] == '\0')
+    {
+        length--;
+    }
+
+    int ret = mbedtls_base64_decode(decoded, length, &length, encrypted_data, length);
+    if (ret != 0)
+    {
+        cecies_free(decoded);
+        cecies_fprintf(stderr, "CECIES: decryption failed: couldn't base64-decode the given data! mbedtls_base64_decode returned %d\n", ret);
+        return CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    *input = decoded;
+    *input_length = length;
+    return 0;
+}
+
+int cecies_parse_header(const uint8_t* input, const size_t input_length, const int curve, cecies_header* header)
 {
-    const size_t min_data_len = curve == 0 ? 97 : 121;
     const size_t key_length = curve == 0 ? CECIES_X25519_KEY_SIZE : CECIES_X448_KEY_SIZE;
 
-    if (encrypted_data == NULL || output == NULL || output_length == NULL || private_key == NULL)
+    memset(header, 0x00, sizeof(cecies_header));
+
+    const uint8_t* p = input;
+    size_t remaining = input_length;
+
+    if (remaining > CECIES_EXT_HEADER_MAGIC_SIZE && memcmp(p, cecies_ext_header_magic, CECIES_EXT_HEADER_MAGIC_SIZE) == 0)
     {
-        cecies_fprintf(stderr, "CECIES: decryption failed: one or more NULL arguments.\n");
-        return CECIES_DECRYPT_ERROR_CODE_NULL_ARG;
+        const int flags = p[CECIES_EXT_HEADER_MAGIC_SIZE];
+        const size_t ext_length = cecies_calc_ext_header_length(flags);
+
+        if (ext_length == 0 || (flags & ~CECIES_HEADER_FLAGS_KNOWN) != 0)
+        {
+            cecies_fprintf(stderr, "CECIES: decryption failed: unsupported extended ciphertext header flags 0x%02x\n", flags);
+            return CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+        }
+
+        if ((flags & CECIES_HEADER_FLAG_CURVE448 ? 1 : 0) != curve)
+        {
+            cecies_fprintf(stderr, "CECIES: decryption failed: the ciphertext was encrypted using a different curve!\n");
+            return CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+        }
+
+        if (remaining < ext_length)
+        {
+            cecies_fprintf(stderr, "CECIES: decryption failed: ciphertext too short.\n");
+            return CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+        }
+
+        header->ext = p;
+        header->ext_length = ext_length;
+        header->flags = flags;
+
+        const uint8_t* field = p + CECIES_EXT_HEADER_MAGIC_SIZE + 1;
+
+        if (flags & CECIES_HEADER_FLAG_KEY_ID)
+        {
+            header->key_id = field;
+            field += CECIES_KEY_ID_SIZE;
+        }
+
+        if (flags & CECIES_HEADER_FLAG_KEY_COMMITMENT)
+        {
+            header->key_commitment = field;
+        }
+
+        p += ext_length;
+        remaining -= ext_length;
     }
 
-    if (encrypted_data_length < min_data_len)
+    if (remaining < 16 + 32 + key_length + 16 + 1)
     {
-        cecies_fprintf(stderr, "CECIES: decryption failed: one or more invalid arguments.\n");
+        cecies_fprintf(stderr, "CECIES: decryption failed: ciphertext too short.\n");
         return CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
     }
 
+    header->iv = p;
+    header->salt = p + 16;
+    header->R = p + 16 + 32;
+    header->tag = p + 16 + 32 + key_length;
+    header->ciphertext = p + 16 + 32 + key_length + 16;
+    header->ciphertext_length = remaining - 16 - 32 - key_length - 16;
+
+    return 0;
+}
+
+int cecies_seed_ctr_drbg(mbedtls_ctr_drbg_context* ctr_drbg, mbedtls_entropy_context* entropy)
+{
+    uint8_t pers[256];
+    cecies_dev_urandom(pers, 128);
+    snprintf((char*)(pers + 128), 128, "cecies_PERS_3~£,@+14/\\%llu", cecies_get_random_big_integer());
+    mbedtls_sha512(pers + 128, 128, pers + 128 + 64, 0);
+
+    const int ret = mbedtls_ctr_drbg_seed(ctr_drbg, mbedtls_entropy_func, entropy, pers, CECIES_MIN(sizeof(pers), (MBEDTLS_CTR_DRBG_MAX_SEED_INPUT - MBEDTLS_CTR_DRBG_ENTROPY_LEN - 1)));
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: MbedTLS PRNG seed failed! mbedtls_ctr_drbg_seed returned %d\n", ret);
+    }
+
+    mbedtls_platform_zeroize(pers, sizeof(pers));
+    return (ret);
+}
+
+int cecies_derive_aes_key(mbedtls_ecp_group* ecp_group, mbedtls_ctr_drbg_context* ctr_drbg, const mbedtls_mpi* dA, const mbedtls_ecp_point* R, const cecies_header* header, const size_t key_length, uint8_t aes_key[32])
+{
     int ret = 1;
-    uint8_t* input = (uint8_t*)encrypted_data;
-    size_t input_length = encrypted_data_length;
 
-    if (encrypted_data_base64)
+    uint8_t S_bytes[CECIES_X448_KEY_SIZE] = { 0x00 };
+    size_t S_bytes_length = 0;
+
+    mbedtls_ecp_point S;
+    mbedtls_ecp_point_init(&S);
+
+    ret = mbedtls_ecp_mul(ecp_group, &S, dA, R, mbedtls_ctr_drbg_random, ctr_drbg);
+    if (ret != 0)
     {
-        input = malloc(input_length);
-        if (input == NULL)
+        cecies_fprintf(stderr, "CECIES: Ephemeral public key multiplication invalid; couldn't compute AES secret! mbedtls_ecp_mul returned %d\n", ret);
+        goto exit;
+    }
+
+    ret = mbedtls_ecp_point_write_binary(ecp_group, &S, MBEDTLS_ECP_PF_UNCOMPRESSED, &S_bytes_length, S_bytes, key_length);
+    if (ret != 0 || S_bytes_length != key_length)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed! Invalid ECP point; mbedtls_ecp_point_write_binary returned %d\n", ret);
+        ret = ret != 0 ? ret : CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+        goto exit;
+    }
+
+    ret = cecies_derive_aes_key_from_secret(S_bytes, S_bytes_length, header, aes_key);
+
+exit:
+    mbedtls_ecp_point_free(&S);
+    mbedtls_platform_zeroize(S_bytes, sizeof(S_bytes));
+    return (ret);
+}
+
+int cecies_derive_aes_key_from_secret(const uint8_t* S_bytes, const size_t S_bytes_length, const cecies_header* header, uint8_t aes_key[32])
+{
+    uint8_t key_commitment[CECIES_KEY_COMMITMENT_SIZE] = { 0x00 };
+
+    int ret = cecies_derive_keys(header->salt, S_bytes, S_bytes_length, aes_key, header->key_commitment != NULL ? key_commitment : NULL);
+
+    ret = cecies_check_derived_aes_key(ret, header, aes_key, key_commitment);
+
+    mbedtls_platform_zeroize(key_commitment, sizeof(key_commitment));
+    return (ret);
+}
+
+int cecies_check_derived_aes_key(int ret, const cecies_header* header, const uint8_t aes_key[32], const uint8_t* key_commitment)
+{
+    if (ret != 0 || memcmp(aes_key, empty32, 32) == 0)
+    {
+        cecies_fprintf(stderr, "CECIES: HKDF failed! cecies_derive_keys returned %d\n", ret);
+        return ret != 0 ? ret : CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    if (header->key_commitment != NULL)
+    {
+        uint8_t diff = 0;
+        for (int i = 0; i < CECIES_KEY_COMMITMENT_SIZE; ++i)
         {
-            cecies_fprintf(stderr, "CECIES: decryption failed: OUT OF MEMORY!\n");
-            return CECIES_DECRYPT_ERROR_CODE_OUT_OF_MEMORY;
+            diff |= (uint8_t)(key_commitment[i] ^ header->key_commitment[i]);
         }
 
-        if (encrypted_data[input_length - 1] == '\0')
+        if (diff != 0)
         {
-            input_length--;
+            return CECIES_DECRYPT_ERROR_CODE_WRONG_KEY;
         }
+    }
 
-        ret = mbedtls_base64_decode(input, input_length, &input_length, encrypted_data, input_length);
-        if (ret != 0)
+    return 0;
+}
+
+int cecies_is_zlib_header(const uint8_t* data, const size_t data_length)
+{
+    if (data_length < 2 || data[0] != 0x78)
+    {
+        return 0;
+    }
+
+    switch (data[1])
+    {
+        case 0x01:
+        case 0x5E:
+        case 0x9C:
+        case 0xDA:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+int cecies_payload_compression(const cecies_header* header, const uint8_t* data, const size_t data_length)
+{
+    if (header->ext != NULL)
+    {
+        return (header->flags & CECIES_HEADER_FLAG_COMPRESSED) != 0 ? CECIES_PAYLOAD_COMPRESSED : CECIES_PAYLOAD_PLAIN;
+    }
+
+    return cecies_is_zlib_header(data, data_length) ? CECIES_PAYLOAD_MAYBE_COMPRESSED : CECIES_PAYLOAD_PLAIN;
+}
+
+int cecies_decompress_if_needed(const cecies_header* header, uint8_t** data, size_t* data_length)
+{
+    uint8_t* decrypted = *data;
+
+    const int compression = cecies_payload_compression(header, decrypted, *data_length);
+    if (compression == CECIES_PAYLOAD_PLAIN)
+    {
+        return 0;
+    }
+
+    uint8_t* tmp = NULL;
+    size_t tmplength = 0;
+
+    if (cecies_decompress(decrypted, *data_length, &tmp, &tmplength) != 0)
+    {
+        if (compression == CECIES_PAYLOAD_COMPRESSED)
         {
-            free(input);
-            cecies_fprintf(stderr, "CECIES: decryption failed: couldn't base64-decode the given data! mbedtls_base64_decode returned %d\n", ret);
-            return CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+            cecies_fprintf(stderr, "CECIES: decompression failed! The payload is flagged as compressed but doesn't inflate.\n");
+            return CECIES_DECRYPT_ERROR_CODE_DECOMPRESSION_FAILED;
         }
+
+        // If decompression fails, it still means that the decryption succeeded!
+        // Legacy ciphertexts don't say whether they're compressed: maybe the data just happens to start with a valid zlib header...
+        // So, uhh, silently succeed and output the decrypted data ;D
+        return 0;
     }
 
-    size_t olen = input_length - 16 - 32 - key_length - 16;
+    mbedtls_platform_zeroize(decrypted, *data_length);
+    cecies_free(decrypted);
+
+    *data = tmp;
+    *data_length = tmplength;
+    return 0;
+}
+
+int cecies_decrypt_payload(const cecies_header* header, const uint8_t aes_key[32], const int decompress, uint8_t** output, size_t* output_length)
+{
+    int ret = 1;
+
+    const size_t olen = header->ciphertext_length;
 
     uint8_t iv[16] = { 0x00 };
     uint8_t tag[16] = { 0x00 };
-    uint8_t salt[32] = { 0x00 };
+
+    mbedtls_gcm_context aes_ctx;
+    mbedtls_gcm_init(&aes_ctx);
+
+    memcpy(iv, header->iv, 16);
+    memcpy(tag, header->tag, 16);
+
+    uint8_t* decrypted = cecies_malloc(olen);
+    if (decrypted == NULL)
+    {
+        ret = CCRUSH_ERROR_OUT_OF_MEMORY;
+        goto exit;
+    }
+
+    const size_t gcm_thread_count = cecies_parallel_gcm_get_thread_count(olen);
+
+    if (gcm_thread_count > 1)
+    {
+        uint8_t computed_tag[16];
+
+        ret = cecies_gcm_crypt_and_tag_parallel(aes_key, MBEDTLS_GCM_DECRYPT, iv, 16, header->ext, header->ext_length, header->ciphertext, olen, decrypted, computed_tag, gcm_thread_count);
+
+        // Constant-time tag comparison.
+        uint8_t diff = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            diff |= (uint8_t)(computed_tag[i] ^ tag[i]);
+        }
+
+        if (ret == 0 && diff != 0)
+        {
+            ret = MBEDTLS_ERR_GCM_AUTH_FAILED;
+        }
+    }
+    else
+    {
+        // Only the serial path uses the MbedTLS GCM context (the parallel one sets up its own per worker thread).
+        ret = mbedtls_gcm_setkey(&aes_ctx, MBEDTLS_CIPHER_ID_AES, aes_key, 256);
+        if (ret != 0)
+        {
+            mbedtls_platform_zeroize(decrypted, olen);
+            cecies_free(decrypted);
+            cecies_fprintf(stderr, "CECIES: AES key setup failed! mbedtls_gcm_setkey returned %d\n", ret);
+            goto exit;
+        }
+
+        ret = mbedtls_gcm_auth_decrypt( //
+            &aes_ctx,                   // The MbedTLS AES context pointer.
+            olen,                       // Length of the data blob to decrypt.
+            iv,                         // Initialization vector which was extracted from the ciphertext.
+            16,                         // Length of the IV is always 16 bytes.
+            header->ext,                // The extended header (if any) is authenticated as additional data.
+            header->ext_length,         // ^
+            tag,                        // The GCM auth tag.
+            16,                         // Length of the tag.
+            header->ciphertext,         // From where to start on reading the data to decrypt (skip the ciphertext prefix of IV, Salt, Ephemeral key and auth tag).
+            decrypted                   // Where to write the decrypted data into.
+        );
+    }
+
+    if (ret != 0)
+    {
+        // Whatever GCM got to decrypt before failing is unauthenticated plaintext.
+        mbedtls_platform_zeroize(decrypted, olen);
+        cecies_free(decrypted);
+        cecies_fprintf(stderr, "CECIES: decryption failed! GCM returned %d\n", ret);
+        goto exit;
+    }
+
+    size_t decrypted_length = olen;
+
+    if (decompress)
+    {
+        ret = cecies_decompress_if_needed(header, &decrypted, &decrypted_length);
+        if (ret != 0)
+        {
+            mbedtls_platform_zeroize(decrypted, decrypted_length);
+            cecies_free(decrypted);
+            goto exit;
+        }
+    }
+
+    ret = 0;
+    *output = decrypted;
+    *output_length = decrypted_length;
+
+exit:
+
+    mbedtls_gcm_free(&aes_ctx);
+
+    mbedtls_platform_zeroize(iv, 16);
+
+    return (ret);
+}
+
+int cecies_derive_header_key(const cecies_header* header, const uint8_t* private_key, const int curve, uint8_t aes_key[32])
+{
+    return curve == 0 ? cecies_curve25519_derive_header_key(header, private_key, aes_key) : cecies_curve448_derive_header_key(header, private_key, aes_key);
+}
+
+int cecies_decrypt_header(const cecies_header* header, const uint8_t* private_key, const int curve, const int decompress, uint8_t** output, size_t* output_length)
+{
     uint8_t aes_key[32] = { 0x00 };
-    uint8_t R_bytes[64] = { 0x00 };
-    uint8_t S_bytes[64] = { 0x00 };
-    uint8_t private_key_bytes[64] = { 0x00 };
 
-    size_t private_key_bytes_length = 0, S_bytes_length = 0;
+    int ret = cecies_derive_header_key(header, private_key, curve, aes_key);
+    if (ret == 0)
+    {
+        ret = cecies_decrypt_payload(header, aes_key, decompress, output, output_length);
+    }
+
+    mbedtls_platform_zeroize(aes_key, sizeof(aes_key));
+    return (ret);
+}
+
+int cecies_verify_header(const cecies_header* header, const uint8_t* private_key, const int curve)
+{
+    uint8_t aes_key[32] = { 0x00 };
+
+    int ret = cecies_derive_header_key(header, private_key, curve, aes_key);
+    if (ret == 0)
+    {
+        ret = cecies_gcm_check_tag(aes_key, header->iv, 16, header->ext, header->ext_length, header->ciphertext, header->ciphertext_length, header->tag);
+        if (ret == 1)
+        {
+            cecies_fprintf(stderr, "CECIES: verification failed! The GCM authentication tag doesn't match.\n");
+            ret = CECIES_DECRYPT_ERROR_CODE_VERIFICATION_FAILED;
+        }
+    }
+
+    mbedtls_platform_zeroize(aes_key, sizeof(aes_key));
+    return (ret);
+}
+
+typedef struct cecies_trial_context
+{
+    const cecies_header* header;
+    const mbedtls_ecp_point* R;
+    const uint8_t* private_keys;
+    size_t private_key_stride;
+    size_t private_keys_count;
+    int curve;
+
+    cecies_mutex mutex;
+    size_t next;
+    int found;
+    size_t found_index;
+    uint8_t found_aes_key[32];
+} cecies_trial_context;
+
+/*
+ * Trial decryption worker: claims candidate keys one by one until either the matching key was found (by any worker) or the candidates ran out.
+ * Per candidate, only the ECDH, HKDF and a GHASH over the ciphertext are computed: the payload itself is decrypted later, once, with the winning key.
+ */
+static void cecies_trial_worker(void* arg)
+{
+    cecies_trial_context* ctx = (cecies_trial_context*)arg;
+
+    const cecies_header* header = ctx->header;
+    const size_t key_length = ctx->curve == 0 ? CECIES_X25519_KEY_SIZE : CECIES_X448_KEY_SIZE;
+
+    uint8_t aes_key[32] = { 0x00 };
+    uint8_t private_key_bytes[64] = { 0x00 };
+    size_t private_key_bytes_length = 0;
 
     mbedtls_ecp_group ecp_group;
-    mbedtls_gcm_context aes_ctx;
-    mbedtls_md_context_t md_ctx;
     mbedtls_entropy_context entropy;
     mbedtls_ctr_drbg_context ctr_drbg;
-
-    // Variables named after the ECIES illustration on https://asecuritysite.com/encryption/go_ecies
     mbedtls_mpi dA;
-    mbedtls_ecp_point R;
-    mbedtls_ecp_point S;
 
     mbedtls_ecp_group_init(&ecp_group);
-    mbedtls_gcm_init(&aes_ctx);
-    mbedtls_md_init(&md_ctx);
     mbedtls_entropy_init(&entropy);
     mbedtls_ctr_drbg_init(&ctr_drbg);
     mbedtls_mpi_init(&dA);
-    mbedtls_ecp_point_init(&R);
-    mbedtls_ecp_point_init(&S);
 
-    ret = mbedtls_ecp_group_load(&ecp_group, curve == 0 ? MBEDTLS_ECP_DP_CURVE25519 : MBEDTLS_ECP_DP_CURVE448);
-    if (ret != 0)
+    // The group and the PRNG are set up only once per worker, not once per candidate key.
+    if (mbedtls_ecp_group_load(&ecp_group, ctx->curve == 0 ? MBEDTLS_ECP_DP_CURVE25519 : MBEDTLS_ECP_DP_CURVE448) != 0 || cecies_seed_ctr_drbg(&ctr_drbg, &entropy) != 0)
     {
-        cecies_fprintf(stderr, "CECIES: MbedTLS ECP group setup failed! mbedtls_ecp_group_load returned %d\n", ret);
         goto exit;
     }
 
-    uint8_t pers[256];
-    cecies_dev_urandom(pers, 128);
-    snprintf((char*)(pers + 128), 128, "cecies_PERS_3~£,@+14/\\%llu", cecies_get_random_big_integer());
-    mbedtls_sha512(pers + 128, 128, pers + 128 + 64, 0);
+    for (;;)
+    {
+        size_t i;
 
-    ret = mbedtls_ctr_drbg_seed(&ctr_drbg, mbedtls_entropy_func, &entropy, pers, CECIES_MIN(sizeof(pers), (MBEDTLS_CTR_DRBG_MAX_SEED_INPUT - MBEDTLS_CTR_DRBG_ENTROPY_LEN - 1)));
-    if (ret != 0)
+        cecies_mutex_lock(&ctx->mutex);
+        const int done = ctx->found || ctx->next >= ctx->private_keys_count;
+        i = ctx->next++;
+        cecies_mutex_unlock(&ctx->mutex);
+
+        if (done)
+        {
+            break;
+        }
+
+        const char* private_key = (const char*)(ctx->private_keys + i * ctx->private_key_stride);
+
+        if (cecies_hexstr2bin(private_key, key_length * 2, private_key_bytes, sizeof(private_key_bytes), &private_key_bytes_length) != 0 || private_key_bytes_length != key_length)
+        {
+            continue;
+        }
+
+        if (mbedtls_mpi_read_binary(&dA, private_key_bytes, key_length) != 0 || mbedtls_ecp_check_privkey(&ecp_group, &dA) != 0)
+        {
+            continue;
+        }
+
+        if (cecies_derive_aes_key(&ecp_group, &ctr_drbg, &dA, ctx->R, header, key_length, aes_key) != 0)
+        {
+            continue;
+        }
+
+        if (cecies_gcm_check_tag(aes_key, header->iv, 16, header->ext, header->ext_length, header->ciphertext, header->ciphertext_length, header->tag) != 0)
+        {
+            continue;
+        }
+
+        cecies_mutex_lock(&ctx->mutex);
+        if (!ctx->found)
+        {
+            ctx->found = 1;
+            ctx->found_index = i;
+            memcpy(ctx->found_aes_key, aes_key, 32);
+        }
+        cecies_mutex_unlock(&ctx->mutex);
+        break;
+    }
+
+exit:
+    mbedtls_ecp_group_free(&ecp_group);
+    mbedtls_entropy_free(&entropy);
+    mbedtls_ctr_drbg_free(&ctr_drbg);
+    mbedtls_mpi_free(&dA);
+
+    mbedtls_platform_zeroize(aes_key, sizeof(aes_key));
+    mbedtls_platform_zeroize(private_key_bytes, sizeof(private_key_bytes));
+}
+
+static int cecies_decrypt_trial(const uint8_t* encrypted_data, const size_t encrypted_data_length, const int encrypted_data_base64, const uint8_t* private_keys, const size_t private_key_stride, const size_t private_keys_count, size_t thread_count, size_t* out_key_index, uint8_t** output, size_t* output_length, const int curve)
+{
+    const size_t min_data_len = curve == 0 ? 97 : 121;
+    const size_t key_length = curve == 0 ? CECIES_X25519_KEY_SIZE : CECIES_X448_KEY_SIZE;
+
+    if (encrypted_data == NULL || private_keys == NULL || out_key_index == NULL || output == NULL || output_length == NULL)
     {
-        cecies_fprintf(stderr, "CECIES: MbedTLS PRNG seed failed! mbedtls_ctr_drbg_seed returned %d\n", ret);
-        goto exit;
+        cecies_fprintf(stderr, "CECIES: trial decryption failed: one or more NULL arguments.\n");
+        return CECIES_DECRYPT_ERROR_CODE_NULL_ARG;
     }
 
-    memcpy(iv, input, 16);
-    memcpy(salt, input + 16, 32);
-    memcpy(R_bytes, input + 16 + 32, key_length);
-    memcpy(tag, input + 16 + 32 + key_length, 16);
+    if (encrypted_data_length < min_data_len || private_keys_count == 0)
+    {
+        cecies_fprintf(stderr, "CECIES: trial decryption failed: one or more invalid arguments.\n");
+        return CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+    }
 
-    ret = cecies_hexstr2bin(private_key, key_length * 2, private_key_bytes, sizeof(private_key_bytes), &private_key_bytes_length);
-    if (ret != 0 || private_key_bytes_length != key_length)
+    int ret = 1;
+    uint8_t* input = NULL;
+    size_t input_length = 0;
+
+    cecies_header header;
+    cecies_trial_context ctx;
+    cecies_thread* threads = NULL;
+    size_t threads_started = 0;
+
+    mbedtls_ecp_group ecp_group;
+    mbedtls_ecp_point R;
+
+    mbedtls_ecp_group_init(&ecp_group);
+    mbedtls_ecp_point_init(&R);
+
+    memset(&ctx, 0x00, sizeof(ctx));
+    cecies_mutex_init(&ctx.mutex);
+
+    ret = cecies_decode_input(encrypted_data, encrypted_data_length, encrypted_data_base64, &input, &input_length);
+    if (ret != 0)
     {
-        cecies_fprintf(stderr, "CECIES: Parsing decryption private key failed! Invalid hex string format or invalid key length... cecies_hexstr2bin returned %d\n", ret);
-        ret = CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+        input = NULL;
         goto exit;
     }
 
-    ret = mbedtls_mpi_read_binary(&dA, private_key_bytes, private_key_bytes_length);
+    ret = cecies_parse_header(input, input_length, curve, &header);
     if (ret != 0)
     {
-        cecies_fprintf(stderr, "CECIES: Parsing decryption private key failed! mbedtls_mpi_read_binary returned %d\n", ret);
         goto exit;
     }
 
-    ret = mbedtls_ecp_check_privkey(&ecp_group, &dA);
+    // The ephemeral public key R is parsed and validated only once for all candidates.
+    ret = mbedtls_ecp_group_load(&ecp_group, curve == 0 ? MBEDTLS_ECP_DP_CURVE25519 : MBEDTLS_ECP_DP_CURVE448);
     if (ret != 0)
     {
-        cecies_fprintf(stderr, "CECIES: Invalid decryption private key! mbedtls_ecp_check_privkey returned %d\n", ret);
+        cecies_fprintf(stderr, "CECIES: MbedTLS ECP group setup failed! mbedtls_ecp_group_load returned %d\n", ret);
         goto exit;
     }
 
-    ret = mbedtls_ecp_point_read_binary(&ecp_group, &R, R_bytes, key_length);
+    ret = mbedtls_ecp_point_read_binary(&ecp_group, &R, header.R, key_length);
     if (ret != 0)
     {
         cecies_fprintf(stderr, "CECIES: Parsing ephemeral public key failed! mbedtls_ecp_point_read_binary returned %d\n", ret);
@@ -173,130 +605,143 @@ static int cecies_decrypt(const uint8_t* encrypted_data, const size_t encrypted_
         goto exit;
     }
 
-    ret = mbedtls_ecp_mul(&ecp_group, &S, &dA, &R, mbedtls_ctr_drbg_random, &ctr_drbg);
-    if (ret != 0)
+    ctx.header = &header;
+    ctx.R = &R;
+    ctx.private_keys = private_keys;
+    ctx.private_key_stride = private_key_stride;
+    ctx.private_keys_count = private_keys_count;
+    ctx.curve = curve;
+
+    if (thread_count == 0)
     {
-        cecies_fprintf(stderr, "CECIES: Ephemeral public key multiplication invalid; couldn't compute AES secret! mbedtls_ecp_mul returned %d\n", ret);
-        goto exit;
+        thread_count = cecies_get_cpu_count();
     }
 
-    ret = mbedtls_ecp_point_write_binary(&ecp_group, &S, MBEDTLS_ECP_PF_UNCOMPRESSED, &S_bytes_length, S_bytes, key_length);
-    if (ret != 0 || S_bytes_length != key_length)
+    thread_count = CECIES_MIN(thread_count, private_keys_count);
+
+    if (thread_count > 1)
     {
-        cecies_fprintf(stderr, "CECIES: decryption failed! Invalid ECP point; mbedtls_ecp_point_write_binary returned %d\n", ret);
-        goto exit;
+        threads = cecies_malloc((thread_count - 1) * sizeof(cecies_thread));
+        if (threads == NULL)
+        {
+            ret = CECIES_DECRYPT_ERROR_CODE_OUT_OF_MEMORY;
+            goto exit;
+        }
+
+        for (; threads_started < thread_count - 1; ++threads_started)
+        {
+            if (cecies_thread_create(&threads[threads_started], cecies_trial_worker, &ctx) != 0)
+            {
+                break; // Just continue with the threads we've got.
+            }
+        }
     }
 
-    ret = mbedtls_md_setup(&md_ctx, mbedtls_md_info_from_type(MBEDTLS_MD_SHA512), 1);
-    if (ret != 0)
+    // The calling thread participates too.
+    cecies_trial_worker(&ctx);
+
+    for (size_t i = 0; i < threads_started; ++i)
     {
-        cecies_fprintf(stderr, "CECIES: MbedTLS MD context (SHA512) setup failed! mbedtls_md_setup returned %d\n", ret);
-        goto exit;
+        cecies_thread_join(threads[i]);
     }
 
-    ret = mbedtls_hkdf(mbedtls_md_info_from_type(MBEDTLS_MD_SHA512), salt, 32, S_bytes, S_bytes_length, NULL, 0, aes_key, 32);
-    if (ret != 0 || memcmp(aes_key, empty32, 32) == 0)
+    if (!ctx.found)
     {
-        cecies_fprintf(stderr, "CECIES: HKDF failed! mbedtls_hkdf returned %d\n", ret);
+        ret = CECIES_DECRYPT_ERROR_CODE_KEY_NOT_FOUND;
         goto exit;
     }
 
-    ret = mbedtls_gcm_setkey(&aes_ctx, MBEDTLS_CIPHER_ID_AES, aes_key, 256);
-    if (ret != 0)
+    ret = cecies_decrypt_payload(&header, ctx.found_aes_key, 1, output, output_length);
+    if (ret == 0)
     {
-        cecies_fprintf(stderr, "CECIES: AES key setup failed! mbedtls_gcm_setkey returned %d\n", ret);
-        goto exit;
+        *out_key_index = ctx.found_index;
     }
 
-    uint8_t* decrypted = malloc(olen);
-    if (decrypted == NULL)
+exit:
+
+    mbedtls_ecp_group_free(&ecp_group);
+    mbedtls_ecp_point_free(&R);
+
+    cecies_mutex_free(&ctx.mutex);
+    mbedtls_platform_zeroize(ctx.found_aes_key, sizeof(ctx.found_aes_key));
+
+    cecies_free(threads);
+
+    if (encrypted_data_base64)
     {
-        ret = CCRUSH_ERROR_OUT_OF_MEMORY;
-        goto exit;
+        cecies_free(input);
+    }
+
+    return (ret);
+}
+
+/*
+ * This avoids code duplication between the Curve25519 and Curve448 decryption variants (only key length and a few minor things differ).
+ * The last "curve" argument determines which curve to use for decryption: pass 0 for Curve25519 and 1 for Curve448!
+ */
+int cecies_decrypt(const uint8_t* encrypted_data, const size_t encrypted_data_length, const int encrypted_data_base64, char* private_key, uint8_t** output, size_t* output_length, const int curve, const int mode, int* compression)
+{
+    const size_t min_data_len = curve == 0 ? 97 : 121;
+    const size_t key_length = curve == 0 ? CECIES_X25519_KEY_SIZE : CECIES_X448_KEY_SIZE;
+
+    const int verify_only = mode == CECIES_DECRYPT_MODE_VERIFY;
+
+    if (encrypted_data == NULL || (!verify_only && (output == NULL || output_length == NULL)) || private_key == NULL)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed: one or more NULL arguments.\n");
+        return CECIES_DECRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    if (encrypted_data_length < min_data_len)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed: one or more invalid arguments.\n");
+        return CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
     }
 
-    ret = mbedtls_gcm_auth_decrypt(          //
-        &aes_ctx,                            // The MbedTLS AES context pointer.
-        olen,                                // Length of the data blob to decrypt.
-        iv,                                  // Initialization vector which was extracted from the ciphertext.
-        16,                                  // Length of the IV is always 16 bytes.
-        NULL,                                // No additional data.
-        0,                                   // ^
-        tag,                                 // The GCM auth tag.
-        16,                                  // Length of the tag.
-        input + (16 + 32 + key_length + 16), // From where to start on reading the data to decrypt (skip the ciphertext prefix of IV, Salt, Ephemeral key and auth tag).
-        decrypted                            // Where to write the decrypted data into.
-    );
+    int ret = 1;
+    uint8_t* input = NULL;
+    size_t input_length = 0;
+
+    uint8_t private_key_bytes[64] = { 0x00 };
+    size_t private_key_bytes_length = 0;
+
+    cecies_header header;
 
+    ret = cecies_decode_input(encrypted_data, encrypted_data_length, encrypted_data_base64, &input, &input_length);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    ret = cecies_parse_header(input, input_length, curve, &header);
     if (ret != 0)
     {
-        free(decrypted);
-        cecies_fprintf(stderr, "CECIES: decryption failed! mbedtls_gcm_auth_decrypt returned %d\n", ret);
         goto exit;
     }
 
-    if (*decrypted == 0x78)
+    ret = cecies_hexstr2bin(private_key, key_length * 2, private_key_bytes, sizeof(private_key_bytes), &private_key_bytes_length);
+    if (ret != 0 || private_key_bytes_length != key_length)
     {
-        switch (decrypted[1])
-        {
-            case 0x01:
-            case 0x5E:
-            case 0x9C:
-            case 0xDA: // Zlib header detected
-            {
-                uint8_t* tmp = NULL;
-                size_t tmplength = 0;
-
-                ret = ccrush_decompress(decrypted, olen, 256, &tmp, &tmplength);
-                if (ret != 0)
-                {
-                    // If decompression fails, it still means that the decryption succeeded!
-                    // In this case, maybe the data just happens to start with a valid zlib header...
-                    // So, uhh, silently succeed and output the decrypted data ;D
-                    break;
-                }
-
-                mbedtls_platform_zeroize(decrypted, olen);
-                free(decrypted);
-
-                ret = 0;
-                *output = tmp;
-                *output_length = tmplength;
-
-                goto exit;
-            }
-            default: {
-                break;
-            }
-        }
+        cecies_fprintf(stderr, "CECIES: Parsing decryption private key failed! Invalid hex string format or invalid key length... cecies_hexstr2bin returned %d\n", ret);
+        ret = CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+        goto exit;
     }
 
-    ret = 0;
-    *output = decrypted;
-    *output_length = olen;
+    ret = verify_only ? cecies_verify_header(&header, private_key_bytes, curve) : cecies_decrypt_header(&header, private_key_bytes, curve, mode != CECIES_DECRYPT_MODE_RAW, output, output_length);
 
-exit:
+    if (ret == 0 && mode == CECIES_DECRYPT_MODE_RAW && compression != NULL)
+    {
+        *compression = cecies_payload_compression(&header, *output, *output_length);
+    }
 
-    mbedtls_ecp_group_free(&ecp_group);
-    mbedtls_gcm_free(&aes_ctx);
-    mbedtls_md_free(&md_ctx);
-    mbedtls_entropy_free(&entropy);
-    mbedtls_ctr_drbg_free(&ctr_drbg);
-    mbedtls_mpi_free(&dA);
-    mbedtls_ecp_point_free(&R);
-    mbedtls_ecp_point_free(&S);
+exit:
 
-    mbedtls_platform_zeroize(iv, 16);
-    mbedtls_platform_zeroize(salt, 32);
-    mbedtls_platform_zeroize(aes_key, 32);
-    mbedtls_platform_zeroize(R_bytes, sizeof(R_bytes));
-    mbedtls_platform_zeroize(S_bytes, sizeof(S_bytes));
     mbedtls_platform_zeroize(&private_key, sizeof(private_key));
     mbedtls_platform_zeroize(private_key_bytes, sizeof(private_key_bytes));
 
     if (encrypted_data_base64)
     {
-        free(input);
+        cecies_free(input);
     }
 
     return (ret);
@@ -304,10 +749,30 @@ exit:
 
 int cecies_curve25519_decrypt(const uint8_t* encrypted_data, const size_t encrypted_data_length, const int encrypted_data_base64, cecies_curve25519_key private_key, uint8_t** output, size_t* output_length)
 {
-    return cecies_decrypt(encrypted_data, encrypted_data_length, encrypted_data_base64, private_key.hexstring, output, output_length, 0);
+    return cecies_decrypt(encrypted_data, encrypted_data_length, encrypted_data_base64, private_key.hexstring, output, output_length, 0, CECIES_DECRYPT_MODE_DECRYPT, NULL);
 }
 
 int cecies_curve448_decrypt(const uint8_t* encrypted_data, const size_t encrypted_data_length, const int encrypted_data_base64, cecies_curve448_key private_key, uint8_t** output, size_t* output_length)
 {
-    return cecies_decrypt(encrypted_data, encrypted_data_length, encrypted_data_base64, private_key.hexstring, output, output_length, 1);
-}
\ No newline at end of file
+    return cecies_decrypt(encrypted_data, encrypted_data_length, encrypted_data_base64, private_key.hexstring, output, output_length, 1, CECIES_DECRYPT_MODE_DECRYPT, NULL);
+}
+
+int cecies_curve25519_decrypt_trial(const uint8_t* encrypted_data, const size_t encrypted_data_length, const int encrypted_data_base64, const cecies_curve25519_key* private_keys, const size_t private_keys_count, const size_t thread_count, size_t* out_key_index, uint8_t** output, size_t* output_length)
+{
+    return cecies_decrypt_trial(encrypted_data, encrypted_data_length, encrypted_data_base64, (const uint8_t*)private_keys, sizeof(cecies_curve25519_key), private_keys_count, thread_count, out_key_index, output, output_length, 0);
+}
+
+int cecies_curve448_decrypt_trial(const uint8_t* encrypted_data, const size_t encrypted_data_length, const int encrypted_data_base64, const cecies_curve448_key* private_keys, const size_t private_keys_count, const size_t thread_count, size_t* out_key_index, uint8_t** output, size_t* output_length)
+{
+    return cecies_decrypt_trial(encrypted_data, encrypted_data_length, encrypted_data_base64, (const uint8_t*)private_keys, sizeof(cecies_curve448_key), private_keys_count, thread_count, out_key_index, output, output_length, 1);
+}
+
+int cecies_curve25519_verify(const uint8_t* encrypted_data, const size_t encrypted_data_length, const int encrypted_data_base64, cecies_curve25519_key private_key)
+{
+    return cecies_decrypt(encrypted_data, encrypted_data_length, encrypted_data_base64, private_key.hexstring, NULL, NULL, 0, CECIES_DECRYPT_MODE_VERIFY, NULL);
+}
+
+int cecies_curve448_verify(const uint8_t* encrypted_data, const size_t encrypted_data_length, const int encrypted_data_base64, cecies_curve448_key private_key)
+{
+    return cecies_decrypt(encrypted_data, encrypted_data_length, encrypted_data_base64, private_key.hexstring, NULL, NULL, 1, CECIES_DECRYPT_MODE_VERIFY, NULL);
+}
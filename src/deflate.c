@@ -0,0 +1,1012 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <ccrush.h>
+#include <mbedtls/platform_util.h>
+
+#include "cecies/util.h"
+#include "internal.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__SSE2__)
+#define CECIES_DEFLATE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/*
+ * One-shot raw deflate (RFC 1951) for the blocks of cecies_compress(): the whole input (and the dictionary in front of it) is in memory,
+ * so there's no sliding window to maintain and matches are searched for directly in the input.
+ *
+ * The match finder follows zlib's: hash chains over 3-byte strings with the same per-level chain lengths and lazy matching parameters,
+ * so compression ratios stay where zlib has them. What's different is how candidates are compared: 16 bytes at a time with SSE2 (8 with scalar 64-bit words elsewhere),
+ * after rejecting most candidates by the byte that would have to extend the best match so far.
+ * Every block is emitted as whichever of stored, fixed Huffman or dynamic Huffman comes out the smallest.
+ */
+
+#define CECIES_DEFLATE_MIN_MATCH 3
+#define CECIES_DEFLATE_MAX_MATCH 258
+#define CECIES_DEFLATE_MAX_DISTANCE 32768
+
+#define CECIES_DEFLATE_WINDOW_MASK (CECIES_DEFLATE_MAX_DISTANCE - 1)
+
+#define CECIES_DEFLATE_HASH_BITS 15
+#define CECIES_DEFLATE_HASH_SIZE (1 << CECIES_DEFLATE_HASH_BITS)
+
+/* Empty hash chain. Positions are 32-bit, which is why cecies_deflate_raw() refuses inputs (plus dictionary) of 4 GiB and more. */
+#define CECIES_DEFLATE_NIL UINT32_MAX
+
+/* Symbols (literals and matches) per block: the same as zlib's lit_bufsize with memLevel 8. */
+#define CECIES_DEFLATE_BLOCK_SYMBOLS 16384
+
+/* Length 3 matches that are further away than this are not worth it (zlib's TOO_FAR). */
+#define CECIES_DEFLATE_TOO_FAR 4096
+
+#define CECIES_DEFLATE_MAX_BITS 15
+#define CECIES_DEFLATE_MAX_CODELEN_BITS 7
+
+#define CECIES_DEFLATE_LITLEN_CODES 286
+#define CECIES_DEFLATE_DIST_CODES 30
+#define CECIES_DEFLATE_CODELEN_CODES 19
+
+#define CECIES_DEFLATE_END_OF_BLOCK 256
+
+#define CECIES_DEFLATE_STORED_MAX 65535
+
+typedef struct cecies_deflate_config
+{
+    /* Reduce the chain length to a quarter once the previous match is at least this long. */
+    unsigned int good_length;
+
+    /* Lazy levels: don't look for a better match once the previous one is at least this long. Greedy levels: the longest match whose positions are all hashed. */
+    unsigned int lazy_length;
+
+    /* Stop searching once a match is at least this long. */
+    unsigned int nice_length;
+
+    unsigned int max_chain;
+    int lazy;
+} cecies_deflate_config;
+
+/* zlib's configuration_table (levels 1 to 9). */
+static const cecies_deflate_config cecies_deflate_configs[10] = {
+    { 0, 0, 0, 0, 0 }, //
+    { 4, 4, 8, 4, 0 }, //
+    { 4, 5, 16, 8, 0 }, //
+    { 4, 6, 32, 32, 0 }, //
+    { 4, 4, 16, 16, 1 }, //
+    { 8, 16, 32, 32, 1 }, //
+    { 8, 16, 128, 128, 1 }, //
+    { 8, 32, 128, 256, 1 }, //
+    { 32, 128, 258, 1024, 1 }, //
+    { 32, 258, 258, 4096, 1 }, //
+};
+
+static const uint16_t cecies_deflate_length_base[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t cecies_deflate_length_extra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+static const uint16_t cecies_deflate_dist_base[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const uint8_t cecies_deflate_dist_extra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+static const uint8_t cecies_deflate_codelen_order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+static const uint8_t cecies_deflate_codelen_extra[19] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 3, 7 };
+
+typedef struct cecies_deflate_huffman
+{
+    uint8_t lengths[CECIES_DEFLATE_LITLEN_CODES + 2];
+
+    /* Bit-reversed codewords, ready to be written least significant bit first. */
+    uint16_t codes[CECIES_DEFLATE_LITLEN_CODES + 2];
+} cecies_deflate_huffman;
+
+typedef struct cecies_deflate_state
+{
+    const uint8_t* base;
+    size_t end;
+    cecies_deflate_config config;
+
+    /* The latest position of every hash, and for every position in the window how far back the previous one with the same hash is (0: none, or too far). */
+    uint32_t head[CECIES_DEFLATE_HASH_SIZE];
+    uint16_t prev[CECIES_DEFLATE_MAX_DISTANCE];
+
+    /* The current block's symbols: distance 0 means a literal (in lengths_or_literals), otherwise it's a match of length lengths_or_literals + 3. */
+    uint16_t distances[CECIES_DEFLATE_BLOCK_SYMBOLS];
+    uint8_t lengths_or_literals[CECIES_DEFLATE_BLOCK_SYMBOLS];
+    size_t symbols;
+
+    /* Where the current block's input starts, and where it ends so far. */
+    size_t block_start;
+    size_t block_end;
+
+    uint32_t litlen_freqs[CECIES_DEFLATE_LITLEN_CODES + 2];
+    uint32_t dist_freqs[CECIES_DEFLATE_DIST_CODES + 2];
+
+    uint8_t length_codes[256];
+    uint8_t dist_codes[512];
+
+    cecies_deflate_huffman fixed_litlen;
+    cecies_deflate_huffman fixed_dist;
+
+    uint8_t* output;
+    size_t output_size;
+    size_t output_length;
+
+    uint64_t bit_buffer;
+    unsigned int bit_count;
+} cecies_deflate_state;
+
+size_t cecies_deflate_bound(const size_t length)
+{
+    // Every block is at most as big as storing it would be: that's 5 bytes of overhead per 64 KiB, plus alignment and the end-of-block markers
+    // of blocks (of at least 16 KiB each, because of the symbol buffer size) that were cut short.
+    return length + (length >> 10) + 64;
+}
+
+static inline uint32_t cecies_deflate_hash(const uint8_t* p)
+{
+    const uint32_t bytes = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16);
+    return (bytes * 0x9E3779B1u) >> (32 - CECIES_DEFLATE_HASH_BITS);
+}
+
+/*
+ * Hashes the string at position and returns the previous head of its hash chain (the first candidate for a match).
+ */
+static inline uint32_t cecies_deflate_insert(cecies_deflate_state* state, const size_t position)
+{
+    const uint32_t hash = cecies_deflate_hash(state->base + position);
+    const uint32_t candidate = state->head[hash];
+
+    state->prev[position & CECIES_DEFLATE_WINDOW_MASK] = (uint16_t)(candidate < position && position - candidate <= CECIES_DEFLATE_MAX_DISTANCE ? position - candidate : 0);
+    state->head[hash] = (uint32_t)position;
+
+    return candidate;
+}
+
+static inline uint16_t cecies_deflate_load16(const uint8_t* p)
+{
+    uint16_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+/*
+ * How many of the first max bytes of a and b are equal.
+ */
+static inline size_t cecies_deflate_match_length(const uint8_t* a, const uint8_t* b, const size_t max)
+{
+    size_t length = 0;
+
+#ifdef CECIES_DEFLATE_SSE2
+    while (max - length >= 16)
+    {
+        const __m128i equal = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + length)), _mm_loadu_si128((const __m128i*)(b + length)));
+        const unsigned int mask = (unsigned int)_mm_movemask_epi8(equal) ^ 0xFFFF;
+
+        if (mask != 0)
+        {
+            return length + (size_t)__builtin_ctz(mask);
+        }
+
+        length += 16;
+    }
+#endif
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (max - length >= 8)
+    {
+        uint64_t x, y;
+        memcpy(&x, a + length, 8);
+        memcpy(&y, b + length, 8);
+
+        if (x != y)
+        {
+            return length + (size_t)(__builtin_ctzll(x ^ y) >> 3);
+        }
+
+        length += 8;
+    }
+#endif
+
+    while (length < max && a[length] == b[length])
+    {
+        ++length;
+    }
+
+    return length;
+}
+
+/*
+ * Walks the hash chain starting at candidate for a match longer than best_length at position. Returns the length of the best match found (or best_length if there's none).
+ */
+static inline size_t cecies_deflate_longest_match(const cecies_deflate_state* state, const size_t position, uint32_t candidate, size_t best_length, unsigned int chain, size_t* distance)
+{
+    const size_t max_length = CECIES_MIN(CECIES_DEFLATE_MAX_MATCH, state->end - position);
+    if (best_length >= max_length)
+    {
+        return best_length;
+    }
+
+    const size_t nice_length = CECIES_MIN(state->config.nice_length, max_length);
+    const size_t limit = position > CECIES_DEFLATE_MAX_DISTANCE ? position - CECIES_DEFLATE_MAX_DISTANCE : 0;
+    const uint8_t* scan = state->base + position;
+
+    const uint16_t scan_start = cecies_deflate_load16(scan);
+    uint16_t scan_end = cecies_deflate_load16(scan + best_length - 1);
+
+    // A link that was overwritten by a newer string (one window further) leads somewhere arbitrary, but that's always out of the window already (or wraps around below 0).
+    while (candidate >= limit && candidate < position && chain-- > 0)
+    {
+        const uint8_t* match = state->base + candidate;
+
+        // Only a match that ends like the best one so far (plus one more byte) can be longer, and hash collisions mostly differ right at the start.
+        if (cecies_deflate_load16(match + best_length - 1) == scan_end && cecies_deflate_load16(match) == scan_start)
+        {
+            const size_t length = cecies_deflate_match_length(match, scan, max_length);
+
+            if (length > best_length)
+            {
+                best_length = length;
+                *distance = position - candidate;
+
+                if (length >= nice_length)
+                {
+                    break;
+                }
+
+                scan_end = cecies_deflate_load16(scan + best_length - 1);
+            }
+        }
+
+        const uint32_t delta = state->prev[candidate & CECIES_DEFLATE_WINDOW_MASK];
+        if (delta == 0)
+        {
+            break;
+        }
+
+        candidate -= delta;
+    }
+
+    return best_length;
+}
+
+static inline void cecies_deflate_put_bits(cecies_deflate_state* state, const uint32_t bits, const unsigned int count)
+{
+    state->bit_buffer |= (uint64_t)bits << state->bit_count;
+    state->bit_count += count;
+
+    if (state->bit_count >= 32)
+    {
+        uint8_t* out = state->output + state->output_length;
+        out[0] = (uint8_t)state->bit_buffer;
+        out[1] = (uint8_t)(state->bit_buffer >> 8);
+        out[2] = (uint8_t)(state->bit_buffer >> 16);
+        out[3] = (uint8_t)(state->bit_buffer >> 24);
+
+        state->output_length += 4;
+        state->bit_buffer >>= 32;
+        state->bit_count -= 32;
+    }
+}
+
+/*
+ * Pads the output with zero bits up to the next byte boundary and writes out everything that's still in the bit buffer.
+ */
+static void cecies_deflate_align(cecies_deflate_state* state)
+{
+    while (state->bit_count > 0)
+    {
+        state->output[state->output_length++] = (uint8_t)state->bit_buffer;
+        state->bit_buffer >>= 8;
+        state->bit_count = state->bit_count > 8 ? state->bit_count - 8 : 0;
+    }
+
+    state->bit_buffer = 0;
+}
+
+/*
+ * Bit-reversed canonical codewords for the given code lengths.
+ */
+static void cecies_deflate_assign_codes(cecies_deflate_huffman* huffman, const unsigned int n)
+{
+    unsigned int count[CECIES_DEFLATE_MAX_BITS + 1] = { 0 };
+    uint32_t next_code[CECIES_DEFLATE_MAX_BITS + 1];
+
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        ++count[huffman->lengths[i]];
+    }
+
+    count[0] = 0;
+
+    uint32_t code = 0;
+    for (unsigned int length = 1; length <= CECIES_DEFLATE_MAX_BITS; ++length)
+    {
+        code = (code + count[length - 1]) << 1;
+        next_code[length] = code;
+    }
+
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        const unsigned int length = huffman->lengths[i];
+        if (length == 0)
+        {
+            huffman->codes[i] = 0;
+            continue;
+        }
+
+        const uint32_t codeword = next_code[length]++;
+
+        uint32_t reversed = 0;
+        for (unsigned int b = 0; b < length; ++b)
+        {
+            reversed |= ((codeword >> b) & 1) << (length - 1 - b);
+        }
+
+        huffman->codes[i] = (uint16_t)reversed;
+    }
+}
+
+typedef struct cecies_deflate_leaf
+{
+    uint32_t freq;
+    uint16_t symbol;
+} cecies_deflate_leaf;
+
+static int cecies_deflate_compare_leaves(const void* a, const void* b)
+{
+    const cecies_deflate_leaf* x = (const cecies_deflate_leaf*)a;
+    const cecies_deflate_leaf* y = (const cecies_deflate_leaf*)b;
+
+    if (x->freq != y->freq)
+    {
+        return x->freq < y->freq ? -1 : 1;
+    }
+
+    return x->symbol < y->symbol ? -1 : x->symbol > y->symbol;
+}
+
+/*
+ * Huffman code lengths of at most max_bits for the given symbol frequencies (plus the codewords themselves).
+ * Codes always get at least two codewords, just like zlib makes them: a code of a single one-bit codeword is incomplete, which not every inflater accepts.
+ * Lengths that end up too long are fixed up the way zlib's gen_bitlen() does it.
+ */
+static void cecies_deflate_build_huffman(cecies_deflate_huffman* huffman, const uint32_t* freqs, const unsigned int n, const unsigned int max_bits)
+{
+    cecies_deflate_leaf leaves[CECIES_DEFLATE_LITLEN_CODES];
+    uint32_t weights[2 * CECIES_DEFLATE_LITLEN_CODES];
+    uint16_t parents[2 * CECIES_DEFLATE_LITLEN_CODES];
+    uint8_t depths[2 * CECIES_DEFLATE_LITLEN_CODES];
+    unsigned int bl_count[CECIES_DEFLATE_MAX_BITS + 1] = { 0 };
+
+    memset(huffman->lengths, 0x00, sizeof(huffman->lengths));
+
+    unsigned int leaves_count = 0;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        if (freqs[i] != 0)
+        {
+            leaves[leaves_count].freq = freqs[i];
+            leaves[leaves_count].symbol = (uint16_t)i;
+            ++leaves_count;
+        }
+    }
+
+    if (leaves_count < 2)
+    {
+        // One (or no) symbol: two one-bit codewords, the second one for a symbol that's never used.
+        const unsigned int used = leaves_count == 1 ? leaves[0].symbol : 0;
+        huffman->lengths[used] = 1;
+        huffman->lengths[used == 0 ? 1 : 0] = 1;
+        cecies_deflate_assign_codes(huffman, n);
+        return;
+    }
+
+    qsort(leaves, leaves_count, sizeof(cecies_deflate_leaf), cecies_deflate_compare_leaves);
+
+    // Two-queue Huffman construction: leaves are 0..leaves_count-1 (sorted by frequency), internal nodes are created in order of increasing weight after that.
+    for (unsigned int i = 0; i < leaves_count; ++i)
+    {
+        weights[i] = leaves[i].freq;
+    }
+
+    unsigned int next_leaf = 0;
+    unsigned int next_node = leaves_count;
+    const unsigned int nodes_count = 2 * leaves_count - 1;
+
+    for (unsigned int node = leaves_count; node < nodes_count; ++node)
+    {
+        unsigned int children[2];
+
+        for (int c = 0; c < 2; ++c)
+        {
+            if (next_leaf < leaves_count && (next_node >= node || weights[next_leaf] <= weights[next_node]))
+            {
+                children[c] = next_leaf++;
+            }
+            else
+            {
+                children[c] = next_node++;
+            }
+        }
+
+        weights[node] = weights[children[0]] + weights[children[1]];
+        parents[children[0]] = (uint16_t)node;
+        parents[children[1]] = (uint16_t)node;
+    }
+
+    // Depths from the root down (parents always come after their children).
+    unsigned int overflow = 0;
+    depths[nodes_count - 1] = 0;
+
+    for (unsigned int node = nodes_count - 1; node-- > 0;)
+    {
+        const unsigned int depth = depths[parents[node]] + 1u;
+        depths[node] = (uint8_t)CECIES_MIN(depth, 255u);
+
+        // Just like in zlib, internal nodes count towards the overflow too: that makes it exactly twice the number of steps needed to fix the lengths up below.
+        if (depth > max_bits)
+        {
+            ++overflow;
+        }
+
+        if (node < leaves_count)
+        {
+            ++bl_count[CECIES_MIN(depth, max_bits)];
+        }
+    }
+
+    // Each step moves a leaf one level down (next to a clamped one), which takes away as much of the code space overflow as one clamped leaf had added (see zlib's gen_bitlen()).
+    while (overflow > 0)
+    {
+        unsigned int bits = max_bits - 1;
+        while (bl_count[bits] == 0)
+        {
+            --bits;
+        }
+
+        --bl_count[bits];
+        bl_count[bits + 1] += 2;
+        --bl_count[max_bits];
+        overflow = overflow > 2 ? overflow - 2 : 0;
+    }
+
+    // The least frequent symbols get the longest codewords.
+    unsigned int leaf = 0;
+    for (unsigned int bits = max_bits; bits > 0; --bits)
+    {
+        for (unsigned int i = bl_count[bits]; i > 0; --i)
+        {
+            huffman->lengths[leaves[leaf++].symbol] = (uint8_t)bits;
+        }
+    }
+
+    cecies_deflate_assign_codes(huffman, n);
+}
+
+static inline unsigned int cecies_deflate_dist_code(const cecies_deflate_state* state, const unsigned int distance)
+{
+    return distance <= 256 ? state->dist_codes[distance - 1] : state->dist_codes[256 + ((distance - 1) >> 7)];
+}
+
+/*
+ * Run-length encodes the concatenated literal/length and distance code lengths with the code length alphabet (symbols 16, 17 and 18 repeat).
+ * Returns the number of code length symbols; their repeat counts go into extras.
+ */
+static unsigned int cecies_deflate_encode_lengths(const uint8_t* lengths, const unsigned int n, uint8_t* symbols, uint8_t* extras)
+{
+    unsigned int count = 0;
+
+    for (unsigned int i = 0; i < n;)
+    {
+        const uint8_t value = lengths[i];
+
+        unsigned int run = 1;
+        while (i + run < n && lengths[i + run] == value)
+        {
+            ++run;
+        }
+
+        i += run;
+
+        if (value == 0)
+        {
+            while (run >= 11)
+            {
+                const unsigned int repeat = CECIES_MIN(run, 138u);
+                symbols[count] = 18;
+                extras[count++] = (uint8_t)(repeat - 11);
+                run -= repeat;
+            }
+
+            if (run >= 3)
+            {
+                symbols[count] = 17;
+                extras[count++] = (uint8_t)(run - 3);
+                run = 0;
+            }
+        }
+        else
+        {
+            symbols[count] = value;
+            extras[count++] = 0;
+            --run;
+
+            while (run >= 3)
+            {
+                const unsigned int repeat = CECIES_MIN(run, 6u);
+                symbols[count] = 16;
+                extras[count++] = (uint8_t)(repeat - 3);
+                run -= repeat;
+            }
+        }
+
+        while (run > 0)
+        {
+            symbols[count] = value;
+            extras[count++] = 0;
+            --run;
+        }
+    }
+
+    return count;
+}
+
+/*
+ * Size in bits of the current block's symbols (and their end of block) with the given codes, extra bits included.
+ */
+static uint64_t cecies_deflate_symbols_cost(const cecies_deflate_state* state, const cecies_deflate_huffman* litlen, const cecies_deflate_huffman* dist)
+{
+    uint64_t cost = 0;
+
+    for (unsigned int i = 0; i < CECIES_DEFLATE_LITLEN_CODES; ++i)
+    {
+        cost += (uint64_t)state->litlen_freqs[i] * (litlen->lengths[i] + (i > CECIES_DEFLATE_END_OF_BLOCK ? cecies_deflate_length_extra[i - 257] : 0));
+    }
+
+    for (unsigned int i = 0; i < CECIES_DEFLATE_DIST_CODES; ++i)
+    {
+        cost += (uint64_t)state->dist_freqs[i] * (dist->lengths[i] + cecies_deflate_dist_extra[i]);
+    }
+
+    return cost;
+}
+
+static void cecies_deflate_write_symbols(cecies_deflate_state* state, const cecies_deflate_huffman* litlen, const cecies_deflate_huffman* dist)
+{
+    for (size_t i = 0; i < state->symbols; ++i)
+    {
+        const unsigned int distance = state->distances[i];
+        const unsigned int value = state->lengths_or_literals[i];
+
+        if (distance == 0)
+        {
+            cecies_deflate_put_bits(state, litlen->codes[value], litlen->lengths[value]);
+            continue;
+        }
+
+        const unsigned int length_code = state->length_codes[value];
+        const unsigned int length_symbol = 257 + length_code;
+        cecies_deflate_put_bits(state, litlen->codes[length_symbol] | ((uint32_t)(value + 3 - cecies_deflate_length_base[length_code]) << litlen->lengths[length_symbol]), litlen->lengths[length_symbol] + cecies_deflate_length_extra[length_code]);
+
+        const unsigned int dist_code = cecies_deflate_dist_code(state, distance);
+        cecies_deflate_put_bits(state, dist->codes[dist_code] | ((uint32_t)(distance - cecies_deflate_dist_base[dist_code]) << dist->lengths[dist_code]), dist->lengths[dist_code] + cecies_deflate_dist_extra[dist_code]);
+    }
+
+    cecies_deflate_put_bits(state, litlen->codes[CECIES_DEFLATE_END_OF_BLOCK], litlen->lengths[CECIES_DEFLATE_END_OF_BLOCK]);
+}
+
+static void cecies_deflate_write_stored(cecies_deflate_state* state, const int final)
+{
+    const uint8_t* data = state->base + state->block_start;
+    size_t remaining = state->block_end - state->block_start;
+
+    do
+    {
+        const size_t length = CECIES_MIN(remaining, (size_t)CECIES_DEFLATE_STORED_MAX);
+        remaining -= length;
+
+        cecies_deflate_put_bits(state, (final && remaining == 0) ? 1 : 0, 3);
+        cecies_deflate_align(state);
+
+        uint8_t* out = state->output + state->output_length;
+        out[0] = (uint8_t)length;
+        out[1] = (uint8_t)(length >> 8);
+        out[2] = (uint8_t)~length;
+        out[3] = (uint8_t)(~length >> 8);
+        memcpy(out + 4, data, length);
+
+        state->output_length += 4 + length;
+        data += length;
+    } while (remaining > 0);
+}
+
+/*
+ * Emits the current block as whichever block type comes out the smallest, and starts a new one.
+ */
+static int cecies_deflate_flush_block(cecies_deflate_state* state, const int final)
+{
+    cecies_deflate_huffman litlen;
+    cecies_deflate_huffman dist;
+    cecies_deflate_huffman codelen;
+
+    uint8_t lengths[CECIES_DEFLATE_LITLEN_CODES + CECIES_DEFLATE_DIST_CODES];
+    uint8_t codelen_symbols[CECIES_DEFLATE_LITLEN_CODES + CECIES_DEFLATE_DIST_CODES];
+    uint8_t codelen_extras[CECIES_DEFLATE_LITLEN_CODES + CECIES_DEFLATE_DIST_CODES];
+    uint32_t codelen_freqs[CECIES_DEFLATE_CODELEN_CODES] = { 0 };
+
+    state->litlen_freqs[CECIES_DEFLATE_END_OF_BLOCK] = 1;
+
+    cecies_deflate_build_huffman(&litlen, state->litlen_freqs, CECIES_DEFLATE_LITLEN_CODES, CECIES_DEFLATE_MAX_BITS);
+    cecies_deflate_build_huffman(&dist, state->dist_freqs, CECIES_DEFLATE_DIST_CODES, CECIES_DEFLATE_MAX_BITS);
+
+    unsigned int nlitlen = CECIES_DEFLATE_LITLEN_CODES;
+    while (nlitlen > 257 && litlen.lengths[nlitlen - 1] == 0)
+    {
+        --nlitlen;
+    }
+
+    unsigned int ndist = CECIES_DEFLATE_DIST_CODES;
+    while (ndist > 1 && dist.lengths[ndist - 1] == 0)
+    {
+        --ndist;
+    }
+
+    memcpy(lengths, litlen.lengths, nlitlen);
+    memcpy(lengths + nlitlen, dist.lengths, ndist);
+
+    const unsigned int ncodelen_symbols = cecies_deflate_encode_lengths(lengths, nlitlen + ndist, codelen_symbols, codelen_extras);
+
+    for (unsigned int i = 0; i < ncodelen_symbols; ++i)
+    {
+        ++codelen_freqs[codelen_symbols[i]];
+    }
+
+    cecies_deflate_build_huffman(&codelen, codelen_freqs, CECIES_DEFLATE_CODELEN_CODES, CECIES_DEFLATE_MAX_CODELEN_BITS);
+
+    unsigned int ncodelen = CECIES_DEFLATE_CODELEN_CODES;
+    while (ncodelen > 4 && codelen.lengths[cecies_deflate_codelen_order[ncodelen - 1]] == 0)
+    {
+        --ncodelen;
+    }
+
+    uint64_t dynamic_cost = 3 + 5 + 5 + 4 + 3 * (uint64_t)ncodelen + cecies_deflate_symbols_cost(state, &litlen, &dist);
+    for (unsigned int i = 0; i < CECIES_DEFLATE_CODELEN_CODES; ++i)
+    {
+        dynamic_cost += (uint64_t)codelen_freqs[i] * (codelen.lengths[i] + cecies_deflate_codelen_extra[i]);
+    }
+
+    const uint64_t fixed_cost = 3 + cecies_deflate_symbols_cost(state, &state->fixed_litlen, &state->fixed_dist);
+
+    // Stored blocks: 3 header bits, padding up to the next byte, LEN and NLEN, then the bytes themselves (for every 64 KiB).
+    const size_t block_length = state->block_end - state->block_start;
+    const uint64_t stored_chunks = block_length == 0 ? 1 : (block_length + CECIES_DEFLATE_STORED_MAX - 1) / CECIES_DEFLATE_STORED_MAX;
+    const uint64_t stored_cost = (3 + ((8 - ((state->bit_count + 3) & 7)) & 7)) + (stored_chunks - 1) * 8 + stored_chunks * 32 + (uint64_t)block_length * 8;
+
+    const uint64_t cost = CECIES_MIN(stored_cost, CECIES_MIN(fixed_cost, dynamic_cost));
+
+    // Room for the block, plus the sync flush or final padding that may follow it.
+    if ((state->output_size - state->output_length) * 8 < cost + state->bit_count + 64)
+    {
+        return CCRUSH_ERROR_ZLIB;
+    }
+
+    if (cost == stored_cost)
+    {
+        cecies_deflate_write_stored(state, final);
+    }
+    else if (cost == fixed_cost)
+    {
+        cecies_deflate_put_bits(state, (final ? 1 : 0) | (1 << 1), 3);
+        cecies_deflate_write_symbols(state, &state->fixed_litlen, &state->fixed_dist);
+    }
+    else
+    {
+        cecies_deflate_put_bits(state, (final ? 1 : 0) | (2 << 1), 3);
+        cecies_deflate_put_bits(state, nlitlen - 257, 5);
+        cecies_deflate_put_bits(state, ndist - 1, 5);
+        cecies_deflate_put_bits(state, ncodelen - 4, 4);
+
+        for (unsigned int i = 0; i < ncodelen; ++i)
+        {
+            cecies_deflate_put_bits(state, codelen.lengths[cecies_deflate_codelen_order[i]], 3);
+        }
+
+        for (unsigned int i = 0; i < ncodelen_symbols; ++i)
+        {
+            const unsigned int symbol = codelen_symbols[i];
+            cecies_deflate_put_bits(state, codelen.codes[symbol] | ((uint32_t)codelen_extras[i] << codelen.lengths[symbol]), codelen.lengths[symbol] + cecies_deflate_codelen_extra[symbol]);
+        }
+
+        cecies_deflate_write_symbols(state, &litlen, &dist);
+    }
+
+    state->symbols = 0;
+    state->block_start = state->block_end;
+
+    memset(state->litlen_freqs, 0x00, sizeof(state->litlen_freqs));
+    memset(state->dist_freqs, 0x00, sizeof(state->dist_freqs));
+
+    return 0;
+}
+
+static inline int cecies_deflate_literal(cecies_deflate_state* state, const size_t position)
+{
+    const uint8_t literal = state->base[position];
+
+    state->distances[state->symbols] = 0;
+    state->lengths_or_literals[state->symbols++] = literal;
+    ++state->litlen_freqs[literal];
+
+    state->block_end = position + 1;
+
+    return state->symbols == CECIES_DEFLATE_BLOCK_SYMBOLS ? cecies_deflate_flush_block(state, 0) : 0;
+}
+
+static inline int cecies_deflate_match(cecies_deflate_state* state, const size_t position, const size_t length, const size_t distance)
+{
+    const unsigned int value = (unsigned int)(length - CECIES_DEFLATE_MIN_MATCH);
+
+    state->distances[state->symbols] = (uint16_t)distance;
+    state->lengths_or_literals[state->symbols++] = (uint8_t)value;
+    ++state->litlen_freqs[257 + state->length_codes[value]];
+    ++state->dist_freqs[cecies_deflate_dist_code(state, (unsigned int)distance)];
+
+    state->block_end = position + length;
+
+    return state->symbols == CECIES_DEFLATE_BLOCK_SYMBOLS ? cecies_deflate_flush_block(state, 0) : 0;
+}
+
+/*
+ * zlib's deflate_fast(): takes the longest match at every position right away. Only the strings of short matches are hashed.
+ */
+static int cecies_deflate_greedy(cecies_deflate_state* state, size_t position)
+{
+    const size_t end = state->end;
+
+    while (position < end)
+    {
+        size_t length = 0;
+        size_t distance = 0;
+
+        if (end - position >= CECIES_DEFLATE_MIN_MATCH)
+        {
+            const uint32_t candidate = cecies_deflate_insert(state, position);
+            length = cecies_deflate_longest_match(state, position, candidate, CECIES_DEFLATE_MIN_MATCH - 1, state->config.max_chain, &distance);
+        }
+
+        if (length < CECIES_DEFLATE_MIN_MATCH)
+        {
+            if (cecies_deflate_literal(state, position) != 0)
+            {
+                return CCRUSH_ERROR_ZLIB;
+            }
+
+            ++position;
+            continue;
+        }
+
+        if (cecies_deflate_match(state, position, length, distance) != 0)
+        {
+            return CCRUSH_ERROR_ZLIB;
+        }
+
+        if (length <= state->config.lazy_length)
+        {
+            for (size_t p = position + 1; p < position + length && end - p >= CECIES_DEFLATE_MIN_MATCH; ++p)
+            {
+                cecies_deflate_insert(state, p);
+            }
+        }
+
+        position += length;
+    }
+
+    return 0;
+}
+
+/*
+ * zlib's deflate_slow(): a match is only taken if the one starting at the next position isn't longer, otherwise a literal is emitted and the next match becomes the candidate.
+ */
+static int cecies_deflate_lazy(cecies_deflate_state* state, size_t position)
+{
+    const size_t end = state->end;
+
+    size_t previous_length = CECIES_DEFLATE_MIN_MATCH - 1;
+    size_t previous_distance = 0;
+    int match_available = 0;
+
+    while (position < end)
+    {
+        size_t length = CECIES_DEFLATE_MIN_MATCH - 1;
+        size_t distance = 0;
+
+        if (end - position >= CECIES_DEFLATE_MIN_MATCH)
+        {
+            const uint32_t candidate = cecies_deflate_insert(state, position);
+
+            if (previous_length < state->config.lazy_length)
+            {
+                const unsigned int chain = previous_length >= state->config.good_length ? state->config.max_chain >> 2 : state->config.max_chain;
+                length = cecies_deflate_longest_match(state, position, candidate, previous_length, chain, &distance);
+
+                if (length <= previous_length || (length == CECIES_DEFLATE_MIN_MATCH && distance > CECIES_DEFLATE_TOO_FAR))
+                {
+                    length = CECIES_DEFLATE_MIN_MATCH - 1;
+                }
+            }
+        }
+
+        if (previous_length >= CECIES_DEFLATE_MIN_MATCH && length <= previous_length)
+        {
+            // The previous position's match wins: it started one byte back.
+            const size_t match_start = position - 1;
+
+            if (cecies_deflate_match(state, match_start, previous_length, previous_distance) != 0)
+            {
+                return CCRUSH_ERROR_ZLIB;
+            }
+
+            for (size_t p = position + 1; p < match_start + previous_length && end - p >= CECIES_DEFLATE_MIN_MATCH; ++p)
+            {
+                cecies_deflate_insert(state, p);
+            }
+
+            position = match_start + previous_length;
+            previous_length = CECIES_DEFLATE_MIN_MATCH - 1;
+            match_available = 0;
+            continue;
+        }
+
+        if (match_available && cecies_deflate_literal(state, position - 1) != 0)
+        {
+            return CCRUSH_ERROR_ZLIB;
+        }
+
+        match_available = 1;
+        previous_length = length;
+        previous_distance = distance;
+        ++position;
+    }
+
+    if (match_available && cecies_deflate_literal(state, position - 1) != 0)
+    {
+        return CCRUSH_ERROR_ZLIB;
+    }
+
+    return 0;
+}
+
+static void cecies_deflate_init_tables(cecies_deflate_state* state)
+{
+    for (unsigned int code = 0; code < 28; ++code)
+    {
+        for (unsigned int i = 0; i < (1u << cecies_deflate_length_extra[code]); ++i)
+        {
+            state->length_codes[cecies_deflate_length_base[code] - CECIES_DEFLATE_MIN_MATCH + i] = (uint8_t)code;
+        }
+    }
+
+    // Length 258 has a code of its own (even though 285's predecessor could express it as well).
+    state->length_codes[255] = 28;
+
+    // Distances up to 256 are looked up directly, longer ones (whose codes have at least 7 extra bits) by their distance - 1 divided by 128.
+    for (unsigned int code = 0; code < 16; ++code)
+    {
+        for (unsigned int i = 0; i < (1u << cecies_deflate_dist_extra[code]); ++i)
+        {
+            state->dist_codes[cecies_deflate_dist_base[code] - 1 + i] = (uint8_t)code;
+        }
+    }
+
+    for (unsigned int code = 16; code < 30; ++code)
+    {
+        for (unsigned int i = 0; i < (1u << (cecies_deflate_dist_extra[code] - 7)); ++i)
+        {
+            state->dist_codes[256 + ((cecies_deflate_dist_base[code] - 1) >> 7) + i] = (uint8_t)code;
+        }
+    }
+
+    memset(state->fixed_litlen.lengths, 8, 144);
+    memset(state->fixed_litlen.lengths + 144, 9, 112);
+    memset(state->fixed_litlen.lengths + 256, 7, 24);
+    memset(state->fixed_litlen.lengths + 280, 8, 8);
+    cecies_deflate_assign_codes(&state->fixed_litlen, 288);
+
+    memset(state->fixed_dist.lengths, 5, 32);
+    cecies_deflate_assign_codes(&state->fixed_dist, 32);
+}
+
+int cecies_deflate_raw(const uint8_t* input, const size_t input_length, const size_t dictionary_length, const int level, const int last, uint8_t* output, const size_t output_size, size_t* output_length)
+{
+    if (input == NULL || output == NULL || output_length == NULL || level < 1 || level > 9 || dictionary_length > CECIES_DEFLATE_MAX_DISTANCE || input_length >= UINT32_MAX - CECIES_DEFLATE_MAX_DISTANCE)
+    {
+        return CCRUSH_ERROR_INVALID_ARGS;
+    }
+
+    cecies_deflate_state* state = cecies_malloc(sizeof(cecies_deflate_state));
+    if (state == NULL)
+    {
+        return CCRUSH_ERROR_OUT_OF_MEMORY;
+    }
+
+    for (size_t i = 0; i < CECIES_DEFLATE_HASH_SIZE; ++i)
+    {
+        state->head[i] = CECIES_DEFLATE_NIL;
+    }
+
+    memset(state->litlen_freqs, 0x00, sizeof(state->litlen_freqs));
+    memset(state->dist_freqs, 0x00, sizeof(state->dist_freqs));
+
+    state->base = input - dictionary_length;
+    state->end = dictionary_length + input_length;
+    state->config = cecies_deflate_configs[level];
+    state->symbols = 0;
+    state->block_start = dictionary_length;
+    state->block_end = dictionary_length;
+    state->output = output;
+    state->output_size = output_size;
+    state->output_length = 0;
+    state->bit_buffer = 0;
+    state->bit_count = 0;
+
+    cecies_deflate_init_tables(state);
+
+    // The dictionary's strings are matched against like any other (earlier) input.
+    for (size_t position = 0; position < dictionary_length && state->end - position >= CECIES_DEFLATE_MIN_MATCH; ++position)
+    {
+        cecies_deflate_insert(state, position);
+    }
+
+    int ret = state->config.lazy ? cecies_deflate_lazy(state, dictionary_length) : cecies_deflate_greedy(state, dictionary_length);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    if (last)
+    {
+        // The final block (possibly one without any symbols: an empty stream still needs its end of block).
+        ret = cecies_deflate_flush_block(state, 1);
+        if (ret != 0)
+        {
+            goto exit;
+        }
+    }
+    else
+    {
+        if (state->symbols != 0)
+        {
+            ret = cecies_deflate_flush_block(state, 0);
+            if (ret != 0)
+            {
+                goto exit;
+            }
+        }
+
+        // Sync flush: an empty stored block, which leaves the output byte-aligned so that the next part of the stream can just be appended.
+        state->block_start = state->block_end = state->end;
+        cecies_deflate_write_stored(state, 0);
+    }
+
+    cecies_deflate_align(state);
+    *output_length = state->output_length;
+
+exit:
+    mbedtls_platform_zeroize(state->lengths_or_literals, sizeof(state->lengths_or_literals));
+    cecies_free(state);
+    return (ret);
+}
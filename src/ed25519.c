@@ -0,0 +1,458 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <string.h>
+
+#include <mbedtls/sha512.h>
+#include <mbedtls/version.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/platform_util.h>
+
+#include "cecies/ed25519.h"
+#include "internal.h"
+
+/*
+ * Ed25519 as per RFC 8032 (pure Ed25519, no context or prehashing), on top of the Edwards curve arithmetic in edwards.c.
+ * Batch verification checks the random linear combination sum(z_i * (R_i + k_i * A_i - S_i * B)) = 0 (times the cofactor) for 128-bit random z_i,
+ * which edwards.c evaluates as a single multi-scalar multiplication over all the R_i and A_i.
+ */
+
+/*
+ * The group order l, little-endian.
+ */
+static const uint8_t cecies_ed25519_order[32] = {
+    0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14, //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, //
+};
+
+/*
+ * Encodings of the points of small order (the order 1, 2 and 8 ones and the non-canonical encodings of y = 0, 1 and -1), as rejected by libsodium.
+ * The order 4 points (y = 0) are covered by the all-zero entry, since the sign bit is ignored when comparing.
+ */
+static const uint8_t cecies_ed25519_small_order_points[7][32] = {
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+    { 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+    { 0x26, 0xe8, 0x95, 0x8f, 0xc2, 0xb2, 0x27, 0xb0, 0x45, 0xc3, 0xf4, 0x89, 0xf2, 0xef, 0x98, 0xf0, 0xd5, 0xdf, 0xac, 0x05, 0xd3, 0xc6, 0x33, 0x39, 0xb1, 0x38, 0x02, 0x88, 0x6d, 0x53, 0xfc, 0x05 },
+    { 0xc7, 0x17, 0x6a, 0x70, 0x3d, 0x4d, 0xd8, 0x4f, 0xba, 0x3c, 0x0b, 0x76, 0x0d, 0x10, 0x67, 0x0f, 0x2a, 0x20, 0x53, 0xfa, 0x2c, 0x39, 0xcc, 0xc6, 0x4e, 0xc7, 0xfd, 0x77, 0x92, 0xac, 0x03, 0x7a },
+    { 0xec, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f },
+    { 0xed, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f },
+    { 0xee, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f },
+};
+
+/*
+ * hash = SHA-512(a || b || c), where b can be left out (MbedTLS 3 dropped the _ret suffix of the incremental SHA-512 functions).
+ */
+static int cecies_ed25519_hash(uint8_t hash[64], const uint8_t* a, const size_t a_length, const uint8_t* b, const size_t b_length, const uint8_t* c, const size_t c_length)
+{
+    mbedtls_sha512_context sha512;
+    mbedtls_sha512_init(&sha512);
+
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+    int ret = mbedtls_sha512_starts(&sha512, 0);
+    ret = ret != 0 ? ret : mbedtls_sha512_update(&sha512, a, a_length);
+    ret = ret != 0 || b_length == 0 ? ret : mbedtls_sha512_update(&sha512, b, b_length);
+    ret = ret != 0 || c_length == 0 ? ret : mbedtls_sha512_update(&sha512, c, c_length);
+    ret = ret != 0 ? ret : mbedtls_sha512_finish(&sha512, hash);
+#else
+    int ret = mbedtls_sha512_starts_ret(&sha512, 0);
+    ret = ret != 0 ? ret : mbedtls_sha512_update_ret(&sha512, a, a_length);
+    ret = ret != 0 || b_length == 0 ? ret : mbedtls_sha512_update_ret(&sha512, b, b_length);
+    ret = ret != 0 || c_length == 0 ? ret : mbedtls_sha512_update_ret(&sha512, c, c_length);
+    ret = ret != 0 ? ret : mbedtls_sha512_finish_ret(&sha512, hash);
+#endif
+
+    mbedtls_sha512_free(&sha512);
+    return ret;
+}
+
+/*
+ * The secret scalar a and the nonce prefix of a private key: SHA-512 of its seed, with the first half clamped.
+ */
+static void cecies_ed25519_expand_seed(const uint8_t seed[32], uint8_t az[64])
+{
+    mbedtls_sha512(seed, 32, az, 0);
+    az[0] &= 248;
+    az[31] &= 127;
+    az[31] |= 64;
+}
+
+/*
+ * k = SHA-512(R || A || M) mod l
+ */
+static int cecies_ed25519_challenge(uint8_t k[32], const uint8_t R[32], const uint8_t A[32], const uint8_t* message, const size_t message_length)
+{
+    uint8_t hash[64];
+
+    const int ret = cecies_ed25519_hash(hash, R, 32, A, 32, message, message_length);
+    if (ret == 0)
+    {
+        cecies_ed25519_scalar_reduce(k, hash);
+    }
+
+    return ret;
+}
+
+static int cecies_ed25519_has_small_order(const uint8_t p[32])
+{
+    for (size_t i = 0; i < sizeof(cecies_ed25519_small_order_points) / sizeof(cecies_ed25519_small_order_points[0]); ++i)
+    {
+        if (memcmp(p, cecies_ed25519_small_order_points[i], 31) == 0 && (p[31] & 0x7f) == cecies_ed25519_small_order_points[i][31])
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * S < l
+ */
+static int cecies_ed25519_scalar_is_canonical(const uint8_t S[32])
+{
+    for (int i = 31; i >= 0; --i)
+    {
+        if (S[i] != cecies_ed25519_order[i])
+        {
+            return S[i] < cecies_ed25519_order[i];
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * The checks that come before evaluating the verification equation: returns 1 if the signature and public key are acceptable, 0 if they're rejected right away.
+ */
+static int cecies_ed25519_precheck(const uint8_t signature[64], const uint8_t public_key[32])
+{
+    return cecies_ed25519_scalar_is_canonical(signature + 32) && !cecies_ed25519_has_small_order(signature) && !cecies_ed25519_has_small_order(public_key);
+}
+
+int cecies_ed25519_keypair_from_seed(const uint8_t seed[CECIES_ED25519_SEED_SIZE], uint8_t public_key[CECIES_ED25519_PUBLIC_KEY_SIZE], uint8_t private_key[CECIES_ED25519_PRIVATE_KEY_SIZE])
+{
+    if (seed == NULL || public_key == NULL || private_key == NULL)
+    {
+        cecies_fprintf(stderr, "CECIES: Ed25519 key derivation failed because one or more arguments were NULL!\n");
+        return CECIES_ED25519_ERROR_CODE_NULL_ARG;
+    }
+
+    uint8_t az[64];
+    uint8_t A[32];
+
+    cecies_ed25519_expand_seed(seed, az);
+    cecies_ed25519_base_multiply(A, az);
+
+    memmove(private_key, seed, 32);
+    memcpy(private_key + 32, A, 32);
+    memcpy(public_key, A, 32);
+
+    mbedtls_platform_zeroize(az, sizeof(az));
+    return 0;
+}
+
+int cecies_generate_ed25519_keypair(uint8_t public_key[CECIES_ED25519_PUBLIC_KEY_SIZE], uint8_t private_key[CECIES_ED25519_PRIVATE_KEY_SIZE], const uint8_t* additional_entropy, const size_t additional_entropy_length)
+{
+    if (public_key == NULL || private_key == NULL)
+    {
+        cecies_fprintf(stderr, "CECIES: Ed25519 key generation failed because the output argument was NULL!\n");
+        return CECIES_ED25519_ERROR_CODE_NULL_ARG;
+    }
+
+    mbedtls_entropy_context entropy;
+    mbedtls_ctr_drbg_context ctr_drbg;
+
+    mbedtls_entropy_init(&entropy);
+    mbedtls_ctr_drbg_init(&ctr_drbg);
+
+    uint8_t seed[32];
+
+    uint8_t pers[256];
+    cecies_dev_urandom(pers, sizeof(pers));
+
+    if (additional_entropy)
+    {
+        mbedtls_sha512(additional_entropy, additional_entropy_length, pers + (sizeof(pers) - 64), 0);
+    }
+
+    int ret = mbedtls_ctr_drbg_seed(&ctr_drbg, mbedtls_entropy_func, &entropy, pers, CECIES_MIN(sizeof(pers), (MBEDTLS_CTR_DRBG_MAX_SEED_INPUT - MBEDTLS_CTR_DRBG_ENTROPY_LEN - 1)));
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: MbedTLS PRNG seed failed! mbedtls_ctr_drbg_seed returned %d\n", ret);
+        goto exit;
+    }
+
+    ret = mbedtls_ctr_drbg_random(&ctr_drbg, seed, sizeof(seed));
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Ed25519 seed generation failed! mbedtls_ctr_drbg_random returned %d\n", ret);
+        goto exit;
+    }
+
+    ret = cecies_ed25519_keypair_from_seed(seed, public_key, private_key);
+
+exit:
+    mbedtls_ctr_drbg_free(&ctr_drbg);
+    mbedtls_entropy_free(&entropy);
+    mbedtls_platform_zeroize(seed, sizeof(seed));
+    mbedtls_platform_zeroize(pers, sizeof(pers));
+    return (ret);
+}
+
+int cecies_ed25519_sign(const uint8_t* message, const size_t message_length, const uint8_t private_key[CECIES_ED25519_PRIVATE_KEY_SIZE], uint8_t signature[CECIES_ED25519_SIGNATURE_SIZE])
+{
+    if (private_key == NULL || signature == NULL || (message == NULL && message_length != 0))
+    {
+        cecies_fprintf(stderr, "CECIES: Ed25519 signing failed because one or more arguments were NULL!\n");
+        return CECIES_ED25519_ERROR_CODE_NULL_ARG;
+    }
+
+    uint8_t az[64];
+    uint8_t hash[64];
+    uint8_t r[32], R[32], k[32];
+
+    cecies_ed25519_expand_seed(private_key, az);
+
+    // r = SHA-512(prefix || M) mod l, R = [r]B
+    int ret = cecies_ed25519_hash(hash, az + 32, 32, NULL, 0, message, message_length);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Ed25519 signing failed! SHA-512 returned %d\n", ret);
+        goto exit;
+    }
+
+    cecies_ed25519_scalar_reduce(r, hash);
+    cecies_ed25519_base_multiply(R, r);
+
+    ret = cecies_ed25519_challenge(k, R, private_key + 32, message, message_length);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Ed25519 signing failed! SHA-512 returned %d\n", ret);
+        goto exit;
+    }
+
+    // S = (r + k * a) mod l
+    memcpy(signature, R, 32);
+    cecies_ed25519_scalar_muladd(signature + 32, k, az, r);
+
+exit:
+    mbedtls_platform_zeroize(az, sizeof(az));
+    mbedtls_platform_zeroize(hash, sizeof(hash));
+    mbedtls_platform_zeroize(r, sizeof(r));
+    return (ret);
+}
+
+/*
+ * cecies_ed25519_verify() without the argument checks.
+ */
+static int cecies_ed25519_verify_single(const uint8_t* message, const size_t message_length, const uint8_t signature[64], const uint8_t public_key[32])
+{
+    uint8_t k[32];
+
+    if (!cecies_ed25519_precheck(signature, public_key) || cecies_ed25519_challenge(k, signature, public_key, message, message_length) != 0)
+    {
+        return CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE;
+    }
+
+    // [8]R == [8]([S]B - [k]A): the same (cofactored) equation that cecies_ed25519_verify_batch() checks, so that the two always agree.
+    if (cecies_ed25519_verify_equation(signature, k, public_key, signature + 32) != 0)
+    {
+        return CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE;
+    }
+
+    return 0;
+}
+
+int cecies_ed25519_verify(const uint8_t* message, const size_t message_length, const uint8_t signature[CECIES_ED25519_SIGNATURE_SIZE], const uint8_t public_key[CECIES_ED25519_PUBLIC_KEY_SIZE])
+{
+    if (signature == NULL || public_key == NULL || (message == NULL && message_length != 0))
+    {
+        cecies_fprintf(stderr, "CECIES: Ed25519 signature verification failed because one or more arguments were NULL!\n");
+        return CECIES_ED25519_ERROR_CODE_NULL_ARG;
+    }
+
+    return cecies_ed25519_verify_single(message, message_length, signature, public_key);
+}
+
+int cecies_ed25519_verify_batch(const uint8_t* const* messages, const size_t* message_lengths, const uint8_t* const* signatures, const uint8_t* const* public_keys, const size_t count, int* results)
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    if (messages == NULL || message_lengths == NULL || signatures == NULL || public_keys == NULL)
+    {
+        cecies_fprintf(stderr, "CECIES: Ed25519 batch verification failed because one or more arguments were NULL!\n");
+        return CECIES_ED25519_ERROR_CODE_NULL_ARG;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (signatures[i] == NULL || public_keys[i] == NULL || (messages[i] == NULL && message_lengths[i] != 0))
+        {
+            cecies_fprintf(stderr, "CECIES: Ed25519 batch verification failed because one or more arguments were NULL!\n");
+            return CECIES_ED25519_ERROR_CODE_NULL_ARG;
+        }
+    }
+
+    if (count == 1)
+    {
+        const int ret = cecies_ed25519_verify_single(messages[0], message_lengths[0], signatures[0], public_keys[0]);
+
+        if (results != NULL)
+        {
+            results[0] = ret;
+        }
+
+        return ret;
+    }
+
+    int ret = 0;
+
+    static const uint8_t zero[32] = { 0 };
+    uint8_t base_scalar[32] = { 0 };
+    uint8_t batch_key[32] = { 0 };
+    uint8_t z[64] = { 0 };
+    uint8_t k[32];
+
+    // Every signature that passes the prechecks adds its R (scalar z) and A (scalar z * k) to the multi-scalar multiplication.
+    // The others are rejected right away (results[i] if there is an array for it), which rejected[i] keeps track of.
+    const uint8_t** points = cecies_malloc(2 * count * sizeof(const uint8_t*));
+    uint8_t* scalars = cecies_malloc(2 * count * 32);
+    uint8_t* rejected = cecies_calloc(count, 1);
+
+    size_t point_count = 0;
+    int any_rejected = 0;
+
+    if (points == NULL || scalars == NULL || rejected == NULL)
+    {
+        cecies_fprintf(stderr, "CECIES: Ed25519 batch verification failed: OUT OF MEMORY!\n");
+        ret = CECIES_ED25519_ERROR_CODE_OUT_OF_MEMORY;
+        goto exit;
+    }
+
+    // Setting up a CTR_DRBG costs about as much as two signature verifications, so the random coefficients are derived from one key read straight from the OS instead
+    // (the DRBG is only used if that read failed, which leaves the key all zeros).
+    cecies_dev_urandom(batch_key, sizeof(batch_key));
+
+    if (memcmp(batch_key, zero, sizeof(batch_key)) == 0)
+    {
+        mbedtls_entropy_context entropy;
+        mbedtls_ctr_drbg_context ctr_drbg;
+
+        mbedtls_entropy_init(&entropy);
+        mbedtls_ctr_drbg_init(&ctr_drbg);
+
+        ret = cecies_seed_ctr_drbg(&ctr_drbg, &entropy);
+        ret = ret != 0 ? ret : mbedtls_ctr_drbg_random(&ctr_drbg, batch_key, sizeof(batch_key));
+
+        mbedtls_ctr_drbg_free(&ctr_drbg);
+        mbedtls_entropy_free(&entropy);
+
+        if (ret != 0)
+        {
+            cecies_fprintf(stderr, "CECIES: Ed25519 batch verification failed! Generating the random coefficients returned %d\n", ret);
+            goto exit;
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!cecies_ed25519_precheck(signatures[i], public_keys[i]))
+        {
+            if (results == NULL)
+            {
+                ret = CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE;
+                goto exit;
+            }
+
+            rejected[i] = any_rejected = 1;
+            continue;
+        }
+
+        // z = the first 128 bits of SHA-512(batch key || i), the rest stays zero.
+        uint8_t index[8];
+        for (size_t j = 0; j < sizeof(index); ++j)
+        {
+            index[j] = (uint8_t)((uint64_t)i >> (8 * j));
+        }
+
+        ret = cecies_ed25519_hash(z, batch_key, sizeof(batch_key), index, sizeof(index), NULL, 0);
+        memset(z + 16, 0x00, sizeof(z) - 16);
+
+        ret = ret != 0 ? ret : cecies_ed25519_challenge(k, signatures[i], public_keys[i], messages[i], message_lengths[i]);
+        if (ret != 0)
+        {
+            cecies_fprintf(stderr, "CECIES: Ed25519 batch verification failed! Generating the random coefficients returned %d\n", ret);
+            goto exit;
+        }
+
+        points[point_count] = signatures[i];
+        memcpy(scalars + 32 * point_count, z, 32);
+        ++point_count;
+
+        points[point_count] = public_keys[i];
+        cecies_ed25519_scalar_muladd(scalars + 32 * point_count, z, k, zero);
+        ++point_count;
+
+        cecies_ed25519_scalar_muladd(base_scalar, z, signatures[i] + 32, base_scalar);
+    }
+
+    ret = point_count == 0 ? 0 : cecies_ed25519_batch_check(base_scalar, points, scalars, point_count);
+
+    if (ret == MBEDTLS_ERR_MPI_ALLOC_FAILED)
+    {
+        cecies_fprintf(stderr, "CECIES: Ed25519 batch verification failed: OUT OF MEMORY!\n");
+        ret = CECIES_ED25519_ERROR_CODE_OUT_OF_MEMORY;
+        goto exit;
+    }
+
+    if (ret == 0)
+    {
+        for (size_t i = 0; i < count && results != NULL; ++i)
+        {
+            results[i] = rejected[i] ? CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE : 0;
+        }
+
+        ret = any_rejected ? CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE : 0;
+        goto exit;
+    }
+
+    // At least one of the signatures is invalid: find out which one(s).
+    ret = CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE;
+
+    for (size_t i = 0; i < count && results != NULL; ++i)
+    {
+        results[i] = rejected[i] ? CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE : cecies_ed25519_verify_single(messages[i], message_lengths[i], signatures[i], public_keys[i]);
+    }
+
+exit:
+    if (scalars != NULL)
+    {
+        mbedtls_platform_zeroize(scalars, 2 * count * 32);
+    }
+
+    mbedtls_platform_zeroize(z, sizeof(z));
+    mbedtls_platform_zeroize(batch_key, sizeof(batch_key));
+    mbedtls_platform_zeroize(base_scalar, sizeof(base_scalar));
+
+    cecies_free(points);
+    cecies_free(scalars);
+    cecies_free(rejected);
+    return (ret);
+}
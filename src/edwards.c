@@ -0,0 +1,1456 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <string.h>
+
+#include <mbedtls/ecp.h>
+#include <mbedtls/platform_util.h>
+
+#include "cecies/util.h"
+#include "internal.h"
+
+/*
+ * Fixed-base scalar multiplication for ephemeral (and long-term) key generation.
+ * MbedTLS computes R = r * G through the same Montgomery ladder it uses for any other point, one bit of r at a time.
+ * Since G never changes, the multiples that the ladder recomputes every time can be precomputed instead: here r * G is evaluated on the Edwards form of the curve
+ * (Ed25519 for Curve25519 and edwards448 for Curve448, see RFC 7748 section 4) using a comb over a table of multiples of the base point (edwards_base_tables.h),
+ * and only the resulting point's u-coordinate is mapped back to Montgomery form.
+ * The edwards448 field arithmetic needs 128-bit integer multiplication: without it (e.g. MSVC), Curve448 key generation keeps going through mbedtls_ecp_gen_keypair().
+ * Ed25519 has a portable field for that case (see internal.h), which its signatures (ed25519.c) rely on as well.
+ */
+
+#include "edwards_base_tables.h"
+
+#ifdef CECIES_EDWARDS
+typedef unsigned __int128 cecies_uint128;
+#endif
+
+#ifdef CECIES_ED25519_WIDE
+
+// Field arithmetic mod p = 2^255 - 19: 5 limbs of 51 bits (loosely reduced: limbs may exceed 51 bits by a little between operations).
+
+#define CECIES_ED25519_LIMBS 5
+#define CECIES_ED25519_MASK ((UINT64_C(1) << 51) - 1)
+
+typedef uint64_t cecies_ed25519_limb;
+typedef cecies_ed25519_limb cecies_ed25519_fe[CECIES_ED25519_LIMBS];
+
+/*
+ * One carry pass: leaves limbs 1 to 4 below 2^51 and limb 0 only a little above it, which is all that the other operations need from their inputs.
+ */
+static void cecies_ed25519_fe_carry_once(uint64_t h[5])
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        h[i + 1] += h[i] >> 51;
+        h[i] &= CECIES_ED25519_MASK;
+    }
+
+    h[0] += 19 * (h[4] >> 51);
+    h[4] &= CECIES_ED25519_MASK;
+}
+
+static void cecies_ed25519_fe_carry(uint64_t h[5])
+{
+    cecies_ed25519_fe_carry_once(h);
+    cecies_ed25519_fe_carry_once(h);
+}
+
+static void cecies_ed25519_fe_add(uint64_t h[5], const uint64_t f[5], const uint64_t g[5])
+{
+    for (int i = 0; i < 5; ++i)
+    {
+        h[i] = f[i] + g[i];
+    }
+
+    cecies_ed25519_fe_carry_once(h);
+}
+
+static void cecies_ed25519_fe_sub(uint64_t h[5], const uint64_t f[5], const uint64_t g[5])
+{
+    // Adding 4 * p first keeps every limb positive.
+    h[0] = f[0] + ((CECIES_ED25519_MASK - 18) << 2) - g[0];
+
+    for (int i = 1; i < 5; ++i)
+    {
+        h[i] = f[i] + (CECIES_ED25519_MASK << 2) - g[i];
+    }
+
+    cecies_ed25519_fe_carry_once(h);
+}
+
+/*
+ * h = t, carrying the 128-bit column sums of a multiplication back down into 51-bit limbs.
+ */
+static void cecies_ed25519_fe_carry_wide(uint64_t h[5], cecies_uint128 t[5])
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        t[i + 1] += t[i] >> 51;
+        h[i] = (uint64_t)t[i] & CECIES_ED25519_MASK;
+    }
+
+    const uint64_t carry = (uint64_t)(t[4] >> 51);
+    h[4] = (uint64_t)t[4] & CECIES_ED25519_MASK;
+    h[0] += 19 * carry;
+    h[1] += h[0] >> 51;
+    h[0] &= CECIES_ED25519_MASK;
+}
+
+static void cecies_ed25519_fe_mul(uint64_t h[5], const uint64_t f[5], const uint64_t g[5])
+{
+    const uint64_t g1_19 = 19 * g[1], g2_19 = 19 * g[2], g3_19 = 19 * g[3], g4_19 = 19 * g[4];
+
+    cecies_uint128 t[5];
+    t[0] = (cecies_uint128)f[0] * g[0] + (cecies_uint128)f[1] * g4_19 + (cecies_uint128)f[2] * g3_19 + (cecies_uint128)f[3] * g2_19 + (cecies_uint128)f[4] * g1_19;
+    t[1] = (cecies_uint128)f[0] * g[1] + (cecies_uint128)f[1] * g[0] + (cecies_uint128)f[2] * g4_19 + (cecies_uint128)f[3] * g3_19 + (cecies_uint128)f[4] * g2_19;
+    t[2] = (cecies_uint128)f[0] * g[2] + (cecies_uint128)f[1] * g[1] + (cecies_uint128)f[2] * g[0] + (cecies_uint128)f[3] * g4_19 + (cecies_uint128)f[4] * g3_19;
+    t[3] = (cecies_uint128)f[0] * g[3] + (cecies_uint128)f[1] * g[2] + (cecies_uint128)f[2] * g[1] + (cecies_uint128)f[3] * g[0] + (cecies_uint128)f[4] * g4_19;
+    t[4] = (cecies_uint128)f[0] * g[4] + (cecies_uint128)f[1] * g[3] + (cecies_uint128)f[2] * g[2] + (cecies_uint128)f[3] * g[1] + (cecies_uint128)f[4] * g[0];
+
+    cecies_ed25519_fe_carry_wide(h, t);
+}
+
+static void cecies_ed25519_fe_sqr(uint64_t h[5], const uint64_t f[5])
+{
+    const uint64_t f0_2 = 2 * f[0], f1_2 = 2 * f[1];
+    const uint64_t f1_38 = 38 * f[1], f2_38 = 38 * f[2], f3_38 = 38 * f[3], f3_19 = 19 * f[3], f4_19 = 19 * f[4];
+
+    cecies_uint128 t[5];
+    t[0] = (cecies_uint128)f[0] * f[0] + (cecies_uint128)f1_38 * f[4] + (cecies_uint128)f2_38 * f[3];
+    t[1] = (cecies_uint128)f0_2 * f[1] + (cecies_uint128)f2_38 * f[4] + (cecies_uint128)f3_19 * f[3];
+    t[2] = (cecies_uint128)f0_2 * f[2] + (cecies_uint128)f[1] * f[1] + (cecies_uint128)f3_38 * f[4];
+    t[3] = (cecies_uint128)f0_2 * f[3] + (cecies_uint128)f1_2 * f[2] + (cecies_uint128)f4_19 * f[4];
+    t[4] = (cecies_uint128)f0_2 * f[4] + (cecies_uint128)f1_2 * f[3] + (cecies_uint128)f[2] * f[2];
+
+    cecies_ed25519_fe_carry_wide(h, t);
+}
+
+static void cecies_ed25519_fe_cmov(uint64_t f[5], const uint64_t g[5], const uint64_t mask)
+{
+    for (int i = 0; i < 5; ++i)
+    {
+        f[i] ^= (f[i] ^ g[i]) & mask;
+    }
+}
+
+/*
+ * Writes f out as the canonical (fully reduced mod p) little-endian encoding.
+ */
+static void cecies_ed25519_fe_tobytes(uint8_t s[32], const uint64_t f[5])
+{
+    uint64_t h[5], t[5];
+    memcpy(h, f, sizeof(h));
+    cecies_ed25519_fe_carry(h);
+    cecies_ed25519_fe_carry(h);
+
+    // h < 2^255 < 2 * p now, so subtracting p once (if that doesn't go below zero) fully reduces it: h - p = h + 19 - 2^255.
+    int64_t borrow = 19;
+    for (int i = 0; i < 5; ++i)
+    {
+        const int64_t v = (int64_t)h[i] - (i == 4 ? (int64_t)1 << 51 : 0) + borrow;
+        t[i] = (uint64_t)v & CECIES_ED25519_MASK;
+        borrow = v >> 51;
+    }
+
+    cecies_ed25519_fe_cmov(h, t, (uint64_t)(borrow + 1) * UINT64_MAX);
+
+    const uint64_t w[4] = {
+        h[0] | (h[1] << 51),
+        (h[1] >> 13) | (h[2] << 38),
+        (h[2] >> 26) | (h[3] << 25),
+        (h[3] >> 39) | (h[4] << 12),
+    };
+
+    for (int i = 0; i < 32; ++i)
+    {
+        s[i] = (uint8_t)(w[i / 8] >> (8 * (i % 8)));
+    }
+
+    mbedtls_platform_zeroize(h, sizeof(h));
+    mbedtls_platform_zeroize(t, sizeof(t));
+}
+
+static uint64_t cecies_ed25519_load_le64(const uint8_t* p)
+{
+    uint64_t v = 0;
+
+    for (int i = 7; i >= 0; --i)
+    {
+        v = (v << 8) | p[i];
+    }
+
+    return v;
+}
+
+static void cecies_ed25519_fe_frombytes(uint64_t h[5], const uint8_t s[32])
+{
+    const uint64_t w0 = cecies_ed25519_load_le64(s + 0);
+    const uint64_t w1 = cecies_ed25519_load_le64(s + 8);
+    const uint64_t w2 = cecies_ed25519_load_le64(s + 16);
+    const uint64_t w3 = cecies_ed25519_load_le64(s + 24);
+
+    // The top bit (the x sign bit in point encodings) is ignored.
+    h[0] = w0 & CECIES_ED25519_MASK;
+    h[1] = ((w0 >> 51) | (w1 << 13)) & CECIES_ED25519_MASK;
+    h[2] = ((w1 >> 38) | (w2 << 26)) & CECIES_ED25519_MASK;
+    h[3] = ((w2 >> 25) | (w3 << 39)) & CECIES_ED25519_MASK;
+    h[4] = (w3 >> 12) & CECIES_ED25519_MASK;
+}
+
+static const uint64_t cecies_ed25519_d[5] = { 0x34dca135978a3, 0x1a8283b156ebd, 0x5e7a26001c029, 0x739c663a03cbb, 0x52036cee2b6ff };
+static const uint64_t cecies_ed25519_d2[5] = { 0x69b9426b2f159, 0x35050762add7a, 0x3cf44c0038052, 0x6738cc7407977, 0x2406d9dc56dff };
+static const uint64_t cecies_ed25519_sqrtm1[5] = { 0x61b274a0ea0b0, 0x0d5a5fc8f189d, 0x7ef5e9cbd0c60, 0x78595a6804c9e, 0x2b8324804fc1d };
+
+#else
+
+// Portable field arithmetic mod p = 2^255 - 19: 10 limbs of alternately 26 and 25 bits (limb i starts at bit ceil(25.5 * i)), with 64-bit products.
+// Every operation returns carried limbs (none above its width by more than a little), which keeps the column sums of cecies_ed25519_fe_mul() below 2^61.
+
+#define CECIES_ED25519_LIMBS 10
+
+// The width of limb i: 26 bits for the even ones, 25 bits for the odd ones.
+#define CECIES_ED25519_BITS(i) (26 - ((i) & 1))
+#define CECIES_ED25519_MASK(i) ((UINT32_C(1) << CECIES_ED25519_BITS(i)) - 1)
+
+typedef uint32_t cecies_ed25519_limb;
+typedef cecies_ed25519_limb cecies_ed25519_fe[CECIES_ED25519_LIMBS];
+
+/*
+ * One carry pass: leaves limbs 1 to 9 within their widths and limb 0 only a little above it, which is all that the other operations need from their inputs.
+ */
+static void cecies_ed25519_fe_carry_once(uint32_t h[10])
+{
+    for (int i = 0; i < 9; ++i)
+    {
+        h[i + 1] += h[i] >> CECIES_ED25519_BITS(i);
+        h[i] &= CECIES_ED25519_MASK(i);
+    }
+
+    h[0] += 19 * (h[9] >> 25);
+    h[9] &= CECIES_ED25519_MASK(9);
+}
+
+static void cecies_ed25519_fe_carry(uint32_t h[10])
+{
+    cecies_ed25519_fe_carry_once(h);
+    cecies_ed25519_fe_carry_once(h);
+}
+
+static void cecies_ed25519_fe_add(uint32_t h[10], const uint32_t f[10], const uint32_t g[10])
+{
+    for (int i = 0; i < 10; ++i)
+    {
+        h[i] = f[i] + g[i];
+    }
+
+    cecies_ed25519_fe_carry_once(h);
+}
+
+static void cecies_ed25519_fe_sub(uint32_t h[10], const uint32_t f[10], const uint32_t g[10])
+{
+    // Adding 4 * p first keeps every limb positive.
+    h[0] = f[0] + ((CECIES_ED25519_MASK(0) - 18) << 2) - g[0];
+
+    for (int i = 1; i < 10; ++i)
+    {
+        h[i] = f[i] + (CECIES_ED25519_MASK(i) << 2) - g[i];
+    }
+
+    cecies_ed25519_fe_carry_once(h);
+}
+
+/*
+ * h = t, carrying the 64-bit column sums of a multiplication back down into limbs.
+ */
+static void cecies_ed25519_fe_carry_wide(uint32_t h[10], uint64_t t[10])
+{
+    for (int i = 0; i < 9; ++i)
+    {
+        t[i + 1] += t[i] >> CECIES_ED25519_BITS(i);
+        h[i] = (uint32_t)t[i] & CECIES_ED25519_MASK(i);
+    }
+
+    const uint64_t h0 = h[0] + 19 * (t[9] >> 25);
+    h[9] = (uint32_t)t[9] & CECIES_ED25519_MASK(9);
+    h[0] = (uint32_t)h0 & CECIES_ED25519_MASK(0);
+    h[1] += (uint32_t)(h0 >> 26);
+}
+
+/*
+ * Limb i times limb j lands in column i + j: doubled if both are odd (since both of their offsets were rounded up by half a bit), and times 19 if it wraps around past 2^255.
+ */
+static void cecies_ed25519_fe_mul(uint32_t h[10], const uint32_t f[10], const uint32_t g[10])
+{
+    const uint32_t f1_2 = 2 * f[1], f3_2 = 2 * f[3], f5_2 = 2 * f[5], f7_2 = 2 * f[7], f9_2 = 2 * f[9];
+    const uint32_t g1_19 = 19 * g[1], g2_19 = 19 * g[2], g3_19 = 19 * g[3], g4_19 = 19 * g[4], g5_19 = 19 * g[5], g6_19 = 19 * g[6], g7_19 = 19 * g[7], g8_19 = 19 * g[8], g9_19 = 19 * g[9];
+
+    uint64_t t[10];
+    t[0] = (uint64_t)f[0] * g[0] + (uint64_t)f1_2 * g9_19 + (uint64_t)f[2] * g8_19 + (uint64_t)f3_2 * g7_19 + (uint64_t)f[4] * g6_19 + (uint64_t)f5_2 * g5_19 + (uint64_t)f[6] * g4_19 + (uint64_t)f7_2 * g3_19 + (uint64_t)f[8] * g2_19 + (uint64_t)f9_2 * g1_19;
+    t[1] = (uint64_t)f[0] * g[1] + (uint64_t)f[1] * g[0] + (uint64_t)f[2] * g9_19 + (uint64_t)f[3] * g8_19 + (uint64_t)f[4] * g7_19 + (uint64_t)f[5] * g6_19 + (uint64_t)f[6] * g5_19 + (uint64_t)f[7] * g4_19 + (uint64_t)f[8] * g3_19 + (uint64_t)f[9] * g2_19;
+    t[2] = (uint64_t)f[0] * g[2] + (uint64_t)f1_2 * g[1] + (uint64_t)f[2] * g[0] + (uint64_t)f3_2 * g9_19 + (uint64_t)f[4] * g8_19 + (uint64_t)f5_2 * g7_19 + (uint64_t)f[6] * g6_19 + (uint64_t)f7_2 * g5_19 + (uint64_t)f[8] * g4_19 + (uint64_t)f9_2 * g3_19;
+    t[3] = (uint64_t)f[0] * g[3] + (uint64_t)f[1] * g[2] + (uint64_t)f[2] * g[1] + (uint64_t)f[3] * g[0] + (uint64_t)f[4] * g9_19 + (uint64_t)f[5] * g8_19 + (uint64_t)f[6] * g7_19 + (uint64_t)f[7] * g6_19 + (uint64_t)f[8] * g5_19 + (uint64_t)f[9] * g4_19;
+    t[4] = (uint64_t)f[0] * g[4] + (uint64_t)f1_2 * g[3] + (uint64_t)f[2] * g[2] + (uint64_t)f3_2 * g[1] + (uint64_t)f[4] * g[0] + (uint64_t)f5_2 * g9_19 + (uint64_t)f[6] * g8_19 + (uint64_t)f7_2 * g7_19 + (uint64_t)f[8] * g6_19 + (uint64_t)f9_2 * g5_19;
+    t[5] = (uint64_t)f[0] * g[5] + (uint64_t)f[1] * g[4] + (uint64_t)f[2] * g[3] + (uint64_t)f[3] * g[2] + (uint64_t)f[4] * g[1] + (uint64_t)f[5] * g[0] + (uint64_t)f[6] * g9_19 + (uint64_t)f[7] * g8_19 + (uint64_t)f[8] * g7_19 + (uint64_t)f[9] * g6_19;
+    t[6] = (uint64_t)f[0] * g[6] + (uint64_t)f1_2 * g[5] + (uint64_t)f[2] * g[4] + (uint64_t)f3_2 * g[3] + (uint64_t)f[4] * g[2] + (uint64_t)f5_2 * g[1] + (uint64_t)f[6] * g[0] + (uint64_t)f7_2 * g9_19 + (uint64_t)f[8] * g8_19 + (uint64_t)f9_2 * g7_19;
+    t[7] = (uint64_t)f[0] * g[7] + (uint64_t)f[1] * g[6] + (uint64_t)f[2] * g[5] + (uint64_t)f[3] * g[4] + (uint64_t)f[4] * g[3] + (uint64_t)f[5] * g[2] + (uint64_t)f[6] * g[1] + (uint64_t)f[7] * g[0] + (uint64_t)f[8] * g9_19 + (uint64_t)f[9] * g8_19;
+    t[8] = (uint64_t)f[0] * g[8] + (uint64_t)f1_2 * g[7] + (uint64_t)f[2] * g[6] + (uint64_t)f3_2 * g[5] + (uint64_t)f[4] * g[4] + (uint64_t)f5_2 * g[3] + (uint64_t)f[6] * g[2] + (uint64_t)f7_2 * g[1] + (uint64_t)f[8] * g[0] + (uint64_t)f9_2 * g9_19;
+    t[9] = (uint64_t)f[0] * g[9] + (uint64_t)f[1] * g[8] + (uint64_t)f[2] * g[7] + (uint64_t)f[3] * g[6] + (uint64_t)f[4] * g[5] + (uint64_t)f[5] * g[4] + (uint64_t)f[6] * g[3] + (uint64_t)f[7] * g[2] + (uint64_t)f[8] * g[1] + (uint64_t)f[9] * g[0];
+
+    cecies_ed25519_fe_carry_wide(h, t);
+}
+
+static void cecies_ed25519_fe_sqr(uint32_t h[10], const uint32_t f[10])
+{
+    // Every product f[i] * f[j] with i < j shows up twice.
+    const uint32_t f0_2 = 2 * f[0], f1_2 = 2 * f[1], f2_2 = 2 * f[2], f3_2 = 2 * f[3], f4_2 = 2 * f[4], f5_2 = 2 * f[5], f6_2 = 2 * f[6], f7_2 = 2 * f[7], f8_2 = 2 * f[8], f9_2 = 2 * f[9];
+    const uint32_t f1_4 = 4 * f[1], f3_4 = 4 * f[3], f5_4 = 4 * f[5], f7_4 = 4 * f[7];
+    const uint32_t f5_19 = 19 * f[5], f6_19 = 19 * f[6], f7_19 = 19 * f[7], f8_19 = 19 * f[8], f9_19 = 19 * f[9];
+
+    uint64_t t[10];
+    t[0] = (uint64_t)f[0] * f[0] + (uint64_t)f1_4 * f9_19 + (uint64_t)f2_2 * f8_19 + (uint64_t)f3_4 * f7_19 + (uint64_t)f4_2 * f6_19 + (uint64_t)f5_2 * f5_19;
+    t[1] = (uint64_t)f0_2 * f[1] + (uint64_t)f2_2 * f9_19 + (uint64_t)f3_2 * f8_19 + (uint64_t)f4_2 * f7_19 + (uint64_t)f5_2 * f6_19;
+    t[2] = (uint64_t)f0_2 * f[2] + (uint64_t)f1_2 * f[1] + (uint64_t)f3_4 * f9_19 + (uint64_t)f4_2 * f8_19 + (uint64_t)f5_4 * f7_19 + (uint64_t)f[6] * f6_19;
+    t[3] = (uint64_t)f0_2 * f[3] + (uint64_t)f1_2 * f[2] + (uint64_t)f4_2 * f9_19 + (uint64_t)f5_2 * f8_19 + (uint64_t)f6_2 * f7_19;
+    t[4] = (uint64_t)f0_2 * f[4] + (uint64_t)f1_4 * f[3] + (uint64_t)f[2] * f[2] + (uint64_t)f5_4 * f9_19 + (uint64_t)f6_2 * f8_19 + (uint64_t)f7_2 * f7_19;
+    t[5] = (uint64_t)f0_2 * f[5] + (uint64_t)f1_2 * f[4] + (uint64_t)f2_2 * f[3] + (uint64_t)f6_2 * f9_19 + (uint64_t)f7_2 * f8_19;
+    t[6] = (uint64_t)f0_2 * f[6] + (uint64_t)f1_4 * f[5] + (uint64_t)f2_2 * f[4] + (uint64_t)f3_2 * f[3] + (uint64_t)f7_4 * f9_19 + (uint64_t)f[8] * f8_19;
+    t[7] = (uint64_t)f0_2 * f[7] + (uint64_t)f1_2 * f[6] + (uint64_t)f2_2 * f[5] + (uint64_t)f3_2 * f[4] + (uint64_t)f8_2 * f9_19;
+    t[8] = (uint64_t)f0_2 * f[8] + (uint64_t)f1_4 * f[7] + (uint64_t)f2_2 * f[6] + (uint64_t)f3_4 * f[5] + (uint64_t)f[4] * f[4] + (uint64_t)f9_2 * f9_19;
+    t[9] = (uint64_t)f0_2 * f[9] + (uint64_t)f1_2 * f[8] + (uint64_t)f2_2 * f[7] + (uint64_t)f3_2 * f[6] + (uint64_t)f4_2 * f[5];
+
+    cecies_ed25519_fe_carry_wide(h, t);
+}
+
+static void cecies_ed25519_fe_cmov(uint32_t f[10], const uint32_t g[10], const uint32_t mask)
+{
+    for (int i = 0; i < 10; ++i)
+    {
+        f[i] ^= (f[i] ^ g[i]) & mask;
+    }
+}
+
+/*
+ * Writes f out as the canonical (fully reduced mod p) little-endian encoding.
+ */
+static void cecies_ed25519_fe_tobytes(uint8_t s[32], const uint32_t f[10])
+{
+    uint32_t h[10], t[10];
+    memcpy(h, f, sizeof(h));
+    cecies_ed25519_fe_carry(h);
+    cecies_ed25519_fe_carry(h);
+
+    // h < 2^255 < 2 * p now, so subtracting p once (if that doesn't go below zero) fully reduces it: h - p = h + 19 - 2^255.
+    int32_t borrow = 19;
+    for (int i = 0; i < 10; ++i)
+    {
+        const int32_t v = (int32_t)h[i] - (i == 9 ? (int32_t)1 << 25 : 0) + borrow;
+        t[i] = (uint32_t)v & CECIES_ED25519_MASK(i);
+        borrow = v >> CECIES_ED25519_BITS(i);
+    }
+
+    cecies_ed25519_fe_cmov(h, t, (uint32_t)(borrow + 1) * UINT32_MAX);
+
+    uint64_t w = 0;
+    int bits = 0;
+    size_t n = 0;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        w |= (uint64_t)h[i] << bits;
+        bits += CECIES_ED25519_BITS(i);
+
+        for (; bits >= 8; bits -= 8)
+        {
+            s[n++] = (uint8_t)w;
+            w >>= 8;
+        }
+    }
+
+    // 255 bits: the last 7 are still in w.
+    s[31] = (uint8_t)w;
+
+    mbedtls_platform_zeroize(h, sizeof(h));
+    mbedtls_platform_zeroize(t, sizeof(t));
+    mbedtls_platform_zeroize(&w, sizeof(w));
+}
+
+static void cecies_ed25519_fe_frombytes(uint32_t h[10], const uint8_t s[32])
+{
+    int offset = 0;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        // Limb i spans (at most) 5 bytes, starting at byte offset / 8.
+        uint64_t w = 0;
+        for (int k = 4; k >= 0; --k)
+        {
+            const int byte = offset / 8 + k;
+            w = (w << 8) | (byte < 32 ? s[byte] : 0);
+        }
+
+        // The top bit (the x sign bit in point encodings) is ignored: limb 9 ends at bit 254.
+        h[i] = (uint32_t)(w >> (offset % 8)) & CECIES_ED25519_MASK(i);
+        offset += CECIES_ED25519_BITS(i);
+    }
+}
+
+static const uint32_t cecies_ed25519_d[10] = { 0x35978a3, 0x0d37284, 0x3156ebd, 0x06a0a0e, 0x001c029, 0x179e898, 0x3a03cbb, 0x1ce7198, 0x2e2b6ff, 0x1480db3 };
+static const uint32_t cecies_ed25519_d2[10] = { 0x2b2f159, 0x1a6e509, 0x22add7a, 0x0d4141d, 0x0038052, 0x0f3d130, 0x3407977, 0x19ce331, 0x1c56dff, 0x0901b67 };
+static const uint32_t cecies_ed25519_sqrtm1[10] = { 0x20ea0b0, 0x186c9d2, 0x08f189d, 0x035697f, 0x0bd0c60, 0x1fbd7a7, 0x2804c9e, 0x1e16569, 0x004fc1d, 0x0ae0c92 };
+
+#endif // CECIES_ED25519_WIDE
+
+static void cecies_ed25519_fe_sqr_n(cecies_ed25519_fe h, const cecies_ed25519_fe f, const int n)
+{
+    cecies_ed25519_fe_sqr(h, f);
+
+    for (int i = 1; i < n; ++i)
+    {
+        cecies_ed25519_fe_sqr(h, h);
+    }
+}
+
+/*
+ * h = f^(2^250 - 1), the common part of the exponentiations below (z11 = f^11 is needed by the inversion).
+ */
+static void cecies_ed25519_fe_pow2_250_1(cecies_ed25519_fe h, cecies_ed25519_fe z11, const cecies_ed25519_fe f)
+{
+    cecies_ed25519_fe z2_5_0, z2_10_0, z2_20_0, z2_50_0, z2_100_0, t;
+
+    cecies_ed25519_fe_sqr(t, f);          // 2
+    cecies_ed25519_fe_sqr_n(z11, t, 2);   // 8
+    cecies_ed25519_fe_mul(z11, z11, f);   // 9
+    cecies_ed25519_fe_mul(t, t, z11);     // 11
+    cecies_ed25519_fe_sqr(z2_5_0, t);     // 22
+    cecies_ed25519_fe_mul(z2_5_0, z2_5_0, z11); // 31 = 2^5 - 1
+    memcpy(z11, t, sizeof(cecies_ed25519_fe));
+
+    cecies_ed25519_fe_sqr_n(t, z2_5_0, 5);
+    cecies_ed25519_fe_mul(z2_10_0, t, z2_5_0);
+    cecies_ed25519_fe_sqr_n(t, z2_10_0, 10);
+    cecies_ed25519_fe_mul(z2_20_0, t, z2_10_0);
+    cecies_ed25519_fe_sqr_n(t, z2_20_0, 20);
+    cecies_ed25519_fe_mul(t, t, z2_20_0);
+    cecies_ed25519_fe_sqr_n(t, t, 10);
+    cecies_ed25519_fe_mul(z2_50_0, t, z2_10_0);
+    cecies_ed25519_fe_sqr_n(t, z2_50_0, 50);
+    cecies_ed25519_fe_mul(z2_100_0, t, z2_50_0);
+    cecies_ed25519_fe_sqr_n(t, z2_100_0, 100);
+    cecies_ed25519_fe_mul(t, t, z2_100_0);
+    cecies_ed25519_fe_sqr_n(t, t, 50);
+    cecies_ed25519_fe_mul(h, t, z2_50_0);
+}
+
+/*
+ * h = 1 / f = f^(p - 2), with p - 2 = 2^255 - 21 (h = 0 if f = 0).
+ */
+static void cecies_ed25519_fe_invert(cecies_ed25519_fe h, const cecies_ed25519_fe f)
+{
+    cecies_ed25519_fe z11, t;
+    cecies_ed25519_fe_pow2_250_1(t, z11, f);
+    cecies_ed25519_fe_sqr_n(t, t, 5);
+    cecies_ed25519_fe_mul(h, t, z11);
+}
+
+/*
+ * h = f^((p - 5) / 8) = f^(2^252 - 3), for the square root in cecies_ed25519_decode().
+ */
+static void cecies_ed25519_fe_pow22523(cecies_ed25519_fe h, const cecies_ed25519_fe f)
+{
+    cecies_ed25519_fe z11, t;
+    cecies_ed25519_fe_pow2_250_1(t, z11, f);
+    cecies_ed25519_fe_sqr_n(t, t, 2);
+    cecies_ed25519_fe_mul(h, t, f);
+}
+
+#ifdef CECIES_EDWARDS
+
+// Field arithmetic mod p = 2^448 - 2^224 - 1: 8 limbs of 56 bits (loosely reduced, like the 51-bit Ed25519 limbs). 2^448 = 2^224 + 1 (mod p), so whatever overflows the top limb is added into limbs 0 and 4.
+
+#define CECIES_ED448_MASK ((UINT64_C(1) << 56) - 1)
+
+static void cecies_ed448_fe_carry(uint64_t h[8])
+{
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (int i = 0; i < 7; ++i)
+        {
+            h[i + 1] += h[i] >> 56;
+            h[i] &= CECIES_ED448_MASK;
+        }
+
+        const uint64_t carry = h[7] >> 56;
+        h[7] &= CECIES_ED448_MASK;
+        h[0] += carry;
+        h[4] += carry;
+    }
+}
+
+static void cecies_ed448_fe_add(uint64_t h[8], const uint64_t f[8], const uint64_t g[8])
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        h[i] = f[i] + g[i];
+    }
+
+    cecies_ed448_fe_carry(h);
+}
+
+static void cecies_ed448_fe_sub(uint64_t h[8], const uint64_t f[8], const uint64_t g[8])
+{
+    // Adding 4 * p first keeps every limb positive.
+    for (int i = 0; i < 8; ++i)
+    {
+        h[i] = f[i] + ((CECIES_ED448_MASK - (i == 4)) << 2) - g[i];
+    }
+
+    cecies_ed448_fe_carry(h);
+}
+
+static void cecies_ed448_fe_mul(uint64_t h[8], const uint64_t f[8], const uint64_t g[8])
+{
+    cecies_uint128 t[15] = { 0 };
+
+    for (int i = 0; i < 8; ++i)
+    {
+        for (int j = 0; j < 8; ++j)
+        {
+            t[i + j] += (cecies_uint128)f[i] * g[j];
+        }
+    }
+
+    // Limb k >= 8 has the weight of limbs k - 8 and k - 4 combined (going downwards, so that limbs 8 to 10 have received their share from 12 to 14 before being folded themselves).
+    for (int k = 14; k >= 8; --k)
+    {
+        t[k - 8] += t[k];
+        t[k - 4] += t[k];
+    }
+
+    for (int i = 0; i < 7; ++i)
+    {
+        t[i + 1] += t[i] >> 56;
+        h[i] = (uint64_t)t[i] & CECIES_ED448_MASK;
+    }
+
+    const uint64_t carry = (uint64_t)(t[7] >> 56);
+    h[7] = (uint64_t)t[7] & CECIES_ED448_MASK;
+    h[0] += carry;
+    h[4] += carry;
+    h[1] += h[0] >> 56;
+    h[0] &= CECIES_ED448_MASK;
+    h[5] += h[4] >> 56;
+    h[4] &= CECIES_ED448_MASK;
+}
+
+static void cecies_ed448_fe_sqr(uint64_t h[8], const uint64_t f[8])
+{
+    cecies_ed448_fe_mul(h, f, f);
+}
+
+static void cecies_ed448_fe_cmov(uint64_t f[8], const uint64_t g[8], const uint64_t mask)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        f[i] ^= (f[i] ^ g[i]) & mask;
+    }
+}
+
+static void cecies_ed448_fe_sqr_n(uint64_t h[8], const uint64_t f[8], const int n)
+{
+    cecies_ed448_fe_sqr(h, f);
+
+    for (int i = 1; i < n; ++i)
+    {
+        cecies_ed448_fe_sqr(h, h);
+    }
+}
+
+/*
+ * h = 1 / f = f^(p - 2), with p - 2 = (2^223 - 1) * 2^225 + (2^222 - 1) * 4 + 1 (h = 0 if f = 0).
+ * x_n below stands for f^(2^n - 1).
+ */
+static void cecies_ed448_fe_invert(uint64_t h[8], const uint64_t f[8])
+{
+    uint64_t x3[8], x6[8], x12[8], x24[8], x30[8], x48[8], x96[8], x192[8], x222[8], t[8];
+
+    cecies_ed448_fe_sqr(t, f);
+    cecies_ed448_fe_mul(t, t, f); // x2
+    cecies_ed448_fe_sqr(x3, t);
+    cecies_ed448_fe_mul(x3, x3, f);
+    cecies_ed448_fe_sqr_n(x6, x3, 3);
+    cecies_ed448_fe_mul(x6, x6, x3);
+    cecies_ed448_fe_sqr_n(x12, x6, 6);
+    cecies_ed448_fe_mul(x12, x12, x6);
+    cecies_ed448_fe_sqr_n(x24, x12, 12);
+    cecies_ed448_fe_mul(x24, x24, x12);
+    cecies_ed448_fe_sqr_n(x30, x24, 6);
+    cecies_ed448_fe_mul(x30, x30, x6);
+    cecies_ed448_fe_sqr_n(x48, x24, 24);
+    cecies_ed448_fe_mul(x48, x48, x24);
+    cecies_ed448_fe_sqr_n(x96, x48, 48);
+    cecies_ed448_fe_mul(x96, x96, x48);
+    cecies_ed448_fe_sqr_n(x192, x96, 96);
+    cecies_ed448_fe_mul(x192, x192, x96);
+    cecies_ed448_fe_sqr_n(x222, x192, 30);
+    cecies_ed448_fe_mul(x222, x222, x30);
+    cecies_ed448_fe_sqr(t, x222);
+    cecies_ed448_fe_mul(t, t, f); // x223
+
+    cecies_ed448_fe_sqr_n(t, t, 223);
+    cecies_ed448_fe_mul(t, t, x222);
+    cecies_ed448_fe_sqr_n(t, t, 2);
+    cecies_ed448_fe_mul(h, t, f);
+}
+
+/*
+ * Writes f out as the canonical (fully reduced mod p) little-endian encoding.
+ */
+static void cecies_ed448_fe_tobytes(uint8_t s[56], const uint64_t f[8])
+{
+    uint64_t h[8], t[8];
+    memcpy(h, f, sizeof(h));
+    cecies_ed448_fe_carry(h);
+    cecies_ed448_fe_carry(h);
+
+    // h < 2^448 < 2 * p now, so subtracting p once (if that doesn't go below zero) fully reduces it.
+    // h - p = h + 2^224 + 1 - 2^448: it's h >= p if adding 2^224 + 1 carries out of the top limb.
+    uint64_t carry = 1;
+    for (int i = 0; i < 8; ++i)
+    {
+        const uint64_t v = h[i] + (i == 4) + carry;
+        t[i] = v & CECIES_ED448_MASK;
+        carry = v >> 56;
+    }
+
+    cecies_ed448_fe_cmov(h, t, carry * UINT64_MAX);
+
+    for (int i = 0; i < 56; ++i)
+    {
+        s[i] = (uint8_t)(h[i / 7] >> (8 * (i % 7)));
+    }
+
+    mbedtls_platform_zeroize(h, sizeof(h));
+    mbedtls_platform_zeroize(t, sizeof(t));
+}
+
+#define CECIES_ED cecies_ed448
+#define CECIES_ED_LIMB uint64_t
+#define CECIES_ED_LIMBS 8
+#define CECIES_ED_A 1
+#define CECIES_ED_DIGITS 113
+#define CECIES_ED_POSITIONS 15
+#include "edwards_impl.h"
+
+#endif // CECIES_EDWARDS
+
+#define CECIES_ED cecies_ed25519
+#define CECIES_ED_LIMB cecies_ed25519_limb
+#define CECIES_ED_LIMBS CECIES_ED25519_LIMBS
+#define CECIES_ED_A (-1)
+#define CECIES_ED_DIGITS 64
+#define CECIES_ED_POSITIONS 8
+#include "edwards_impl.h"
+
+/*
+ * Ed25519 (RFC 8032): point en-/decoding, the double-scalar multiplication for verifying a single signature, the multi-scalar multiplication
+ * for verifying a whole batch, and the scalar arithmetic mod l = 2^252 + 27742317777372353535851937790883648493.
+ * Signing goes through the constant-time comb above; everything else here only ever touches public data (keys and signatures) and is variable-time.
+ */
+
+#ifdef CECIES_ED25519_WIDE
+
+// Scalars are 4 limbs of 64 bits, multiplied into 128-bit integers.
+#define CECIES_ED25519_SCALAR_LIMBS 4
+
+typedef uint64_t cecies_ed25519_scalar_limb;
+typedef cecies_uint128 cecies_ed25519_scalar_wide;
+
+static const uint64_t cecies_ed25519_l[5] = { 0x5812631a5cf5d3ed, 0x14def9dea2f79cd6, 0x0000000000000000, 0x1000000000000000, 0 };
+
+// floor(2^512 / l), for Barrett reduction.
+static const uint64_t cecies_ed25519_mu[5] = { 0xed9ce5a30a2c131b, 0x2106215d086329a7, 0xffffffffffffffeb, 0xffffffffffffffff, 0xf };
+
+#else
+
+// Scalars are 8 limbs of 32 bits, multiplied into 64-bit integers.
+#define CECIES_ED25519_SCALAR_LIMBS 8
+
+typedef uint32_t cecies_ed25519_scalar_limb;
+typedef uint64_t cecies_ed25519_scalar_wide;
+
+static const uint32_t cecies_ed25519_l[9] = { 0x5cf5d3ed, 0x5812631a, 0xa2f79cd6, 0x14def9de, 0x00000000, 0x00000000, 0x00000000, 0x10000000, 0 };
+
+// floor(2^512 / l), for Barrett reduction.
+static const uint32_t cecies_ed25519_mu[9] = { 0x0a2c131b, 0xed9ce5a3, 0x086329a7, 0x2106215d, 0xffffffeb, 0xffffffff, 0xffffffff, 0xffffffff, 0xf };
+
+#endif // CECIES_ED25519_WIDE
+
+#define CECIES_ED25519_SCALAR_BITS (8 * sizeof(cecies_ed25519_scalar_limb))
+
+static cecies_ed25519_scalar_limb cecies_ed25519_scalar_load(const uint8_t* p)
+{
+    cecies_ed25519_scalar_limb v = 0;
+
+    for (size_t i = sizeof(v); i-- > 0;)
+    {
+        v = (v << 8) | p[i];
+    }
+
+    return v;
+}
+
+static void cecies_ed25519_scalar_store(uint8_t* p, const cecies_ed25519_scalar_limb v)
+{
+    for (size_t i = 0; i < sizeof(v); ++i)
+    {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static int cecies_ed25519_fe_iszero(const cecies_ed25519_fe f)
+{
+    uint8_t s[32];
+    uint8_t z = 0;
+    cecies_ed25519_fe_tobytes(s, f);
+
+    for (int i = 0; i < 32; ++i)
+    {
+        z |= s[i];
+    }
+
+    return z == 0;
+}
+
+static int cecies_ed25519_fe_isnegative(const cecies_ed25519_fe f)
+{
+    uint8_t s[32];
+    cecies_ed25519_fe_tobytes(s, f);
+    return s[0] & 1;
+}
+
+static void cecies_ed25519_fe_neg(cecies_ed25519_fe h, const cecies_ed25519_fe f)
+{
+    static const cecies_ed25519_fe zero = { 0 };
+    cecies_ed25519_fe_sub(h, zero, f);
+}
+
+/*
+ * A point prepared for being added to others: (Y + X, Y - X, Z, 2 * d * T).
+ */
+typedef struct cecies_ed25519_cached
+{
+    cecies_ed25519_fe YplusX;
+    cecies_ed25519_fe YminusX;
+    cecies_ed25519_fe Z;
+    cecies_ed25519_fe T2d;
+} cecies_ed25519_cached;
+
+static void cecies_ed25519_point_identity(cecies_ed25519_point* p)
+{
+    memset(p, 0x00, sizeof(cecies_ed25519_point));
+    p->Y[0] = 1;
+    p->Z[0] = 1;
+}
+
+static void cecies_ed25519_to_cached(cecies_ed25519_cached* c, const cecies_ed25519_point* p)
+{
+    cecies_ed25519_fe_add(c->YplusX, p->Y, p->X);
+    cecies_ed25519_fe_sub(c->YminusX, p->Y, p->X);
+    memcpy(c->Z, p->Z, sizeof(c->Z));
+    cecies_ed25519_fe_mul(c->T2d, p->T, cecies_ed25519_d2);
+}
+
+/*
+ * r = p + q (or p - q if subtract is set); r may be p. These are the complete "add-2008-hwcd-3" formulas for a = -1.
+ */
+static void cecies_ed25519_point_add_cached(cecies_ed25519_point* r, const cecies_ed25519_point* p, const cecies_ed25519_cached* q, const int subtract)
+{
+    cecies_ed25519_fe a, b, c, d, e, f, g, h;
+
+    // -(Y + X, Y - X, Z, 2dT) = (Y - X, Y + X, Z, -2dT)
+    cecies_ed25519_fe_sub(a, p->Y, p->X);
+    cecies_ed25519_fe_mul(a, a, subtract ? q->YplusX : q->YminusX);
+    cecies_ed25519_fe_add(b, p->Y, p->X);
+    cecies_ed25519_fe_mul(b, b, subtract ? q->YminusX : q->YplusX);
+    cecies_ed25519_fe_mul(c, p->T, q->T2d);
+    cecies_ed25519_fe_mul(d, p->Z, q->Z);
+    cecies_ed25519_fe_add(d, d, d);
+
+    cecies_ed25519_fe_sub(e, b, a);
+    cecies_ed25519_fe_add(h, b, a);
+
+    if (subtract)
+    {
+        cecies_ed25519_fe_add(f, d, c);
+        cecies_ed25519_fe_sub(g, d, c);
+    }
+    else
+    {
+        cecies_ed25519_fe_sub(f, d, c);
+        cecies_ed25519_fe_add(g, d, c);
+    }
+
+    cecies_ed25519_fe_mul(r->X, e, f);
+    cecies_ed25519_fe_mul(r->Y, g, h);
+    cecies_ed25519_fe_mul(r->T, e, h);
+    cecies_ed25519_fe_mul(r->Z, f, g);
+}
+
+/*
+ * Decodes a point as per RFC 8032 section 5.1.3 (negated if negate is set). Non-canonical encodings (y >= p) are rejected.
+ * Returns 0 on success or 1 if the encoding isn't a valid point.
+ */
+static int cecies_ed25519_decode(cecies_ed25519_point* p, const uint8_t s[32], const int negate)
+{
+    static const cecies_ed25519_fe one = { 1 };
+
+    cecies_ed25519_fe u, v, v3, x, y, t;
+
+    // y < p = 2^255 - 19
+    int canonical = (s[31] & 0x7f) != 0x7f || s[0] < 0xed;
+    for (int i = 1; i < 31 && !canonical; ++i)
+    {
+        canonical = s[i] != 0xff;
+    }
+
+    if (!canonical)
+    {
+        return 1;
+    }
+
+    const int sign = s[31] >> 7;
+    cecies_ed25519_fe_frombytes(y, s);
+
+    // x^2 = u / v = (y^2 - 1) / (d * y^2 + 1)
+    cecies_ed25519_fe_sqr(u, y);
+    cecies_ed25519_fe_mul(v, u, cecies_ed25519_d);
+    cecies_ed25519_fe_sub(u, u, one);
+    cecies_ed25519_fe_add(v, v, one);
+
+    // x = u * v^3 * (u * v^7)^((p - 5) / 8)
+    cecies_ed25519_fe_sqr(v3, v);
+    cecies_ed25519_fe_mul(v3, v3, v);
+    cecies_ed25519_fe_sqr(x, v3);
+    cecies_ed25519_fe_mul(x, x, v);
+    cecies_ed25519_fe_mul(x, x, u);
+    cecies_ed25519_fe_pow22523(x, x);
+    cecies_ed25519_fe_mul(x, x, v3);
+    cecies_ed25519_fe_mul(x, x, u);
+
+    // v * x^2 is either u (x is the root), -u (x * sqrt(-1) is) or neither (there is none).
+    cecies_ed25519_fe_sqr(t, x);
+    cecies_ed25519_fe_mul(t, t, v);
+    cecies_ed25519_fe_sub(v, t, u);
+
+    if (!cecies_ed25519_fe_iszero(v))
+    {
+        cecies_ed25519_fe_add(v, t, u);
+
+        if (!cecies_ed25519_fe_iszero(v))
+        {
+            return 1;
+        }
+
+        cecies_ed25519_fe_mul(x, x, cecies_ed25519_sqrtm1);
+    }
+
+    if (cecies_ed25519_fe_iszero(x) && sign)
+    {
+        return 1;
+    }
+
+    if ((cecies_ed25519_fe_isnegative(x) ^ sign ^ (negate != 0)) != 0)
+    {
+        cecies_ed25519_fe_neg(x, x);
+    }
+
+    memcpy(p->X, x, sizeof(x));
+    memcpy(p->Y, y, sizeof(y));
+    memcpy(p->Z, one, sizeof(one));
+    cecies_ed25519_fe_mul(p->T, x, y);
+    return 0;
+}
+
+static void cecies_ed25519_encode(uint8_t s[32], const cecies_ed25519_point* p)
+{
+    cecies_ed25519_fe z, x, y;
+
+    cecies_ed25519_fe_invert(z, p->Z);
+    cecies_ed25519_fe_mul(x, p->X, z);
+    cecies_ed25519_fe_mul(y, p->Y, z);
+    cecies_ed25519_fe_tobytes(s, y);
+    s[31] |= (uint8_t)(cecies_ed25519_fe_isnegative(x) << 7);
+
+    mbedtls_platform_zeroize(z, sizeof(z));
+    mbedtls_platform_zeroize(x, sizeof(x));
+    mbedtls_platform_zeroize(y, sizeof(y));
+}
+
+/*
+ * r = x mod l for a 512-bit x (2k limbs), using Barrett reduction (HAC 14.42 with b = 2^64 and k = 4, or b = 2^32 and k = 8); constant-time.
+ */
+static void cecies_ed25519_scalar_reduce_limbs(cecies_ed25519_scalar_limb r[CECIES_ED25519_SCALAR_LIMBS], const cecies_ed25519_scalar_limb x[2 * CECIES_ED25519_SCALAR_LIMBS])
+{
+    cecies_ed25519_scalar_limb q2[2 * CECIES_ED25519_SCALAR_LIMBS + 2] = { 0 }, r2[CECIES_ED25519_SCALAR_LIMBS + 1] = { 0 }, t[CECIES_ED25519_SCALAR_LIMBS + 1];
+
+    // q3 = floor(floor(x / b^(k - 1)) * mu / b^(k + 1)): the top k + 1 limbs of q2.
+    for (int i = 0; i < CECIES_ED25519_SCALAR_LIMBS + 1; ++i)
+    {
+        cecies_ed25519_scalar_limb carry = 0;
+
+        for (int j = 0; j < CECIES_ED25519_SCALAR_LIMBS + 1; ++j)
+        {
+            const cecies_ed25519_scalar_wide m = (cecies_ed25519_scalar_wide)x[CECIES_ED25519_SCALAR_LIMBS - 1 + i] * cecies_ed25519_mu[j] + q2[i + j] + carry;
+            q2[i + j] = (cecies_ed25519_scalar_limb)m;
+            carry = (cecies_ed25519_scalar_limb)(m >> CECIES_ED25519_SCALAR_BITS);
+        }
+
+        q2[i + CECIES_ED25519_SCALAR_LIMBS + 1] = carry;
+    }
+
+    // r2 = q3 * l mod b^(k + 1)
+    for (int i = 0; i < CECIES_ED25519_SCALAR_LIMBS + 1; ++i)
+    {
+        cecies_ed25519_scalar_limb carry = 0;
+
+        for (int j = 0; i + j < CECIES_ED25519_SCALAR_LIMBS + 1; ++j)
+        {
+            const cecies_ed25519_scalar_wide m = (cecies_ed25519_scalar_wide)q2[CECIES_ED25519_SCALAR_LIMBS + 1 + i] * cecies_ed25519_l[j] + r2[i + j] + carry;
+            r2[i + j] = (cecies_ed25519_scalar_limb)m;
+            carry = (cecies_ed25519_scalar_limb)(m >> CECIES_ED25519_SCALAR_BITS);
+        }
+    }
+
+    // r = (x mod b^(k + 1)) - r2 mod b^(k + 1), which is below 3 * l: subtract l (at most) twice.
+    cecies_ed25519_scalar_limb borrow = 0;
+    for (int i = 0; i < CECIES_ED25519_SCALAR_LIMBS + 1; ++i)
+    {
+        const cecies_ed25519_scalar_wide d = (cecies_ed25519_scalar_wide)x[i] - r2[i] - borrow;
+        r2[i] = (cecies_ed25519_scalar_limb)d;
+        borrow = (cecies_ed25519_scalar_limb)(d >> CECIES_ED25519_SCALAR_BITS) & 1;
+    }
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        borrow = 0;
+        for (int i = 0; i < CECIES_ED25519_SCALAR_LIMBS + 1; ++i)
+        {
+            const cecies_ed25519_scalar_wide d = (cecies_ed25519_scalar_wide)r2[i] - cecies_ed25519_l[i] - borrow;
+            t[i] = (cecies_ed25519_scalar_limb)d;
+            borrow = (cecies_ed25519_scalar_limb)(d >> CECIES_ED25519_SCALAR_BITS) & 1;
+        }
+
+        const cecies_ed25519_scalar_limb mask = borrow - 1;
+        for (int i = 0; i < CECIES_ED25519_SCALAR_LIMBS + 1; ++i)
+        {
+            r2[i] ^= (r2[i] ^ t[i]) & mask;
+        }
+    }
+
+    memcpy(r, r2, CECIES_ED25519_SCALAR_LIMBS * sizeof(cecies_ed25519_scalar_limb));
+
+    mbedtls_platform_zeroize(q2, sizeof(q2));
+    mbedtls_platform_zeroize(r2, sizeof(r2));
+    mbedtls_platform_zeroize(t, sizeof(t));
+}
+
+void cecies_ed25519_scalar_reduce(uint8_t out[32], const uint8_t in[64])
+{
+    cecies_ed25519_scalar_limb x[2 * CECIES_ED25519_SCALAR_LIMBS], r[CECIES_ED25519_SCALAR_LIMBS];
+
+    for (int i = 0; i < 2 * CECIES_ED25519_SCALAR_LIMBS; ++i)
+    {
+        x[i] = cecies_ed25519_scalar_load(in + sizeof(x[0]) * i);
+    }
+
+    cecies_ed25519_scalar_reduce_limbs(r, x);
+
+    for (int i = 0; i < CECIES_ED25519_SCALAR_LIMBS; ++i)
+    {
+        cecies_ed25519_scalar_store(out + sizeof(r[0]) * i, r[i]);
+    }
+
+    mbedtls_platform_zeroize(x, sizeof(x));
+    mbedtls_platform_zeroize(r, sizeof(r));
+}
+
+void cecies_ed25519_scalar_muladd(uint8_t out[32], const uint8_t a[32], const uint8_t b[32], const uint8_t c[32])
+{
+    cecies_ed25519_scalar_limb al[CECIES_ED25519_SCALAR_LIMBS], bl[CECIES_ED25519_SCALAR_LIMBS], x[2 * CECIES_ED25519_SCALAR_LIMBS] = { 0 }, r[CECIES_ED25519_SCALAR_LIMBS];
+
+    for (int i = 0; i < CECIES_ED25519_SCALAR_LIMBS; ++i)
+    {
+        al[i] = cecies_ed25519_scalar_load(a + sizeof(al[0]) * i);
+        bl[i] = cecies_ed25519_scalar_load(b + sizeof(bl[0]) * i);
+        x[i] = cecies_ed25519_scalar_load(c + sizeof(x[0]) * i);
+    }
+
+    // a * b + c < 2^512
+    for (int i = 0; i < CECIES_ED25519_SCALAR_LIMBS; ++i)
+    {
+        cecies_ed25519_scalar_limb carry = 0;
+
+        for (int j = 0; j < CECIES_ED25519_SCALAR_LIMBS; ++j)
+        {
+            const cecies_ed25519_scalar_wide m = (cecies_ed25519_scalar_wide)al[i] * bl[j] + x[i + j] + carry;
+            x[i + j] = (cecies_ed25519_scalar_limb)m;
+            carry = (cecies_ed25519_scalar_limb)(m >> CECIES_ED25519_SCALAR_BITS);
+        }
+
+        for (int k = i + CECIES_ED25519_SCALAR_LIMBS; k < 2 * CECIES_ED25519_SCALAR_LIMBS && carry != 0; ++k)
+        {
+            const cecies_ed25519_scalar_wide m = (cecies_ed25519_scalar_wide)x[k] + carry;
+            x[k] = (cecies_ed25519_scalar_limb)m;
+            carry = (cecies_ed25519_scalar_limb)(m >> CECIES_ED25519_SCALAR_BITS);
+        }
+    }
+
+    cecies_ed25519_scalar_reduce_limbs(r, x);
+
+    for (int i = 0; i < CECIES_ED25519_SCALAR_LIMBS; ++i)
+    {
+        cecies_ed25519_scalar_store(out + sizeof(r[0]) * i, r[i]);
+    }
+
+    mbedtls_platform_zeroize(al, sizeof(al));
+    mbedtls_platform_zeroize(bl, sizeof(bl));
+    mbedtls_platform_zeroize(x, sizeof(x));
+    mbedtls_platform_zeroize(r, sizeof(r));
+}
+
+void cecies_ed25519_base_multiply(uint8_t out[32], const uint8_t scalar[32])
+{
+    cecies_ed25519_point p;
+    cecies_ed25519_scalarmult_base(&p, scalar, 32);
+    cecies_ed25519_encode(out, &p);
+    mbedtls_platform_zeroize(&p, sizeof(p));
+}
+
+/*
+ * Signed radix-16 digits in [-8, 8) of a scalar below 2^255, like cecies_ed25519_scalarmult_base() uses.
+ */
+static void cecies_ed25519_recode_radix16(int8_t e[64], const uint8_t k[32])
+{
+    for (int i = 0; i < 32; ++i)
+    {
+        e[2 * i + 0] = (int8_t)(k[i] & 15);
+        e[2 * i + 1] = (int8_t)(k[i] >> 4);
+    }
+
+    for (int i = 0; i < 63; ++i)
+    {
+        const int8_t carry = (int8_t)((e[i] + 8) >> 4);
+        e[i] = (int8_t)(e[i] - (carry << 4));
+        e[i + 1] = (int8_t)(e[i + 1] + carry);
+    }
+}
+
+int cecies_ed25519_verify_equation(const uint8_t R[32], const uint8_t h[32], const uint8_t A[32], const uint8_t S[32])
+{
+    static const cecies_ed25519_fe zero = { 0 };
+
+    cecies_ed25519_point p, q;
+    cecies_ed25519_cached table[8];
+    cecies_ed25519_limb b[3][CECIES_ED25519_LIMBS];
+    int8_t eh[64], es[64];
+
+    if (cecies_ed25519_decode(&q, A, 1) != 0)
+    {
+        return 1;
+    }
+
+    // table[j] = (j + 1) * -A; the multiples of B come from the first row of the comb table.
+    cecies_ed25519_to_cached(&table[0], &q);
+    for (int j = 1; j < 8; ++j)
+    {
+        cecies_ed25519_point_add_cached(&q, &q, &table[0], 0);
+        cecies_ed25519_to_cached(&table[j], &q);
+    }
+
+    cecies_ed25519_recode_radix16(eh, h);
+    cecies_ed25519_recode_radix16(es, S);
+
+    // Both scalar multiplications share one chain of doublings (Straus).
+    cecies_ed25519_point_identity(&p);
+
+    for (int i = 63; i >= 0; --i)
+    {
+        if (i != 63)
+        {
+            for (int d = 0; d < 4; ++d)
+            {
+                cecies_ed25519_point_double(&p);
+            }
+        }
+
+        if (eh[i] != 0)
+        {
+            cecies_ed25519_point_add_cached(&p, &p, &table[(eh[i] < 0 ? -eh[i] : eh[i]) - 1], eh[i] < 0);
+        }
+
+        if (es[i] != 0)
+        {
+            memcpy(b, cecies_ed25519_base_table[0][(es[i] < 0 ? -es[i] : es[i]) - 1], sizeof(b));
+
+            if (es[i] < 0)
+            {
+                cecies_ed25519_fe_sub(b[0], zero, b[0]);
+                cecies_ed25519_fe_sub(b[2], zero, b[2]);
+            }
+
+            cecies_ed25519_point_add_affine(&p, (const cecies_ed25519_limb(*)[CECIES_ED25519_LIMBS])b);
+        }
+    }
+
+    // Valid signatures from honest signers match exactly, which saves decoding R.
+    uint8_t check[32];
+    cecies_ed25519_encode(check, &p);
+
+    if (memcmp(check, R, sizeof(check)) == 0)
+    {
+        return 0;
+    }
+
+    // Otherwise, R and [S]B - [h]A may still only differ by a point of small order: [8]([S]B - [h]A - R) == 0 <=> X == 0 and Y == Z.
+    if (cecies_ed25519_decode(&q, R, 1) != 0)
+    {
+        return 1;
+    }
+
+    cecies_ed25519_to_cached(&table[0], &q);
+    cecies_ed25519_point_add_cached(&p, &p, &table[0], 0);
+
+    for (int d = 0; d < 3; ++d)
+    {
+        cecies_ed25519_point_double(&p);
+    }
+
+    cecies_ed25519_fe_sub(p.Y, p.Y, p.Z);
+    return cecies_ed25519_fe_iszero(p.X) && cecies_ed25519_fe_iszero(p.Y) ? 0 : 1;
+}
+
+/*
+ * The (bits)-bit window of a 32-byte scalar starting at bit position (zero-padded past the end).
+ */
+static uint32_t cecies_ed25519_scalar_window(const uint8_t k[32], const size_t position, const size_t bits)
+{
+    uint32_t w = 0;
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        const size_t byte = position / 8 + i;
+        if (byte < 32)
+        {
+            w |= (uint32_t)k[byte] << (8 * i);
+        }
+    }
+
+    return (w >> (position % 8)) & ((UINT32_C(1) << bits) - 1);
+}
+
+/*
+ * Pippenger's bucket method: acc = sum_i scalars[i] * points[i], for large batches. Returns 1 if one of the points doesn't decode.
+ */
+static int cecies_ed25519_msm_pippenger(cecies_ed25519_point* acc, const uint8_t* const* points, const uint8_t* scalars, const size_t count)
+{
+    // Window width c: every window costs count additions into the buckets plus 2^c for summing the 2^(c - 1) buckets up.
+    size_t c = 2;
+    while (c < 12 && ((size_t)1 << (c + 2)) <= count)
+    {
+        ++c;
+    }
+
+    // Scalars are below 2^253; the signed recoding may carry into one more window.
+    const size_t windows = (253 + c - 1) / c + 1;
+    const size_t bucket_count = (size_t)1 << (c - 1);
+
+    int ret = 1;
+    cecies_ed25519_point sum, running;
+    cecies_ed25519_cached cached;
+
+    cecies_ed25519_cached* prepared = cecies_malloc(count * sizeof(cecies_ed25519_cached));
+    cecies_ed25519_point* buckets = cecies_malloc(bucket_count * sizeof(cecies_ed25519_point));
+    uint8_t* used = cecies_malloc(bucket_count);
+    int16_t* digits = cecies_malloc(count * windows * sizeof(int16_t));
+
+    if (prepared == NULL || buckets == NULL || used == NULL || digits == NULL)
+    {
+        ret = MBEDTLS_ERR_MPI_ALLOC_FAILED;
+        goto exit;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (cecies_ed25519_decode(&sum, points[i], 0) != 0)
+        {
+            goto exit;
+        }
+
+        cecies_ed25519_to_cached(&prepared[i], &sum);
+
+        // Signed digits in [-2^(c - 1), 2^(c - 1)).
+        uint32_t carry = 0;
+        for (size_t w = 0; w < windows; ++w)
+        {
+            int32_t digit = (int32_t)(cecies_ed25519_scalar_window(scalars + 32 * i, w * c, c) + carry);
+            carry = digit >= (int32_t)bucket_count;
+            digit -= (int32_t)(carry << c);
+            digits[i * windows + w] = (int16_t)digit;
+        }
+    }
+
+    cecies_ed25519_point_identity(acc);
+
+    for (size_t w = windows; w-- > 0;)
+    {
+        for (size_t d = 0; d < c && w != windows - 1; ++d)
+        {
+            cecies_ed25519_point_double(acc);
+        }
+
+        memset(used, 0x00, bucket_count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const int16_t digit = digits[i * windows + w];
+            if (digit == 0)
+            {
+                continue;
+            }
+
+            const size_t b = (size_t)(digit < 0 ? -digit : digit) - 1;
+
+            if (!used[b])
+            {
+                cecies_ed25519_point_identity(&buckets[b]);
+                used[b] = 1;
+            }
+
+            cecies_ed25519_point_add_cached(&buckets[b], &buckets[b], &prepared[i], digit < 0);
+        }
+
+        // sum = sum_b (b + 1) * buckets[b], as the sum of the running sums from the top bucket down.
+        cecies_ed25519_point_identity(&running);
+        cecies_ed25519_point_identity(&sum);
+
+        for (size_t b = bucket_count; b-- > 0;)
+        {
+            if (used[b])
+            {
+                cecies_ed25519_to_cached(&cached, &buckets[b]);
+                cecies_ed25519_point_add_cached(&running, &running, &cached, 0);
+            }
+
+            cecies_ed25519_to_cached(&cached, &running);
+            cecies_ed25519_point_add_cached(&sum, &sum, &cached, 0);
+        }
+
+        cecies_ed25519_to_cached(&cached, &sum);
+        cecies_ed25519_point_add_cached(acc, acc, &cached, 0);
+    }
+
+    ret = 0;
+
+exit:
+    cecies_free(prepared);
+    cecies_free(buckets);
+    cecies_free(used);
+    cecies_free(digits);
+    return ret;
+}
+
+
+/*
+ * Straus' method: acc = sum_i scalars[i] * points[i] with one shared chain of doublings, which beats Pippenger for small batches. Returns 1 if one of the points doesn't decode.
+ */
+static int cecies_ed25519_msm_straus(cecies_ed25519_point* acc, const uint8_t* const* points, const uint8_t* scalars, const size_t count)
+{
+    int ret = 1;
+    cecies_ed25519_point q;
+
+    // table[8 * i + j] = (j + 1) * points[i]
+    cecies_ed25519_cached* table = cecies_malloc(8 * count * sizeof(cecies_ed25519_cached));
+    int8_t* digits = cecies_malloc(64 * count);
+
+    if (table == NULL || digits == NULL)
+    {
+        ret = MBEDTLS_ERR_MPI_ALLOC_FAILED;
+        goto exit;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (cecies_ed25519_decode(&q, points[i], 0) != 0)
+        {
+            goto exit;
+        }
+
+        cecies_ed25519_to_cached(&table[8 * i], &q);
+        for (size_t j = 1; j < 8; ++j)
+        {
+            cecies_ed25519_point_add_cached(&q, &q, &table[8 * i], 0);
+            cecies_ed25519_to_cached(&table[8 * i + j], &q);
+        }
+
+        cecies_ed25519_recode_radix16(digits + 64 * i, scalars + 32 * i);
+    }
+
+    cecies_ed25519_point_identity(acc);
+
+    for (int w = 63; w >= 0; --w)
+    {
+        for (int d = 0; d < 4 && w != 63; ++d)
+        {
+            cecies_ed25519_point_double(acc);
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const int8_t digit = digits[64 * i + w];
+            if (digit != 0)
+            {
+                cecies_ed25519_point_add_cached(acc, acc, &table[8 * i + (digit < 0 ? -digit : digit) - 1], digit < 0);
+            }
+        }
+    }
+
+    ret = 0;
+
+exit:
+    cecies_free(table);
+    cecies_free(digits);
+    return ret;
+}
+
+int cecies_ed25519_batch_check(const uint8_t base_scalar[32], const uint8_t* const* points, const uint8_t* scalars, const size_t count)
+{
+    cecies_ed25519_point acc, sum;
+    cecies_ed25519_cached cached;
+
+    // Straus costs about 71 additions per point, Pippenger about 253 / c plus the bucket sums: they break even at around 128 points.
+    const int ret = count < 128 ? cecies_ed25519_msm_straus(&acc, points, scalars, count) : cecies_ed25519_msm_pippenger(&acc, points, scalars, count);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    // [8]([base_scalar]B - acc) == 0 <=> X == 0 and Y == Z.
+    cecies_ed25519_scalarmult_base(&sum, base_scalar, 32);
+    cecies_ed25519_to_cached(&cached, &acc);
+    cecies_ed25519_point_add_cached(&sum, &sum, &cached, 1);
+
+    for (int d = 0; d < 3; ++d)
+    {
+        cecies_ed25519_point_double(&sum);
+    }
+
+    cecies_ed25519_fe_sub(sum.Y, sum.Y, sum.Z);
+    return cecies_ed25519_fe_iszero(sum.X) && cecies_ed25519_fe_iszero(sum.Y) ? 0 : 1;
+}
+
+int cecies_curve25519_fixed_base(const uint8_t scalar[32], uint8_t u[32])
+{
+    cecies_ed25519_point p;
+    cecies_ed25519_fe n, d;
+
+    // Top bit ignored, just like X25519 (RFC 7748) does.
+    uint8_t k[32];
+    memcpy(k, scalar, sizeof(k));
+    k[31] &= 0x7f;
+
+    cecies_ed25519_scalarmult_base(&p, k, sizeof(k));
+
+    // The birational map to Curve25519: u = (1 + y) / (1 - y) = (Z + Y) / (Z - Y).
+    cecies_ed25519_fe_add(n, p.Z, p.Y);
+    cecies_ed25519_fe_sub(d, p.Z, p.Y);
+    cecies_ed25519_fe_invert(d, d);
+    cecies_ed25519_fe_mul(n, n, d);
+    cecies_ed25519_fe_tobytes(u, n);
+
+    mbedtls_platform_zeroize(&p, sizeof(p));
+    mbedtls_platform_zeroize(n, sizeof(n));
+    mbedtls_platform_zeroize(d, sizeof(d));
+    mbedtls_platform_zeroize(k, sizeof(k));
+    return 0;
+}
+
+int cecies_curve448_fixed_base(const uint8_t scalar[56], uint8_t u[56])
+{
+#ifdef CECIES_EDWARDS
+    cecies_ed448_point p;
+    uint64_t n[8], d[8];
+
+    cecies_ed448_scalarmult_base(&p, scalar, 56);
+
+    // The 4-isogeny to Curve448 (which maps the edwards448 base point to u = 5): u = y^2 / x^2 = Y^2 / X^2.
+    cecies_ed448_fe_sqr(n, p.Y);
+    cecies_ed448_fe_sqr(d, p.X);
+    cecies_ed448_fe_invert(d, d);
+    cecies_ed448_fe_mul(n, n, d);
+    cecies_ed448_fe_tobytes(u, n);
+
+    mbedtls_platform_zeroize(&p, sizeof(p));
+    mbedtls_platform_zeroize(n, sizeof(n));
+    mbedtls_platform_zeroize(d, sizeof(d));
+    return 0;
+#else
+    (void)scalar;
+    (void)u;
+    return MBEDTLS_ERR_ECP_FEATURE_UNAVAILABLE;
+#endif
+}
+
+int cecies_ecp_gen_keypair(mbedtls_ecp_group* group, mbedtls_mpi* d, mbedtls_ecp_point* Q, int (*f_rng)(void*, unsigned char*, size_t), void* p_rng)
+{
+#ifdef CECIES_EDWARDS
+    const int fixed_base = group->id == MBEDTLS_ECP_DP_CURVE25519 || group->id == MBEDTLS_ECP_DP_CURVE448;
+#else
+    const int fixed_base = group->id == MBEDTLS_ECP_DP_CURVE25519;
+#endif
+
+    if (fixed_base)
+    {
+        const size_t length = group->id == MBEDTLS_ECP_DP_CURVE25519 ? 32 : 56;
+
+        uint8_t k[56];
+        uint8_t u[56];
+
+        // Same (RFC 7748 clamped) private key as mbedtls_ecp_gen_keypair() would generate; only the public key computation differs.
+        int ret = mbedtls_ecp_gen_privkey(group, d, f_rng, p_rng);
+
+        if (ret == 0)
+        {
+            ret = mbedtls_mpi_write_binary_le(d, k, length);
+        }
+
+        if (ret == 0)
+        {
+            ret = length == 32 ? cecies_curve25519_fixed_base(k, u) : cecies_curve448_fixed_base(k, u);
+        }
+
+        if (ret == 0)
+        {
+            ret = mbedtls_ecp_point_read_binary(group, Q, u, length);
+        }
+
+        mbedtls_platform_zeroize(k, sizeof(k));
+        mbedtls_platform_zeroize(u, sizeof(u));
+        return ret;
+    }
+
+    return mbedtls_ecp_gen_keypair(group, d, Q, f_rng, p_rng);
+}
@@ -0,0 +1,356 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef CECIES_EDWARDS_BASE_TABLES_H
+#define CECIES_EDWARDS_BASE_TABLES_H
+
+/*
+ * Precomputed multiples of the Ed25519 and edwards448 (RFC 7748, section 4.2) base points for the fixed-base comb in edwards_impl.h.
+ * Entry [m][j] is the affine point (j + 1) * 2^(32 * m) * B, stored as { x, y, d * x * y } in the field element limbs of edwards.c
+ * (5 limbs of 51 bits for Ed25519, or 10 limbs of alternately 26 and 25 bits for its portable field; 8 limbs of 56 bits for edwards448), every limb fully reduced.
+ * This file is generated: do not edit it by hand.
+ */
+
+#ifdef CECIES_ED25519_WIDE
+
+static const uint64_t cecies_ed25519_base_table[8][8][3][5] = {
+    {
+        { { 0x62d608f25d51a, 0x412a4b4f6592a, 0x75b7171a4b31d, 0x1ff60527118fe, 0x216936d3cd6e5 }, { 0x6666666666658, 0x4cccccccccccc, 0x1999999999999, 0x3333333333333, 0x6666666666666 }, { 0x48902c3bd5534, 0x23ccaac49eabc, 0x286b3184db3d0, 0x16a1686df72f7, 0x3788bdb44f863 } },
+        { { 0x5a14e2843ce0e, 0x0a2baf48bf078, 0x0cf9eb0203639, 0x2361e821dbe8c, 0x36ab384c9f5a0 }, { 0x746ae6af8a3c9, 0x22c870a2ac1cb, 0x6887d5a5ce43d, 0x4e10ed12f7464, 0x2260cdf309232 }, { 0x55459d2cdbd26, 0x5d5d9acf7843f, 0x67ad4626d82d7, 0x2dcd403e82102, 0x780d7ad89f528 } },
+        { { 0x2485fd3f8e25c, 0x3302c4910d58c, 0x36b20e98d0e60, 0x7a48ffa573a1f, 0x67ae9c4a22928 }, { 0x3684878f5b4d4, 0x2ece480608058, 0x09a7bde7c5bb0, 0x4d5d09350c730, 0x1267b1d177ee6 }, { 0x7499f86e86c3b, 0x221c35da6214a, 0x1e5b698b12846, 0x531b45c395163, 0x6d141357895cd } },
+        { { 0x2a657c4c9f870, 0x03279c2a8e927, 0x0d483e469ce7b, 0x0a34192ea5c3d, 0x203da8db56cff }, { 0x0ab61ca32112f, 0x65d45e1fe1be7, 0x355c5b133c8a0, 0x2f0a3875c42c0, 0x47d0e827cb159 }, { 0x1fdf4e23b7f7b, 0x457b5cc1725a1, 0x0568928dd3c72, 0x78ad776f73e44, 0x7fce865fb1aa9 } },
+        { { 0x09cc0322ef233, 0x727c37c34b228, 0x4b6977970a067, 0x43dfe77be7be8, 0x49fda73eade35 }, { 0x21f83d676c8ed, 0x15128616ba21a, 0x6491998c4a0bb, 0x737f016370a44, 0x5f4825b298fea }, { 0x5edf8c0954139, 0x07d0bdd1fcbcb, 0x77b4e5a4e1c10, 0x5a6ad06d9c2c6, 0x61d55f34b59dd } },
+        { { 0x2741a7dcbf23d, 0x04d8f6884ef07, 0x428a6fa879666, 0x00e315756606e, 0x4c9797ba7a456 }, { 0x27ad0f9497ef4, 0x0d289ad6c183a, 0x53df5dfe505f0, 0x4508edb84d3fe, 0x054de3fc2886d }, { 0x61933817525af, 0x0341a1bb0185a, 0x07782897ce1c0, 0x078d4f92892c2, 0x485c748d4f86b } },
+        { { 0x5981af50e4107, 0x6777e39d2ab0a, 0x476041e0fa027, 0x6a774f1f70ca5, 0x14568685fcf4b }, { 0x4c4b59f4062b8, 0x0def57e47a258, 0x4dab507c220ad, 0x297c3e732346e, 0x31c563e32b47d }, { 0x1b6e400dc59d1, 0x47053ea49af18, 0x0ef5be76606be, 0x429d4a7106e96, 0x3d4fdd8e3507c } },
+        { { 0x7fdbc08a584c8, 0x7700d31732770, 0x13b3e4faceb19, 0x0db214316ae7c, 0x6742e15f97d77 }, { 0x75ba9fc37b9b4, 0x78c43dc9263c5, 0x22bce3e05e0f3, 0x1bcb756b784b3, 0x21d30600c9e57 }, { 0x0faece4d1488d, 0x788bcca7d7e7c, 0x56c54657146e2, 0x3a558d9048643, 0x13483e2e17662 } },
+    },
+    {
+        { { 0x797a46abc0cbb, 0x20e5bcde5b262, 0x0ca003cb02070, 0x462eed5ea13b4, 0x4d1e116d13615 }, { 0x61efb10c9b91a, 0x76bd149709e89, 0x4023e310fa12d, 0x2db2e6289aa5a, 0x6d415be49d4e3 }, { 0x106db38bc5929, 0x79d51ed16076d, 0x7c822e00e3869, 0x0d9bd8a92882c, 0x3e6b411a9e7ff } },
+        { { 0x2148248127d15, 0x658297a8659a8, 0x3e38bb230a985, 0x3eedf71ca2292, 0x4b5bae5a77a86 }, { 0x3b8de209a77cb, 0x4af7181f41b24, 0x19d0bb2dabb2e, 0x090cc3ad22c07, 0x739476e0b3847 }, { 0x5d867a5232818, 0x4115c577abd16, 0x156833bf492d6, 0x204a0b3eba2bd, 0x10ee5c5303541 } },
+        { { 0x67e5a18ecc8f9, 0x0f8e7374be3e2, 0x20b53c6b986ae, 0x278281c2d3acc, 0x28e01e9eebe62 }, { 0x682a0a58a68c1, 0x6d36c8bc54f6e, 0x5c412374e86d3, 0x14db149d3e0d5, 0x34a3ef2080894 }, { 0x71c06984ff0bc, 0x26b9e165c7706, 0x35c4156dd605b, 0x5b755eeeea65f, 0x5d213b119560c } },
+        { { 0x33f232869fcdf, 0x3be66e4877f0b, 0x2a26341ac8b54, 0x789f0837fe7b6, 0x33bfa90cc1b9d }, { 0x5824fb2da81d9, 0x03a5e21302873, 0x405f4b7d2b3bc, 0x572cfd2fff884, 0x53b120db6327c }, { 0x0eccd22dadaf5, 0x691b3a7924cf6, 0x07c7d130c1309, 0x2c7b9cc02464c, 0x5cf9327ea0a80 } },
+        { { 0x70b4a1110cc99, 0x77b444058d29e, 0x29aecabcdb38a, 0x64388b7fb4166, 0x6759a4f961d6a }, { 0x43f61ecf8af35, 0x4c0b7c2cc6794, 0x000db52c40468, 0x263d92c8908b0, 0x7e6c7c2dca5f4 }, { 0x5c4fc6718c9e5, 0x56a125c0bbe72, 0x439fd069a2066, 0x09c81066a4f4b, 0x517cc00558ce7 } },
+        { { 0x434a9ade80267, 0x1b8f55022be1a, 0x1339dd7aa521d, 0x0f3c3b487024a, 0x56bec70310915 }, { 0x66b33ec86fb32, 0x60d9f59056a25, 0x5c4301739f91d, 0x4666e532b5a79, 0x6ab2ddd075077 }, { 0x3ac554ce4a646, 0x6fb000b807fa2, 0x3b4a7244600de, 0x46afef4a4776b, 0x28410a7d2ba5e } },
+        { { 0x3d6530a7c82bc, 0x4f6bd651a0841, 0x0a7158c176b82, 0x33ed6f9d40bd0, 0x4bbefbdc2c608 }, { 0x63f6849538107, 0x420e11412a081, 0x0f9d3deb0d51f, 0x6e4bce8e72ee6, 0x6eb85cc89c0c2 }, { 0x088fb49d7283b, 0x5f1dfd54a6548, 0x622bcca3b5c43, 0x525048923243c, 0x2ecfe8afc6f3f } },
+        { { 0x0222bc0b9efc6, 0x386b66e0e23c1, 0x3da69124805ea, 0x6814de0caac58, 0x444929347c2de }, { 0x42aff2e1d6245, 0x181af64b48423, 0x695f23ff0e456, 0x5eb22d1928f3e, 0x77785ec5cbbda }, { 0x3808af5436106, 0x4b6c46d1256d4, 0x4cc031133156f, 0x680f5de0cad4e, 0x2286c0e74837d } },
+    },
+    {
+        { { 0x36b8ff4eda202, 0x7daa346bd67c1, 0x2822a5801e36d, 0x4eaea25b067da, 0x6222bd88bf2df }, { 0x6fa5782e45313, 0x117520560d1e3, 0x06df13d5042d8, 0x012eeb5ed7693, 0x0325bb42ea4ed }, { 0x7720282ae7347, 0x681251ad29969, 0x4fb482a6d794e, 0x4ae8e86bd45ea, 0x456b92ed94f65 } },
+        { { 0x2aa2d8bdba597, 0x337727e412228, 0x682a0453a101b, 0x262572fd31592, 0x023bc7abc84cb }, { 0x511df0f29c9ee, 0x1e58c41b9ddb0, 0x5c81ba413e52e, 0x58a64a8101b8e, 0x4d2b97a739ece }, { 0x69b1b020a8b8f, 0x118998483bc32, 0x128a2219a57de, 0x15861c29bab74, 0x05e65db951543 } },
+        { { 0x7640e33263467, 0x4d99d421b1000, 0x229877cb2a32a, 0x020e2cd45a4e5, 0x132a065edb5c4 }, { 0x5fa3e1dd7de2f, 0x3863fd1d4b30c, 0x7973f46ce42c3, 0x3c03b16b5bdc2, 0x534ef70a3532f }, { 0x37d18b1b431e1, 0x48572d33f2158, 0x13d5df80fed18, 0x1c053dcf327de, 0x16a171084756a } },
+        { { 0x633fbbd39d169, 0x2de1deb9e1897, 0x1cb211e5ff1a1, 0x252cc055229db, 0x6d5066cf7137b }, { 0x347115219a417, 0x68445d52b6b96, 0x2e0615fe54802, 0x3e441d5f1ad5f, 0x54bb8cd82a0a8 }, { 0x45d328e2d959a, 0x6c311b1b80813, 0x0626b610ce36d, 0x4781effc32c6f, 0x7a2e97fd4e067 } },
+        { { 0x2429c7b04c2cd, 0x1f7334164ea0e, 0x2e82a3d8f00c4, 0x49a3fac10ad3a, 0x35ff8f7cdb086 }, { 0x49cbaa6ce8b8a, 0x2fbfc351521f8, 0x6ed81ad386d5c, 0x782aa34f434a9, 0x50e1cc6871155 }, { 0x12ec38c994ca5, 0x35ceb1dab05b7, 0x56f940a646a39, 0x07ddf71055276, 0x2c6f6c3093c76 } },
+        { { 0x2120a622e0213, 0x4928e70b4255e, 0x20ca395004af1, 0x137b5a74383cd, 0x6c6365c17f4bb }, { 0x1499e5494c782, 0x54c171a7d6061, 0x2a7b2382370cc, 0x4b4641905002b, 0x1c5703a9d3d1a }, { 0x69f7761f7e2bd, 0x17d4ff481177e, 0x34ce39609c0aa, 0x7953a8f5e8ffc, 0x090319da4a3e7 } },
+        { { 0x44c675bd887d1, 0x309183c31e772, 0x1f3aa0d1e7794, 0x2965c1800a0df, 0x68b818a50b31d }, { 0x0e4dfed398826, 0x2a6b5bb8ee8e5, 0x5b63d0e5a1659, 0x35914773a6ba9, 0x1e8b233ec0076 }, { 0x4a2602e74cbfa, 0x64b05c51a3ff7, 0x4ed08f8aeba7b, 0x6a7d60ce07f56, 0x16c39f6f3d7b6 } },
+        { { 0x3e8be859362a9, 0x285b6b601c94e, 0x277aacb4ea942, 0x6a71a039dbb31, 0x6b66159ac8702 }, { 0x61a22c8ca96c5, 0x0644c063cebfd, 0x110cae7398c22, 0x282724d9d2eac, 0x19dd4bef38efd }, { 0x55efa4ba611d7, 0x259dce46930de, 0x535745954de14, 0x58341080b2e28, 0x658a219b1683c } },
+    },
+    {
+        { { 0x45ceb3b5775d0, 0x71709f92a0ac2, 0x2a7d6afd28c7a, 0x64b6d414a0a90, 0x51f4ff8c599b1 }, { 0x406b0d7863ac1, 0x700fa97a36ff0, 0x14bbad2c4ba01, 0x0f9fb7ccd771c, 0x35ac9588d46e4 }, { 0x347811c4f2fe4, 0x02cf8de43ba83, 0x2824c87208676, 0x04debe87f5771, 0x1f47f41e81978 } },
+        { { 0x29b6a71bf9741, 0x1dccd7f1e7d8e, 0x149a0be95a5b0, 0x31fb1e040b0ec, 0x568de690133ca }, { 0x5b123773039e8, 0x7e9ae87c7a37f, 0x03996d0e96eb9, 0x323a0ee6e219d, 0x4c48220992e8e }, { 0x4ede03866e8cb, 0x0b6c7d8a9a623, 0x68024c0c1fd15, 0x797ace211ef3a, 0x0482683dc3bbc } },
+        { { 0x206c8b59f5785, 0x4df5e07e8f3f6, 0x5f659be6ec6a7, 0x3193a84b2d27c, 0x4f2f4b477f6ca }, { 0x0269d9359e934, 0x4b847999e4a90, 0x4118b05ab8e14, 0x21cd0b6990453, 0x13115f873b8a8 }, { 0x23a4e2dd14ad0, 0x5bca37d25af83, 0x79262d5ad28f8, 0x32b19bc4ee9f9, 0x2b5ed791c6da0 } },
+        { { 0x30cc4663403da, 0x61f36a4978dce, 0x48df3d3a54a05, 0x10ef7a35c4fee, 0x3342c4717d552 }, { 0x5c6a85b6937c5, 0x0cd0dcc3f9493, 0x1f7499c735fa9, 0x29b46aa6678fd, 0x50676cdf00c93 }, { 0x63b247fea6706, 0x7054ac8c1cf4e, 0x2126af9c08bd5, 0x2166234896087, 0x61d930ee4d75a } },
+        { { 0x30fb8f1eccccb, 0x283e91bedd33f, 0x2235667e8bf41, 0x7685498387edd, 0x282a400973b64 }, { 0x62dd27aa84686, 0x23c1862a18fea, 0x31aff366b3a83, 0x549acae4ff00d, 0x5a8a95d8ceddb }, { 0x0aae59468c6f9, 0x46186ce508b4a, 0x1048713d5988c, 0x50431273d24db, 0x13d36404d72e9 } },
+        { { 0x29d9ed297dbd3, 0x1d030c6eca418, 0x7c356254aecce, 0x106a1f2de6054, 0x7aaf48f59f15c }, { 0x1896bf1a58d6e, 0x11d1c1269b58d, 0x798b78e2a3c2b, 0x1c61b0a4e31df, 0x2765ba6a9e766 }, { 0x766fc9c85f0e8, 0x44728ce3f159e, 0x529e1e9528440, 0x50da0a247199e, 0x3d8efa5b9c487 } },
+        { { 0x5979baa2329b4, 0x19a93ef8737a9, 0x46e5644cdd17d, 0x1aae72fc62ac4, 0x0336498fbd2b4 }, { 0x08a7c5dd5cbd8, 0x25ffe91b3543c, 0x26c427ebf83f5, 0x673f2258e1bcb, 0x653338b616279 }, { 0x0aec2950c0c3d, 0x5386ddacd7dbb, 0x7ed8905e7c955, 0x073d12eb8a043, 0x2367a6239ed78 } },
+        { { 0x3a45d29424d9a, 0x77229b1550ded, 0x48807bcdb7f49, 0x19eac75c6e662, 0x3396978bfc50b }, { 0x0ca4ac8073393, 0x794fbb7b5763a, 0x41f332d14fab1, 0x13ee5ce9adfc8, 0x5ccf1359113c1 }, { 0x62292ef9006a2, 0x56bfca674a1c2, 0x3068060b8765b, 0x1c58281f9ec78, 0x74d0cc73278e7 } },
+    },
+    {
+        { { 0x047ae60b7e824, 0x1385ce47cbf90, 0x538a682639a17, 0x1964a969cc270, 0x4c27afff3c45f }, { 0x2bd114bf5a66b, 0x3ca349893cb77, 0x30a70ea4342f8, 0x43ecaf88f5b13, 0x5f2c99e6526dc }, { 0x40a69356e4e7f, 0x3f8b48dd0b789, 0x2f38c14783756, 0x5a4f683f87ffe, 0x22346f16be16e } },
+        { { 0x7d1b43224e085, 0x651f7f44d3f9d, 0x1f5bb93da54b1, 0x57bd040abfbc8, 0x786be30733efd }, { 0x30712c63e2736, 0x7d673ad37c9d5, 0x3f4211ca9f022, 0x42d9a138766ea, 0x653a5f772f349 }, { 0x263446f561165, 0x77bbae1ff81a9, 0x2b2b01f720cdd, 0x32a222b630e23, 0x2c794d5ff3cf9 } },
+        { { 0x5ca89f193c7c7, 0x190eadb296624, 0x613c26eba92eb, 0x28e517e9d52c5, 0x09c186afb8339 }, { 0x49a357f7b062f, 0x577daa9fe2346, 0x61928780aa0a9, 0x1a9c9a34ad8a4, 0x6137b0746027b }, { 0x0012284e35444, 0x134b558973322, 0x066513fa5c06c, 0x063e0f88d88cf, 0x380f92dd86576 } },
+        { { 0x022f04c2eaa13, 0x57d69a3366d97, 0x72376731a9341, 0x499efc4abc0ad, 0x21fee4804968a }, { 0x0d3e930901700, 0x7512e5846260c, 0x2160ce6f694d9, 0x28ea0b62ed0a8, 0x500b7740072cb }, { 0x784a1cdc02d11, 0x376242abfc0c3, 0x045268dd09d16, 0x43b1a4505fcd7, 0x474dce5d8a277 } },
+        { { 0x1e3a2b12d4f17, 0x4b2e7932aa923, 0x22727a3b68433, 0x0415c09f01b2e, 0x4a2e1f96eee4e }, { 0x4b832ac846fc4, 0x22e66b4cc889a, 0x77c36a3708a79, 0x62dc64a88c45f, 0x6c3f24822e185 }, { 0x60ba1f95e460a, 0x7cb5856c3b9e3, 0x14ff72e5db44d, 0x491332e0bc39a, 0x20b3d2735e2c9 } },
+        { { 0x1449ec0ec3464, 0x54da0a6d415e8, 0x27490d51894c3, 0x3a33578cadec3, 0x5dbd3bf95494d }, { 0x4e1c737e25b77, 0x54f6f73f1826f, 0x264aae68d0b38, 0x5d8431e6c6054, 0x56f5f77776e9f }, { 0x2c8f74340eb66, 0x1ced85a753cdc, 0x10111079c0421, 0x1793b5d217056, 0x08bb7e3716ff3 } },
+        { { 0x0badc76ed5685, 0x35fa4ebc2326e, 0x5dc73aed63804, 0x1e078f96abefc, 0x4b3702044575d }, { 0x027acd289b820, 0x1f5f99c524904, 0x581aabf8db72c, 0x17a97a13d4072, 0x54333c50acf33 }, { 0x260cce9839a75, 0x3631165cd660a, 0x6b3052a81810b, 0x034788ccf88fd, 0x2797d6808b5c8 } },
+        { { 0x7136e1146b3df, 0x59e3baac9c516, 0x25223e30d62b6, 0x5b57250cc032f, 0x77fe8a5d490af }, { 0x5c5afa5f50246, 0x7c146a8b74dae, 0x48636448ab327, 0x18b45600199ca, 0x3c530f01e039f }, { 0x17e684ff53ebe, 0x14b0935cf6915, 0x650b8809502d9, 0x4edc963a6aa91, 0x085c4e5302144 } },
+    },
+    {
+        { { 0x3945652014031, 0x31dca5551450b, 0x2aad73634142b, 0x5fbc3dbd51c17, 0x543d84cb04fb2 }, { 0x32ba4de59ef20, 0x293485d85cdd2, 0x0ac9d611bd0b7, 0x24f349ec1c78c, 0x0358fdc5b63ed }, { 0x55c2185107077, 0x0d24f0ec47f71, 0x5c5dda3e726cb, 0x0f873dd426a1b, 0x7ee21f1aee155 } },
+        { { 0x0e1fb4f605ea1, 0x68129eaa3ed4e, 0x0060718d8ce56, 0x25a521392830c, 0x02ac4c0386a42 }, { 0x74860d7de3877, 0x4aa9ff50e9e00, 0x487eddffd0cc3, 0x2f23583d97f83, 0x01a36c19fc30e }, { 0x78c62d483f1e3, 0x1dce4c6359c1d, 0x4037692af666e, 0x74bb29c114d2c, 0x7fbcc11fce186 } },
+        { { 0x3a6db62a039e9, 0x7947312005e76, 0x0b93d668de230, 0x74f0a829607a2, 0x2d2dd667a240f }, { 0x0791506554dd1, 0x22b97071b6edd, 0x6fc323592bbf4, 0x42913dd36a31c, 0x377bd9db79c5d }, { 0x1eb50adbe9483, 0x20d53a82352eb, 0x348ba8f6169ed, 0x51b1c55b390e2, 0x438d3e85670c1 } },
+        { { 0x283d3ac2cc513, 0x014a0bee52f90, 0x75bd156187ed8, 0x5cdb2e84c8617, 0x2816f8430d466 }, { 0x1b17e74b47f1e, 0x0cc956b4309f1, 0x319ab821d177c, 0x51c1a92648778, 0x5452c4b45430e }, { 0x06bf5827414a6, 0x252f50f37d07f, 0x62f31ae21b630, 0x1477a546a68c5, 0x77ad4d3991565 } },
+        { { 0x46a6fba4bbef3, 0x7f7379b4035b8, 0x582fec791fd1e, 0x2d67d8ac3c282, 0x1caeba6f06a2c }, { 0x56a7be98d85b8, 0x018d77ab3a72c, 0x0977146a47b06, 0x2bba507e77aa1, 0x65fcdc11e7ea7 }, { 0x24542eef286cd, 0x4e0fb9a249efa, 0x23dedb2433444, 0x6cd3e8247c776, 0x35aebb65f5235 } },
+        { { 0x0f5d51935a5c7, 0x04a699191958a, 0x374259f1ae7a4, 0x77a6462756390, 0x060c2952bf5ad }, { 0x04b4205427f5b, 0x636039548e695, 0x07ef77cacb315, 0x124bbe329edd8, 0x10ef5d4944825 }, { 0x70ccb99db04b1, 0x34d8abe133288, 0x323a07c49f8e5, 0x41d52047dfb42, 0x1fc0f1c5c7b86 } },
+        { { 0x537b4701f0c00, 0x22b2dd12588b4, 0x1d947e640b8d6, 0x4aa8b50afee60, 0x5d41698923f4e }, { 0x64780eef8bc11, 0x64fba820ef8a6, 0x60a63f7922bb8, 0x1745f6d6f5785, 0x2d92794a28e9f }, { 0x607e299b71245, 0x19c331cfd96f0, 0x3ddfc38e8bdbc, 0x7afbcb5bf4002, 0x493e0ac5f87d0 } },
+        { { 0x489c13fdc9fe9, 0x7f2183c84ee88, 0x7d337b8f29d2b, 0x40b31bfca128e, 0x0cc495fe64bc4 }, { 0x606036e75198b, 0x27c71834ded4b, 0x50deae783c8a3, 0x3bf7f6069f334, 0x42138e7b6cab9 }, { 0x1da913062ecb1, 0x7ceb41b0b8fee, 0x3ecca78a06a5d, 0x0db62022b0c2a, 0x5816c969029c9 } },
+    },
+    {
+        { { 0x2d644c7dad28d, 0x43703afa4db6f, 0x1f85df5ea777b, 0x73e16c6821b8e, 0x1bc7af1e38185 }, { 0x2f65900314833, 0x24c6364e1f95e, 0x57701247409f8, 0x797bd2f77c3bc, 0x61d909d855661 }, { 0x78ca9e1daed3b, 0x7321119e9bd40, 0x564b2c03b58de, 0x2d2c0f318087f, 0x2d2fc43f41b3a } },
+        { { 0x1938218028354, 0x6bb1b54fa00f3, 0x6e28f67cbea25, 0x4b5e9141aad35, 0x06bce245f8c25 }, { 0x4955188a3c065, 0x161bd0f1292df, 0x1d521630b2506, 0x6d06495669788, 0x3d26989cdd0f6 }, { 0x71f8376d37090, 0x5199a13ac0387, 0x44c7022ce603a, 0x26faf56b63e0d, 0x7510f366a7eaf } },
+        { { 0x589041b29662f, 0x1d6fbadddcfd7, 0x1fff2d032c3bc, 0x2f7b21e1d64e1, 0x7665908aaf444 }, { 0x3a00e4b704ca1, 0x71715f4826e10, 0x40ad025948864, 0x2a3670bfc0327, 0x4ed18a7c50da4 }, { 0x58446af7c3c7c, 0x5c610937e5a6d, 0x342dd70a4f1e1, 0x05e6b00d27498, 0x4757d81bc8729 } },
+        { { 0x5954e6c16d4f7, 0x7ca457221ebb3, 0x69398c394d173, 0x554841a79f99d, 0x0a09b36eb5a04 }, { 0x2eb0fa35ed926, 0x49a86e7641e74, 0x3b54cf41b3a7b, 0x085125b7595d7, 0x3aa47fd60fa31 }, { 0x144dcddd2a1f7, 0x1d5ac971429cf, 0x726c155e6ec1d, 0x1e3c760b97193, 0x316a910dbfca3 } },
+        { { 0x4d5451113735e, 0x2574dcfa41233, 0x55926182e858b, 0x6b540645ad45f, 0x1c71ce37638e6 }, { 0x0fee129e406cb, 0x7e88f52e59c7d, 0x2833edf503460, 0x166921edd6bcd, 0x7880cc1c2003b }, { 0x0bf6e12d96bf1, 0x5b99b53040df7, 0x7da98c443f2e1, 0x24fb6a48d2df0, 0x6f391b2e3df70 } },
+        { { 0x39e7f74cbc8d6, 0x08d90a5963263, 0x70b3f944839e5, 0x7bec4bd417c4a, 0x3c607a84c1df2 }, { 0x79a86ba3cea68, 0x42e6340c19d4e, 0x76fb861261f82, 0x51d11c25d5a44, 0x34518ad109941 }, { 0x089e2aa889626, 0x3a9a881fcdbe5, 0x4a0768ecd1084, 0x01291199de157, 0x071a1cc7a5032 } },
+        { { 0x2f417ffbe2da0, 0x4d4c71c738621, 0x5bbdfc4e85ff1, 0x6331ffc9c6eb0, 0x089b6cd02000b }, { 0x016f13e8ceb88, 0x4f9b762547cf1, 0x72995f90f2f92, 0x7ec5a1c6f7e88, 0x66ef7206aa36d }, { 0x0091efedbd94d, 0x61a21ab291e34, 0x3cd293c90f72f, 0x7a5fe659f40bf, 0x3c06f3976469e } },
+        { { 0x6b2d6fc2c9fdb, 0x5b0e0cf4a45c3, 0x1de41b4adca18, 0x6b07c3d5aa1a3, 0x079e9d5b60917 }, { 0x1381c04c78797, 0x79470b8eb0720, 0x2fe8895900193, 0x5229893654a28, 0x16512951d2240 }, { 0x5df0d77a8caca, 0x77917b15edaf5, 0x5cbb45c291824, 0x219ca647dfede, 0x633e900dfc6e9 } },
+    },
+    {
+        { { 0x03c41cb05dc3f, 0x4732705808479, 0x71ccb4fe555a3, 0x66f2e8dea7d5f, 0x75d942c04210d }, { 0x5c4874e35ab2d, 0x5a8f4848cf2ec, 0x45cc72fce38fe, 0x09e47ebf162bb, 0x696cc14856cdc }, { 0x1b88b14bdfa3d, 0x22d4f06834b90, 0x52d7b8d53a276, 0x20d7865c555d1, 0x567c527448eaf } },
+        { { 0x0a57b885fae14, 0x48bd176421bf2, 0x6483f528f0c5c, 0x6bb56ad0c8d30, 0x6d12e0dd1cd8b }, { 0x4a3028f70bd8e, 0x6fb588ceb49a4, 0x015e96e043c83, 0x3c01505c1b392, 0x0d5c9e4b74fde }, { 0x4fec6b54d779b, 0x3e5b3db90b7d0, 0x33d7fa9e1dcc1, 0x50753086d4b14, 0x7008d56fe2a2c } },
+        { { 0x39f2d199b0017, 0x689cd6da39047, 0x04ee67cfea426, 0x44f62eac8c288, 0x7d04264e36e88 }, { 0x3319ae930f866, 0x2b7f27fb1bc34, 0x68ccfeaf09e3c, 0x13fce3bbcbc54, 0x6cc9f269424b8 }, { 0x7aa94594c3cdc, 0x3cd47e9092d1e, 0x13e46a5ba355c, 0x07c449f811086, 0x4aacb59d72b88 } },
+        { { 0x3fba21f5fd594, 0x5a41f0680fc3d, 0x60684b418c206, 0x0d78588e79b4a, 0x16c1556c9a2bc }, { 0x335745ef14f36, 0x3d719e23ae502, 0x5ced6e016ce4f, 0x7c48f0cd6f5f4, 0x23e38cd5158b0 }, { 0x09c5f951982f1, 0x0fa2e926c32cc, 0x293a5d690b07f, 0x0db020eac6895, 0x597e55372343d } },
+        { { 0x11af2b10518f5, 0x1b54232605b64, 0x63b6355b3ae8c, 0x0634abcb5fe74, 0x1723bcb3e1d15 }, { 0x689807682b3ea, 0x769004a1eaadc, 0x1faf5e2abddd7, 0x591a01cc06d86, 0x5d4ba682e08eb }, { 0x579a2d5b64b8e, 0x729943731f3f4, 0x68830dbc511d6, 0x0a4ccd65aa280, 0x3da48b803f6b3 } },
+        { { 0x70fe618e77933, 0x09554f402b26a, 0x57a55d0c13eff, 0x5807222ada534, 0x456bdf4c7423e }, { 0x50b42c46c2997, 0x2e6936b85381b, 0x1d18e01e71f42, 0x43e15d81bc772, 0x579782c36c68e }, { 0x11966d15a72aa, 0x42115d187fc20, 0x3a8f3b33da1fa, 0x3130baaed2f9f, 0x016385fa95b47 } },
+        { { 0x6a339f4412193, 0x50756eb9eb0a5, 0x1767916351622, 0x1089da2b5dd8b, 0x2269a46cdf0aa }, { 0x68f85514c514e, 0x7083ffbf804f6, 0x0b87e873a8780, 0x3f90dc508ecec, 0x489cf3771fa99 }, { 0x478256fb151e0, 0x6f076da45db6c, 0x3e1a5527de001, 0x3eba7272e5612, 0x0e61bfa1a20d9 } },
+        { { 0x3804bb683be22, 0x3733debc4886d, 0x00cee3497f2a2, 0x5bb4af39f15ca, 0x66e632db15cc9 }, { 0x2d6a6134af084, 0x38fdec0e8d27f, 0x1239e9bd979b5, 0x660c87ff50378, 0x534e3c9c194cc }, { 0x2a889716d3564, 0x31b1e851edd2d, 0x58ce4c5d37a06, 0x1742581d1b763, 0x02c88dcfb77be } },
+    },
+};
+
+#else
+
+static const uint32_t cecies_ed25519_base_table[8][8][3][10] = {
+    {
+        { { 0x325d51a, 0x18b5823, 0x0f6592a, 0x104a92d, 0x1a4b31d, 0x1d6dc5c, 0x27118fe, 0x07fd814, 0x13cd6e5, 0x085a4db }, { 0x2666658, 0x1999999, 0x0cccccc, 0x1333333, 0x1999999, 0x0666666, 0x3333333, 0x0cccccc, 0x2666666, 0x1999999 }, { 0x3bd5534, 0x12240b0, 0x049eabc, 0x08f32ab, 0x04db3d0, 0x0a1acc6, 0x2df72f7, 0x05a85a1, 0x344f863, 0x0de22f6 } },
+        { { 0x043ce0e, 0x168538a, 0x08bf078, 0x028aebd, 0x0203639, 0x033e7ac, 0x21dbe8c, 0x08d87a0, 0x0c9f5a0, 0x0daace1 }, { 0x2f8a3c9, 0x1d1ab9a, 0x22ac1cb, 0x08b21c2, 0x25ce43d, 0x1a21f56, 0x12f7464, 0x13843b4, 0x3309232, 0x0898337 }, { 0x2cdbd26, 0x1551674, 0x0f7843f, 0x175766b, 0x26d82d7, 0x19eb518, 0x3e82102, 0x0b73500, 0x189f528, 0x1e035eb } },
+        { { 0x3f8e25c, 0x09217f4, 0x110d58c, 0x0cc0b12, 0x18d0e60, 0x0dac83a, 0x2573a1f, 0x1e923fe, 0x0a22928, 0x19eba71 }, { 0x0f5b4d4, 0x0da121e, 0x0608058, 0x0bb3920, 0x27c5bb0, 0x0269ef7, 0x350c730, 0x1357424, 0x1177ee6, 0x0499ec7 }, { 0x2e86c3b, 0x1d267e1, 0x1a6214a, 0x08870d7, 0x0b12846, 0x0796da6, 0x0395163, 0x14c6d17, 0x17895cd, 0x1b4504d } },
+        { { 0x0c9f870, 0x0a995f1, 0x2a8e927, 0x00c9e70, 0x069ce7b, 0x03520f9, 0x2ea5c3d, 0x028d064, 0x1b56cff, 0x080f6a3 }, { 0x232112f, 0x02ad872, 0x1fe1be7, 0x1975178, 0x133c8a0, 0x0d5716c, 0x35c42c0, 0x0bc28e1, 0x27cb159, 0x11f43a0 }, { 0x23b7f7b, 0x07f7d38, 0x01725a1, 0x115ed73, 0x0dd3c72, 0x015a24a, 0x2f73e44, 0x1e2b5dd, 0x1fb1aa9, 0x1ff3a19 } },
+        { { 0x22ef233, 0x027300c, 0x034b228, 0x1c9f0df, 0x170a067, 0x12da5de, 0x3be7be8, 0x10f7f9d, 0x3eade35, 0x127f69c }, { 0x276c8ed, 0x087e0f5, 0x16ba21a, 0x0544a18, 0x0c4a0bb, 0x1924666, 0x2370a44, 0x1cdfc05, 0x3298fea, 0x17d2096 }, { 0x0954139, 0x17b7e30, 0x11fcbcb, 0x01f42f7, 0x24e1c10, 0x1ded396, 0x2d9c2c6, 0x169ab41, 0x34b59dd, 0x187557c } },
+        { { 0x1cbf23d, 0x09d069f, 0x084ef07, 0x01363da, 0x2879666, 0x10a29be, 0x356606e, 0x0038c55, 0x3a7a456, 0x1325e5e }, { 0x1497ef4, 0x09eb43e, 0x16c183a, 0x034a26b, 0x3e505f0, 0x14f7d77, 0x384d3fe, 0x11423b6, 0x3c2886d, 0x015378f }, { 0x17525af, 0x1864ce0, 0x3b0185a, 0x00d0686, 0x17ce1c0, 0x01de0a2, 0x12892c2, 0x01e353e, 0x0d4f86b, 0x12171d2 } },
+        { { 0x10e4107, 0x16606bd, 0x1d2ab0a, 0x19ddf8e, 0x20fa027, 0x11d8107, 0x1f70ca5, 0x1a9dd3c, 0x05fcf4b, 0x0515a1a }, { 0x34062b8, 0x1312d67, 0x247a258, 0x037bd5f, 0x3c220ad, 0x136ad41, 0x332346e, 0x0a5f0f9, 0x232b47d, 0x0c7158f }, { 0x0dc59d1, 0x06db900, 0x249af18, 0x11c14fa, 0x36606be, 0x03bd6f9, 0x3106e96, 0x10a7529, 0x0e3507c, 0x0f53f76 } },
+        { { 0x0a584c8, 0x1ff6f02, 0x1732770, 0x1dc034c, 0x3aceb19, 0x04ecf93, 0x316ae7c, 0x036c850, 0x1f97d77, 0x19d0b85 }, { 0x037b9b4, 0x1d6ea7f, 0x09263c5, 0x1e310f7, 0x205e0f3, 0x08af38f, 0x2b784b3, 0x06f2dd5, 0x00c9e57, 0x0874c18 }, { 0x0d1488d, 0x03ebb39, 0x27d7e7c, 0x1e22f32, 0x17146e2, 0x15b1519, 0x1048643, 0x0e95636, 0x2e17662, 0x04d20f8 } },
+    },
+    {
+        { { 0x2bc0cbb, 0x1e5e91a, 0x1e5b262, 0x08396f3, 0x0b02070, 0x032800f, 0x1ea13b4, 0x118bbb5, 0x2d13615, 0x1347845 }, { 0x0c9b91a, 0x187bec4, 0x1709e89, 0x1daf452, 0x10fa12d, 0x1008f8c, 0x289aa5a, 0x0b6cb98, 0x249d4e3, 0x1b5056f }, { 0x0bc5929, 0x041b6ce, 0x116076d, 0x1e7547b, 0x00e3869, 0x1f208b8, 0x292882c, 0x0366f62, 0x1a9e7ff, 0x0f9ad04 } },
+        { { 0x0127d15, 0x0852092, 0x28659a8, 0x1960a5e, 0x230a985, 0x0f8e2ec, 0x1ca2292, 0x0fbb7dc, 0x1a77a86, 0x12d6eb9 }, { 0x09a77cb, 0x0ee3788, 0x1f41b24, 0x12bdc60, 0x2dabb2e, 0x06742ec, 0x2d22c07, 0x024330e, 0x20b3847, 0x1ce51db }, { 0x1232818, 0x17619e9, 0x37abd16, 0x1045715, 0x3f492d6, 0x055a0ce, 0x3eba2bd, 0x081282c, 0x1303541, 0x043b971 } },
+        { { 0x0ecc8f9, 0x19f9686, 0x34be3e2, 0x03e39cd, 0x2b986ae, 0x082d4f1, 0x02d3acc, 0x09e0a07, 0x1eebe62, 0x0a3807a }, { 0x18a68c1, 0x1a0a829, 0x3c54f6e, 0x1b4db22, 0x34e86d3, 0x171048d, 0x1d3e0d5, 0x0536c52, 0x2080894, 0x0d28fbc }, { 0x04ff0bc, 0x1c701a6, 0x25c7706, 0x09ae785, 0x2dd605b, 0x0d71055, 0x2eea65f, 0x16dd57b, 0x119560c, 0x17484ec } },
+        { { 0x069fcdf, 0x0cfc8ca, 0x0877f0b, 0x0ef99b9, 0x1ac8b54, 0x0a898d0, 0x37fe7b6, 0x1e27c20, 0x0cc1b9d, 0x0cefea4 }, { 0x2da81d9, 0x16093ec, 0x1302873, 0x00e9788, 0x3d2b3bc, 0x1017d2d, 0x2fff884, 0x15cb3f4, 0x1b6327c, 0x14ec483 }, { 0x2dadaf5, 0x03b3348, 0x3924cf6, 0x1a46ce9, 0x30c1309, 0x01f1f44, 0x002464c, 0x0b1ee73, 0x3ea0a80, 0x173e4c9 } },
+        { { 0x110cc99, 0x1c2d284, 0x058d29e, 0x1ded110, 0x3cdb38a, 0x0a6bb2a, 0x3fb4166, 0x190e22d, 0x3961d6a, 0x19d6693 }, { 0x0f8af35, 0x10fd87b, 0x2cc6794, 0x1302df0, 0x2c40468, 0x00036d4, 0x08908b0, 0x098f64b, 0x2dca5f4, 0x1f9b1f0 }, { 0x318c9e5, 0x1713f19, 0x00bbe72, 0x15a8497, 0x29a2066, 0x10e7f41, 0x26a4f4b, 0x0272041, 0x0558ce7, 0x145f300 } },
+        { { 0x1e80267, 0x10d2a6b, 0x022be1a, 0x06e3d54, 0x3aa521d, 0x04ce775, 0x087024a, 0x03cf0ed, 0x0310915, 0x15afb1c }, { 0x086fb32, 0x19accfb, 0x1056a25, 0x18367d6, 0x339f91d, 0x1710c05, 0x32b5a79, 0x1199b94, 0x1075077, 0x1aacb77 }, { 0x0e4a646, 0x0eb1553, 0x3807fa2, 0x1bec002, 0x04600de, 0x0ed29c9, 0x0a4776b, 0x11abfbd, 0x3d2ba5e, 0x0a10429 } },
+        { { 0x27c82bc, 0x0f594c2, 0x11a0841, 0x13daf59, 0x0176b82, 0x029c563, 0x1d40bd0, 0x0cfb5be, 0x1c2c608, 0x12efbef }, { 0x1538107, 0x18fda12, 0x012a081, 0x1083845, 0x2b0d51f, 0x03e74f7, 0x0e72ee6, 0x1b92f3a, 0x089c0c2, 0x1bae173 }, { 0x1d7283b, 0x0223ed2, 0x14a6548, 0x17c77f5, 0x23b5c43, 0x188af32, 0x123243c, 0x1494122, 0x2fc6f3f, 0x0bb3fa2 } },
+        { { 0x0b9efc6, 0x0088af0, 0x20e23c1, 0x0e1ad9b, 0x24805ea, 0x0f69a44, 0x0caac58, 0x1a05378, 0x347c2de, 0x11124a4 }, { 0x21d6245, 0x10abfcb, 0x0b48423, 0x0606bd9, 0x3f0e456, 0x1a57c8f, 0x1928f3e, 0x17ac8b4, 0x05cbbda, 0x1dde17b }, { 0x1436106, 0x0e022bd, 0x11256d4, 0x12db11b, 0x133156f, 0x13300c4, 0x20cad4e, 0x1a03d77, 0x274837d, 0x08a1b03 } },
+    },
+    {
+        { { 0x0eda202, 0x0dae3fd, 0x2bd67c1, 0x1f6a8d1, 0x001e36d, 0x0a08a96, 0x1b067da, 0x13aba89, 0x08bf2df, 0x1888af6 }, { 0x2e45313, 0x1be95e0, 0x160d1e3, 0x045d481, 0x15042d8, 0x01b7c4f, 0x1ed7693, 0x004bbad, 0x02ea4ed, 0x00c96ed }, { 0x2ae7347, 0x1dc80a0, 0x2d29969, 0x1a04946, 0x26d794e, 0x13ed20a, 0x2bd45ea, 0x12ba3a1, 0x2d94f65, 0x115ae4b } },
+        { { 0x3dba597, 0x0aa8b62, 0x2412228, 0x0cddc9f, 0x13a101b, 0x1a0a811, 0x3d31592, 0x09895cb, 0x2bc84cb, 0x008ef1e }, { 0x329c9ee, 0x14477c3, 0x1b9ddb0, 0x0796310, 0x013e52e, 0x17206e9, 0x0101b8e, 0x162992a, 0x2739ece, 0x134ae5e }, { 0x20a8b8f, 0x1a6c6c0, 0x083bc32, 0x0462661, 0x19a57de, 0x04a2888, 0x29bab74, 0x0561870, 0x3951543, 0x0179976 } },
+        { { 0x3263467, 0x1d9038c, 0x21b1000, 0x1366750, 0x0b2a32a, 0x08a61df, 0x145a4e5, 0x00838b3, 0x1edb5c4, 0x04ca819 }, { 0x1d7de2f, 0x17e8f87, 0x1d4b30c, 0x0e18ff4, 0x2ce42c3, 0x1e5cfd1, 0x2b5bdc2, 0x0f00ec5, 0x0a3532f, 0x14d3bdc }, { 0x1b431e1, 0x0df462c, 0x33f2158, 0x1215cb4, 0x00fed18, 0x04f577e, 0x0f327de, 0x07014f7, 0x084756a, 0x05a85c4 } },
+        { { 0x139d169, 0x18cfeef, 0x39e1897, 0x0b7877a, 0x25ff1a1, 0x072c847, 0x15229db, 0x094b301, 0x0f7137b, 0x1b5419b }, { 0x219a417, 0x0d1c454, 0x12b6b96, 0x1a11175, 0x3e54802, 0x0b81857, 0x1f1ad5f, 0x0f91075, 0x182a0a8, 0x152ee33 }, { 0x22d959a, 0x1174ca3, 0x1b80813, 0x1b0c46c, 0x10ce36d, 0x0189ad8, 0x3c32c6f, 0x11e07bf, 0x3d4e067, 0x1e8ba5f } },
+        { { 0x304c2cd, 0x090a71e, 0x164ea0e, 0x07dccd0, 0x18f00c4, 0x0ba0a8f, 0x010ad3a, 0x1268feb, 0x3cdb086, 0x0d7fe3d }, { 0x2ce8b8a, 0x1272ea9, 0x11521f8, 0x0beff0d, 0x1386d5c, 0x1bb606b, 0x0f434a9, 0x1e0aa8d, 0x2871155, 0x1438731 }, { 0x0994ca5, 0x04bb0e3, 0x1ab05b7, 0x0d73ac7, 0x2646a39, 0x15be502, 0x1055276, 0x01f77dc, 0x3093c76, 0x0b1bdb0 } },
+        { { 0x22e0213, 0x0848298, 0x0b4255e, 0x124a39c, 0x1004af1, 0x08328e5, 0x34383cd, 0x04ded69, 0x017f4bb, 0x1b18d97 }, { 0x094c782, 0x0526795, 0x27d6061, 0x15305c6, 0x02370cc, 0x0a9ec8e, 0x105002b, 0x12d1906, 0x29d3d1a, 0x0715c0e }, { 0x1f7e2bd, 0x1a7ddd8, 0x081177e, 0x05f53fd, 0x209c0aa, 0x0d338e5, 0x35e8ffc, 0x1e54ea3, 0x1a4a3e7, 0x0240c67 } },
+        { { 0x3d887d1, 0x11319d6, 0x031e772, 0x0c2460f, 0x11e7794, 0x07cea83, 0x000a0df, 0x0a59706, 0x250b31d, 0x1a2e062 }, { 0x1398826, 0x03937fb, 0x38ee8e5, 0x0a9ad6e, 0x25a1659, 0x16d8f43, 0x33a6ba9, 0x0d6451d, 0x3ec0076, 0x07a2c8c }, { 0x274cbfa, 0x128980b, 0x11a3ff7, 0x192c171, 0x0aeba7b, 0x13b423e, 0x0e07f56, 0x1a9f583, 0x2f3d7b6, 0x05b0e7d } },
+        { { 0x19362a9, 0x0fa2fa1, 0x201c94e, 0x0a16dad, 0x34ea942, 0x09deab2, 0x39dbb31, 0x1a9c680, 0x1ac8702, 0x1ad9856 }, { 0x0ca96c5, 0x18688b2, 0x23cebfd, 0x0191301, 0x3398c22, 0x04432b9, 0x19d2eac, 0x0a09c93, 0x2f38efd, 0x067752f }, { 0x3a611d7, 0x157be92, 0x06930de, 0x0967739, 0x154de14, 0x14d5d16, 0x00b2e28, 0x160d042, 0x1b1683c, 0x1962886 } },
+    },
+    {
+        { { 0x35775d0, 0x1173ace, 0x12a0ac2, 0x1c5c27e, 0x3d28c7a, 0x0a9f5ab, 0x14a0a90, 0x192db50, 0x0c599b1, 0x147d3fe }, { 0x3863ac1, 0x101ac35, 0x3a36ff0, 0x1c03ea5, 0x2c4ba01, 0x052eeb4, 0x0cd771c, 0x03e7edf, 0x08d46e4, 0x0d6b256 }, { 0x04f2fe4, 0x0d1e047, 0x243ba83, 0x00b3e37, 0x3208676, 0x0a09321, 0x07f5771, 0x0137afa, 0x1e81978, 0x07d1fd0 } },
+        { { 0x1bf9741, 0x0a6da9c, 0x31e7d8e, 0x077335f, 0x295a5b0, 0x052682f, 0x040b0ec, 0x0c7ec78, 0x10133ca, 0x15a379a }, { 0x33039e8, 0x16c48dd, 0x3c7a37f, 0x1fa6ba1, 0x0e96eb9, 0x00e65b4, 0x26e219d, 0x0c8e83b, 0x0992e8e, 0x1312088 }, { 0x066e8cb, 0x13b780e, 0x0a9a623, 0x02db1f6, 0x0c1fd15, 0x1a00930, 0x211ef3a, 0x1e5eb38, 0x3dc3bbc, 0x01209a0 } },
+        { { 0x19f5785, 0x081b22d, 0x3e8f3f6, 0x137d781, 0x26ec6a7, 0x17d966f, 0x0b2d27c, 0x0c64ea1, 0x077f6ca, 0x13cbd2d }, { 0x359e934, 0x009a764, 0x19e4a90, 0x12e11e6, 0x1ab8e14, 0x10462c1, 0x2990453, 0x087342d, 0x073b8a8, 0x04c457e }, { 0x1d14ad0, 0x08e938b, 0x125af83, 0x16f28df, 0x1ad28f8, 0x1e498b5, 0x04ee9f9, 0x0cac66f, 0x11c6da0, 0x0ad7b5e } },
+        { { 0x23403da, 0x0c33119, 0x0978dce, 0x187cda9, 0x3a54a05, 0x1237cf4, 0x35c4fee, 0x043bde8, 0x317d552, 0x0cd0b11 }, { 0x36937c5, 0x171aa16, 0x03f9493, 0x0334373, 0x0735fa9, 0x07dd267, 0x26678fd, 0x0a6d1aa, 0x1f00c93, 0x1419db3 }, { 0x3ea6706, 0x18ec91f, 0x0c1cf4e, 0x1c152b2, 0x1c08bd5, 0x0849abe, 0x0896087, 0x085988d, 0x2e4d75a, 0x18764c3 } },
+        { { 0x1eccccb, 0x0c3ee3c, 0x3edd33f, 0x0a0fa46, 0x3e8bf41, 0x088d599, 0x0387edd, 0x1da1526, 0x0973b64, 0x0a0a900 }, { 0x2a84686, 0x18b749e, 0x2a18fea, 0x08f0618, 0x26b3a83, 0x0c6bfcd, 0x24ff00d, 0x1526b2b, 0x18ceddb, 0x16a2a57 }, { 0x068c6f9, 0x02ab965, 0x2508b4a, 0x11861b3, 0x3d5988c, 0x04121c4, 0x33d24db, 0x1410c49, 0x04d72e9, 0x04f4d90 } },
+        { { 0x297dbd3, 0x0a767b4, 0x2eca418, 0x0740c31, 0x14aecce, 0x1f0d589, 0x2de6054, 0x041a87c, 0x359f15c, 0x1eabd23 }, { 0x1a58d6e, 0x0625afc, 0x269b58d, 0x0474704, 0x22a3c2b, 0x1e62de3, 0x24e31df, 0x07186c2, 0x2a9e766, 0x09d96e9 }, { 0x085f0e8, 0x1d9bf27, 0x23f159e, 0x111ca33, 0x1528440, 0x14a787a, 0x247199e, 0x1436828, 0x1b9c487, 0x0f63be9 } },
+        { { 0x22329b4, 0x165e6ea, 0x38737a9, 0x066a4fb, 0x0cdd17d, 0x11b9591, 0x3c62ac4, 0x06ab9cb, 0x0fbd2b4, 0x00cd926 }, { 0x1d5cbd8, 0x0229f17, 0x1b3543c, 0x097ffa4, 0x2bf83f5, 0x09b109f, 0x18e1bcb, 0x19cfc89, 0x3616279, 0x194cce2 }, { 0x10c0c3d, 0x02bb0a5, 0x2cd7dbb, 0x14e1b76, 0x1e7c955, 0x1fb6241, 0x2b8a043, 0x01cf44b, 0x239ed78, 0x08d9e98 } },
+        { { 0x1424d9a, 0x0e9174a, 0x1550ded, 0x1dc8a6c, 0x0db7f49, 0x12201ef, 0x1c6e662, 0x067ab1d, 0x0bfc50b, 0x0ce5a5e }, { 0x0073393, 0x03292b2, 0x3b5763a, 0x1e53eed, 0x114fab1, 0x107cccb, 0x29adfc8, 0x04fb973, 0x19113c1, 0x1733c4d }, { 0x39006a2, 0x188a4bb, 0x274a1c2, 0x15aff29, 0x0b8765b, 0x0c1a018, 0x1f9ec78, 0x07160a0, 0x33278e7, 0x1d34331 } },
+    },
+    {
+        { { 0x0b7e824, 0x011eb98, 0x07cbf90, 0x04e1739, 0x2639a17, 0x14e29a0, 0x29cc270, 0x06592a5, 0x3f3c45f, 0x1309ebf }, { 0x3f5a66b, 0x0af4452, 0x093cb77, 0x0f28d26, 0x24342f8, 0x0c29c3a, 0x08f5b13, 0x10fb2be, 0x26526dc, 0x17cb267 }, { 0x16e4e7f, 0x1029a4d, 0x1d0b789, 0x0fe2d23, 0x0783756, 0x0bce305, 0x3f87ffe, 0x1693da0, 0x16be16e, 0x088d1bc } },
+        { { 0x224e085, 0x1f46d0c, 0x04d3f9d, 0x1947dfd, 0x3da54b1, 0x07d6ee4, 0x0abfbc8, 0x15ef410, 0x0733efd, 0x1e1af8c }, { 0x23e2736, 0x0c1c4b1, 0x137c9d5, 0x1f59ceb, 0x0a9f022, 0x0fd0847, 0x38766ea, 0x10b6684, 0x372f349, 0x194e97d }, { 0x3561165, 0x098d11b, 0x1ff81a9, 0x1deeeb8, 0x3720cdd, 0x0acac07, 0x3630e23, 0x0ca888a, 0x1ff3cf9, 0x0b1e535 } },
+        { { 0x193c7c7, 0x172a27c, 0x3296624, 0x0643ab6, 0x2ba92eb, 0x184f09b, 0x29d52c5, 0x0a3945f, 0x2fb8339, 0x027061a }, { 0x37b062f, 0x1268d5f, 0x1fe2346, 0x15df6aa, 0x00aa0a9, 0x1864a1e, 0x34ad8a4, 0x06a7268, 0x346027b, 0x184dec1 }, { 0x0e35444, 0x00048a1, 0x0973322, 0x04d2d56, 0x3a5c06c, 0x019944f, 0x08d88cf, 0x018f83e, 0x1d86576, 0x0e03e4b } },
+        { { 0x02eaa13, 0x008bc13, 0x3366d97, 0x15f5a68, 0x31a9341, 0x1c8dd9c, 0x0abc0ad, 0x1267bf1, 0x004968a, 0x087fb92 }, { 0x0901700, 0x034fa4c, 0x046260c, 0x1d44b96, 0x2f694d9, 0x0858339, 0x22ed0a8, 0x0a3a82d, 0x00072cb, 0x1402ddd }, { 0x1c02d11, 0x1e12873, 0x2bfc0c3, 0x0dd890a, 0x1d09d16, 0x01149a3, 0x105fcd7, 0x10ec691, 0x1d8a277, 0x11d3739 } },
+        { { 0x12d4f17, 0x078e8ac, 0x32aa923, 0x12cb9e4, 0x3b68433, 0x089c9e8, 0x1f01b2e, 0x0105702, 0x16eee4e, 0x128b87e }, { 0x0846fc4, 0x12e0cab, 0x0cc889a, 0x08b99ad, 0x3708a79, 0x1df0da8, 0x288c45f, 0x18b7192, 0x022e185, 0x1b0fc92 }, { 0x15e460a, 0x182e87e, 0x2c3b9e3, 0x1f2d615, 0x25db44d, 0x053fdcb, 0x20bc39a, 0x1244ccb, 0x335e2c9, 0x082cf49 } },
+        { { 0x0ec3464, 0x05127b0, 0x2d415e8, 0x1536829, 0x11894c3, 0x09d2435, 0x0cadec3, 0x0e8cd5e, 0x395494d, 0x176f4ef }, { 0x3e25b77, 0x13871cd, 0x3f1826f, 0x153dbdc, 0x28d0b38, 0x0992ab9, 0x26c6054, 0x17610c7, 0x3776e9f, 0x15bd7dd }, { 0x340eb66, 0x0b23dd0, 0x2753cdc, 0x073b616, 0x39c0421, 0x0404441, 0x1217056, 0x05e4ed7, 0x3716ff3, 0x022edf8 } },
+        { { 0x2ed5685, 0x02eb71d, 0x3c2326e, 0x0d7e93a, 0x2d63804, 0x1771ceb, 0x16abefc, 0x0781e3e, 0x044575d, 0x12cdc08 }, { 0x289b820, 0x009eb34, 0x0524904, 0x07d7e67, 0x38db72c, 0x1606aaf, 0x13d4072, 0x05ea5e8, 0x10acf33, 0x150ccf1 }, { 0x1839a75, 0x098333a, 0x1cd660a, 0x0d8c459, 0x281810b, 0x1acc14a, 0x0cf88fd, 0x00d1e23, 0x008b5c8, 0x09e5f5a } },
+        { { 0x146b3df, 0x1c4db84, 0x2c9c516, 0x1678eea, 0x30d62b6, 0x09488f8, 0x0cc032f, 0x16d5c94, 0x1d490af, 0x1dffa29 }, { 0x1f50246, 0x1716be9, 0x0b74dae, 0x1f051aa, 0x08ab327, 0x1218d91, 0x00199ca, 0x062d158, 0x01e039f, 0x0f14c3c }, { 0x3f53ebe, 0x05f9a13, 0x1cf6915, 0x052c24d, 0x09502d9, 0x1942e20, 0x3a6aa91, 0x13b7258, 0x1302144, 0x0217139 } },
+    },
+    {
+        { { 0x2014031, 0x0e51594, 0x151450b, 0x0c77295, 0x234142b, 0x0aab5cd, 0x3d51c17, 0x17ef0f6, 0x0b04fb2, 0x150f613 }, { 0x259ef20, 0x0cae937, 0x185cdd2, 0x0a4d217, 0x11bd0b7, 0x02b2758, 0x2c1c78c, 0x093cd27, 0x05b63ed, 0x00d63f7 }, { 0x1107077, 0x1570861, 0x2c47f71, 0x03493c3, 0x3e726cb, 0x1717768, 0x1426a1b, 0x03e1cf7, 0x1aee155, 0x1fb887c } },
+        { { 0x3605ea1, 0x0387ed3, 0x2a3ed4e, 0x1a04a7a, 0x0d8ce56, 0x00181c6, 0x392830c, 0x0969484, 0x0386a42, 0x00ab130 }, { 0x3de3877, 0x1d21835, 0x10e9e00, 0x12aa7fd, 0x3fd0cc3, 0x121fb77, 0x3d97f83, 0x0bc8d60, 0x19fc30e, 0x0068db0 }, { 0x083f1e3, 0x1e318b5, 0x2359c1d, 0x0773931, 0x2af666e, 0x100dda4, 0x0114d2c, 0x1d2eca7, 0x1fce186, 0x1fef304 } },
+        { { 0x2a039e9, 0x0e9b6d8, 0x2005e76, 0x1e51cc4, 0x28de230, 0x02e4f59, 0x29607a2, 0x1d3c2a0, 0x27a240f, 0x0b4b759 }, { 0x2554dd1, 0x01e4541, 0x31b6edd, 0x08ae5c1, 0x192bbf4, 0x1bf0c8d, 0x136a31c, 0x10a44f7, 0x1b79c5d, 0x0ddef67 }, { 0x1be9483, 0x07ad42b, 0x02352eb, 0x08354ea, 0x36169ed, 0x0d22ea3, 0x1b390e2, 0x146c715, 0x05670c1, 0x10e34fa } },
+        { { 0x02cc513, 0x0a0f4eb, 0x2e52f90, 0x005282f, 0x2187ed8, 0x1d6f455, 0x04c8617, 0x1736cba, 0x030d466, 0x0a05be1 }, { 0x0b47f1e, 0x06c5f9d, 0x34309f1, 0x033255a, 0x21d177c, 0x0c66ae0, 0x2648778, 0x14706a4, 0x345430e, 0x1514b12 }, { 0x27414a6, 0x01afd60, 0x337d07f, 0x094bd43, 0x221b630, 0x18bcc6b, 0x06a68c5, 0x051de95, 0x3991565, 0x1deb534 } },
+        { { 0x24bbef3, 0x11a9bee, 0x34035b8, 0x1fdcde6, 0x391fd1e, 0x160bfb1, 0x2c3c282, 0x0b59f62, 0x2f06a2c, 0x072bae9 }, { 0x18d85b8, 0x15a9efa, 0x2b3a72c, 0x00635de, 0x2a47b06, 0x025dc51, 0x3e77aa1, 0x0aee941, 0x11e7ea7, 0x197f370 }, { 0x2f286cd, 0x09150bb, 0x2249efa, 0x1383ee6, 0x2433444, 0x08f7b6c, 0x247c776, 0x1b34fa0, 0x25f5235, 0x0d6baed } },
+        { { 0x135a5c7, 0x03d7546, 0x191958a, 0x0129a64, 0x31ae7a4, 0x0dd0967, 0x2756390, 0x1de9918, 0x12bf5ad, 0x01830a5 }, { 0x1427f5b, 0x012d081, 0x148e695, 0x18d80e5, 0x0acb315, 0x01fbddf, 0x329edd8, 0x0492ef8, 0x0944825, 0x043bd75 }, { 0x1db04b1, 0x1c332e6, 0x2133288, 0x0d362af, 0x049f8e5, 0x0c8e81f, 0x07dfb42, 0x1075481, 0x05c7b86, 0x07f03c7 } },
+        { { 0x01f0c00, 0x14ded1c, 0x12588b4, 0x08acb74, 0x240b8d6, 0x07651f9, 0x0afee60, 0x12aa2d4, 0x0923f4e, 0x17505a6 }, { 0x2f8bc11, 0x191e03b, 0x20ef8a6, 0x193eea0, 0x3922bb8, 0x18298fd, 0x16f5785, 0x05d17db, 0x0a28e9f, 0x0b649e5 }, { 0x1b71245, 0x181f8a6, 0x0fd96f0, 0x0670cc7, 0x0e8bdbc, 0x0f77f0e, 0x1bf4002, 0x1ebef2d, 0x05f87d0, 0x124f82b } },
+        { { 0x3dc9fe9, 0x122704f, 0x084ee88, 0x1fc860f, 0x0f29d2b, 0x1f4cdee, 0x3ca128e, 0x102cc6f, 0x3e64bc4, 0x0331257 }, { 0x275198b, 0x18180db, 0x34ded4b, 0x09f1c60, 0x383c8a3, 0x1437ab9, 0x069f334, 0x0efdfd8, 0x3b6cab9, 0x1084e39 }, { 0x062ecb1, 0x076a44c, 0x30b8fee, 0x1f3ad06, 0x0a06a5d, 0x0fb329e, 0x22b0c2a, 0x036d880, 0x29029c9, 0x1605b25 } },
+    },
+    {
+        { { 0x3dad28d, 0x0b59131, 0x3a4db6f, 0x10dc0eb, 0x1ea777b, 0x07e177d, 0x2821b8e, 0x1cf85b1, 0x1e38185, 0x06f1ebc }, { 0x0314833, 0x0bd9640, 0x0e1f95e, 0x09318d9, 0x07409f8, 0x15dc049, 0x377c3bc, 0x1e5ef4b, 0x1855661, 0x1876427 }, { 0x1daed3b, 0x1e32a78, 0x1e9bd40, 0x1cc8446, 0x03b58de, 0x1592cb0, 0x318087f, 0x0b4b03c, 0x3f41b3a, 0x0b4bf10 } },
+        { { 0x0028354, 0x064e086, 0x0fa00f3, 0x1aec6d5, 0x3cbea25, 0x1b8a3d9, 0x01aad35, 0x12d7a45, 0x05f8c25, 0x01af389 }, { 0x0a3c065, 0x1255462, 0x31292df, 0x0586f43, 0x30b2506, 0x0754858, 0x1669788, 0x1b41925, 0x1cdd0f6, 0x0f49a62 }, { 0x2d37090, 0x1c7e0dd, 0x3ac0387, 0x1466684, 0x2ce603a, 0x1131c08, 0x2b63e0d, 0x09bebd5, 0x26a7eaf, 0x1d443cd } },
+        { { 0x329662f, 0x1624106, 0x1ddcfd7, 0x075beeb, 0x032c3bc, 0x07ffcb4, 0x21d64e1, 0x0bdec87, 0x0aaf444, 0x1d99642 }, { 0x3704ca1, 0x0e80392, 0x0826e10, 0x1c5c57d, 0x1948864, 0x102b409, 0x3fc0327, 0x0a8d9c2, 0x3c50da4, 0x13b4629 }, { 0x37c3c7c, 0x16111ab, 0x37e5a6d, 0x1718424, 0x0a4f1e1, 0x0d0b75c, 0x0d27498, 0x0179ac0, 0x1bc8729, 0x11d5f60 } },
+        { { 0x016d4f7, 0x165539b, 0x221ebb3, 0x1f2915c, 0x394d173, 0x1a4e630, 0x279f99d, 0x1552106, 0x2eb5a04, 0x02826cd }, { 0x35ed926, 0x0bac3e8, 0x3641e74, 0x126a1b9, 0x01b3a7b, 0x0ed533d, 0x37595d7, 0x0214496, 0x160fa31, 0x0ea91ff }, { 0x1d2a1f7, 0x0513737, 0x31429cf, 0x0756b25, 0x1e6ec1d, 0x1c9b055, 0x0b97193, 0x078f1d8, 0x0dbfca3, 0x0c5aa44 } },
+        { { 0x113735e, 0x1355144, 0x3a41233, 0x095d373, 0x02e858b, 0x1564986, 0x05ad45f, 0x1ad5019, 0x37638e6, 0x071c738 }, { 0x1e406cb, 0x03fb84a, 0x2e59c7d, 0x1fa23d4, 0x3503460, 0x0a0cfb7, 0x2dd6bcd, 0x059a487, 0x1c2003b, 0x1e20330 }, { 0x2d96bf1, 0x02fdb84, 0x3040df7, 0x16e66d4, 0x043f2e1, 0x1f6a631, 0x08d2df0, 0x093eda9, 0x2e3df70, 0x1bce46c } },
+        { { 0x0cbc8d6, 0x0e79fdd, 0x1963263, 0x0236429, 0x04839e5, 0x1c2cfe5, 0x1417c4a, 0x1efb12f, 0x04c1df2, 0x0f181ea }, { 0x23cea68, 0x1e6a1ae, 0x0c19d4e, 0x10b98d0, 0x1261f82, 0x1dbee18, 0x25d5a44, 0x1474470, 0x1109941, 0x0d1462b }, { 0x2889626, 0x02278aa, 0x1fcdbe5, 0x0ea6a20, 0x2cd1084, 0x1281da3, 0x19de157, 0x004a446, 0x07a5032, 0x01c6873 } },
+        { { 0x3be2da0, 0x0bd05ff, 0x0738621, 0x13531c7, 0x0e85ff1, 0x16ef7f1, 0x09c6eb0, 0x18cc7ff, 0x102000b, 0x0226db3 }, { 0x28ceb88, 0x005bc4f, 0x2547cf1, 0x13e6dd8, 0x10f2f92, 0x1ca657e, 0x06f7e88, 0x1fb1687, 0x06aa36d, 0x19bbdc8 }, { 0x2dbd94d, 0x00247bf, 0x3291e34, 0x186886a, 0x090f72f, 0x0f34a4f, 0x19f40bf, 0x1e97f99, 0x176469e, 0x0f01bce } },
+        { { 0x02c9fdb, 0x1acb5bf, 0x34a45c3, 0x16c3833, 0x0adca18, 0x077906d, 0x15aa1a3, 0x1ac1f0f, 0x1b60917, 0x01e7a75 }, { 0x0c78797, 0x04e0701, 0x0eb0720, 0x1e51c2e, 0x1900193, 0x0bfa225, 0x3654a28, 0x148a624, 0x11d2240, 0x05944a5 }, { 0x3a8caca, 0x177c35d, 0x15edaf5, 0x1de45ec, 0x0291824, 0x172ed17, 0x07dfede, 0x0867299, 0x0dfc6e9, 0x18cfa40 } },
+    },
+    {
+        { { 0x305dc3f, 0x00f1072, 0x1808479, 0x11cc9c1, 0x3e555a3, 0x1c732d3, 0x1ea7d5f, 0x19bcba3, 0x004210d, 0x1d7650b }, { 0x235ab2d, 0x17121d3, 0x08cf2ec, 0x16a3d21, 0x3ce38fe, 0x11731cb, 0x3f162bb, 0x02791fa, 0x0856cdc, 0x1a5b305 }, { 0x0bdfa3d, 0x06e22c5, 0x2834b90, 0x08b53c1, 0x153a276, 0x14b5ee3, 0x1c555d1, 0x0835e19, 0x3448eaf, 0x159f149 } },
+        { { 0x05fae14, 0x0295ee2, 0x2421bf2, 0x122f45d, 0x28f0c5c, 0x1920fd4, 0x10c8d30, 0x1aed5ab, 0x1d1cd8b, 0x1b44b83 }, { 0x370bd8e, 0x128c0a3, 0x0eb49a4, 0x1bed623, 0x2043c83, 0x0057a5b, 0x1c1b392, 0x0f00541, 0x0b74fde, 0x0357279 }, { 0x14d779b, 0x13fb1ad, 0x390b7d0, 0x0f96cf6, 0x1e1dcc1, 0x0cf5fea, 0x06d4b14, 0x141d4c2, 0x2fe2a2c, 0x1c02355 } },
+        { { 0x19b0017, 0x0e7cb46, 0x1a39047, 0x1a2735b, 0x0fea426, 0x013b99f, 0x2c8c288, 0x113d8ba, 0x0e36e88, 0x1f41099 }, { 0x130f866, 0x0cc66ba, 0x3b1bc34, 0x0adfc9f, 0x2f09e3c, 0x1a333fa, 0x3bcbc54, 0x04ff38e, 0x29424b8, 0x1b327c9 }, { 0x14c3cdc, 0x1eaa516, 0x1092d1e, 0x0f351fa, 0x1ba355c, 0x04f91a9, 0x3811086, 0x01f1127, 0x1d72b88, 0x12ab2d6 } },
+        { { 0x35fd594, 0x0fee887, 0x280fc3d, 0x16907c1, 0x018c206, 0x181a12d, 0x0e79b4a, 0x035e162, 0x2c9a2bc, 0x05b0555 }, { 0x2f14f36, 0x0cd5d17, 0x23ae502, 0x0f5c678, 0x016ce4f, 0x173b5b8, 0x0d6f5f4, 0x1f123c3, 0x15158b0, 0x08f8e33 }, { 0x11982f1, 0x02717e5, 0x26c32cc, 0x03e8ba4, 0x290b07f, 0x0a4e975, 0x2ac6895, 0x036c083, 0x372343d, 0x165f954 } },
+        { { 0x10518f5, 0x046bcac, 0x2605b64, 0x06d508c, 0x1b3ae8c, 0x18ed8d5, 0x0b5fe74, 0x018d2af, 0x33e1d15, 0x05c8ef2 }, { 0x282b3ea, 0x1a2601d, 0x21eaadc, 0x1da4012, 0x2abddd7, 0x07ebd78, 0x0c06d86, 0x1646807, 0x02e08eb, 0x1752e9a }, { 0x1b64b8e, 0x15e68b5, 0x331f3f4, 0x1ca650d, 0x3c511d6, 0x1a20c36, 0x25aa280, 0x0293335, 0x003f6b3, 0x0f6922e } },
+        { { 0x0e77933, 0x1c3f986, 0x002b26a, 0x025553d, 0x0c13eff, 0x15e9574, 0x2ada534, 0x1601c88, 0x0c7423e, 0x115af7d }, { 0x06c2997, 0x142d0b1, 0x385381b, 0x0b9a4da, 0x1e71f42, 0x0746380, 0x01bc772, 0x10f8576, 0x036c68e, 0x15e5e0b }, { 0x15a72aa, 0x04659b4, 0x187fc20, 0x1084574, 0x33da1fa, 0x0ea3cec, 0x2ed2f9f, 0x0c4c2ea, 0x3a95b47, 0x0058e17 } },
+        { { 0x0412193, 0x1a8ce7d, 0x39eb0a5, 0x141d5ba, 0x2351622, 0x05d9e45, 0x2b5dd8b, 0x0422768, 0x2cdf0aa, 0x089a691 }, { 0x14c514e, 0x1a3e154, 0x3f804f6, 0x1c20ffe, 0x33a8780, 0x02e1fa1, 0x108ecec, 0x0fe4371, 0x371fa99, 0x12273cd }, { 0x3b151e0, 0x11e095b, 0x245db6c, 0x1bc1db6, 0x27de001, 0x0f86954, 0x32e5612, 0x0fae9c9, 0x21a20d9, 0x03986fe } },
+        { { 0x283be22, 0x0e012ed, 0x3c4886d, 0x0dccf7a, 0x097f2a2, 0x0033b8d, 0x39f15ca, 0x16ed2bc, 0x1b15cc9, 0x19b98cb }, { 0x34af084, 0x0b5a984, 0x0e8d27f, 0x0e3f7b0, 0x3d979b5, 0x048e7a6, 0x3f50378, 0x198321f, 0x1c194cc, 0x14d38f2 }, { 0x16d3564, 0x0aa225c, 0x11edd2d, 0x0c6c7a1, 0x1d37a06, 0x1633931, 0x1d1b763, 0x05d0960, 0x0fb77be, 0x00b2237 } },
+    },
+};
+
+#endif // CECIES_ED25519_WIDE
+
+#ifdef CECIES_EDWARDS
+
+static const uint64_t cecies_ed448_base_table[15][8][3][8] = {
+    {
+        { { 0x26a82bc70cc05e, 0x80e18b00938e26, 0xf72ab66511433b, 0xa3d3a46412ae1a, 0x0f1767ea6de324, 0x36da9e14657047, 0xed221d15a622bf, 0x4f1970c66bed0d }, { 0x08795bf230fa14, 0x132c4ed7c8ad98, 0x1ce67c39c4fdbd, 0x05a0c2d73ad3ff, 0xa3984087789c1e, 0xc7624bea73736c, 0x248876203756c9, 0x693f46716eb6bc }, { 0x6a7c93790d43b1, 0x85ee44c273b40e, 0x961292e5164ae4, 0xf1ce00e83a6626, 0x11129e5cb41037, 0xf4d1b86e904781, 0x675b8a5541c3fa, 0x26afa9e48a9aa1 } },
+        { { 0x55555555555555, 0x55555555555555, 0x55555555555555, 0x55555555555555, 0xaaaaaaaaaaaaa9, 0xaaaaaaaaaaaaaa, 0xaaaaaaaaaaaaaa, 0xaaaaaaaaaaaaaa }, { 0xeafbcdea9386ed, 0xb2bed1cda06bda, 0x833a2a3098bbbc, 0x8ad8c4b80d6565, 0x884dd7b7e36d72, 0xc2b0036ed7a035, 0x8db359d6205086, 0xae05e9634ad704 }, { 0x96d0fd22ea0bcf, 0x414f3022aaa32a, 0xa2580f70aa1fce, 0x79044d81085cc8, 0x2827021c60afc3, 0x8b1b16bb1e4e1e, 0x1f364906945ffc, 0x60181b4cb90600 } },
+        { { 0x28173286ff2f8f, 0xb769465da85757, 0xf7f6271fd6e862, 0x4a3fcfe8daa9cb, 0xda82c7e2ba077a, 0x943332241b8b8c, 0x6455bd64316cb6, 0x0865886b9108af }, { 0x22ac13588ed6fc, 0x9a68fed02dafb8, 0x1bdb6767f0bffa, 0xec4e1d58bb3a33, 0x56c3b9fce43c82, 0xa6449a4a8d9523, 0xf706cbda7ad43a, 0xe005a8dbd5125c }, { 0xcd3a416e267a3a, 0x884610e5c7d816, 0x7e3e42f4031129, 0x0d31d305649240, 0xacf4198379c2b4, 0xc41bda309ec353, 0x10037a60e8dfc2, 0x4f44d997609bbb } },
+        { { 0xce42ac48ba7f30, 0xe1798949e120e2, 0xf1515dd8ba21ae, 0x70c74cc301b7bd, 0x0891c693fda4be, 0x29ea255a09cf4e, 0x2c1419a17226f9, 0x49dcbc5c6c0cce }, { 0xe236f86de51839, 0x44285d0d4f5b32, 0x7ea1ca9472b5d4, 0x7b8a5bc1c0d8f9, 0x57d845c90dc322, 0x1b979cb7c02f04, 0x27164b33a5de02, 0xd49077e4accde5 }, { 0xaa3dcca72bc254, 0x68c0edd7ca4479, 0x66736e05836578, 0xda10c10469f9a1, 0x571bc5c241d5a3, 0x18eb55672bbca6, 0x642830dbb5826b, 0x16b986789758b7 } },
+        { { 0xa99d1092030034, 0x2d8cefc6f950d0, 0x7a920c3c96f07b, 0x958812808bc0d5, 0x62ada756d761e8, 0x0def80cbcf7285, 0x0e2ba7601eedb5, 0x7a9f9335a48dcb }, { 0xb4731472f435eb, 0x5512881f225443, 0xee59d2b33c5840, 0xb698017127d7a4, 0xb18fced86551f7, 0x0ade260ca1823a, 0xd3b9109ce4fd58, 0xadfd751a2517ed }, { 0x6c3e8e1f5bb305, 0x7034f02b36b2e0, 0x2d67133823c705, 0x3ae3e790f84b33, 0xe6491f542ca451, 0x4b251a66a8a9db, 0x7aae0cf80dce8e, 0x67fe268fc13b32 } },
+        { { 0x7fd7652abef79c, 0x6c20a07443a878, 0x5c1840d12a7109, 0x4a06e4a876451c, 0x3bed0b4ad95f65, 0x25d2e673fb0260, 0x2e00349aebd971, 0x54523e04498b72 }, { 0xea5d1da07c7bcc, 0xcce776938ea98c, 0x80284e861d2b3e, 0x48de76b6e1ff1b, 0x7b121869c58522, 0xbfd053a2765a1a, 0x2d743ec056c667, 0x3f99b9cd8ab61c }, { 0x84b14cf71fd75e, 0x4e1bd5aee29fcd, 0xe919fcc6a06cf6, 0x549ad40bc7849e, 0x4b1939c844442b, 0xae0e1fd148ec5f, 0xfdaeee482cc284, 0x8acfb79c73502c } },
+        { { 0xdf9567ceb5eaf7, 0x110a6b478ac7d7, 0x2d335014706e0b, 0x0df9c7b0b5a209, 0xba4223d568e684, 0xd78af2d8c3719b, 0x77467b9a5291b6, 0x079748e5c89bef }, { 0xe20d3fadac377f, 0x34e866972b5c09, 0xd8687a3c40bbb7, 0x7b3946fd2f84c9, 0xd00e40ca78f50e, 0xb87594417e7179, 0x9c7373bcb23583, 0x7ddeda3c90fd69 }, { 0xfae64438edf0d0, 0x25186aa89f8084, 0xb4bbc907a54de8, 0xe1e5f106f60ee2, 0xdae6ce2338fdd5, 0x340f5f4bcf6588, 0x796abe2815418a, 0x6b8be3ae56f3ca } },
+        { { 0x2538a67153bde0, 0x223aca9406b696, 0xf9080dc1ad713e, 0x6c4cb47d816a64, 0xbc285685dc8b97, 0xd97b037c08e2d7, 0x5b63fb45d0e66b, 0xd1f1bc5520e8a3 }, { 0x4eb873ce69e09b, 0x1663164bc8ee45, 0x08f7003ba8d89f, 0x4b98ead386ad82, 0xa4b93b7bd94c7b, 0x46ba408c6b38b3, 0xdae87d1f3574ff, 0xc7564f4e9bea9b }, { 0x7f1f714f0c4cfe, 0xd33b910b3c56f7, 0x127aeca66779ce, 0xa72daa330ed043, 0x3514d44b9f1668, 0x460aaacbcacd70, 0xffbad390fc827c, 0x46f8fc54e87f0e } },
+    },
+    {
+        { { 0x761c219dd9a54d, 0x1127fcb86a39c0, 0x7d0e4f04c9bedd, 0x27c017a4d976b6, 0x800c973da042cf, 0xe7419af2593f11, 0xbd49448ae67960, 0xd3b60b7744fd85 }, { 0x5e74ed961676fe, 0x7383ef339af627, 0x34407e05e62df7, 0xb0534618bf3196, 0xd6b7184583b407, 0xe3d068555011be, 0x94083d02124b52, 0xa908324f780aaf }, { 0xfd1b6144b8aae0, 0xa98932bb894602, 0xfa6519aa0dfa56, 0x3d7e4e534d9bca, 0x1604c921bec324, 0xa15051066af677, 0x040dc31c5faf19, 0xa17784b53d760e } },
+        { { 0xb27af1a73ec9c3, 0xb66ad9f70fa725, 0x07724f58cf73e4, 0xc3fcd579949358, 0x06efb79da0cc01, 0x1e977d210597c9, 0xcd732be703e8d6, 0x6fd29bf6d0b69e }, { 0xca658ac667128e, 0xca0036ac7872b3, 0xc9698585355837, 0x59f3be8075cf1c, 0x9f1b9b03809a11, 0x6881ced9733871, 0x8cda0fbe902a5f, 0x4d8c69b4e3871e }, { 0x933bc3302c5b4d, 0x26bb490fce5f9c, 0x9b2551df4bd513, 0x5294c6bd742304, 0x3c4e1fed3edfbd, 0xe76de01c04c9f2, 0x1e7e257d876cb8, 0x8c31b967c157ec } },
+        { { 0x5c3bd07ddee82f, 0xe52dd312f9723b, 0xcf8761174f1be8, 0xd9ecbd835f8657, 0x4f77393fbfea17, 0xec9579fd78fe2c, 0x320de920fb0450, 0xbfc9b8d95d9c47 }, { 0x818bd425e1b4c3, 0x0e0c41c40e2c78, 0x0f7ce9abccb0d0, 0xc7e9fa45ef81fb, 0x2561d6f73574ad, 0xa2d8d99d2efb0b, 0xcf8f316e96cd0a, 0x088f0f14964807 }, { 0x94c7a7fe953216, 0x27688c4f277847, 0x2fbfc70eee8237, 0x026b71952d42b4, 0x658f43939126d7, 0xefd117f9b19257, 0x471848f0c34aa3, 0x5fad90042452c7 } },
+        { { 0x0a8498945d5a19, 0x47ab39c6c2131f, 0x5c02824f3fc35d, 0x3be77c89ee8127, 0xa8491b7c90b80a, 0x5397631a28aa93, 0x54d6e816c0b344, 0x22878be876d0e4 }, { 0xeecb8a46db3bf6, 0x340f29554577a3, 0xa7798689a00f85, 0x98465d74bb9147, 0x9532d7dda3c736, 0x6d574f17504b20, 0x6e356f4d86e435, 0x70c2e8d4533887 }, { 0x3101886ab48263, 0x764806997929a2, 0x6ed0245d3cba6e, 0x05d02244fd26af, 0x7b2f871419957f, 0x9e502de6600598, 0xe403905e1a5dcc, 0xe5f63f5b3e4735 } },
+        { { 0xdce5a0ad293980, 0x32d7210069010e, 0x64af59f06deaaa, 0xd6b43c459239e4, 0x74bf2559199c29, 0x3efff4111e1e2b, 0x1aa7b5ecb0f8d8, 0x9baa22b989e395 }, { 0xf78db807b33ac1, 0x05a3b4354ce80a, 0x371defc7bc8e12, 0x63305a01224610, 0x028b1ae6d697ef, 0x7aba39c1cd8051, 0x76ed7a928ee4b4, 0x31bd02a7f99901 }, { 0x4e67a5eb92646d, 0xe8e589742fc3ca, 0xce29b7f842dfd3, 0x2c09988e4b2188, 0x282bfe530e7674, 0x60afefa6e2eed5, 0xb38bb04c61dfbf, 0x073defafe5cb05 } },
+        { { 0xf9dab7af075566, 0x84e29a5f56f18b, 0x3a4c45af64e56d, 0xcf3644a6a7302d, 0xfb40808156b658, 0xf33ef9cf96be52, 0xfe92038caa2f08, 0xcfaf2e3b261894 }, { 0xf2a0dbc224ce3f, 0xed05009592eb27, 0x501743f95889d0, 0xa88a47877c95c2, 0x86755fbdd63da9, 0x9024acfc7ee828, 0x634b020f38113b, 0x3c5aacc6056e64 }, { 0xed8ef2923d6d60, 0x55094f10db8b4f, 0xd12215afde43c2, 0x71e328caf3522f, 0xfbf7a3bb853a53, 0xb2bdbdc56cd132, 0xe51a5b2731c0c7, 0x74ce8cc1f512ce } },
+        { { 0xe03ff3aa2ef760, 0x3b95767b1c3bac, 0x51ce6aa940d754, 0x7cbac3f47a9a3d, 0xa864ac434f8d1a, 0x1eff3f280dbd47, 0xd8ab6607ebd5ca, 0xc4df5c405b07ed }, { 0x3dc92dfa4f095b, 0x5ae36a57cdbd9a, 0x7ff29737891e04, 0x37c03130a5fe7b, 0x210d7b0aa6e35e, 0x6edfb53bf200d8, 0x787b68d84afb85, 0x9b5c49b72c6de3 }, { 0x1311dfcc6d4b09, 0x85f7be93f91279, 0x9b91aa90730ff5, 0x863c6a7738f494, 0x294ffed95eaad5, 0xadbb7dfa8eadd8, 0x1543a243e76478, 0x5cc148e840546b } },
+        { { 0x51857164010f4e, 0xe0b144b0536ebe, 0xacabb14887d663, 0xac1caededf584f, 0xb43fb8faf175a3, 0x310b6d5f992a3c, 0xf2c4aa285178a4, 0x69c99698bd56bf }, { 0x73d6372a4d972e, 0x3d5bb2e9583803, 0x7bf7d18d891581, 0xa5ce5d7568a34a, 0x670b4331f45c81, 0x97265a71f96910, 0xdb14eb3b07c1ea, 0xdf008eafed447c }, { 0x6817d445b03506, 0xe4e3377f50bfac, 0xafa4f110d4d85f, 0x45d658747dda87, 0xf3fa9987c752db, 0xcba3505567eb3f, 0x98267f050c19e7, 0xb220fb7cb36d30 } },
+    },
+    {
+        { { 0x183492f83e882c, 0x4d58203b5e6c12, 0x1ac96c3efec20b, 0xabd5a5be1cd15e, 0x7e1e242cbbb14b, 0x9f03f45d0543b3, 0xc94bc47d678158, 0x7917be0a446cad }, { 0x53f2be29b37394, 0x0cb0a6c064cc76, 0x3a857bcfba3da3, 0xac86bc580fcb49, 0x9d5336e30ab146, 0xafb093d5bc1270, 0x996689de5c3b6e, 0x55189faea076ba }, { 0xc8bf78435dbc45, 0x6c57c2387e0887, 0x1f85c0de6db114, 0x693119ced47bb9, 0x756219cf43bd39, 0x8f1e31bdbad75d, 0x704f62f4d0d122, 0x71aeb60197a95a } },
+        { { 0x99ef986646ce03, 0xa155f8130e6100, 0x75bef1729b6b07, 0xc46f08e1de077b, 0xf52fdc57ed0526, 0xe09d98961a299a, 0x95273297b8e93a, 0x11255b50acd185 }, { 0x57919db4a6acdd, 0x708a5784451d74, 0x5b0bd01283f7b3, 0xe82f40cc3d9260, 0x2ab96ec82bbdc2, 0x921f680c164d87, 0xf0f7883c17a6a9, 0xc366478382a001 }, { 0x78d3619ee2e2d7, 0x9f042c2adcbed7, 0x23a1a6ec2fedf1, 0xf48c41f5dea103, 0xc60f9e6ea31cbb, 0x607885c6f09170, 0xe3f2cc5565b565, 0xdafe1054eb5277 } },
+        { { 0x5c9aa072e40791, 0xf0b72d6a0776bf, 0x445f9b2eaa50dc, 0xa929fa96bda47f, 0x539dc713bbfc49, 0x4f16dd0006a78b, 0x331ba3deef39c7, 0xbfa0a24c34157c }, { 0x0220beb6a3b482, 0x3164d4d6c43885, 0xa03bb5dacdea23, 0xd6b8b5a9d8f450, 0xd218e65bd208fe, 0x43948ed35c476f, 0x29a0dd80a2ed2b, 0xa6ccf3325295b7 }, { 0xda58cd263864cc, 0xe0592d73bdc00b, 0x57ed15fb624c59, 0xefc4d910fc69f3, 0xa684396a0d8e98, 0x023f7780f01599, 0xa35beb7df8857f, 0x029dd9574d3899 } },
+        { { 0xf68f15fac38939, 0xb3dd5a2f8010c1, 0xf7ac290a35f141, 0xdc8f3b27388574, 0x7ec3de1e95fed2, 0xc625451257ac7d, 0x66fc33e664e55a, 0xd3968d34832ba5 }, { 0x980291bc026448, 0xfcb212524da4a5, 0xbca7df4827a360, 0xfcc395c85ca63b, 0xcf566ec8e9f733, 0x835ee9bd465f70, 0xe66d111372f916, 0xc066cf904d9211 }, { 0xb8cefbdcf9291b, 0x977005c2d3f079, 0xb35ceeb5ab3561, 0xe2133de448b273, 0x36d1587eeacb0c, 0x0d24ae4faa7c51, 0xd47b844fc8b43a, 0x1b4883c0bf408d } },
+        { { 0xb9763a38b48818, 0xa6d23cc4288f96, 0xe27fcf5ed3a229, 0x6aebf9cabaff00, 0xf3375038131cd1, 0x13ad41dffabd58, 0x1bee6af861c83b, 0x274fe969c142e7 }, { 0x70ebcc99b84b5b, 0xe1a57d78191cfc, 0x46ccd06cbf00b8, 0xc233e8eefe402d, 0xb4ab215beebeb3, 0xb7424eabd14e7b, 0x351259aa679578, 0x6d6d01e471d684 }, { 0x8bdb179fa7a7d5, 0x94583b958555d1, 0xf814053ca50e17, 0xec4c49869d2a1a, 0xd329e119b387ae, 0xd547c740dce7cc, 0x6fce1e8d8c6fe2, 0x5140895c3bf363 } },
+        { { 0x755c465815ae38, 0xadc3e85611db56, 0x633999b188dd50, 0xfdf7509c12d907, 0x25bcfde238b6af, 0x50d705d397f5e7, 0xb65f60b944c974, 0x8867fc327ac325 }, { 0x2edc4413763eff, 0x892c0b3341fb63, 0xb34b83ab3a7f28, 0x9aa106d15c2f18, 0x720bbc61bb2277, 0x637f72a5cfaefd, 0xf57db6ef43e565, 0xceb7c67b58e772 }, { 0x870a86b67705eb, 0xd06deca78972df, 0xe41ceb53fda6fd, 0xae8bf23f4a0c66, 0x28c3cde093d978, 0xfd9b34a16fb596, 0x027e99c8ebae55, 0x8a08be9d691723 } },
+        { { 0x2793da56ecc1de, 0x4e1097438f31b2, 0x4229b4f8781267, 0xe5d2272dec04a1, 0x6abb463ec17cff, 0x28aaa7e0cbb048, 0x41dc081d22ef85, 0xcbc361e5e63d0f }, { 0xb78aafcad5dbaa, 0x0111505fc1edc3, 0x63ed66d92c7bfa, 0x2982284e468919, 0x30f1f21b8c0d8c, 0xf0567472685093, 0x0e085b6f03dd0f, 0xa8c8db85581e66 }, { 0x283fbc3f88fce9, 0xa853f67b9d397f, 0xf6b22f95b066c9, 0xcea0c70973dd94, 0x71521d720c3b24, 0x1315899a65b624, 0x600a72c3313e92, 0x1e4f2d078ea9ca } },
+        { { 0x42009a6264ad0c, 0x13bf2b8593bef4, 0x1d111905d4e8b1, 0xfe3e940ef7bddc, 0xa012275624e62c, 0xcb659241d6d3cc, 0xc7bcc70edb7ab6, 0xff9fafbb750b1c }, { 0xf65df297fea84b, 0x17c84a890b0e02, 0xa92a859301e821, 0xbee8cb2fb480d1, 0x7010b8c59c604e, 0x47bf3f4e803c43, 0xd64514247b3fff, 0xc4c5dcb9f0da13 }, { 0x32bbf1155d37c8, 0xf4f9f0ffc28f17, 0x783e5fd8616348, 0xa72ff5ac6b36d2, 0xce9a6cd9c84782, 0x214a967f569e2d, 0xd0e32ecbe118c1, 0x69247e764c4469 } },
+    },
+    {
+        { { 0xac087bb07861c5, 0x3bd37db5ae8240, 0x94c68ecf94518f, 0xd32a378ff88a5b, 0x42c8aaf9b441d1, 0x089db70fc07f12, 0x211c386d3d4455, 0x1db9af7546b158 }, { 0xdfd1b6551bc927, 0x69c04930733df4, 0xdc72cd42aeb586, 0xeebdace823aa13, 0x51b3b3c56ad643, 0xb983a99d4e0426, 0xa1e5b6c69c4ecc, 0x37cd38245e6668 }, { 0xba80922c3d285a, 0x6b373d6d846642, 0x837877e7fa41e6, 0x577fae006acec7, 0xca84c5ccc7a837, 0x0b9ad341e19f74, 0x0d7bc7d5a9e706, 0x91cce98fa30f06 } },
+        { { 0x158ce6d9f73aea, 0x36a774914ff475, 0x0d4e424dc0b018, 0xc2c44483946f09, 0x7a7de3ffacda62, 0x49a19e6b486709, 0x65094d8db61da7, 0x09edfd98f5ee87 }, { 0xe460fcfb37226d, 0x3b9d03969bf470, 0x3d4d511247ca22, 0xc7248d6c782cb1, 0x91189a000ad293, 0x1244942e8abe75, 0x9f88d12bf52cdb, 0x368463ebbbcadf }, { 0xdaeea4b2315a44, 0x7da87c43a13d0d, 0x5f27ca99236ad6, 0xb66cd48db64e1b, 0xca760b8dd97fb7, 0xa4fb3fb7cd596d, 0xbc87334a2d3523, 0x59dc250af6cc41 } },
+        { { 0x419e4b38074f45, 0xd3f8e2e0771c83, 0xd2743b42e68d34, 0xc68b7dbb116a00, 0xfad2cf7d84cc37, 0xcfd27c0b7a0f4d, 0x3b9e23f190e587, 0x7bab499751ca9e }, { 0x3270861a8f12ee, 0xee1f38d31b36d5, 0x748bb31e4c0eed, 0x9be5c9b110ebad, 0x728660bc8b6cb6, 0x7bc9df793d914a, 0x73a4f2cc88c859, 0xbe4a2fdb4e7f0e }, { 0xff1143fd3fd31a, 0xb34828b648cd54, 0x112c522e1f71a2, 0x6b835773c4270f, 0x9f8c01654c069e, 0xa34fa41b06d618, 0x1bae3cb1c5f7bc, 0x135aff373a5d0c } },
+        { { 0xe566ff8a450e77, 0xb0b40066a13aba, 0x483a510cd7dc90, 0xb1a20135fa9ccc, 0xeb0b631a80e67c, 0x7c34e1f020801a, 0x0257dc8f4e447c, 0x7abe7d174c6f0f }, { 0xf115a3ab19a576, 0x8f0474a064ca0e, 0x999bb6b351f99b, 0x855254b773edc3, 0x49f6c2f427d717, 0x9f682532e0cef2, 0x1fe126c2ee34f5, 0x1ec2cae80150f7 }, { 0x23bf6de3dfcbfb, 0x85ef628b4a43bd, 0x6779bd2d1c65c9, 0xecd1262a6458bd, 0xe64ea29e26bb72, 0x64168369499219, 0xd69da45186f016, 0xf3e282efc09aa5 } },
+        { { 0x862c5afc005b7a, 0x61adea7ec4ef17, 0xf885fd3007b446, 0x25c129d9b0e30e, 0xbc10f25feec7e0, 0x3901ac4df79ee1, 0xad49db7fe9e19f, 0xc8624d9360d050 }, { 0xc74a576bf3260b, 0xbde80248c010c2, 0xf15532909b6977, 0x6a5a82ed52dcf8, 0x4fbf59d29b9dfc, 0x337d049c7b730c, 0xb3deac63a89cd4, 0x1e07595ad2f2eb }, { 0x32620c760601e4, 0x5496ff8f32159d, 0x05ae181c840217, 0x536942e67cdc96, 0xa37f029cc477e6, 0xc2cc0b7b54c677, 0xdcddc94565a363, 0x8dc0c0f0b155b6 } },
+        { { 0xa0b0a4d3b7c84e, 0xf132c378cf2b00, 0x192814beaaa8ec, 0xe7929f97b4b5df, 0xf08a68e42d0ab7, 0x814afb17b60cdd, 0x78c348c7d9c160, 0xf8a948844db217 }, { 0xcdefd88eaa2578, 0xf717f56bd0e260, 0x7754e131694d02, 0x1254c14181dbd8, 0x0dacdd26e5f312, 0xb8abdfbcef87bf, 0xb985972e74e2ea, 0x1717621002b424 }, { 0x1efff30d74da75, 0xd8c5a8cb7e9dba, 0x57bec8d2c436d9, 0x551bea4fdf47cc, 0x7aff3bd439671d, 0x75331835aa1a67, 0x8f9237a0d21eaa, 0x55593aeb32a443 } },
+        { { 0x92cc75e162df70, 0x1e20c0618ee849, 0xc036b4626aa590, 0x31be67e4da5155, 0x04911b5f7213b0, 0x39261d7bb2e72e, 0x9e844665c015a3, 0x2f59fc0298ae67 }, { 0xa3ea7ba1701fcc, 0x87a5fa90ebd651, 0xa607ed4301d7b1, 0xbd4ec5f3b2e271, 0x732a1a2dc4180f, 0xbe15d82feaa8c1, 0x103670266f2f3f, 0xccfd3979e79ce8 }, { 0x0a850944edfa59, 0x9e66ed4209b441, 0x2ef3b9846fbef7, 0x5f682fecdc1c56, 0xd43c4b0f69aa0a, 0xe107f85778efa5, 0x9c725403d0486c, 0xd713378ab4126e } },
+        { { 0x82ab83570a54ad, 0x5c1dee8e3bec75, 0xf583ff454b556b, 0x9220199f461e60, 0xdf61ca887fc4e7, 0x6641fd20776dad, 0x00c6edd8edd061, 0xaf9b14255f7e87 }, { 0x73f15e49bbe3ec, 0xdd3b788f8bc1fa, 0xb24cc071b8ff86, 0x6c260d241be58b, 0xec1c4e36b10ada, 0xf6b42097fdb985, 0x0d0ac85d47c212, 0x967191c07d78d1 }, { 0xc6d33fbb759a6b, 0x0a14ff0392bcad, 0xf73290923a9a3d, 0x9216b0671d7a11, 0x2b9286bc39a3f3, 0x81248d52fb70ee, 0x8335bf30c44b41, 0xc91ffe14f5f85b } },
+    },
+    {
+        { { 0xd19e8fd423bddf, 0x9d77042387ef59, 0x315cbdd849590a, 0xfdc637c7866c1e, 0x72be83d03515a6, 0xd44a4a00376780, 0x3b9613119e0c2b, 0x023aca37b1a689 }, { 0xf5f368782282ea, 0x44710898a8b5c7, 0xcd2f00a17a3066, 0x754e11281ed681, 0x9c6c70c0bfcefd, 0xd6aced03b6f29b, 0xe443d562817a2a, 0xe590ef4e7c0012 }, { 0xd1e278e43d1bb3, 0xc2425ea433dec1, 0x2b3ca828b0d298, 0x5a22f742f29790, 0x0f914e33c2d71d, 0x1a3d97d6de97fe, 0x766650f7548a04, 0xe3e74e54a0be9c } },
+        { { 0xc2f96763e62e2a, 0x661816eb2daa26, 0x3515fd2dd5f512, 0xdc36e2756b6e75, 0x0bdde4674cc658, 0x102908600e7644, 0xfdf00451694a09, 0x454bcb6ceac169 }, { 0xf4c92ab6481eb6, 0x8b77afa09750e7, 0xe6f42316362d6d, 0x0d45deef53a3ae, 0xdac7aacd7dcf98, 0x628cb7f125ec4a, 0x41e8a20aec0320, 0x7418c7eea2e35b }, { 0x5fe6dbe6b64516, 0x09fce5eafa9df2, 0x6ca4f4ca3e581b, 0x447f5162f92de8, 0x243ca4836cf382, 0x593afe89fc8f8c, 0xa1d50703326809, 0x33271b5710ff5f } },
+        { { 0x4d649abdf40519, 0x8cb22d43525833, 0x15f6d137a5333f, 0x8c3991b72c23ee, 0x248b9a50cd44a3, 0x6b4c4e0ccc1a75, 0x3221efb15c99a9, 0x236d5040a9c504 }, { 0x401c7fbd559100, 0xcf0e07507c524d, 0x39647c034a9275, 0x2355422f7e8683, 0x3e0a16eb3ae670, 0x1c83bcbad61b7f, 0x491bcb19ca6cbe, 0xe668dc45e29458 }, { 0x4bd162bb8b00e3, 0xb50ed013f47cf7, 0x8978713a6882f1, 0x5e78ea9f8e3daf, 0x1ff1a2e72af308, 0x2f65cff3fa5132, 0x983e785a26110c, 0xf14bcf28c77938 } },
+        { { 0xe44c65b219379e, 0x211381bbb607ee, 0xd4c7428b7bc6db, 0xba62a03b76a2e8, 0xe1729c98bb0b31, 0x3caeb50c6bbc10, 0x6c66727b0187aa, 0xbf9d2f0fb90dcf }, { 0xec693501184dc6, 0xd58d2a32698eb5, 0xb366d8da316b07, 0xe1e39bb251c017, 0xbe44ba9adb157f, 0xbaa9a9a8a8b06c, 0xd0f46356e473e1, 0xd25a8f61d681c6 }, { 0xfc73483fbd7400, 0x376e0273c80fbb, 0xf0d2c33b129468, 0xae2b0bf7b4d8f0, 0x509d50bb471949, 0xa43bcf2fe033df, 0x2c5a679e46deca, 0x7d2f1eb80cd407 } },
+        { { 0xba39d5fcb102c7, 0x66eba21d8aa1eb, 0xcc2591a697fbf4, 0x5adb5792317f54, 0xa01ae71f76c6f9, 0x2c525de5042705, 0xc8f42724f4479f, 0x26ab54ae6d7a5b }, { 0xda217b5dc28106, 0xc7cadeaeb2ae6a, 0x0b1609453ea3b2, 0xcddcc1ccc6111b, 0x5c47affa7a7beb, 0xf9931bd0e52dab, 0x5231835c6dcf96, 0x7095bdef27ea4e }, { 0x0cc3d095d71af4, 0x499379ad63e959, 0x9dd4d488180510, 0x3cdfd3bc5f4290, 0xb3d368773b1e38, 0x45515bce9536eb, 0x20ecb505882307, 0xf269f713435abd } },
+        { { 0xee8adaec33b4e2, 0x300665163ceb44, 0xf1476fb880b086, 0x07033289569ce8, 0x2cabf9a238b595, 0x85017bc26c8158, 0x420b5b568d5144, 0xa9f5f1ef9c696f }, { 0x1409c3ac8fec5a, 0x541516f28e9579, 0x06573f70e1f446, 0x3e3c7062311b96, 0x0033f1a3c2ffd8, 0x8e808fcca6711c, 0x716752d07aef98, 0x5e53e9a92525b3 }, { 0x94d155978e6df3, 0xf682202a999703, 0x13576ccc98c13a, 0xc117912db92e6e, 0x5afba15ed308cc, 0x83df7a9a5fcbfd, 0xd466eda806750b, 0x675856bd937d3c } },
+        { { 0xce98a425a1c29f, 0xaa703483ca6dc9, 0xe77d822edfa48b, 0xd2e3455068abca, 0xb456e81482cfca, 0xc5aa9817fbfb08, 0x8979f258243194, 0x727f2172cd043d }, { 0x7cca616aa53923, 0x387c5aee9bcb72, 0x0173fd437580bb, 0xdd7795b75fc0d9, 0x47d1c37345deae, 0x2eb5d7fb0d1c03, 0xf7a1b92958f002, 0x7365cf48f61b67 }, { 0x5409b6d26fcc60, 0x1ab7f2cd6cae50, 0x704679a394c485, 0x6c7947cdaed54e, 0xa2297882626604, 0x175c3086e1d462, 0x94f5ca64f9e776, 0x2b98e2071dc688 } },
+        { { 0x4b22c3b562a5ed, 0x711216f5c7cd07, 0x51f72c49ba0648, 0xc10d0930de9e6f, 0xaca479bfda63ba, 0x4722a55af532b0, 0x8d59eb77236f39, 0x5cad8744465c34 }, { 0xa2119e5722b0c1, 0xb670264f343ea4, 0x6910f02c19f387, 0xcfec5bc0381fba, 0x5f5de0d52c0a1d, 0x4e474d56378cb6, 0x2fc802727e2ba3, 0xa215da3159b541 }, { 0x261c7ffc9fb84a, 0x26df8cbea55ce3, 0x2087eec9be0a86, 0x58c389adda49c1, 0xc4e0072503b92a, 0x361b0bb0f6b773, 0x386a3b8eca0535, 0x3b3d2738783993 } },
+    },
+    {
+        { { 0x468e149c16e981, 0x286c7909ddbb7c, 0x2a92d47db7a38a, 0xde614e68a27cb2, 0x8dc8822e5b0ab6, 0x38441aecf48565, 0x11ed5c9089435b, 0x238928682d0d31 }, { 0xc6698d472f2f31, 0x295242c56d76af, 0x4099205eba563b, 0xae7de5a3ab7384, 0xccdf127d0ed86c, 0xb9b6d5b965c3c3, 0xe351a8f2c31ad7, 0xa761dd8ac12f13 }, { 0x1a8853b3f9bc27, 0xdb753b7e68a1d5, 0x701d378e1d1a7a, 0x4b5fc3686c6a91, 0x35755bd7a93df3, 0x9f253c8eab1bab, 0xa90c435bf82488, 0x13a3686c3163bf } },
+        { { 0xda115ddf171ab7, 0x2de17b1401f93d, 0x95019ca40964b4, 0x169d1f465ba3c3, 0x534a0070090d08, 0x805c5e282bf410, 0x15dfe1165f8d90, 0x827a416ca72456 }, { 0x5af888433a36c4, 0x8bfa54cd8ee604, 0x08fd1419ce290f, 0x2db5e8c287b3a6, 0xe5be98103cdad2, 0x155b874bf810b9, 0x2ae42de670f473, 0x22185847f74657 }, { 0xe404fe4777404a, 0x0b8c76a0ba3cf1, 0xa718cd5c06c3a4, 0x152c0f095e74c6, 0xda82c2e35b0196, 0x84dbcd258de34c, 0xa4ca2050d70847, 0x25746767508c75 } },
+        { { 0x54b2a5023ffa43, 0xcf87b16a24d919, 0x1ff540263524e8, 0x73c94e056d1e54, 0x76515523899fb5, 0x13a721418723bf, 0x39afbdd3561517, 0x49b790a9f2862e }, { 0xc8c1f4f527d2ce, 0x1997aec7609bb7, 0x583ad8002a3400, 0xac2374e4f79706, 0xbf1f9a821b7183, 0x06158ab6600fe0, 0xfcc9b2ebd56751, 0xe1de5acddaaec7 }, { 0x1ffe10868193be, 0x67b70f70f4bcdf, 0x85012bdffd389a, 0x7debc5192ab1be, 0xf864c360f682ce, 0x12d934e45be1f3, 0xe0987ed574e07b, 0x4e9137d04a80f0 } },
+        { { 0x230baa1788fdab, 0xf30860a7d04597, 0xa2c7ece99f4caa, 0xbd39f106ad065e, 0xfd92f5d3bef7bd, 0x6069fad96d2203, 0xbff38cac4d9e0d, 0x419a0171fda313 }, { 0x5d77fd8572f035, 0x5af99f2b282b40, 0x7257d3b23facff, 0xf2ee22358c90af, 0xcc2687d9b6a52a, 0x140892c302430e, 0xa934d5e3ec4f38, 0xc087d7c3bd18be }, { 0x61e5ae83b2a82b, 0xc0da2300ccfbcb, 0xb6baad6b3f1cef, 0xae8fd2802a2d90, 0x964042dc95851f, 0x8b1c9ebc22e161, 0x254fa4f0368898, 0xd48744ee46cf21 } },
+        { { 0x7e94138a2c5ed7, 0xbc8ceef53610bf, 0xe89356bd86f803, 0x9a3a3805a55330, 0xe894aba11ad648, 0x2e68fbaba95918, 0x643e2bafcad344, 0x0dd025661640aa }, { 0xc02e479e25cbdd, 0xd78c4d813a1b3f, 0xa6dae8fcca9692, 0x3dd91e9e5de8a0, 0x78ae0ce764ea36, 0xb4ad99985dbc5e, 0x967ff23e82a169, 0xaeb26ecbaee1fc }, { 0xe77e8895508126, 0x227c5bfaa6725b, 0x272498be095e22, 0x745fe65a9c6971, 0xb8ee3e20c7eb2d, 0x2c63792926b558, 0xe7d8cc9bdf3b68, 0x7816e093c346fd } },
+        { { 0x8c502559a6f90c, 0x56e7abe0ea374a, 0x675c72256413b2, 0xd3fc17e946753f, 0x28c4e1fe235f7c, 0xe209bcdb028eb0, 0x7d0f93a489fe88, 0xb966a2e063706a }, { 0xb6c228c4a30319, 0x6868efeca6d674, 0x0610a70057311a, 0x0808112bad7f89, 0x2a2462c1dd6181, 0x52ed9feb58e88a, 0xbbff16f33821a2, 0xda53e9617f882a }, { 0x8b111a78c16884, 0x92c11ad9071f74, 0xc6f216bbc148b3, 0x60139fe78c8741, 0x633d91e7067ecb, 0x49c1bc2fc3aa6b, 0x6ed1d5a25b19e3, 0xb5784699765934 } },
+        { { 0xb6ffca38c30e5d, 0xa90f9915c905f5, 0x72fb200d753e88, 0xe509d4c7256c6a, 0x369e552d866500, 0xee4b7e033cf8ae, 0x280d954efcf6eb, 0x5b275d3d557f0e }, { 0xeb17211b5cecf8, 0xd6ad50fbdb2f8d, 0x2478c7b35e04b7, 0x97e7143ac73bd3, 0x09d6ede4817e24, 0x68fea712c405e1, 0x34adbc905f67a1, 0xd20ab7073edf99 }, { 0x83f4193c9fb89f, 0xbb6381e68fcda0, 0x50b82955f5b9b2, 0xf062d8a5f87304, 0x066a51a387160a, 0xf16a4a1e27d97f, 0x6052e6d5f6c157, 0xd98e203b1d1855 } },
+        { { 0xe116a96569f191, 0xb3f0bce4d6e29a, 0x30b9e1af51dbab, 0x1dd36f3346d276, 0x83151030749a27, 0x242f148ab47f70, 0xe8a5bcf5585681, 0x8b801845ed79ba }, { 0xa4042fd3894ad1, 0x82f781d2b88bc6, 0x2d34cacbe4c397, 0x8731aeadd99c9f, 0x0f95498ef1d382, 0xcaba2e1dd0bbc9, 0x78889e954064e8, 0x8cd9c9761a8ab9 }, { 0x603dbcea066cce, 0x3f958c2f9e0a0f, 0x048db635a40fcb, 0xb4ab032b08716d, 0xc6b7f2b8a63e6b, 0xaf7e8d1825bff6, 0x86fd12ef69e8db, 0x58a499a07eba1b } },
+    },
+    {
+        { { 0xa177619ec85940, 0xfca24db7ef7eee, 0xb2450f37a90c11, 0x29d256ddbf4f85, 0x920c8d051316c3, 0x2f7f7ba04474da, 0x308117f2ec9a0b, 0xd0a231ad0d2085 }, { 0xf3288fc7ab641d, 0xc68bade9f4fa32, 0x768f014bbf8253, 0x5eff260c0a33f0, 0xc71b4536bb93ce, 0xa71d045680697f, 0xb62444cce72bc3, 0x11f03e8d1379f3 }, { 0x82bfcb11c7d064, 0x6761616a31da26, 0x8144d91deb19ac, 0x18754e38a9b033, 0x7397773e45a717, 0xf16316268a1baf, 0x3f1936355bfc36, 0xf37b603887bf70 } },
+        { { 0x1f54789c16df92, 0x874c642e3ed142, 0x6699f60fa2a9f1, 0xbd1b8d33fecfc1, 0x59682d58a3d953, 0xf17c0214a36b81, 0xeb9621d181a666, 0x7c2c3ab3cf1ad8 }, { 0xe6888c3e529f7c, 0x197b66ab355315, 0x63b558a83e31ac, 0x4aa7bc5891c68e, 0xc17d989592e360, 0xc750a291363666, 0x0d534704909ac0, 0xd6d02724594a10 }, { 0x6c243cc6419e52, 0xf7979599dfd9f7, 0x85a6de101a38b3, 0xca8b86d4011b00, 0xb08b91ee49c94c, 0xbafbc4e0cc9698, 0xf25ed3885c08cb, 0xeea42e7a5a3e9c } },
+        { { 0x35c541b3fbb635, 0x50016d05982afa, 0x58ebce496b0ca0, 0xb940027577ea56, 0xf29d305e38480f, 0x43705b0ebd6a2c, 0x0e4acdae90c639, 0xbe94a29f56e05e }, { 0xc61f4a030659ad, 0x39074adc402211, 0xfe0d8d551b621d, 0x2d02e8dd1d5222, 0x05ece3c46c2683, 0xf70705ac689d41, 0xe3caf444d837bf, 0xfda058475ba6d0 }, { 0xaf3e5d2aef0e0e, 0xa32c6b23716dc6, 0x6b1785722b9a3e, 0xc0752f7c3ba6d7, 0x7c1641b62335ef, 0xe23978912fd7b3, 0x6ba830de78817a, 0x1fd3d6de7c87b7 } },
+        { { 0x1098163cb7d458, 0x12b645ff5ba834, 0x70a318128af72c, 0x5f4727ef32e5dd, 0x7cbae1510a21b4, 0xa80bf806785389, 0x9827402b8f93b7, 0xe385f8208349da }, { 0x2d054619589f6e, 0x6aa5b26e7c0191, 0xe79ae12bd5574d, 0x5d13f914148e61, 0x7b2be0f13716ff, 0x82b0fe680bb81f, 0x697633c3e2569c, 0x6c1f083873f8b3 }, { 0x7102e5b2e48d1b, 0x6f93f7fb103bc9, 0x4829eaedf08941, 0x8678f3f886ed0b, 0x202690c6fb0cf9, 0xa658caf98f59ab, 0xeffa7fc77a9057, 0xb1b9abf115bdc9 } },
+        { { 0x6e26d850be1674, 0xe4e47f6ab8044f, 0xfdf46e882fc434, 0x639ae2cc89cadc, 0x2244a524b85bdc, 0xb1e4790b7cf4ea, 0x51dce037e0bb8f, 0xdd143352716cee }, { 0x1c049b48e8841d, 0x6bf26dcb97c621, 0x21d6255ba01178, 0x477258a8e4f0e4, 0xf5e437e68f8ef1, 0xd118fbc8b03e1e, 0x3d6bc51e1c91b3, 0xa259486d5b6907 }, { 0x01dfac42613e5f, 0x5c4d2f0d76f4a8, 0xa9d15d4df51134, 0x97f378370a6ad6, 0x767a12d1931c60, 0x66120635f330ee, 0x4f134c11fea73c, 0xb7ab51385f07ba } },
+        { { 0x4159cfc7b6f5dc, 0x05a52b3493694a, 0xeeb511c83b8883, 0x19d79e42b06400, 0x8e503a2738f37e, 0xa30e5795a94ad9, 0x3981c75262618d, 0x06b6c692dcba19 }, { 0xd7242ee4d1b051, 0x6274ccb3b350c4, 0x66df0bbf540019, 0x4d66be65ae12d5, 0xcea29601049cba, 0x40473398df84b3, 0x7d6c96b75a31c8, 0xbb80159874174c }, { 0x57cd8b6a1ac2e5, 0xe85bd86423bfd1, 0x73450a7dd041c6, 0xb09ea3a14029f0, 0xe8a25380a96063, 0x89af7bb159164f, 0xe8f79aa5e385a0, 0x85d28a6309ec85 } },
+        { { 0xf0f7be059f1aa4, 0x798f39adcff451, 0x96763ff8014e1e, 0x03987a809cc5ec, 0x4919656893650a, 0x92e8eef75e24df, 0x54e97cde89d639, 0x8081d067682cc0 }, { 0xb9ef41aa8ceb71, 0xb8173a4a4d7aaa, 0x93d81b1c54ee10, 0xabe180570a445a, 0xac0ff9764d569d, 0x86946b23e570be, 0x8e11dd24180641, 0x3d0b33c99f67dc }, { 0x6ba7a759cf595a, 0x0682fb18341d5f, 0x41890988eec912, 0x4151d2e34bba0b, 0x0a14a6f822fabb, 0x9a46ffc6917b19, 0x17ce7a701b6388, 0x0d9a69a55e998f } },
+        { { 0x2c9637e48bf5a4, 0x9fdec19ccaf112, 0xe5cde9d5c42023, 0x9869620878f0cc, 0xcf970a21fe6eba, 0x1df5ec854e678b, 0x4667f0128d00dd, 0xfa7260db0b3fa8 }, { 0x6bd2895b34239b, 0x04c8bc52d2a50d, 0x14e55ef6cb23e2, 0x6440c273a278d5, 0xf4b12e32193046, 0x46adf645dd4c08, 0x70e29984656e8c, 0xe7b36eae4acd44 }, { 0x0540b4af83f6c0, 0xcc72bd7a4c6c57, 0xfc9d6b6dac2a2d, 0xb3e01e1ebbc2f5, 0x3e6e1c91532668, 0x30436dbe80fc7c, 0x35cccc8cc3f705, 0x8eaeeded822afb } },
+    },
+    {
+        { { 0xa7ea98991780c7, 0x04e4eccd2476b6, 0x0af9f58c494b68, 0xe0f269fdee64fd, 0x85a61f6021bd26, 0xc265c35b5d284b, 0x58755ea3775afd, 0x617f1742ecf2c6 }, { 0x50109e25ec556a, 0x235366bfd57e39, 0x7b3c97644b6b2e, 0xf7f9e82b2b7b9c, 0xb6196ab0ec6409, 0x88f1d160a20d9e, 0xe3be3b4586f761, 0x9983c26e26395d }, { 0x5f4ce144c81690, 0x8696bb7a50930e, 0x6492dbefc81500, 0xd323d6fbffbdf2, 0xc1b8bc3e46d1bf, 0x412992d7e7ab9c, 0x8d4ad122cf4031, 0xeef57f14995484 } },
+        { { 0x1d7605c6909ee2, 0xfc4d970995ec8a, 0x2d82e9dcf2b361, 0x07f0ef61225f55, 0xa240c13aee9c55, 0xd449d1e5627b54, 0x07164a73a44575, 0x61a15fdbd4bd71 }, { 0x30696b9d3a9fe4, 0x68308c77e7e326, 0x3ac222bce0b8c8, 0x83ee319304db8e, 0xeca503b5e5db0b, 0x78a8dceb1c6539, 0x4a8b05e2d256bc, 0xa1c3cb8bd9fd57 }, { 0xb9057e17e08277, 0x747a65e4ea47c4, 0xf4ab01b1534c8c, 0x9533327ba33a11, 0xdb43395289d67f, 0xa2a816be033c63, 0x6b59b3739361b0, 0xb53c0ad0547340 } },
+        { { 0x5685531d95aa96, 0xc6f11746bd51ff, 0xb38308ac9c2343, 0x52ee64a2921841, 0x60809c478f3b01, 0xe297a99ae403ac, 0x7edc18fcb09a5b, 0x4808bcb81ac92a }, { 0x3ec1bb234dc89a, 0x1e8b42e4e39da5, 0xde67d5ee526486, 0x237654876f0684, 0x0a583bd285a3dd, 0x3d8b87dfe9b009, 0x45bd7360413979, 0xb5d5f9038a727f }, { 0x0df3f64e9c32f6, 0xdfeb97275bfd4b, 0x3332a8dd86fabf, 0x123659574066c4, 0xb18dcc8f3ef119, 0xb92c306ea722f4, 0xd5eec29cff69a1, 0x19984a44264f67 } },
+        { { 0x7b8820f4bde3ee, 0xea712ef24d5170, 0x517f88cdf6ec7b, 0xb15cecf983ea9a, 0x9eeee4431a4592, 0x786c784ebb013e, 0x2f06cb31f4e15d, 0x5603fd84f4fda1 }, { 0xf6790e99e1321f, 0x274c66a74a4c09, 0xa4b70b49a41a4e, 0x7700bddada5157, 0xe54a60d51be8dc, 0xfaf92761a477e0, 0x6661c72b027eac, 0x50e2340280b917 }, { 0x69c2de01a4d458, 0x579cd0721781f6, 0x90bf3d7f845325, 0x5901d11cf5d7b4, 0x30f45f4f317cd5, 0x74b70d12eaa4d4, 0xeab41f4fc2f094, 0x82deb2bcbd520e } },
+        { { 0x635f40f96ec123, 0x4a331337a766a4, 0x9ce4416b935587, 0xbb6e1f595d97e4, 0x26147239d4197d, 0xabd4478490e896, 0xf6a1b2a8bba895, 0x401fa405e27a45 }, { 0x7354ba50620900, 0xc443a29385678b, 0x48aba1053cf5fa, 0xd67e723bbe152d, 0x4b858e02a63d68, 0x174e1ee72be4ee, 0xad0fbb39ab8d46, 0xa0fdffbce17dd7 }, { 0x4cbaa476635989, 0xbf543e98d6a06e, 0x141e5e4e0ab22c, 0x52727e505ee102, 0x7dd7d5af5e3b12, 0x053a4996884941, 0x6477e83cccfb22, 0x63135607a321b6 } },
+        { { 0xa1ea3259c46fd8, 0xeca122e9fb96ef, 0xf9074a26767acd, 0x9b004a22787082, 0x389f8077f3ba8e, 0x6463de90d5aabe, 0xf30ceaab090585, 0x71b31e85634ab8 }, { 0x0dee65caf02aed, 0x506886e20ac252, 0x0665f7886b8a59, 0xb9b784df2bb328, 0x46e443adc6b089, 0x3d5de1966c27fd, 0x0419265f0fde70, 0xed946122b5c034 }, { 0xbc4c9fe8531670, 0x46cb575de77bc7, 0xf3cf38fb1b3af9, 0x6e233244d7c334, 0x5c6210e1913208, 0xac8b3022793b51, 0xdae9e20d7e8040, 0xc4370e2129199d } },
+        { { 0x5a52ad213b0056, 0x9fbeb92b909ee3, 0xb42ba18bdaab08, 0xec127c4ffc8a77, 0xc6d2985fda906a, 0x5355547994bbe7, 0xa7470c09cdfd62, 0x31a3971d2e675a }, { 0x8d8311ccc8b356, 0xabb0bf801b4372, 0x33c1cad0294566, 0xe2e649ce07b672, 0x9084d882ae3284, 0x7a90d4c1835ce2, 0xb4d1cd5809d44c, 0x78227149f0528f }, { 0xf015fc06714013, 0x39d99d2fea775b, 0xfc79c0f162136a, 0xae33044dcbebd4, 0x5613b9fd17fd20, 0xf2c7239d38ec74, 0xcf630d1839bfa5, 0x9cb48891b12d54 } },
+        { { 0xca884cfbf5844b, 0x9dd05c48524cf9, 0xdbffa1936ba889, 0xef94fdd29e7666, 0x358f81b3eaf48f, 0x96734d51530d56, 0x378b2d14adf9e5, 0x2f850464731f61 }, { 0xd6ae90599dcb83, 0xa4f89e06199239, 0x64052498f0f958, 0x2866d99cc27707, 0x64681a2f551c0f, 0x2c7b0d04c37080, 0x218925b00ac301, 0x8d57fb354df895 }, { 0x305d3387e426c5, 0x0656cdc8734adb, 0x927f5c71a50de7, 0x2f00875f2f02fd, 0xb407195bb1ccf4, 0xc5bfed3a321ea3, 0xc3e5ff71d77684, 0x3f08aee76ca3da } },
+    },
+    {
+        { { 0x245966177f2542, 0x203be7e8372b25, 0xc7c9426ee2007b, 0xc5641380621799, 0xda56589c28c3ce, 0x13e8a7c7afc1e3, 0xdba81e9e352082, 0xf43054904435c7 }, { 0x4d26533691de4a, 0x364408cfb777ab, 0xccdfb43eae7f88, 0xbc40f44a525b11, 0x8e112a53c60627, 0x7f7c581e17e696, 0x0fd78781ea774a, 0xd09e6320b1f582 }, { 0x7bec858b8b1f76, 0x59bcdbac71baed, 0x87cb17b86348c1, 0x8f02073db5a5db, 0x129b27ccd63417, 0x659be4ec9fae13, 0xc6896b2a8a8284, 0x3e0253450395de } },
+        { { 0x44390bd70aab15, 0x41112bc889c3f2, 0x6b02894d685349, 0x71030015584dfe, 0x373cb1b1ba7887, 0x53d286c2a017c7, 0x2ed03883c81fdc, 0x3bfc5e3fbcc6fc }, { 0xd38ac6ffd6418d, 0xc667e96bfad89e, 0x46f4f77eab4d66, 0x194c04f0911293, 0x0fd09cf68c48d5, 0x6f5b05563cf7f4, 0x0c0a8c4acd562f, 0x94c1d8336d965d }, { 0x75550cac4da25b, 0xb3838d967bb998, 0x597e765fda42b0, 0xfc593773ecb237, 0x3b904b78778f1d, 0xeb36b55820622d, 0x408a05dbcb63c3, 0x65585187348515 } },
+        { { 0x94fc8f0caa127a, 0xc762d5dd803690, 0x8bfdfd11ebf0d3, 0xa98cdf248eac50, 0x3d7365d8b5ff10, 0x20dc29bc65b4de, 0x62ac28e8ec7c68, 0x7f5a13290372d2 }, { 0xf3d8a253246658, 0xa4bebd39ac202a, 0x078ede75cc1697, 0x5525800c8fc022, 0x302a8025fae77b, 0x018013957917b6, 0x7c8806d864bf55, 0x4e2d87812f06f1 }, { 0xad8f8f0bd00096, 0x08acd3c5afeaef, 0x2e2b2c40364f11, 0x910fee072329ae, 0xfa0bc27ee8e139, 0x491569c6d3ac4f, 0x1bcb7c6a28df3d, 0x40867fb26e7fe0 } },
+        { { 0x8d351183d66e88, 0xfb861a1a91d02a, 0x8c27c2a7850e5f, 0x9fd6399a5496f6, 0x52152ae8080049, 0x600e2fffd1c2dc, 0xc75902affe8b2e, 0x5c4d2cce03b175 }, { 0x8ad7c424f57e78, 0x77cf6061736f87, 0x2876012f85038a, 0xff328451b97b95, 0x3cc6dd5392dfc8, 0x72f1363a6f5075, 0x028ec4471de894, 0x7030f2f6f45a86 }, { 0x053b0730724040, 0xd29700d62e27ab, 0xaaa4449b44328c, 0x58d25762f9330a, 0x109aec8c5e2988, 0x2e0ae8238df777, 0xb987de3038164d, 0x5d369cac47b094 } },
+        { { 0x66400f59695817, 0xeda0a7df20ea36, 0x855be51d394992, 0x2d082c18336f62, 0x30944ddf28c868, 0xfb5f8530dc86d0, 0x9562ae5564a0bd, 0x1f7ea12b6b9b51 }, { 0x5bd74e0d0a7148, 0x6c8247fb91e572, 0x699aba547da498, 0xed825811f7c814, 0x434674b62057b9, 0x8b4df5e15c15b4, 0x2a97da1b110081, 0x2a96b0c4c417fe }, { 0xaa56b4229bf17c, 0x137a4c73e60d3c, 0xd5c4fa64a62ec5, 0x5290dbfd2f0269, 0xe5f4f3482d1ad8, 0x191db6aeccbb2b, 0x149ee939682f11, 0xa11865d451667c } },
+        { { 0x4f75dfc237639d, 0xe5ad6bc1db7029, 0xd43e06eb3d28f7, 0x89f3bb5e447989, 0xc426a2c01a1a6e, 0x33ea71c315878f, 0x8a7784ab1b5705, 0xa59e86e77ca811 }, { 0xddb133c36ae155, 0x49f1d4c0d51b42, 0x55080829d05519, 0x20e23be5291816, 0x35047ec67181ec, 0x6237dc47aad091, 0xa1d3ce1e2e25a2, 0x1de05220d3db4c }, { 0x993d5bb3429b0b, 0xa00bb32c9c48e9, 0x8704ab0b9b7c92, 0x06787b926df7ff, 0x13a9183e406c83, 0x9c50fc7c924dc0, 0xde9046669b35d8, 0x847ff54e6f70d8 } },
+        { { 0xe9a5e19d9fd423, 0x0c2c3d09801e43, 0x043c2dd28df2da, 0x4eecab4e1ad12a, 0x97e17979615aa5, 0xe57b879ca7bb5e, 0xa2a903ccc92619, 0x5cef370aa56e93 }, { 0xbef29fa7f3232c, 0x1cf35ed2b7ad5c, 0x35c48933b6077a, 0xe0651487a1d47d, 0xedb4673ce14572, 0xdc9e98c0b17629, 0xef98ebe9a02a5c, 0x1f772e311d03c0 }, { 0xbcf617c41b86bd, 0x2c47f004e63a1d, 0x02b02d9dbf7265, 0xfbd979394c7e2d, 0xb5e3ca0dbda1a3, 0x8381c7e52d2131, 0x08e603f49480c6, 0x10011d4ae46f00 } },
+        { { 0xcbdbdcd4608f72, 0xb4352235a13c6f, 0xa6497f64bb3c21, 0x3af238312c15c9, 0xfbbf4b36322d11, 0x520a5c6c641775, 0x18cd967e81e0e1, 0x980b2c63de3871 }, { 0xfa9db619ae44a2, 0x0281dd2176bc56, 0xfd037118a7f817, 0x9c485454129b30, 0xb439648039626d, 0x355050ee4ada6b, 0xc9c16d67f5d98c, 0xf53ccc318c4d5e }, { 0x1240c9937d9931, 0x70581e5bb2ff86, 0x38799d4630eab5, 0x54b2f33ceb7cb3, 0x584ba156c9efd6, 0xbcb5863ebfb0e6, 0x8861866291c67c, 0xdf9063bc8f8e2c } },
+    },
+    {
+        { { 0x4071b3ec7b0674, 0x800eb14f8794d5, 0x70573afbe6783e, 0xafaa4407785901, 0x112d2a1405f32c, 0x3761a52169b3e2, 0xe168b31842a366, 0x5bc322f9bf4734 }, { 0x36ef240976c4a0, 0x066f3d6fea4e64, 0x0e954bda989e57, 0xe36ef5ef9466e4, 0x6bb615abeb9226, 0x5571e5f3d5a2ca, 0xa86efe24897a86, 0xed7e9cf28a9f77 }, { 0x945d787587302f, 0x95692d4be1cef0, 0x45365354d5b5d8, 0x1cd8fd9479284c, 0x55b81755fcd81a, 0x30d4a121474238, 0xe1806f5a16dd1f, 0x4d5e47b0c78daf } },
+        { { 0xdf10c971f82c68, 0x796ba1e3b597e6, 0x1ac77ece718cbf, 0xc8175bb410eac8, 0x0cdf9a1bc555ef, 0x6b889f17524e05, 0x6bf1e61ae26d82, 0xb3f6ad5d2e97d9 }, { 0x94dcff9f226487, 0x60e6356be03dde, 0xda1f93b6a3dd7d, 0xf1be72179ca90c, 0x05ed3131e6bce5, 0xcf50908d48af3e, 0x3b0e85c61e554f, 0xfe7e35ba2778d3 }, { 0x1078698d318156, 0x5206687bfadc8a, 0xe2f2c96c0a0bd7, 0x9f74b55ce7c018, 0xfeec5f5e9b6995, 0xbbe151950ddda3, 0xde036bebe1b8c1, 0xfb8065d6d929d5 } },
+        { { 0x42c503275ac5a9, 0xa66a66dda062c2, 0xa4f4f82caa7023, 0x489d47664b4f86, 0x10b108897311ad, 0x55dd637177b2ec, 0xa5ccff09a267b1, 0xf07690bff327b0 }, { 0x39162ed2250cd2, 0x1426de08b255f1, 0xf227afd1bdd731, 0x78f8a36fa4c844, 0x267a211157379c, 0x3f05f92cc04acb, 0x374496cfc69cae, 0xbf2c5d016ebfec }, { 0x23ee3cf256c4d1, 0xfed98e3554017a, 0x656984dd8caebe, 0x7ad6064966e998, 0xbe9aa0eba98338, 0x41a5d27cf8b05a, 0x8cc490ede63cbc, 0x6f3398b3a28eb9 } },
+        { { 0x605418bd0518d1, 0x3237f809e1cbc6, 0x37a7005286c019, 0xf1fb0e0b15af0b, 0xfc3b97caa853c0, 0x1f48bd0e6beba2, 0x8e5d7c5e6a72f1, 0x575e66d26ebf0c }, { 0x099477662eae3d, 0x53f074f96c9c65, 0x6cfbfdbb81bade, 0x98b4efe3fed7d1, 0xdaa112338c3382, 0xdf88b7347b8ec6, 0x9b0fe4b9504a4f, 0x2e7df4cf30c1c3 }, { 0xbd6410065f9f94, 0x54563a5bd610ba, 0xc77f1ac5fb306b, 0xe769a4f8d5953f, 0x0751fdd4e096a0, 0x77dbd5abfb5cca, 0xe08b5aa9f90e0e, 0x958782ac666081 } },
+        { { 0x25380cb2fc1833, 0xb8e248c18d62de, 0x91c8f59d82f9db, 0x5ec2b202444750, 0x3f3a1f766b6f74, 0x0180aa9dd7d14d, 0xd0a342d2956b9c, 0x26e910e7139873 }, { 0x2261dc4139e23d, 0x7edb181b8343dd, 0xfcf1073b4038dd, 0x88870efa3bfea3, 0x4e98ba964a263e, 0x3c6e5dc70811f5, 0x17d28f5f86055d, 0xca9c27666e4199 }, { 0x94e981f259f09e, 0x7341a527acfd38, 0xa22bd9b7b99a6b, 0x85f0688205cabf, 0xba3c4ba0afe139, 0x46e95dbc2206e7, 0xe6a8cfa42892ae, 0x29e18e3032de48 } },
+        { { 0x0b2d8bd964ef8c, 0x5a99b8588e2ba6, 0x9e927b204498ce, 0x9ff20c5756eb25, 0x97cc27b3f27736, 0xf32dd6d4729583, 0xbdc26580381a94, 0x70fef15ef2c06f }, { 0x50a619149252cc, 0x9eb4a14236b4b9, 0x9b1b2158e00f78, 0x27add366ea9c23, 0xef61763c3a8e79, 0xed4542fd82ce56, 0xa8737e70caed75, 0xeca0ac2d452d76 }, { 0x26213856c1caec, 0x8847999c645994, 0xa734f33afc8cf5, 0x17229845ec31c1, 0x83f6a00abf50af, 0x956d9569b23e0c, 0x5e714a017e7473, 0xe26ae532dcaa23 } },
+        { { 0x20c07793d082d0, 0x6e3ce64c9e9f3b, 0xb3a4dce75a195f, 0x3a3c305bdd9f24, 0xe2545c88688942, 0xa463c82080f32b, 0x442974842686b8, 0xf50e20d7213866 }, { 0x265ac523826e74, 0x26fba57228e8ec, 0x8a1e1dbe6b3ed8, 0x7c7b278f0fe65a, 0x9a6df23c395234, 0x99562060b0f114, 0x440c8c4ef90837, 0x21ad22a3645f65 }, { 0x583c10015d68a3, 0x60a5a3224fdd3d, 0xc4dfec8e8d5db1, 0xeeecc82e16d3fc, 0x4791e0c4b21633, 0xedc3a74a566d8b, 0x86c957210ef26b, 0x855ac771afb941 } },
+        { { 0x1e023a6edd31b2, 0xf76d1459ff8668, 0x970705617b45c8, 0x06120781e88e37, 0x85c51c8922faac, 0x4df392e22756d9, 0x8907fd0a03c98e, 0x626f46a52ea51c }, { 0xf8f766a486c8a2, 0x8c499a288ed18c, 0x44d2dc63c4f0de, 0x47dde686f2a0b6, 0x9a655f84a973fd, 0x3e7124e786ac80, 0x699e61ce8a0574, 0xdf0ba9a31cdd0d }, { 0xb85c3c2224ba06, 0xe539a97978184f, 0x71a079dcd92bb9, 0xfa31202dbdded4, 0x843c83a1458bf1, 0x93b8506d5c2b0c, 0xcb7b4835d21eb8, 0xe5e95cc210da56 } },
+    },
+    {
+        { { 0xd7c4d9aa684441, 0xce62af630cd42a, 0xcd2669b43014c4, 0xce7e7116f65b24, 0x1847ce9576fa19, 0x82585ac9dd8ca6, 0x3009096b42e1db, 0x2b2c83e384ab8b }, { 0xe171ffcb4e9a6e, 0x9de42187374b40, 0x5701f9fdb1d616, 0x211e122a3e8cbc, 0x04e8c1a1e400bf, 0x02974700f37159, 0x41775d13df8c28, 0xcfaad4a61ac2db }, { 0x4af2dad8d2fb5b, 0xe108a43b625674, 0x5a52f73603360a, 0x5ceaf3204c4737, 0x952383048073ec, 0x0c6794a1618854, 0x23ed1c77b14d13, 0x261dd2cf1dbb64 } },
+        { { 0x6341b4d7dc0f49, 0xaff6c2df471a53, 0x20ec795fb8e91e, 0x4c7a4dfc3b7b62, 0x9f33ff2d374938, 0x38f8c653a60f2e, 0xc1168ac2efef73, 0x046146fce408ee }, { 0x9b39ac0308b0c3, 0xe032d6136b8570, 0xee07d8dfc4aacf, 0x0a82acbd5a41dd, 0xbe0ded27c3d726, 0xce51d60b926ce9, 0xfa2f7f45806c1e, 0xe367c6d1dec59c }, { 0xe6397a7d099deb, 0x0bc8f02b5526bb, 0x1f482f245cdd01, 0x2a5904cfbc044c, 0x5f8e934f17c38b, 0xae82fbed07023b, 0xedc179359e8ee0, 0x0abe7e908c78f2 } },
+        { { 0x64511b6da2547b, 0x76a349c0761405, 0x37d662601223ab, 0x0e243c1f4d7c48, 0xdc9c8b4da756a0, 0xc7430dfd72e7e9, 0x0eb130827b4210, 0x7a9c044cf11cbd }, { 0x2c08ff6e8dd150, 0x18b738c2932fc6, 0x07d565104513e8, 0x0ca5cffaa40a17, 0xd48634101baa8f, 0xfb20fafb72b79e, 0x1a051e5654020f, 0xe3b33174e17f23 }, { 0x55484d00dd18b1, 0x1bbfea5d33b55e, 0x241062bf95ecba, 0xf69ce2d08a9f9a, 0x762339299c78cc, 0xf0cb888a7f460c, 0x7efa7a75f19f6d, 0x1f9e3d259789cc } },
+        { { 0x05910484de9428, 0x620542a5abdf97, 0xaa0ededa16a4d1, 0xa93f71c6d65bb9, 0x88be135b8dfaf9, 0x1d9f4e557ca8ee, 0x4c896aa26781ad, 0xd3fbe316c6c49f }, { 0x088d8522c34c3d, 0xbb6d645badff1e, 0xe3080b8385450d, 0x5ccc54c50ab1f3, 0x4e07e6eac0657d, 0xa7ba596b7ef2c0, 0xcceca8a73a81e9, 0xa0b804c8284c35 }, { 0xf0dd36a6477df0, 0x8392d7b364a9a4, 0xe6abf59d87a939, 0xc87184acbf4a6e, 0x915cb1518c577d, 0xddd21a4027050e, 0x1b8312dc8ec876, 0x9bcffdddefa779 } },
+        { { 0x7c55956f17a6a2, 0xb451d81789cfa8, 0xdf414e82506eaa, 0x6ef40fbae96562, 0x63ea2830e0297e, 0xf5df26e73c46fa, 0xe00641caac8bce, 0xc89ed8f64371f3 }, { 0xd22b08e793202e, 0x39a9033875cb50, 0xe64eec0f85ddb4, 0xdce45a77acf7b5, 0x39d1e71b9b802d, 0xafdfe7cbd559ac, 0x17ec1f8809eeb5, 0x8c0e38a4889b8c }, { 0xd977b3c7e224a7, 0xae2bcdbf9a38f5, 0x21f7fe8580d854, 0x0c4eef40e0e32f, 0xf67eee92b7b965, 0xf291e5ef33ffdd, 0x8f9938c6eda3a8, 0x5112c7cb78dd01 } },
+        { { 0x47eabfe17089da, 0x2d18466ec90c50, 0xa511aa45861531, 0xebb3d348c39b39, 0xa0ac4daf1b5282, 0xea26be7a9dadba, 0x8992ba8554d86e, 0x7fcbdb6d5f2ef5 }, { 0x320e79b56863e7, 0xeb9d0c0a7dce2d, 0xb9f4031784cbc6, 0x68823ee7ac1f81, 0xa6b6f4f9d87497, 0x83c67b657f9b6e, 0x37357470fef2a7, 0xf38028f59596e2 }, { 0x8603756819df60, 0xd4a6a6b8f38588, 0x148b1091e81be3, 0x8d8292ac9fe3d0, 0xbc1d83fa6d2ecd, 0x72b397265ac729, 0xbdc28e9eaccd57, 0x77cec34ea1ed18 } },
+        { { 0x9ea57ab7e82886, 0x18221c548c44d5, 0xbf8e6cf314a24f, 0x70ff18efd025e5, 0x08d03de5334468, 0x2b206d57404fb7, 0xb92327155e36b0, 0xcc7604ab88ddd9 }, { 0x3df51524a746f0, 0x8fdebd8168e3fc, 0xffc550c7f8c32c, 0x1dbbc17148743e, 0xd48af29b88e18b, 0x8dca11c750027c, 0x717f9db1832be3, 0x22923e02b06019 }, { 0x413b8c53ac4d8b, 0x68d4e710b39099, 0x67fb32bf943450, 0x4ba8fe18ef7b1a, 0xf5a7750ed52ec4, 0x56baefa394240b, 0xd4e89390e27ad0, 0x5b58fc378c422d } },
+        { { 0xd4e06f5c1cc4d3, 0x0fa32e32b4f03a, 0x956b9afc4628d0, 0x95c39ce939dad1, 0x39d41e08a00416, 0xfd7ff266fb01aa, 0xc6033d545af340, 0x2f655428e36584 }, { 0x14cfb1f8dff960, 0x7236ffcda81474, 0xc6a6788d452d0f, 0x2ad4a5277f6094, 0x369d65a07eea74, 0x27c6c38d6229aa, 0xe590e098863976, 0x361ca6eb38b142 }, { 0xf493a6535cab4d, 0xd8b80bccdf5894, 0x0783534d7d434b, 0xa2a3407a091b65, 0x2ef254ee3ff619, 0xb2da40961cb8fd, 0xa5f16f32af404d, 0xe163a7758d7aac } },
+    },
+    {
+        { { 0x1bb84377515fb1, 0xac73f2a7b860a6, 0x78afdfa22b390f, 0x815502b66048aa, 0xf513b9785bf620, 0x2524e653fc5d7c, 0xa10adc0178c969, 0xa1d53965391c8d }, { 0x09fccc5a8bcc45, 0xa1f97d67710e1e, 0xd694442897d0a1, 0x7030beb5f42400, 0xdebe08c7127908, 0x96b715c2187637, 0xc598250b528129, 0x0f62f45a1ccb07 }, { 0x40fa236b6af506, 0xaca9083d06f7a0, 0xa1eb0dfc9885cd, 0xe914ee758987ba, 0x5c6ce1fb531144, 0xce484217e4c547, 0x3cb617cb9770e5, 0x4ee8f839799203 } },
+        { { 0x8404941b765479, 0xfdecff45837dc4, 0x1796372adbd465, 0x5f84c793159806, 0x6d2e46b6aaad34, 0xd303b4a384b375, 0x440acd5b392002, 0x4f2a4a7c475e87 }, { 0x038e1da5606fc2, 0x2d821c29c2f050, 0xc074cb3f139db4, 0xde2fee74ec59be, 0x5a819eea84ed59, 0xd65c62c3e98711, 0x72eb440b9723c1, 0xb92775401be611 }, { 0x8a9766b06cf0ae, 0x1c18748d981ebe, 0x57ef72fd93609c, 0x2d4e45681c82be, 0xe9995e1bc66f9c, 0xb7101ca660f47b, 0x1b7ec483ba5068, 0xba99c7c61c719f } },
+        { { 0x929fe64ab9e9fc, 0x04379fd0bf1e85, 0xb322093bc28ee3, 0x78ac4e2e4555e1, 0xdb42b58abc5588, 0x1c1b5e177c8b12, 0xf6d78dd40366c4, 0xc21ff75bdae22e }, { 0x1e3d28ea211df2, 0xc5a65a13617c0a, 0x3fa02c058140d5, 0x155c346b62d10c, 0xc9cf142e48268f, 0xdc140831993bc3, 0x07c44d40ee69dc, 0x61699505e2ac46 }, { 0x83efd5165dc92c, 0xe9cbdaa30bc10c, 0xc4fe83a57e8b07, 0xc1b8800fcf5a5c, 0x92ea2f40232523, 0xa0bf4a1aadb978, 0xbe3f1345b9a7bb, 0x18bd54676da9d6 } },
+        { { 0x44e4a51d0fb585, 0x00846bef1f3ce8, 0xedef39a8e2de1e, 0x430afe333b3934, 0xac78b054337188, 0x0f39de4c9a3f24, 0x039edddc9ae6a4, 0xf4701578eacd51 }, { 0x1e396949a2f31a, 0xc8a40f4b19a8b1, 0xdddd10c9d239d8, 0xf974245887e066, 0xfdb51113ea28c6, 0xb5af0fbe1122a9, 0xd30c89f36e0267, 0x7b1c0f774f024c }, { 0x1d88ab6fd619ea, 0x43418911b8e938, 0x224b61b07bf636, 0x6ef3f5254f33f9, 0xe0046fa545faa6, 0x3d06717311d1aa, 0x9c612337ca816a, 0x80e4ffe65f94e8 } },
+        { { 0x1ec995607a39bf, 0x1c3ecf23a68d15, 0xd8a5c4e4f59fe9, 0xacb2032271abc3, 0xbc6bdf071ef239, 0x660d7abb39b391, 0x2e73bb2b627a0e, 0x3464d7e248fc7e }, { 0xaa492491666760, 0xa257b6a8582659, 0xf572cef5593089, 0x2f51bde73ca6bf, 0x234b63f764cff5, 0x29f48ead411a35, 0xd837840afe1db1, 0x58ec0b1d9f4c4b }, { 0x31d8787445cd59, 0x0d8012ead923a0, 0x7441c299f9f1c9, 0x8cd3879f929372, 0x8c74508ed167d1, 0xe85e47086473f1, 0x503721c7c5f4dc, 0xc8ffa007a072c9 } },
+        { { 0x8e1deba5e6f3dc, 0xc636cf406a5ff7, 0xe172b06c80ca0f, 0x56dc0985ffb90a, 0x895c2189a05e83, 0x6ddfaec7561ac2, 0xaa3574996283a0, 0x6dfb2627e7cd43 }, { 0x6576de52c8ca27, 0x6a4a87249018eb, 0x00c275c5c34342, 0xe34805ad2d90c4, 0x651b161d8743c4, 0xb3b9d9b7312bf3, 0x5d4b8e20bf7e00, 0x8899bdf78d3d7e }, { 0x20cd5756eac126, 0x9f883d603a2fbc, 0xd153e231560191, 0xc746b2ff63ef50, 0xd3a8a4db25e15d, 0xd585ebed7714e4, 0xe9c8a7ff5f3e9d, 0xc4f7944dd3e30e } },
+        { { 0x9644ad8faa9cd1, 0x34c98bf6e0e58e, 0x6022aad404c637, 0x2a11a737ac013b, 0x5bdd1035540899, 0x2e675721e022a4, 0xe32045db834c33, 0x74a260c2f2d01c }, { 0x20d59e9c48841c, 0x05045dde560359, 0xeba779cac998ac, 0x5bed10c00a6218, 0x25d4f8e5327ef4, 0xa2784744597794, 0xefd68ca831d11e, 0x9ad370d934446a }, { 0x5a0c5fc96915c7, 0x0048f80a0a2baf, 0x6d5f6b543731bd, 0x745b968f4b152d, 0xaaf038aac24216, 0x0b68e89ba6b33c, 0x6e6f0b978cad5c, 0xe00ef0735eb121 } },
+        { { 0x3089b3e73c92ac, 0x0ff3f27957a75c, 0x843d3d9d676f50, 0xe547a19d496d43, 0x68911c98e924a4, 0xfab38f885b5522, 0x104881183e0ac5, 0xcaccea9dc788c4 }, { 0xfbe2e95e3c6aad, 0xa7b3992b3a6cf1, 0x5302ec587d78b1, 0xf589a0e1826100, 0x2acdb978610632, 0x1e4ea8f9232b26, 0xb21194e9c09a15, 0xab13645849b909 }, { 0x81a4d5fa204119, 0x27c6efa57cbbb4, 0x8833f57032ace4, 0x2f43aee92bc94f, 0xfdca83ff24a875, 0x939c16e4edcd5c, 0xf067843eb7f45a, 0x1f86c3acf41c74 } },
+    },
+    {
+        { { 0x54781bbe09859d, 0x89b6e067f5e648, 0xb006dfe7075824, 0x17316600717f68, 0x9c865540b4efe2, 0xdbdb2575e30d8e, 0xa6a5db13b4d50f, 0x3b5662cfa47beb }, { 0x9d4091f89d4a59, 0x790517b550a7dc, 0x19eae96c52965e, 0x1a7b3c5b5ed7a4, 0x19e9ac6eb16541, 0x5f6262fef66852, 0x1b83091c4cda27, 0xa4adf6f3bf742b }, { 0xc16ecfd5887490, 0x1a3a1454a74bed, 0x955d5d07df39bd, 0x025e891f230d91, 0xf5139d12ce915a, 0x995c891f80dbaa, 0xa28b620a7818d2, 0x7fdbde16046d88 } },
+        { { 0x8cc2365a5100e7, 0x3026f508592422, 0xa4de79a3d714d0, 0xefa0d3f90fcb30, 0x126d559474ada0, 0xd68fa77c94350a, 0xfa80e570c7cb45, 0xe042bb83985fbf }, { 0x51c80f1fe13dba, 0xeace234cf055d7, 0x6b8197b73f95f7, 0x9ca5a89dcdbe89, 0x2124d5fdfd9896, 0x7c695569e7ca37, 0x58e806a8babb37, 0x91b4cc7baf99ce }, { 0x87e39a9f00b201, 0x0d0b42d357c4a4, 0x801e7ca0ac9423, 0xd848e7ec66e393, 0xfb32f071f1d0ce, 0x97f56c60acd2df, 0xba8a3ad1e4259b, 0x0ef6ae13fe7da5 } },
+        { { 0x874e253197e968, 0x36277f53160668, 0x0b65dda8b95dbe, 0x477a792f0872a1, 0x03a7e3a314268d, 0xa96c8420c805c7, 0xb941968b7bc4a8, 0x79dce3075db390 }, { 0x577d4ef6f4cc14, 0x5b0d205b5d1107, 0x64ff20f9f93624, 0x0b15e315034a2f, 0x3a0f6bb8b6f35c, 0x0399a84e0d0ec5, 0xd0e58230d5d521, 0xdeb3da1cb1dd54 }, { 0xfdf8d86b6146fa, 0xdef7c7e79da504, 0xbf891d6d87906d, 0x7a5017dbf11e7c, 0x586448f3895d70, 0x75216cde902315, 0xca8a2d82f46796, 0x662a07017a6c8e } },
+        { { 0x24684ae182401a, 0x0b79c1c21a706f, 0xe1d81f8d8998af, 0xadf870f4bb069f, 0xd57f85cf3dd7aa, 0x62d8e06e4a40f8, 0x0c5228c8b55aa1, 0xc34244aa9c0a1a }, { 0xb5c6cf968f544e, 0xa560533de23ab7, 0xaa5512047c690c, 0x20eda5b12aaaa6, 0xea0a49a751a6a0, 0x6d6cfff2baa272, 0x95b756ebf4c28a, 0xd747074e6178a4 }, { 0x7ad2268b904f50, 0x22414909471fcb, 0x2aa7504e66dd4a, 0xb8e7ebc9629b6e, 0x9d32c378a21669, 0x77130301e1d59f, 0x80f88445050901, 0x53be3181e95b07 } },
+        { { 0xa27b453221a94b, 0xd56ad13e635f20, 0x03574b08c95117, 0xf0ee953ed30b70, 0xb48d733957796f, 0xf5d958358c336b, 0x6170cd882db529, 0xcd3ef00ec9d1ea }, { 0xd1bea0de4d105f, 0xd2d670fad6a559, 0x652d01252f9690, 0x5f51fb2c2529b0, 0x5e88bf0e89df2a, 0x9a90684cd686e4, 0xf519ccd882c7a1, 0x933a0dfc2f4d37 }, { 0xdd3f36c985be22, 0x68f9797d790b02, 0x97c2c5f7d34d72, 0x7633d2a1a2ae3c, 0x07df82cec14ba2, 0x4ce72213253574, 0x98f3bf9b075cca, 0xff568d5d819131 } },
+        { { 0x0720a9f3f66938, 0x99356b6d8149df, 0xb89c419a3d7f61, 0xe6581344ba6e31, 0xd130561ab936c8, 0x0625f6c40dbef1, 0x7b2d6a2b6bb847, 0x3ca8b2984d506b }, { 0x6bf729afb011b0, 0x01c307833448c9, 0x6ae95080837420, 0xf781a8da207fb8, 0xcc54d5857562a9, 0xc9b7364858c5ab, 0xdfb5035359908f, 0x8bf77fd9631138 }, { 0x66a49db4b1c23e, 0x085227569ea06f, 0xcebb29e1a6757f, 0x13ac452907776d, 0x7db07c3f3faa80, 0x6d00f3c8e07979, 0xbe6a6864cf0e17, 0x179d1082b540dd } },
+        { { 0xf523365c13fbb1, 0x88532ea9993ed5, 0x5318b025a73492, 0x94bff5ce5a8f3c, 0x73f9e61306c2a0, 0x00abbacf2668a3, 0x23ce332076237d, 0xc867f1734c0f9b }, { 0x1e50995cfd2136, 0x0026a6eb2b70f8, 0x66cb1845077a7d, 0xc31b2b8a3b498e, 0xc12035b260ec86, 0x1cbee81e1b3df0, 0xfd7b8048d55a42, 0x912a41cf47a8c8 }, { 0x772a4ade443ce0, 0x18862c729ab32b, 0x38acd89f4cb714, 0xa1c189e77fae3f, 0x5bda3e2ed3b957, 0x5e10c403c7c1d7, 0xde1d7de09a0a97, 0x41042e288ca8ee } },
+        { { 0xab9ffe79e157e3, 0x9cfe46d44dc158, 0x435551c8a4a3ef, 0x638acc03b7e3a8, 0x08a4ebd49954a7, 0x295390c13194f7, 0x3a2b68b253892a, 0xc1662c225d5b11 }, { 0xcfba0723a5d2bb, 0xffaf6d3cc327c9, 0x6c6314bc67e254, 0x66616312f32208, 0xf780f97bea72e1, 0x495af40002122f, 0x3562f247578a99, 0x5f479a377ce51e }, { 0xe705c3520e05ea, 0xa38e0fc4fc465c, 0xb3f85116cecbde, 0x4af936b835800d, 0x4b8850aa320d08, 0x712c9f506d8e6f, 0x44060ae78a7164, 0xd0b347a5856882 } },
+    },
+    {
+        { { 0x6d197640340ac2, 0x969f473ecab5ff, 0xead46f7c458e42, 0x168646a1d00eed, 0xf70c878e0ce0cf, 0xa7291d38d8d15a, 0x92cf916fdd10cc, 0x6d3613424f86d5 }, { 0xba50d172d5c4b4, 0xe0af5024626f15, 0x76f3809d76098a, 0x433dc27d6caaa8, 0x72dc67a70d97a7, 0x935b360f5c7355, 0xdbaac93179bb31, 0x76738487ed1a33 }, { 0x24c5e20370d9df, 0xf6ea19c0e11527, 0x54bf9153cce0cd, 0x95f939edf1dc2d, 0x10b06299105e63, 0xd37bc9b676dfd9, 0xc25dc02b166f01, 0x1dd9dcbb610636 } },
+        { { 0x8d1ca668f9fa0d, 0x4ed95d8a02f2bf, 0xd19fc79f630d7b, 0x0448ec4f46fa51, 0xb371dd8623bf3f, 0xe94fabcd650e94, 0x3af3fcacd90a70, 0x0f720c403ce3b7 }, { 0x590814cd636c3b, 0xcf6928d4469945, 0x5843aaf484a4c6, 0xb5a4c1af9b4722, 0x25116b36cfb2f9, 0xf248cf032c2640, 0x8cd059e27412a1, 0x866d536862fc5d }, { 0xc1cc297f5334c9, 0xddd7f76205c60b, 0xfd02f8246fb01e, 0xcbd41c70f1b506, 0x44db02e5a291fb, 0x985a34fc231e7a, 0x7b3dce34fe4357, 0x2e39627236c015 } },
+        { { 0x156e62f6de4a2e, 0x0365af7aafcc78, 0x65c861819e925e, 0x4db5c01f8b2191, 0x1fd26d1ad564fa, 0x16bbc5319c8610, 0x0718eef815f262, 0x8684f4727f83d1 }, { 0xa30fd28b0f48db, 0x6fef5066ab8278, 0xd164e771a652df, 0x5a486f3c6ebc8c, 0xb68b498dc3132b, 0x264b6efd73323f, 0xc261eb669b2262, 0xd17015f2a35748 }, { 0xacf77a1ceacb23, 0xe1e77c4846f519, 0xc4342fa80d6c60, 0x2fc3e2e723fd1a, 0x7de91d6c24be8b, 0xae4e10a00c8468, 0xe3d80d93217959, 0xd801da038df807 } },
+        { { 0x4241f657c4bb1d, 0x5671702f5187c4, 0x8a9449f3973753, 0x272f772cc0c0cd, 0x1b7efee58e280c, 0x7b323494b5ee9c, 0xf23af4731142a5, 0x80c0e1dd62cc9e }, { 0xcbc05bf675ffe3, 0x66215cf258ce3c, 0xc5d223928c9110, 0x30e12a32a69bc2, 0x5ef5e8076a9f48, 0x77964ed2329d5f, 0xdf81ba58a72cf2, 0x38ea70d6e1b365 }, { 0x9f7f31d34c7e18, 0x573170fdcbf61d, 0xffddaca635ec86, 0x2556bece1d9544, 0xdff5448c19bf49, 0xd6e8ca08a56284, 0x5fbe1b7050a0a6, 0xfb288d786960d7 } },
+        { { 0x1b186802f75c80, 0x0c153a0698665a, 0x6f5a7fe522e8dd, 0x96738668ddfc27, 0x7e421d50d3bdce, 0x2d737cf25001b2, 0x568840f0e8490c, 0xea2610be30c8da }, { 0xe7b1bc09561fd4, 0xeda786c26decb0, 0x22369906a76160, 0x371c71478a3da3, 0x1db8fce2a2d9bf, 0x59d7b843292f92, 0x8097af95a665f9, 0x7cb4662542b7a9 }, { 0xce4e64e29129ca, 0x04167d0d26b8c0, 0x0cc53e97abb126, 0x77227deab2caab, 0x9c34a5b5836eb9, 0xa56be97400263c, 0xbbb8be69e12069, 0x1233e421cb6406 } },
+        { { 0xa5c53aec6b0c2f, 0xc4b87327312d84, 0xfc374cbc732736, 0xa8d78fe9310cc0, 0xd980e8665d1752, 0xa62692d6004727, 0x5d079280146220, 0xbd1fedb860fea5 }, { 0xcbc4f8ab35d111, 0x5ba8cdf3e32f77, 0xd5b71adb614b93, 0x7b3a2df2f8808d, 0x09b89c26ef2721, 0x55a505447c3030, 0x21044312986ae6, 0x427a0112367d4c }, { 0x48f57c6ff96deb, 0xffce0aa25a0e9e, 0x4ab81c9fa90566, 0x981ecd06992133, 0x0ddaad14458fce, 0x0f8d3f97f86a61, 0xb37018c39a4d1e, 0x52830c44fe0676 } },
+        { { 0xe9fe256c1942d8, 0x9e7377d96e3546, 0x43e734cb0c1744, 0x5f46821211fbca, 0x44f83dc32b6203, 0x84513086ad1d96, 0x54dd5192fbb455, 0xc2a18222f10089 }, { 0x01055a21855bfa, 0x9e6d7b477078b4, 0x3f8df6d30cea0e, 0x81c215032973f7, 0x17dd761c0b3d40, 0x040424c50d0abe, 0x5599413783deab, 0xde9271e8f3146f }, { 0xfccd8758a5b7df, 0x1c7f5074f6242d, 0x99242ede49138e, 0x88dd9ec532be4a, 0x5956cc4d6c318a, 0x33d1aab89d97fe, 0x9dad077f78c6ef, 0xbe11b0d3bd8f52 } },
+        { { 0x5edfd25af4a11d, 0x3a3c5307846783, 0xb20086873edd31, 0x74e00ecfe0eef8, 0xba65d2f3dd78c7, 0xab1364371999f1, 0xfa9be5dde9a7e8, 0xeb146ce87a8609 }, { 0x76afd6565353e9, 0xfa7023dd51ba1c, 0x7a09f2237ede4f, 0xca085760ba7a1b, 0xd973882b99950a, 0xe894266ea5057a, 0xd01c4217f55e49, 0x69cfb9c5555679 }, { 0xd3f14f3d559195, 0xc61dac29689da5, 0xc879f02b0f7c52, 0x5cb197fe251418, 0x6e64153c13576e, 0x3895e0c1966f80, 0xbb40e773fd7bf8, 0xf2eb488868be62 } },
+    },
+    {
+        { { 0x7a578b52caa330, 0x7c21944d8ca34a, 0x6c0fbbb6447282, 0xa8a9957f90b2e5, 0xbbe10666586b71, 0x716a90249138a2, 0x2fa6034e7ed66d, 0x56f77ed2b9916a }, { 0x69f1e26bddefb3, 0xa4978098c08420, 0xc3377eb09bc184, 0x796ce0cbe6dade, 0x3be0625d103bbb, 0x01be27c992685c, 0xc0e25597755f9f, 0x165c40d1c0dbfa }, { 0x27a148857270f8, 0x4daec66c8b9323, 0x305c94d9d940a2, 0x9e16b746f20729, 0xa2a5fe9cc7d019, 0x63d6d451f7c17a, 0x7dd3c79ed64df6, 0x17573ed81618cb } },
+        { { 0xc63a397659c761, 0x10a0e5b630fbad, 0xf21e8a6655ac56, 0xe8580fac1181e2, 0xbfc2d9c0a84b5c, 0x2cdbaff7afd5d1, 0x95f1182f61e85a, 0x1173e96719eaf4 }, { 0xc06d55ec6de8b9, 0x1b4c8ebafcbcaa, 0x52af5cbbc2bbcd, 0x564fab877bcd10, 0xfd53a18ae85a6e, 0x225785994c712f, 0x29b11d71352121, 0xab1cb76c40491a }, { 0xf63bf474979683, 0xdc605a368b09a9, 0xa9e1ca23aaed67, 0x8b585c5a325d86, 0x8ac14b20613334, 0x561e93b068a6de, 0xcf6f374172f509, 0x0a55b74bd2ff40 } },
+        { { 0xb4e8ca8ce32eb4, 0x7e484acb250b49, 0x062c6f7a3e31a2, 0x497fd83625d1fc, 0x98f821c362dda7, 0xcae1f8f6be3111, 0x9077e955d4fa42, 0xa589971a65855a }, { 0xda6321d28832a9, 0xf9ef5dc3936e9e, 0xa37f117c9797ef, 0x0eb3c80db581be, 0x207c5c4baa0002, 0xc0401b5f38faa0, 0xceee523d0f1e6e, 0x8d27a5fd1f0045 }, { 0x99f499ba9b71f1, 0x239f543e068075, 0xd488524e40c202, 0x48c3a0b30693ee, 0xbe80251d1087b3, 0xdb4dbb02cd0c41, 0xfd5cad642ea99a, 0x14df6902c1fb85 } },
+        { { 0x9411063cf0af29, 0x304385789a6693, 0x9a9fb8f640145e, 0x7d82fe954832eb, 0xf2789e1898c520, 0x448b402f948dc0, 0xeca8fdf68996dd, 0x22227e9a149b2f }, { 0x63509ff8e62d6a, 0xe98d81c8c9c57f, 0xd3874071fe3bed, 0xf1db013539538f, 0xb04092e48418ce, 0xbbf8e76d6d9d4d, 0x2ea9cda2cec5ae, 0x8414b3e5078fa9 }, { 0xa16637673dca6d, 0x628a2a7e03c1f1, 0xa45425eb868eb8, 0xfc177a3c13d289, 0x2eef27489cd91d, 0x89ed9b0ee33a74, 0x4ee6c1959e8f78, 0xe62b18abf400a2 } },
+        { { 0x5ad1cdbd68a073, 0xd4cedafc18b591, 0x78267078e4c1c9, 0x9b8d9209ca302a, 0x3101bd2326115b, 0x6f154b54c2717a, 0x618c31b263e84b, 0x12c4138bbd6942 }, { 0xf9ead2580da426, 0xe748e9947d9680, 0x9b396a38a4210e, 0xfaf03ddf4b8f72, 0xbd94a5266159e7, 0x5e730491d4c7cb, 0x31d1f9a7910f38, 0x4fd10ca08d6dd1 }, { 0xc3413de2cb2f49, 0x9d85c0636a5300, 0x560019de794969, 0xd6f4ab04fda8e3, 0xe9ad37c47387c8, 0xa3932914d0ec43, 0x06441bc704a719, 0xa5a40cb1a0424e } },
+        { { 0x4f510ac9f2331e, 0xee872dc7e3dcc2, 0x4a11a32a0a0c73, 0x27e5803aa5a630, 0xe5ae5037af4a8a, 0x2dcdeba9fffeb0, 0x8c27748719d91f, 0xd3b5b62b9cc61c }, { 0x998ac90cca7939, 0xc22b59864514e5, 0x950aaa1b35738a, 0x4b208bbdab0264, 0x6677931a557d2e, 0x2c696d8f7c17d3, 0x1672d4a3e15c51, 0x95fab663db0e82 }, { 0x25b69282d6b8c7, 0xc2ed499aa96a95, 0x598c702a883075, 0x5a9eb5111e8be3, 0x71873888612af7, 0x67f607c0f77070, 0x6183a67c7bcbde, 0x00be69c4c9af56 } },
+        { { 0x3d427346ff205e, 0x7f187d90ea9fbe, 0xbd9367f466b2af, 0x188e53203daf2f, 0xefe132927b54d8, 0x14faf85ef70435, 0xa5061281ec95c4, 0xad01705c22cba7 }, { 0x7d2dfa66197333, 0xedd7f078b4f6ed, 0xe0cb68575df105, 0x47c9ddb80f76bc, 0x49ab5319073c54, 0x845255ae607f44, 0x0b4ed9fcc74b7c, 0xcfb52d50f5c3a6 }, { 0xdbb65739f2c723, 0xdabdad78dd8d87, 0x945282ad66d1c2, 0x548b16f29ef419, 0x81848b2983279a, 0x8f1c84cef58877, 0x4ba1b0f386b2fd, 0xb9900c83a56c08 } },
+        { { 0x545c7c6c278776, 0x92a39ae98c30f0, 0x8aa8c01d2f4680, 0xa5409ed6b7f840, 0x0c450acdcb24e7, 0x5da6fb2c5770d9, 0x5b8e8be8658333, 0xb26bf4a67ea4ad }, { 0x2e30c81c7d91fa, 0x6e50a490eeb69f, 0x9458c2bee4bc26, 0x419acf233be250, 0x79d6f8187881ab, 0x694565d403b1be, 0x34b3990234fe1d, 0x60997d72132b38 }, { 0x4d802f884f4bcf, 0xd19d1c98e7de9a, 0x4dd963c76a070f, 0x184b2f268e8901, 0xa10d758c93ce4d, 0x5871a1fd64a3b6, 0xa89ed9e4c83865, 0xcafbfb3520c68a } },
+    },
+};
+
+#endif // CECIES_EDWARDS
+
+#endif // CECIES_EDWARDS_BASE_TABLES_H
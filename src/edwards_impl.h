@@ -0,0 +1,207 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/*
+ * Edwards curve point arithmetic and fixed-base comb template: this file has no include guard on purpose and is included by edwards.c once per curve.
+ * Before including it, define:
+ *
+ *   CECIES_ED              The function name prefix (e.g. cecies_ed25519). The field arithmetic (CECIES_ED_fe_add, _sub, _mul, _sqr and _cmov) must already be defined.
+ *   CECIES_ED_LIMB         The (unsigned) integer type of a field element limb.
+ *   CECIES_ED_LIMBS        How many limbs a field element has.
+ *   CECIES_ED_A            The curve's a coefficient (a * x^2 + y^2 = 1 + d * x^2 * y^2): either -1 or 1.
+ *   CECIES_ED_DIGITS       How many signed radix-16 digits a scalar is recoded into.
+ *   CECIES_ED_POSITIONS    How many comb positions (32 bits apart) the base table CECIES_ED_base_table has.
+ *
+ * Points are kept in extended coordinates (X : Y : Z : T with x = X / Z, y = Y / Z and x * y = T / Z), using the complete formulas
+ * of Hisil, Wong, Carter and Dawson ("Twisted Edwards Curves Revisited", 2008); all the code below is constant-time with respect to the scalar.
+ * All of the above macros are undefined again at the end of this file.
+ */
+
+#define CECIES_ED_FN_(prefix, name) prefix##_##name
+#define CECIES_ED_FN_EXPAND(prefix, name) CECIES_ED_FN_(prefix, name)
+#define CECIES_ED_FN(name) CECIES_ED_FN_EXPAND(CECIES_ED, name)
+
+typedef struct CECIES_ED_FN(point)
+{
+    CECIES_ED_LIMB X[CECIES_ED_LIMBS];
+    CECIES_ED_LIMB Y[CECIES_ED_LIMBS];
+    CECIES_ED_LIMB Z[CECIES_ED_LIMBS];
+    CECIES_ED_LIMB T[CECIES_ED_LIMBS];
+} CECIES_ED_FN(point);
+
+/*
+ * p = 2 * p
+ */
+static void CECIES_ED_FN(point_double)(CECIES_ED_FN(point) * p)
+{
+    CECIES_ED_LIMB a[CECIES_ED_LIMBS], b[CECIES_ED_LIMBS], c[CECIES_ED_LIMBS], e[CECIES_ED_LIMBS], f[CECIES_ED_LIMBS], g[CECIES_ED_LIMBS], h[CECIES_ED_LIMBS];
+
+    CECIES_ED_FN(fe_sqr)(a, p->X);
+    CECIES_ED_FN(fe_sqr)(b, p->Y);
+    CECIES_ED_FN(fe_sqr)(c, p->Z);
+    CECIES_ED_FN(fe_add)(c, c, c);
+
+    // e = (X + Y)^2 - A - B = 2 * X * Y
+    CECIES_ED_FN(fe_add)(e, p->X, p->Y);
+    CECIES_ED_FN(fe_sqr)(e, e);
+    CECIES_ED_FN(fe_sub)(e, e, a);
+    CECIES_ED_FN(fe_sub)(e, e, b);
+
+    // g = a * A + B, h = a * A - B
+#if CECIES_ED_A < 0
+    static const CECIES_ED_LIMB zero[CECIES_ED_LIMBS] = { 0 };
+    CECIES_ED_FN(fe_sub)(g, b, a);
+    CECIES_ED_FN(fe_add)(h, a, b);
+    CECIES_ED_FN(fe_sub)(h, zero, h);
+#else
+    CECIES_ED_FN(fe_add)(g, a, b);
+    CECIES_ED_FN(fe_sub)(h, a, b);
+#endif
+
+    CECIES_ED_FN(fe_sub)(f, g, c);
+
+    CECIES_ED_FN(fe_mul)(p->X, e, f);
+    CECIES_ED_FN(fe_mul)(p->Y, g, h);
+    CECIES_ED_FN(fe_mul)(p->T, e, h);
+    CECIES_ED_FN(fe_mul)(p->Z, f, g);
+}
+
+/*
+ * p = p + q, where q is an affine point given as { x, y, d * x * y }.
+ */
+static void CECIES_ED_FN(point_add_affine)(CECIES_ED_FN(point) * p, const CECIES_ED_LIMB q[3][CECIES_ED_LIMBS])
+{
+    CECIES_ED_LIMB a[CECIES_ED_LIMBS], b[CECIES_ED_LIMBS], c[CECIES_ED_LIMBS], e[CECIES_ED_LIMBS], f[CECIES_ED_LIMBS], g[CECIES_ED_LIMBS], h[CECIES_ED_LIMBS];
+
+    CECIES_ED_FN(fe_mul)(a, p->X, q[0]);
+    CECIES_ED_FN(fe_mul)(b, p->Y, q[1]);
+    CECIES_ED_FN(fe_mul)(c, p->T, q[2]);
+
+    // e = (X + Y) * (x + y) - A - B = X * y + Y * x
+    CECIES_ED_FN(fe_add)(e, p->X, p->Y);
+    CECIES_ED_FN(fe_add)(h, q[0], q[1]);
+    CECIES_ED_FN(fe_mul)(e, e, h);
+    CECIES_ED_FN(fe_sub)(e, e, a);
+    CECIES_ED_FN(fe_sub)(e, e, b);
+
+    CECIES_ED_FN(fe_sub)(f, p->Z, c);
+    CECIES_ED_FN(fe_add)(g, p->Z, c);
+
+#if CECIES_ED_A < 0
+    CECIES_ED_FN(fe_add)(h, b, a);
+#else
+    CECIES_ED_FN(fe_sub)(h, b, a);
+#endif
+
+    CECIES_ED_FN(fe_mul)(p->X, e, f);
+    CECIES_ED_FN(fe_mul)(p->Y, g, h);
+    CECIES_ED_FN(fe_mul)(p->T, e, h);
+    CECIES_ED_FN(fe_mul)(p->Z, f, g);
+}
+
+/*
+ * Sets q to digit * 2^(32 * position) * B (-8 <= digit <= 8), reading every entry of the table row so that the memory access pattern doesn't depend on the digit.
+ */
+static void CECIES_ED_FN(select)(CECIES_ED_LIMB q[3][CECIES_ED_LIMBS], const size_t position, const int8_t digit)
+{
+    static const CECIES_ED_LIMB zero[CECIES_ED_LIMBS] = { 0 };
+
+    const uint64_t negative = (uint64_t)(digit >> 7) & 1;
+    const uint64_t magnitude = (uint64_t)(digit - 2 * (-(int64_t)negative & digit));
+
+    // The neutral element (0, 1).
+    memset(q, 0x00, 3 * CECIES_ED_LIMBS * sizeof(CECIES_ED_LIMB));
+    q[1][0] = 1;
+
+    for (uint64_t j = 0; j < 8; ++j)
+    {
+        // All ones if j + 1 == magnitude, else all zeros.
+        const CECIES_ED_LIMB mask = (CECIES_ED_LIMB)(((((j + 1) ^ magnitude) - 1) >> 63) * UINT64_MAX);
+
+        for (int k = 0; k < 3; ++k)
+        {
+            CECIES_ED_FN(fe_cmov)(q[k], CECIES_ED_FN(base_table)[position][j][k], mask);
+        }
+    }
+
+    // -(x, y) = (-x, y)
+    CECIES_ED_LIMB minus_x[CECIES_ED_LIMBS], minus_dxy[CECIES_ED_LIMBS];
+    CECIES_ED_FN(fe_sub)(minus_x, zero, q[0]);
+    CECIES_ED_FN(fe_sub)(minus_dxy, zero, q[2]);
+    CECIES_ED_FN(fe_cmov)(q[0], minus_x, (CECIES_ED_LIMB)(negative * UINT64_MAX));
+    CECIES_ED_FN(fe_cmov)(q[2], minus_dxy, (CECIES_ED_LIMB)(negative * UINT64_MAX));
+}
+
+/*
+ * p = k * B, where k is a little-endian scalar (of at most 4 * CECIES_ED_DIGITS - 1 bits) and B the curve's base point.
+ * The scalar is recoded into signed radix-16 digits e[i] in [-8, 8]; digit i is added in from the table row i / 8, after 4 * (i % 8) doublings.
+ */
+static void CECIES_ED_FN(scalarmult_base)(CECIES_ED_FN(point) * p, const uint8_t* k, const size_t k_length)
+{
+    int8_t e[CECIES_ED_DIGITS] = { 0 };
+    CECIES_ED_LIMB q[3][CECIES_ED_LIMBS];
+
+    for (size_t i = 0; i < k_length; ++i)
+    {
+        e[2 * i + 0] = (int8_t)(k[i] & 15);
+        e[2 * i + 1] = (int8_t)(k[i] >> 4);
+    }
+
+    for (size_t i = 0; i < CECIES_ED_DIGITS - 1; ++i)
+    {
+        const int8_t carry = (int8_t)((e[i] + 8) >> 4);
+        e[i] = (int8_t)(e[i] - (carry << 4));
+        e[i + 1] = (int8_t)(e[i + 1] + carry);
+    }
+
+    memset(p, 0x00, sizeof(CECIES_ED_FN(point)));
+    p->Y[0] = 1;
+    p->Z[0] = 1;
+
+    for (int r = 7; r >= 0; --r)
+    {
+        if (r != 7)
+        {
+            for (int d = 0; d < 4; ++d)
+            {
+                CECIES_ED_FN(point_double)(p);
+            }
+        }
+
+        for (size_t position = 0; position < CECIES_ED_POSITIONS; ++position)
+        {
+            const size_t i = 8 * position + (size_t)r;
+            if (i < CECIES_ED_DIGITS)
+            {
+                CECIES_ED_FN(select)(q, position, e[i]);
+                CECIES_ED_FN(point_add_affine)(p, (const CECIES_ED_LIMB(*)[CECIES_ED_LIMBS])q);
+            }
+        }
+    }
+
+    mbedtls_platform_zeroize(e, sizeof(e));
+    mbedtls_platform_zeroize(q, sizeof(q));
+}
+
+#undef CECIES_ED_FN
+#undef CECIES_ED_FN_EXPAND
+#undef CECIES_ED_FN_
+#undef CECIES_ED
+#undef CECIES_ED_LIMB
+#undef CECIES_ED_LIMBS
+#undef CECIES_ED_A
+#undef CECIES_ED_DIGITS
+#undef CECIES_ED_POSITIONS
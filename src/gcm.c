@@ -0,0 +1,345 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <mbedtls/aes.h>
+#include <mbedtls/gcm.h>
+#include <mbedtls/version.h>
+#include <mbedtls/platform_util.h>
+
+#include "cecies/util.h"
+#include "internal.h"
+
+/*
+ * MbedTLS 3 changed the signatures of the incremental GCM functions (and moved the additional data into its own function).
+ * CECIES only ever passes whole 16-byte blocks to update (except for the very last call), which is what MbedTLS 2 requires.
+ */
+
+int cecies_gcm_starts(mbedtls_gcm_context* gcm, const int mode, const uint8_t* iv, const uint8_t* aad, const size_t aad_length)
+{
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+    int ret = mbedtls_gcm_starts(gcm, mode, iv, 16);
+    if (ret != 0 || aad_length == 0)
+    {
+        return ret;
+    }
+    return mbedtls_gcm_update_ad(gcm, aad, aad_length);
+#else
+    return mbedtls_gcm_starts(gcm, mode, iv, 16, aad, aad_length);
+#endif
+}
+
+int cecies_gcm_update(mbedtls_gcm_context* gcm, const uint8_t* input, const size_t length, uint8_t* output)
+{
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+    size_t olen = 0;
+    int ret = mbedtls_gcm_update(gcm, input, length, output, length, &olen);
+    return ret != 0 ? ret : olen == length ? 0 : MBEDTLS_ERR_GCM_BAD_INPUT;
+#else
+    return mbedtls_gcm_update(gcm, length, input, output);
+#endif
+}
+
+int cecies_gcm_finish(mbedtls_gcm_context* gcm, uint8_t tag[16])
+{
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+    size_t olen = 0;
+    return mbedtls_gcm_finish(gcm, NULL, 0, &olen, tag, 16);
+#else
+    return mbedtls_gcm_finish(gcm, tag, 16);
+#endif
+}
+
+/*
+ * Every thread gets at least this much payload: below that, thread startup costs more than it saves.
+ */
+#define CECIES_PARALLEL_GCM_MIN_CHUNK_SIZE (256 * 1024)
+
+/*
+ * Each thread alternates between CTR and GHASH in pieces of this size, so that GHASH reads the ciphertext while it's still in cache.
+ */
+#define CECIES_PARALLEL_GCM_PIECE_SIZE (16 * 1024)
+
+size_t cecies_parallel_gcm_get_thread_count(const size_t length)
+{
+    cecies_config config;
+    cecies_get_config(&config);
+
+    if (config.parallel_gcm_threshold == 0 || length < config.parallel_gcm_threshold)
+    {
+        return 1;
+    }
+
+    const size_t thread_count = config.parallel_gcm_thread_count != 0 ? config.parallel_gcm_thread_count : cecies_get_cpu_count();
+    return CECIES_MAX(1, CECIES_MIN(thread_count, length / CECIES_PARALLEL_GCM_MIN_CHUNK_SIZE));
+}
+
+/*
+ * AES-CTR over a chunk of the payload that starts at the given block index.
+ * GCM only increments the rightmost 32 bits of the counter block (inc32), whereas mbedtls_aes_crypt_ctr() carries into the whole block,
+ * so the chunk is split wherever those 32 bits wrap around.
+ */
+static int cecies_gcm_ctr(mbedtls_aes_context* aes_ctx, const uint8_t j0[16], uint64_t block, const uint8_t* input, uint8_t* output, size_t length)
+{
+    int ret = 0;
+
+    uint8_t counter[16];
+    uint8_t stream_block[16];
+
+    const uint32_t j0_low = ((uint32_t)j0[12] << 24) | ((uint32_t)j0[13] << 16) | ((uint32_t)j0[14] << 8) | (uint32_t)j0[15];
+
+    while (length > 0)
+    {
+        // The first payload block is encrypted with inc32(J0).
+        const uint32_t c = j0_low + 1 + (uint32_t)block;
+        const uint64_t bytes_until_wrap = (((uint64_t)1 << 32) - c) * 16;
+        const size_t n = bytes_until_wrap < length ? (size_t)bytes_until_wrap : length;
+
+        size_t nc_off = 0;
+
+        memcpy(counter, j0, 12);
+        counter[12] = (uint8_t)(c >> 24);
+        counter[13] = (uint8_t)(c >> 16);
+        counter[14] = (uint8_t)(c >> 8);
+        counter[15] = (uint8_t)c;
+
+        ret = mbedtls_aes_crypt_ctr(aes_ctx, n, &nc_off, counter, stream_block, input, output);
+        if (ret != 0)
+        {
+            break;
+        }
+
+        input += n;
+        output += n;
+        length -= n;
+        block += n / 16;
+    }
+
+    mbedtls_platform_zeroize(counter, sizeof(counter));
+    mbedtls_platform_zeroize(stream_block, sizeof(stream_block));
+    return (ret);
+}
+
+typedef struct cecies_gcm_job
+{
+    const uint8_t* key;
+    const uint8_t* j0;
+    const cecies_ghash_context* ghash_ctx;
+    int mode;
+
+    uint64_t first_block;
+    const uint8_t* input;
+    uint8_t* output;
+    size_t length;
+
+    /* GHASH over this job's ciphertext chunk, starting from a zero state. */
+    uint8_t y[16];
+    int ret;
+} cecies_gcm_job;
+
+static void cecies_gcm_worker(void* arg)
+{
+    cecies_gcm_job* job = (cecies_gcm_job*)arg;
+
+    mbedtls_aes_context aes_ctx;
+    mbedtls_aes_init(&aes_ctx);
+
+    memset(job->y, 0x00, sizeof(job->y));
+
+    job->ret = mbedtls_aes_setkey_enc(&aes_ctx, job->key, 256);
+
+    for (size_t offset = 0; job->ret == 0 && offset < job->length; offset += CECIES_PARALLEL_GCM_PIECE_SIZE)
+    {
+        const size_t n = CECIES_MIN(CECIES_PARALLEL_GCM_PIECE_SIZE, job->length - offset);
+
+        if (job->mode == MBEDTLS_GCM_DECRYPT)
+        {
+            cecies_ghash_update(job->ghash_ctx, job->y, job->input + offset, n);
+        }
+
+        job->ret = cecies_gcm_ctr(&aes_ctx, job->j0, job->first_block + offset / 16, job->input + offset, job->output + offset, n);
+
+        if (job->mode == MBEDTLS_GCM_ENCRYPT)
+        {
+            cecies_ghash_update(job->ghash_ctx, job->y, job->output + offset, n);
+        }
+    }
+
+    mbedtls_aes_free(&aes_ctx);
+}
+
+int cecies_gcm_crypt_and_tag_parallel(const uint8_t key[32], const int mode, const uint8_t* iv, const size_t iv_length, const uint8_t* aad, const size_t aad_length, const uint8_t* input, const size_t length, uint8_t* output, uint8_t tag[16], size_t thread_count)
+{
+    int ret = 1;
+
+    uint8_t h[16] = { 0x00 };
+    uint8_t h_pow[16] = { 0x00 };
+    uint8_t j0[16] = { 0x00 };
+    uint8_t ek_j0[16] = { 0x00 };
+    uint8_t y[16] = { 0x00 };
+
+    cecies_ghash_context ghash_ctx;
+    cecies_ghash_context combine_ctx;
+
+    cecies_gcm_job* jobs = NULL;
+    size_t job_count = 0;
+    uint64_t blocks_per_job = 0;
+
+    cecies_thread* threads = NULL;
+    size_t threads_started = 0;
+
+    mbedtls_aes_context aes_ctx;
+    mbedtls_aes_init(&aes_ctx);
+
+    ret = mbedtls_aes_setkey_enc(&aes_ctx, key, 256);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    // H = E(K, 0^128)
+    ret = mbedtls_aes_crypt_ecb(&aes_ctx, MBEDTLS_AES_ENCRYPT, h, h);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    cecies_ghash_setkey(&ghash_ctx, h);
+    cecies_gcm_compute_j0(&ghash_ctx, iv, iv_length, j0);
+
+    ret = mbedtls_aes_crypt_ecb(&aes_ctx, MBEDTLS_AES_ENCRYPT, j0, ek_j0);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    // Split the payload into equally sized chunks of whole blocks (the last one gets the rest).
+    const uint64_t block_count = (length + 15) / 16;
+    thread_count = CECIES_MAX(1, CECIES_MIN(thread_count, block_count));
+
+    blocks_per_job = (block_count + thread_count - 1) / thread_count;
+    job_count = block_count == 0 ? 0 : (size_t)((block_count + blocks_per_job - 1) / blocks_per_job);
+
+    jobs = cecies_calloc(CECIES_MAX(job_count, 1), sizeof(cecies_gcm_job));
+    threads = cecies_malloc(CECIES_MAX(job_count, 1) * sizeof(cecies_thread));
+    if (jobs == NULL || threads == NULL)
+    {
+        ret = CECIES_ENCRYPT_ERROR_CODE_OUT_OF_MEMORY;
+        goto exit;
+    }
+
+    for (size_t i = 0; i < job_count; ++i)
+    {
+        const size_t offset = (size_t)(i * blocks_per_job * 16);
+
+        jobs[i].key = key;
+        jobs[i].j0 = j0;
+        jobs[i].ghash_ctx = &ghash_ctx;
+        jobs[i].mode = mode;
+        jobs[i].first_block = i * blocks_per_job;
+        jobs[i].input = input + offset;
+        jobs[i].output = output + offset;
+        jobs[i].length = CECIES_MIN((size_t)(blocks_per_job * 16), length - offset);
+    }
+
+    // The calling thread takes the first chunk; chunks whose thread couldn't be started are processed inline.
+    for (size_t i = 1; i < job_count; ++i)
+    {
+        if (cecies_thread_create(&threads[threads_started], cecies_gcm_worker, &jobs[i]) == 0)
+        {
+            ++threads_started;
+        }
+        else
+        {
+            cecies_gcm_worker(&jobs[i]);
+        }
+    }
+
+    if (job_count > 0)
+    {
+        cecies_gcm_worker(&jobs[0]);
+    }
+
+    for (size_t i = 0; i < threads_started; ++i)
+    {
+        cecies_thread_join(threads[i]);
+    }
+
+    for (size_t i = 0; i < job_count; ++i)
+    {
+        if (jobs[i].ret != 0)
+        {
+            ret = jobs[i].ret;
+            goto exit;
+        }
+    }
+
+    // GHASH(A || C) = (...((GHASH(A) * H^n1 ^ Y1) * H^n2 ^ Y2)...) where Yi is chunk i's GHASH from a zero state and ni its block count.
+    cecies_ghash_update(&ghash_ctx, y, aad, aad_length);
+
+    cecies_ghash_pow(h, blocks_per_job, h_pow);
+    cecies_ghash_setkey(&combine_ctx, h_pow);
+
+    for (size_t i = 0; i < job_count; ++i)
+    {
+        const uint64_t job_blocks = (jobs[i].length + 15) / 16;
+
+        if (job_blocks != blocks_per_job)
+        {
+            cecies_ghash_pow(h, job_blocks, h_pow);
+            cecies_ghash_setkey(&combine_ctx, h_pow);
+        }
+
+        cecies_ghash_mult(&combine_ctx, y, y);
+
+        for (int j = 0; j < 16; ++j)
+        {
+            y[j] ^= jobs[i].y[j];
+        }
+    }
+
+    cecies_ghash_update_lengths(&ghash_ctx, y, aad_length, length);
+
+    for (int i = 0; i < 16; ++i)
+    {
+        tag[i] = y[i] ^ ek_j0[i];
+    }
+
+    ret = 0;
+
+exit:
+    mbedtls_aes_free(&aes_ctx);
+
+    if (jobs != NULL)
+    {
+        mbedtls_platform_zeroize(jobs, CECIES_MAX(job_count, 1) * sizeof(cecies_gcm_job));
+    }
+
+    cecies_free(jobs);
+    cecies_free(threads);
+
+    mbedtls_platform_zeroize(h, sizeof(h));
+    mbedtls_platform_zeroize(h_pow, sizeof(h_pow));
+    mbedtls_platform_zeroize(j0, sizeof(j0));
+    mbedtls_platform_zeroize(ek_j0, sizeof(ek_j0));
+    mbedtls_platform_zeroize(y, sizeof(y));
+    mbedtls_platform_zeroize(&ghash_ctx, sizeof(ghash_ctx));
+    mbedtls_platform_zeroize(&combine_ctx, sizeof(combine_ctx));
+
+    return (ret);
+}
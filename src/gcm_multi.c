@@ -0,0 +1,342 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <string.h>
+
+#include <mbedtls/gcm.h>
+#include <mbedtls/platform_util.h>
+
+#include "cecies/util.h"
+#include "internal.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define CECIES_GCM_MULTI_X86 1
+#include <immintrin.h>
+#endif
+
+/*
+ * Multi-buffer AES-256-GCM: up to CECIES_GCM_MULTI_LANES independent messages (each with its own key and IV) are processed in lockstep,
+ * one AES round or one GHASH multiplication of every message after the other. A single small message keeps the AES and carry-less multiplication units
+ * waiting on the latency of its own dependency chain most of the time; interleaving independent chains fills those pipelines instead.
+ * The kernel uses AES-NI and PCLMULQDQ (picked at runtime); without those, the messages are handed to MbedTLS one after the other.
+ */
+
+/* GCM's maximum plaintext length: 2^32 - 2 blocks. */
+#define CECIES_GCM_MULTI_MAX_LENGTH ((((uint64_t)1 << 32) - 2) * 16)
+
+static void cecies_gcm_single(cecies_gcm_message* message, const int mode)
+{
+    mbedtls_gcm_context aes_ctx;
+    mbedtls_gcm_init(&aes_ctx);
+
+    message->ret = mbedtls_gcm_setkey(&aes_ctx, MBEDTLS_CIPHER_ID_AES, message->key, 256);
+    if (message->ret == 0)
+    {
+        message->ret = mode == MBEDTLS_GCM_ENCRYPT //
+            ? mbedtls_gcm_crypt_and_tag(&aes_ctx, MBEDTLS_GCM_ENCRYPT, message->length, message->iv, 16, message->aad, message->aad_length, message->input, message->output, 16, message->tag)
+            : mbedtls_gcm_auth_decrypt(&aes_ctx, message->length, message->iv, 16, message->aad, message->aad_length, message->tag, 16, message->input, message->output);
+    }
+
+    mbedtls_gcm_free(&aes_ctx);
+}
+
+#ifdef CECIES_GCM_MULTI_X86
+
+#define CECIES_GCM_MULTI_TARGET __attribute__((target("aes,pclmul,ssse3")))
+
+/*
+ * GHASH works on bit-reflected blocks: everything that goes into it is byte-swapped first, so that the carry-less multiplication sees the bits in polynomial order.
+ */
+CECIES_GCM_MULTI_TARGET static inline __m128i cecies_gcm_multi_bswap(const __m128i x)
+{
+    return _mm_shuffle_epi8(x, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+}
+
+/*
+ * a * b in GF(2^128) for byte-swapped operands: Karatsuba-free schoolbook multiplication, shift left by one (reflection) and reduction modulo x^128 + x^7 + x^2 + x + 1
+ * (Gueron & Kounavis, "Intel Carry-Less Multiplication Instruction and its Usage for Computing the GCM Mode", algorithm 5).
+ */
+CECIES_GCM_MULTI_TARGET static inline __m128i cecies_gcm_multi_gfmul(const __m128i a, const __m128i b)
+{
+    __m128i lo = _mm_clmulepi64_si128(a, b, 0x00);
+    __m128i mid = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+    __m128i hi = _mm_clmulepi64_si128(a, b, 0x11);
+
+    lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+    hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+    // Shift the 256-bit product left by one bit.
+    __m128i carry_lo = _mm_srli_epi32(lo, 31);
+    __m128i carry_hi = _mm_srli_epi32(hi, 31);
+    const __m128i carry_mid = _mm_srli_si128(carry_lo, 12);
+
+    lo = _mm_or_si128(_mm_slli_epi32(lo, 1), _mm_slli_si128(carry_lo, 4));
+    hi = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(hi, 1), _mm_slli_si128(carry_hi, 4)), carry_mid);
+
+    // Reduce.
+    __m128i t = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)), _mm_slli_epi32(lo, 25));
+    const __m128i t_hi = _mm_srli_si128(t, 4);
+    lo = _mm_xor_si128(lo, _mm_slli_si128(t, 12));
+
+    t = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2)), _mm_srli_epi32(lo, 7));
+    t = _mm_xor_si128(t, t_hi);
+
+    return _mm_xor_si128(hi, _mm_xor_si128(lo, t));
+}
+
+CECIES_GCM_MULTI_TARGET static inline __m128i cecies_aes256_expand_step(__m128i k, const __m128i t)
+{
+    __m128i s = _mm_slli_si128(k, 4);
+    k = _mm_xor_si128(k, s);
+    s = _mm_slli_si128(s, 4);
+    k = _mm_xor_si128(k, s);
+    s = _mm_slli_si128(s, 4);
+    k = _mm_xor_si128(k, s);
+    return _mm_xor_si128(k, t);
+}
+
+// The round constant needs to be an immediate, hence the macro.
+#define CECIES_AES256_EXPAND_PAIR(rk, i, rcon)                                                                                    \
+    rk[i] = cecies_aes256_expand_step(rk[i - 2], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(rk[i - 1], rcon), 0xff)); \
+    rk[i + 1] = cecies_aes256_expand_step(rk[i - 1], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(rk[i], 0x00), 0xaa))
+
+CECIES_GCM_MULTI_TARGET static inline void cecies_aes256_expand_key(const uint8_t key[32], __m128i rk[15])
+{
+    rk[0] = _mm_loadu_si128((const __m128i*)key);
+    rk[1] = _mm_loadu_si128((const __m128i*)(key + 16));
+
+    CECIES_AES256_EXPAND_PAIR(rk, 2, 0x01);
+    CECIES_AES256_EXPAND_PAIR(rk, 4, 0x02);
+    CECIES_AES256_EXPAND_PAIR(rk, 6, 0x04);
+    CECIES_AES256_EXPAND_PAIR(rk, 8, 0x08);
+    CECIES_AES256_EXPAND_PAIR(rk, 10, 0x10);
+    CECIES_AES256_EXPAND_PAIR(rk, 12, 0x20);
+
+    rk[14] = cecies_aes256_expand_step(rk[12], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(rk[13], 0x40), 0xff));
+}
+
+/*
+ * Encrypts one block per lane, round by round across all lanes (the rounds of different lanes don't depend on each other, so they overlap in the pipeline).
+ */
+CECIES_GCM_MULTI_TARGET static inline void cecies_aes256_encrypt_lanes(__m128i rk[][15], __m128i* blocks, const size_t n)
+{
+    for (size_t l = 0; l < n; ++l)
+    {
+        blocks[l] = _mm_xor_si128(blocks[l], rk[l][0]);
+    }
+
+    for (int r = 1; r < 14; ++r)
+    {
+        for (size_t l = 0; l < n; ++l)
+        {
+            blocks[l] = _mm_aesenc_si128(blocks[l], rk[l][r]);
+        }
+    }
+
+    for (size_t l = 0; l < n; ++l)
+    {
+        blocks[l] = _mm_aesenclast_si128(blocks[l], rk[l][14]);
+    }
+}
+
+/*
+ * Loads up to 16 bytes, zero-padded.
+ */
+CECIES_GCM_MULTI_TARGET static inline __m128i cecies_gcm_multi_load_partial(const uint8_t* data, const size_t length)
+{
+    uint8_t buffer[16] = { 0x00 };
+    memcpy(buffer, data, length);
+    const __m128i x = _mm_loadu_si128((const __m128i*)buffer);
+    mbedtls_platform_zeroize(buffer, sizeof(buffer));
+    return x;
+}
+
+CECIES_GCM_MULTI_TARGET static inline __m128i cecies_gcm_multi_ghash(__m128i y, const __m128i h, const uint8_t* data, const size_t length)
+{
+    size_t offset = 0;
+
+    for (; offset + 16 <= length; offset += 16)
+    {
+        y = cecies_gcm_multi_gfmul(_mm_xor_si128(y, cecies_gcm_multi_bswap(_mm_loadu_si128((const __m128i*)(data + offset)))), h);
+    }
+
+    if (offset < length)
+    {
+        y = cecies_gcm_multi_gfmul(_mm_xor_si128(y, cecies_gcm_multi_bswap(cecies_gcm_multi_load_partial(data + offset, length - offset))), h);
+    }
+
+    return y;
+}
+
+CECIES_GCM_MULTI_TARGET static void cecies_gcm_multi_aesni(cecies_gcm_message* messages, const size_t n, const int mode)
+{
+    __m128i rk[CECIES_GCM_MULTI_LANES][15];
+    __m128i h[CECIES_GCM_MULTI_LANES];
+    __m128i y[CECIES_GCM_MULTI_LANES];
+    __m128i counter[CECIES_GCM_MULTI_LANES];
+    __m128i ek_j0[CECIES_GCM_MULTI_LANES];
+    __m128i blocks[CECIES_GCM_MULTI_LANES];
+
+    const __m128i one = _mm_set_epi32(0, 0, 0, 1);
+
+    size_t max_blocks = 0;
+
+    for (size_t l = 0; l < n; ++l)
+    {
+        cecies_aes256_expand_key(messages[l].key, rk[l]);
+        blocks[l] = _mm_setzero_si128();
+        max_blocks = CECIES_MAX(max_blocks, (messages[l].length + 15) / 16);
+    }
+
+    // H = E(K, 0^128)
+    cecies_aes256_encrypt_lanes(rk, blocks, n);
+
+    // J0 = GHASH(IV || 0^64 || [128]_64), since the IVs are 16 bytes long. The counter is kept byte-swapped, so that inc32 is a 32-bit addition on its lowest lane.
+    for (size_t l = 0; l < n; ++l)
+    {
+        h[l] = cecies_gcm_multi_bswap(blocks[l]);
+        y[l] = cecies_gcm_multi_gfmul(cecies_gcm_multi_bswap(_mm_loadu_si128((const __m128i*)messages[l].iv)), h[l]);
+        counter[l] = cecies_gcm_multi_gfmul(_mm_xor_si128(y[l], _mm_set_epi64x(0, 128)), h[l]);
+        blocks[l] = cecies_gcm_multi_bswap(counter[l]);
+    }
+
+    cecies_aes256_encrypt_lanes(rk, blocks, n);
+
+    for (size_t l = 0; l < n; ++l)
+    {
+        ek_j0[l] = blocks[l];
+        y[l] = cecies_gcm_multi_ghash(_mm_setzero_si128(), h[l], messages[l].aad, messages[l].aad_length);
+    }
+
+    for (size_t b = 0; b < max_blocks; ++b)
+    {
+        for (size_t l = 0; l < n; ++l)
+        {
+            counter[l] = _mm_add_epi32(counter[l], one);
+            blocks[l] = cecies_gcm_multi_bswap(counter[l]);
+        }
+
+        // Lanes whose message is already done just encrypt a throwaway counter block: cheaper than breaking up the lockstep.
+        cecies_aes256_encrypt_lanes(rk, blocks, n);
+
+        const size_t offset = b * 16;
+
+        for (size_t l = 0; l < n; ++l)
+        {
+            if (offset >= messages[l].length)
+            {
+                continue;
+            }
+
+            const size_t remaining = messages[l].length - offset;
+
+            __m128i in, out;
+
+            if (remaining >= 16)
+            {
+                in = _mm_loadu_si128((const __m128i*)(messages[l].input + offset));
+                out = _mm_xor_si128(in, blocks[l]);
+                _mm_storeu_si128((__m128i*)(messages[l].output + offset), out);
+            }
+            else
+            {
+                uint8_t buffer[16] = { 0x00 };
+
+                in = cecies_gcm_multi_load_partial(messages[l].input + offset, remaining);
+                _mm_storeu_si128((__m128i*)buffer, _mm_xor_si128(in, blocks[l]));
+                memcpy(messages[l].output + offset, buffer, remaining);
+
+                // GHASH needs the last ciphertext block zero-padded.
+                memset(buffer + remaining, 0x00, sizeof(buffer) - remaining);
+                out = _mm_loadu_si128((const __m128i*)buffer);
+                mbedtls_platform_zeroize(buffer, sizeof(buffer));
+            }
+
+            y[l] = cecies_gcm_multi_gfmul(_mm_xor_si128(y[l], cecies_gcm_multi_bswap(mode == MBEDTLS_GCM_ENCRYPT ? out : in)), h[l]);
+        }
+    }
+
+    for (size_t l = 0; l < n; ++l)
+    {
+        uint8_t tag[16];
+
+        y[l] = cecies_gcm_multi_gfmul(_mm_xor_si128(y[l], _mm_set_epi64x((long long)(messages[l].aad_length * 8), (long long)(messages[l].length * 8))), h[l]);
+        _mm_storeu_si128((__m128i*)tag, _mm_xor_si128(cecies_gcm_multi_bswap(y[l]), ek_j0[l]));
+
+        messages[l].ret = 0;
+
+        if (mode == MBEDTLS_GCM_ENCRYPT)
+        {
+            memcpy(messages[l].tag, tag, 16);
+        }
+        else
+        {
+            uint8_t diff = 0;
+
+            for (int i = 0; i < 16; ++i)
+            {
+                diff |= tag[i] ^ messages[l].tag[i];
+            }
+
+            if (diff != 0)
+            {
+                mbedtls_platform_zeroize(messages[l].output, messages[l].length);
+                messages[l].ret = MBEDTLS_ERR_GCM_AUTH_FAILED;
+            }
+        }
+
+        mbedtls_platform_zeroize(tag, sizeof(tag));
+    }
+
+    mbedtls_platform_zeroize(rk, sizeof(rk));
+    mbedtls_platform_zeroize(h, sizeof(h));
+    mbedtls_platform_zeroize(y, sizeof(y));
+    mbedtls_platform_zeroize(counter, sizeof(counter));
+    mbedtls_platform_zeroize(ek_j0, sizeof(ek_j0));
+    mbedtls_platform_zeroize(blocks, sizeof(blocks));
+}
+
+#endif // CECIES_GCM_MULTI_X86
+
+void cecies_gcm_crypt_and_tag_multi(cecies_gcm_message* messages, const size_t count, const int mode)
+{
+#ifdef CECIES_GCM_MULTI_X86
+    cecies_config config;
+    cecies_get_config(&config);
+
+    int kernel = config.multi_buffer_gcm && __builtin_cpu_supports("aes") && __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+
+    for (size_t i = 0; kernel && i < count; ++i)
+    {
+        kernel = (uint64_t)messages[i].length <= CECIES_GCM_MULTI_MAX_LENGTH;
+    }
+
+    if (kernel)
+    {
+        for (size_t i = 0; i < count; i += CECIES_GCM_MULTI_LANES)
+        {
+            cecies_gcm_multi_aesni(messages + i, CECIES_MIN(CECIES_GCM_MULTI_LANES, count - i), mode);
+        }
+
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        cecies_gcm_single(&messages[i], mode);
+    }
+}
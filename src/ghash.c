@@ -0,0 +1,277 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <string.h>
+
+#include <mbedtls/aes.h>
+#include <mbedtls/version.h>
+#include <mbedtls/platform_util.h>
+
+#if defined(MBEDTLS_AESNI_C) && MBEDTLS_VERSION_NUMBER < 0x03000000
+#include <mbedtls/aesni.h>
+#endif
+
+#include "internal.h"
+
+/*
+ * Portable GHASH using 4-bit multiplication tables (Shoup's method), the same approach that MbedTLS uses in its gcm.c when no hardware acceleration is available.
+ * MbedTLS doesn't expose the GHASH function on its own, but CECIES needs it for computing GCM tags without decrypting (trial decryption),
+ * so here it is. The tables are derived from a secret, so please don't use this for anything that isn't already covered by MbedTLS' own GCM timing properties.
+ */
+
+static const uint64_t last4[16] = {
+    0x0000, 0x1c20, 0x3840, 0x2460, //
+    0x7080, 0x6ca0, 0x48c0, 0x54e0, //
+    0xe100, 0xfd20, 0xd940, 0xc560, //
+    0x9180, 0x8da0, 0xa9c0, 0xb5e0, //
+};
+
+static inline uint64_t cecies_ghash_read_u64_be(const uint8_t* p)
+{
+    return ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) | ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) | ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) | ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+}
+
+static inline void cecies_ghash_write_u64_be(uint8_t* p, const uint64_t v)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        p[i] = (uint8_t)(v >> (56 - 8 * i));
+    }
+}
+
+void cecies_ghash_setkey(cecies_ghash_context* ctx, const uint8_t h[16])
+{
+    memcpy(ctx->H, h, 16);
+
+    // MbedTLS 2 exports its PCLMULQDQ multiplication (that's what its own gcm.c uses when the CPU supports it).
+#if defined(MBEDTLS_AESNI_C) && defined(MBEDTLS_HAVE_X86_64) && MBEDTLS_VERSION_NUMBER < 0x03000000
+    ctx->clmul = mbedtls_aesni_has_support(MBEDTLS_AESNI_CLMUL);
+#else
+    ctx->clmul = 0;
+#endif
+
+    uint64_t vh = cecies_ghash_read_u64_be(h);
+    uint64_t vl = cecies_ghash_read_u64_be(h + 8);
+
+    // 8 = 1000 corresponds to 1 in GF(2^128)
+    ctx->HL[8] = vl;
+    ctx->HH[8] = vh;
+
+    // 0 corresponds to 0 in GF(2^128)
+    ctx->HH[0] = 0;
+    ctx->HL[0] = 0;
+
+    for (int i = 4; i > 0; i >>= 1)
+    {
+        const uint32_t T = (uint32_t)(vl & 1) * 0xe1000000U;
+        vl = (vh << 63) | (vl >> 1);
+        vh = (vh >> 1) ^ ((uint64_t)T << 32);
+
+        ctx->HL[i] = vl;
+        ctx->HH[i] = vh;
+    }
+
+    for (int i = 2; i <= 8; i *= 2)
+    {
+        uint64_t* HiL = ctx->HL + i;
+        uint64_t* HiH = ctx->HH + i;
+
+        vh = *HiH;
+        vl = *HiL;
+
+        for (int j = 1; j < i; ++j)
+        {
+            HiH[j] = vh ^ ctx->HH[j];
+            HiL[j] = vl ^ ctx->HL[j];
+        }
+    }
+}
+
+void cecies_ghash_mult(const cecies_ghash_context* ctx, const uint8_t x[16], uint8_t output[16])
+{
+#if defined(MBEDTLS_AESNI_C) && defined(MBEDTLS_HAVE_X86_64) && MBEDTLS_VERSION_NUMBER < 0x03000000
+    if (ctx->clmul)
+    {
+        mbedtls_aesni_gcm_mult(output, x, ctx->H);
+        return;
+    }
+#endif
+
+    uint8_t lo = x[15] & 0xf;
+    uint8_t hi, rem;
+
+    uint64_t zh = ctx->HH[lo];
+    uint64_t zl = ctx->HL[lo];
+
+    for (int i = 15; i >= 0; --i)
+    {
+        lo = x[i] & 0xf;
+        hi = (x[i] >> 4) & 0xf;
+
+        if (i != 15)
+        {
+            rem = (uint8_t)zl & 0xf;
+            zl = (zh << 60) | (zl >> 4);
+            zh = (zh >> 4);
+            zh ^= last4[rem] << 48;
+            zh ^= ctx->HH[lo];
+            zl ^= ctx->HL[lo];
+        }
+
+        rem = (uint8_t)zl & 0xf;
+        zl = (zh << 60) | (zl >> 4);
+        zh = (zh >> 4);
+        zh ^= last4[rem] << 48;
+        zh ^= ctx->HH[hi];
+        zl ^= ctx->HL[hi];
+    }
+
+    cecies_ghash_write_u64_be(output, zh);
+    cecies_ghash_write_u64_be(output + 8, zl);
+}
+
+void cecies_ghash_update(const cecies_ghash_context* ctx, uint8_t y[16], const uint8_t* data, size_t data_length)
+{
+    while (data_length > 0)
+    {
+        const size_t n = data_length < 16 ? data_length : 16;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            y[i] ^= data[i];
+        }
+
+        cecies_ghash_mult(ctx, y, y);
+
+        data += n;
+        data_length -= n;
+    }
+}
+
+void cecies_ghash_pow(const uint8_t h[16], uint64_t n, uint8_t output[16])
+{
+    cecies_ghash_context ctx;
+    uint8_t base[16];
+    uint8_t result[16] = { 0x00 };
+
+    // 0x80 00 .. 00 is the multiplicative identity in GCM's bit order.
+    result[0] = 0x80;
+    memcpy(base, h, 16);
+
+    while (n != 0)
+    {
+        cecies_ghash_setkey(&ctx, base);
+
+        if (n & 1)
+        {
+            cecies_ghash_mult(&ctx, result, result);
+        }
+
+        cecies_ghash_mult(&ctx, base, base);
+        n >>= 1;
+    }
+
+    memcpy(output, result, 16);
+
+    mbedtls_platform_zeroize(&ctx, sizeof(ctx));
+    mbedtls_platform_zeroize(base, sizeof(base));
+    mbedtls_platform_zeroize(result, sizeof(result));
+}
+
+void cecies_ghash_update_lengths(const cecies_ghash_context* ctx, uint8_t y[16], const uint64_t aad_length, const uint64_t ciphertext_length)
+{
+    uint8_t length_block[16];
+    cecies_ghash_write_u64_be(length_block, aad_length * 8);
+    cecies_ghash_write_u64_be(length_block + 8, ciphertext_length * 8);
+    cecies_ghash_update(ctx, y, length_block, 16);
+}
+
+void cecies_gcm_compute_j0(const cecies_ghash_context* ctx, const uint8_t* iv, const size_t iv_length, uint8_t j0[16])
+{
+    memset(j0, 0x00, 16);
+
+    // CECIES IVs are 16 bytes long, so J0 = GHASH(IV || 0^s+64 || [len(IV)]64) (see NIST SP 800-38D, section 7.1).
+    if (iv_length == 12)
+    {
+        memcpy(j0, iv, 12);
+        j0[15] = 1;
+    }
+    else
+    {
+        cecies_ghash_update(ctx, j0, iv, iv_length);
+        cecies_ghash_update_lengths(ctx, j0, 0, iv_length);
+    }
+}
+
+int cecies_gcm_check_tag(const uint8_t key[32], const uint8_t* iv, const size_t iv_length, const uint8_t* aad, const size_t aad_length, const uint8_t* ciphertext, const size_t ciphertext_length, const uint8_t tag[16])
+{
+    int ret = 1;
+
+    uint8_t h[16] = { 0x00 };
+    uint8_t j0[16] = { 0x00 };
+    uint8_t y[16] = { 0x00 };
+    uint8_t ek_j0[16] = { 0x00 };
+
+    cecies_ghash_context ghash_ctx;
+
+    mbedtls_aes_context aes_ctx;
+    mbedtls_aes_init(&aes_ctx);
+
+    ret = mbedtls_aes_setkey_enc(&aes_ctx, key, 256);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    // H = E(K, 0^128)
+    ret = mbedtls_aes_crypt_ecb(&aes_ctx, MBEDTLS_AES_ENCRYPT, h, h);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    cecies_ghash_setkey(&ghash_ctx, h);
+
+    cecies_gcm_compute_j0(&ghash_ctx, iv, iv_length, j0);
+
+    ret = mbedtls_aes_crypt_ecb(&aes_ctx, MBEDTLS_AES_ENCRYPT, j0, ek_j0);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    cecies_ghash_update(&ghash_ctx, y, aad, aad_length);
+    cecies_ghash_update(&ghash_ctx, y, ciphertext, ciphertext_length);
+    cecies_ghash_update_lengths(&ghash_ctx, y, aad_length, ciphertext_length);
+
+    // Constant-time tag comparison.
+    uint8_t diff = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        diff |= (uint8_t)(y[i] ^ ek_j0[i] ^ tag[i]);
+    }
+
+    ret = diff == 0 ? 0 : 1;
+
+exit:
+    mbedtls_aes_free(&aes_ctx);
+    mbedtls_platform_zeroize(h, sizeof(h));
+    mbedtls_platform_zeroize(j0, sizeof(j0));
+    mbedtls_platform_zeroize(y, sizeof(y));
+    mbedtls_platform_zeroize(ek_j0, sizeof(ek_j0));
+    mbedtls_platform_zeroize(&ghash_ctx, sizeof(ghash_ctx));
+    return (ret);
+}
@@ -0,0 +1,800 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <string.h>
+
+#include <ccrush.h>
+#include <mbedtls/platform_util.h>
+
+#include "cecies/util.h"
+#include "internal.h"
+
+/*
+ * One-shot raw inflate (RFC 1951) for cecies_decompress(): the whole compressed payload is in memory already, so unlike zlib's inflate
+ * this never has to suspend in the middle of a symbol, which makes for a much tighter decoding loop:
+ *
+ * - A 64-bit bit buffer that's refilled with a single unaligned 8-byte load, which always leaves enough bits in it for a whole length/distance pair.
+ * - Huffman decode tables with 10 (literal/length) and 8 (distance) bit primary tables: almost every symbol is decoded with a single lookup,
+ *   and every table entry carries the base value and the number of extra bits too.
+ * - Match copies in 16 (or 8) byte words instead of byte by byte: the output buffer always has some slack after the end, so copies may overshoot.
+ */
+
+#define CECIES_INFLATE_LITLEN_TABLE_BITS 10
+#define CECIES_INFLATE_DIST_TABLE_BITS 8
+#define CECIES_INFLATE_CODELEN_TABLE_BITS 7
+
+/* Primary tables plus room for the largest possible subtables: a subtable of 2^k entries takes at least k+1 codewords (there are at most 288 and 32 of them). */
+#define CECIES_INFLATE_LITLEN_TABLE_SIZE (1024 + 288 / 6 * 32)
+#define CECIES_INFLATE_DIST_TABLE_SIZE (256 + 32 / 8 * 128)
+
+#define CECIES_INFLATE_MAX_CODE_LENGTH 15
+
+/* Longest match plus what a wide copy may overshoot by: the output buffer is grown whenever less than this is left. */
+#define CECIES_INFLATE_OUTPUT_SLACK (258 + 16)
+
+/* Zero bytes that may be fed to the bit buffer past the end of the input before the stream is considered truncated (see cecies_inflate_refill()). */
+#define CECIES_INFLATE_MAX_OVERREAD 8
+
+/*
+ * Decode table entries: the total number of bits to consume (codeword length plus extra bits) in bits 0-7, the codeword length alone in bits 8-11,
+ * the entry's kind flags in bits 12-15 and the value (literal byte, length or distance base, or subtable offset) in bits 16-31.
+ * Length and distance values are then the base plus whatever is above the codeword in the total bits, so that the codeword and extra bits go away in one shift.
+ * Subtable pointers store the number of primary table bits and the subtable's index bits instead. Entries without any flag (all-zero ones) are invalid.
+ */
+#define CECIES_INFLATE_FLAG_END 0x1000
+#define CECIES_INFLATE_FLAG_SUBTABLE 0x2000
+#define CECIES_INFLATE_FLAG_BASE 0x4000
+#define CECIES_INFLATE_FLAG_LITERAL 0x8000
+
+#define CECIES_INFLATE_ENTRY(flags, value, codeword_bits, extra_bits) (((uint32_t)(value) << 16) | (uint32_t)(flags) | ((uint32_t)(codeword_bits) << 8) | ((uint32_t)(codeword_bits) + (uint32_t)(extra_bits)))
+#define CECIES_INFLATE_ENTRY_BITS(entry) ((entry)&0xFF)
+#define CECIES_INFLATE_ENTRY_CODEWORD_BITS(entry) (((entry) >> 8) & 0x0F)
+#define CECIES_INFLATE_ENTRY_VALUE(entry) ((entry) >> 16)
+
+/* Base value plus the extra bits sitting above the codeword, for an entry that's about to be consumed from the (32 lowest bits of the) bit buffer. */
+#define CECIES_INFLATE_ENTRY_DECODE(entry, bits32) (CECIES_INFLATE_ENTRY_VALUE(entry) + (((bits32) & ((UINT32_C(1) << CECIES_INFLATE_ENTRY_BITS(entry)) - 1)) >> CECIES_INFLATE_ENTRY_CODEWORD_BITS(entry)))
+
+static const uint16_t cecies_inflate_length_base[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t cecies_inflate_length_extra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+static const uint16_t cecies_inflate_dist_base[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const uint8_t cecies_inflate_dist_extra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+static const uint8_t cecies_inflate_codelen_order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+typedef struct cecies_inflate_bits
+{
+    const uint8_t* next;
+    const uint8_t* end;
+
+    uint64_t buffer;
+    unsigned int count;
+
+    /* How many zero bytes were fed into the buffer after the input ran out. */
+    size_t overread;
+} cecies_inflate_bits;
+
+typedef struct cecies_inflate_output
+{
+    uint8_t* data;
+    size_t capacity;
+    size_t length;
+} cecies_inflate_output;
+
+static inline uint64_t cecies_inflate_load_le64(const uint8_t* p)
+{
+    return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24) | ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) | ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+}
+
+/*
+ * Tops the bit buffer up to at least 56 bits. Away from the end of the input that's one 8-byte load; at the very end, zero bytes are shifted in
+ * (they're accounted for in overread, so that a stream that really needed them is detected as truncated).
+ */
+static inline void cecies_inflate_refill(cecies_inflate_bits* bits)
+{
+    if (bits->end - bits->next >= 8)
+    {
+        bits->buffer |= cecies_inflate_load_le64(bits->next) << bits->count;
+        bits->next += (63 - bits->count) >> 3;
+        bits->count |= 56;
+        return;
+    }
+
+    while (bits->count <= 56)
+    {
+        if (bits->next < bits->end)
+        {
+            bits->buffer |= (uint64_t)*bits->next++ << bits->count;
+        }
+        else
+        {
+            ++bits->overread;
+        }
+
+        bits->count += 8;
+    }
+}
+
+static inline uint32_t cecies_inflate_take(cecies_inflate_bits* bits, const unsigned int n)
+{
+    const uint32_t value = (uint32_t)(bits->buffer & (((uint64_t)1 << n) - 1));
+    bits->buffer >>= n;
+    bits->count -= n;
+    return value;
+}
+
+/*
+ * How many input bytes were really consumed (whole bytes that are still sitting in the bit buffer don't count).
+ */
+static inline size_t cecies_inflate_position(const cecies_inflate_bits* bits, const uint8_t* start)
+{
+    return (size_t)(bits->next - start) + bits->overread - (bits->count >> 3);
+}
+
+/*
+ * Builds a decode table from the code lengths of n symbols. values, extras and flags describe the symbols (NULL extras: no extra bits).
+ * Returns 0 on success or 1 if the code lengths don't describe a valid prefix code (incomplete codes are only accepted for a single code of length 1, just like zlib does it).
+ */
+static int cecies_inflate_build_table(uint32_t* table, const size_t table_size, const unsigned int table_bits, const uint8_t* lengths, const unsigned int n, const uint16_t* values, const uint8_t* extras, const uint16_t* flags)
+{
+    unsigned int count[CECIES_INFLATE_MAX_CODE_LENGTH + 1] = { 0 };
+    unsigned int offsets[CECIES_INFLATE_MAX_CODE_LENGTH + 2];
+    uint16_t sorted[288];
+
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        ++count[lengths[i]];
+    }
+
+    unsigned int max_length = CECIES_INFLATE_MAX_CODE_LENGTH;
+    while (max_length > 0 && count[max_length] == 0)
+    {
+        --max_length;
+    }
+
+    // Every entry is invalid until a codeword claims it: that's what incomplete codes (and empty ones) decode to.
+    memset(table, 0x00, ((size_t)1 << table_bits) * sizeof(uint32_t));
+
+    // No codes at all is fine (e.g. a block without any matches may have no distance codes).
+    if (max_length == 0)
+    {
+        return 0;
+    }
+
+    // Check for an over-subscribed or incomplete set of lengths.
+    int left = 1;
+    for (unsigned int length = 1; length <= CECIES_INFLATE_MAX_CODE_LENGTH; ++length)
+    {
+        left = (left << 1) - (int)count[length];
+        if (left < 0)
+        {
+            return 1;
+        }
+    }
+
+    if (left > 0 && max_length != 1)
+    {
+        return 1;
+    }
+
+    offsets[1] = 0;
+    for (unsigned int length = 1; length <= CECIES_INFLATE_MAX_CODE_LENGTH; ++length)
+    {
+        offsets[length + 1] = offsets[length] + count[length];
+    }
+
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        if (lengths[i] != 0)
+        {
+            sorted[offsets[lengths[i]]++] = (uint16_t)i;
+        }
+    }
+
+    const uint32_t table_mask = ((uint32_t)1 << table_bits) - 1;
+
+    uint32_t code = 0; // Canonical codeword (most significant bit first).
+    unsigned int index = 0;
+
+    uint32_t current_prefix = UINT32_MAX;
+    size_t subtable_start = 0;
+    unsigned int subtable_bits = 0;
+    size_t next_subtable = (size_t)1 << table_bits;
+
+    for (unsigned int length = 1; length <= max_length; ++length)
+    {
+        for (unsigned int remaining = count[length]; remaining > 0; --remaining, ++index, ++code)
+        {
+            const unsigned int symbol = sorted[index];
+
+            // The bit stream is read least significant bit first, so the table is indexed by the reversed codeword.
+            uint32_t reversed = 0;
+            for (unsigned int b = 0; b < length; ++b)
+            {
+                reversed |= ((code >> b) & 1) << (length - 1 - b);
+            }
+
+            if (length <= table_bits)
+            {
+                const uint32_t entry = CECIES_INFLATE_ENTRY(flags[symbol], values[symbol], length, extras != NULL ? extras[symbol] : 0);
+
+                for (uint32_t i = reversed; i <= table_mask; i += (uint32_t)1 << length)
+                {
+                    table[i] = entry;
+                }
+
+                continue;
+            }
+
+            const uint32_t prefix = reversed & table_mask;
+
+            if (prefix != current_prefix)
+            {
+                // A new subtable: just big enough for the codewords that share this prefix (they're next in canonical order).
+                subtable_bits = length - table_bits;
+                int room = 1 << subtable_bits;
+
+                for (unsigned int l = length;;)
+                {
+                    room -= (int)(l == length ? remaining : count[l]);
+                    if (room <= 0 || l == max_length)
+                    {
+                        break;
+                    }
+
+                    ++l;
+                    ++subtable_bits;
+                    room <<= 1;
+                }
+
+                if (next_subtable + ((size_t)1 << subtable_bits) > table_size)
+                {
+                    return 1;
+                }
+
+                current_prefix = prefix;
+                subtable_start = next_subtable;
+                next_subtable += (size_t)1 << subtable_bits;
+
+                memset(table + subtable_start, 0x00, ((size_t)1 << subtable_bits) * sizeof(uint32_t));
+                table[prefix] = ((uint32_t)subtable_start << 16) | CECIES_INFLATE_FLAG_SUBTABLE | ((uint32_t)subtable_bits << 8) | table_bits;
+            }
+
+            const unsigned int sub_length = length - table_bits;
+            const uint32_t entry = CECIES_INFLATE_ENTRY(flags[symbol], values[symbol], sub_length, extras != NULL ? extras[symbol] : 0);
+
+            for (uint32_t i = reversed >> table_bits; i < ((uint32_t)1 << subtable_bits); i += (uint32_t)1 << sub_length)
+            {
+                table[subtable_start + i] = entry;
+            }
+        }
+
+        code <<= 1;
+    }
+
+    return 0;
+}
+
+/*
+ * Literal/length and distance decode tables for the given code lengths (nlitlen literal/length codes followed by ndist distance codes).
+ */
+static int cecies_inflate_build_tables(uint32_t* litlen_table, uint32_t* dist_table, const uint8_t* lengths, const unsigned int nlitlen, const unsigned int ndist)
+{
+    uint16_t values[288];
+    uint8_t extras[288];
+    uint16_t flags[288];
+
+    for (unsigned int i = 0; i < 288; ++i)
+    {
+        if (i < 256)
+        {
+            values[i] = (uint16_t)i;
+            extras[i] = 0;
+            flags[i] = CECIES_INFLATE_FLAG_LITERAL;
+        }
+        else if (i == 256)
+        {
+            values[i] = 0;
+            extras[i] = 0;
+            flags[i] = CECIES_INFLATE_FLAG_END;
+        }
+        else if (i < 286)
+        {
+            values[i] = cecies_inflate_length_base[i - 257];
+            extras[i] = cecies_inflate_length_extra[i - 257];
+            flags[i] = CECIES_INFLATE_FLAG_BASE;
+        }
+        else
+        {
+            // Symbols 286 and 287 take part in the fixed code, but they're not valid.
+            values[i] = 0;
+            extras[i] = 0;
+            flags[i] = 0;
+        }
+    }
+
+    if (cecies_inflate_build_table(litlen_table, CECIES_INFLATE_LITLEN_TABLE_SIZE, CECIES_INFLATE_LITLEN_TABLE_BITS, lengths, nlitlen, values, extras, flags) != 0)
+    {
+        return 1;
+    }
+
+    for (unsigned int i = 0; i < 32; ++i)
+    {
+        values[i] = i < 30 ? cecies_inflate_dist_base[i] : 0;
+        extras[i] = i < 30 ? cecies_inflate_dist_extra[i] : 0;
+        flags[i] = i < 30 ? CECIES_INFLATE_FLAG_BASE : 0;
+    }
+
+    return cecies_inflate_build_table(dist_table, CECIES_INFLATE_DIST_TABLE_SIZE, CECIES_INFLATE_DIST_TABLE_BITS, lengths + nlitlen, ndist, values, extras, flags);
+}
+
+/*
+ * Reads the code lengths of a dynamic block's header and builds its decode tables.
+ */
+static int cecies_inflate_read_dynamic_header(cecies_inflate_bits* bits, uint32_t* litlen_table, uint32_t* dist_table)
+{
+    uint8_t lengths[286 + 30];
+    uint8_t codelen_lengths[19] = { 0 };
+    uint16_t codelen_values[19];
+    uint16_t codelen_flags[19];
+    uint32_t codelen_table[1 << CECIES_INFLATE_CODELEN_TABLE_BITS];
+
+    cecies_inflate_refill(bits);
+
+    const unsigned int nlitlen = cecies_inflate_take(bits, 5) + 257;
+    const unsigned int ndist = cecies_inflate_take(bits, 5) + 1;
+    const unsigned int ncodelen = cecies_inflate_take(bits, 4) + 4;
+
+    if (nlitlen > 286 || ndist > 30)
+    {
+        return 1;
+    }
+
+    for (unsigned int i = 0; i < ncodelen; ++i)
+    {
+        cecies_inflate_refill(bits);
+        codelen_lengths[cecies_inflate_codelen_order[i]] = (uint8_t)cecies_inflate_take(bits, 3);
+    }
+
+    for (unsigned int i = 0; i < 19; ++i)
+    {
+        codelen_values[i] = (uint16_t)i;
+        codelen_flags[i] = CECIES_INFLATE_FLAG_LITERAL;
+    }
+
+    if (cecies_inflate_build_table(codelen_table, 1 << CECIES_INFLATE_CODELEN_TABLE_BITS, CECIES_INFLATE_CODELEN_TABLE_BITS, codelen_lengths, 19, codelen_values, NULL, codelen_flags) != 0)
+    {
+        return 1;
+    }
+
+    for (unsigned int i = 0; i < nlitlen + ndist;)
+    {
+        cecies_inflate_refill(bits);
+
+        const uint32_t entry = codelen_table[bits->buffer & ((1 << CECIES_INFLATE_CODELEN_TABLE_BITS) - 1)];
+        if ((entry & CECIES_INFLATE_FLAG_LITERAL) == 0)
+        {
+            return 1;
+        }
+
+        cecies_inflate_take(bits, CECIES_INFLATE_ENTRY_BITS(entry));
+
+        const unsigned int symbol = CECIES_INFLATE_ENTRY_VALUE(entry);
+
+        if (symbol < 16)
+        {
+            lengths[i++] = (uint8_t)symbol;
+            continue;
+        }
+
+        uint8_t value = 0;
+        unsigned int repeat;
+
+        if (symbol == 16)
+        {
+            if (i == 0)
+            {
+                return 1;
+            }
+
+            value = lengths[i - 1];
+            repeat = 3 + cecies_inflate_take(bits, 2);
+        }
+        else if (symbol == 17)
+        {
+            repeat = 3 + cecies_inflate_take(bits, 3);
+        }
+        else
+        {
+            repeat = 11 + cecies_inflate_take(bits, 7);
+        }
+
+        if (i + repeat > nlitlen + ndist)
+        {
+            return 1;
+        }
+
+        memset(lengths + i, value, repeat);
+        i += repeat;
+    }
+
+    // Without an end-of-block code the block couldn't ever end.
+    if (lengths[256] == 0)
+    {
+        return 1;
+    }
+
+    return bits->overread > CECIES_INFLATE_MAX_OVERREAD || cecies_inflate_build_tables(litlen_table, dist_table, lengths, nlitlen, ndist);
+}
+
+/*
+ * Makes room for at least needed more bytes. Not realloc(): the old buffer holds plaintext and needs to be wiped.
+ */
+static int cecies_inflate_grow(cecies_inflate_output* output, const size_t needed)
+{
+    size_t capacity = output->capacity;
+    while (capacity - output->length < needed)
+    {
+        if (capacity > SIZE_MAX / 2)
+        {
+            return CCRUSH_ERROR_OUT_OF_MEMORY;
+        }
+
+        capacity *= 2;
+    }
+
+    uint8_t* grown = cecies_malloc(capacity);
+    if (grown == NULL)
+    {
+        return CCRUSH_ERROR_OUT_OF_MEMORY;
+    }
+
+    memcpy(grown, output->data, output->length);
+    mbedtls_platform_zeroize(output->data, output->capacity);
+    cecies_free(output->data);
+
+    output->data = grown;
+    output->capacity = capacity;
+    return 0;
+}
+
+/*
+ * Copies a match of the given length from distance bytes back. Copies overshoot by up to 15 bytes (there's always enough slack in the output buffer for that).
+ */
+static inline void cecies_inflate_copy_match(uint8_t* out, const size_t distance, const size_t length)
+{
+    const uint8_t* src = out - distance;
+    uint8_t* const end = out + length;
+
+    if (distance >= 16)
+    {
+        // Source and destination words never overlap.
+        do
+        {
+            memcpy(out, src, 16);
+            out += 16;
+            src += 16;
+        } while (out < end);
+    }
+    else if (distance >= 8)
+    {
+        do
+        {
+            memcpy(out, src, 8);
+            out += 8;
+            src += 8;
+        } while (out < end);
+    }
+    else if (distance == 1)
+    {
+        memset(out, *src, length);
+    }
+    else
+    {
+        while (out < end)
+        {
+            *out++ = *src++;
+        }
+    }
+}
+
+/*
+ * Decodes the symbols of one Huffman-coded block.
+ * The bit reader's state lives in local variables while decoding: stores to the (byte) output could alias it otherwise, which would force it to be reloaded after every single symbol.
+ */
+static int cecies_inflate_block(cecies_inflate_bits* bits, cecies_inflate_output* output, const uint32_t* litlen_table, const uint32_t* dist_table)
+{
+    const uint64_t litlen_mask = ((uint64_t)1 << CECIES_INFLATE_LITLEN_TABLE_BITS) - 1;
+    const uint64_t dist_mask = ((uint64_t)1 << CECIES_INFLATE_DIST_TABLE_BITS) - 1;
+
+    const uint8_t* in = bits->next;
+    const uint8_t* const in_end = bits->end;
+    uint64_t buffer = bits->buffer;
+    unsigned int count = bits->count;
+
+    uint8_t* out_start = output->data;
+    uint8_t* out = output->data + output->length;
+    uint8_t* out_limit = output->data + output->capacity - CECIES_INFLATE_OUTPUT_SLACK;
+
+    int ret = 0;
+
+    for (;;)
+    {
+        if (out > out_limit)
+        {
+            output->length = (size_t)(out - output->data);
+
+            ret = cecies_inflate_grow(output, CECIES_INFLATE_OUTPUT_SLACK);
+            if (ret != 0)
+            {
+                break;
+            }
+
+            out_start = output->data;
+            out = output->data + output->length;
+            out_limit = output->data + output->capacity - CECIES_INFLATE_OUTPUT_SLACK;
+        }
+
+        // At least 56 bits: enough for a literal/length code with its extra bits (15 + 5) and a distance code with its extra bits (15 + 13).
+        if (in_end - in >= 8)
+        {
+            buffer |= cecies_inflate_load_le64(in) << count;
+            in += (63 - count) >> 3;
+            count |= 56;
+        }
+        else
+        {
+            bits->next = in;
+            bits->buffer = buffer;
+            bits->count = count;
+
+            cecies_inflate_refill(bits);
+
+            if (bits->overread > CECIES_INFLATE_MAX_OVERREAD)
+            {
+                ret = CCRUSH_ERROR_ZLIB;
+                break;
+            }
+
+            in = bits->next;
+            buffer = bits->buffer;
+            count = bits->count;
+        }
+
+        uint32_t entry = litlen_table[buffer & litlen_mask];
+
+        if (entry & CECIES_INFLATE_FLAG_LITERAL)
+        {
+            // Up to two more literals fit into what's left of the bit buffer (a subtable lookup takes 15 bits at most).
+            for (int i = 0; i < 3 && (entry & CECIES_INFLATE_FLAG_LITERAL); ++i)
+            {
+                *out++ = (uint8_t)CECIES_INFLATE_ENTRY_VALUE(entry);
+                buffer >>= CECIES_INFLATE_ENTRY_BITS(entry);
+                count -= CECIES_INFLATE_ENTRY_BITS(entry);
+                entry = litlen_table[buffer & litlen_mask];
+            }
+
+            continue;
+        }
+
+        if ((entry & CECIES_INFLATE_FLAG_BASE) == 0)
+        {
+            if (entry & CECIES_INFLATE_FLAG_SUBTABLE)
+            {
+                buffer >>= CECIES_INFLATE_ENTRY_BITS(entry);
+                count -= CECIES_INFLATE_ENTRY_BITS(entry);
+                entry = litlen_table[CECIES_INFLATE_ENTRY_VALUE(entry) + (buffer & (((uint64_t)1 << CECIES_INFLATE_ENTRY_CODEWORD_BITS(entry)) - 1))];
+            }
+
+            if (entry & CECIES_INFLATE_FLAG_LITERAL)
+            {
+                *out++ = (uint8_t)CECIES_INFLATE_ENTRY_VALUE(entry);
+                buffer >>= CECIES_INFLATE_ENTRY_BITS(entry);
+                count -= CECIES_INFLATE_ENTRY_BITS(entry);
+                continue;
+            }
+
+            if ((entry & CECIES_INFLATE_FLAG_BASE) == 0)
+            {
+                ret = (entry & CECIES_INFLATE_FLAG_END) ? 0 : CCRUSH_ERROR_ZLIB;
+                buffer >>= CECIES_INFLATE_ENTRY_BITS(entry);
+                count -= CECIES_INFLATE_ENTRY_BITS(entry);
+                break;
+            }
+        }
+
+        const size_t length = CECIES_INFLATE_ENTRY_DECODE(entry, (uint32_t)buffer);
+        buffer >>= CECIES_INFLATE_ENTRY_BITS(entry);
+        count -= CECIES_INFLATE_ENTRY_BITS(entry);
+
+        entry = dist_table[buffer & dist_mask];
+
+        if (entry & CECIES_INFLATE_FLAG_SUBTABLE)
+        {
+            buffer >>= CECIES_INFLATE_ENTRY_BITS(entry);
+            count -= CECIES_INFLATE_ENTRY_BITS(entry);
+            entry = dist_table[CECIES_INFLATE_ENTRY_VALUE(entry) + (buffer & (((uint64_t)1 << CECIES_INFLATE_ENTRY_CODEWORD_BITS(entry)) - 1))];
+        }
+
+        if ((entry & CECIES_INFLATE_FLAG_BASE) == 0)
+        {
+            ret = CCRUSH_ERROR_ZLIB;
+            break;
+        }
+
+        const size_t distance = CECIES_INFLATE_ENTRY_DECODE(entry, (uint32_t)buffer);
+        buffer >>= CECIES_INFLATE_ENTRY_BITS(entry);
+        count -= CECIES_INFLATE_ENTRY_BITS(entry);
+
+        if (distance > (size_t)(out - out_start))
+        {
+            ret = CCRUSH_ERROR_ZLIB;
+            break;
+        }
+
+        cecies_inflate_copy_match(out, distance, length);
+        out += length;
+    }
+
+    output->length = (size_t)(out - output->data);
+
+    bits->next = in;
+    bits->buffer = buffer;
+    bits->count = count;
+
+    return ret;
+}
+
+/*
+ * Copies a stored block straight from the input.
+ */
+static int cecies_inflate_stored(cecies_inflate_bits* bits, cecies_inflate_output* output, const uint8_t* start)
+{
+    // Stored blocks start at the next byte boundary: rewind the input to where the bit buffer is at.
+    cecies_inflate_take(bits, bits->count & 7);
+
+    const size_t input_length = (size_t)(bits->end - start);
+    const size_t position = cecies_inflate_position(bits, start);
+
+    if (position > input_length || input_length - position < 4)
+    {
+        return CCRUSH_ERROR_ZLIB;
+    }
+
+    const uint8_t* in = start + position;
+    const size_t length = (size_t)in[0] | ((size_t)in[1] << 8);
+    const size_t nlength = (size_t)in[2] | ((size_t)in[3] << 8);
+    in += 4;
+
+    if (length != (~nlength & 0xFFFF) || (size_t)(bits->end - in) < length)
+    {
+        return CCRUSH_ERROR_ZLIB;
+    }
+
+    if (output->capacity - output->length < length + CECIES_INFLATE_OUTPUT_SLACK)
+    {
+        const int ret = cecies_inflate_grow(output, length + CECIES_INFLATE_OUTPUT_SLACK);
+        if (ret != 0)
+        {
+            return ret;
+        }
+    }
+
+    memcpy(output->data + output->length, in, length);
+    output->length += length;
+
+    bits->next = in + length;
+    bits->buffer = 0;
+    bits->count = 0;
+    return 0;
+}
+
+int cecies_inflate_raw(const uint8_t* input, const size_t input_length, const size_t output_size_hint, uint8_t** out_data, size_t* out_data_length)
+{
+    if (input == NULL || out_data == NULL || out_data_length == NULL)
+    {
+        return CCRUSH_ERROR_INVALID_ARGS;
+    }
+
+    int ret = 1;
+
+    cecies_inflate_bits bits;
+    memset(&bits, 0x00, sizeof(bits));
+    bits.next = input;
+    bits.end = input + input_length;
+
+    cecies_inflate_output output;
+    output.capacity = CECIES_MAX(output_size_hint, 4096);
+    output.length = 0;
+    output.data = cecies_malloc(output.capacity);
+
+    uint32_t* tables = cecies_malloc((CECIES_INFLATE_LITLEN_TABLE_SIZE + CECIES_INFLATE_DIST_TABLE_SIZE) * sizeof(uint32_t));
+
+    if (output.data == NULL || tables == NULL)
+    {
+        ret = CCRUSH_ERROR_OUT_OF_MEMORY;
+        goto exit;
+    }
+
+    uint32_t* litlen_table = tables;
+    uint32_t* dist_table = tables + CECIES_INFLATE_LITLEN_TABLE_SIZE;
+
+    for (int last = 0; !last;)
+    {
+        cecies_inflate_refill(&bits);
+
+        last = (int)cecies_inflate_take(&bits, 1);
+        const uint32_t type = cecies_inflate_take(&bits, 2);
+
+        switch (type)
+        {
+            case 0:
+                ret = cecies_inflate_stored(&bits, &output, input);
+                break;
+            case 1: {
+                uint8_t lengths[288 + 32];
+                memset(lengths, 8, 144);
+                memset(lengths + 144, 9, 112);
+                memset(lengths + 256, 7, 24);
+                memset(lengths + 280, 8, 8);
+                memset(lengths + 288, 5, 32);
+
+                ret = cecies_inflate_build_tables(litlen_table, dist_table, lengths, 288, 32);
+                ret = ret == 0 ? cecies_inflate_block(&bits, &output, litlen_table, dist_table) : CCRUSH_ERROR_ZLIB;
+                break;
+            }
+            case 2:
+                ret = cecies_inflate_read_dynamic_header(&bits, litlen_table, dist_table);
+                ret = ret == 0 ? cecies_inflate_block(&bits, &output, litlen_table, dist_table) : CCRUSH_ERROR_ZLIB;
+                break;
+            default:
+                ret = CCRUSH_ERROR_ZLIB;
+                break;
+        }
+
+        if (ret != 0)
+        {
+            goto exit;
+        }
+    }
+
+    // The stream has to end (rounded up to a whole byte) exactly where the input does.
+    cecies_inflate_take(&bits, bits.count & 7);
+
+    if (cecies_inflate_position(&bits, input) != input_length)
+    {
+        ret = CCRUSH_ERROR_ZLIB;
+        goto exit;
+    }
+
+    // Wide copies may have overshot the end of the output by a few bytes: callers only ever wipe out_data_length bytes.
+    mbedtls_platform_zeroize(output.data + output.length, CECIES_MIN(output.capacity - output.length, 16));
+
+    *out_data = output.data;
+    *out_data_length = output.length;
+    output.data = NULL;
+    ret = 0;
+
+exit:
+    if (output.data != NULL)
+    {
+        mbedtls_platform_zeroize(output.data, output.capacity);
+        cecies_free(output.data);
+    }
+
+    cecies_free(tables);
+    return (ret);
+}
@@ -0,0 +1,128 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include <mbedtls/base64.h>
+
+#include "cecies/util.h"
+#include "cecies/inspect.h"
+#include "internal.h"
+
+#include "cecies/data.txt"
+
+// Longest possible header + 1 byte of payload.
+#define CECIES_INSPECT_MAX_HEADER_LENGTH (CECIES_MAX_HEADER_SIZE + 1)
+
+// Amount of base64 characters that need decoding to obtain the longest possible header (rounded up to whole 4-character groups).
+#define CECIES_INSPECT_MAX_HEADER_BASE64_LENGTH (((CECIES_INSPECT_MAX_HEADER_LENGTH + 2) / 3) * 4)
+
+int cecies_inspect(const uint8_t* encrypted_data, size_t encrypted_data_length, const int encrypted_data_base64, int curve, cecies_ciphertext_info* out_info)
+{
+    if (encrypted_data == NULL || out_info == NULL)
+    {
+        cecies_fprintf(stderr, "CECIES: inspection failed: one or more NULL arguments.\n");
+        return CECIES_DECRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    if (encrypted_data_length == 0 || curve < -1 || curve > 1)
+    {
+        cecies_fprintf(stderr, "CECIES: inspection failed: one or more invalid arguments.\n");
+        return CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    uint8_t prefix[CECIES_INSPECT_MAX_HEADER_BASE64_LENGTH / 4 * 3];
+
+    const uint8_t* input = encrypted_data;
+    size_t input_length = encrypted_data_length;
+    size_t binary_length = encrypted_data_length;
+
+    if (encrypted_data_base64)
+    {
+        if (encrypted_data[encrypted_data_length - 1] == '\0')
+        {
+            encrypted_data_length--;
+        }
+
+        if (encrypted_data_length == 0 || encrypted_data_length % 4 != 0)
+        {
+            cecies_fprintf(stderr, "CECIES: inspection failed: invalid base64 length.\n");
+            return CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+        }
+
+        const size_t padding = (encrypted_data[encrypted_data_length - 1] == '=') + (encrypted_data[encrypted_data_length - 2] == '=');
+        binary_length = encrypted_data_length / 4 * 3 - padding;
+
+        const size_t prefix_base64_length = CECIES_MIN(encrypted_data_length, CECIES_INSPECT_MAX_HEADER_BASE64_LENGTH);
+
+        const int ret = mbedtls_base64_decode(prefix, sizeof(prefix), &input_length, encrypted_data, prefix_base64_length);
+        if (ret != 0)
+        {
+            cecies_fprintf(stderr, "CECIES: inspection failed: couldn't base64-decode the ciphertext header! mbedtls_base64_decode returned %d\n", ret);
+            return CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+        }
+
+        input = prefix;
+    }
+
+    const int has_ext_header = input_length > CECIES_EXT_HEADER_MAGIC_SIZE && memcmp(input, cecies_ext_header_magic, CECIES_EXT_HEADER_MAGIC_SIZE) == 0;
+
+    if (has_ext_header)
+    {
+        curve = (input[CECIES_EXT_HEADER_MAGIC_SIZE] & CECIES_HEADER_FLAG_CURVE448) ? 1 : 0;
+    }
+    else if (curve == -1)
+    {
+        cecies_fprintf(stderr, "CECIES: inspection failed: the ciphertext has no extended header, so the curve needs to be passed explicitly.\n");
+        return CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    cecies_header header;
+
+    const int ret = cecies_parse_header(input, input_length, curve, &header);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    memset(out_info, 0x00, sizeof(cecies_ciphertext_info));
+
+    out_info->curve = curve;
+    out_info->header_flags = header.flags;
+    out_info->binary_length = binary_length;
+    out_info->ext_header_length = header.ext_length;
+    out_info->iv_offset = (size_t)(header.iv - input);
+    out_info->salt_offset = (size_t)(header.salt - input);
+    out_info->ephemeral_public_key_offset = (size_t)(header.R - input);
+    out_info->tag_offset = (size_t)(header.tag - input);
+    out_info->payload_offset = (size_t)(header.ciphertext - input);
+    out_info->payload_length = binary_length - out_info->payload_offset;
+    out_info->ephemeral_public_key_length = curve == 0 ? CECIES_X25519_KEY_SIZE : CECIES_X448_KEY_SIZE;
+    out_info->has_key_id = header.key_id != NULL;
+    out_info->has_key_commitment = header.key_commitment != NULL;
+    out_info->is_compressed = header.ext != NULL ? (header.flags & CECIES_HEADER_FLAG_COMPRESSED) != 0 : -1;
+    out_info->plaintext_length_bound = out_info->is_compressed == 0 ? out_info->payload_length : SIZE_MAX;
+
+    memcpy(out_info->ephemeral_public_key, header.R, out_info->ephemeral_public_key_length);
+
+    if (header.key_id != NULL)
+    {
+        memcpy(out_info->key_id, header.key_id, CECIES_KEY_ID_SIZE);
+    }
+
+    return 0;
+}
@@ -0,0 +1,674 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/*
+ * Internal helpers that are shared between the CECIES translation units.
+ * This header is NOT part of the public API: don't include it from outside of the src/ folder!
+ */
+
+#ifndef CECIES_INTERNAL_H
+#define CECIES_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include <mbedtls/gcm.h>
+#include <mbedtls/ecp.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ctr_drbg.h>
+
+#include "cecies/constants.h"
+
+#ifdef _MSC_VER
+#define CECIES_THREAD_LOCAL __declspec(thread)
+#else
+#define CECIES_THREAD_LOCAL _Thread_local
+#endif
+
+/*
+ * Allocation functions that go through the allocator set using cecies_set_allocator() (free using cecies_free()).
+ * With the default allocator, they return plain malloc() blocks.
+ * All allocations inside CECIES must use these, so that they're counted and can be pooled.
+ */
+void* cecies_malloc(size_t size);
+void* cecies_calloc(size_t count, size_t size);
+
+/*
+ * A caller-provided memory region (e.g. on the stack) that serves allocations instead of the allocator.
+ */
+typedef struct cecies_arena
+{
+    uint8_t* buffer;
+    size_t size;
+    size_t top;
+
+    /* High-water mark (everything below it gets wiped when the arena is popped). */
+    size_t peak;
+
+    struct cecies_arena* previous;
+
+    /* The next one in the list of all threads' pushed arenas (which cecies_free() looks blocks up in). */
+    struct cecies_arena* next_live;
+} cecies_arena;
+
+/*
+ * Makes the given buffer serve all of the calling thread's cecies_malloc()/cecies_calloc() calls (and thus MbedTLS' allocations, if it's built with MBEDTLS_PLATFORM_MEMORY)
+ * until cecies_arena_pop() is called. Allocations fail once the buffer is full. Blocks carved out of it can be freed by any thread (using cecies_free()).
+ */
+void cecies_arena_push(cecies_arena* arena, void* buffer, size_t buffer_size);
+
+/*
+ * Wipes the arena's buffer and restores whatever served the calling thread's allocations before. Everything allocated from the arena must be freed by then.
+ */
+void cecies_arena_pop(cecies_arena* arena);
+
+/*
+ * zlib allocation hooks (for z_stream's zalloc and zfree) on top of cecies_malloc() and cecies_free().
+ */
+void* cecies_zalloc(void* opaque, unsigned int items, unsigned int size);
+void cecies_zfree(void* opaque, void* address);
+
+/*
+ * All extended ciphertext header flags that can be passed to the encryption functions.
+ */
+#define CECIES_HEADER_FLAGS_SUPPORTED (CECIES_HEADER_FLAG_CURVE448 | CECIES_HEADER_FLAG_KEY_ID | CECIES_HEADER_FLAG_KEY_COMMITMENT)
+
+/*
+ * All extended ciphertext header flags that this version of CECIES understands when parsing a ciphertext (including the ones that only the library itself sets).
+ */
+#define CECIES_HEADER_FLAGS_KNOWN (CECIES_HEADER_FLAGS_SUPPORTED | CECIES_HEADER_FLAG_COMPRESSED)
+
+/*
+ * A parsed ciphertext header. All pointers point into the (decoded) ciphertext buffer that was passed to cecies_parse_header().
+ */
+typedef struct cecies_header
+{
+    /* The extended header (authenticated as additional data by AES-GCM); NULL for plain ciphertexts. */
+    const uint8_t* ext;
+    size_t ext_length;
+
+    /* CECIES_HEADER_FLAG_* flags (always 0 for plain ciphertexts). */
+    int flags;
+
+    /* Key ID hint (NULL if the ciphertext doesn't carry one). */
+    const uint8_t* key_id;
+
+    /* Key commitment value (NULL if the ciphertext doesn't carry one). */
+    const uint8_t* key_commitment;
+
+    const uint8_t* iv;
+    const uint8_t* salt;
+    const uint8_t* R;
+    const uint8_t* tag;
+
+    const uint8_t* ciphertext;
+    size_t ciphertext_length;
+} cecies_header;
+
+/*
+ * Computes the key ID of a raw (binary) public key: the first CECIES_KEY_ID_SIZE bytes of its SHA2-512 hash.
+ */
+void cecies_calc_key_id(const uint8_t* public_key, size_t public_key_length, uint8_t key_id[CECIES_KEY_ID_SIZE]);
+
+/*
+ * Derives the AES-256 key from a shared secret: HKDF-SHA512 with the ciphertext's salt and empty info.
+ * If key_commitment isn't NULL, CECIES_KEY_COMMITMENT_SIZE bytes of key commitment value are expanded from the same pseudorandom key (using a distinct info label) and written into it.
+ * Returns 0 on success or an MbedTLS error code on failure.
+ */
+int cecies_derive_keys(const uint8_t* salt, const uint8_t* shared_secret, size_t shared_secret_length, uint8_t aes_key[32], uint8_t* key_commitment);
+
+/*
+ * cecies_derive_keys() for count messages at once (all with equally long shared secrets), through the multi-buffer SHA-512 (see cecies_set_multi_buffer_sha512()).
+ * key_commitments[i] may be NULL for the messages that don't need one. The keys are byte for byte the ones cecies_derive_keys() would give; results[i] is set to 0 or an error code.
+ */
+void cecies_derive_keys_multi(const uint8_t* const* salts, const uint8_t* const* shared_secrets, size_t shared_secret_length, uint8_t* const* aes_keys, uint8_t* const* key_commitments, size_t count, int* results);
+
+/*
+ * Everything that's needed for encrypting a payload to a recipient: the output of the ephemeral key exchange and key derivation.
+ */
+typedef struct cecies_encryption_setup
+{
+    int curve;
+    int header_flags;
+    size_t ext_header_length;
+
+    /* Length of the full ciphertext header (extended header + IV + salt + R + tag): the payload starts right after it. */
+    size_t header_length;
+
+    uint8_t iv[16];
+    uint8_t salt[32];
+    uint8_t R[CECIES_X448_KEY_SIZE];
+    uint8_t aes_key[32];
+    uint8_t key_id[CECIES_KEY_ID_SIZE];
+    uint8_t key_commitment[CECIES_KEY_COMMITMENT_SIZE];
+} cecies_encryption_setup;
+
+/*
+ * Generates an ephemeral key pair, performs the key exchange with the recipient's public key (hex string) and derives the AES key (and everything else the header_flags ask for).
+ * Returns 0 on success or an error code on failure (in that case the setup is zeroed).
+ */
+int cecies_encryption_setup_init(const char* public_key, int header_flags, int curve, cecies_encryption_setup* setup);
+
+/*
+ * Curve-specialized variants of cecies_encryption_setup_init() (generated from curve_impl.h).
+ */
+int cecies_curve25519_encryption_setup_init(const char* public_key, int header_flags, cecies_encryption_setup* setup);
+int cecies_curve448_encryption_setup_init(const char* public_key, int header_flags, cecies_encryption_setup* setup);
+
+/*
+ * Parsed and validated keys of one curve, together with the loaded ECP group and a seeded CTR_DRBG: everything that would otherwise be set up (and torn down) again for every single en-/decryption.
+ * It's not thread-safe, since every operation draws from the CTR_DRBG. The CTR_DRBG points to the entropy context inside the struct, so don't move it around once initialized!
+ */
+typedef struct cecies_key_state
+{
+    int curve;
+    int has_public_key;
+    int has_private_key;
+    mbedtls_ecp_group ecp_group;
+    mbedtls_entropy_context entropy;
+    mbedtls_ctr_drbg_context ctr_drbg;
+    mbedtls_ecp_point QA;
+    mbedtls_mpi dA;
+    uint8_t public_key[CECIES_X448_KEY_SIZE];
+} cecies_key_state;
+
+/*
+ * Initializes a key state for the respective curve (generated from curve_impl.h) using a raw (binary) public and/or private key (pass NULL for the one you don't need).
+ * Returns 0 on success (free the state using cecies_key_state_free() afterwards) or an error code on failure (the state then doesn't need to be freed).
+ */
+int cecies_curve25519_key_state_init(cecies_key_state* state, const uint8_t* public_key, const uint8_t* private_key);
+int cecies_curve448_key_state_init(cecies_key_state* state, const uint8_t* public_key, const uint8_t* private_key);
+
+/*
+ * Frees a key state and wipes the keys it holds.
+ */
+void cecies_key_state_free(cecies_key_state* state);
+
+/*
+ * Like cecies_encryption_setup_init(), but with the recipient's public key (and everything else) taken from an initialized key state (generated from curve_impl.h).
+ */
+int cecies_curve25519_encryption_setup_init_from_state(cecies_key_state* state, int header_flags, cecies_encryption_setup* setup);
+int cecies_curve448_encryption_setup_init_from_state(cecies_key_state* state, int header_flags, cecies_encryption_setup* setup);
+
+/*
+ * The part of cecies_*_encryption_setup_init_from_state() that comes after the key agreement, for when the ephemeral public key R and the shared secret S (both raw) were computed elsewhere.
+ */
+int cecies_curve25519_encryption_setup_init_from_secret(cecies_key_state* state, int header_flags, const uint8_t* R_bytes, const uint8_t* S_bytes, cecies_encryption_setup* setup);
+int cecies_curve448_encryption_setup_init_from_secret(cecies_key_state* state, int header_flags, const uint8_t* R_bytes, const uint8_t* S_bytes, cecies_encryption_setup* setup);
+
+/*
+ * Everything of cecies_*_encryption_setup_init_from_secret() except the key derivation (salt, IV, R and key ID): for deriving the keys of several setups at once (see cecies_derive_keys_multi()).
+ * The setup's keys then need to be derived from its salt and checked with cecies_encryption_setup_check_keys().
+ */
+int cecies_curve25519_encryption_setup_prepare(cecies_key_state* state, int header_flags, const uint8_t* R_bytes, cecies_encryption_setup* setup);
+int cecies_curve448_encryption_setup_prepare(cecies_key_state* state, int header_flags, const uint8_t* R_bytes, cecies_encryption_setup* setup);
+
+/*
+ * Checks the outcome (ret) of deriving a setup's keys: on failure (or an all-zero AES key), the setup is zeroed and an error code returned.
+ */
+int cecies_encryption_setup_check_keys(int ret, cecies_encryption_setup* setup);
+
+/*
+ * Writes the ciphertext header (setup->header_length bytes) into output. The tag slot at the end of the header is zeroed: it needs to be filled in once encryption is complete.
+ */
+void cecies_encryption_setup_write_header(const cecies_encryption_setup* setup, uint8_t* output);
+
+/*
+ * Checks whether the given (decrypted) data starts with one of the zlib headers that compressed CECIES payloads start with.
+ */
+int cecies_is_zlib_header(const uint8_t* data, size_t data_length);
+
+#define CECIES_PAYLOAD_PLAIN 0
+#define CECIES_PAYLOAD_COMPRESSED 1
+#define CECIES_PAYLOAD_MAYBE_COMPRESSED 2
+
+/*
+ * Tells whether a decrypted payload needs inflating. Ciphertexts with an extended header say so themselves (CECIES_HEADER_FLAG_COMPRESSED): CECIES_PAYLOAD_COMPRESSED or CECIES_PAYLOAD_PLAIN.
+ * Legacy ciphertexts without one carry no flag, so their payload is sniffed for a zlib header instead: CECIES_PAYLOAD_MAYBE_COMPRESSED if it starts with one (the plaintext may only happen to), CECIES_PAYLOAD_PLAIN otherwise.
+ */
+int cecies_payload_compression(const cecies_header* header, const uint8_t* data, size_t data_length);
+
+/*
+ * Decompresses the given (decrypted) payload in place if cecies_payload_compression() says so: on success, *data is replaced by the decompressed buffer (the old one is zeroed and freed).
+ * Returns CECIES_DECRYPT_ERROR_CODE_DECOMPRESSION_FAILED if a payload flagged as compressed fails to inflate (*data is left as it is: the caller wipes and frees it). Legacy payloads that only look compressed are kept as they are.
+ */
+int cecies_decompress_if_needed(const cecies_header* header, uint8_t** data, size_t* data_length);
+
+/*
+ * Base64-decodes the given ciphertext if needed. If encrypted_data_base64 is set, *input is allocated and needs to be freed by the caller; otherwise it just points to encrypted_data.
+ * Returns 0 on success, or a CECIES_DECRYPT_ERROR_CODE_* on failure.
+ */
+int cecies_decode_input(const uint8_t* encrypted_data, size_t encrypted_data_length, int encrypted_data_base64, uint8_t** input, size_t* input_length);
+
+/*
+ * Parses a (decoded) ciphertext header for the given curve (0 for Curve25519 and 1 for Curve448).
+ * Returns 0 on success or CECIES_DECRYPT_ERROR_CODE_INVALID_ARG if the data is too short or the extended header is invalid or meant for another curve.
+ */
+int cecies_parse_header(const uint8_t* input, size_t input_length, int curve, cecies_header* header);
+
+/*
+ * Derives the AES-256 key of a parsed ciphertext using a raw (binary) private key of the given curve (0 for Curve25519 and 1 for Curve448).
+ */
+int cecies_derive_header_key(const cecies_header* header, const uint8_t* private_key, int curve, uint8_t aes_key[32]);
+
+/*
+ * Curve-specialized variants of cecies_derive_header_key() (generated from curve_impl.h).
+ */
+int cecies_curve25519_derive_header_key(const cecies_header* header, const uint8_t* private_key, uint8_t aes_key[32]);
+int cecies_curve448_derive_header_key(const cecies_header* header, const uint8_t* private_key, uint8_t aes_key[32]);
+
+/*
+ * Like cecies_derive_header_key(), but with the private key (and everything else) taken from an initialized key state (generated from curve_impl.h).
+ */
+int cecies_curve25519_derive_header_key_from_state(cecies_key_state* state, const cecies_header* header, uint8_t aes_key[32]);
+int cecies_curve448_derive_header_key_from_state(cecies_key_state* state, const cecies_header* header, uint8_t aes_key[32]);
+
+/*
+ * Reads and validates a parsed ciphertext's ephemeral public key R (generated from curve_impl.h). The point needs to be initialized (and freed) by the caller.
+ */
+int cecies_curve25519_read_ephemeral_key(cecies_key_state* state, const cecies_header* header, mbedtls_ecp_point* R);
+int cecies_curve448_read_ephemeral_key(cecies_key_state* state, const cecies_header* header, mbedtls_ecp_point* R);
+
+/*
+ * Seeds a CTR_DRBG with the entropy context and a freshly randomized personalization string.
+ */
+int cecies_seed_ctr_drbg(mbedtls_ctr_drbg_context* ctr_drbg, mbedtls_entropy_context* entropy);
+
+/*
+ * Computes the shared secret S = dA * R and derives the AES key from it (HKDF-SHA512 using the ciphertext's salt).
+ * If the ciphertext carries a key commitment value, it's checked right away and CECIES_DECRYPT_ERROR_CODE_WRONG_KEY is returned (silently) on mismatch.
+ */
+int cecies_derive_aes_key(mbedtls_ecp_group* ecp_group, mbedtls_ctr_drbg_context* ctr_drbg, const mbedtls_mpi* dA, const mbedtls_ecp_point* R, const cecies_header* header, size_t key_length, uint8_t aes_key[32]);
+
+/*
+ * The part of cecies_derive_aes_key() that comes after the key agreement, for when the (raw) shared secret S was computed elsewhere.
+ */
+int cecies_derive_aes_key_from_secret(const uint8_t* S_bytes, size_t S_bytes_length, const cecies_header* header, uint8_t aes_key[32]);
+
+/*
+ * Checks the outcome (ret) of deriving a ciphertext's AES key (and key commitment, if the header has one): returns CECIES_DECRYPT_ERROR_CODE_WRONG_KEY (silently) if the key commitment doesn't match.
+ */
+int cecies_check_derived_aes_key(int ret, const cecies_header* header, const uint8_t aes_key[32], const uint8_t* key_commitment);
+
+/*
+ * Decrypts a parsed ciphertext using a raw (binary) private key of the given curve (0 for Curve25519 and 1 for Curve448).
+ * Compressed payloads are only decompressed if decompress is set. On success, *output is allocated and needs to be freed by the caller.
+ */
+int cecies_decrypt_header(const cecies_header* header, const uint8_t* private_key, int curve, int decompress, uint8_t** output, size_t* output_length);
+
+/*
+ * Checks a parsed ciphertext's authentication tag using a raw (binary) private key of the given curve, without decrypting anything.
+ * Returns 0 if the ciphertext is authentic, CECIES_DECRYPT_ERROR_CODE_VERIFICATION_FAILED if it isn't, or another error code on failure.
+ */
+int cecies_verify_header(const cecies_header* header, const uint8_t* private_key, int curve);
+
+/*
+ * Decrypts (and, if decompress is set, decompresses if needed) a parsed ciphertext's payload using an already derived AES-256 key.
+ * On success, *output is allocated and needs to be freed by the caller.
+ */
+int cecies_decrypt_payload(const cecies_header* header, const uint8_t aes_key[32], int decompress, uint8_t** output, size_t* output_length);
+
+#define CECIES_DECRYPT_MODE_DECRYPT 0
+#define CECIES_DECRYPT_MODE_VERIFY 1
+#define CECIES_DECRYPT_MODE_RAW 2
+
+/*
+ * Decodes, parses and decrypts (CECIES_DECRYPT_MODE_DECRYPT), only verifies (CECIES_DECRYPT_MODE_VERIFY, output is ignored)
+ * or decrypts without decompressing (CECIES_DECRYPT_MODE_RAW) a ciphertext using a hex-encoded private key.
+ * In raw mode, compression (if not NULL) receives what cecies_payload_compression() says about the output.
+ */
+int cecies_decrypt(const uint8_t* encrypted_data, size_t encrypted_data_length, int encrypted_data_base64, char* private_key, uint8_t** output, size_t* output_length, int curve, int mode, int* compression);
+
+/*
+ * GHASH context: precomputed 4-bit multiplication tables for a hash subkey H.
+ */
+typedef struct cecies_ghash_context
+{
+    uint64_t HL[16];
+    uint64_t HH[16];
+
+    /* The hash subkey itself, and whether PCLMULQDQ can be used instead of the tables. */
+    uint8_t H[16];
+    int clmul;
+} cecies_ghash_context;
+
+/*
+ * Precomputes the multiplication tables for the given hash subkey.
+ */
+void cecies_ghash_setkey(cecies_ghash_context* ctx, const uint8_t h[16]);
+
+/*
+ * output = x * H in GF(2^128) (x and output may overlap).
+ */
+void cecies_ghash_mult(const cecies_ghash_context* ctx, const uint8_t x[16], uint8_t output[16]);
+
+/*
+ * Absorbs data into the GHASH state y; a trailing partial block is zero-padded.
+ */
+void cecies_ghash_update(const cecies_ghash_context* ctx, uint8_t y[16], const uint8_t* data, size_t data_length);
+
+/*
+ * output = h^n in GF(2^128) (square-and-multiply; used to combine GHASH states of consecutive chunks).
+ */
+void cecies_ghash_pow(const uint8_t h[16], uint64_t n, uint8_t output[16]);
+
+/*
+ * Absorbs the final GCM length block (both lengths in bytes) into the GHASH state y.
+ */
+void cecies_ghash_update_lengths(const cecies_ghash_context* ctx, uint8_t y[16], uint64_t aad_length, uint64_t ciphertext_length);
+
+/*
+ * Computes the initial GCM counter block J0 for the given IV (ctx must be set up with the hash subkey).
+ */
+void cecies_gcm_compute_j0(const cecies_ghash_context* ctx, const uint8_t* iv, size_t iv_length, uint8_t j0[16]);
+
+/*
+ * Computes the AES-256-GCM tag over the given AAD and ciphertext without decrypting anything, and compares it against the expected tag in constant time.
+ * Returns 0 if the tag matches, 1 if it doesn't, or an MbedTLS error code on failure.
+ */
+int cecies_gcm_check_tag(const uint8_t key[32], const uint8_t* iv, size_t iv_length, const uint8_t* aad, size_t aad_length, const uint8_t* ciphertext, size_t ciphertext_length, const uint8_t tag[16]);
+
+/*
+ * Incremental AES-GCM (with a 16-byte IV), papering over the API differences between MbedTLS 2 and 3.
+ * Except for the very last call, cecies_gcm_update() must only be passed whole 16-byte blocks.
+ */
+int cecies_gcm_starts(mbedtls_gcm_context* gcm, int mode, const uint8_t* iv, const uint8_t* aad, size_t aad_length);
+int cecies_gcm_update(mbedtls_gcm_context* gcm, const uint8_t* input, size_t length, uint8_t* output);
+int cecies_gcm_finish(mbedtls_gcm_context* gcm, uint8_t tag[16]);
+
+/*
+ * How many threads to use for AES-GCM over a payload of the given length (see cecies_set_parallel_gcm()); 1 means "use MbedTLS' single-threaded GCM".
+ */
+size_t cecies_parallel_gcm_get_thread_count(size_t length);
+
+/*
+ * AES-256-GCM over input using up to thread_count threads: the CTR keystream is split by block offset and the partial GHASH results are combined using powers of H.
+ * Output (and tag) are bit-identical to mbedtls_gcm_crypt_and_tag(). In MBEDTLS_GCM_DECRYPT mode the tag is computed over the input and it's up to the caller to compare it.
+ */
+int cecies_gcm_crypt_and_tag_parallel(const uint8_t key[32], int mode, const uint8_t* iv, size_t iv_length, const uint8_t* aad, size_t aad_length, const uint8_t* input, size_t length, uint8_t* output, uint8_t tag[16], size_t thread_count);
+
+/*
+ * How many independent messages the multi-buffer AES-GCM kernel interleaves.
+ */
+#define CECIES_GCM_MULTI_LANES 8
+
+/*
+ * One message of a multi-buffer AES-256-GCM call (16-byte IV and tag).
+ * The tag is written when encrypting and checked when decrypting; ret is set to 0 or an MbedTLS error code (output is wiped on MBEDTLS_ERR_GCM_AUTH_FAILED).
+ */
+typedef struct cecies_gcm_message
+{
+    const uint8_t* key;
+    const uint8_t* iv;
+    const uint8_t* aad;
+    size_t aad_length;
+    const uint8_t* input;
+    uint8_t* output;
+    size_t length;
+    uint8_t tag[16];
+    int ret;
+} cecies_gcm_message;
+
+/*
+ * En-/decrypts a batch of independent messages, CECIES_GCM_MULTI_LANES at a time in lockstep (see cecies_set_multi_buffer_gcm()).
+ * Output and tags are bit-identical to mbedtls_gcm_crypt_and_tag(); the per-message outcome is in each message's ret.
+ */
+void cecies_gcm_crypt_and_tag_multi(cecies_gcm_message* messages, size_t count, int mode);
+
+/*
+ * How many X25519 scalar multiplications cecies_x25519_multi() runs side by side: 8 with AVX-512, 4 with AVX2,
+ * or 0 if neither is available (or both are switched off using cecies_set_simd_x25519()), in which case it mustn't be called.
+ */
+size_t cecies_x25519_multi_lanes(void);
+
+/*
+ * outputs[i] = X25519(scalars[i], points[i]) as per RFC 7748 (32-byte little-endian scalars, u-coordinates and results) for count independent pairs, in constant time.
+ * results[i] is set to 0, or to MBEDTLS_ERR_ECP_INVALID_KEY if the shared secret came out all zero (a small-order point).
+ */
+void cecies_x25519_multi(const uint8_t* const* scalars, const uint8_t* const* points, uint8_t* const* outputs, size_t count, int* results);
+
+/*
+ * A resumable X25519 scalar multiplication: the constant-time Montgomery ladder of RFC 7748, which can be run a few scalar bits at a time (e.g. to bound the duration of restartable steps).
+ * Scalars, u-coordinates and results are 32 bytes little-endian, just like for cecies_x25519_multi().
+ */
+typedef struct cecies_x25519_ladder
+{
+    /* x1, x2, z2, x3, z3 (10 limbs each) and the pending swap. */
+    int64_t state[51];
+
+    uint8_t scalar[32];
+
+    /* The next scalar bit to process (-1 once they're all done). */
+    int bit;
+} cecies_x25519_ladder;
+
+void cecies_x25519_ladder_init(cecies_x25519_ladder* ladder, const uint8_t scalar[32], const uint8_t u[32]);
+
+/*
+ * Runs the ladder over the next max_bits scalar bits (0 for all of the remaining ones). Returns 1 if there are bits left, 0 once the ladder is through.
+ */
+int cecies_x25519_ladder_run(cecies_x25519_ladder* ladder, size_t max_bits);
+
+/*
+ * Writes the result of a ladder that is through and wipes it. Returns 0, or MBEDTLS_ERR_ECP_INVALID_KEY if the result came out all zero (a small-order point).
+ */
+int cecies_x25519_ladder_finish(cecies_x25519_ladder* ladder, uint8_t out[32]);
+
+/*
+ * The same for X448 (see x448.c): 56-byte scalars, u-coordinates and results.
+ */
+typedef struct cecies_x448_ladder
+{
+    /* x1, x2, z2, x3, z3 (16 limbs each). */
+    uint32_t state[5][16];
+    uint32_t swap;
+
+    uint8_t scalar[56];
+    int bit;
+} cecies_x448_ladder;
+
+void cecies_x448_ladder_init(cecies_x448_ladder* ladder, const uint8_t scalar[56], const uint8_t u[56]);
+int cecies_x448_ladder_run(cecies_x448_ladder* ladder, size_t max_bits);
+int cecies_x448_ladder_finish(cecies_x448_ladder* ladder, uint8_t out[56]);
+
+/*
+ * The edwards448 arithmetic in edwards.c needs 128-bit integer multiplication. Ed25519 uses it too if it's there (CECIES_ED25519_WIDE: 5 limbs of 51 bits),
+ * and falls back to 10 limbs of 25.5 bits in 32-bit integers otherwise. Define CECIES_ED25519_PORTABLE to use the fallback anyway (e.g. to test it).
+ */
+#if defined(__SIZEOF_INT128__)
+#define CECIES_EDWARDS 1
+#if !defined(CECIES_ED25519_PORTABLE)
+#define CECIES_ED25519_WIDE 1
+#endif
+#endif
+
+/*
+ * u = X25519(scalar, 9): the Curve25519 public key of a 32-byte little-endian scalar, computed in constant time using a precomputed table of multiples of the base point.
+ * Returns 0.
+ */
+int cecies_curve25519_fixed_base(const uint8_t scalar[32], uint8_t u[32]);
+
+/*
+ * u = X448(scalar, 5): the Curve448 public key of a 56-byte little-endian (already clamped) scalar, just like cecies_curve25519_fixed_base().
+ * Returns 0, or MBEDTLS_ERR_ECP_FEATURE_UNAVAILABLE if the compiler lacks 128-bit integers (see edwards.c).
+ */
+int cecies_curve448_fixed_base(const uint8_t scalar[56], uint8_t u[56]);
+
+/*
+ * Drop-in replacement for mbedtls_ecp_gen_keypair(): for Curve25519 and Curve448, the private key is generated the same way, but the public key goes through the fixed-base tables above.
+ * Any other group (or Curve448 with a compiler that lacks 128-bit integers) goes straight to mbedtls_ecp_gen_keypair().
+ */
+int cecies_ecp_gen_keypair(mbedtls_ecp_group* group, mbedtls_mpi* d, mbedtls_ecp_point* Q, int (*f_rng)(void*, unsigned char*, size_t), void* p_rng);
+
+/*
+ * Ed25519 building blocks for ed25519.c (see edwards.c). All scalars are 32 bytes little-endian and all points are 32-byte RFC 8032 encodings.
+ */
+
+/*
+ * out = in mod l, for a 64-byte little-endian number (e.g. a SHA-512 hash); constant-time.
+ */
+void cecies_ed25519_scalar_reduce(uint8_t out[32], const uint8_t in[64]);
+
+/*
+ * out = (a * b + c) mod l; constant-time.
+ */
+void cecies_ed25519_scalar_muladd(uint8_t out[32], const uint8_t a[32], const uint8_t b[32], const uint8_t c[32]);
+
+/*
+ * Encodes scalar * B (for a scalar below 2^255), computed in constant time through the fixed-base comb.
+ */
+void cecies_ed25519_base_multiply(uint8_t out[32], const uint8_t scalar[32]);
+
+/*
+ * Checks the cofactored verification equation [8]R == [8]([S]B - [h]A) (variable-time: for verification only), just like cecies_ed25519_batch_check() does for a whole batch.
+ * Returns 0 if it holds, 1 if it doesn't (or R or A isn't a valid, canonically encoded point).
+ */
+int cecies_ed25519_verify_equation(const uint8_t R[32], const uint8_t h[32], const uint8_t A[32], const uint8_t S[32]);
+
+/*
+ * Checks whether [8]([base_scalar]B - sum(scalars[i] * points[i])) is the neutral element, evaluating the sum of the count (scalars below 2^253) products
+ * as one multi-scalar multiplication (Straus for small batches, Pippenger's bucket method for large ones; variable-time: for verification only).
+ * Returns 0 if it is, 1 if it isn't (or one of the points doesn't decode) or MBEDTLS_ERR_MPI_ALLOC_FAILED.
+ */
+int cecies_ed25519_batch_check(const uint8_t base_scalar[32], const uint8_t* const* points, const uint8_t* scalars, size_t count);
+
+/*
+ * How many threads to use for compressing an input of the given length (see cecies_set_parallel_compression()); 1 means "use ccrush_compress()".
+ */
+size_t cecies_parallel_compression_get_thread_count(size_t length);
+
+/*
+ * Compresses data into a single standard zlib stream (decompressible with ccrush_decompress() or cecies_decompress()), using up to thread_count threads.
+ * With more than one thread the input is deflated pigz-style in independent blocks that are primed with the previous block's tail.
+ * Returns 0 on success or a CCRUSH_ERROR_* code.
+ */
+int cecies_compress(const uint8_t* data, size_t data_length, int level, size_t thread_count, uint8_t** out_data, size_t* out_data_length);
+
+/*
+ * Decompresses a zlib stream (verifying its Adler-32 with cecies_adler32()). Returns 0 on success or a CCRUSH_ERROR_* code.
+ */
+int cecies_decompress(const uint8_t* data, size_t data_length, uint8_t** out_data, size_t* out_data_length);
+
+/*
+ * Inflates raw deflate data (no zlib header or trailer) that has to end exactly where the input does, into a newly allocated buffer (see src/inflate.c).
+ * output_size_hint is the initial output buffer size: the buffer grows (and is wiped on the way) as needed.
+ * Returns 0 on success or a CCRUSH_ERROR_* code.
+ */
+int cecies_inflate_raw(const uint8_t* input, size_t input_length, size_t output_size_hint, uint8_t** out_data, size_t* out_data_length);
+
+/*
+ * Upper bound for the output of cecies_deflate_raw() for length input bytes (sync flush included).
+ */
+size_t cecies_deflate_bound(size_t length);
+
+/*
+ * Deflates input into raw deflate data (see src/deflate.c) with a zlib compression level of 1 to 9. The dictionary_length (at most 32 KiB) bytes right before input
+ * are used as preset dictionary. The last part of a stream ends with a final block, other parts with a sync flush (so that the next part can be appended).
+ * Returns 0 on success or a CCRUSH_ERROR_* code.
+ */
+int cecies_deflate_raw(const uint8_t* input, size_t input_length, size_t dictionary_length, int level, int last, uint8_t* output, size_t output_size, size_t* output_length);
+
+/*
+ * Updates a running Adler-32 checksum (start with 1), using SSSE3/AVX2 where the CPU supports it.
+ */
+uint32_t cecies_adler32(uint32_t adler, const uint8_t* data, size_t data_length);
+
+/*
+ * Minimal threading abstraction (pthreads on POSIX, Win32 threads on Windows).
+ */
+#ifdef _WIN32
+typedef HANDLE cecies_thread;
+typedef CRITICAL_SECTION cecies_mutex;
+typedef CONDITION_VARIABLE cecies_cond;
+#else
+typedef pthread_t cecies_thread;
+typedef pthread_mutex_t cecies_mutex;
+typedef pthread_cond_t cecies_cond;
+#endif
+
+/*
+ * Starts a new thread that runs func(arg). Returns 0 on success.
+ */
+int cecies_thread_create(cecies_thread* thread, void (*func)(void*), void* arg);
+
+/*
+ * Waits for a thread to finish.
+ */
+void cecies_thread_join(cecies_thread thread);
+
+void cecies_mutex_init(cecies_mutex* mutex);
+void cecies_mutex_lock(cecies_mutex* mutex);
+void cecies_mutex_unlock(cecies_mutex* mutex);
+void cecies_mutex_free(cecies_mutex* mutex);
+
+void cecies_cond_init(cecies_cond* cond);
+void cecies_cond_wait(cecies_cond* cond, cecies_mutex* mutex);
+void cecies_cond_signal(cecies_cond* cond);
+void cecies_cond_broadcast(cecies_cond* cond);
+void cecies_cond_free(cecies_cond* cond);
+
+/*
+ * Gets the number of online CPU cores (at least 1).
+ */
+size_t cecies_get_cpu_count(void);
+
+/*
+ * Minimal asynchronous positional file I/O: io_uring on Linux (if the kernel supports it), otherwise every request is
+ * performed synchronously (pread()/pwrite()) right when it's submitted and its completion is queued up for cecies_io_wait().
+ */
+typedef struct cecies_io cecies_io;
+
+/*
+ * Creates an I/O context that can have up to queue_depth requests in flight. Returns 0 on success.
+ */
+int cecies_io_init(cecies_io** out_io, unsigned int queue_depth);
+
+/*
+ * Submits a read (write == 0) or write (write != 0) of length bytes at the given file offset. The tag is handed back by cecies_io_wait().
+ * The buffer must stay valid until the request's completion has been reaped. Returns 0 on success.
+ */
+int cecies_io_submit(cecies_io* io, int write, int fd, void* buffer, size_t length, uint64_t offset, uint64_t tag);
+
+/*
+ * Waits for the next completion. The result is the amount of bytes transferred or a negative errno value.
+ * Returns 0 on success (non-zero if nothing is in flight).
+ */
+int cecies_io_wait(cecies_io* io, uint64_t* tag, int64_t* result);
+
+/*
+ * Returns 1 if the I/O context is backed by io_uring, 0 if it's the synchronous fallback.
+ */
+int cecies_io_is_async(const cecies_io* io);
+
+/*
+ * Frees an I/O context (all requests must have been reaped).
+ */
+void cecies_io_free(cecies_io* io);
+
+/*
+ * Synchronous positional reads and writes that retry until everything was transferred (or EOF was hit when reading).
+ * They return the amount of bytes transferred, or -1 on failure.
+ */
+int64_t cecies_pread_full(int fd, void* buffer, size_t length, uint64_t offset);
+int64_t cecies_pwrite_full(int fd, const void* buffer, size_t length, uint64_t offset);
+
+#endif // CECIES_INTERNAL_H
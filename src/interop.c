@@ -0,0 +1,647 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <string.h>
+
+#include <mbedtls/gcm.h>
+#include <mbedtls/platform_util.h>
+
+#include "cecies/util.h"
+#include "cecies/interop.h"
+#include "internal.h"
+
+/*
+ * How many messages of a batch have their keys derived together: enough for the multi-lane X25519 to share one field inversion among several groups of lanes
+ * (see cecies_x25519_multi()). Their AES-GCM passes then go through the multi-buffer kernel CECIES_GCM_MULTI_LANES at a time.
+ */
+#define CECIES_CONTEXT_BATCH_WINDOW 32
+
+struct cecies_context
+{
+    int header_flags;
+    cecies_key_state state;
+};
+
+/*
+ * Reads a key that was passed either raw (key_size bytes) or hex-encoded (key_size * 2 characters) into its raw form.
+ */
+static int cecies_context_read_key(const uint8_t* key, const size_t key_length, const size_t key_size, uint8_t* out)
+{
+    if (key_length == key_size)
+    {
+        memcpy(out, key, key_size);
+        return 0;
+    }
+
+    if (key_length != key_size * 2)
+    {
+        return CECIES_CONTEXT_ERROR_CODE_INVALID_ARG;
+    }
+
+    // The +1 is for the NUL-terminator that cecies_hexstr2bin() appends.
+    size_t bytes_length = 0;
+    uint8_t bytes[CECIES_X448_KEY_SIZE + 1] = { 0x00 };
+
+    int ret = cecies_hexstr2bin((const char*)key, key_length, bytes, key_size + 1, &bytes_length);
+    if (ret == 0 && bytes_length == key_size)
+    {
+        memcpy(out, bytes, key_size);
+    }
+    else
+    {
+        ret = CECIES_CONTEXT_ERROR_CODE_INVALID_ARG;
+    }
+
+    mbedtls_platform_zeroize(bytes, sizeof(bytes));
+    return (ret);
+}
+
+static int cecies_context_create(cecies_context** out_context, const int curve, const uint8_t* public_key, const size_t public_key_length, const uint8_t* private_key, const size_t private_key_length, const int header_flags)
+{
+    if (out_context == NULL)
+    {
+        return CECIES_CONTEXT_ERROR_CODE_NULL_ARG;
+    }
+
+    if ((public_key == NULL && private_key == NULL) || (header_flags & ~CECIES_HEADER_FLAGS_SUPPORTED) != 0)
+    {
+        return CECIES_CONTEXT_ERROR_CODE_INVALID_ARG;
+    }
+
+    const size_t key_size = curve == 0 ? CECIES_X25519_KEY_SIZE : CECIES_X448_KEY_SIZE;
+
+    uint8_t public_key_bytes[CECIES_X448_KEY_SIZE] = { 0x00 };
+    uint8_t private_key_bytes[CECIES_X448_KEY_SIZE] = { 0x00 };
+
+    int ret = 1;
+    cecies_context* context = NULL;
+
+    if (public_key != NULL && cecies_context_read_key(public_key, public_key_length, key_size, public_key_bytes) != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Context creation failed! Invalid public key length or hex string format...\n");
+        ret = CECIES_CONTEXT_ERROR_CODE_INVALID_ARG;
+        goto exit;
+    }
+
+    if (private_key != NULL && cecies_context_read_key(private_key, private_key_length, key_size, private_key_bytes) != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Context creation failed! Invalid private key length or hex string format...\n");
+        ret = CECIES_CONTEXT_ERROR_CODE_INVALID_ARG;
+        goto exit;
+    }
+
+    context = cecies_calloc(1, sizeof(cecies_context));
+    if (context == NULL)
+    {
+        cecies_fprintf(stderr, "CECIES: Context creation failed: OUT OF MEMORY!\n");
+        ret = CECIES_CONTEXT_ERROR_CODE_OUT_OF_MEMORY;
+        goto exit;
+    }
+
+    context->header_flags = header_flags;
+
+    ret = (curve == 0 ? cecies_curve25519_key_state_init : cecies_curve448_key_state_init)(&context->state, public_key != NULL ? public_key_bytes : NULL, private_key != NULL ? private_key_bytes : NULL);
+    if (ret != 0)
+    {
+        cecies_free(context);
+        goto exit;
+    }
+
+    *out_context = context;
+
+exit:
+
+    mbedtls_platform_zeroize(private_key_bytes, sizeof(private_key_bytes));
+    return (ret);
+}
+
+int cecies_curve25519_context_create(cecies_context** out_context, const uint8_t* public_key, const size_t public_key_length, const uint8_t* private_key, const size_t private_key_length, const int header_flags)
+{
+    return cecies_context_create(out_context, 0, public_key, public_key_length, private_key, private_key_length, header_flags);
+}
+
+int cecies_curve448_context_create(cecies_context** out_context, const uint8_t* public_key, const size_t public_key_length, const uint8_t* private_key, const size_t private_key_length, const int header_flags)
+{
+    return cecies_context_create(out_context, 1, public_key, public_key_length, private_key, private_key_length, header_flags);
+}
+
+void cecies_context_free(cecies_context* context)
+{
+    if (context == NULL)
+    {
+        return;
+    }
+
+    cecies_key_state_free(&context->state);
+    mbedtls_platform_zeroize(context, sizeof(cecies_context));
+    cecies_free(context);
+}
+
+int cecies_context_get_curve(const cecies_context* context)
+{
+    return context != NULL ? context->state.curve : -1;
+}
+
+size_t cecies_context_get_encrypted_size(const cecies_context* context, const size_t data_length)
+{
+    if (context == NULL)
+    {
+        return 0;
+    }
+
+    const int curve448 = context->state.curve != 0;
+    return cecies_calc_ext_header_length(context->header_flags | (curve448 ? CECIES_HEADER_FLAG_CURVE448 : 0)) + cecies_calc_output_buffer_needed_size(data_length, curve448 ? CECIES_X448_KEY_SIZE : CECIES_X25519_KEY_SIZE);
+}
+
+size_t cecies_context_get_decrypted_size(const cecies_context* context, const uint8_t* encrypted_data, const size_t encrypted_data_length)
+{
+    cecies_header header;
+
+    if (context == NULL || encrypted_data == NULL || cecies_parse_header(encrypted_data, encrypted_data_length, context->state.curve, &header) != 0)
+    {
+        return 0;
+    }
+
+    return header.ciphertext_length;
+}
+
+/*
+ * Checks whether a message can be encrypted into the given output buffer, and gets its ciphertext length.
+ */
+static int cecies_context_check_encryption(const cecies_context* context, const size_t data_length, const size_t output_size, size_t* output_length)
+{
+    if (data_length == 0 || !context->state.has_public_key)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    const size_t olen = cecies_context_get_encrypted_size(context, data_length);
+
+    if (output_size < olen)
+    {
+        cecies_fprintf(stderr, "CECIES: encryption failed: output buffer too small (%zu bytes needed).\n", olen);
+        return CECIES_ENCRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE;
+    }
+
+    *output_length = olen;
+    return 0;
+}
+
+/*
+ * Parses a ciphertext and checks whether it can be decrypted into the given output buffer.
+ */
+static int cecies_context_check_decryption(const cecies_context* context, const uint8_t* encrypted_data, const size_t encrypted_data_length, const size_t output_size, cecies_header* header)
+{
+    if (!context->state.has_private_key)
+    {
+        return CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    const int ret = cecies_parse_header(encrypted_data, encrypted_data_length, context->state.curve, header);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    if (output_size < header->ciphertext_length)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed: output buffer too small (%zu bytes needed).\n", header->ciphertext_length);
+        return CECIES_DECRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE;
+    }
+
+    return 0;
+}
+
+/*
+ * Curve25519 key agreements (and ephemeral key generation) of a whole group of messages at once through the multi-lane X25519, followed by their HKDF through the multi-buffer SHA-512 (see cecies_context_derive_keys()).
+ */
+static void cecies_context_derive_keys_x25519(cecies_context* context, const int mode, const size_t n, const cecies_header* headers, cecies_encryption_setup* setups, uint8_t aes_keys[][32], int* results)
+{
+    static const uint8_t base_point[32] = { 9 };
+
+    cecies_key_state* state = &context->state;
+
+    // Encryption needs two multiplications per message (R = r * G and S = r * QA), decryption one (S = dA * R).
+    uint8_t scalars[CECIES_CONTEXT_BATCH_WINDOW][32];
+    uint8_t secrets[2 * CECIES_CONTEXT_BATCH_WINDOW][32];
+
+    const uint8_t* k[2 * CECIES_CONTEXT_BATCH_WINDOW];
+    const uint8_t* u[2 * CECIES_CONTEXT_BATCH_WINDOW];
+    uint8_t* out[2 * CECIES_CONTEXT_BATCH_WINDOW];
+    int rets[2 * CECIES_CONTEXT_BATCH_WINDOW];
+
+    // The HKDF of all the messages whose key agreement went through then also runs at once (see cecies_derive_keys_multi()).
+    const uint8_t* salts[CECIES_CONTEXT_BATCH_WINDOW];
+    const uint8_t* shared_secrets[CECIES_CONTEXT_BATCH_WINDOW];
+    uint8_t* derived_keys[CECIES_CONTEXT_BATCH_WINDOW];
+    uint8_t* derived_key_commitments[CECIES_CONTEXT_BATCH_WINDOW];
+    uint8_t key_commitments[CECIES_CONTEXT_BATCH_WINDOW][CECIES_KEY_COMMITMENT_SIZE];
+    size_t lanes[CECIES_CONTEXT_BATCH_WINDOW];
+
+    memset(scalars, 0x00, sizeof(scalars));
+
+    if (mode == MBEDTLS_GCM_ENCRYPT)
+    {
+        mbedtls_mpi r;
+        mbedtls_mpi_init(&r);
+
+        for (size_t j = 0; j < n; ++j)
+        {
+            results[j] = mbedtls_ecp_gen_privkey(&state->ecp_group, &r, mbedtls_ctr_drbg_random, &state->ctr_drbg);
+            if (results[j] == 0)
+            {
+                results[j] = mbedtls_mpi_write_binary_le(&r, scalars[j], 32);
+            }
+
+            if (results[j] != 0)
+            {
+                cecies_fprintf(stderr, "CECIES: Ephemeral keypair generation failed! mbedtls_ecp_gen_privkey returned %d\n", results[j]);
+            }
+
+            k[j] = k[n + j] = scalars[j];
+            u[j] = base_point;
+            u[n + j] = state->public_key;
+            out[j] = secrets[j];
+            out[n + j] = secrets[n + j];
+        }
+
+        mbedtls_mpi_free(&r);
+
+        // Messages whose key generation failed still take up their lanes (with a zero scalar): their results are just never used.
+        cecies_x25519_multi(k, u, out, 2 * n, rets);
+
+        size_t m = 0;
+
+        for (size_t j = 0; j < n; ++j)
+        {
+            if (results[j] == 0)
+            {
+                results[j] = rets[j] != 0 ? rets[j] : rets[n + j];
+            }
+
+            if (results[j] == 0)
+            {
+                results[j] = cecies_curve25519_encryption_setup_prepare(state, context->header_flags, secrets[j], &setups[j]);
+            }
+
+            if (results[j] == 0)
+            {
+                salts[m] = setups[j].salt;
+                shared_secrets[m] = secrets[n + j];
+                derived_keys[m] = setups[j].aes_key;
+                derived_key_commitments[m] = (context->header_flags & CECIES_HEADER_FLAG_KEY_COMMITMENT) ? setups[j].key_commitment : NULL;
+                lanes[m++] = j;
+            }
+        }
+
+        cecies_derive_keys_multi(salts, shared_secrets, CECIES_X25519_KEY_SIZE, derived_keys, derived_key_commitments, m, rets);
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            results[lanes[i]] = cecies_encryption_setup_check_keys(rets[i], &setups[lanes[i]]);
+        }
+    }
+    else
+    {
+        size_t m = 0;
+
+        mbedtls_ecp_point R;
+        mbedtls_ecp_point_init(&R);
+
+        const int ret = mbedtls_mpi_write_binary_le(&state->dA, scalars[0], 32);
+
+        for (size_t j = 0; j < n; ++j)
+        {
+            results[j] = ret != 0 ? ret : cecies_curve25519_read_ephemeral_key(state, &headers[j], &R);
+
+            if (results[j] == 0)
+            {
+                k[m] = scalars[0];
+                u[m] = headers[j].R;
+                out[m] = secrets[j];
+                lanes[m++] = j;
+            }
+        }
+
+        mbedtls_ecp_point_free(&R);
+
+        cecies_x25519_multi(k, u, out, m, rets);
+
+        size_t d = 0;
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            const size_t j = lanes[i];
+
+            results[j] = rets[i];
+            if (results[j] == 0)
+            {
+                salts[d] = headers[j].salt;
+                shared_secrets[d] = secrets[j];
+                derived_keys[d] = aes_keys[j];
+                derived_key_commitments[d] = headers[j].key_commitment != NULL ? key_commitments[d] : NULL;
+                lanes[d++] = j;
+            }
+        }
+
+        cecies_derive_keys_multi(salts, shared_secrets, CECIES_X25519_KEY_SIZE, derived_keys, derived_key_commitments, d, rets);
+
+        for (size_t i = 0; i < d; ++i)
+        {
+            const size_t j = lanes[i];
+
+            results[j] = cecies_check_derived_aes_key(rets[i], &headers[j], aes_keys[j], key_commitments[i]);
+            if (results[j] == CECIES_DECRYPT_ERROR_CODE_WRONG_KEY)
+            {
+                cecies_fprintf(stderr, "CECIES: decryption failed! The key commitment doesn't match: wrong private key.\n");
+            }
+        }
+    }
+
+    mbedtls_platform_zeroize(scalars, sizeof(scalars));
+    mbedtls_platform_zeroize(secrets, sizeof(secrets));
+    mbedtls_platform_zeroize(key_commitments, sizeof(key_commitments));
+}
+
+/*
+ * Derives the message keys of up to CECIES_CONTEXT_BATCH_WINDOW messages (ephemeral key, key agreement and HKDF): into setups when encrypting and into aes_keys (using the parsed headers) when decrypting.
+ * For Curve25519 on a CPU with AVX2, the key agreements all run side by side through the multi-lane X25519; otherwise they go through MbedTLS one after the other.
+ */
+static void cecies_context_derive_keys(cecies_context* context, const int mode, const size_t n, const cecies_header* headers, cecies_encryption_setup* setups, uint8_t aes_keys[][32], int* results)
+{
+    cecies_key_state* state = &context->state;
+
+    if (state->curve == 0 && cecies_x25519_multi_lanes() != 0)
+    {
+        cecies_context_derive_keys_x25519(context, mode, n, headers, setups, aes_keys, results);
+        return;
+    }
+
+    for (size_t j = 0; j < n; ++j)
+    {
+        results[j] = mode == MBEDTLS_GCM_ENCRYPT //
+            ? (state->curve == 0 ? cecies_curve25519_encryption_setup_init_from_state : cecies_curve448_encryption_setup_init_from_state)(state, context->header_flags, &setups[j])
+            : (state->curve == 0 ? cecies_curve25519_derive_header_key_from_state : cecies_curve448_derive_header_key_from_state)(state, &headers[j], aes_keys[j]);
+    }
+}
+
+/*
+ * Writes an encrypted message's header and sets up its AES-GCM pass.
+ */
+static void cecies_context_begin_encryption(const cecies_encryption_setup* setup, const uint8_t* data, const size_t data_length, uint8_t* output, cecies_gcm_message* message)
+{
+    cecies_encryption_setup_write_header(setup, output);
+
+    memset(message, 0x00, sizeof(cecies_gcm_message));
+    message->key = setup->aes_key;
+    message->iv = setup->iv;
+    message->aad = setup->ext_header_length != 0 ? output : NULL;
+    message->aad_length = setup->ext_header_length;
+    message->input = data;
+    message->output = output + setup->header_length;
+    message->length = data_length;
+}
+
+/*
+ * Sets up a parsed ciphertext's AES-GCM pass.
+ */
+static void cecies_context_begin_decryption(const cecies_header* header, const uint8_t aes_key[32], uint8_t* output, cecies_gcm_message* message)
+{
+    memset(message, 0x00, sizeof(cecies_gcm_message));
+    message->key = aes_key;
+    message->iv = header->iv;
+    message->aad = header->ext;
+    message->aad_length = header->ext_length;
+    message->input = header->ciphertext;
+    message->output = output;
+    message->length = header->ciphertext_length;
+    memcpy(message->tag, header->tag, 16);
+}
+
+/*
+ * Checks the outcome of a message's AES-GCM pass: on success, an encrypted message's tag is put in its place right in front of the ciphertext; on failure, the output is wiped.
+ */
+static int cecies_context_finish(const int mode, cecies_gcm_message* message, uint8_t* output, const size_t output_length)
+{
+    const int ret = message->ret;
+
+    if (ret != 0)
+    {
+        if (mode == MBEDTLS_GCM_ENCRYPT)
+        {
+            cecies_fprintf(stderr, "CECIES: AES-GCM encryption failed! mbedtls_gcm_crypt_and_tag returned %d\n", ret);
+        }
+        else
+        {
+            cecies_fprintf(stderr, "CECIES: decryption failed! mbedtls_gcm_auth_decrypt returned %d\n", ret);
+        }
+
+        mbedtls_platform_zeroize(output, output_length);
+    }
+    else if (mode == MBEDTLS_GCM_ENCRYPT)
+    {
+        memcpy(message->output - 16, message->tag, 16);
+    }
+
+    mbedtls_platform_zeroize(message, sizeof(cecies_gcm_message));
+    return (ret);
+}
+
+static void cecies_context_batch_record(const size_t i, const int ret, const size_t written, size_t* output_lengths, int* results, int* first_error)
+{
+    if (ret != 0 && *first_error == 0)
+    {
+        *first_error = ret;
+    }
+
+    if (results != NULL)
+    {
+        results[i] = ret;
+    }
+
+    output_lengths[i] = written;
+}
+
+/*
+ * Messages are processed CECIES_CONTEXT_BATCH_WINDOW at a time: first they're all checked (each output tentatively placed right after the previous one),
+ * then their keys are derived together (see cecies_context_derive_keys()) and then all of their AES-GCM passes go through the multi-buffer kernel.
+ * Messages that fail along the way leave a gap, which the outputs behind them are then moved into.
+ * A single en-/decryption is just a batch of one.
+ */
+static int cecies_context_batch(cecies_context* context, const int mode, const uint8_t* input, const size_t* input_lengths, const size_t count, uint8_t* output, const size_t output_size, size_t* output_lengths, int* results)
+{
+    int first_error = 0;
+
+    size_t in = 0, out = 0;
+
+    cecies_header headers[CECIES_CONTEXT_BATCH_WINDOW];
+    cecies_encryption_setup setups[CECIES_CONTEXT_BATCH_WINDOW];
+    uint8_t aes_keys[CECIES_CONTEXT_BATCH_WINDOW][32];
+    cecies_gcm_message messages[CECIES_CONTEXT_BATCH_WINDOW];
+    int rets[CECIES_CONTEXT_BATCH_WINDOW];
+
+    size_t indices[CECIES_CONTEXT_BATCH_WINDOW];
+    size_t inputs[CECIES_CONTEXT_BATCH_WINDOW];
+    size_t offsets[CECIES_CONTEXT_BATCH_WINDOW];
+    size_t lengths[CECIES_CONTEXT_BATCH_WINDOW];
+
+    for (size_t i = 0; i < count;)
+    {
+        size_t n = 0;
+        size_t next = out;
+
+        for (; i < count && n < CECIES_CONTEXT_BATCH_WINDOW; ++i)
+        {
+            size_t olen = 0;
+
+            int ret;
+
+            if (mode == MBEDTLS_GCM_ENCRYPT)
+            {
+                ret = cecies_context_check_encryption(context, input_lengths[i], output_size - next, &olen);
+            }
+            else
+            {
+                ret = cecies_context_check_decryption(context, input + in, input_lengths[i], output_size - next, &headers[n]);
+                olen = headers[n].ciphertext_length;
+            }
+
+            if (ret != 0)
+            {
+                cecies_context_batch_record(i, ret, 0, output_lengths, results, &first_error);
+            }
+            else
+            {
+                indices[n] = i;
+                inputs[n] = in;
+                offsets[n] = next;
+                lengths[n] = olen;
+
+                next += olen;
+                ++n;
+            }
+
+            in += input_lengths[i];
+        }
+
+        cecies_context_derive_keys(context, mode, n, headers, setups, aes_keys, rets);
+
+        size_t m = 0;
+
+        for (size_t j = 0; j < n; ++j)
+        {
+            if (rets[j] != 0)
+            {
+                continue;
+            }
+
+            if (mode == MBEDTLS_GCM_ENCRYPT)
+            {
+                cecies_context_begin_encryption(&setups[j], input + inputs[j], input_lengths[indices[j]], output + offsets[j], &messages[m]);
+            }
+            else
+            {
+                cecies_context_begin_decryption(&headers[j], aes_keys[j], output + offsets[j], &messages[m]);
+            }
+
+            ++m;
+        }
+
+        cecies_gcm_crypt_and_tag_multi(messages, m, mode);
+
+        for (size_t i_m = 0, j = 0; j < n; ++j)
+        {
+            if (rets[j] == 0)
+            {
+                rets[j] = cecies_context_finish(mode, &messages[i_m++], output + offsets[j], lengths[j]);
+            }
+
+            if (rets[j] == 0)
+            {
+                if (offsets[j] != out)
+                {
+                    memmove(output + out, output + offsets[j], lengths[j]);
+                }
+
+                out += lengths[j];
+            }
+
+            cecies_context_batch_record(indices[j], rets[j], rets[j] == 0 ? lengths[j] : 0, output_lengths, results, &first_error);
+        }
+
+    }
+
+    mbedtls_platform_zeroize(setups, sizeof(setups));
+    mbedtls_platform_zeroize(aes_keys, sizeof(aes_keys));
+
+    return first_error;
+}
+
+int cecies_context_encrypt_into(cecies_context* context, const uint8_t* data, const size_t data_length, uint8_t* output, const size_t output_size, size_t* output_length)
+{
+    if (context == NULL || data == NULL || output == NULL || output_length == NULL)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    size_t olen = 0;
+
+    const int ret = cecies_context_batch(context, MBEDTLS_GCM_ENCRYPT, data, &data_length, 1, output, output_size, &olen, NULL);
+    if (ret == 0)
+    {
+        *output_length = olen;
+    }
+
+    return (ret);
+}
+
+int cecies_context_decrypt_into(cecies_context* context, const uint8_t* encrypted_data, const size_t encrypted_data_length, uint8_t* output, const size_t output_size, size_t* output_length)
+{
+    if (context == NULL || encrypted_data == NULL || output == NULL || output_length == NULL)
+    {
+        return CECIES_DECRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    size_t olen = 0;
+
+    const int ret = cecies_context_batch(context, MBEDTLS_GCM_DECRYPT, encrypted_data, &encrypted_data_length, 1, output, output_size, &olen, NULL);
+    if (ret == 0)
+    {
+        *output_length = olen;
+    }
+
+    return (ret);
+}
+
+int cecies_context_encrypt_batch(cecies_context* context, const uint8_t* input, const size_t* input_lengths, const size_t count, uint8_t* output, const size_t output_size, size_t* output_lengths, int* results)
+{
+    if (context == NULL || input == NULL || input_lengths == NULL || output == NULL || output_lengths == NULL)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    return cecies_context_batch(context, MBEDTLS_GCM_ENCRYPT, input, input_lengths, count, output, output_size, output_lengths, results);
+}
+
+int cecies_context_decrypt_batch(cecies_context* context, const uint8_t* input, const size_t* input_lengths, const size_t count, uint8_t* output, const size_t output_size, size_t* output_lengths, int* results)
+{
+    if (context == NULL || input == NULL || input_lengths == NULL || output == NULL || output_lengths == NULL)
+    {
+        return CECIES_DECRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    return cecies_context_batch(context, MBEDTLS_GCM_DECRYPT, input, input_lengths, count, output, output_size, output_lengths, results);
+}
@@ -0,0 +1,452 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <string.h>
+#include <errno.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && !defined(CECIES_NO_IO_URING) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define CECIES_HAVE_IO_URING 1
+#endif
+#endif
+
+#ifdef CECIES_HAVE_IO_URING
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+#include "cecies/util.h"
+#include "internal.h"
+
+typedef struct cecies_io_completion
+{
+    uint64_t tag;
+    int64_t result;
+} cecies_io_completion;
+
+struct cecies_io
+{
+    unsigned int queue_depth;
+    unsigned int in_flight;
+
+    /* Synchronous fallback: ring buffer of already completed requests. io_uring: the completions that were reaped off the ring early (see cecies_io_uring_enter()). */
+    cecies_io_completion* completions;
+    unsigned int completions_head;
+    unsigned int reaped;
+
+#ifdef CECIES_HAVE_IO_URING
+    int ring_fd;
+
+    void* sq_ring;
+    size_t sq_ring_size;
+    void* cq_ring;
+    size_t cq_ring_size;
+    struct io_uring_sqe* sqes;
+    size_t sqes_size;
+
+    unsigned int* sq_tail;
+    unsigned int* sq_mask;
+    unsigned int* sq_array;
+
+    unsigned int* cq_head;
+    unsigned int* cq_tail;
+    unsigned int* cq_mask;
+    struct io_uring_cqe* cqes;
+#endif
+};
+
+int64_t cecies_pread_full(int fd, void* buffer, size_t length, uint64_t offset)
+{
+    size_t total = 0;
+    while (total < length)
+    {
+#ifdef _WIN32
+        OVERLAPPED overlapped = { 0 };
+        overlapped.Offset = (DWORD)(offset + total);
+        overlapped.OffsetHigh = (DWORD)((offset + total) >> 32);
+        DWORD n = 0;
+        const DWORD request = (DWORD)((length - total) > 0x40000000 ? 0x40000000 : (length - total));
+        if (!ReadFile((HANDLE)_get_osfhandle(fd), (uint8_t*)buffer + total, request, &n, &overlapped))
+        {
+            if (GetLastError() == ERROR_HANDLE_EOF)
+            {
+                break;
+            }
+            return -1;
+        }
+#else
+        const ssize_t n = pread(fd, (uint8_t*)buffer + total, length - total, (off_t)(offset + total));
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+#endif
+        if (n == 0)
+        {
+            break;
+        }
+        total += (size_t)n;
+    }
+    return (int64_t)total;
+}
+
+int64_t cecies_pwrite_full(int fd, const void* buffer, size_t length, uint64_t offset)
+{
+    size_t total = 0;
+    while (total < length)
+    {
+#ifdef _WIN32
+        OVERLAPPED overlapped = { 0 };
+        overlapped.Offset = (DWORD)(offset + total);
+        overlapped.OffsetHigh = (DWORD)((offset + total) >> 32);
+        DWORD n = 0;
+        const DWORD request = (DWORD)((length - total) > 0x40000000 ? 0x40000000 : (length - total));
+        if (!WriteFile((HANDLE)_get_osfhandle(fd), (const uint8_t*)buffer + total, request, &n, &overlapped))
+        {
+            return -1;
+        }
+#else
+        const ssize_t n = pwrite(fd, (const uint8_t*)buffer + total, length - total, (off_t)(offset + total));
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+#endif
+        if (n == 0)
+        {
+            return -1;
+        }
+        total += (size_t)n;
+    }
+    return (int64_t)total;
+}
+
+#ifdef CECIES_HAVE_IO_URING
+
+static int cecies_io_uring_init(cecies_io* io)
+{
+    struct io_uring_params params;
+    memset(&params, 0x00, sizeof(params));
+
+    const int fd = (int)syscall(__NR_io_uring_setup, io->queue_depth, &params);
+    if (fd < 0)
+    {
+        return 1;
+    }
+
+    // Plain (non-vectored) IORING_OP_READ/WRITE came with the same kernel release (5.6) as this feature flag.
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_RW_CUR_POS))
+    {
+        close(fd);
+        return 1;
+    }
+
+    size_t sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    const size_t cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (cq_ring_size > sq_ring_size)
+    {
+        sq_ring_size = cq_ring_size;
+    }
+
+    void* ring = mmap(NULL, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring == MAP_FAILED)
+    {
+        close(fd);
+        return 1;
+    }
+
+    const size_t sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = mmap(NULL, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+    {
+        munmap(ring, sq_ring_size);
+        close(fd);
+        return 1;
+    }
+
+    uint8_t* r = ring;
+    io->ring_fd = fd;
+    io->sq_ring = io->cq_ring = ring;
+    io->sq_ring_size = io->cq_ring_size = sq_ring_size;
+    io->sqes = sqes;
+    io->sqes_size = sqes_size;
+
+    io->sq_tail = (unsigned int*)(r + params.sq_off.tail);
+    io->sq_mask = (unsigned int*)(r + params.sq_off.ring_mask);
+    io->sq_array = (unsigned int*)(r + params.sq_off.array);
+
+    io->cq_head = (unsigned int*)(r + params.cq_off.head);
+    io->cq_tail = (unsigned int*)(r + params.cq_off.tail);
+    io->cq_mask = (unsigned int*)(r + params.cq_off.ring_mask);
+    io->cqes = (struct io_uring_cqe*)(r + params.cq_off.cqes);
+
+    io->queue_depth = params.sq_entries;
+    return 0;
+}
+
+// How often cecies_io_uring_enter() retries on EAGAIN/EBUSY before giving up.
+#define CECIES_IO_URING_MAX_RETRIES 100
+
+/*
+ * Moves all of the completions that are on the ring over into io->completions (cecies_io_wait() hands those out first), which frees up the completion queue.
+ */
+static void cecies_io_uring_reap(cecies_io* io)
+{
+    unsigned int head = *io->cq_head;
+
+    while (head != __atomic_load_n(io->cq_tail, __ATOMIC_ACQUIRE))
+    {
+        const struct io_uring_cqe* cqe = &io->cqes[head & *io->cq_mask];
+
+        cecies_io_completion* completion = &io->completions[(io->completions_head + io->reaped) % io->queue_depth];
+        completion->tag = cqe->user_data;
+        completion->result = cqe->res;
+
+        io->reaped++;
+        head++;
+    }
+
+    __atomic_store_n(io->cq_head, head, __ATOMIC_RELEASE);
+}
+
+/*
+ * Enters the kernel. EAGAIN and EBUSY mean that the kernel is short of resources or that the completion queue is full, which won't change by just trying again:
+ * the completions are reaped off the ring and then, if there are requests in flight, their completion is waited for (IORING_ENTER_GETEVENTS); if there are none, this backs off for a bit.
+ */
+static int cecies_io_uring_enter(cecies_io* io, unsigned int to_submit, unsigned int min_complete, unsigned int flags)
+{
+    for (unsigned int attempt = 0;; ++attempt)
+    {
+        const long r = syscall(__NR_io_uring_enter, io->ring_fd, to_submit, min_complete, flags, NULL, 0);
+        if (r >= 0)
+        {
+            return 0;
+        }
+
+        if (errno == EINTR)
+        {
+            continue;
+        }
+
+        if ((errno != EAGAIN && errno != EBUSY) || attempt == CECIES_IO_URING_MAX_RETRIES)
+        {
+            return 1;
+        }
+
+        cecies_io_uring_reap(io);
+
+        if (to_submit == 0 && io->reaped != 0)
+        {
+            // A wait: there is something to hand out now.
+            return 0;
+        }
+
+        if (io->in_flight > io->reaped && syscall(__NR_io_uring_enter, io->ring_fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) >= 0)
+        {
+            continue;
+        }
+
+        const struct timespec backoff = { 0, (long)(1000 << (attempt < 10 ? attempt : 10)) };
+        nanosleep(&backoff, NULL);
+    }
+}
+
+#endif // CECIES_HAVE_IO_URING
+
+int cecies_io_init(cecies_io** out_io, const unsigned int queue_depth)
+{
+    if (out_io == NULL || queue_depth == 0)
+    {
+        return 1;
+    }
+
+    cecies_io* io = cecies_calloc(1, sizeof(cecies_io));
+    if (io == NULL)
+    {
+        return 1;
+    }
+
+    io->queue_depth = queue_depth;
+
+#ifdef CECIES_HAVE_IO_URING
+    io->ring_fd = -1;
+    if (cecies_io_uring_init(io) != 0)
+    {
+        io->queue_depth = queue_depth;
+    }
+#endif
+
+    io->completions = cecies_calloc(io->queue_depth, sizeof(cecies_io_completion));
+    if (io->completions == NULL)
+    {
+        cecies_io_free(io);
+        return 1;
+    }
+
+    *out_io = io;
+    return 0;
+}
+
+int cecies_io_is_async(const cecies_io* io)
+{
+#ifdef CECIES_HAVE_IO_URING
+    return io != NULL && io->ring_fd >= 0;
+#else
+    (void)io;
+    return 0;
+#endif
+}
+
+int cecies_io_submit(cecies_io* io, const int write, const int fd, void* buffer, const size_t length, const uint64_t offset, const uint64_t tag)
+{
+    if (io == NULL || buffer == NULL || io->in_flight >= io->queue_depth)
+    {
+        return 1;
+    }
+
+#ifdef CECIES_HAVE_IO_URING
+    if (io->ring_fd >= 0)
+    {
+        if (length > 0x7FFFF000)
+        {
+            return 1;
+        }
+
+        const unsigned int tail = *io->sq_tail;
+        const unsigned int index = tail & *io->sq_mask;
+
+        struct io_uring_sqe* sqe = &io->sqes[index];
+        memset(sqe, 0x00, sizeof(struct io_uring_sqe));
+        sqe->opcode = write ? IORING_OP_WRITE : IORING_OP_READ;
+        sqe->fd = fd;
+        sqe->addr = (uint64_t)(uintptr_t)buffer;
+        sqe->len = (uint32_t)length;
+        sqe->off = offset;
+        sqe->user_data = tag;
+
+        io->sq_array[index] = index;
+        __atomic_store_n(io->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+        if (cecies_io_uring_enter(io, 1, 0, 0) != 0)
+        {
+            // The kernel didn't consume the entry: take it back.
+            __atomic_store_n(io->sq_tail, tail, __ATOMIC_RELEASE);
+            return 1;
+        }
+
+        io->in_flight++;
+        return 0;
+    }
+#endif
+
+    const int64_t result = write ? cecies_pwrite_full(fd, buffer, length, offset) : cecies_pread_full(fd, buffer, length, offset);
+
+    cecies_io_completion* completion = &io->completions[(io->completions_head + io->in_flight) % io->queue_depth];
+    completion->tag = tag;
+    completion->result = result < 0 ? -(int64_t)(errno ? errno : EIO) : result;
+
+    io->in_flight++;
+    return 0;
+}
+
+int cecies_io_wait(cecies_io* io, uint64_t* tag, int64_t* result)
+{
+    if (io == NULL || tag == NULL || result == NULL || io->in_flight == 0)
+    {
+        return 1;
+    }
+
+#ifdef CECIES_HAVE_IO_URING
+    if (io->ring_fd >= 0)
+    {
+        for (;;)
+        {
+            if (io->reaped != 0)
+            {
+                const cecies_io_completion* completion = &io->completions[io->completions_head];
+                *tag = completion->tag;
+                *result = completion->result;
+
+                io->completions_head = (io->completions_head + 1) % io->queue_depth;
+                io->reaped--;
+                io->in_flight--;
+                return 0;
+            }
+
+            const unsigned int head = *io->cq_head;
+            if (head != __atomic_load_n(io->cq_tail, __ATOMIC_ACQUIRE))
+            {
+                const struct io_uring_cqe* cqe = &io->cqes[head & *io->cq_mask];
+                *tag = cqe->user_data;
+                *result = cqe->res;
+
+                __atomic_store_n(io->cq_head, head + 1, __ATOMIC_RELEASE);
+                io->in_flight--;
+                return 0;
+            }
+
+            if (cecies_io_uring_enter(io, 0, 1, IORING_ENTER_GETEVENTS) != 0)
+            {
+                return 1;
+            }
+        }
+    }
+#endif
+
+    const cecies_io_completion* completion = &io->completions[io->completions_head];
+    *tag = completion->tag;
+    *result = completion->result;
+
+    io->completions_head = (io->completions_head + 1) % io->queue_depth;
+    io->in_flight--;
+    return 0;
+}
+
+void cecies_io_free(cecies_io* io)
+{
+    if (io == NULL)
+    {
+        return;
+    }
+
+#ifdef CECIES_HAVE_IO_URING
+    if (io->ring_fd >= 0)
+    {
+        munmap(io->sqes, io->sqes_size);
+        munmap(io->sq_ring, io->sq_ring_size);
+        close(io->ring_fd);
+    }
+#endif
+
+    cecies_free(io->completions);
+    cecies_free(io);
+}
@@ -0,0 +1,798 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <zlib.h>
+#include <mbedtls/gcm.h>
+#include <mbedtls/platform_util.h>
+
+#include "cecies/util.h"
+#include "cecies/iovec.h"
+#include "internal.h"
+
+/*
+ * A read/write position inside an array of segments.
+ */
+typedef struct cecies_iov_cursor
+{
+    const cecies_iovec* iov;
+    size_t count;
+    size_t index;
+    size_t offset;
+} cecies_iov_cursor;
+
+static void cecies_iov_skip_empty(cecies_iov_cursor* cursor)
+{
+    while (cursor->index < cursor->count && cursor->offset == cursor->iov[cursor->index].iov_len)
+    {
+        cursor->index++;
+        cursor->offset = 0;
+    }
+}
+
+static void cecies_iov_cursor_init(cecies_iov_cursor* cursor, const cecies_iovec* iov, const size_t count)
+{
+    cursor->iov = iov;
+    cursor->count = count;
+    cursor->index = 0;
+    cursor->offset = 0;
+    cecies_iov_skip_empty(cursor);
+}
+
+/*
+ * How many bytes are available contiguously at the cursor position (0 at the end of the segments).
+ */
+static size_t cecies_iov_contiguous(const cecies_iov_cursor* cursor)
+{
+    return cursor->index < cursor->count ? cursor->iov[cursor->index].iov_len - cursor->offset : 0;
+}
+
+static uint8_t* cecies_iov_ptr(const cecies_iov_cursor* cursor)
+{
+    return (uint8_t*)cursor->iov[cursor->index].iov_base + cursor->offset;
+}
+
+static void cecies_iov_advance(cecies_iov_cursor* cursor, size_t n)
+{
+    while (n > 0 && cursor->index < cursor->count)
+    {
+        const size_t k = CECIES_MIN(n, cecies_iov_contiguous(cursor));
+        cursor->offset += k;
+        n -= k;
+        cecies_iov_skip_empty(cursor);
+    }
+}
+
+/*
+ * Copies n bytes from the cursor position into dst and advances the cursor (the caller makes sure that there are enough bytes left).
+ */
+static void cecies_iov_gather(cecies_iov_cursor* cursor, uint8_t* dst, size_t n)
+{
+    while (n > 0)
+    {
+        const size_t k = CECIES_MIN(n, cecies_iov_contiguous(cursor));
+        memcpy(dst, cecies_iov_ptr(cursor), k);
+        dst += k;
+        n -= k;
+        cecies_iov_advance(cursor, k);
+    }
+}
+
+/*
+ * Copies n bytes from src to the cursor position and advances the cursor (the caller makes sure that there's enough room left).
+ */
+static void cecies_iov_scatter(cecies_iov_cursor* cursor, const uint8_t* src, size_t n)
+{
+    while (n > 0)
+    {
+        const size_t k = CECIES_MIN(n, cecies_iov_contiguous(cursor));
+        memcpy(cecies_iov_ptr(cursor), src, k);
+        src += k;
+        n -= k;
+        cecies_iov_advance(cursor, k);
+    }
+}
+
+/*
+ * Wipes (at most) n bytes starting at the cursor position.
+ */
+static void cecies_iov_zeroize(cecies_iov_cursor cursor, size_t n)
+{
+    while (n > 0 && cursor.index < cursor.count)
+    {
+        const size_t k = CECIES_MIN(n, cecies_iov_contiguous(&cursor));
+        mbedtls_platform_zeroize(cecies_iov_ptr(&cursor), k);
+        n -= k;
+        cecies_iov_advance(&cursor, k);
+    }
+}
+
+/*
+ * Sums up the segment lengths. Returns 0 on success or 1 if a segment is NULL but not empty, or if the total overflows.
+ */
+static int cecies_iov_total_length(const cecies_iovec* iov, const size_t count, size_t* total)
+{
+    *total = 0;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if ((iov[i].iov_base == NULL && iov[i].iov_len != 0) || *total + iov[i].iov_len < *total)
+        {
+            return 1;
+        }
+
+        *total += iov[i].iov_len;
+    }
+
+    return 0;
+}
+
+/*
+ * Runs length bytes from the input cursor through GCM into the output cursor (which may point to the very same bytes for in-place operation).
+ * Runs of whole blocks that are contiguous on both sides go straight through; blocks that straddle segment boundaries are bounced through a local block.
+ */
+static int cecies_gcm_iov(mbedtls_gcm_context* gcm, cecies_iov_cursor* input, cecies_iov_cursor* output, size_t length)
+{
+    int ret = 0;
+    uint8_t block[16];
+
+    while (length > 0)
+    {
+        const size_t n = CECIES_MIN(length, CECIES_MIN(cecies_iov_contiguous(input), cecies_iov_contiguous(output))) & ~(size_t)15;
+
+        if (n > 0)
+        {
+            ret = cecies_gcm_update(gcm, cecies_iov_ptr(input), n, cecies_iov_ptr(output));
+            if (ret != 0)
+            {
+                break;
+            }
+
+            cecies_iov_advance(input, n);
+            cecies_iov_advance(output, n);
+            length -= n;
+            continue;
+        }
+
+        // Only the very last block can be a partial one (which is what MbedTLS 2 requires).
+        const size_t k = CECIES_MIN(length, 16);
+
+        cecies_iov_gather(input, block, k);
+
+        ret = cecies_gcm_update(gcm, block, k, block);
+        if (ret != 0)
+        {
+            break;
+        }
+
+        cecies_iov_scatter(output, block, k);
+        length -= k;
+    }
+
+    mbedtls_platform_zeroize(block, sizeof(block));
+    return (ret);
+}
+
+/*
+ * Deflates the data segments into a zlib stream of at most max_length bytes at the output cursor position (which is left untouched).
+ * Returns 0 on success, 1 if the compressed data would be longer than max_length or a CECIES_ENCRYPT_ERROR_CODE_* on failure.
+ */
+static int cecies_deflate_iov(const cecies_iovec* data, const size_t data_count, const int level, cecies_iov_cursor output, const size_t max_length, size_t* compressed_length)
+{
+    z_stream stream;
+    memset(&stream, 0x00, sizeof(stream));
+    stream.zalloc = cecies_zalloc;
+    stream.zfree = cecies_zfree;
+
+    if (deflateInit(&stream, level) != Z_OK)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_COMPRESSION_FAILED;
+    }
+
+    int ret = 1;
+    size_t written = 0;
+
+    cecies_iov_cursor input;
+    cecies_iov_cursor_init(&input, data, data_count);
+
+    while (written < max_length && cecies_iov_contiguous(&output) > 0)
+    {
+        if (stream.avail_in == 0 && cecies_iov_contiguous(&input) > 0)
+        {
+            const size_t n = CECIES_MIN(cecies_iov_contiguous(&input), (size_t)UINT32_MAX);
+            stream.next_in = cecies_iov_ptr(&input);
+            stream.avail_in = (uInt)n;
+            cecies_iov_advance(&input, n);
+        }
+
+        const uInt out_chunk = (uInt)CECIES_MIN(CECIES_MIN(cecies_iov_contiguous(&output), max_length - written), (size_t)UINT32_MAX);
+
+        stream.next_out = cecies_iov_ptr(&output);
+        stream.avail_out = out_chunk;
+
+        const int z = deflate(&stream, cecies_iov_contiguous(&input) == 0 ? Z_FINISH : Z_NO_FLUSH);
+
+        const size_t produced = out_chunk - stream.avail_out;
+        cecies_iov_advance(&output, produced);
+        written += produced;
+
+        if (z == Z_STREAM_END)
+        {
+            *compressed_length = written;
+            ret = 0;
+            break;
+        }
+
+        if (z != Z_OK && z != Z_BUF_ERROR)
+        {
+            cecies_fprintf(stderr, "CECIES: compression failed! deflate returned %d\n", z);
+            ret = CECIES_ENCRYPT_ERROR_CODE_COMPRESSION_FAILED;
+            break;
+        }
+    }
+
+    deflateEnd(&stream);
+    return (ret);
+}
+
+/*
+ * Incrementally inflates a (decrypted) zlib stream that arrives piece by piece into the output segments, checking its Adler-32 using cecies_adler32().
+ */
+typedef struct cecies_iov_inflater
+{
+    z_stream stream;
+    cecies_iov_cursor output;
+    size_t written;
+    uint32_t adler;
+
+    /* How many bytes of the zlib header are still to be skipped. */
+    size_t header_skip;
+
+    /* The Adler-32 trailer that follows the deflate data. */
+    uint8_t trailer[4];
+    size_t trailer_length;
+
+    int stream_end;
+} cecies_iov_inflater;
+
+static int cecies_iov_inflater_init(cecies_iov_inflater* inflater, const cecies_iov_cursor output)
+{
+    memset(inflater, 0x00, sizeof(cecies_iov_inflater));
+    inflater->stream.zalloc = cecies_zalloc;
+    inflater->stream.zfree = cecies_zfree;
+    inflater->output = output;
+    inflater->adler = 1;
+    inflater->header_skip = 2;
+
+    return inflateInit2(&inflater->stream, -15) == Z_OK ? 0 : CECIES_DECRYPT_ERROR_CODE_OUT_OF_MEMORY;
+}
+
+/*
+ * Feeds the next piece of the zlib stream to the inflater.
+ * Returns 0 on success, 1 if the data isn't a valid zlib stream after all, or CECIES_DECRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE if the output segments are too small.
+ */
+static int cecies_iov_inflater_update(cecies_iov_inflater* inflater, const uint8_t* data, size_t data_length)
+{
+    const size_t skip = CECIES_MIN(inflater->header_skip, data_length);
+    inflater->header_skip -= skip;
+    data += skip;
+    data_length -= skip;
+
+    z_stream* stream = &inflater->stream;
+    stream->next_in = (Bytef*)data;
+    stream->avail_in = (uInt)data_length;
+
+    int output_full = 0;
+
+    while (!inflater->stream_end && (stream->avail_in > 0 || output_full))
+    {
+        if (cecies_iov_contiguous(&inflater->output) == 0)
+        {
+            return CECIES_DECRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE;
+        }
+
+        uint8_t* out = cecies_iov_ptr(&inflater->output);
+        const uInt out_chunk = (uInt)CECIES_MIN(cecies_iov_contiguous(&inflater->output), (size_t)UINT32_MAX);
+
+        stream->next_out = out;
+        stream->avail_out = out_chunk;
+
+        const int z = inflate(stream, Z_NO_FLUSH);
+
+        const size_t produced = out_chunk - stream->avail_out;
+        inflater->adler = cecies_adler32(inflater->adler, out, produced);
+        cecies_iov_advance(&inflater->output, produced);
+        inflater->written += produced;
+        output_full = stream->avail_out == 0;
+
+        if (z == Z_STREAM_END)
+        {
+            inflater->stream_end = 1;
+            break;
+        }
+
+        if (z == Z_BUF_ERROR)
+        {
+            break;
+        }
+
+        if (z != Z_OK)
+        {
+            return 1;
+        }
+    }
+
+    // Whatever follows the deflate data is the trailer (and there's nothing after it).
+    if (inflater->stream_end && stream->avail_in > 0)
+    {
+        if (stream->avail_in > sizeof(inflater->trailer) - inflater->trailer_length)
+        {
+            return 1;
+        }
+
+        memcpy(inflater->trailer + inflater->trailer_length, stream->next_in, stream->avail_in);
+        inflater->trailer_length += stream->avail_in;
+        stream->avail_in = 0;
+    }
+
+    return 0;
+}
+
+/*
+ * Checks that the zlib stream is complete and that its checksum matches. Returns 0 on success and 1 otherwise.
+ */
+static int cecies_iov_inflater_finish(cecies_iov_inflater* inflater, size_t* output_length)
+{
+    const uint8_t* trailer = inflater->trailer;
+
+    if (!inflater->stream_end || inflater->trailer_length != sizeof(inflater->trailer))
+    {
+        return 1;
+    }
+
+    if (inflater->adler != (((uint32_t)trailer[0] << 24) | ((uint32_t)trailer[1] << 16) | ((uint32_t)trailer[2] << 8) | (uint32_t)trailer[3]))
+    {
+        return 1;
+    }
+
+    *output_length = inflater->written;
+    return 0;
+}
+
+/*
+ * Runs length bytes from the input cursor through GCM into a contiguous buffer.
+ */
+static int cecies_gcm_iov_to_buffer(mbedtls_gcm_context* gcm, cecies_iov_cursor* input, uint8_t* buffer, const size_t length)
+{
+    const cecies_iovec iov = { buffer, length };
+
+    cecies_iov_cursor output;
+    cecies_iov_cursor_init(&output, &iov, 1);
+
+    return cecies_gcm_iov(gcm, input, &output, length);
+}
+
+/*
+ * This avoids code duplication between the Curve25519 and Curve448 variants: pass 0 for Curve25519 and 1 for Curve448 as the last "curve" argument!
+ */
+static int cecies_encrypt_iov(const cecies_iovec* data, const size_t data_count, const int compress, const char* public_key, const int header_flags, const cecies_iovec* output, const size_t output_count, size_t* output_length, const int curve)
+{
+    if (data == NULL || output == NULL || output_length == NULL || public_key == NULL)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    size_t data_length = 0;
+    size_t output_size = 0;
+
+    if (cecies_iov_total_length(data, data_count, &data_length) != 0 || cecies_iov_total_length(output, output_count, &output_size) != 0)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    if (data_length == 0 || (header_flags & ~CECIES_HEADER_FLAGS_SUPPORTED) != 0)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    const size_t key_length = curve == 0 ? CECIES_X25519_KEY_SIZE : CECIES_X448_KEY_SIZE;
+    const size_t header_length = cecies_calc_ext_header_length(header_flags | (curve == 0 ? 0 : CECIES_HEADER_FLAG_CURVE448)) + 16 + 32 + key_length + 16;
+
+    // Uncompressed payloads need exactly as much room as the data; compressed ones need less (or they're not worth it).
+    if (output_size <= header_length || (!compress && output_size - header_length < data_length))
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE;
+    }
+
+    int ret = 1;
+
+    size_t payload_length = data_length;
+    size_t touched = 0;
+    int compressed = 0;
+
+    cecies_encryption_setup setup;
+    uint8_t header[CECIES_MAX_HEADER_SIZE];
+
+    cecies_iov_cursor output_start;
+    cecies_iov_cursor_init(&output_start, output, output_count);
+
+    cecies_iov_cursor payload = output_start;
+    cecies_iov_advance(&payload, header_length);
+
+    mbedtls_gcm_context gcm;
+    mbedtls_gcm_init(&gcm);
+
+    if (compress)
+    {
+        const int level = compress < 1 ? Z_DEFAULT_COMPRESSION : CECIES_MIN(compress, 9);
+
+        // Everything that deflate may write counts as touched, even if it doesn't finish.
+        touched = header_length + CECIES_MIN(output_size - header_length, data_length - 1);
+
+        ret = cecies_deflate_iov(data, data_count, level, payload, data_length - 1, &payload_length);
+        if (ret > 1)
+        {
+            goto exit;
+        }
+
+        compressed = ret == 0;
+        payload_length = compressed ? payload_length : data_length;
+
+        if (!compressed && output_size - header_length < data_length)
+        {
+            ret = CECIES_ENCRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE;
+            goto exit;
+        }
+    }
+
+    ret = cecies_encryption_setup_init(public_key, header_flags, curve, &setup);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    if (compressed && setup.ext_header_length != 0)
+    {
+        setup.header_flags |= CECIES_HEADER_FLAG_COMPRESSED;
+    }
+
+    ret = mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, setup.aes_key, 256);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: AES key setup failed! mbedtls_gcm_setkey returned %d\n", ret);
+        goto exit;
+    }
+
+    cecies_encryption_setup_write_header(&setup, header);
+
+    ret = cecies_gcm_starts(&gcm, MBEDTLS_GCM_ENCRYPT, setup.iv, header, setup.ext_header_length);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: AES-GCM encryption failed! mbedtls_gcm_starts returned %d\n", ret);
+        goto exit;
+    }
+
+    cecies_iov_cursor input;
+
+    if (compressed)
+    {
+        input = payload; // In place.
+    }
+    else
+    {
+        cecies_iov_cursor_init(&input, data, data_count);
+    }
+
+    touched = CECIES_MAX(touched, header_length + payload_length);
+
+    ret = cecies_gcm_iov(&gcm, &input, &payload, payload_length);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: AES-GCM encryption failed! mbedtls_gcm_update returned %d\n", ret);
+        goto exit;
+    }
+
+    ret = cecies_gcm_finish(&gcm, header + header_length - 16);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: AES-GCM encryption failed! mbedtls_gcm_finish returned %d\n", ret);
+        goto exit;
+    }
+
+    cecies_iov_scatter(&output_start, header, header_length);
+    *output_length = header_length + payload_length;
+
+exit:
+
+    if (ret != 0)
+    {
+        // Don't leave any compressed plaintext behind in the output segments.
+        cecies_iov_zeroize(output_start, touched);
+    }
+
+    mbedtls_gcm_free(&gcm);
+    mbedtls_platform_zeroize(&setup, sizeof(setup));
+    mbedtls_platform_zeroize(header, sizeof(header));
+
+    return (ret);
+}
+
+int cecies_curve25519_encrypt_iov(const cecies_iovec* data, const size_t data_count, const int compress, const cecies_curve25519_key public_key, const int header_flags, const cecies_iovec* output, const size_t output_count, size_t* output_length)
+{
+    return cecies_encrypt_iov(data, data_count, compress, public_key.hexstring, header_flags, output, output_count, output_length, 0);
+}
+
+int cecies_curve448_encrypt_iov(const cecies_iovec* data, const size_t data_count, const int compress, const cecies_curve448_key public_key, const int header_flags, const cecies_iovec* output, const size_t output_count, size_t* output_length)
+{
+    return cecies_encrypt_iov(data, data_count, compress, public_key.hexstring, header_flags, output, output_count, output_length, 1);
+}
+
+static int cecies_decrypt_iov(const cecies_iovec* encrypted_data, const size_t encrypted_data_count, char* private_key, const cecies_iovec* output, const size_t output_count, size_t* output_length, const int curve)
+{
+    const size_t key_length = curve == 0 ? CECIES_X25519_KEY_SIZE : CECIES_X448_KEY_SIZE;
+
+    if (encrypted_data == NULL || output == NULL || output_length == NULL || private_key == NULL)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed: one or more NULL arguments.\n");
+        return CECIES_DECRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    int ret = 1;
+
+    size_t encrypted_data_length = 0;
+    size_t output_size = 0;
+    size_t payload_length = 0;
+    int decrypted = 0;
+
+    uint8_t private_key_bytes[64] = { 0x00 };
+    size_t private_key_bytes_length = 0;
+
+    uint8_t header_buffer[CECIES_MAX_HEADER_SIZE + 1];
+    uint8_t aes_key[32] = { 0x00 };
+    uint8_t tag[16] = { 0x00 };
+    uint8_t chunk[4096];
+
+    int inflating = 0;
+    int inflate_ret = 0;
+    int inflater_initialized = 0;
+    cecies_iov_inflater inflater;
+
+    cecies_header header;
+
+    mbedtls_gcm_context gcm;
+    mbedtls_gcm_init(&gcm);
+
+    cecies_iov_cursor input;
+    cecies_iov_cursor_init(&input, encrypted_data, encrypted_data_count);
+
+    cecies_iov_cursor output_start;
+    cecies_iov_cursor_init(&output_start, output, output_count);
+
+    if (cecies_iov_total_length(encrypted_data, encrypted_data_count, &encrypted_data_length) != 0 || cecies_iov_total_length(output, output_count, &output_size) != 0)
+    {
+        ret = CECIES_DECRYPT_ERROR_CODE_NULL_ARG;
+        goto exit;
+    }
+
+    const size_t header_buffer_length = CECIES_MIN(encrypted_data_length, sizeof(header_buffer));
+    cecies_iov_gather(&input, header_buffer, header_buffer_length);
+
+    ret = cecies_parse_header(header_buffer, header_buffer_length, curve, &header);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    // The header buffer holds the beginning of the payload too: rewind the input to where the payload starts.
+    const size_t header_length = (size_t)(header.ciphertext - header_buffer);
+    payload_length = encrypted_data_length - header_length;
+
+    cecies_iov_cursor_init(&input, encrypted_data, encrypted_data_count);
+    cecies_iov_advance(&input, header_length);
+
+    if (output_size < payload_length)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed: output segments too small.\n");
+        ret = CECIES_DECRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE;
+        goto exit;
+    }
+
+    ret = cecies_hexstr2bin(private_key, key_length * 2, private_key_bytes, sizeof(private_key_bytes), &private_key_bytes_length);
+    if (ret != 0 || private_key_bytes_length != key_length)
+    {
+        cecies_fprintf(stderr, "CECIES: Parsing decryption private key failed! Invalid hex string format or invalid key length... cecies_hexstr2bin returned %d\n", ret);
+        ret = CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+        goto exit;
+    }
+
+    ret = cecies_derive_header_key(&header, private_key_bytes, curve, aes_key);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    ret = mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, aes_key, 256);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: AES key setup failed! mbedtls_gcm_setkey returned %d\n", ret);
+        goto exit;
+    }
+
+    ret = cecies_gcm_starts(&gcm, MBEDTLS_GCM_DECRYPT, header.iv, header.ext, header.ext_length);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed! mbedtls_gcm_starts returned %d\n", ret);
+        goto exit;
+    }
+
+    cecies_iov_cursor plaintext = output_start;
+    decrypted = 1;
+
+    // Ciphertexts with an extended header say whether the payload is compressed, legacy ones need the first decrypted chunk to tell whether it's a zlib stream:
+    // if it is, every chunk is inflated straight into the output segments as soon as it's decrypted (there's never a copy of the whole compressed payload).
+    const size_t first_length = CECIES_MIN(payload_length, sizeof(chunk));
+
+    ret = cecies_gcm_iov_to_buffer(&gcm, &input, chunk, first_length);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed! mbedtls_gcm_update returned %d\n", ret);
+        goto exit;
+    }
+
+    const int compression = cecies_payload_compression(&header, chunk, payload_length);
+    inflating = compression != CECIES_PAYLOAD_PLAIN;
+
+    if (!inflating)
+    {
+        cecies_iov_scatter(&plaintext, chunk, first_length);
+        ret = cecies_gcm_iov(&gcm, &input, &plaintext, payload_length - first_length);
+    }
+    else
+    {
+        ret = cecies_iov_inflater_init(&inflater, output_start);
+        if (ret != 0)
+        {
+            goto exit;
+        }
+
+        inflater_initialized = 1;
+        inflate_ret = cecies_iov_inflater_update(&inflater, chunk, first_length);
+
+        for (size_t done = first_length; ret == 0 && done < payload_length;)
+        {
+            const size_t n = CECIES_MIN(payload_length - done, sizeof(chunk));
+
+            ret = cecies_gcm_iov_to_buffer(&gcm, &input, chunk, n);
+
+            // Once inflating failed, the rest of the payload is only decrypted for the sake of the authentication tag.
+            if (ret == 0 && inflate_ret == 0)
+            {
+                inflate_ret = cecies_iov_inflater_update(&inflater, chunk, n);
+            }
+
+            done += n;
+        }
+
+        if (ret == 0 && inflate_ret == 0)
+        {
+            inflate_ret = cecies_iov_inflater_finish(&inflater, output_length);
+        }
+    }
+
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed! mbedtls_gcm_update returned %d\n", ret);
+        goto exit;
+    }
+
+    ret = cecies_gcm_finish(&gcm, tag);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed! mbedtls_gcm_finish returned %d\n", ret);
+        goto exit;
+    }
+
+    uint8_t diff = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        diff |= (uint8_t)(tag[i] ^ header.tag[i]);
+    }
+
+    if (diff != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed! The GCM authentication tag doesn't match.\n");
+        ret = CECIES_DECRYPT_ERROR_CODE_VERIFICATION_FAILED;
+        goto exit;
+    }
+
+    if (!inflating)
+    {
+        *output_length = payload_length;
+        goto exit;
+    }
+
+    if (inflate_ret == CECIES_DECRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed: output segments too small for the decompressed payload.\n");
+        ret = inflate_ret;
+        goto exit;
+    }
+
+    if (inflate_ret != 0 && compression == CECIES_PAYLOAD_COMPRESSED)
+    {
+        cecies_fprintf(stderr, "CECIES: decompression failed! The payload is flagged as compressed but doesn't inflate.\n");
+        ret = CECIES_DECRYPT_ERROR_CODE_DECOMPRESSION_FAILED;
+        goto exit;
+    }
+
+    if (inflate_ret != 0)
+    {
+        // Just like the one-shot decryption: legacy data that only happens to start with a zlib header is returned as it is.
+        // The (already authenticated) payload is simply decrypted once more, this time straight into the output segments.
+        cecies_iov_cursor_init(&input, encrypted_data, encrypted_data_count);
+        cecies_iov_advance(&input, header_length);
+        plaintext = output_start;
+
+        ret = cecies_gcm_starts(&gcm, MBEDTLS_GCM_DECRYPT, header.iv, header.ext, header.ext_length);
+        if (ret == 0)
+        {
+            ret = cecies_gcm_iov(&gcm, &input, &plaintext, payload_length);
+        }
+
+        if (ret != 0)
+        {
+            cecies_fprintf(stderr, "CECIES: decryption failed! GCM returned %d\n", ret);
+            goto exit;
+        }
+
+        *output_length = payload_length;
+    }
+
+exit:
+
+    if (ret != 0 && decrypted)
+    {
+        cecies_iov_zeroize(output_start, output_size);
+    }
+
+    if (inflater_initialized)
+    {
+        inflateEnd(&inflater.stream);
+    }
+
+    mbedtls_gcm_free(&gcm);
+
+    mbedtls_platform_zeroize(private_key, key_length * 2);
+    mbedtls_platform_zeroize(private_key_bytes, sizeof(private_key_bytes));
+    mbedtls_platform_zeroize(header_buffer, sizeof(header_buffer));
+    mbedtls_platform_zeroize(aes_key, sizeof(aes_key));
+    mbedtls_platform_zeroize(tag, sizeof(tag));
+    mbedtls_platform_zeroize(chunk, sizeof(chunk));
+
+    return (ret);
+}
+
+int cecies_curve25519_decrypt_iov(const cecies_iovec* encrypted_data, const size_t encrypted_data_count, cecies_curve25519_key private_key, const cecies_iovec* output, const size_t output_count, size_t* output_length)
+{
+    return cecies_decrypt_iov(encrypted_data, encrypted_data_count, private_key.hexstring, output, output_count, output_length, 0);
+}
+
+int cecies_curve448_decrypt_iov(const cecies_iovec* encrypted_data, const size_t encrypted_data_count, cecies_curve448_key private_key, const cecies_iovec* output, const size_t output_count, size_t* output_length)
+{
+    return cecies_decrypt_iov(encrypted_data, encrypted_data_count, private_key.hexstring, output, output_count, output_length, 1);
+}
@@ -25,6 +25,7 @@
 
 #include "cecies/guid.h"
 #include "cecies/keygen.h"
+#include "internal.h"
 
 #include "cecies/data.txt"
 
@@ -84,10 +85,10 @@ int cecies_generate_curve25519_keypair(cecies_curve25519_keypair* output, const
 
     // Generate EC key-pair.
 
-    ret = mbedtls_ecp_gen_keypair(&ecp_group, &r, &R, mbedtls_ctr_drbg_random, &ctr_drbg);
+    ret = cecies_ecp_gen_keypair(&ecp_group, &r, &R, mbedtls_ctr_drbg_random, &ctr_drbg);
     if (ret != 0)
     {
-        cecies_fprintf(stderr, "\nCECIES: Keypair generation failed! mbedtls_ecp_gen_keypair returned %d\n", ret);
+        cecies_fprintf(stderr, "\nCECIES: Keypair generation failed! cecies_ecp_gen_keypair returned %d\n", ret);
         goto exit;
     }
 
@@ -211,10 +212,10 @@ int cecies_generate_curve448_keypair(cecies_curve448_keypair* output, const uint
 
     // Generate EC key-pair.
 
-    ret = mbedtls_ecp_gen_keypair(&ecp_group, &r, &R, mbedtls_ctr_drbg_random, &ctr_drbg);
+    ret = cecies_ecp_gen_keypair(&ecp_group, &r, &R, mbedtls_ctr_drbg_random, &ctr_drbg);
     if (ret != 0)
     {
-        cecies_fprintf(stderr, "\nCECIES: Keypair generation failed! mbedtls_ecp_gen_keypair returned %d\n", ret);
+        cecies_fprintf(stderr, "\nCECIES: Keypair generation failed! cecies_ecp_gen_keypair returned %d\n", ret);
         goto exit;
     }
 
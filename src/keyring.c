@@ -0,0 +1,554 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_NO_STATUS
+#include <windows.h>
+#undef WIN32_NO_STATUS
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include <mbedtls/platform_util.h>
+
+#include "cecies/util.h"
+#include "cecies/keyring.h"
+#include "internal.h"
+
+/*
+ * Keyring file layout (all integers are little-endian):
+ *
+ *   Offset  Size  Field
+ *   0       8     Magic bytes "CECIESKR"
+ *   8       4     Format version (currently 1)
+ *   12      4     Curve (0 for Curve25519, 1 for Curve448)
+ *   16      8     Key count (n)
+ *   24      8     Index bucket count (b): a power of 2 that is at least 2n
+ *   32      ...   n entries of [key ID (8 bytes) | raw private key (32 or 56 bytes)]
+ *   ...     4b    Open-addressing hash index: each bucket holds (entry index + 1), 0 marks an empty bucket
+ *
+ * The bucket for a key ID is its first 8 bytes (read as little-endian integer) modulo b; collisions are resolved by linear probing.
+ * Key IDs are SHA2-512 output, so they're uniformly distributed and don't need to be hashed again.
+ */
+
+#define CECIES_KEYRING_HEADER_SIZE 32
+#define CECIES_KEYRING_VERSION 1
+
+static const uint8_t CECIES_KEYRING_MAGIC[8] = { 'C', 'E', 'C', 'I', 'E', 'S', 'K', 'R' };
+
+struct cecies_keyring
+{
+    const uint8_t* map;
+    size_t map_size;
+    int curve;
+    size_t key_size;
+    size_t entry_size;
+    uint64_t key_count;
+    uint64_t bucket_count;
+    const uint8_t* entries;
+    const uint8_t* index;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+};
+
+static inline uint32_t cecies_keyring_read_u32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint64_t cecies_keyring_read_u64(const uint8_t* p)
+{
+    return (uint64_t)cecies_keyring_read_u32(p) | ((uint64_t)cecies_keyring_read_u32(p + 4) << 32);
+}
+
+static inline void cecies_keyring_write_u32(uint8_t* p, const uint32_t v)
+{
+    p[0] = (uint8_t)(v);
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline void cecies_keyring_write_u64(uint8_t* p, const uint64_t v)
+{
+    cecies_keyring_write_u32(p, (uint32_t)v);
+    cecies_keyring_write_u32(p + 4, (uint32_t)(v >> 32));
+}
+
+static FILE* cecies_keyring_create_file(const char* file_path)
+{
+#ifdef _WIN32
+    return fopen(file_path, "wb");
+#else
+    const int fd = open(file_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+
+    FILE* file = fdopen(fd, "wb");
+    if (file == NULL)
+    {
+        close(fd);
+    }
+
+    return file;
+#endif
+}
+
+/*
+ * Both keypair types are laid out as { public_key hex-string, private_key hex-string },
+ * so the writer just walks over them with the keypair struct's size as stride.
+ */
+static int cecies_keyring_write(const char* file_path, const uint8_t* keypairs, const size_t keypairs_count, const size_t keypair_size, const size_t private_key_offset, const int curve)
+{
+    if (file_path == NULL || keypairs == NULL)
+    {
+        return CECIES_KEYRING_ERROR_CODE_NULL_ARG;
+    }
+
+    if (keypairs_count == 0 || keypairs_count >= UINT32_MAX / 2)
+    {
+        return CECIES_KEYRING_ERROR_CODE_INVALID_ARG;
+    }
+
+    const size_t key_size = curve == 0 ? CECIES_X25519_KEY_SIZE : CECIES_X448_KEY_SIZE;
+
+    uint64_t bucket_count = 2;
+    while (bucket_count < (uint64_t)keypairs_count * 2)
+    {
+        bucket_count <<= 1;
+    }
+
+    int ret = 1;
+    FILE* file = NULL;
+
+    uint8_t header[CECIES_KEYRING_HEADER_SIZE] = { 0x00 };
+    uint8_t entry[CECIES_KEY_ID_SIZE + 64] = { 0x00 };
+    uint8_t public_key[64 + 1] = { 0x00 };
+
+    uint8_t* key_ids = cecies_malloc(keypairs_count * CECIES_KEY_ID_SIZE);
+    uint8_t* index = cecies_calloc((size_t)bucket_count, 4);
+
+    if (key_ids == NULL || index == NULL)
+    {
+        ret = CECIES_KEYRING_ERROR_CODE_OUT_OF_MEMORY;
+        goto exit;
+    }
+
+    const uint64_t mask = bucket_count - 1;
+
+    for (size_t i = 0; i < keypairs_count; ++i)
+    {
+        const char* public_key_hexstr = (const char*)(keypairs + i * keypair_size);
+
+        size_t public_key_length = 0;
+        if (cecies_hexstr2bin(public_key_hexstr, key_size * 2, public_key, sizeof(public_key), &public_key_length) != 0 || public_key_length != key_size)
+        {
+            cecies_fprintf(stderr, "CECIES: Writing keyring failed! Public key #%zu has an invalid format.\n", i);
+            ret = CECIES_KEYRING_ERROR_CODE_INVALID_ARG;
+            goto exit;
+        }
+
+        uint8_t* key_id = key_ids + i * CECIES_KEY_ID_SIZE;
+        cecies_calc_key_id(public_key, public_key_length, key_id);
+
+        uint64_t bucket = cecies_keyring_read_u64(key_id) & mask;
+
+        for (;;)
+        {
+            const uint32_t slot = cecies_keyring_read_u32(index + bucket * 4);
+            if (slot == 0)
+            {
+                cecies_keyring_write_u32(index + bucket * 4, (uint32_t)(i + 1));
+                break;
+            }
+
+            if (memcmp(key_ids + (size_t)(slot - 1) * CECIES_KEY_ID_SIZE, key_id, CECIES_KEY_ID_SIZE) == 0)
+            {
+                cecies_fprintf(stderr, "CECIES: Writing keyring failed! Key #%zu has the same key ID as key #%u (duplicate key?)\n", i, slot - 1);
+                ret = CECIES_KEYRING_ERROR_CODE_INVALID_ARG;
+                goto exit;
+            }
+
+            bucket = (bucket + 1) & mask;
+        }
+    }
+
+    file = cecies_keyring_create_file(file_path);
+    if (file == NULL)
+    {
+        cecies_fprintf(stderr, "CECIES: Writing keyring failed! Couldn't create the file \"%s\"\n", file_path);
+        ret = CECIES_KEYRING_ERROR_CODE_FILE_ACCESS_FAILED;
+        goto exit;
+    }
+
+    memcpy(header, CECIES_KEYRING_MAGIC, sizeof(CECIES_KEYRING_MAGIC));
+    cecies_keyring_write_u32(header + 8, CECIES_KEYRING_VERSION);
+    cecies_keyring_write_u32(header + 12, (uint32_t)curve);
+    cecies_keyring_write_u64(header + 16, (uint64_t)keypairs_count);
+    cecies_keyring_write_u64(header + 24, bucket_count);
+
+    if (fwrite(header, 1, sizeof(header), file) != sizeof(header))
+    {
+        ret = CECIES_KEYRING_ERROR_CODE_FILE_ACCESS_FAILED;
+        goto exit;
+    }
+
+    for (size_t i = 0; i < keypairs_count; ++i)
+    {
+        const char* private_key_hexstr = (const char*)(keypairs + i * keypair_size + private_key_offset);
+
+        size_t private_key_length = 0;
+        if (cecies_hexstr2bin(private_key_hexstr, key_size * 2, entry + CECIES_KEY_ID_SIZE, sizeof(entry) - CECIES_KEY_ID_SIZE, &private_key_length) != 0 || private_key_length != key_size)
+        {
+            cecies_fprintf(stderr, "CECIES: Writing keyring failed! Private key #%zu has an invalid format.\n", i);
+            ret = CECIES_KEYRING_ERROR_CODE_INVALID_ARG;
+            goto exit;
+        }
+
+        memcpy(entry, key_ids + i * CECIES_KEY_ID_SIZE, CECIES_KEY_ID_SIZE);
+
+        if (fwrite(entry, 1, CECIES_KEY_ID_SIZE + key_size, file) != CECIES_KEY_ID_SIZE + key_size)
+        {
+            ret = CECIES_KEYRING_ERROR_CODE_FILE_ACCESS_FAILED;
+            goto exit;
+        }
+    }
+
+    if (fwrite(index, 4, (size_t)bucket_count, file) != (size_t)bucket_count)
+    {
+        ret = CECIES_KEYRING_ERROR_CODE_FILE_ACCESS_FAILED;
+        goto exit;
+    }
+
+    ret = 0;
+
+exit:
+
+    if (file != NULL && fclose(file) != 0 && ret == 0)
+    {
+        ret = CECIES_KEYRING_ERROR_CODE_FILE_ACCESS_FAILED;
+    }
+
+    if (ret != 0 && file != NULL)
+    {
+        remove(file_path);
+    }
+
+    mbedtls_platform_zeroize(entry, sizeof(entry));
+
+    cecies_free(key_ids);
+    cecies_free(index);
+
+    return (ret);
+}
+
+int cecies_curve25519_keyring_write(const char* file_path, const cecies_curve25519_keypair* keypairs, const size_t keypairs_count)
+{
+    return cecies_keyring_write(file_path, (const uint8_t*)keypairs, keypairs_count, sizeof(cecies_curve25519_keypair), offsetof(cecies_curve25519_keypair, private_key), 0);
+}
+
+int cecies_curve448_keyring_write(const char* file_path, const cecies_curve448_keypair* keypairs, const size_t keypairs_count)
+{
+    return cecies_keyring_write(file_path, (const uint8_t*)keypairs, keypairs_count, sizeof(cecies_curve448_keypair), offsetof(cecies_curve448_keypair, private_key), 1);
+}
+
+static void cecies_keyring_unmap(cecies_keyring* keyring)
+{
+#ifdef _WIN32
+    if (keyring->map != NULL)
+    {
+        UnmapViewOfFile(keyring->map);
+    }
+
+    if (keyring->mapping != NULL)
+    {
+        CloseHandle(keyring->mapping);
+    }
+
+    if (keyring->file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(keyring->file);
+    }
+#else
+    if (keyring->map != NULL)
+    {
+        munmap((void*)keyring->map, keyring->map_size);
+    }
+#endif
+}
+
+static int cecies_keyring_map(const char* file_path, cecies_keyring* keyring)
+{
+#ifdef _WIN32
+    keyring->file = CreateFileA(file_path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+    if (keyring->file == INVALID_HANDLE_VALUE)
+    {
+        return CECIES_KEYRING_ERROR_CODE_FILE_ACCESS_FAILED;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(keyring->file, &file_size) || file_size.QuadPart < CECIES_KEYRING_HEADER_SIZE || (uint64_t)file_size.QuadPart > SIZE_MAX)
+    {
+        return CECIES_KEYRING_ERROR_CODE_INVALID_FILE;
+    }
+
+    keyring->map_size = (size_t)file_size.QuadPart;
+
+    keyring->mapping = CreateFileMappingA(keyring->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (keyring->mapping == NULL)
+    {
+        return CECIES_KEYRING_ERROR_CODE_FILE_ACCESS_FAILED;
+    }
+
+    keyring->map = MapViewOfFile(keyring->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (keyring->map == NULL)
+    {
+        return CECIES_KEYRING_ERROR_CODE_FILE_ACCESS_FAILED;
+    }
+#else
+    const int fd = open(file_path, O_RDONLY);
+    if (fd < 0)
+    {
+        return CECIES_KEYRING_ERROR_CODE_FILE_ACCESS_FAILED;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < CECIES_KEYRING_HEADER_SIZE || (uint64_t)st.st_size > SIZE_MAX)
+    {
+        close(fd);
+        return CECIES_KEYRING_ERROR_CODE_INVALID_FILE;
+    }
+
+    keyring->map_size = (size_t)st.st_size;
+
+    void* map = mmap(NULL, keyring->map_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED)
+    {
+        return CECIES_KEYRING_ERROR_CODE_FILE_ACCESS_FAILED;
+    }
+
+#ifdef MADV_RANDOM
+    // Lookups hit random pages: don't waste I/O on read-ahead.
+    madvise(map, keyring->map_size, MADV_RANDOM);
+#endif
+
+    keyring->map = map;
+#endif
+    return 0;
+}
+
+int cecies_keyring_open(const char* file_path, cecies_keyring** out_keyring)
+{
+    if (file_path == NULL || out_keyring == NULL)
+    {
+        return CECIES_KEYRING_ERROR_CODE_NULL_ARG;
+    }
+
+    cecies_keyring* keyring = cecies_calloc(1, sizeof(cecies_keyring));
+    if (keyring == NULL)
+    {
+        return CECIES_KEYRING_ERROR_CODE_OUT_OF_MEMORY;
+    }
+
+#ifdef _WIN32
+    keyring->file = INVALID_HANDLE_VALUE;
+#endif
+
+    int ret = cecies_keyring_map(file_path, keyring);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Opening keyring \"%s\" failed! Couldn't map the file into memory.\n", file_path);
+        goto exit;
+    }
+
+    ret = CECIES_KEYRING_ERROR_CODE_INVALID_FILE;
+
+    const uint8_t* header = keyring->map;
+
+    if (memcmp(header, CECIES_KEYRING_MAGIC, sizeof(CECIES_KEYRING_MAGIC)) != 0 || cecies_keyring_read_u32(header + 8) != CECIES_KEYRING_VERSION)
+    {
+        cecies_fprintf(stderr, "CECIES: Opening keyring \"%s\" failed! Not a keyring file, or unsupported keyring format version.\n", file_path);
+        goto exit;
+    }
+
+    const uint32_t curve = cecies_keyring_read_u32(header + 12);
+    const uint64_t key_count = cecies_keyring_read_u64(header + 16);
+    const uint64_t bucket_count = cecies_keyring_read_u64(header + 24);
+
+    if (curve > 1 || key_count == 0 || key_count >= UINT32_MAX / 2 || bucket_count < key_count * 2 || bucket_count > UINT32_MAX || (bucket_count & (bucket_count - 1)) != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Opening keyring \"%s\" failed! Corrupt keyring header.\n", file_path);
+        goto exit;
+    }
+
+    keyring->curve = (int)curve;
+    keyring->key_size = curve == 0 ? CECIES_X25519_KEY_SIZE : CECIES_X448_KEY_SIZE;
+    keyring->entry_size = CECIES_KEY_ID_SIZE + keyring->key_size;
+    keyring->key_count = key_count;
+    keyring->bucket_count = bucket_count;
+
+    if ((uint64_t)keyring->map_size != CECIES_KEYRING_HEADER_SIZE + key_count * keyring->entry_size + bucket_count * 4)
+    {
+        cecies_fprintf(stderr, "CECIES: Opening keyring \"%s\" failed! The file size doesn't match its header (truncated file?)\n", file_path);
+        goto exit;
+    }
+
+    keyring->entries = keyring->map + CECIES_KEYRING_HEADER_SIZE;
+    keyring->index = keyring->entries + key_count * keyring->entry_size;
+
+    ret = 0;
+    *out_keyring = keyring;
+
+exit:
+
+    if (ret != 0)
+    {
+        cecies_keyring_unmap(keyring);
+        cecies_free(keyring);
+    }
+
+    return (ret);
+}
+
+void cecies_keyring_close(cecies_keyring* keyring)
+{
+    if (keyring == NULL)
+    {
+        return;
+    }
+
+    cecies_keyring_unmap(keyring);
+    cecies_free(keyring);
+}
+
+int cecies_keyring_get_curve(const cecies_keyring* keyring)
+{
+    return keyring != NULL ? keyring->curve : -1;
+}
+
+size_t cecies_keyring_get_key_count(const cecies_keyring* keyring)
+{
+    return keyring != NULL ? (size_t)keyring->key_count : 0;
+}
+
+int cecies_keyring_find(const cecies_keyring* keyring, const uint8_t* key_id, const uint8_t** out_private_key, size_t* out_private_key_length)
+{
+    if (keyring == NULL || key_id == NULL || out_private_key == NULL)
+    {
+        return CECIES_KEYRING_ERROR_CODE_NULL_ARG;
+    }
+
+    const uint64_t mask = keyring->bucket_count - 1;
+    uint64_t bucket = cecies_keyring_read_u64(key_id) & mask;
+
+    // The index is at most half full, so there's always an empty bucket that terminates the probe sequence.
+    for (uint64_t probes = 0; probes < keyring->bucket_count; ++probes)
+    {
+        const uint32_t slot = cecies_keyring_read_u32(keyring->index + bucket * 4);
+        if (slot == 0 || slot > keyring->key_count)
+        {
+            break;
+        }
+
+        const uint8_t* entry = keyring->entries + (size_t)(slot - 1) * keyring->entry_size;
+
+        if (memcmp(entry, key_id, CECIES_KEY_ID_SIZE) == 0)
+        {
+            *out_private_key = entry + CECIES_KEY_ID_SIZE;
+
+            if (out_private_key_length != NULL)
+            {
+                *out_private_key_length = keyring->key_size;
+            }
+
+            return 0;
+        }
+
+        bucket = (bucket + 1) & mask;
+    }
+
+    return CECIES_KEYRING_ERROR_CODE_KEY_NOT_FOUND;
+}
+
+int cecies_keyring_decrypt(const cecies_keyring* keyring, const uint8_t* encrypted_data, const size_t encrypted_data_length, const int encrypted_data_base64, uint8_t** output, size_t* output_length)
+{
+    if (keyring == NULL || encrypted_data == NULL || output == NULL || output_length == NULL)
+    {
+        cecies_fprintf(stderr, "CECIES: keyring decryption failed: one or more NULL arguments.\n");
+        return CECIES_KEYRING_ERROR_CODE_NULL_ARG;
+    }
+
+    if (encrypted_data_length == 0)
+    {
+        return CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    uint8_t* input = NULL;
+    size_t input_length = 0;
+
+    cecies_header header;
+    const uint8_t* private_key = NULL;
+
+    int ret = cecies_decode_input(encrypted_data, encrypted_data_length, encrypted_data_base64, &input, &input_length);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    ret = cecies_parse_header(input, input_length, keyring->curve, &header);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    if (header.key_id == NULL)
+    {
+        cecies_fprintf(stderr, "CECIES: keyring decryption failed: the ciphertext doesn't contain a key ID hint.\n");
+        ret = CECIES_KEYRING_ERROR_CODE_KEY_NOT_FOUND;
+        goto exit;
+    }
+
+    ret = cecies_keyring_find(keyring, header.key_id, &private_key, NULL);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: keyring decryption failed: no private key for the ciphertext's key ID found in the keyring.\n");
+        goto exit;
+    }
+
+    ret = cecies_decrypt_header(&header, private_key, keyring->curve, 1, output, output_length);
+
+exit:
+
+    if (encrypted_data_base64)
+    {
+        cecies_free(input);
+    }
+
+    return (ret);
+}
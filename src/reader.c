@@ -0,0 +1,226 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <zlib.h>
+#include <mbedtls/platform_util.h>
+
+#include "cecies/util.h"
+#include "cecies/reader.h"
+#include "internal.h"
+
+struct cecies_reader
+{
+    /* The decrypted and authenticated payload (still compressed if it was compressed). */
+    uint8_t* plaintext;
+    size_t plaintext_length;
+
+    /* How far into the plaintext buffer reading (or inflating) has progressed. */
+    size_t position;
+
+    /* Set while the plaintext is being inflated; cleared for uncompressed plaintexts. */
+    int compressed;
+
+    /* Set if the extended header flags the payload as compressed: then it has to inflate, there's no falling back to "not compressed after all". */
+    int flagged;
+
+    /* Whether inflated bytes were handed out already (after that, there's no more falling back to "not compressed after all"). */
+    int produced;
+
+    int finished;
+
+    z_stream stream;
+    uint32_t adler;
+};
+
+static void cecies_reader_release(cecies_reader* reader)
+{
+    if (reader->compressed)
+    {
+        inflateEnd(&reader->stream);
+        reader->compressed = 0;
+    }
+
+    if (reader->plaintext != NULL)
+    {
+        mbedtls_platform_zeroize(reader->plaintext, reader->plaintext_length);
+        cecies_free(reader->plaintext);
+        reader->plaintext = NULL;
+    }
+
+    reader->plaintext_length = reader->position = 0;
+}
+
+static int cecies_decrypt_reader(const uint8_t* encrypted_data, const size_t encrypted_data_length, const int encrypted_data_base64, char* private_key, cecies_reader** out_reader, const int curve)
+{
+    if (out_reader == NULL)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed: one or more NULL arguments.\n");
+        return CECIES_DECRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    uint8_t* plaintext = NULL;
+    size_t plaintext_length = 0;
+    int compression = CECIES_PAYLOAD_PLAIN;
+
+    int ret = cecies_decrypt(encrypted_data, encrypted_data_length, encrypted_data_base64, private_key, &plaintext, &plaintext_length, curve, CECIES_DECRYPT_MODE_RAW, &compression);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    cecies_reader* reader = cecies_calloc(1, sizeof(cecies_reader));
+    if (reader == NULL)
+    {
+        mbedtls_platform_zeroize(plaintext, plaintext_length);
+        cecies_free(plaintext);
+        return CECIES_DECRYPT_ERROR_CODE_OUT_OF_MEMORY;
+    }
+
+    reader->plaintext = plaintext;
+    reader->plaintext_length = plaintext_length;
+    reader->adler = 1;
+    reader->stream.zalloc = cecies_zalloc;
+    reader->stream.zfree = cecies_zfree;
+    reader->flagged = compression == CECIES_PAYLOAD_COMPRESSED;
+
+    // zlib header (2 bytes) + at least one byte of deflate data + Adler-32 trailer (4 bytes).
+    if (compression != CECIES_PAYLOAD_PLAIN && plaintext_length >= 7 && cecies_is_zlib_header(plaintext, plaintext_length) && inflateInit2(&reader->stream, -15) == Z_OK)
+    {
+        reader->compressed = 1;
+        reader->position = 2;
+    }
+    else if (reader->flagged)
+    {
+        cecies_fprintf(stderr, "CECIES: decompression failed! The payload is flagged as compressed but isn't a zlib stream.\n");
+        cecies_reader_release(reader);
+        cecies_free(reader);
+        return CECIES_DECRYPT_ERROR_CODE_DECOMPRESSION_FAILED;
+    }
+
+    *out_reader = reader;
+    return 0;
+}
+
+int cecies_curve25519_decrypt_reader(const uint8_t* encrypted_data, const size_t encrypted_data_length, const int encrypted_data_base64, cecies_curve25519_key private_key, cecies_reader** out_reader)
+{
+    return cecies_decrypt_reader(encrypted_data, encrypted_data_length, encrypted_data_base64, private_key.hexstring, out_reader, 0);
+}
+
+int cecies_curve448_decrypt_reader(const uint8_t* encrypted_data, const size_t encrypted_data_length, const int encrypted_data_base64, cecies_curve448_key private_key, cecies_reader** out_reader)
+{
+    return cecies_decrypt_reader(encrypted_data, encrypted_data_length, encrypted_data_base64, private_key.hexstring, out_reader, 1);
+}
+
+int cecies_reader_read(cecies_reader* reader, uint8_t* output, const size_t output_size, size_t* output_length)
+{
+    if (reader == NULL || output == NULL || output_length == NULL)
+    {
+        return CECIES_DECRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    *output_length = 0;
+
+    if (reader->finished)
+    {
+        return 0;
+    }
+
+    if (!reader->compressed)
+    {
+        const size_t n = CECIES_MIN(output_size, reader->plaintext_length - reader->position);
+
+        memcpy(output, reader->plaintext + reader->position, n);
+        reader->position += n;
+        *output_length = n;
+        return 0;
+    }
+
+    size_t written = 0;
+
+    while (written < output_size)
+    {
+        // The last 4 bytes are the Adler-32 trailer, not deflate data.
+        const uInt in_chunk = (uInt)CECIES_MIN(reader->plaintext_length - 4 - reader->position, (size_t)UINT32_MAX);
+        const uInt out_chunk = (uInt)CECIES_MIN(output_size - written, (size_t)UINT32_MAX);
+
+        reader->stream.next_in = reader->plaintext + reader->position;
+        reader->stream.avail_in = in_chunk;
+        reader->stream.next_out = output + written;
+        reader->stream.avail_out = out_chunk;
+
+        const int z = inflate(&reader->stream, Z_NO_FLUSH);
+
+        const size_t produced = out_chunk - reader->stream.avail_out;
+        reader->position += in_chunk - reader->stream.avail_in;
+        reader->adler = cecies_adler32(reader->adler, output + written, produced);
+        written += produced;
+
+        // Anything between the end of the deflate data and the trailer makes for an invalid stream (see below).
+        if (z == Z_STREAM_END && reader->position + 4 == reader->plaintext_length)
+        {
+            const uint8_t* trailer = reader->plaintext + reader->position;
+            const uint32_t expected_adler = ((uint32_t)trailer[0] << 24) | ((uint32_t)trailer[1] << 16) | ((uint32_t)trailer[2] << 8) | (uint32_t)trailer[3];
+
+            // Nothing is left to read: the (compressed) plaintext isn't needed anymore.
+            cecies_reader_release(reader);
+            reader->finished = 1;
+
+            if (reader->adler != expected_adler)
+            {
+                cecies_fprintf(stderr, "CECIES: decompression failed: Adler-32 mismatch.\n");
+                return CECIES_DECRYPT_ERROR_CODE_DECOMPRESSION_FAILED;
+            }
+
+            break;
+        }
+
+        if (z != Z_OK)
+        {
+            if (!reader->produced && !reader->flagged)
+            {
+                // Just like the one-shot decryption: legacy data that only happens to start with a zlib header is returned as it is.
+                inflateEnd(&reader->stream);
+                reader->compressed = 0;
+                reader->position = 0;
+                return cecies_reader_read(reader, output, output_size, output_length);
+            }
+
+            cecies_fprintf(stderr, "CECIES: decompression failed! inflate returned %d\n", z);
+            cecies_reader_release(reader);
+            reader->finished = 1;
+            return CECIES_DECRYPT_ERROR_CODE_DECOMPRESSION_FAILED;
+        }
+    }
+
+    reader->produced |= written > 0;
+    *output_length = written;
+    return 0;
+}
+
+void cecies_reader_free(cecies_reader* reader)
+{
+    if (reader == NULL)
+    {
+        return;
+    }
+
+    cecies_reader_release(reader);
+    mbedtls_platform_zeroize(reader, sizeof(cecies_reader));
+    cecies_free(reader);
+}
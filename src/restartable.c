@@ -0,0 +1,766 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <string.h>
+#include <zlib.h>
+
+#include <mbedtls/gcm.h>
+#include <mbedtls/ecp.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/platform_util.h>
+
+#include "cecies/util.h"
+#include "cecies/restartable.h"
+#include "internal.h"
+
+#include "cecies/data.txt"
+
+enum cecies_restartable_stage
+{
+    CECIES_RESTARTABLE_STAGE_SETUP = 0,
+    CECIES_RESTARTABLE_STAGE_KEYGEN = 1,
+    CECIES_RESTARTABLE_STAGE_ECDH = 2,
+    CECIES_RESTARTABLE_STAGE_KDF = 3,
+    CECIES_RESTARTABLE_STAGE_GCM = 4,
+    CECIES_RESTARTABLE_STAGE_INFLATE = 5,
+    CECIES_RESTARTABLE_STAGE_DONE = 6,
+};
+
+struct cecies_restartable
+{
+    int decrypt;
+    int curve;
+    int header_flags;
+    int stage;
+
+    /* Once a step fails, its error code sticks. */
+    int error;
+
+    size_t key_length;
+    size_t gcm_chunk_size;
+    unsigned int ecp_max_bits;
+
+    /* Encryption: the plaintext. Decryption: the parsed ciphertext. */
+    const uint8_t* data;
+    size_t data_length;
+    cecies_header header;
+
+    /* Encryption: the recipient's public key. Decryption: the private key. */
+    uint8_t key[CECIES_X448_KEY_SIZE + 1];
+
+    mbedtls_ecp_group ecp_group;
+    mbedtls_entropy_context entropy;
+    mbedtls_ctr_drbg_context ctr_drbg;
+
+    // Variables named after the ECIES illustration on https://asecuritysite.com/encryption/go_ecies
+    // d is the ephemeral private key r when encrypting and the recipient's private key dA when decrypting;
+    // Q is the recipient's public key QA when encrypting and the ephemeral public key R when decrypting.
+    // The points are u-coordinates in their (little-endian) binary form.
+    mbedtls_mpi d;
+    const uint8_t* Q;
+    uint8_t R[CECIES_X448_KEY_SIZE];
+    uint8_t S[CECIES_X448_KEY_SIZE];
+
+    /* The scalar multiplication in progress (if ladder_running): at most ecp_max_bits scalar bits are processed per step. */
+    int ladder_running;
+    union
+    {
+        cecies_x25519_ladder x25519;
+        cecies_x448_ladder x448;
+    } ladder;
+
+    cecies_encryption_setup setup;
+    mbedtls_gcm_context gcm;
+
+    uint8_t* output;
+    size_t output_length;
+
+    /* How many payload bytes went through GCM so far. */
+    size_t position;
+
+    /* Decryption of a compressed payload: the inflated output (gcm_chunk_size bytes more per step) and how much of the (compressed) output was consumed so far. */
+    int inflating;
+    z_stream stream;
+    uint32_t adler;
+    uint8_t* inflated;
+    size_t inflated_capacity;
+    size_t inflated_length;
+    size_t inflate_position;
+};
+
+static int cecies_restartable_init(cecies_restartable** out_ctx, const int decrypt, const int curve, const size_t gcm_chunk_size, const unsigned int ecp_max_bits)
+{
+    cecies_restartable* ctx = cecies_calloc(1, sizeof(cecies_restartable));
+    if (ctx == NULL)
+    {
+        return decrypt ? CECIES_DECRYPT_ERROR_CODE_OUT_OF_MEMORY : CECIES_ENCRYPT_ERROR_CODE_OUT_OF_MEMORY;
+    }
+
+    ctx->decrypt = decrypt;
+    ctx->curve = curve;
+    ctx->key_length = curve == 0 ? CECIES_X25519_KEY_SIZE : CECIES_X448_KEY_SIZE;
+    ctx->gcm_chunk_size = (gcm_chunk_size == 0 ? CECIES_RESTARTABLE_DEFAULT_GCM_CHUNK_SIZE : CECIES_MAX(gcm_chunk_size, 16)) & ~(size_t)15;
+    ctx->ecp_max_bits = ecp_max_bits;
+
+    mbedtls_ecp_group_init(&ctx->ecp_group);
+    mbedtls_entropy_init(&ctx->entropy);
+    mbedtls_ctr_drbg_init(&ctx->ctr_drbg);
+    mbedtls_mpi_init(&ctx->d);
+    mbedtls_gcm_init(&ctx->gcm);
+
+    *out_ctx = ctx;
+    return 0;
+}
+
+static int cecies_encrypt_restartable_init(cecies_restartable** out_ctx, const uint8_t* data, const size_t data_length, const char* public_key, const int header_flags, const size_t gcm_chunk_size, const unsigned int ecp_max_bits, const int curve)
+{
+    if (out_ctx == NULL || data == NULL)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    if (data_length == 0 || (header_flags & ~CECIES_HEADER_FLAGS_SUPPORTED) != 0)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    const size_t key_length = curve == 0 ? CECIES_X25519_KEY_SIZE : CECIES_X448_KEY_SIZE;
+
+    uint8_t public_key_bytes[CECIES_X448_KEY_SIZE + 1] = { 0x00 };
+    size_t public_key_bytes_length = 0;
+
+    int ret = cecies_hexstr2bin(public_key, key_length * 2, public_key_bytes, sizeof(public_key_bytes), &public_key_bytes_length);
+    if (ret != 0 || public_key_bytes_length != key_length)
+    {
+        cecies_fprintf(stderr, "CECIES: Parsing recipient's public key failed! Invalid hex string format...\n");
+        return CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    cecies_restartable* ctx = NULL;
+
+    ret = cecies_restartable_init(&ctx, 0, curve, gcm_chunk_size, ecp_max_bits);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    ctx->data = data;
+    ctx->data_length = data_length;
+    ctx->header_flags = header_flags;
+    memcpy(ctx->key, public_key_bytes, key_length);
+
+    *out_ctx = ctx;
+    return 0;
+}
+
+static int cecies_decrypt_restartable_init(cecies_restartable** out_ctx, const uint8_t* encrypted_data, const size_t encrypted_data_length, char* private_key, const size_t gcm_chunk_size, const unsigned int ecp_max_bits, const int curve)
+{
+    if (out_ctx == NULL || encrypted_data == NULL)
+    {
+        return CECIES_DECRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    const size_t key_length = curve == 0 ? CECIES_X25519_KEY_SIZE : CECIES_X448_KEY_SIZE;
+
+    cecies_header header;
+    cecies_restartable* ctx = NULL;
+
+    uint8_t private_key_bytes[CECIES_X448_KEY_SIZE + 1] = { 0x00 };
+    size_t private_key_bytes_length = 0;
+
+    int ret = cecies_parse_header(encrypted_data, encrypted_data_length, curve, &header);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    ret = cecies_hexstr2bin(private_key, key_length * 2, private_key_bytes, sizeof(private_key_bytes), &private_key_bytes_length);
+    if (ret != 0 || private_key_bytes_length != key_length)
+    {
+        cecies_fprintf(stderr, "CECIES: Parsing decryption private key failed! Invalid hex string format or invalid key length... cecies_hexstr2bin returned %d\n", ret);
+        ret = CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+        goto exit;
+    }
+
+    ret = cecies_restartable_init(&ctx, 1, curve, gcm_chunk_size, ecp_max_bits);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    ctx->data = encrypted_data;
+    ctx->data_length = encrypted_data_length;
+    ctx->header = header;
+    memcpy(ctx->key, private_key_bytes, key_length);
+
+    *out_ctx = ctx;
+
+exit:
+    mbedtls_platform_zeroize(private_key, key_length * 2);
+    mbedtls_platform_zeroize(private_key_bytes, sizeof(private_key_bytes));
+    return (ret);
+}
+
+/*
+ * X = d * u, running the Montgomery ladder over at most ctx->ecp_max_bits scalar bits per call (CECIES_RESTARTABLE_IN_PROGRESS is returned until it's done).
+ * MbedTLS can't do this: it only restarts scalar multiplications on short Weierstrass curves (and only through a process-wide operation budget).
+ */
+static int cecies_restartable_mul(cecies_restartable* ctx, uint8_t* X, const uint8_t* u)
+{
+    if (!ctx->ladder_running)
+    {
+        uint8_t scalar[CECIES_X448_KEY_SIZE];
+
+        const int ret = mbedtls_mpi_write_binary_le(&ctx->d, scalar, ctx->key_length);
+        if (ret != 0)
+        {
+            mbedtls_platform_zeroize(scalar, sizeof(scalar));
+            return ret;
+        }
+
+        if (ctx->curve == 0)
+        {
+            cecies_x25519_ladder_init(&ctx->ladder.x25519, scalar, u);
+        }
+        else
+        {
+            cecies_x448_ladder_init(&ctx->ladder.x448, scalar, u);
+        }
+
+        mbedtls_platform_zeroize(scalar, sizeof(scalar));
+        ctx->ladder_running = 1;
+    }
+
+    const int more = ctx->curve == 0 ? cecies_x25519_ladder_run(&ctx->ladder.x25519, ctx->ecp_max_bits) : cecies_x448_ladder_run(&ctx->ladder.x448, ctx->ecp_max_bits);
+    if (more)
+    {
+        return CECIES_RESTARTABLE_IN_PROGRESS;
+    }
+
+    ctx->ladder_running = 0;
+    return ctx->curve == 0 ? cecies_x25519_ladder_finish(&ctx->ladder.x25519, X) : cecies_x448_ladder_finish(&ctx->ladder.x448, X);
+}
+
+/*
+ * Checks a (binary) public key or ephemeral public key the same way as the one-shot functions do.
+ */
+static int cecies_restartable_check_point(cecies_restartable* ctx, const uint8_t* point)
+{
+    mbedtls_ecp_point Q;
+    mbedtls_ecp_point_init(&Q);
+
+    int ret = mbedtls_ecp_point_read_binary(&ctx->ecp_group, &Q, point, ctx->key_length);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Parsing %s public key failed! mbedtls_ecp_point_read_binary returned %d\n", ctx->decrypt ? "ephemeral" : "recipient's", ret);
+        goto exit;
+    }
+
+    ret = mbedtls_ecp_check_pubkey(&ctx->ecp_group, &Q);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: %s public key invalid! mbedtls_ecp_check_pubkey returned %d\n", ctx->decrypt ? "Ephemeral" : "Recipient", ret);
+    }
+
+exit:
+    mbedtls_ecp_point_free(&Q);
+    return (ret);
+}
+
+static int cecies_restartable_setup(cecies_restartable* ctx)
+{
+    int ret = cecies_seed_ctr_drbg(&ctx->ctr_drbg, &ctx->entropy);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    ret = mbedtls_ecp_group_load(&ctx->ecp_group, ctx->curve == 0 ? MBEDTLS_ECP_DP_CURVE25519 : MBEDTLS_ECP_DP_CURVE448);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: MbedTLS ECP group setup failed! mbedtls_ecp_group_load returned %d\n", ret);
+        return ret;
+    }
+
+    if (ctx->decrypt)
+    {
+        ret = mbedtls_mpi_read_binary(&ctx->d, ctx->key, ctx->key_length);
+        if (ret != 0)
+        {
+            cecies_fprintf(stderr, "CECIES: Parsing decryption private key failed! mbedtls_mpi_read_binary returned %d\n", ret);
+            return ret;
+        }
+
+        ret = mbedtls_ecp_check_privkey(&ctx->ecp_group, &ctx->d);
+        if (ret != 0)
+        {
+            cecies_fprintf(stderr, "CECIES: Invalid decryption private key! mbedtls_ecp_check_privkey returned %d\n", ret);
+            return ret;
+        }
+
+        ctx->Q = ctx->header.R;
+        return cecies_restartable_check_point(ctx, ctx->Q);
+    }
+
+    ctx->Q = ctx->key;
+
+    ret = cecies_restartable_check_point(ctx, ctx->Q);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    ret = mbedtls_ecp_gen_privkey(&ctx->ecp_group, &ctx->d, mbedtls_ctr_drbg_random, &ctx->ctr_drbg);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Ephemeral private key generation failed! mbedtls_ecp_gen_privkey returned %d\n", ret);
+    }
+
+    return (ret);
+}
+
+static int cecies_restartable_kdf(cecies_restartable* ctx)
+{
+    uint8_t key_commitment[CECIES_KEY_COMMITMENT_SIZE] = { 0x00 };
+
+    cecies_encryption_setup* setup = &ctx->setup;
+
+    const uint8_t* S_bytes = ctx->S;
+    const size_t S_bytes_length = ctx->key_length;
+
+    int ret = 1;
+
+    if (ctx->decrypt)
+    {
+        const cecies_header* header = &ctx->header;
+
+        ret = cecies_derive_keys(header->salt, S_bytes, S_bytes_length, setup->aes_key, header->key_commitment != NULL ? key_commitment : NULL);
+        if (ret != 0)
+        {
+            cecies_fprintf(stderr, "CECIES: HKDF failed! cecies_derive_keys returned %d\n", ret);
+            goto exit;
+        }
+
+        if (header->key_commitment != NULL)
+        {
+            uint8_t diff = 0;
+            for (int i = 0; i < CECIES_KEY_COMMITMENT_SIZE; ++i)
+            {
+                diff |= (uint8_t)(key_commitment[i] ^ header->key_commitment[i]);
+            }
+
+            if (diff != 0)
+            {
+                cecies_fprintf(stderr, "CECIES: decryption failed! The key commitment doesn't match: wrong private key.\n");
+                ret = CECIES_DECRYPT_ERROR_CODE_WRONG_KEY;
+                goto exit;
+            }
+        }
+
+        // Allocate at least one byte, so that an empty payload still yields a valid output buffer.
+        ctx->output_length = header->ciphertext_length;
+        ctx->output = cecies_malloc(CECIES_MAX(ctx->output_length, 1));
+        if (ctx->output == NULL)
+        {
+            ret = CECIES_DECRYPT_ERROR_CODE_OUT_OF_MEMORY;
+            goto exit;
+        }
+
+        ret = mbedtls_gcm_setkey(&ctx->gcm, MBEDTLS_CIPHER_ID_AES, setup->aes_key, 256);
+        if (ret == 0)
+        {
+            ret = cecies_gcm_starts(&ctx->gcm, MBEDTLS_GCM_DECRYPT, header->iv, header->ext, header->ext_length);
+        }
+
+        goto exit;
+    }
+
+    setup->curve = ctx->curve;
+    setup->header_flags = ctx->header_flags | (ctx->curve == 0 ? 0 : CECIES_HEADER_FLAG_CURVE448);
+    setup->ext_header_length = cecies_calc_ext_header_length(setup->header_flags);
+    setup->header_length = setup->ext_header_length + 16 + 32 + ctx->key_length + 16;
+
+    memcpy(setup->R, ctx->R, ctx->key_length);
+
+    ret = mbedtls_ctr_drbg_random(&ctx->ctr_drbg, setup->salt, 32);
+    if (ret != 0 || memcmp(setup->salt, empty32, 32) == 0)
+    {
+        cecies_fprintf(stderr, "CECIES: Salt generation failed! mbedtls_ctr_drbg_random returned %d\n", ret);
+        ret = ret != 0 ? ret : CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG;
+        goto exit;
+    }
+
+    ret = mbedtls_ctr_drbg_random(&ctx->ctr_drbg, setup->iv, 16);
+    if (ret != 0 || memcmp(setup->iv, empty32, 16) == 0)
+    {
+        cecies_fprintf(stderr, "CECIES: IV generation failed! mbedtls_ctr_drbg_random returned %d\n", ret);
+        ret = ret != 0 ? ret : CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG;
+        goto exit;
+    }
+
+    ret = cecies_derive_keys(setup->salt, S_bytes, S_bytes_length, setup->aes_key, (ctx->header_flags & CECIES_HEADER_FLAG_KEY_COMMITMENT) ? setup->key_commitment : NULL);
+    if (ret != 0 || memcmp(setup->aes_key, empty32, 32) == 0)
+    {
+        cecies_fprintf(stderr, "CECIES: HKDF failed! cecies_derive_keys returned %d\n", ret);
+        ret = ret != 0 ? ret : CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG;
+        goto exit;
+    }
+
+    if (ctx->header_flags & CECIES_HEADER_FLAG_KEY_ID)
+    {
+        cecies_calc_key_id(ctx->key, ctx->key_length, setup->key_id);
+    }
+
+    ctx->output_length = setup->header_length + ctx->data_length;
+    ctx->output = cecies_malloc(ctx->output_length);
+    if (ctx->output == NULL)
+    {
+        ret = CECIES_ENCRYPT_ERROR_CODE_OUT_OF_MEMORY;
+        goto exit;
+    }
+
+    cecies_encryption_setup_write_header(setup, ctx->output);
+
+    ret = mbedtls_gcm_setkey(&ctx->gcm, MBEDTLS_CIPHER_ID_AES, setup->aes_key, 256);
+    if (ret == 0)
+    {
+        ret = cecies_gcm_starts(&ctx->gcm, MBEDTLS_GCM_ENCRYPT, setup->iv, ctx->output, setup->ext_header_length);
+    }
+
+exit:
+    mbedtls_platform_zeroize(ctx->S, sizeof(ctx->S));
+    mbedtls_platform_zeroize(key_commitment, sizeof(key_commitment));
+    return (ret);
+}
+
+static int cecies_restartable_gcm(cecies_restartable* ctx)
+{
+    const size_t payload_length = ctx->decrypt ? ctx->header.ciphertext_length : ctx->data_length;
+    const size_t n = CECIES_MIN(ctx->gcm_chunk_size, payload_length - ctx->position);
+
+    if (n != 0)
+    {
+        const uint8_t* input = (ctx->decrypt ? ctx->header.ciphertext : ctx->data) + ctx->position;
+        uint8_t* output = ctx->output + (ctx->decrypt ? 0 : ctx->setup.header_length) + ctx->position;
+
+        const int ret = cecies_gcm_update(&ctx->gcm, input, n, output);
+        if (ret != 0)
+        {
+            cecies_fprintf(stderr, "CECIES: AES-GCM failed! mbedtls_gcm_update returned %d\n", ret);
+            return ret;
+        }
+
+        ctx->position += n;
+
+        if (ctx->position < payload_length)
+        {
+            return CECIES_RESTARTABLE_IN_PROGRESS;
+        }
+    }
+
+    if (!ctx->decrypt)
+    {
+        return cecies_gcm_finish(&ctx->gcm, ctx->output + ctx->setup.header_length - 16);
+    }
+
+    uint8_t tag[16];
+
+    int ret = cecies_gcm_finish(&ctx->gcm, tag);
+
+    // Constant-time tag comparison.
+    uint8_t diff = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        diff |= (uint8_t)(tag[i] ^ ctx->header.tag[i]);
+    }
+
+    if (ret == 0 && diff != 0)
+    {
+        ret = MBEDTLS_ERR_GCM_AUTH_FAILED;
+    }
+
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed! GCM returned %d\n", ret);
+        return ret;
+    }
+
+    const int compression = cecies_payload_compression(&ctx->header, ctx->output, ctx->output_length);
+
+    // zlib header (2 bytes) + at least one byte of deflate data + Adler-32 trailer (4 bytes): see cecies_restartable_inflate().
+    if (compression != CECIES_PAYLOAD_PLAIN && ctx->output_length >= 7 && cecies_is_zlib_header(ctx->output, ctx->output_length))
+    {
+        ctx->stream.zalloc = cecies_zalloc;
+        ctx->stream.zfree = cecies_zfree;
+        ctx->inflating = inflateInit2(&ctx->stream, -15) == Z_OK;
+        ctx->inflate_position = 2;
+        ctx->adler = 1;
+    }
+
+    if (compression == CECIES_PAYLOAD_COMPRESSED && !ctx->inflating)
+    {
+        cecies_fprintf(stderr, "CECIES: decompression failed! The payload is flagged as compressed but isn't a zlib stream.\n");
+        return CECIES_DECRYPT_ERROR_CODE_DECOMPRESSION_FAILED;
+    }
+
+    return 0;
+}
+
+/*
+ * Stops inflating: on success, the inflated output replaces the decrypted one. Otherwise the decrypted output stays (just like with cecies_decompress_if_needed(), a legacy payload may only happen to start with a zlib header).
+ */
+static void cecies_restartable_inflate_end(cecies_restartable* ctx, const int success)
+{
+    inflateEnd(&ctx->stream);
+    ctx->inflating = 0;
+
+    uint8_t** discard = success ? &ctx->output : &ctx->inflated;
+    size_t discard_length = success ? ctx->output_length : ctx->inflated_capacity;
+
+    if (*discard != NULL)
+    {
+        mbedtls_platform_zeroize(*discard, discard_length);
+        cecies_free(*discard);
+    }
+
+    if (success)
+    {
+        ctx->output = ctx->inflated;
+        ctx->output_length = ctx->inflated_length;
+    }
+
+    ctx->inflated = NULL;
+    ctx->inflated_capacity = ctx->inflated_length = 0;
+}
+
+/*
+ * Called when inflating failed: fine for legacy payloads (they keep their decrypted output), an error for ones that the extended header flags as compressed.
+ */
+static int cecies_restartable_inflate_failed(const cecies_restartable* ctx)
+{
+    if (ctx->header.ext == NULL)
+    {
+        return 0;
+    }
+
+    cecies_fprintf(stderr, "CECIES: decompression failed! The payload is flagged as compressed but doesn't inflate.\n");
+    return CECIES_DECRYPT_ERROR_CODE_DECOMPRESSION_FAILED;
+}
+
+/*
+ * Decompresses the decrypted payload, at most gcm_chunk_size bytes of output per call (CECIES_RESTARTABLE_IN_PROGRESS is returned until it's done).
+ */
+static int cecies_restartable_inflate(cecies_restartable* ctx)
+{
+    size_t budget = ctx->gcm_chunk_size;
+
+    while (budget > 0)
+    {
+        if (ctx->inflated_length == ctx->inflated_capacity)
+        {
+            // Not realloc(): the old buffer holds plaintext and needs to be wiped.
+            const size_t capacity = ctx->inflated_capacity != 0 ? ctx->inflated_capacity * 2 : CECIES_MAX(ctx->output_length * 4, 4096);
+
+            uint8_t* grown = cecies_malloc(capacity);
+            if (grown == NULL)
+            {
+                return CECIES_DECRYPT_ERROR_CODE_OUT_OF_MEMORY;
+            }
+
+            if (ctx->inflated != NULL)
+            {
+                memcpy(grown, ctx->inflated, ctx->inflated_length);
+                mbedtls_platform_zeroize(ctx->inflated, ctx->inflated_capacity);
+                cecies_free(ctx->inflated);
+            }
+
+            ctx->inflated = grown;
+            ctx->inflated_capacity = capacity;
+        }
+
+        // The last 4 bytes are the Adler-32 trailer, not deflate data.
+        const uInt in_chunk = (uInt)CECIES_MIN(ctx->output_length - 4 - ctx->inflate_position, (size_t)UINT32_MAX);
+        const uInt out_chunk = (uInt)CECIES_MIN(CECIES_MIN(ctx->inflated_capacity - ctx->inflated_length, budget), (size_t)UINT32_MAX);
+
+        uint8_t* out = ctx->inflated + ctx->inflated_length;
+
+        ctx->stream.next_in = ctx->output + ctx->inflate_position;
+        ctx->stream.avail_in = in_chunk;
+        ctx->stream.next_out = out;
+        ctx->stream.avail_out = out_chunk;
+
+        const int z = inflate(&ctx->stream, Z_NO_FLUSH);
+
+        const size_t produced = out_chunk - ctx->stream.avail_out;
+        ctx->inflate_position += in_chunk - ctx->stream.avail_in;
+        ctx->inflated_length += produced;
+        ctx->adler = cecies_adler32(ctx->adler, out, produced);
+        budget -= produced;
+
+        // Bytes left between the end of the deflate data and the trailer make for an invalid stream (see below).
+        if (z == Z_STREAM_END && ctx->inflate_position + 4 == ctx->output_length)
+        {
+            const uint8_t* trailer = ctx->output + ctx->inflate_position;
+            const uint32_t expected_adler = ((uint32_t)trailer[0] << 24) | ((uint32_t)trailer[1] << 16) | ((uint32_t)trailer[2] << 8) | (uint32_t)trailer[3];
+
+            const int success = ctx->adler == expected_adler;
+
+            cecies_restartable_inflate_end(ctx, success);
+            return success ? 0 : cecies_restartable_inflate_failed(ctx);
+        }
+
+        // Z_BUF_ERROR with output space left means that the input ended prematurely.
+        if ((z != Z_OK && z != Z_BUF_ERROR) || (z == Z_BUF_ERROR && ctx->stream.avail_out != 0))
+        {
+            cecies_restartable_inflate_end(ctx, 0);
+            return cecies_restartable_inflate_failed(ctx);
+        }
+    }
+
+    return CECIES_RESTARTABLE_IN_PROGRESS;
+}
+
+int cecies_restartable_step(cecies_restartable* ctx, uint8_t** output, size_t* output_length)
+{
+    if (ctx == NULL || output == NULL || output_length == NULL)
+    {
+        return ctx != NULL && ctx->decrypt ? CECIES_DECRYPT_ERROR_CODE_NULL_ARG : CECIES_ENCRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    if (ctx->error != 0)
+    {
+        return ctx->error;
+    }
+
+    int ret = 1;
+
+    switch (ctx->stage)
+    {
+        case CECIES_RESTARTABLE_STAGE_SETUP:
+            ret = cecies_restartable_setup(ctx);
+            break;
+        case CECIES_RESTARTABLE_STAGE_KEYGEN: {
+            // The base point's u-coordinate is 9 (Curve25519) or 5 (Curve448).
+            uint8_t G[CECIES_X448_KEY_SIZE] = { 0x00 };
+            G[0] = ctx->curve == 0 ? 9 : 5;
+
+            ret = cecies_restartable_mul(ctx, ctx->R, G);
+            break;
+        }
+        case CECIES_RESTARTABLE_STAGE_ECDH:
+            ret = cecies_restartable_mul(ctx, ctx->S, ctx->Q);
+            if (ret != 0 && ret != CECIES_RESTARTABLE_IN_PROGRESS)
+            {
+                cecies_fprintf(stderr, "CECIES: ECP scalar multiplication failed! cecies_restartable_mul returned %d\n", ret);
+            }
+            break;
+        case CECIES_RESTARTABLE_STAGE_KDF:
+            ret = cecies_restartable_kdf(ctx);
+            break;
+        case CECIES_RESTARTABLE_STAGE_GCM:
+            ret = cecies_restartable_gcm(ctx);
+            break;
+        case CECIES_RESTARTABLE_STAGE_INFLATE:
+            ret = cecies_restartable_inflate(ctx);
+            break;
+        default:
+            ret = ctx->decrypt ? CECIES_DECRYPT_ERROR_CODE_INVALID_ARG : CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG;
+            break;
+    }
+
+    if (ret == CECIES_RESTARTABLE_IN_PROGRESS)
+    {
+        return ret;
+    }
+
+    if (ret != 0)
+    {
+        if (ctx->output != NULL)
+        {
+            mbedtls_platform_zeroize(ctx->output, ctx->output_length);
+            cecies_free(ctx->output);
+            ctx->output = NULL;
+        }
+
+        ctx->error = ret;
+        return ret;
+    }
+
+    // The ephemeral key pair is generated by the key exchange itself when decrypting, and only compressed payloads need inflating.
+    ctx->stage += (ctx->stage == CECIES_RESTARTABLE_STAGE_SETUP && ctx->decrypt) || (ctx->stage == CECIES_RESTARTABLE_STAGE_GCM && !ctx->inflating) ? 2 : 1;
+
+    if (ctx->stage != CECIES_RESTARTABLE_STAGE_DONE)
+    {
+        return CECIES_RESTARTABLE_IN_PROGRESS;
+    }
+
+    *output = ctx->output;
+    *output_length = ctx->output_length;
+
+    ctx->output = NULL;
+    ctx->output_length = 0;
+
+    return 0;
+}
+
+void cecies_restartable_free(cecies_restartable* ctx)
+{
+    if (ctx == NULL)
+    {
+        return;
+    }
+
+    mbedtls_ecp_group_free(&ctx->ecp_group);
+    mbedtls_entropy_free(&ctx->entropy);
+    mbedtls_ctr_drbg_free(&ctx->ctr_drbg);
+    mbedtls_mpi_free(&ctx->d);
+    mbedtls_gcm_free(&ctx->gcm);
+
+    if (ctx->inflating)
+    {
+        cecies_restartable_inflate_end(ctx, 0);
+    }
+
+    if (ctx->output != NULL)
+    {
+        mbedtls_platform_zeroize(ctx->output, ctx->output_length);
+        cecies_free(ctx->output);
+    }
+
+    mbedtls_platform_zeroize(ctx, sizeof(cecies_restartable));
+    cecies_free(ctx);
+}
+
+int cecies_curve25519_encrypt_restartable_init(cecies_restartable** out_ctx, const uint8_t* data, const size_t data_length, cecies_curve25519_key public_key, const int header_flags, const size_t gcm_chunk_size, const unsigned int ecp_max_bits)
+{
+    return cecies_encrypt_restartable_init(out_ctx, data, data_length, public_key.hexstring, header_flags, gcm_chunk_size, ecp_max_bits, 0);
+}
+
+int cecies_curve448_encrypt_restartable_init(cecies_restartable** out_ctx, const uint8_t* data, const size_t data_length, cecies_curve448_key public_key, const int header_flags, const size_t gcm_chunk_size, const unsigned int ecp_max_bits)
+{
+    return cecies_encrypt_restartable_init(out_ctx, data, data_length, public_key.hexstring, header_flags, gcm_chunk_size, ecp_max_bits, 1);
+}
+
+int cecies_curve25519_decrypt_restartable_init(cecies_restartable** out_ctx, const uint8_t* encrypted_data, const size_t encrypted_data_length, cecies_curve25519_key private_key, const size_t gcm_chunk_size, const unsigned int ecp_max_bits)
+{
+    return cecies_decrypt_restartable_init(out_ctx, encrypted_data, encrypted_data_length, private_key.hexstring, gcm_chunk_size, ecp_max_bits, 0);
+}
+
+int cecies_curve448_decrypt_restartable_init(cecies_restartable** out_ctx, const uint8_t* encrypted_data, const size_t encrypted_data_length, cecies_curve448_key private_key, const size_t gcm_chunk_size, const unsigned int ecp_max_bits)
+{
+    return cecies_decrypt_restartable_init(out_ctx, encrypted_data, encrypted_data_length, private_key.hexstring, gcm_chunk_size, ecp_max_bits, 1);
+}
@@ -0,0 +1,342 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <string.h>
+
+#include <mbedtls/platform_util.h>
+
+#include "cecies/util.h"
+#include "internal.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define CECIES_SHA512_MULTI_X86 1
+#include <immintrin.h>
+#endif
+
+/*
+ * Multi-buffer SHA-512: the compression function of independent messages runs side by side in the 64-bit lanes of AVX2 (4 at a time) or AVX-512 (8 at a time) vectors.
+ * On top of it sits an HMAC and an HKDF (RFC 5869) that derive the keys of a whole batch of messages at once: for small messages, the dozen or so compression function calls
+ * that every message's HKDF-SHA512 costs (plus MbedTLS' message digest context setup for every single HMAC) are a visible part of the total.
+ * Without AVX2, every message's keys are derived through MbedTLS (cecies_derive_keys()) one after the other.
+ */
+
+// How many messages at most cecies_derive_keys_multi() processes per round (bounds its stack usage).
+#define CECIES_SHA512_MULTI_WINDOW 32
+
+static const uint64_t cecies_sha512_iv[8] = {
+    0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1, //
+    0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179, //
+};
+
+static const uint64_t cecies_sha512_k[80] = {
+    0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc, 0x3956c25bf348b538, 0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118, //
+    0xd807aa98a3030242, 0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2, 0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235, 0xc19bf174cf692694, //
+    0xe49b69c19ef14ad2, 0xefbe4786384f25e3, 0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65, 0x2de92c6f592b0275, 0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5, //
+    0x983e5152ee66dfab, 0xa831c66d2db43210, 0xb00327c898fb213f, 0xbf597fc7beef0ee4, 0xc6e00bf33da88fc2, 0xd5a79147930aa725, 0x06ca6351e003826f, 0x142929670a0e6e70, //
+    0x27b70a8546d22ffc, 0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed, 0x53380d139d95b3df, 0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6, 0x92722c851482353b, //
+    0xa2bfe8a14cf10364, 0xa81a664bbc423001, 0xc24b8b70d0f89791, 0xc76c51a30654be30, 0xd192e819d6ef5218, 0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8, //
+    0x19a4c116b8d2d0c8, 0x1e376c085141ab53, 0x2748774cdf8eeb99, 0x34b0bcb5e19b48a8, 0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb, 0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3, //
+    0x748f82ee5defb2fc, 0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec, 0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915, 0xc67178f2e372532b, //
+    0xca273eceea26619c, 0xd186b8c721c0c207, 0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178, 0x06f067aa72176fba, 0x0a637dc5a2c898a6, 0x113f9804bef90dae, 0x1b710b35131c471b, //
+    0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc, 0x431d67c49c100d4c, 0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec, 0x6c44198c4a475817, //
+};
+
+static inline uint64_t cecies_sha512_load_be64(const uint8_t* p)
+{
+    return ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) | ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) | ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) | ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+}
+
+#ifdef CECIES_SHA512_MULTI_X86
+
+#define CECIES_SHA512 cecies_sha512_avx2
+#define CECIES_SHA512_TARGET __attribute__((target("avx2")))
+#define CECIES_SHA512_LANES 4
+#define CECIES_SHA512_VEC __m256i
+#define CECIES_SHA512_SET1(x) _mm256_set1_epi64x((int64_t)(x))
+#define CECIES_SHA512_LOAD(p) _mm256_loadu_si256((const __m256i*)(p))
+#define CECIES_SHA512_STORE(p, x) _mm256_storeu_si256((__m256i*)(p), (x))
+#define CECIES_SHA512_ADD(a, b) _mm256_add_epi64((a), (b))
+#define CECIES_SHA512_AND(a, b) _mm256_and_si256((a), (b))
+#define CECIES_SHA512_ANDNOT(a, b) _mm256_andnot_si256((a), (b))
+#define CECIES_SHA512_OR(a, b) _mm256_or_si256((a), (b))
+#define CECIES_SHA512_XOR(a, b) _mm256_xor_si256((a), (b))
+#define CECIES_SHA512_ROR(x, n) _mm256_or_si256(_mm256_srli_epi64((x), (n)), _mm256_slli_epi64((x), 64 - (n)))
+#define CECIES_SHA512_SHR(x, n) _mm256_srli_epi64((x), (n))
+#include "sha512_multi_impl.h"
+
+#define CECIES_SHA512 cecies_sha512_avx512
+#define CECIES_SHA512_TARGET __attribute__((target("avx512f")))
+#define CECIES_SHA512_LANES 8
+#define CECIES_SHA512_VEC __m512i
+#define CECIES_SHA512_SET1(x) _mm512_set1_epi64((int64_t)(x))
+#define CECIES_SHA512_LOAD(p) _mm512_loadu_si512((const void*)(p))
+#define CECIES_SHA512_STORE(p, x) _mm512_storeu_si512((void*)(p), (x))
+#define CECIES_SHA512_ADD(a, b) _mm512_add_epi64((a), (b))
+#define CECIES_SHA512_AND(a, b) _mm512_and_si512((a), (b))
+#define CECIES_SHA512_ANDNOT(a, b) _mm512_andnot_si512((a), (b))
+#define CECIES_SHA512_OR(a, b) _mm512_or_si512((a), (b))
+#define CECIES_SHA512_XOR(a, b) _mm512_xor_si512((a), (b))
+#define CECIES_SHA512_ROR(x, n) _mm512_ror_epi64((x), (n))
+#define CECIES_SHA512_SHR(x, n) _mm512_srli_epi64((x), (n))
+#include "sha512_multi_impl.h"
+
+#endif // CECIES_SHA512_MULTI_X86
+
+size_t cecies_sha512_multi_lanes(void)
+{
+#ifdef CECIES_SHA512_MULTI_X86
+    cecies_config config;
+    cecies_get_config(&config);
+
+    if (config.multi_buffer_sha512)
+    {
+        if (__builtin_cpu_supports("avx512f"))
+        {
+            return 8;
+        }
+
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return 4;
+        }
+    }
+#endif
+    return 0;
+}
+
+/*
+ * Runs nblocks blocks of each of the count messages through the compression function (see sha512_multi_impl.h), lanes at a time.
+ * states[i] is message i's chaining value: its 8 words, in order.
+ */
+static void cecies_sha512_multi_compress(const size_t lanes, uint64_t (*states)[8], const uint8_t* const* blocks, const size_t nblocks, const size_t count)
+{
+#ifdef CECIES_SHA512_MULTI_X86
+    uint64_t state[8 * 8];
+    const uint8_t* lane_blocks[8];
+
+    for (size_t i = 0; i < count; i += lanes)
+    {
+        const size_t n = CECIES_MIN(lanes, count - i);
+
+        // Unused lanes just hash the first message again.
+        for (size_t l = 0; l < lanes; ++l)
+        {
+            const size_t m = i + (l < n ? l : 0);
+
+            lane_blocks[l] = blocks[m];
+
+            for (int k = 0; k < 8; ++k)
+            {
+                state[k * lanes + l] = states[m][k];
+            }
+        }
+
+        if (lanes == 8)
+        {
+            cecies_sha512_avx512_compress(state, lane_blocks, nblocks);
+        }
+        else
+        {
+            cecies_sha512_avx2_compress(state, lane_blocks, nblocks);
+        }
+
+        for (size_t l = 0; l < n; ++l)
+        {
+            for (int k = 0; k < 8; ++k)
+            {
+                states[i + l][k] = state[k * lanes + l];
+            }
+        }
+    }
+
+    mbedtls_platform_zeroize(state, sizeof(state));
+#else
+    (void)lanes;
+    (void)states;
+    (void)blocks;
+    (void)nblocks;
+    (void)count;
+#endif
+}
+
+static void cecies_sha512_store_digest(const uint64_t state[8], uint8_t digest[64])
+{
+    for (int i = 0; i < 64; ++i)
+    {
+        digest[i] = (uint8_t)(state[i / 8] >> (56 - 8 * (i % 8)));
+    }
+}
+
+/*
+ * Fills in the final block of a message that's 128 (the HMAC key block) + length bytes long, length < 112.
+ */
+static void cecies_sha512_pad_final_block(uint8_t block[128], const uint8_t* data, const size_t length)
+{
+    const uint64_t bits = (uint64_t)(128 + length) * 8;
+
+    memset(block, 0x00, 128);
+    memcpy(block, data, length);
+    block[length] = 0x80;
+
+    for (int i = 0; i < 8; ++i)
+    {
+        block[127 - i] = (uint8_t)(bits >> (8 * i));
+    }
+}
+
+/*
+ * The HMAC-SHA512 key schedule of count keys (all key_length <= 128 bytes long): the chaining values after hashing the inner (K ^ ipad) and the outer (K ^ opad) key block.
+ * These can then be used for as many cecies_hmac_sha512_multi_finish() calls as needed.
+ */
+static void cecies_hmac_sha512_multi_init(const size_t lanes, const uint8_t* const* keys, const size_t key_length, const size_t count, uint64_t (*inner)[8], uint64_t (*outer)[8], uint8_t (*blocks)[128])
+{
+    const uint8_t* pointers[CECIES_SHA512_MULTI_WINDOW];
+
+    for (int pad = 0; pad < 2; ++pad)
+    {
+        uint64_t(*states)[8] = pad == 0 ? inner : outer;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            memset(blocks[i], pad == 0 ? 0x36 : 0x5c, 128);
+
+            for (size_t j = 0; j < key_length; ++j)
+            {
+                blocks[i][j] ^= keys[i][j];
+            }
+
+            memcpy(states[i], cecies_sha512_iv, sizeof(cecies_sha512_iv));
+            pointers[i] = blocks[i];
+        }
+
+        cecies_sha512_multi_compress(lanes, states, pointers, 1, count);
+    }
+
+    mbedtls_platform_zeroize(blocks, count * 128);
+}
+
+/*
+ * out[i] = HMAC-SHA512(key i, data[i]), from the key schedule of cecies_hmac_sha512_multi_init() (all data_length < 112 bytes).
+ */
+static void cecies_hmac_sha512_multi_finish(const size_t lanes, const uint64_t (*inner)[8], const uint64_t (*outer)[8], const uint8_t* const* data, const size_t data_length, const size_t count, uint8_t (*out)[64], uint64_t (*states)[8], uint8_t (*blocks)[128])
+{
+    const uint8_t* pointers[CECIES_SHA512_MULTI_WINDOW] = { NULL };
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        memcpy(states[i], inner[i], sizeof(states[i]));
+        cecies_sha512_pad_final_block(blocks[i], data[i], data_length);
+        pointers[i] = blocks[i];
+    }
+
+    cecies_sha512_multi_compress(lanes, states, pointers, 1, count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        cecies_sha512_store_digest(states[i], out[i]);
+        memcpy(states[i], outer[i], sizeof(states[i]));
+        cecies_sha512_pad_final_block(blocks[i], out[i], 64);
+    }
+
+    cecies_sha512_multi_compress(lanes, states, pointers, 1, count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        cecies_sha512_store_digest(states[i], out[i]);
+    }
+
+    mbedtls_platform_zeroize(states, count * sizeof(states[0]));
+    mbedtls_platform_zeroize(blocks, count * 128);
+}
+
+void cecies_derive_keys_multi(const uint8_t* const* salts, const uint8_t* const* shared_secrets, const size_t shared_secret_length, uint8_t* const* aes_keys, uint8_t* const* key_commitments, const size_t count, int* results)
+{
+    static const uint8_t expand_aes_key[] = { 0x01 };
+    static const uint8_t expand_key_commitment[] = "CECIES key commitment\x01";
+
+    const size_t lanes = cecies_sha512_multi_lanes();
+
+    if (lanes == 0 || shared_secret_length >= 112)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            results[i] = cecies_derive_keys(salts[i], shared_secrets[i], shared_secret_length, aes_keys[i], key_commitments[i]);
+        }
+        return;
+    }
+
+    uint64_t inner[CECIES_SHA512_MULTI_WINDOW][8];
+    uint64_t outer[CECIES_SHA512_MULTI_WINDOW][8];
+    uint64_t states[CECIES_SHA512_MULTI_WINDOW][8];
+    uint8_t blocks[CECIES_SHA512_MULTI_WINDOW][128];
+    uint8_t prk[CECIES_SHA512_MULTI_WINDOW][64];
+    uint8_t okm[CECIES_SHA512_MULTI_WINDOW][64];
+
+    const uint8_t* data[CECIES_SHA512_MULTI_WINDOW];
+    const uint8_t* keys[CECIES_SHA512_MULTI_WINDOW];
+
+    for (size_t i = 0; i < count; i += CECIES_SHA512_MULTI_WINDOW)
+    {
+        const size_t n = CECIES_MIN(CECIES_SHA512_MULTI_WINDOW, count - i);
+
+        // Extract: PRK = HMAC(salt, IKM).
+        cecies_hmac_sha512_multi_init(lanes, salts + i, 32, n, inner, outer, blocks);
+        cecies_hmac_sha512_multi_finish(lanes, (const uint64_t(*)[8])inner, (const uint64_t(*)[8])outer, shared_secrets + i, shared_secret_length, n, prk, states, blocks);
+
+        // Expand (both outputs fit into the first block of output keying material): T(1) = HMAC(PRK, info | 0x01), once with empty info for the AES key and once with the key commitment label.
+        for (size_t j = 0; j < n; ++j)
+        {
+            keys[j] = prk[j];
+        }
+
+        cecies_hmac_sha512_multi_init(lanes, keys, 64, n, inner, outer, blocks);
+
+        for (size_t j = 0; j < n; ++j)
+        {
+            data[j] = expand_aes_key;
+        }
+
+        cecies_hmac_sha512_multi_finish(lanes, (const uint64_t(*)[8])inner, (const uint64_t(*)[8])outer, data, sizeof(expand_aes_key), n, okm, states, blocks);
+
+        int any_key_commitment = 0;
+
+        for (size_t j = 0; j < n; ++j)
+        {
+            memcpy(aes_keys[i + j], okm[j], 32);
+            data[j] = expand_key_commitment;
+            any_key_commitment |= key_commitments[i + j] != NULL;
+            results[i + j] = 0;
+        }
+
+        if (any_key_commitment)
+        {
+            cecies_hmac_sha512_multi_finish(lanes, (const uint64_t(*)[8])inner, (const uint64_t(*)[8])outer, data, sizeof(expand_key_commitment) - 1, n, okm, states, blocks);
+
+            for (size_t j = 0; j < n; ++j)
+            {
+                if (key_commitments[i + j] != NULL)
+                {
+                    memcpy(key_commitments[i + j], okm[j], CECIES_KEY_COMMITMENT_SIZE);
+                }
+            }
+        }
+    }
+
+    mbedtls_platform_zeroize(inner, sizeof(inner));
+    mbedtls_platform_zeroize(outer, sizeof(outer));
+    mbedtls_platform_zeroize(prk, sizeof(prk));
+    mbedtls_platform_zeroize(okm, sizeof(okm));
+}
@@ -0,0 +1,150 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/*
+ * Multi-buffer SHA-512 compression function template: this file has no include guard on purpose and is included by sha512_multi.c once per vector width.
+ * Before including it, define:
+ *
+ *   CECIES_SHA512                The function name prefix (e.g. cecies_sha512_avx2).
+ *   CECIES_SHA512_TARGET         The function attribute that enables the instruction set.
+ *   CECIES_SHA512_LANES          How many 64-bit lanes a vector has (= how many messages are hashed side by side).
+ *   CECIES_SHA512_VEC            The vector type.
+ *   CECIES_SHA512_SET1(x)        Broadcasts a 64-bit integer.
+ *   CECIES_SHA512_LOAD(p)        Loads CECIES_SHA512_LANES uint64_t values.
+ *   CECIES_SHA512_STORE(p, x)    Stores CECIES_SHA512_LANES uint64_t values.
+ *   CECIES_SHA512_ADD(a, b)      64-bit addition.
+ *   CECIES_SHA512_AND(a, b)      Bitwise and.
+ *   CECIES_SHA512_ANDNOT(a, b)   Bitwise (~a) & b.
+ *   CECIES_SHA512_OR(a, b)       Bitwise or.
+ *   CECIES_SHA512_XOR(a, b)      Bitwise xor.
+ *   CECIES_SHA512_ROR(x, n)      64-bit right rotation by an immediate.
+ *   CECIES_SHA512_SHR(x, n)      64-bit logical right shift by an immediate.
+ *
+ * Every lane runs the FIPS 180-4 compression function on a different message: word t of lane l is word t of message l.
+ * All of the above macros are undefined again at the end of this file.
+ */
+
+#define CECIES_SHA512_FN_(prefix, name) prefix##_##name
+#define CECIES_SHA512_FN_EXPAND(prefix, name) CECIES_SHA512_FN_(prefix, name)
+#define CECIES_SHA512_FN(name) CECIES_SHA512_FN_EXPAND(CECIES_SHA512, name)
+
+/*
+ * Runs nblocks 128-byte blocks of each lane's message (blocks[l] points to lane l's first one) through the compression function,
+ * starting from and updating state (laid out as [8][CECIES_SHA512_LANES]: word i of lane l is state[i * CECIES_SHA512_LANES + l]).
+ */
+CECIES_SHA512_TARGET static void CECIES_SHA512_FN(compress)(uint64_t* state, const uint8_t* const* blocks, const size_t nblocks)
+{
+    CECIES_SHA512_VEC s[8];
+    CECIES_SHA512_VEC w[16];
+
+    for (int i = 0; i < 8; ++i)
+    {
+        s[i] = CECIES_SHA512_LOAD(state + i * CECIES_SHA512_LANES);
+    }
+
+    for (size_t b = 0; b < nblocks; ++b)
+    {
+        uint64_t words[16][CECIES_SHA512_LANES];
+
+        for (int l = 0; l < CECIES_SHA512_LANES; ++l)
+        {
+            for (int t = 0; t < 16; ++t)
+            {
+                words[t][l] = cecies_sha512_load_be64(blocks[l] + b * 128 + t * 8);
+            }
+        }
+
+        for (int t = 0; t < 16; ++t)
+        {
+            w[t] = CECIES_SHA512_LOAD(words[t]);
+        }
+
+        CECIES_SHA512_VEC a = s[0], bb = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+
+        // Fully unrolled (in chunks of 16), so that the message schedule's indices into w fold away at compile time.
+        for (int r = 0; r < 80; r += 16)
+        {
+#pragma GCC unroll 16
+            for (int j = 0; j < 16; ++j)
+            {
+                const int t = r + j;
+
+                if (t >= 16)
+                {
+                    const CECIES_SHA512_VEC w2 = w[(j + 14) & 15];
+                    const CECIES_SHA512_VEC w15 = w[(j + 1) & 15];
+                    const CECIES_SHA512_VEC s0 = CECIES_SHA512_XOR(CECIES_SHA512_XOR(CECIES_SHA512_ROR(w15, 1), CECIES_SHA512_ROR(w15, 8)), CECIES_SHA512_SHR(w15, 7));
+                    const CECIES_SHA512_VEC s1 = CECIES_SHA512_XOR(CECIES_SHA512_XOR(CECIES_SHA512_ROR(w2, 19), CECIES_SHA512_ROR(w2, 61)), CECIES_SHA512_SHR(w2, 6));
+                    w[j] = CECIES_SHA512_ADD(CECIES_SHA512_ADD(w[j], s0), CECIES_SHA512_ADD(w[(j + 9) & 15], s1));
+                }
+
+                const CECIES_SHA512_VEC S1 = CECIES_SHA512_XOR(CECIES_SHA512_XOR(CECIES_SHA512_ROR(e, 14), CECIES_SHA512_ROR(e, 18)), CECIES_SHA512_ROR(e, 41));
+                const CECIES_SHA512_VEC ch = CECIES_SHA512_XOR(CECIES_SHA512_AND(e, f), CECIES_SHA512_ANDNOT(e, g));
+                const CECIES_SHA512_VEC t1 = CECIES_SHA512_ADD(CECIES_SHA512_ADD(CECIES_SHA512_ADD(h, S1), CECIES_SHA512_ADD(ch, CECIES_SHA512_SET1(cecies_sha512_k[t]))), w[j]);
+
+                const CECIES_SHA512_VEC S0 = CECIES_SHA512_XOR(CECIES_SHA512_XOR(CECIES_SHA512_ROR(a, 28), CECIES_SHA512_ROR(a, 34)), CECIES_SHA512_ROR(a, 39));
+                const CECIES_SHA512_VEC maj = CECIES_SHA512_OR(CECIES_SHA512_AND(a, bb), CECIES_SHA512_AND(c, CECIES_SHA512_OR(a, bb)));
+                const CECIES_SHA512_VEC t2 = CECIES_SHA512_ADD(S0, maj);
+
+                h = g;
+                g = f;
+                f = e;
+                e = CECIES_SHA512_ADD(d, t1);
+                d = c;
+                c = bb;
+                bb = a;
+                a = CECIES_SHA512_ADD(t1, t2);
+            }
+        }
+
+        s[0] = CECIES_SHA512_ADD(s[0], a);
+        s[1] = CECIES_SHA512_ADD(s[1], bb);
+        s[2] = CECIES_SHA512_ADD(s[2], c);
+        s[3] = CECIES_SHA512_ADD(s[3], d);
+        s[4] = CECIES_SHA512_ADD(s[4], e);
+        s[5] = CECIES_SHA512_ADD(s[5], f);
+        s[6] = CECIES_SHA512_ADD(s[6], g);
+        s[7] = CECIES_SHA512_ADD(s[7], h);
+
+        mbedtls_platform_zeroize(words, sizeof(words));
+    }
+
+    for (int i = 0; i < 8; ++i)
+    {
+        CECIES_SHA512_STORE(state + i * CECIES_SHA512_LANES, s[i]);
+    }
+
+    mbedtls_platform_zeroize(s, sizeof(s));
+    mbedtls_platform_zeroize(w, sizeof(w));
+}
+
+#undef CECIES_SHA512_FN
+#undef CECIES_SHA512_FN_EXPAND
+#undef CECIES_SHA512_FN_
+#undef CECIES_SHA512
+#undef CECIES_SHA512_TARGET
+#undef CECIES_SHA512_LANES
+#undef CECIES_SHA512_VEC
+#undef CECIES_SHA512_SET1
+#undef CECIES_SHA512_LOAD
+#undef CECIES_SHA512_STORE
+#undef CECIES_SHA512_ADD
+#undef CECIES_SHA512_AND
+#undef CECIES_SHA512_ANDNOT
+#undef CECIES_SHA512_OR
+#undef CECIES_SHA512_XOR
+#undef CECIES_SHA512_ROR
+#undef CECIES_SHA512_SHR
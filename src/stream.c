@@ -0,0 +1,656 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mbedtls/gcm.h>
+#include <mbedtls/platform_util.h>
+
+#include "cecies/util.h"
+#include "cecies/stream.h"
+#include "internal.h"
+
+#include "cecies/data.txt"
+
+/*
+ * Feeds input through GCM in whole blocks, holding back a trailing partial block in "pending" until more input arrives.
+ * Writes (pending_length + length) rounded down to a multiple of 16 bytes into output.
+ */
+static int cecies_gcm_process(mbedtls_gcm_context* gcm, uint8_t pending[16], size_t* pending_length, const uint8_t* input, size_t length, uint8_t* output, size_t* output_length)
+{
+    int ret = 0;
+    size_t written = 0;
+
+    if (*pending_length > 0)
+    {
+        const size_t n = CECIES_MIN(16 - *pending_length, length);
+        memcpy(pending + *pending_length, input, n);
+        *pending_length += n;
+        input += n;
+        length -= n;
+
+        if (*pending_length < 16)
+        {
+            *output_length = 0;
+            return 0;
+        }
+
+        ret = cecies_gcm_update(gcm, pending, 16, output);
+        if (ret != 0)
+        {
+            return ret;
+        }
+
+        *pending_length = 0;
+        written += 16;
+    }
+
+    const size_t blocks = length & ~(size_t)15;
+    if (blocks > 0)
+    {
+        ret = cecies_gcm_update(gcm, input, blocks, output + written);
+        if (ret != 0)
+        {
+            return ret;
+        }
+
+        written += blocks;
+    }
+
+    memcpy(pending, input + blocks, length - blocks);
+    *pending_length = length - blocks;
+    *output_length = written;
+    return 0;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     ENCRYPTION
+
+struct cecies_encrypt_stream
+{
+    mbedtls_gcm_context gcm;
+    size_t header_length;
+    size_t total_length;
+    uint8_t pending[16];
+    size_t pending_length;
+    int finished;
+};
+
+static int cecies_encrypt_stream_init(cecies_encrypt_stream** out_stream, const char* public_key, const int header_flags, uint8_t* header, const size_t header_size, size_t* header_length, const int curve)
+{
+    if (out_stream == NULL || header == NULL || header_length == NULL)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    int ret = 1;
+    cecies_encryption_setup setup;
+
+    cecies_encrypt_stream* stream = cecies_calloc(1, sizeof(cecies_encrypt_stream));
+    if (stream == NULL)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_OUT_OF_MEMORY;
+    }
+
+    mbedtls_gcm_init(&stream->gcm);
+
+    ret = cecies_encryption_setup_init(public_key, header_flags, curve, &setup);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    if (header_size < setup.header_length)
+    {
+        ret = CECIES_ENCRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE;
+        goto exit;
+    }
+
+    ret = mbedtls_gcm_setkey(&stream->gcm, MBEDTLS_CIPHER_ID_AES, setup.aes_key, 256);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: AES key setup failed! mbedtls_gcm_setkey returned %d\n", ret);
+        goto exit;
+    }
+
+    cecies_encryption_setup_write_header(&setup, header);
+
+    ret = cecies_gcm_starts(&stream->gcm, MBEDTLS_GCM_ENCRYPT, setup.iv, header, setup.ext_header_length);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: AES-GCM encryption failed! mbedtls_gcm_starts returned %d\n", ret);
+        goto exit;
+    }
+
+    stream->header_length = setup.header_length;
+    *header_length = setup.header_length;
+    *out_stream = stream;
+
+exit:
+
+    mbedtls_platform_zeroize(&setup, sizeof(setup));
+
+    if (ret != 0)
+    {
+        cecies_encrypt_stream_free(stream);
+    }
+
+    return (ret);
+}
+
+int cecies_curve25519_encrypt_stream_init(cecies_encrypt_stream** out_stream, cecies_curve25519_key public_key, const int header_flags, uint8_t* header, const size_t header_size, size_t* header_length)
+{
+    return cecies_encrypt_stream_init(out_stream, public_key.hexstring, header_flags, header, header_size, header_length, 0);
+}
+
+int cecies_curve448_encrypt_stream_init(cecies_encrypt_stream** out_stream, cecies_curve448_key public_key, const int header_flags, uint8_t* header, const size_t header_size, size_t* header_length)
+{
+    return cecies_encrypt_stream_init(out_stream, public_key.hexstring, header_flags, header, header_size, header_length, 1);
+}
+
+int cecies_encrypt_stream_update(cecies_encrypt_stream* stream, const uint8_t* data, const size_t data_length, uint8_t* output, const size_t output_size, size_t* output_length)
+{
+    if (stream == NULL || (data == NULL && data_length != 0) || output == NULL || output_length == NULL)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    if (stream->finished)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    if (output_size < ((stream->pending_length + data_length) & ~(size_t)15))
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE;
+    }
+
+    const int ret = cecies_gcm_process(&stream->gcm, stream->pending, &stream->pending_length, data, data_length, output, output_length);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: AES-GCM encryption failed! mbedtls_gcm_update returned %d\n", ret);
+        return ret;
+    }
+
+    stream->total_length += data_length;
+    return 0;
+}
+
+static int cecies_encrypt_stream_final(cecies_encrypt_stream* stream, uint8_t* output, const size_t output_size, size_t* output_length, uint8_t tag[16])
+{
+    if (stream->finished || stream->total_length == 0)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    if (output_size < stream->pending_length)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE;
+    }
+
+    int ret = 0;
+
+    if (stream->pending_length > 0)
+    {
+        ret = cecies_gcm_update(&stream->gcm, stream->pending, stream->pending_length, output);
+        if (ret != 0)
+        {
+            cecies_fprintf(stderr, "CECIES: AES-GCM encryption failed! mbedtls_gcm_update returned %d\n", ret);
+            return ret;
+        }
+    }
+
+    ret = cecies_gcm_finish(&stream->gcm, tag);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: AES-GCM encryption failed! mbedtls_gcm_finish returned %d\n", ret);
+        return ret;
+    }
+
+    *output_length = stream->pending_length;
+
+    mbedtls_platform_zeroize(stream->pending, sizeof(stream->pending));
+    stream->pending_length = 0;
+    stream->finished = 1;
+    return 0;
+}
+
+int cecies_encrypt_stream_finish(cecies_encrypt_stream* stream, uint8_t* output, const size_t output_size, size_t* output_length, uint8_t* header)
+{
+    if (stream == NULL || output == NULL || output_length == NULL || header == NULL)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    return cecies_encrypt_stream_final(stream, output, output_size, output_length, header + stream->header_length - 16);
+}
+
+int cecies_encrypt_stream_finish_file(cecies_encrypt_stream* stream, FILE* file, const long header_position)
+{
+    if (stream == NULL || file == NULL)
+    {
+        return CECIES_ENCRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    uint8_t tag[16];
+    uint8_t output[16];
+    size_t output_length = 0;
+
+    int ret = cecies_encrypt_stream_final(stream, output, sizeof(output), &output_length, tag);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    if (fwrite(output, 1, output_length, file) != output_length)
+    {
+        ret = CECIES_ENCRYPT_ERROR_CODE_FILE_ACCESS_FAILED;
+        goto exit;
+    }
+
+    const long end_position = ftell(file);
+
+    if (end_position < 0                                                                    //
+        || fseek(file, header_position + (long)stream->header_length - 16, SEEK_SET) != 0 //
+        || fwrite(tag, 1, 16, file) != 16                                                   //
+        || fseek(file, end_position, SEEK_SET) != 0)
+    {
+        ret = CECIES_ENCRYPT_ERROR_CODE_FILE_ACCESS_FAILED;
+        goto exit;
+    }
+
+exit:
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: incremental encryption failed: couldn't write the remaining ciphertext and tag into the output file!\n");
+    }
+
+    mbedtls_platform_zeroize(output, sizeof(output));
+    return (ret);
+}
+
+void cecies_encrypt_stream_free(cecies_encrypt_stream* stream)
+{
+    if (stream == NULL)
+    {
+        return;
+    }
+
+    mbedtls_gcm_free(&stream->gcm);
+    mbedtls_platform_zeroize(stream, sizeof(cecies_encrypt_stream));
+    cecies_free(stream);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     DECRYPTION
+
+struct cecies_decrypt_stream
+{
+    int curve;
+    uint8_t private_key[CECIES_X448_KEY_SIZE];
+
+    /* The ciphertext header (plus the first payload byte) is collected here until it's complete. */
+    uint8_t header_buffer[CECIES_MAX_HEADER_SIZE + 1];
+    size_t header_buffer_length;
+    cecies_header header;
+    int header_complete;
+
+    mbedtls_gcm_context gcm;
+    uint8_t pending[16];
+    size_t pending_length;
+
+    /* Decrypted, but not yet authenticated plaintext. */
+    uint8_t* plaintext;
+    size_t plaintext_length;
+    size_t plaintext_capacity;
+
+    /* Total ciphertext length announced via cecies_decrypt_stream_set_length_hint() (0 if unknown). */
+    size_t length_hint;
+
+    int finished;
+};
+
+static int cecies_decrypt_stream_init(cecies_decrypt_stream** out_stream, char* private_key, const int curve)
+{
+    const size_t key_length = curve == 0 ? CECIES_X25519_KEY_SIZE : CECIES_X448_KEY_SIZE;
+
+    if (out_stream == NULL || private_key == NULL)
+    {
+        return CECIES_DECRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    int ret = 1;
+
+    uint8_t private_key_bytes[64] = { 0x00 };
+    size_t private_key_bytes_length = 0;
+
+    ret = cecies_hexstr2bin(private_key, key_length * 2, private_key_bytes, sizeof(private_key_bytes), &private_key_bytes_length);
+    if (ret != 0 || private_key_bytes_length != key_length)
+    {
+        cecies_fprintf(stderr, "CECIES: Parsing decryption private key failed! Invalid hex string format or invalid key length... cecies_hexstr2bin returned %d\n", ret);
+        ret = CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+        goto exit;
+    }
+
+    cecies_decrypt_stream* stream = cecies_calloc(1, sizeof(cecies_decrypt_stream));
+    if (stream == NULL)
+    {
+        ret = CECIES_DECRYPT_ERROR_CODE_OUT_OF_MEMORY;
+        goto exit;
+    }
+
+    mbedtls_gcm_init(&stream->gcm);
+    memcpy(stream->private_key, private_key_bytes, key_length);
+    stream->curve = curve;
+
+    *out_stream = stream;
+    ret = 0;
+
+exit:
+
+    mbedtls_platform_zeroize(private_key, key_length * 2);
+    mbedtls_platform_zeroize(private_key_bytes, sizeof(private_key_bytes));
+
+    return (ret);
+}
+
+int cecies_curve25519_decrypt_stream_init(cecies_decrypt_stream** out_stream, cecies_curve25519_key private_key)
+{
+    return cecies_decrypt_stream_init(out_stream, private_key.hexstring, 0);
+}
+
+int cecies_curve448_decrypt_stream_init(cecies_decrypt_stream** out_stream, cecies_curve448_key private_key)
+{
+    return cecies_decrypt_stream_init(out_stream, private_key.hexstring, 1);
+}
+
+/*
+ * How many bytes of the ciphertext need to be collected before the header can be parsed (the whole header plus the first payload byte).
+ */
+static size_t cecies_decrypt_stream_header_needed(const cecies_decrypt_stream* stream)
+{
+    const size_t key_length = stream->curve == 0 ? CECIES_X25519_KEY_SIZE : CECIES_X448_KEY_SIZE;
+
+    if (stream->header_buffer_length < CECIES_EXT_HEADER_MAGIC_SIZE + 1)
+    {
+        return CECIES_EXT_HEADER_MAGIC_SIZE + 1;
+    }
+
+    size_t ext_length = 0;
+
+    if (memcmp(stream->header_buffer, cecies_ext_header_magic, CECIES_EXT_HEADER_MAGIC_SIZE) == 0)
+    {
+        ext_length = cecies_calc_ext_header_length(stream->header_buffer[CECIES_EXT_HEADER_MAGIC_SIZE] & CECIES_HEADER_FLAGS_KNOWN);
+    }
+
+    return ext_length + 16 + 32 + key_length + 16 + 1;
+}
+
+static int cecies_decrypt_stream_reserve(cecies_decrypt_stream* stream, const size_t length)
+{
+    const size_t needed = stream->plaintext_length + length;
+
+    if (needed <= stream->plaintext_capacity)
+    {
+        return 0;
+    }
+
+    // The payload is whatever comes after the header: with a length hint, it fits into one exactly sized buffer.
+    const size_t header_length = (size_t)(stream->header.ciphertext - stream->header_buffer);
+    const size_t payload_length_hint = stream->length_hint > header_length ? stream->length_hint - header_length : 0;
+
+    size_t capacity = stream->plaintext_capacity ? stream->plaintext_capacity : 4096;
+    while (capacity < needed)
+    {
+        capacity *= 2;
+    }
+
+    if (payload_length_hint >= needed)
+    {
+        capacity = payload_length_hint;
+    }
+
+    uint8_t* plaintext = cecies_malloc(capacity);
+    if (plaintext == NULL)
+    {
+        return CECIES_DECRYPT_ERROR_CODE_OUT_OF_MEMORY;
+    }
+
+    // Not realloc(): the old buffer holds plaintext and needs to be wiped.
+    if (stream->plaintext != NULL)
+    {
+        memcpy(plaintext, stream->plaintext, stream->plaintext_length);
+        mbedtls_platform_zeroize(stream->plaintext, stream->plaintext_capacity);
+        cecies_free(stream->plaintext);
+    }
+
+    stream->plaintext = plaintext;
+    stream->plaintext_capacity = capacity;
+    return 0;
+}
+
+static int cecies_decrypt_stream_payload(cecies_decrypt_stream* stream, const uint8_t* data, const size_t data_length)
+{
+    // GCM never outputs more than what's pending plus the new data (so the buffer ends up exactly as long as the payload).
+    int ret = cecies_decrypt_stream_reserve(stream, stream->pending_length + data_length);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    size_t written = 0;
+
+    ret = cecies_gcm_process(&stream->gcm, stream->pending, &stream->pending_length, data, data_length, stream->plaintext + stream->plaintext_length, &written);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed! mbedtls_gcm_update returned %d\n", ret);
+        return ret;
+    }
+
+    stream->plaintext_length += written;
+    return 0;
+}
+
+static int cecies_decrypt_stream_start(cecies_decrypt_stream* stream)
+{
+    uint8_t aes_key[32] = { 0x00 };
+
+    int ret = cecies_parse_header(stream->header_buffer, stream->header_buffer_length, stream->curve, &stream->header);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    ret = cecies_derive_header_key(&stream->header, stream->private_key, stream->curve, aes_key);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    ret = mbedtls_gcm_setkey(&stream->gcm, MBEDTLS_CIPHER_ID_AES, aes_key, 256);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: AES key setup failed! mbedtls_gcm_setkey returned %d\n", ret);
+        goto exit;
+    }
+
+    ret = cecies_gcm_starts(&stream->gcm, MBEDTLS_GCM_DECRYPT, stream->header.iv, stream->header.ext, stream->header.ext_length);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed! mbedtls_gcm_starts returned %d\n", ret);
+        goto exit;
+    }
+
+    stream->header_complete = 1;
+
+    // The first payload byte was collected along with the header.
+    ret = cecies_decrypt_stream_payload(stream, stream->header.ciphertext, stream->header.ciphertext_length);
+
+exit:
+    mbedtls_platform_zeroize(aes_key, sizeof(aes_key));
+    mbedtls_platform_zeroize(stream->private_key, sizeof(stream->private_key));
+    return (ret);
+}
+
+int cecies_decrypt_stream_set_length_hint(cecies_decrypt_stream* stream, const size_t encrypted_data_length)
+{
+    if (stream == NULL)
+    {
+        return CECIES_DECRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    if (stream->finished || stream->plaintext != NULL)
+    {
+        return CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    stream->length_hint = encrypted_data_length;
+    return 0;
+}
+
+int cecies_decrypt_stream_update(cecies_decrypt_stream* stream, const uint8_t* encrypted_data, size_t encrypted_data_length)
+{
+    if (stream == NULL || (encrypted_data == NULL && encrypted_data_length != 0))
+    {
+        return CECIES_DECRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    if (stream->finished)
+    {
+        return CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    while (!stream->header_complete && encrypted_data_length > 0)
+    {
+        const size_t needed = cecies_decrypt_stream_header_needed(stream);
+        const size_t n = CECIES_MIN(needed - stream->header_buffer_length, encrypted_data_length);
+
+        memcpy(stream->header_buffer + stream->header_buffer_length, encrypted_data, n);
+        stream->header_buffer_length += n;
+        encrypted_data += n;
+        encrypted_data_length -= n;
+
+        if (stream->header_buffer_length == needed && needed == cecies_decrypt_stream_header_needed(stream))
+        {
+            const int ret = cecies_decrypt_stream_start(stream);
+            if (ret != 0)
+            {
+                stream->finished = 1;
+                return ret;
+            }
+        }
+    }
+
+    if (encrypted_data_length == 0)
+    {
+        return 0;
+    }
+
+    const int ret = cecies_decrypt_stream_payload(stream, encrypted_data, encrypted_data_length);
+    if (ret != 0)
+    {
+        stream->finished = 1;
+    }
+
+    return (ret);
+}
+
+int cecies_decrypt_stream_finish(cecies_decrypt_stream* stream, uint8_t** output, size_t* output_length)
+{
+    if (stream == NULL || output == NULL || output_length == NULL)
+    {
+        return CECIES_DECRYPT_ERROR_CODE_NULL_ARG;
+    }
+
+    if (stream->finished || !stream->header_complete)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed: ciphertext too short.\n");
+        return CECIES_DECRYPT_ERROR_CODE_INVALID_ARG;
+    }
+
+    stream->finished = 1;
+
+    int ret = 0;
+    uint8_t tag[16] = { 0x00 };
+
+    if (stream->pending_length > 0)
+    {
+        ret = cecies_gcm_update(&stream->gcm, stream->pending, stream->pending_length, stream->plaintext + stream->plaintext_length);
+        if (ret != 0)
+        {
+            cecies_fprintf(stderr, "CECIES: decryption failed! mbedtls_gcm_update returned %d\n", ret);
+            return ret;
+        }
+
+        stream->plaintext_length += stream->pending_length;
+        stream->pending_length = 0;
+    }
+
+    ret = cecies_gcm_finish(&stream->gcm, tag);
+    if (ret != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed! mbedtls_gcm_finish returned %d\n", ret);
+        return ret;
+    }
+
+    uint8_t diff = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        diff |= (uint8_t)(tag[i] ^ stream->header.tag[i]);
+    }
+
+    if (diff != 0)
+    {
+        cecies_fprintf(stderr, "CECIES: decryption failed! The GCM authentication tag doesn't match.\n");
+        return CECIES_DECRYPT_ERROR_CODE_VERIFICATION_FAILED;
+    }
+
+    uint8_t* plaintext = stream->plaintext;
+    size_t plaintext_length = stream->plaintext_length;
+
+    stream->plaintext = NULL;
+    stream->plaintext_length = stream->plaintext_capacity = 0;
+
+    ret = cecies_decompress_if_needed(&stream->header, &plaintext, &plaintext_length);
+    if (ret != 0)
+    {
+        mbedtls_platform_zeroize(plaintext, plaintext_length);
+        cecies_free(plaintext);
+        return ret;
+    }
+
+    *output = plaintext;
+    *output_length = plaintext_length;
+    return 0;
+}
+
+void cecies_decrypt_stream_free(cecies_decrypt_stream* stream)
+{
+    if (stream == NULL)
+    {
+        return;
+    }
+
+    if (stream->plaintext != NULL)
+    {
+        mbedtls_platform_zeroize(stream->plaintext, stream->plaintext_capacity);
+        cecies_free(stream->plaintext);
+    }
+
+    mbedtls_gcm_free(&stream->gcm);
+    mbedtls_platform_zeroize(stream, sizeof(cecies_decrypt_stream));
+    cecies_free(stream);
+}
@@ -0,0 +1,184 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <stdlib.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "cecies/util.h"
+#include "internal.h"
+
+typedef struct cecies_thread_start
+{
+    void (*func)(void*);
+    void* arg;
+} cecies_thread_start;
+
+#ifdef _WIN32
+
+static DWORD WINAPI cecies_thread_main(LPVOID param)
+{
+    cecies_thread_start start = *(cecies_thread_start*)param;
+    cecies_free(param);
+    start.func(start.arg);
+    return 0;
+}
+
+#else
+
+static void* cecies_thread_main(void* param)
+{
+    cecies_thread_start start = *(cecies_thread_start*)param;
+    cecies_free(param);
+    start.func(start.arg);
+    return NULL;
+}
+
+#endif
+
+int cecies_thread_create(cecies_thread* thread, void (*func)(void*), void* arg)
+{
+    cecies_thread_start* start = cecies_malloc(sizeof(cecies_thread_start));
+    if (start == NULL)
+    {
+        return 1;
+    }
+
+    start->func = func;
+    start->arg = arg;
+
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, cecies_thread_main, start, 0, NULL);
+    if (*thread == NULL)
+    {
+        cecies_free(start);
+        return 1;
+    }
+#else
+    if (pthread_create(thread, NULL, cecies_thread_main, start) != 0)
+    {
+        cecies_free(start);
+        return 1;
+    }
+#endif
+
+    return 0;
+}
+
+void cecies_thread_join(cecies_thread thread)
+{
+#ifdef _WIN32
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
+
+void cecies_mutex_init(cecies_mutex* mutex)
+{
+#ifdef _WIN32
+    InitializeCriticalSection(mutex);
+#else
+    pthread_mutex_init(mutex, NULL);
+#endif
+}
+
+void cecies_mutex_lock(cecies_mutex* mutex)
+{
+#ifdef _WIN32
+    EnterCriticalSection(mutex);
+#else
+    pthread_mutex_lock(mutex);
+#endif
+}
+
+void cecies_mutex_unlock(cecies_mutex* mutex)
+{
+#ifdef _WIN32
+    LeaveCriticalSection(mutex);
+#else
+    pthread_mutex_unlock(mutex);
+#endif
+}
+
+void cecies_mutex_free(cecies_mutex* mutex)
+{
+#ifdef _WIN32
+    DeleteCriticalSection(mutex);
+#else
+    pthread_mutex_destroy(mutex);
+#endif
+}
+
+void cecies_cond_init(cecies_cond* cond)
+{
+#ifdef _WIN32
+    InitializeConditionVariable(cond);
+#else
+    pthread_cond_init(cond, NULL);
+#endif
+}
+
+void cecies_cond_wait(cecies_cond* cond, cecies_mutex* mutex)
+{
+#ifdef _WIN32
+    SleepConditionVariableCS(cond, mutex, INFINITE);
+#else
+    pthread_cond_wait(cond, mutex);
+#endif
+}
+
+void cecies_cond_signal(cecies_cond* cond)
+{
+#ifdef _WIN32
+    WakeConditionVariable(cond);
+#else
+    pthread_cond_signal(cond);
+#endif
+}
+
+void cecies_cond_broadcast(cecies_cond* cond)
+{
+#ifdef _WIN32
+    WakeAllConditionVariable(cond);
+#else
+    pthread_cond_broadcast(cond);
+#endif
+}
+
+void cecies_cond_free(cecies_cond* cond)
+{
+#ifdef _WIN32
+    (void)cond; // Win32 condition variables don't need to be deleted.
+#else
+    pthread_cond_destroy(cond);
+#endif
+}
+
+size_t cecies_get_cpu_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    return system_info.dwNumberOfProcessors > 0 ? (size_t)system_info.dwNumberOfProcessors : 1;
+#else
+    const long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (size_t)n : 1;
+#endif
+}
@@ -14,7 +14,12 @@
    limitations under the License.
 */
 
-#include "cecies/util.h"
+#include <string.h>
+
+#include <mbedtls/md.h>
+#include <mbedtls/hkdf.h>
+#include <mbedtls/sha512.h>
+#include <mbedtls/platform_util.h>
 
 #ifdef _WIN32
 #define WIN32_NO_STATUS
@@ -23,6 +28,9 @@
 #include <bcrypt.h>
 #endif
 
+#include "cecies/util.h"
+#include "internal.h"
+
 static int cecies_fprintf_enabled = 1;
 
 int cecies_is_fprintf_enabled()
@@ -128,6 +136,47 @@ void cecies_dev_urandom(uint8_t* output_buffer, const size_t output_buffer_size)
     }
 }
 
+void cecies_calc_key_id(const uint8_t* public_key, const size_t public_key_length, uint8_t key_id[CECIES_KEY_ID_SIZE])
+{
+    uint8_t hash[64];
+    mbedtls_sha512(public_key, public_key_length, hash, 0);
+    memcpy(key_id, hash, CECIES_KEY_ID_SIZE);
+    mbedtls_platform_zeroize(hash, sizeof(hash));
+}
+
+int cecies_derive_keys(const uint8_t* salt, const uint8_t* shared_secret, const size_t shared_secret_length, uint8_t aes_key[32], uint8_t* key_commitment)
+{
+    static const unsigned char key_commitment_info[] = "CECIES key commitment";
+
+    const mbedtls_md_info_t* md_info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA512);
+
+    if (key_commitment == NULL)
+    {
+        return mbedtls_hkdf(md_info, salt, 32, shared_secret, shared_secret_length, NULL, 0, aes_key, 32);
+    }
+
+    // Extract once, expand twice: the AES key is exactly the same as the one-shot HKDF above would give.
+    uint8_t prk[64];
+
+    int ret = mbedtls_hkdf_extract(md_info, salt, 32, shared_secret, shared_secret_length, prk);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    ret = mbedtls_hkdf_expand(md_info, prk, sizeof(prk), NULL, 0, aes_key, 32);
+    if (ret != 0)
+    {
+        goto exit;
+    }
+
+    ret = mbedtls_hkdf_expand(md_info, prk, sizeof(prk), key_commitment_info, sizeof(key_commitment_info) - 1, key_commitment, CECIES_KEY_COMMITMENT_SIZE);
+
+exit:
+    mbedtls_platform_zeroize(prk, sizeof(prk));
+    return (ret);
+}
+
 char* cecies_get_version_str()
 {
     return CECIES_VERSION_STR;
@@ -136,9 +185,4 @@ char* cecies_get_version_str()
 uint64_t cecies_get_version_nr()
 {
     return CECIES_VERSION;
-}
-
-void cecies_free(void* mem)
-{
-    free(mem);
 }
\ No newline at end of file
@@ -0,0 +1,409 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <string.h>
+
+#include <mbedtls/ecp.h>
+#include <mbedtls/platform_util.h>
+
+#include "cecies/util.h"
+#include "internal.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define CECIES_X25519_X86 1
+#include <immintrin.h>
+#endif
+
+/*
+ * Multi-lane X25519: independent scalar multiplications run side by side in the 64-bit lanes of AVX2 (4 at a time) or AVX-512 (8 at a time) vectors.
+ * A single X25519 through MbedTLS' generic bignum code is what dominates every en-/decryption of a small message; when a batch of messages is at hand,
+ * their key agreements (and ephemeral key generation) go through here instead. Without AVX2, they keep going through mbedtls_ecp_mul() one after the other.
+ */
+
+// How many pairs at most share one inversion in cecies_x25519_multi() (a multiple of both vector widths).
+#define CECIES_X25519_WINDOW 64
+
+// Bit offsets of the 10 limbs (alternately 26 and 25 bits wide) of a field element.
+static const int cecies_x25519_limb_offsets[10] = { 0, 26, 51, 77, 102, 128, 153, 179, 204, 230 };
+
+static inline int cecies_x25519_limb_width(const int i)
+{
+    return (i & 1) ? 25 : 26;
+}
+
+/*
+ * Reads a u-coordinate (RFC 7748: little-endian, top bit ignored, values >= p are fine) into limbs.
+ */
+static void cecies_x25519_fe_frombytes(const uint8_t s[32], int64_t h[10])
+{
+    uint8_t b[40] = { 0x00 };
+    memcpy(b, s, 32);
+    b[31] &= 0x7f;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        const int offset = cecies_x25519_limb_offsets[i];
+
+        uint64_t w = 0;
+        for (int k = 7; k >= 0; --k)
+        {
+            w = (w << 8) | b[offset / 8 + k];
+        }
+
+        h[i] = (int64_t)((w >> (offset % 8)) & (((uint64_t)1 << cecies_x25519_limb_width(i)) - 1));
+    }
+
+    mbedtls_platform_zeroize(b, sizeof(b));
+}
+
+/*
+ * Writes carried limbs out as the canonical (fully reduced mod p) little-endian encoding.
+ */
+static void cecies_x25519_fe_tobytes(uint8_t s[32], int64_t h[10])
+{
+    // q = 1 if h >= p (0 otherwise): then h - q * p is the canonical value, computed as h + 19q with the top carry dropped.
+    int64_t q = (19 * h[9] + ((int64_t)1 << 24)) >> 25;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        q = (h[i] + q) >> cecies_x25519_limb_width(i);
+    }
+
+    h[0] += 19 * q;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        const int width = cecies_x25519_limb_width(i);
+        const int64_t carry = h[i] >> width;
+
+        h[i] -= carry * ((int64_t)1 << width);
+
+        if (i < 9)
+        {
+            h[i + 1] += carry;
+        }
+    }
+
+    uint8_t b[40] = { 0x00 };
+
+    for (int i = 0; i < 10; ++i)
+    {
+        const int offset = cecies_x25519_limb_offsets[i];
+        const uint64_t v = (uint64_t)h[i] << (offset % 8);
+
+        for (int k = 0; k < 5; ++k)
+        {
+            b[offset / 8 + k] |= (uint8_t)(v >> (8 * k));
+        }
+    }
+
+    memcpy(s, b, 32);
+    mbedtls_platform_zeroize(b, sizeof(b));
+}
+
+#ifdef CECIES_X25519_X86
+
+#define CECIES_X25519 cecies_x25519_avx2
+#define CECIES_X25519_TARGET __attribute__((target("avx2")))
+#define CECIES_X25519_LANES 4
+#define CECIES_X25519_VEC __m256i
+#define CECIES_X25519_ZERO() _mm256_setzero_si256()
+#define CECIES_X25519_SET1(x) _mm256_set1_epi64x((int64_t)(x))
+#define CECIES_X25519_LOAD(p) _mm256_loadu_si256((const __m256i*)(p))
+#define CECIES_X25519_STORE(p, x) _mm256_storeu_si256((__m256i*)(p), (x))
+#define CECIES_X25519_ADD(a, b) _mm256_add_epi64((a), (b))
+#define CECIES_X25519_SUB(a, b) _mm256_sub_epi64((a), (b))
+#define CECIES_X25519_MUL(a, b) _mm256_mul_epi32((a), (b))
+#define CECIES_X25519_SLLI(x, n) _mm256_slli_epi64((x), (n))
+// AVX2 has no 64-bit arithmetic shift: bias into the positive range, shift logically and take the bias back out.
+#define CECIES_X25519_SRAI(x, n) _mm256_sub_epi64(_mm256_srli_epi64(_mm256_add_epi64((x), _mm256_set1_epi64x((int64_t)1 << 62)), (n)), _mm256_set1_epi64x(((int64_t)1 << 62) >> (n)))
+#define CECIES_X25519_AND(a, b) _mm256_and_si256((a), (b))
+#define CECIES_X25519_XOR(a, b) _mm256_xor_si256((a), (b))
+#include "x25519_impl.h"
+
+#define CECIES_X25519 cecies_x25519_avx512
+#define CECIES_X25519_TARGET __attribute__((target("avx512f")))
+#define CECIES_X25519_LANES 8
+#define CECIES_X25519_VEC __m512i
+#define CECIES_X25519_ZERO() _mm512_setzero_si512()
+#define CECIES_X25519_SET1(x) _mm512_set1_epi64((int64_t)(x))
+#define CECIES_X25519_LOAD(p) _mm512_loadu_si512((const void*)(p))
+#define CECIES_X25519_STORE(p, x) _mm512_storeu_si512((void*)(p), (x))
+#define CECIES_X25519_ADD(a, b) _mm512_add_epi64((a), (b))
+#define CECIES_X25519_SUB(a, b) _mm512_sub_epi64((a), (b))
+#define CECIES_X25519_MUL(a, b) _mm512_mul_epi32((a), (b))
+#define CECIES_X25519_SLLI(x, n) _mm512_slli_epi64((x), (n))
+#define CECIES_X25519_SRAI(x, n) _mm512_srai_epi64((x), (n))
+#define CECIES_X25519_AND(a, b) _mm512_and_si512((a), (b))
+#define CECIES_X25519_XOR(a, b) _mm512_xor_si512((a), (b))
+#include "x25519_impl.h"
+
+#endif // CECIES_X25519_X86
+
+// One lane in a plain int64_t: the portable instance behind the resumable ladder (cecies_x25519_ladder_run()), which runs on any target.
+#define CECIES_X25519 cecies_x25519_portable
+#define CECIES_X25519_TARGET
+#define CECIES_X25519_LANES 1
+#define CECIES_X25519_VEC int64_t
+#define CECIES_X25519_ZERO() ((int64_t)0)
+#define CECIES_X25519_SET1(x) ((int64_t)(x))
+#define CECIES_X25519_LOAD(p) (*(const int64_t*)(p))
+#define CECIES_X25519_STORE(p, x) (*(int64_t*)(p) = (x))
+#define CECIES_X25519_ADD(a, b) ((a) + (b))
+#define CECIES_X25519_SUB(a, b) ((a) - (b))
+#define CECIES_X25519_MUL(a, b) ((int64_t)(int32_t)(a) * (int32_t)(b))
+// Shifts go through uint64_t (and a bias, like the AVX2 variant), so that negative limbs don't run into undefined or implementation-defined behaviour.
+#define CECIES_X25519_SLLI(x, n) ((int64_t)((uint64_t)(x) << (n)))
+#define CECIES_X25519_SRAI(x, n) ((int64_t)(((uint64_t)(x) + ((uint64_t)1 << 62)) >> (n)) - (((int64_t)1 << 62) >> (n)))
+#define CECIES_X25519_AND(a, b) ((a) & (b))
+#define CECIES_X25519_XOR(a, b) ((a) ^ (b))
+#include "x25519_impl.h"
+
+_Static_assert(sizeof(cecies_x25519_portable_ladder_state) == sizeof(((cecies_x25519_ladder*)0)->state), "cecies_x25519_ladder::state must hold the portable ladder state.");
+
+void cecies_x25519_ladder_init(cecies_x25519_ladder* ladder, const uint8_t scalar[32], const uint8_t u[32])
+{
+    int64_t h[10];
+    cecies_x25519_portable_ladder_state state;
+
+    memcpy(ladder->scalar, scalar, 32);
+    ladder->scalar[0] &= 248;
+    ladder->scalar[31] &= 127;
+    ladder->scalar[31] |= 64;
+    ladder->bit = 254;
+
+    cecies_x25519_fe_frombytes(u, h);
+    cecies_x25519_portable_ladder_start(&state, h);
+    memcpy(&ladder->state, &state, sizeof(ladder->state));
+
+    mbedtls_platform_zeroize(h, sizeof(h));
+    mbedtls_platform_zeroize(&state, sizeof(state));
+}
+
+int cecies_x25519_ladder_run(cecies_x25519_ladder* ladder, const size_t max_bits)
+{
+    if (ladder->bit < 0)
+    {
+        return 0;
+    }
+
+    cecies_x25519_portable_ladder_state state;
+    memcpy(&state, &ladder->state, sizeof(state));
+
+    const int to = max_bits == 0 || max_bits > (size_t)ladder->bit ? 0 : ladder->bit + 1 - (int)max_bits;
+
+    cecies_x25519_portable_ladder_bits(&state, (const uint8_t(*)[32])ladder->scalar, ladder->bit, to);
+    ladder->bit = to - 1;
+
+    memcpy(&ladder->state, &state, sizeof(ladder->state));
+    mbedtls_platform_zeroize(&state, sizeof(state));
+
+    return ladder->bit >= 0;
+}
+
+int cecies_x25519_ladder_finish(cecies_x25519_ladder* ladder, uint8_t out[32])
+{
+    int64_t x[10];
+    int64_t z[10];
+    cecies_x25519_portable_fe f, g;
+    cecies_x25519_portable_ladder_state state;
+
+    memcpy(&state, &ladder->state, sizeof(state));
+    cecies_x25519_portable_ladder_end(&state, x, z);
+
+    cecies_x25519_portable_fe_load(&f, x);
+    cecies_x25519_portable_fe_load(&g, z);
+    cecies_x25519_portable_fe_invert(&g, &g);
+    cecies_x25519_portable_fe_mul(&f, &f, &g);
+    cecies_x25519_portable_fe_store(x, &f);
+    cecies_x25519_fe_tobytes(out, x);
+
+    // An all-zero shared secret means the point was of small order (RFC 7748, section 6.1).
+    uint8_t acc = 0;
+    for (int k = 0; k < 32; ++k)
+    {
+        acc |= out[k];
+    }
+
+    mbedtls_platform_zeroize(x, sizeof(x));
+    mbedtls_platform_zeroize(z, sizeof(z));
+    mbedtls_platform_zeroize(&f, sizeof(f));
+    mbedtls_platform_zeroize(&g, sizeof(g));
+    mbedtls_platform_zeroize(ladder, sizeof(cecies_x25519_ladder));
+
+    return acc != 0 ? 0 : MBEDTLS_ERR_ECP_INVALID_KEY;
+}
+
+size_t cecies_x25519_multi_lanes(void)
+{
+#ifdef CECIES_X25519_X86
+    cecies_config config;
+    cecies_get_config(&config);
+
+    if (config.simd_x25519_max_lanes >= 8 && __builtin_cpu_supports("avx512f"))
+    {
+        return 8;
+    }
+
+    if (config.simd_x25519_max_lanes >= 4 && __builtin_cpu_supports("avx2"))
+    {
+        return 4;
+    }
+#endif
+    return 0;
+}
+
+/*
+ * Returns all ones if h is 0 (mod p), 0 otherwise.
+ */
+static int64_t cecies_x25519_fe_zero_mask(const int64_t h[10])
+{
+    int64_t t[10];
+    uint8_t s[32];
+
+    memcpy(t, h, sizeof(t));
+    cecies_x25519_fe_tobytes(s, t);
+
+    uint32_t acc = 0;
+    for (int k = 0; k < 32; ++k)
+    {
+        acc |= s[k];
+    }
+
+    mbedtls_platform_zeroize(t, sizeof(t));
+    mbedtls_platform_zeroize(s, sizeof(s));
+
+    return -(int64_t)(((acc - 1) >> 8) & 1);
+}
+
+void cecies_x25519_multi(const uint8_t* const* scalars, const uint8_t* const* points, uint8_t* const* outputs, const size_t count, int* results)
+{
+    const size_t lanes = cecies_x25519_multi_lanes();
+
+    if (lanes == 0)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            results[i] = MBEDTLS_ERR_ECP_BAD_INPUT_DATA;
+        }
+        return;
+    }
+
+#ifdef CECIES_X25519_X86
+    // Pairs are processed CECIES_X25519_WINDOW at a time: groups of as many as there are lanes run through the ladder one after the other,
+    // and then all of the window's results get normalized at once with a single (shared) inversion.
+    // Group g's limb k of lane l lives at index (g * 10 + k) * lanes + l.
+    uint8_t e[CECIES_X25519_WINDOW][32];
+    int64_t u[CECIES_X25519_WINDOW * 10];
+    int64_t x[CECIES_X25519_WINDOW * 10];
+    int64_t z[CECIES_X25519_WINDOW * 10];
+    int64_t scratch[CECIES_X25519_WINDOW * 10];
+
+    int64_t h[10];
+
+    for (size_t i = 0; i < count; i += CECIES_X25519_WINDOW)
+    {
+        const size_t n = CECIES_MIN(CECIES_X25519_WINDOW, count - i);
+        const size_t groups = (n + lanes - 1) / lanes;
+
+        // Unused lanes compute a throwaway multiplication (scalar 0, u = 0).
+        memset(e, 0x00, sizeof(e));
+        memset(u, 0x00, sizeof(u));
+
+        for (size_t l = 0; l < n; ++l)
+        {
+            memcpy(e[l], scalars[i + l], 32);
+            e[l][0] &= 248;
+            e[l][31] &= 127;
+            e[l][31] |= 64;
+
+            cecies_x25519_fe_frombytes(points[i + l], h);
+
+            for (int k = 0; k < 10; ++k)
+            {
+                u[((l / lanes) * 10 + k) * lanes + l % lanes] = h[k];
+            }
+        }
+
+        for (size_t g = 0; g < groups; ++g)
+        {
+            const size_t offset = g * 10 * lanes;
+
+            if (lanes == 8)
+            {
+                cecies_x25519_avx512_ladder((const uint8_t(*)[32])e[g * lanes], u + offset, x + offset, z + offset);
+            }
+            else
+            {
+                cecies_x25519_avx2_ladder((const uint8_t(*)[32])e[g * lanes], u + offset, x + offset, z + offset);
+            }
+        }
+
+        // Small-order points (and the unused lanes) end up with z = 0, which would take the whole shared inversion down with it:
+        // replace those by 0/1 (the result that a lone inversion would have given them) before normalizing.
+        for (size_t l = 0; l < groups * lanes; ++l)
+        {
+            for (int k = 0; k < 10; ++k)
+            {
+                h[k] = z[((l / lanes) * 10 + k) * lanes + l % lanes];
+            }
+
+            const int64_t mask = cecies_x25519_fe_zero_mask(h);
+
+            for (int k = 0; k < 10; ++k)
+            {
+                const size_t index = ((l / lanes) * 10 + k) * lanes + l % lanes;
+                x[index] &= ~mask;
+                z[index] = (z[index] & ~mask) | (mask & (k == 0));
+            }
+        }
+
+        if (lanes == 8)
+        {
+            cecies_x25519_avx512_normalize(x, z, scratch, groups);
+        }
+        else
+        {
+            cecies_x25519_avx2_normalize(x, z, scratch, groups);
+        }
+
+        for (size_t l = 0; l < n; ++l)
+        {
+            for (int k = 0; k < 10; ++k)
+            {
+                h[k] = x[((l / lanes) * 10 + k) * lanes + l % lanes];
+            }
+
+            cecies_x25519_fe_tobytes(outputs[i + l], h);
+
+            // An all-zero shared secret means the point was of small order (RFC 7748, section 6.1).
+            uint8_t acc = 0;
+            for (int k = 0; k < 32; ++k)
+            {
+                acc |= outputs[i + l][k];
+            }
+
+            results[i + l] = acc != 0 ? 0 : MBEDTLS_ERR_ECP_INVALID_KEY;
+        }
+    }
+
+    mbedtls_platform_zeroize(e, sizeof(e));
+    mbedtls_platform_zeroize(x, sizeof(x));
+    mbedtls_platform_zeroize(z, sizeof(z));
+    mbedtls_platform_zeroize(scratch, sizeof(scratch));
+    mbedtls_platform_zeroize(h, sizeof(h));
+#endif
+}
@@ -0,0 +1,440 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/*
+ * SIMD X25519 implementation template: this file has no include guard on purpose and is included by x25519.c once per vector width (and once more with a single plain int64_t lane).
+ * Before including it, define:
+ *
+ *   CECIES_X25519                The function name prefix (e.g. cecies_x25519_avx2).
+ *   CECIES_X25519_TARGET         The function attribute that enables the instruction set.
+ *   CECIES_X25519_LANES          How many 64-bit lanes a vector has (= how many scalar multiplications run side by side).
+ *   CECIES_X25519_VEC            The vector type.
+ *   CECIES_X25519_ZERO()         All-zero vector.
+ *   CECIES_X25519_SET1(x)        Broadcasts a 64-bit integer.
+ *   CECIES_X25519_LOAD(p)        Loads CECIES_X25519_LANES int64_t values.
+ *   CECIES_X25519_STORE(p, x)    Stores CECIES_X25519_LANES int64_t values.
+ *   CECIES_X25519_ADD(a, b)      64-bit addition.
+ *   CECIES_X25519_SUB(a, b)      64-bit subtraction.
+ *   CECIES_X25519_MUL(a, b)      Signed 32x32 -> 64-bit multiplication of the low halves.
+ *   CECIES_X25519_SLLI(x, n)     64-bit left shift by an immediate.
+ *   CECIES_X25519_SRAI(x, n)     64-bit arithmetic right shift by an immediate (only ever needed for |x| < 2^62).
+ *   CECIES_X25519_AND(a, b)      Bitwise and.
+ *   CECIES_X25519_XOR(a, b)      Bitwise xor.
+ *
+ * Every lane holds one limb of a different field element: the arithmetic is the one from the ref10 Curve25519 implementation (10 signed limbs of alternately 26 and 25 bits),
+ * just done on CECIES_X25519_LANES independent field elements at once. Nothing in here branches on or indexes by secret data.
+ * All of the above macros are undefined again at the end of this file.
+ */
+
+#define CECIES_X25519_FN_(prefix, name) prefix##_##name
+#define CECIES_X25519_FN_EXPAND(prefix, name) CECIES_X25519_FN_(prefix, name)
+#define CECIES_X25519_FN(name) CECIES_X25519_FN_EXPAND(CECIES_X25519, name)
+
+#define CECIES_X25519_FE CECIES_X25519_FN(fe)
+
+typedef struct
+{
+    CECIES_X25519_VEC v[10];
+} CECIES_X25519_FE;
+
+// Carries limb i into limb i + 1 (rounding, so that limb i ends up signed and centered around 0).
+#define CECIES_X25519_CARRY(h, i, bits)                                                                      \
+    do                                                                                                       \
+    {                                                                                                        \
+        const CECIES_X25519_VEC c = CECIES_X25519_SRAI(CECIES_X25519_ADD(h[i], CECIES_X25519_SET1((int64_t)1 << ((bits)-1))), bits); \
+        h[(i) + 1] = CECIES_X25519_ADD(h[(i) + 1], c);                                                       \
+        h[i] = CECIES_X25519_SUB(h[i], CECIES_X25519_SLLI(c, bits));                                         \
+    } while (0)
+
+CECIES_X25519_TARGET static inline void CECIES_X25519_FN(fe_add)(CECIES_X25519_FE* h, const CECIES_X25519_FE* f, const CECIES_X25519_FE* g)
+{
+    for (int i = 0; i < 10; ++i)
+    {
+        h->v[i] = CECIES_X25519_ADD(f->v[i], g->v[i]);
+    }
+}
+
+CECIES_X25519_TARGET static inline void CECIES_X25519_FN(fe_sub)(CECIES_X25519_FE* h, const CECIES_X25519_FE* f, const CECIES_X25519_FE* g)
+{
+    for (int i = 0; i < 10; ++i)
+    {
+        h->v[i] = CECIES_X25519_SUB(f->v[i], g->v[i]);
+    }
+}
+
+/*
+ * Swaps f and g in the lanes where mask is all ones (and leaves the lanes where it's zero alone).
+ */
+CECIES_X25519_TARGET static inline void CECIES_X25519_FN(fe_cswap)(CECIES_X25519_FE* f, CECIES_X25519_FE* g, const CECIES_X25519_VEC mask)
+{
+    for (int i = 0; i < 10; ++i)
+    {
+        const CECIES_X25519_VEC x = CECIES_X25519_AND(CECIES_X25519_XOR(f->v[i], g->v[i]), mask);
+        f->v[i] = CECIES_X25519_XOR(f->v[i], x);
+        g->v[i] = CECIES_X25519_XOR(g->v[i], x);
+    }
+}
+
+CECIES_X25519_TARGET static inline void CECIES_X25519_FN(fe_carry)(CECIES_X25519_FE* out, CECIES_X25519_VEC h[10])
+{
+    CECIES_X25519_CARRY(h, 0, 26);
+    CECIES_X25519_CARRY(h, 4, 26);
+    CECIES_X25519_CARRY(h, 1, 25);
+    CECIES_X25519_CARRY(h, 5, 25);
+    CECIES_X25519_CARRY(h, 2, 26);
+    CECIES_X25519_CARRY(h, 6, 26);
+    CECIES_X25519_CARRY(h, 3, 25);
+    CECIES_X25519_CARRY(h, 7, 25);
+    CECIES_X25519_CARRY(h, 4, 26);
+    CECIES_X25519_CARRY(h, 8, 26);
+
+    // The carry out of the top limb wraps around to the bottom one times 19 (2^255 = 19 mod p); 19c = 16c + 2c + c, since c doesn't fit into 32 bits here.
+    const CECIES_X25519_VEC c = CECIES_X25519_SRAI(CECIES_X25519_ADD(h[9], CECIES_X25519_SET1((int64_t)1 << 24)), 25);
+    h[0] = CECIES_X25519_ADD(h[0], CECIES_X25519_ADD(CECIES_X25519_ADD(CECIES_X25519_SLLI(c, 4), CECIES_X25519_SLLI(c, 1)), c));
+    h[9] = CECIES_X25519_SUB(h[9], CECIES_X25519_SLLI(c, 25));
+
+    CECIES_X25519_CARRY(h, 0, 26);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        out->v[i] = h[i];
+    }
+}
+
+/*
+ * h = f * g: limb i of f times limb j of g lands in limb (i + j) mod 10, times 19 if it wrapped around and times 2 if both limbs are odd (25-bit) ones.
+ */
+CECIES_X25519_TARGET static inline void CECIES_X25519_FN(fe_mul)(CECIES_X25519_FE* h, const CECIES_X25519_FE* f, const CECIES_X25519_FE* g)
+{
+    CECIES_X25519_VEC f2[10];
+    CECIES_X25519_VEC g19[10];
+    CECIES_X25519_VEC t[10];
+
+    const CECIES_X25519_VEC nineteen = CECIES_X25519_SET1(19);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        f2[i] = CECIES_X25519_SLLI(f->v[i], 1);
+        g19[i] = CECIES_X25519_MUL(g->v[i], nineteen);
+        t[i] = CECIES_X25519_ZERO();
+    }
+
+    // Fully unrolled, so that all of the index arithmetic and selection below folds away at compile time.
+#pragma GCC unroll 10
+    for (int i = 0; i < 10; ++i)
+    {
+#pragma GCC unroll 10
+        for (int j = 0; j < 10; ++j)
+        {
+            const CECIES_X25519_VEC a = (i & j & 1) ? f2[i] : f->v[i];
+            const CECIES_X25519_VEC b = (i + j >= 10) ? g19[j] : g->v[j];
+            t[(i + j) % 10] = CECIES_X25519_ADD(t[(i + j) % 10], CECIES_X25519_MUL(a, b));
+        }
+    }
+
+    CECIES_X25519_FN(fe_carry)(h, t);
+}
+
+/*
+ * h = f^2: like fe_mul(), but each product of two different limbs is only computed once (and doubled).
+ */
+CECIES_X25519_TARGET static inline void CECIES_X25519_FN(fe_sq1)(CECIES_X25519_FE* h, const CECIES_X25519_FE* f)
+{
+    CECIES_X25519_VEC f2[10];
+    CECIES_X25519_VEC f19[10];
+    CECIES_X25519_VEC t[10];
+
+    const CECIES_X25519_VEC nineteen = CECIES_X25519_SET1(19);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        f2[i] = CECIES_X25519_SLLI(f->v[i], 1);
+        f19[i] = CECIES_X25519_MUL(f->v[i], nineteen);
+        t[i] = CECIES_X25519_ZERO();
+    }
+
+#pragma GCC unroll 10
+    for (int i = 0; i < 10; ++i)
+    {
+#pragma GCC unroll 10
+        for (int j = i; j < 10; ++j)
+        {
+            const CECIES_X25519_VEC a = (i & j & 1) ? f2[i] : f->v[i];
+            const CECIES_X25519_VEC b = (i + j >= 10) ? f19[j] : f->v[j];
+            const CECIES_X25519_VEC p = CECIES_X25519_MUL(a, b);
+            t[(i + j) % 10] = CECIES_X25519_ADD(t[(i + j) % 10], i == j ? p : CECIES_X25519_SLLI(p, 1));
+        }
+    }
+
+    CECIES_X25519_FN(fe_carry)(h, t);
+}
+
+/*
+ * h = f^(2^n)
+ */
+CECIES_X25519_TARGET static inline void CECIES_X25519_FN(fe_sq)(CECIES_X25519_FE* h, const CECIES_X25519_FE* f, const int n)
+{
+    CECIES_X25519_FN(fe_sq1)(h, f);
+
+    for (int i = 1; i < n; ++i)
+    {
+        CECIES_X25519_FN(fe_sq1)(h, h);
+    }
+}
+
+CECIES_X25519_TARGET static inline void CECIES_X25519_FN(fe_mul121666)(CECIES_X25519_FE* h, const CECIES_X25519_FE* f)
+{
+    CECIES_X25519_VEC t[10];
+
+    for (int i = 0; i < 10; ++i)
+    {
+        t[i] = CECIES_X25519_MUL(f->v[i], CECIES_X25519_SET1(121666));
+    }
+
+    CECIES_X25519_FN(fe_carry)(h, t);
+}
+
+/*
+ * out = z^(p - 2) = z^(2^255 - 21) = 1 / z (and 0 for z = 0), through a fixed chain of 254 squarings and 11 multiplications.
+ */
+CECIES_X25519_TARGET static void CECIES_X25519_FN(fe_invert)(CECIES_X25519_FE* out, const CECIES_X25519_FE* z)
+{
+    CECIES_X25519_FE t0, t1, t2, t3;
+
+    CECIES_X25519_FN(fe_sq)(&t0, z, 1);         // z^2
+    CECIES_X25519_FN(fe_sq)(&t1, &t0, 2);       // z^8
+    CECIES_X25519_FN(fe_mul)(&t1, z, &t1);      // z^9
+    CECIES_X25519_FN(fe_mul)(&t0, &t0, &t1);    // z^11
+    CECIES_X25519_FN(fe_sq)(&t2, &t0, 1);       // z^22
+    CECIES_X25519_FN(fe_mul)(&t1, &t1, &t2);    // z^(2^5 - 1)
+    CECIES_X25519_FN(fe_sq)(&t2, &t1, 5);       //
+    CECIES_X25519_FN(fe_mul)(&t1, &t2, &t1);    // z^(2^10 - 1)
+    CECIES_X25519_FN(fe_sq)(&t2, &t1, 10);      //
+    CECIES_X25519_FN(fe_mul)(&t2, &t2, &t1);    // z^(2^20 - 1)
+    CECIES_X25519_FN(fe_sq)(&t3, &t2, 20);      //
+    CECIES_X25519_FN(fe_mul)(&t2, &t3, &t2);    // z^(2^40 - 1)
+    CECIES_X25519_FN(fe_sq)(&t2, &t2, 10);      //
+    CECIES_X25519_FN(fe_mul)(&t1, &t2, &t1);    // z^(2^50 - 1)
+    CECIES_X25519_FN(fe_sq)(&t2, &t1, 50);      //
+    CECIES_X25519_FN(fe_mul)(&t2, &t2, &t1);    // z^(2^100 - 1)
+    CECIES_X25519_FN(fe_sq)(&t3, &t2, 100);     //
+    CECIES_X25519_FN(fe_mul)(&t2, &t3, &t2);    // z^(2^200 - 1)
+    CECIES_X25519_FN(fe_sq)(&t2, &t2, 50);      //
+    CECIES_X25519_FN(fe_mul)(&t1, &t2, &t1);    // z^(2^250 - 1)
+    CECIES_X25519_FN(fe_sq)(&t1, &t1, 5);       // z^(2^255 - 2^5)
+    CECIES_X25519_FN(fe_mul)(out, &t1, &t0);    // z^(2^255 - 21)
+
+    mbedtls_platform_zeroize(&t0, sizeof(t0));
+    mbedtls_platform_zeroize(&t1, sizeof(t1));
+    mbedtls_platform_zeroize(&t2, sizeof(t2));
+    mbedtls_platform_zeroize(&t3, sizeof(t3));
+}
+
+CECIES_X25519_TARGET static inline void CECIES_X25519_FN(fe_load)(CECIES_X25519_FE* h, const int64_t* p)
+{
+    for (int i = 0; i < 10; ++i)
+    {
+        h->v[i] = CECIES_X25519_LOAD(p + i * CECIES_X25519_LANES);
+    }
+}
+
+CECIES_X25519_TARGET static inline void CECIES_X25519_FN(fe_store)(int64_t* p, const CECIES_X25519_FE* h)
+{
+    for (int i = 0; i < 10; ++i)
+    {
+        CECIES_X25519_STORE(p + i * CECIES_X25519_LANES, h->v[i]);
+    }
+}
+
+#define CECIES_X25519_LADDER CECIES_X25519_FN(ladder_state)
+
+/*
+ * The state of the Montgomery ladder of RFC 7748 (section 5) on CECIES_X25519_LANES independent scalar/u-coordinate pairs at once,
+ * so that the ladder can also be run a few scalar bits at a time (see ladder_bits()).
+ */
+typedef struct
+{
+    CECIES_X25519_FE x1, x2, z2, x3, z3;
+    CECIES_X25519_VEC swap;
+} CECIES_X25519_LADDER;
+
+/*
+ * Starts a ladder: u is in the limb form of cecies_x25519_fe_frombytes(), laid out as [10][CECIES_X25519_LANES] (one lane per pair).
+ */
+CECIES_X25519_TARGET static inline void CECIES_X25519_FN(ladder_start)(CECIES_X25519_LADDER* state, const int64_t* u)
+{
+    CECIES_X25519_FN(fe_load)(&state->x1, u);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        state->x2.v[i] = CECIES_X25519_SET1(i == 0);
+        state->z2.v[i] = CECIES_X25519_ZERO();
+        state->x3.v[i] = state->x1.v[i];
+        state->z3.v[i] = state->x2.v[i];
+    }
+
+    state->swap = CECIES_X25519_ZERO();
+}
+
+/*
+ * Runs the ladder over the scalar bits from down to to (both inclusive). The scalars are clamped.
+ */
+CECIES_X25519_TARGET static inline void CECIES_X25519_FN(ladder_bits)(CECIES_X25519_LADDER* state, const uint8_t scalars[][32], const int from, const int to)
+{
+    CECIES_X25519_FE tmp0, tmp1;
+
+    CECIES_X25519_FE* x1 = &state->x1;
+    CECIES_X25519_FE* x2 = &state->x2;
+    CECIES_X25519_FE* z2 = &state->z2;
+    CECIES_X25519_FE* x3 = &state->x3;
+    CECIES_X25519_FE* z3 = &state->z3;
+
+    for (int pos = from; pos >= to; --pos)
+    {
+        int64_t bits[CECIES_X25519_LANES];
+
+        for (int l = 0; l < CECIES_X25519_LANES; ++l)
+        {
+            bits[l] = (scalars[l][pos >> 3] >> (pos & 7)) & 1;
+        }
+
+        const CECIES_X25519_VEC b = CECIES_X25519_LOAD(bits);
+        const CECIES_X25519_VEC mask = CECIES_X25519_SUB(CECIES_X25519_ZERO(), CECIES_X25519_XOR(state->swap, b));
+
+        CECIES_X25519_FN(fe_cswap)(x2, x3, mask);
+        CECIES_X25519_FN(fe_cswap)(z2, z3, mask);
+        state->swap = b;
+
+        CECIES_X25519_FN(fe_sub)(&tmp0, x3, z3);
+        CECIES_X25519_FN(fe_sub)(&tmp1, x2, z2);
+        CECIES_X25519_FN(fe_add)(x2, x2, z2);
+        CECIES_X25519_FN(fe_add)(z2, x3, z3);
+        CECIES_X25519_FN(fe_mul)(z3, &tmp0, x2);
+        CECIES_X25519_FN(fe_mul)(z2, z2, &tmp1);
+        CECIES_X25519_FN(fe_sq)(&tmp0, &tmp1, 1);
+        CECIES_X25519_FN(fe_sq)(&tmp1, x2, 1);
+        CECIES_X25519_FN(fe_add)(x3, z3, z2);
+        CECIES_X25519_FN(fe_sub)(z2, z3, z2);
+        CECIES_X25519_FN(fe_mul)(x2, &tmp1, &tmp0);
+        CECIES_X25519_FN(fe_sub)(&tmp1, &tmp1, &tmp0);
+        CECIES_X25519_FN(fe_sq)(z2, z2, 1);
+        CECIES_X25519_FN(fe_mul121666)(z3, &tmp1);
+        CECIES_X25519_FN(fe_sq)(x3, x3, 1);
+        CECIES_X25519_FN(fe_add)(&tmp0, &tmp0, z3);
+        CECIES_X25519_FN(fe_mul)(z3, x1, z2);
+        CECIES_X25519_FN(fe_mul)(z2, &tmp1, &tmp0);
+
+        mbedtls_platform_zeroize(bits, sizeof(bits));
+    }
+
+    mbedtls_platform_zeroize(&tmp0, sizeof(tmp0));
+    mbedtls_platform_zeroize(&tmp1, sizeof(tmp1));
+}
+
+/*
+ * Finishes a ladder that went through all scalar bits: the projective result x/z is stored in the same layout as ladder_start()'s u, and the state is wiped.
+ */
+CECIES_X25519_TARGET static inline void CECIES_X25519_FN(ladder_end)(CECIES_X25519_LADDER* state, int64_t* x, int64_t* z)
+{
+    const CECIES_X25519_VEC mask = CECIES_X25519_SUB(CECIES_X25519_ZERO(), state->swap);
+    CECIES_X25519_FN(fe_cswap)(&state->x2, &state->x3, mask);
+    CECIES_X25519_FN(fe_cswap)(&state->z2, &state->z3, mask);
+
+    CECIES_X25519_FN(fe_store)(x, &state->x2);
+    CECIES_X25519_FN(fe_store)(z, &state->z2);
+
+    mbedtls_platform_zeroize(state, sizeof(CECIES_X25519_LADDER));
+}
+
+/*
+ * The whole ladder in one go. The final division x/z is left to normalize(), so that it can be shared among multiple ladders.
+ */
+CECIES_X25519_TARGET static inline void CECIES_X25519_FN(ladder)(const uint8_t scalars[][32], const int64_t* u, int64_t* x, int64_t* z)
+{
+    CECIES_X25519_LADDER state;
+
+    CECIES_X25519_FN(ladder_start)(&state, u);
+    CECIES_X25519_FN(ladder_bits)(&state, scalars, 254, 0);
+    CECIES_X25519_FN(ladder_end)(&state, x, z);
+}
+
+/*
+ * x[g] = x[g] / z[g] for all groups of ladder() results (each one laid out as [10][CECIES_X25519_LANES], one after the other) with Montgomery's simultaneous inversion:
+ * the running products z[0] * ... * z[g] go into scratch, only the last one is inverted, and walking back down the products peels off each 1 / z[g] with 3 multiplications.
+ * So all of the groups share one inversion (per lane) instead of each paying for its own. None of the z may be 0 (mod p): that would zero every result of its lane.
+ */
+CECIES_X25519_TARGET static inline void CECIES_X25519_FN(normalize)(int64_t* x, const int64_t* z, int64_t* scratch, const size_t groups)
+{
+    const size_t stride = 10 * CECIES_X25519_LANES;
+
+    CECIES_X25519_FE acc, inv, f, g;
+
+    CECIES_X25519_FN(fe_load)(&acc, z);
+    CECIES_X25519_FN(fe_store)(scratch, &acc);
+
+    for (size_t i = 1; i < groups; ++i)
+    {
+        CECIES_X25519_FN(fe_load)(&f, z + i * stride);
+        CECIES_X25519_FN(fe_mul)(&acc, &acc, &f);
+        CECIES_X25519_FN(fe_store)(scratch + i * stride, &acc);
+    }
+
+    CECIES_X25519_FN(fe_invert)(&inv, &acc); // 1 / (z[0] * ... * z[groups - 1])
+
+    for (size_t i = groups - 1; i > 0; --i)
+    {
+        CECIES_X25519_FN(fe_load)(&f, scratch + (i - 1) * stride);
+        CECIES_X25519_FN(fe_mul)(&f, &inv, &f); // 1 / z[i]
+
+        CECIES_X25519_FN(fe_load)(&g, z + i * stride);
+        CECIES_X25519_FN(fe_mul)(&inv, &inv, &g); // 1 / (z[0] * ... * z[i - 1])
+
+        CECIES_X25519_FN(fe_load)(&g, x + i * stride);
+        CECIES_X25519_FN(fe_mul)(&g, &g, &f);
+        CECIES_X25519_FN(fe_store)(x + i * stride, &g);
+    }
+
+    CECIES_X25519_FN(fe_load)(&g, x);
+    CECIES_X25519_FN(fe_mul)(&g, &g, &inv);
+    CECIES_X25519_FN(fe_store)(x, &g);
+
+    mbedtls_platform_zeroize(&acc, sizeof(acc));
+    mbedtls_platform_zeroize(&inv, sizeof(inv));
+    mbedtls_platform_zeroize(&f, sizeof(f));
+    mbedtls_platform_zeroize(&g, sizeof(g));
+}
+
+#undef CECIES_X25519_CARRY
+#undef CECIES_X25519_LADDER
+#undef CECIES_X25519_FE
+#undef CECIES_X25519_FN
+#undef CECIES_X25519_FN_EXPAND
+#undef CECIES_X25519_FN_
+#undef CECIES_X25519
+#undef CECIES_X25519_TARGET
+#undef CECIES_X25519_LANES
+#undef CECIES_X25519_VEC
+#undef CECIES_X25519_ZERO
+#undef CECIES_X25519_SET1
+#undef CECIES_X25519_LOAD
+#undef CECIES_X25519_STORE
+#undef CECIES_X25519_ADD
+#undef CECIES_X25519_SUB
+#undef CECIES_X25519_MUL
+#undef CECIES_X25519_SLLI
+#undef CECIES_X25519_SRAI
+#undef CECIES_X25519_AND
+#undef CECIES_X25519_XOR
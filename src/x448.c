@@ -0,0 +1,336 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <string.h>
+
+#include <mbedtls/ecp.h>
+#include <mbedtls/platform_util.h>
+
+#include "internal.h"
+
+/*
+ * Resumable X448 (RFC 7748): the Montgomery ladder over p = 2^448 - 2^224 - 1, run a few scalar bits at a time (see cecies_x448_ladder_run()).
+ * Field elements are 16 limbs of 28 bits (little-endian) in uint32_t's, with 64-bit intermediate products, so this runs on any target.
+ * Since 2^448 = 2^224 + 1 (mod p), whatever overflows limb 15 is folded back into limbs 0 and 8.
+ * Every operation returns carried limbs (none above 2^28 + 1), which keeps the 64-bit column sums of cecies_x448_fe_mul() from overflowing.
+ */
+
+#define CECIES_X448_MASK 0x0FFFFFFF
+
+// The ladder constant (A - 2) / 4 for Curve448.
+#define CECIES_X448_A24 39081
+
+typedef uint32_t cecies_x448_fe[16];
+
+/*
+ * Carries 16 (64-bit) columns into h: two passes, each wrapping the top carry around into limbs 0 and 8.
+ */
+static void cecies_x448_fe_carry(cecies_x448_fe h, uint64_t c[16])
+{
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (int i = 0; i < 15; ++i)
+        {
+            c[i + 1] += c[i] >> 28;
+            c[i] &= CECIES_X448_MASK;
+        }
+
+        const uint64_t top = c[15] >> 28;
+        c[15] &= CECIES_X448_MASK;
+        c[0] += top;
+        c[8] += top;
+    }
+
+    for (int i = 0; i < 16; ++i)
+    {
+        h[i] = (uint32_t)c[i];
+    }
+
+    mbedtls_platform_zeroize(c, 16 * sizeof(uint64_t));
+}
+
+static void cecies_x448_fe_add(cecies_x448_fe h, const cecies_x448_fe f, const cecies_x448_fe g)
+{
+    uint64_t c[16];
+
+    for (int i = 0; i < 16; ++i)
+    {
+        c[i] = (uint64_t)f[i] + g[i];
+    }
+
+    cecies_x448_fe_carry(h, c);
+}
+
+/*
+ * h = f + 2p - g (2p has the limbs 2^29 - 2, except for limb 8: 2^29 - 4), so that no column goes negative.
+ */
+static void cecies_x448_fe_sub(cecies_x448_fe h, const cecies_x448_fe f, const cecies_x448_fe g)
+{
+    uint64_t c[16];
+
+    for (int i = 0; i < 16; ++i)
+    {
+        c[i] = (uint64_t)f[i] + (i == 8 ? 0x1FFFFFFC : 0x1FFFFFFE) - g[i];
+    }
+
+    cecies_x448_fe_carry(h, c);
+}
+
+static void cecies_x448_fe_mul(cecies_x448_fe h, const cecies_x448_fe f, const cecies_x448_fe g)
+{
+    uint64_t c[31] = { 0 };
+
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int j = 0; j < 16; ++j)
+        {
+            c[i + j] += (uint64_t)f[i] * g[j];
+        }
+    }
+
+    // 2^(28k) = 2^(28(k - 16)) * (2^224 + 1): column k goes into columns k - 8 and k - 16 (top-down, so that the columns 16-22 that receive something get folded too).
+    for (int k = 30; k >= 16; --k)
+    {
+        c[k - 8] += c[k];
+        c[k - 16] += c[k];
+    }
+
+    cecies_x448_fe_carry(h, c);
+    mbedtls_platform_zeroize(c, sizeof(c));
+}
+
+static void cecies_x448_fe_mul_a24(cecies_x448_fe h, const cecies_x448_fe f)
+{
+    uint64_t c[16];
+
+    for (int i = 0; i < 16; ++i)
+    {
+        c[i] = (uint64_t)f[i] * CECIES_X448_A24;
+    }
+
+    cecies_x448_fe_carry(h, c);
+}
+
+/*
+ * Swaps f and g if mask is all ones (leaves them alone if it's 0), in constant time.
+ */
+static void cecies_x448_fe_cswap(cecies_x448_fe f, cecies_x448_fe g, const uint32_t mask)
+{
+    for (int i = 0; i < 16; ++i)
+    {
+        const uint32_t t = mask & (f[i] ^ g[i]);
+        f[i] ^= t;
+        g[i] ^= t;
+    }
+}
+
+/*
+ * out = z^(p - 2) = 1 / z. The exponent is public: all of its bits are set except for bit 1 and bit 224.
+ */
+static void cecies_x448_fe_invert(cecies_x448_fe out, const cecies_x448_fe z)
+{
+    cecies_x448_fe r;
+    memcpy(r, z, sizeof(r));
+
+    for (int i = 446; i >= 0; --i)
+    {
+        cecies_x448_fe_mul(r, r, r);
+
+        if (i != 1 && i != 224)
+        {
+            cecies_x448_fe_mul(r, r, z);
+        }
+    }
+
+    memcpy(out, r, sizeof(r));
+    mbedtls_platform_zeroize(r, sizeof(r));
+}
+
+/*
+ * Reads a u-coordinate (RFC 7748: 56 bytes little-endian, values >= p are fine) into limbs.
+ */
+static void cecies_x448_fe_frombytes(cecies_x448_fe h, const uint8_t s[56])
+{
+    for (int i = 0; i < 16; i += 2)
+    {
+        // Two limbs are exactly 7 bytes.
+        const uint8_t* b = s + (i / 2) * 7;
+
+        uint64_t w = 0;
+        for (int k = 6; k >= 0; --k)
+        {
+            w = (w << 8) | b[k];
+        }
+
+        h[i] = (uint32_t)(w & CECIES_X448_MASK);
+        h[i + 1] = (uint32_t)(w >> 28);
+    }
+}
+
+/*
+ * Writes h out as the canonical (fully reduced mod p) little-endian encoding.
+ */
+static void cecies_x448_fe_tobytes(uint8_t s[56], const cecies_x448_fe f)
+{
+    cecies_x448_fe h;
+    uint64_t c[16];
+
+    // Two more rounds of carries leave every limb below 2^28, i.e. h < 2^448 < 2p (a wrapped-around top carry can leave limb 0 at 2^28 once, but not twice).
+    for (int round = 0; round < 2; ++round)
+    {
+        for (int i = 0; i < 16; ++i)
+        {
+            c[i] = round == 0 ? f[i] : h[i];
+        }
+        cecies_x448_fe_carry(h, c);
+    }
+
+    // Subtract p once, and keep the difference unless that borrowed (i.e. unless h < p).
+    cecies_x448_fe t;
+    uint32_t borrow = 0;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        const uint32_t d = h[i] - (i == 8 ? 0x0FFFFFFE : CECIES_X448_MASK) - borrow;
+        t[i] = d & CECIES_X448_MASK;
+        borrow = d >> 31;
+    }
+
+    const uint32_t keep = borrow - 1;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        h[i] = (t[i] & keep) | (h[i] & ~keep);
+    }
+
+    for (int i = 0; i < 16; i += 2)
+    {
+        const uint64_t w = (uint64_t)h[i] | ((uint64_t)h[i + 1] << 28);
+
+        for (int k = 0; k < 7; ++k)
+        {
+            s[(i / 2) * 7 + k] = (uint8_t)(w >> (8 * k));
+        }
+    }
+
+    mbedtls_platform_zeroize(h, sizeof(h));
+    mbedtls_platform_zeroize(t, sizeof(t));
+}
+
+void cecies_x448_ladder_init(cecies_x448_ladder* ladder, const uint8_t scalar[56], const uint8_t u[56])
+{
+    memcpy(ladder->scalar, scalar, 56);
+    ladder->scalar[0] &= 252;
+    ladder->scalar[55] |= 128;
+    ladder->bit = 447;
+
+    cecies_x448_fe_frombytes(ladder->state[0], u);
+
+    memset(ladder->state[1], 0x00, sizeof(ladder->state[1]));
+    memset(ladder->state[2], 0x00, sizeof(ladder->state[2]));
+    memcpy(ladder->state[3], ladder->state[0], sizeof(ladder->state[3]));
+    memset(ladder->state[4], 0x00, sizeof(ladder->state[4]));
+
+    ladder->state[1][0] = 1;
+    ladder->state[4][0] = 1;
+    ladder->swap = 0;
+}
+
+int cecies_x448_ladder_run(cecies_x448_ladder* ladder, const size_t max_bits)
+{
+    if (ladder->bit < 0)
+    {
+        return 0;
+    }
+
+    const int to = max_bits == 0 || max_bits > (size_t)ladder->bit ? 0 : ladder->bit + 1 - (int)max_bits;
+
+    uint32_t* x1 = ladder->state[0];
+    uint32_t* x2 = ladder->state[1];
+    uint32_t* z2 = ladder->state[2];
+    uint32_t* x3 = ladder->state[3];
+    uint32_t* z3 = ladder->state[4];
+
+    cecies_x448_fe a, aa, b, bb, e, c, d, da, cb;
+
+    for (int pos = ladder->bit; pos >= to; --pos)
+    {
+        const uint32_t bit = (ladder->scalar[pos >> 3] >> (pos & 7)) & 1;
+        const uint32_t mask = 0 - (ladder->swap ^ bit);
+
+        cecies_x448_fe_cswap(x2, x3, mask);
+        cecies_x448_fe_cswap(z2, z3, mask);
+        ladder->swap = bit;
+
+        cecies_x448_fe_add(a, x2, z2);
+        cecies_x448_fe_mul(aa, a, a);
+        cecies_x448_fe_sub(b, x2, z2);
+        cecies_x448_fe_mul(bb, b, b);
+        cecies_x448_fe_sub(e, aa, bb);
+        cecies_x448_fe_add(c, x3, z3);
+        cecies_x448_fe_sub(d, x3, z3);
+        cecies_x448_fe_mul(da, d, a);
+        cecies_x448_fe_mul(cb, c, b);
+
+        cecies_x448_fe_add(x3, da, cb);
+        cecies_x448_fe_mul(x3, x3, x3);
+        cecies_x448_fe_sub(z3, da, cb);
+        cecies_x448_fe_mul(z3, z3, z3);
+        cecies_x448_fe_mul(z3, x1, z3);
+        cecies_x448_fe_mul(x2, aa, bb);
+        cecies_x448_fe_mul_a24(z2, e);
+        cecies_x448_fe_add(z2, aa, z2);
+        cecies_x448_fe_mul(z2, e, z2);
+    }
+
+    ladder->bit = to - 1;
+
+    mbedtls_platform_zeroize(a, sizeof(a));
+    mbedtls_platform_zeroize(aa, sizeof(aa));
+    mbedtls_platform_zeroize(b, sizeof(b));
+    mbedtls_platform_zeroize(bb, sizeof(bb));
+    mbedtls_platform_zeroize(e, sizeof(e));
+    mbedtls_platform_zeroize(c, sizeof(c));
+    mbedtls_platform_zeroize(d, sizeof(d));
+    mbedtls_platform_zeroize(da, sizeof(da));
+    mbedtls_platform_zeroize(cb, sizeof(cb));
+
+    return ladder->bit >= 0;
+}
+
+int cecies_x448_ladder_finish(cecies_x448_ladder* ladder, uint8_t out[56])
+{
+    const uint32_t mask = 0 - ladder->swap;
+    cecies_x448_fe_cswap(ladder->state[1], ladder->state[3], mask);
+    cecies_x448_fe_cswap(ladder->state[2], ladder->state[4], mask);
+
+    cecies_x448_fe z;
+    cecies_x448_fe_invert(z, ladder->state[2]);
+    cecies_x448_fe_mul(z, ladder->state[1], z);
+    cecies_x448_fe_tobytes(out, z);
+
+    // An all-zero shared secret means the point was of small order (RFC 7748, section 6.2).
+    uint8_t acc = 0;
+    for (int k = 0; k < 56; ++k)
+    {
+        acc |= out[k];
+    }
+
+    mbedtls_platform_zeroize(z, sizeof(z));
+    mbedtls_platform_zeroize(ladder, sizeof(cecies_x448_ladder));
+
+    return acc != 0 ? 0 : MBEDTLS_ERR_ECP_INVALID_KEY;
+}
@@ -11,5 +11,7 @@ cmake -DBUILD_SHARED_LIBS=Off -DUSE_SHARED_MBEDTLS_LIBRARY=Off "-D%projname%_ENA
 cmake --build . --config Release
 
 call Release\run_tests.exe
+call Release\run_tests_cpp.exe
+call Release\run_tests_cpp_noexceptions.exe
 
 cd %i%
\ No newline at end of file
@@ -39,5 +39,7 @@ export CC="$PREVCC"
 export CXX="$PREVCXX"
 
 ./run_tests || ./Debug/run_tests.exe || exit
+./run_tests_cpp || ./Debug/run_tests_cpp.exe || exit
+./run_tests_cpp_noexceptions || ./Debug/run_tests_cpp_noexceptions.exe || exit
 
 cd "$REPO" || exit
\ No newline at end of file
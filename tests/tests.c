@@ -33,6 +33,22 @@
 #include <cecies/keygen.h>
 #include <cecies/encrypt.h>
 #include <cecies/decrypt.h>
+#include <cecies/kem.h>
+#include <cecies/ed25519.h>
+#include <cecies/keyring.h>
+#include <cecies/inspect.h>
+#include <cecies/stream.h>
+#include <cecies/reader.h>
+#include <cecies/iovec.h>
+#include <cecies/alloc.h>
+#include <cecies/restartable.h>
+#include <cecies/async.h>
+#include <cecies/interop.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/eventfd.h>
+#endif
 
 #define TEST_INIT cecies_disable_fprintf()
 #include <acutest.h>
@@ -1499,6 +1515,3597 @@ static void cecies_curve448_encrypt_binary_decrypt_ciphertext_was_tampered_with_
     free(decrypted_string);
 }
 
+// -----------------------------------------------------------------------------------------------------------------------     KEYRING
+
+static void cecies_curve25519_encrypt_ext_key_id_decrypts_successfully()
+{
+    uint8_t* encrypted_string = NULL;
+    uint8_t* decrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+    size_t decrypted_string_length = 0;
+
+    //
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID, &encrypted_string, &encrypted_string_length, 0));
+    TEST_CHECK(encrypted_string_length == cecies_calc_ext_header_length(CECIES_HEADER_FLAG_KEY_ID) + cecies_curve25519_calc_output_buffer_needed_size(TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+    TEST_CHECK(0 == cecies_curve25519_decrypt(encrypted_string, encrypted_string_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted_string, &decrypted_string_length));
+    TEST_CHECK(decrypted_string_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+    TEST_CHECK(0 == memcmp(TEST_STRING, decrypted_string, sizeof(TEST_STRING)));
+
+    free(encrypted_string);
+    free(decrypted_string);
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID, &encrypted_string, &encrypted_string_length, 1));
+    TEST_CHECK(0 == cecies_curve25519_decrypt(encrypted_string, encrypted_string_length, 1, TEST_CURVE25519_PRIVATE_KEY, &decrypted_string, &decrypted_string_length));
+    TEST_CHECK(0 == memcmp(TEST_STRING, decrypted_string, sizeof(TEST_STRING)));
+
+    //
+
+    free(encrypted_string);
+    free(decrypted_string);
+}
+
+static void cecies_curve448_encrypt_ext_key_id_decrypts_successfully()
+{
+    uint8_t* encrypted_string = NULL;
+    uint8_t* decrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+    size_t decrypted_string_length = 0;
+
+    //
+
+    TEST_CHECK(0 == cecies_curve448_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 9, TEST_CURVE448_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID, &encrypted_string, &encrypted_string_length, 1));
+    TEST_CHECK(0 == cecies_curve448_decrypt(encrypted_string, encrypted_string_length, 1, TEST_CURVE448_PRIVATE_KEY, &decrypted_string, &decrypted_string_length));
+    TEST_CHECK(decrypted_string_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+    TEST_CHECK(0 == memcmp(TEST_STRING, decrypted_string, sizeof(TEST_STRING)));
+
+    //
+
+    free(encrypted_string);
+    free(decrypted_string);
+}
+
+static void cecies_encrypt_ext_without_flags_output_identical_format()
+{
+    uint8_t* encrypted_string = NULL;
+    uint8_t* decrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+    size_t decrypted_string_length = 0;
+
+    //
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, 0, &encrypted_string, &encrypted_string_length, 0));
+    TEST_CHECK(encrypted_string_length == cecies_curve25519_calc_output_buffer_needed_size(TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+    TEST_CHECK(0 == cecies_curve25519_decrypt(encrypted_string, encrypted_string_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted_string, &decrypted_string_length));
+
+    //
+
+    free(encrypted_string);
+    free(decrypted_string);
+}
+
+static void cecies_encrypt_ext_invalid_header_flags_fails_returns_CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG()
+{
+    uint8_t* encrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG == cecies_curve25519_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, 0x80, &encrypted_string, &encrypted_string_length, 0));
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG == cecies_curve448_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE448_PUBLIC_KEY, 0x80, &encrypted_string, &encrypted_string_length, 0));
+}
+
+static void cecies_encrypt_ext_tampered_ext_header_fails()
+{
+    uint8_t* encrypted_string = NULL;
+    uint8_t* decrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+    size_t decrypted_string_length = 0;
+
+    //
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID, &encrypted_string, &encrypted_string_length, 0));
+
+    // The key ID hint is authenticated along with the ciphertext.
+    encrypted_string[CECIES_EXT_HEADER_MAGIC_SIZE + 1] ^= 0xFF;
+    TEST_CHECK(0 != cecies_curve25519_decrypt(encrypted_string, encrypted_string_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted_string, &decrypted_string_length));
+
+    // Unknown flags are rejected.
+    encrypted_string[CECIES_EXT_HEADER_MAGIC_SIZE + 1] ^= 0xFF;
+    encrypted_string[CECIES_EXT_HEADER_MAGIC_SIZE] |= 0x80;
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_INVALID_ARG == cecies_curve25519_decrypt(encrypted_string, encrypted_string_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted_string, &decrypted_string_length));
+
+    //
+
+    free(encrypted_string);
+}
+
+static void cecies_encrypt_ext_decrypt_with_other_curve_fails_returns_CECIES_DECRYPT_ERROR_CODE_INVALID_ARG()
+{
+    uint8_t* encrypted_string = NULL;
+    uint8_t* decrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+    size_t decrypted_string_length = 0;
+
+    //
+
+    TEST_CHECK(0 == cecies_curve448_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE448_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID, &encrypted_string, &encrypted_string_length, 0));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_INVALID_ARG == cecies_curve25519_decrypt(encrypted_string, encrypted_string_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted_string, &decrypted_string_length));
+
+    //
+
+    free(encrypted_string);
+}
+
+static void cecies_curve25519_keyring_write_open_find_and_decrypt_succeeds()
+{
+    const char* keyring_file_path = "cecies_test_keyring_25519.bin";
+
+    cecies_curve25519_keypair keypairs[33];
+    for (int i = 0; i < 32; ++i)
+    {
+        TEST_ASSERT(0 == cecies_generate_curve25519_keypair(&keypairs[i], NULL, 0));
+    }
+
+    keypairs[32].public_key = TEST_CURVE25519_PUBLIC_KEY;
+    keypairs[32].private_key = TEST_CURVE25519_PRIVATE_KEY;
+
+    TEST_ASSERT(0 == cecies_curve25519_keyring_write(keyring_file_path, keypairs, 33));
+
+    cecies_keyring* keyring = NULL;
+    TEST_ASSERT(0 == cecies_keyring_open(keyring_file_path, &keyring));
+    TEST_CHECK(0 == cecies_keyring_get_curve(keyring));
+    TEST_CHECK(33 == cecies_keyring_get_key_count(keyring));
+
+    uint8_t* encrypted_string = NULL;
+    uint8_t* decrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+    size_t decrypted_string_length = 0;
+
+    for (int i = 0; i < 33; i += 4)
+    {
+        TEST_CHECK(0 == cecies_curve25519_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, keypairs[i].public_key, CECIES_HEADER_FLAG_KEY_ID, &encrypted_string, &encrypted_string_length, i % 2));
+        TEST_CHECK(0 == cecies_keyring_decrypt(keyring, encrypted_string, encrypted_string_length, i % 2, &decrypted_string, &decrypted_string_length));
+        TEST_CHECK(decrypted_string_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+        TEST_CHECK(0 == memcmp(TEST_STRING, decrypted_string, sizeof(TEST_STRING)));
+
+        free(encrypted_string);
+        free(decrypted_string);
+        decrypted_string = NULL;
+    }
+
+    const uint8_t* private_key = NULL;
+    size_t private_key_length = 0;
+    uint8_t expected_private_key[CECIES_X25519_KEY_SIZE + 1];
+    uint8_t public_key[CECIES_X25519_KEY_SIZE + 1];
+    uint8_t key_id[CECIES_KEY_ID_SIZE];
+
+    TEST_CHECK(0 == cecies_hexstr2bin(TEST_CURVE25519_PUBLIC_KEY.hexstring, 64, public_key, sizeof(public_key), NULL));
+    TEST_CHECK(0 == cecies_hexstr2bin(TEST_CURVE25519_PRIVATE_KEY.hexstring, 64, expected_private_key, sizeof(expected_private_key), NULL));
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID, &encrypted_string, &encrypted_string_length, 0));
+    memcpy(key_id, encrypted_string + CECIES_EXT_HEADER_MAGIC_SIZE + 1, CECIES_KEY_ID_SIZE);
+    free(encrypted_string);
+
+    TEST_CHECK(0 == cecies_keyring_find(keyring, key_id, &private_key, &private_key_length));
+    TEST_CHECK(private_key_length == CECIES_X25519_KEY_SIZE);
+    TEST_CHECK(0 == memcmp(private_key, expected_private_key, CECIES_X25519_KEY_SIZE));
+
+    key_id[0] ^= 0xFF;
+    TEST_CHECK(CECIES_KEYRING_ERROR_CODE_KEY_NOT_FOUND == cecies_keyring_find(keyring, key_id, &private_key, &private_key_length));
+
+    cecies_keyring_close(keyring);
+    remove(keyring_file_path);
+}
+
+static void cecies_curve448_keyring_write_open_and_decrypt_succeeds()
+{
+    const char* keyring_file_path = "cecies_test_keyring_448.bin";
+
+    cecies_curve448_keypair keypairs[9];
+    for (int i = 0; i < 8; ++i)
+    {
+        TEST_ASSERT(0 == cecies_generate_curve448_keypair(&keypairs[i], NULL, 0));
+    }
+
+    keypairs[8].public_key = TEST_CURVE448_PUBLIC_KEY;
+    keypairs[8].private_key = TEST_CURVE448_PRIVATE_KEY;
+
+    TEST_ASSERT(0 == cecies_curve448_keyring_write(keyring_file_path, keypairs, 9));
+
+    cecies_keyring* keyring = NULL;
+    TEST_ASSERT(0 == cecies_keyring_open(keyring_file_path, &keyring));
+    TEST_CHECK(1 == cecies_keyring_get_curve(keyring));
+    TEST_CHECK(9 == cecies_keyring_get_key_count(keyring));
+
+    uint8_t* encrypted_string = NULL;
+    uint8_t* decrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+    size_t decrypted_string_length = 0;
+
+    for (int i = 0; i < 9; ++i)
+    {
+        TEST_CHECK(0 == cecies_curve448_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, keypairs[i].public_key, CECIES_HEADER_FLAG_KEY_ID, &encrypted_string, &encrypted_string_length, 1));
+        TEST_CHECK(0 == cecies_keyring_decrypt(keyring, encrypted_string, encrypted_string_length, 1, &decrypted_string, &decrypted_string_length));
+        TEST_CHECK(0 == memcmp(TEST_STRING, decrypted_string, sizeof(TEST_STRING)));
+
+        free(encrypted_string);
+        free(decrypted_string);
+        decrypted_string = NULL;
+    }
+
+    cecies_keyring_close(keyring);
+    remove(keyring_file_path);
+}
+
+static void cecies_keyring_decrypt_without_key_id_hint_fails_returns_CECIES_KEYRING_ERROR_CODE_KEY_NOT_FOUND()
+{
+    const char* keyring_file_path = "cecies_test_keyring_no_hint.bin";
+
+    cecies_curve25519_keypair keypair = { .public_key = TEST_CURVE25519_PUBLIC_KEY, .private_key = TEST_CURVE25519_PRIVATE_KEY };
+    TEST_ASSERT(0 == cecies_curve25519_keyring_write(keyring_file_path, &keypair, 1));
+
+    cecies_keyring* keyring = NULL;
+    TEST_ASSERT(0 == cecies_keyring_open(keyring_file_path, &keyring));
+
+    uint8_t* encrypted_string = NULL;
+    uint8_t* decrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+    size_t decrypted_string_length = 0;
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted_string, &encrypted_string_length, 0));
+    TEST_CHECK(CECIES_KEYRING_ERROR_CODE_KEY_NOT_FOUND == cecies_keyring_decrypt(keyring, encrypted_string, encrypted_string_length, 0, &decrypted_string, &decrypted_string_length));
+    free(encrypted_string);
+
+    // Ciphertexts for another curve are rejected.
+    TEST_CHECK(0 == cecies_curve448_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE448_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID, &encrypted_string, &encrypted_string_length, 0));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_INVALID_ARG == cecies_keyring_decrypt(keyring, encrypted_string, encrypted_string_length, 0, &decrypted_string, &decrypted_string_length));
+    free(encrypted_string);
+
+    cecies_keyring_close(keyring);
+    remove(keyring_file_path);
+}
+
+static void cecies_keyring_write_duplicate_keys_fails_returns_CECIES_KEYRING_ERROR_CODE_INVALID_ARG()
+{
+    cecies_curve25519_keypair keypairs[2] = {
+        { .public_key = TEST_CURVE25519_PUBLIC_KEY, .private_key = TEST_CURVE25519_PRIVATE_KEY },
+        { .public_key = TEST_CURVE25519_PUBLIC_KEY, .private_key = TEST_CURVE25519_PRIVATE_KEY },
+    };
+
+    TEST_CHECK(CECIES_KEYRING_ERROR_CODE_INVALID_ARG == cecies_curve25519_keyring_write("cecies_test_keyring_duplicates.bin", keypairs, 2));
+    TEST_CHECK(CECIES_KEYRING_ERROR_CODE_INVALID_ARG == cecies_curve25519_keyring_write("cecies_test_keyring_duplicates.bin", keypairs, 0));
+    TEST_CHECK(CECIES_KEYRING_ERROR_CODE_NULL_ARG == cecies_curve25519_keyring_write(NULL, keypairs, 1));
+    TEST_CHECK(CECIES_KEYRING_ERROR_CODE_NULL_ARG == cecies_curve25519_keyring_write("cecies_test_keyring_duplicates.bin", NULL, 1));
+}
+
+static void cecies_keyring_open_invalid_file_fails()
+{
+    const char* keyring_file_path = "cecies_test_keyring_invalid.bin";
+
+    cecies_keyring* keyring = NULL;
+    TEST_CHECK(CECIES_KEYRING_ERROR_CODE_NULL_ARG == cecies_keyring_open(NULL, &keyring));
+    TEST_CHECK(CECIES_KEYRING_ERROR_CODE_FILE_ACCESS_FAILED == cecies_keyring_open("cecies_test_keyring_that_does_not_exist.bin", &keyring));
+
+    FILE* file = fopen(keyring_file_path, "wb");
+    TEST_ASSERT(file != NULL);
+    fwrite(TEST_STRING, 1, sizeof(TEST_STRING), file);
+    fclose(file);
+
+    TEST_CHECK(CECIES_KEYRING_ERROR_CODE_INVALID_FILE == cecies_keyring_open(keyring_file_path, &keyring));
+    TEST_CHECK(keyring == NULL);
+
+    cecies_curve25519_keypair keypair = { .public_key = TEST_CURVE25519_PUBLIC_KEY, .private_key = TEST_CURVE25519_PRIVATE_KEY };
+    TEST_ASSERT(0 == cecies_curve25519_keyring_write(keyring_file_path, &keypair, 1));
+
+    // Truncate the keyring file.
+    file = fopen(keyring_file_path, "r+b");
+    TEST_ASSERT(file != NULL);
+    uint8_t contents[128];
+    const size_t contents_length = fread(contents, 1, sizeof(contents), file);
+    fclose(file);
+
+    file = fopen(keyring_file_path, "wb");
+    TEST_ASSERT(file != NULL);
+    fwrite(contents, 1, contents_length - 1, file);
+    fclose(file);
+
+    TEST_CHECK(CECIES_KEYRING_ERROR_CODE_INVALID_FILE == cecies_keyring_open(keyring_file_path, &keyring));
+
+    cecies_keyring_close(NULL);
+    remove(keyring_file_path);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     TRIAL DECRYPTION
+
+static void cecies_curve25519_decrypt_trial_finds_matching_key_and_decrypts_successfully()
+{
+    cecies_curve25519_key private_keys[24];
+    for (int i = 0; i < 24; ++i)
+    {
+        cecies_curve25519_keypair keypair;
+        TEST_ASSERT(0 == cecies_generate_curve25519_keypair(&keypair, NULL, 0));
+        private_keys[i] = keypair.private_key;
+    }
+
+    private_keys[17] = TEST_CURVE25519_PRIVATE_KEY;
+
+    uint8_t* encrypted_string = NULL;
+    uint8_t* decrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+    size_t decrypted_string_length = 0;
+    size_t key_index = 0;
+
+    //
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted_string, &encrypted_string_length, 0));
+
+    for (size_t thread_count = 0; thread_count <= 4; ++thread_count)
+    {
+        TEST_CHECK(0 == cecies_curve25519_decrypt_trial(encrypted_string, encrypted_string_length, 0, private_keys, 24, thread_count, &key_index, &decrypted_string, &decrypted_string_length));
+        TEST_CHECK(key_index == 17);
+        TEST_CHECK(decrypted_string_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+        TEST_CHECK(0 == memcmp(TEST_STRING, decrypted_string, sizeof(TEST_STRING)));
+
+        free(decrypted_string);
+        decrypted_string = NULL;
+    }
+
+    free(encrypted_string);
+
+    // Compressed, base64-encoded and with an extended header (which is authenticated as additional data).
+    TEST_CHECK(0 == cecies_curve25519_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 8, TEST_CURVE25519_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID, &encrypted_string, &encrypted_string_length, 1));
+    TEST_CHECK(0 == cecies_curve25519_decrypt_trial(encrypted_string, encrypted_string_length, 1, private_keys, 24, 0, &key_index, &decrypted_string, &decrypted_string_length));
+    TEST_CHECK(key_index == 17);
+    TEST_CHECK(decrypted_string_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+    TEST_CHECK(0 == memcmp(TEST_STRING, decrypted_string, sizeof(TEST_STRING)));
+
+    //
+
+    free(encrypted_string);
+    free(decrypted_string);
+}
+
+static void cecies_curve448_decrypt_trial_finds_matching_key_and_decrypts_successfully()
+{
+    cecies_curve448_key private_keys[8];
+    for (int i = 0; i < 8; ++i)
+    {
+        cecies_curve448_keypair keypair;
+        TEST_ASSERT(0 == cecies_generate_curve448_keypair(&keypair, NULL, 0));
+        private_keys[i] = keypair.private_key;
+    }
+
+    private_keys[0] = TEST_CURVE448_PRIVATE_KEY;
+
+    uint8_t* encrypted_string = NULL;
+    uint8_t* decrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+    size_t decrypted_string_length = 0;
+    size_t key_index = 0;
+
+    //
+
+    TEST_CHECK(0 == cecies_curve448_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE448_PUBLIC_KEY, &encrypted_string, &encrypted_string_length, 1));
+    TEST_CHECK(0 == cecies_curve448_decrypt_trial(encrypted_string, encrypted_string_length, 1, private_keys + 0, 8, 3, &key_index, &decrypted_string, &decrypted_string_length));
+    TEST_CHECK(key_index == 0);
+    TEST_CHECK(0 == memcmp(TEST_STRING, decrypted_string, sizeof(TEST_STRING)));
+
+    //
+
+    free(encrypted_string);
+    free(decrypted_string);
+}
+
+static void cecies_decrypt_trial_no_matching_key_fails_returns_CECIES_DECRYPT_ERROR_CODE_KEY_NOT_FOUND()
+{
+    cecies_curve25519_key private_keys[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        cecies_curve25519_keypair keypair;
+        TEST_ASSERT(0 == cecies_generate_curve25519_keypair(&keypair, NULL, 0));
+        private_keys[i] = keypair.private_key;
+    }
+
+    uint8_t* encrypted_string = NULL;
+    uint8_t* decrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+    size_t decrypted_string_length = 0;
+    size_t key_index = 1337;
+
+    //
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted_string, &encrypted_string_length, 0));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_KEY_NOT_FOUND == cecies_curve25519_decrypt_trial(encrypted_string, encrypted_string_length, 0, private_keys, 4, 0, &key_index, &decrypted_string, &decrypted_string_length));
+    TEST_CHECK(key_index == 1337);
+    TEST_CHECK(decrypted_string == NULL);
+
+    // A tampered ciphertext must not match any key, not even the right one.
+    private_keys[2] = TEST_CURVE25519_PRIVATE_KEY;
+    encrypted_string[encrypted_string_length - 1] ^= 0x01;
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_KEY_NOT_FOUND == cecies_curve25519_decrypt_trial(encrypted_string, encrypted_string_length, 0, private_keys, 4, 2, &key_index, &decrypted_string, &decrypted_string_length));
+
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_INVALID_ARG == cecies_curve25519_decrypt_trial(encrypted_string, encrypted_string_length, 0, private_keys, 0, 0, &key_index, &decrypted_string, &decrypted_string_length));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_NULL_ARG == cecies_curve25519_decrypt_trial(encrypted_string, encrypted_string_length, 0, NULL, 4, 0, &key_index, &decrypted_string, &decrypted_string_length));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_NULL_ARG == cecies_curve25519_decrypt_trial(encrypted_string, encrypted_string_length, 0, private_keys, 4, 0, NULL, &decrypted_string, &decrypted_string_length));
+
+    //
+
+    free(encrypted_string);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     VERIFY
+
+static void cecies_curve25519_verify_authentic_ciphertext_succeeds()
+{
+    uint8_t* encrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted_string, &encrypted_string_length, 0));
+    TEST_CHECK(0 == cecies_curve25519_verify(encrypted_string, encrypted_string_length, 0, TEST_CURVE25519_PRIVATE_KEY));
+    free(encrypted_string);
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 8, TEST_CURVE25519_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID, &encrypted_string, &encrypted_string_length, 1));
+    TEST_CHECK(0 == cecies_curve25519_verify(encrypted_string, encrypted_string_length, 1, TEST_CURVE25519_PRIVATE_KEY));
+    free(encrypted_string);
+}
+
+static void cecies_curve448_verify_authentic_ciphertext_succeeds()
+{
+    uint8_t* encrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+
+    TEST_CHECK(0 == cecies_curve448_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE448_PUBLIC_KEY, &encrypted_string, &encrypted_string_length, 1));
+    TEST_CHECK(0 == cecies_curve448_verify(encrypted_string, encrypted_string_length, 1, TEST_CURVE448_PRIVATE_KEY));
+    free(encrypted_string);
+}
+
+static void cecies_verify_tampered_ciphertext_or_wrong_key_fails_returns_CECIES_DECRYPT_ERROR_CODE_VERIFICATION_FAILED()
+{
+    uint8_t* encrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+
+    cecies_curve25519_keypair keypair25519;
+    TEST_ASSERT(0 == cecies_generate_curve25519_keypair(&keypair25519, NULL, 0));
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted_string, &encrypted_string_length, 0));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_VERIFICATION_FAILED == cecies_curve25519_verify(encrypted_string, encrypted_string_length, 0, keypair25519.private_key));
+
+    encrypted_string[encrypted_string_length - 3] ^= 0x10;
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_VERIFICATION_FAILED == cecies_curve25519_verify(encrypted_string, encrypted_string_length, 0, TEST_CURVE25519_PRIVATE_KEY));
+    encrypted_string[encrypted_string_length - 3] ^= 0x10;
+
+    // Tag
+    encrypted_string[16 + 32 + 32] ^= 0x01;
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_VERIFICATION_FAILED == cecies_curve25519_verify(encrypted_string, encrypted_string_length, 0, TEST_CURVE25519_PRIVATE_KEY));
+
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_NULL_ARG == cecies_curve25519_verify(NULL, encrypted_string_length, 0, TEST_CURVE25519_PRIVATE_KEY));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_INVALID_ARG == cecies_curve25519_verify(encrypted_string, 32, 0, TEST_CURVE25519_PRIVATE_KEY));
+
+    free(encrypted_string);
+
+    cecies_curve448_keypair keypair448;
+    TEST_ASSERT(0 == cecies_generate_curve448_keypair(&keypair448, NULL, 0));
+
+    TEST_CHECK(0 == cecies_curve448_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE448_PUBLIC_KEY, &encrypted_string, &encrypted_string_length, 0));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_VERIFICATION_FAILED == cecies_curve448_verify(encrypted_string, encrypted_string_length, 0, keypair448.private_key));
+    free(encrypted_string);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     KEY COMMITMENT
+
+static void cecies_encrypt_ext_key_commitment_decrypts_successfully()
+{
+    uint8_t* encrypted_string = NULL;
+    uint8_t* decrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+    size_t decrypted_string_length = 0;
+
+    //
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID | CECIES_HEADER_FLAG_KEY_COMMITMENT, &encrypted_string, &encrypted_string_length, 0));
+    TEST_CHECK(encrypted_string_length == CECIES_EXT_HEADER_MAGIC_SIZE + 1 + CECIES_KEY_ID_SIZE + CECIES_KEY_COMMITMENT_SIZE + cecies_curve25519_calc_output_buffer_needed_size(TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+    TEST_CHECK(0 == cecies_curve25519_decrypt(encrypted_string, encrypted_string_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted_string, &decrypted_string_length));
+    TEST_CHECK(0 == memcmp(TEST_STRING, decrypted_string, sizeof(TEST_STRING)));
+    TEST_CHECK(0 == cecies_curve25519_verify(encrypted_string, encrypted_string_length, 0, TEST_CURVE25519_PRIVATE_KEY));
+
+    free(encrypted_string);
+    free(decrypted_string);
+
+    TEST_CHECK(0 == cecies_curve448_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 6, TEST_CURVE448_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_COMMITMENT, &encrypted_string, &encrypted_string_length, 1));
+    TEST_CHECK(0 == cecies_curve448_decrypt(encrypted_string, encrypted_string_length, 1, TEST_CURVE448_PRIVATE_KEY, &decrypted_string, &decrypted_string_length));
+    TEST_CHECK(decrypted_string_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+    TEST_CHECK(0 == memcmp(TEST_STRING, decrypted_string, sizeof(TEST_STRING)));
+
+    //
+
+    free(encrypted_string);
+    free(decrypted_string);
+}
+
+static void cecies_encrypt_ext_key_commitment_wrong_key_fails_returns_CECIES_DECRYPT_ERROR_CODE_WRONG_KEY()
+{
+    uint8_t* encrypted_string = NULL;
+    uint8_t* decrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+    size_t decrypted_string_length = 0;
+    size_t key_index = 0;
+
+    cecies_curve25519_keypair keypair;
+    TEST_ASSERT(0 == cecies_generate_curve25519_keypair(&keypair, NULL, 0));
+
+    //
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_COMMITMENT, &encrypted_string, &encrypted_string_length, 0));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_WRONG_KEY == cecies_curve25519_decrypt(encrypted_string, encrypted_string_length, 0, keypair.private_key, &decrypted_string, &decrypted_string_length));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_WRONG_KEY == cecies_curve25519_verify(encrypted_string, encrypted_string_length, 0, keypair.private_key));
+    TEST_CHECK(decrypted_string == NULL);
+
+    cecies_curve25519_key private_keys[3] = { keypair.private_key, keypair.private_key, TEST_CURVE25519_PRIVATE_KEY };
+    TEST_CHECK(0 == cecies_curve25519_decrypt_trial(encrypted_string, encrypted_string_length, 0, private_keys, 3, 1, &key_index, &decrypted_string, &decrypted_string_length));
+    TEST_CHECK(key_index == 2);
+    free(decrypted_string);
+
+    // The key commitment value is authenticated along with the ciphertext too.
+    encrypted_string[CECIES_EXT_HEADER_MAGIC_SIZE + 1] ^= 0x01;
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_WRONG_KEY == cecies_curve25519_decrypt(encrypted_string, encrypted_string_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted_string, &decrypted_string_length));
+
+    //
+
+    free(encrypted_string);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     INSPECT
+
+static void cecies_inspect_plain_ciphertext_returns_correct_layout()
+{
+    uint8_t* encrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+    cecies_ciphertext_info info;
+
+    //
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted_string, &encrypted_string_length, 0));
+    TEST_CHECK(0 == cecies_inspect(encrypted_string, encrypted_string_length, 0, 0, &info));
+    TEST_CHECK(info.curve == 0);
+    TEST_CHECK(info.header_flags == 0);
+    TEST_CHECK(info.binary_length == encrypted_string_length);
+    TEST_CHECK(info.ext_header_length == 0);
+    TEST_CHECK(info.iv_offset == 0);
+    TEST_CHECK(info.salt_offset == 16);
+    TEST_CHECK(info.ephemeral_public_key_offset == 48);
+    TEST_CHECK(info.tag_offset == 48 + CECIES_X25519_KEY_SIZE);
+    TEST_CHECK(info.payload_offset == 64 + CECIES_X25519_KEY_SIZE);
+    TEST_CHECK(info.payload_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+    TEST_CHECK(info.is_compressed == -1);
+    TEST_CHECK(info.plaintext_length_bound == SIZE_MAX);
+    TEST_CHECK(info.ephemeral_public_key_length == CECIES_X25519_KEY_SIZE);
+    TEST_CHECK(0 == memcmp(info.ephemeral_public_key, encrypted_string + 48, CECIES_X25519_KEY_SIZE));
+    TEST_CHECK(!info.has_key_id && !info.has_key_commitment);
+
+    // Plain ciphertexts don't tell which curve they belong to.
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_INVALID_ARG == cecies_inspect(encrypted_string, encrypted_string_length, 0, -1, &info));
+
+    //
+
+    free(encrypted_string);
+}
+
+static void cecies_inspect_base64_ext_ciphertext_returns_same_as_binary()
+{
+    uint8_t* encrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+    uint8_t decoded[4096];
+    size_t decoded_length = 0;
+    cecies_ciphertext_info info;
+    cecies_ciphertext_info info_base64;
+
+    for (size_t length = 1; length < 8; ++length) // Different lengths produce different base64 padding.
+    {
+        TEST_CHECK(0 == cecies_curve448_encrypt_ext((uint8_t*)TEST_STRING, length, 0, TEST_CURVE448_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID | CECIES_HEADER_FLAG_KEY_COMMITMENT, &encrypted_string, &encrypted_string_length, 1));
+        TEST_CHECK(0 == mbedtls_base64_decode(decoded, sizeof(decoded), &decoded_length, encrypted_string, encrypted_string_length));
+
+        TEST_CHECK(0 == cecies_inspect(encrypted_string, encrypted_string_length, 1, -1, &info_base64));
+        TEST_CHECK(0 == cecies_inspect(decoded, decoded_length, 0, -1, &info));
+        TEST_CHECK(0 == memcmp(&info, &info_base64, sizeof(info)));
+
+        TEST_CHECK(info.curve == 1);
+        TEST_CHECK(info.header_flags == (CECIES_HEADER_FLAG_CURVE448 | CECIES_HEADER_FLAG_KEY_ID | CECIES_HEADER_FLAG_KEY_COMMITMENT));
+        TEST_CHECK(info.binary_length == decoded_length);
+        TEST_CHECK(info.ext_header_length == cecies_calc_ext_header_length(info.header_flags));
+        TEST_CHECK(info.payload_length == length);
+        TEST_CHECK(info.is_compressed == 0);
+        TEST_CHECK(info.plaintext_length_bound == length);
+        TEST_CHECK(info.has_key_id && info.has_key_commitment);
+        TEST_CHECK(0 == memcmp(info.key_id, decoded + CECIES_EXT_HEADER_MAGIC_SIZE + 1, CECIES_KEY_ID_SIZE));
+        TEST_CHECK(0 == memcmp(info.ephemeral_public_key, decoded + info.ephemeral_public_key_offset, CECIES_X448_KEY_SIZE));
+
+        free(encrypted_string);
+    }
+}
+
+static void cecies_inspect_compressed_ciphertext_has_no_plaintext_length_bound()
+{
+    uint8_t* encrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+    uint8_t* decrypted_string = NULL;
+    size_t decrypted_string_length = 0;
+    cecies_ciphertext_info info;
+
+    //
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 8, TEST_CURVE25519_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID, &encrypted_string, &encrypted_string_length, 0));
+    TEST_CHECK(0 == cecies_inspect(encrypted_string, encrypted_string_length, 0, -1, &info));
+    TEST_CHECK(info.header_flags == (CECIES_HEADER_FLAG_KEY_ID | CECIES_HEADER_FLAG_COMPRESSED));
+    TEST_CHECK(info.is_compressed == 1);
+    TEST_CHECK(info.plaintext_length_bound == SIZE_MAX);
+
+    TEST_CHECK(0 == cecies_curve25519_decrypt(encrypted_string, encrypted_string_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted_string, &decrypted_string_length));
+    TEST_CHECK(decrypted_string_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+    TEST_CHECK(0 == memcmp(decrypted_string, TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+
+    // The flag is only set by the library itself.
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG == cecies_curve25519_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, CECIES_HEADER_FLAG_COMPRESSED, &encrypted_string, &encrypted_string_length, 0));
+
+    //
+
+    free(encrypted_string);
+    free(decrypted_string);
+}
+
+static void cecies_inspect_invalid_args_fails()
+{
+    cecies_ciphertext_info info;
+
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_NULL_ARG == cecies_inspect(NULL, 100, 0, 0, &info));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_NULL_ARG == cecies_inspect((uint8_t*)TEST_STRING, sizeof(TEST_STRING), 0, 0, NULL));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_INVALID_ARG == cecies_inspect((uint8_t*)TEST_STRING, 0, 0, 0, &info));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_INVALID_ARG == cecies_inspect((uint8_t*)TEST_STRING, 20, 0, 0, &info));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_INVALID_ARG == cecies_inspect((uint8_t*)"abc", 3, 1, 0, &info));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_INVALID_ARG == cecies_inspect((uint8_t*)TEST_STRING, sizeof(TEST_STRING), 0, 2, &info));
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     STREAM
+
+static void cecies_encrypt_stream_chunked_decrypts_with_one_shot_decrypt()
+{
+    static const int flags[] = { 0, CECIES_HEADER_FLAG_KEY_ID | CECIES_HEADER_FLAG_KEY_COMMITMENT };
+
+    for (int curve = 0; curve < 2; ++curve)
+    {
+        for (size_t f = 0; f < sizeof(flags) / sizeof(flags[0]); ++f)
+        {
+            cecies_encrypt_stream* stream = NULL;
+            uint8_t ciphertext[CECIES_MAX_HEADER_SIZE + sizeof(TEST_STRING) + 64];
+            size_t header_length = 0;
+            size_t written = 0;
+            size_t ciphertext_length = 0;
+            uint8_t* decrypted = NULL;
+            size_t decrypted_length = 0;
+
+            TEST_CHECK(0 == (curve == 0 ? cecies_curve25519_encrypt_stream_init(&stream, TEST_CURVE25519_PUBLIC_KEY, flags[f], ciphertext, sizeof(ciphertext), &header_length) : cecies_curve448_encrypt_stream_init(&stream, TEST_CURVE448_PUBLIC_KEY, flags[f], ciphertext, sizeof(ciphertext), &header_length)));
+            ciphertext_length = header_length;
+
+            for (size_t i = 0, chunk = 1; i < TEST_STRING_LENGTH_WITH_NUL_TERMINATOR; i += chunk, chunk = chunk * 3 % 37 + 1)
+            {
+                const size_t n = CECIES_MIN(chunk, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR - i);
+                TEST_CHECK(0 == cecies_encrypt_stream_update(stream, (const uint8_t*)TEST_STRING + i, n, ciphertext + ciphertext_length, n + 15, &written));
+                ciphertext_length += written;
+            }
+
+            TEST_CHECK(0 == cecies_encrypt_stream_finish(stream, ciphertext + ciphertext_length, 15, &written, ciphertext));
+            ciphertext_length += written;
+            cecies_encrypt_stream_free(stream);
+
+            TEST_CHECK(ciphertext_length == header_length + TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+
+            if (curve == 0)
+            {
+                TEST_CHECK(0 == cecies_curve25519_decrypt(ciphertext, ciphertext_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted, &decrypted_length));
+            }
+            else
+            {
+                TEST_CHECK(0 == cecies_curve448_decrypt(ciphertext, ciphertext_length, 0, TEST_CURVE448_PRIVATE_KEY, &decrypted, &decrypted_length));
+            }
+
+            TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+            TEST_CHECK(decrypted != NULL && 0 == memcmp(decrypted, TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+
+            free(decrypted);
+        }
+    }
+}
+
+static void cecies_decrypt_stream_chunked_one_shot_ciphertext_succeeds()
+{
+    static const size_t chunk_sizes[] = { 1, 7, 16, 4096 };
+
+    for (size_t c = 0; c < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); ++c)
+    {
+        uint8_t* encrypted_string = NULL;
+        size_t encrypted_string_length = 0;
+        uint8_t* decrypted = NULL;
+        size_t decrypted_length = 0;
+        cecies_decrypt_stream* stream = NULL;
+
+        TEST_CHECK(0 == cecies_curve448_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE448_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_COMMITMENT, &encrypted_string, &encrypted_string_length, 0));
+        TEST_CHECK(0 == cecies_curve448_decrypt_stream_init(&stream, TEST_CURVE448_PRIVATE_KEY));
+
+        for (size_t i = 0; i < encrypted_string_length; i += chunk_sizes[c])
+        {
+            TEST_CHECK(0 == cecies_decrypt_stream_update(stream, encrypted_string + i, CECIES_MIN(chunk_sizes[c], encrypted_string_length - i)));
+        }
+
+        TEST_CHECK(0 == cecies_decrypt_stream_finish(stream, &decrypted, &decrypted_length));
+        TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+        TEST_CHECK(decrypted != NULL && 0 == memcmp(decrypted, TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+
+        cecies_decrypt_stream_free(stream);
+        free(encrypted_string);
+        free(decrypted);
+    }
+}
+
+static void cecies_decrypt_stream_length_hint_allocates_payload_once()
+{
+    const size_t length = 100 * 1024;
+    uint8_t* payload = malloc(length);
+    TEST_ASSERT(payload != NULL);
+    cecies_dev_urandom(payload, length);
+
+    uint8_t* encrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+    uint8_t* decrypted = NULL;
+    size_t decrypted_length = 0;
+    cecies_decrypt_stream* stream = NULL;
+    cecies_alloc_stats stats;
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt(payload, length, 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted_string, &encrypted_string_length, 0));
+    TEST_CHECK(0 == cecies_curve25519_decrypt_stream_init(&stream, TEST_CURVE25519_PRIVATE_KEY));
+    TEST_CHECK(0 == cecies_decrypt_stream_set_length_hint(stream, encrypted_string_length));
+
+    cecies_reset_alloc_stats();
+
+    for (size_t i = 0; i < encrypted_string_length; i += 1000)
+    {
+        TEST_CHECK(0 == cecies_decrypt_stream_update(stream, encrypted_string + i, CECIES_MIN(1000, encrypted_string_length - i)));
+    }
+
+    cecies_get_alloc_stats(&stats);
+    TEST_CHECK(stats.bytes_allocated < length + 4096);
+    TEST_MSG("%llu bytes allocated", (unsigned long long)stats.bytes_allocated);
+
+    // Too late now.
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_INVALID_ARG == cecies_decrypt_stream_set_length_hint(stream, encrypted_string_length));
+
+    TEST_CHECK(0 == cecies_decrypt_stream_finish(stream, &decrypted, &decrypted_length));
+    TEST_CHECK(decrypted_length == length);
+    TEST_CHECK(decrypted != NULL && 0 == memcmp(decrypted, payload, length));
+
+    cecies_decrypt_stream_free(stream);
+    free(encrypted_string);
+    free(decrypted);
+    free(payload);
+}
+
+static void cecies_decrypt_stream_compressed_ciphertext_decompresses()
+{
+    uint8_t* encrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+    uint8_t* decrypted = NULL;
+    size_t decrypted_length = 0;
+    cecies_decrypt_stream* stream = NULL;
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 8, TEST_CURVE25519_PUBLIC_KEY, &encrypted_string, &encrypted_string_length, 0));
+    TEST_CHECK(0 == cecies_curve25519_decrypt_stream_init(&stream, TEST_CURVE25519_PRIVATE_KEY));
+    TEST_CHECK(0 == cecies_decrypt_stream_update(stream, encrypted_string, encrypted_string_length));
+    TEST_CHECK(0 == cecies_decrypt_stream_finish(stream, &decrypted, &decrypted_length));
+    TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+    TEST_CHECK(decrypted != NULL && 0 == memcmp(decrypted, TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+
+    cecies_decrypt_stream_free(stream);
+    free(encrypted_string);
+    free(decrypted);
+}
+
+static void cecies_decrypt_stream_tampered_ciphertext_releases_nothing()
+{
+    uint8_t* encrypted_string = NULL;
+    size_t encrypted_string_length = 0;
+    uint8_t* decrypted = NULL;
+    size_t decrypted_length = 0;
+    cecies_decrypt_stream* stream = NULL;
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted_string, &encrypted_string_length, 0));
+    encrypted_string[encrypted_string_length - 1] ^= 0x01;
+
+    TEST_CHECK(0 == cecies_curve25519_decrypt_stream_init(&stream, TEST_CURVE25519_PRIVATE_KEY));
+    TEST_CHECK(0 == cecies_decrypt_stream_update(stream, encrypted_string, encrypted_string_length));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_VERIFICATION_FAILED == cecies_decrypt_stream_finish(stream, &decrypted, &decrypted_length));
+    TEST_CHECK(decrypted == NULL);
+    cecies_decrypt_stream_free(stream);
+
+    // Wrong key with key commitment: fails as soon as the header is in.
+    free(encrypted_string);
+    TEST_CHECK(0 == cecies_curve25519_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_COMMITMENT, &encrypted_string, &encrypted_string_length, 0));
+    TEST_CHECK(0 == cecies_curve25519_decrypt_stream_init(&stream, TEST_CURVE25519_PRIVATE_KEY2));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_WRONG_KEY == cecies_decrypt_stream_update(stream, encrypted_string, encrypted_string_length));
+    TEST_CHECK(0 != cecies_decrypt_stream_finish(stream, &decrypted, &decrypted_length));
+    TEST_CHECK(decrypted == NULL);
+    cecies_decrypt_stream_free(stream);
+
+    free(encrypted_string);
+}
+
+static void cecies_encrypt_stream_finish_file_patches_tag()
+{
+    FILE* file = tmpfile();
+    TEST_ASSERT(file != NULL);
+
+    cecies_encrypt_stream* stream = NULL;
+    uint8_t header[CECIES_MAX_HEADER_SIZE];
+    uint8_t chunk[64 + 15];
+    size_t header_length = 0;
+    size_t written = 0;
+    uint8_t ciphertext[CECIES_MAX_HEADER_SIZE + sizeof(TEST_STRING) + 64];
+    uint8_t* decrypted = NULL;
+    size_t decrypted_length = 0;
+
+    fputs("prefix", file);
+    const long header_position = ftell(file);
+
+    TEST_CHECK(0 == cecies_curve448_encrypt_stream_init(&stream, TEST_CURVE448_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID, header, sizeof(header), &header_length));
+    TEST_CHECK(header_length == fwrite(header, 1, header_length, file));
+
+    for (size_t i = 0; i < TEST_STRING_LENGTH_WITH_NUL_TERMINATOR; i += 64)
+    {
+        const size_t n = CECIES_MIN(64, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR - i);
+        TEST_CHECK(0 == cecies_encrypt_stream_update(stream, (const uint8_t*)TEST_STRING + i, n, chunk, sizeof(chunk), &written));
+        TEST_CHECK(written == fwrite(chunk, 1, written, file));
+    }
+
+    TEST_CHECK(0 == cecies_encrypt_stream_finish_file(stream, file, header_position));
+    TEST_CHECK(ftell(file) == header_position + (long)(header_length + TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+    cecies_encrypt_stream_free(stream);
+
+    TEST_CHECK(0 == fseek(file, header_position, SEEK_SET));
+    TEST_CHECK(header_length + TEST_STRING_LENGTH_WITH_NUL_TERMINATOR == fread(ciphertext, 1, sizeof(ciphertext), file));
+    fclose(file);
+
+    TEST_CHECK(0 == cecies_curve448_decrypt(ciphertext, header_length + TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE448_PRIVATE_KEY, &decrypted, &decrypted_length));
+    TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+    TEST_CHECK(decrypted != NULL && 0 == memcmp(decrypted, TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+
+    free(decrypted);
+}
+
+static void cecies_encrypt_stream_invalid_args_fails()
+{
+    cecies_encrypt_stream* stream = NULL;
+    uint8_t header[CECIES_MAX_HEADER_SIZE];
+    uint8_t output[16];
+    size_t header_length = 0;
+    size_t written = 0;
+
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_NULL_ARG == cecies_curve25519_encrypt_stream_init(NULL, TEST_CURVE25519_PUBLIC_KEY, 0, header, sizeof(header), &header_length));
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE == cecies_curve25519_encrypt_stream_init(&stream, TEST_CURVE25519_PUBLIC_KEY, 0, header, 16, &header_length));
+    TEST_CHECK(stream == NULL);
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt_stream_init(&stream, TEST_CURVE25519_PUBLIC_KEY, 0, header, sizeof(header), &header_length));
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE == cecies_encrypt_stream_update(stream, (const uint8_t*)TEST_STRING, 32, output, sizeof(output), &written));
+
+    // Empty plaintexts can't be encrypted (just like with cecies_curve25519_encrypt).
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG == cecies_encrypt_stream_finish(stream, output, sizeof(output), &written, header));
+    cecies_encrypt_stream_free(stream);
+
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_NULL_ARG == cecies_curve25519_decrypt_stream_init(NULL, TEST_CURVE25519_PRIVATE_KEY));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_NULL_ARG == cecies_decrypt_stream_update(NULL, output, 1));
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     CONFIG
+
+static void cecies_config_setters_change_only_their_own_fields()
+{
+    cecies_config defaults;
+    cecies_config config;
+
+    cecies_get_config(&defaults);
+    TEST_CHECK(defaults.parallel_gcm_threshold == CECIES_PARALLEL_GCM_DEFAULT_THRESHOLD);
+    TEST_CHECK(defaults.parallel_compression_threshold == CECIES_PARALLEL_COMPRESSION_DEFAULT_THRESHOLD);
+    TEST_CHECK(defaults.multi_buffer_gcm && defaults.multi_buffer_sha512 && defaults.simd_x25519_max_lanes == 8);
+
+    cecies_set_parallel_gcm(1, 3);
+    cecies_set_simd_x25519(4);
+
+    cecies_get_config(&config);
+    TEST_CHECK(config.parallel_gcm_threshold == 1 && config.parallel_gcm_thread_count == 3);
+    TEST_CHECK(config.simd_x25519_max_lanes == 4);
+    TEST_CHECK(config.parallel_compression_threshold == defaults.parallel_compression_threshold);
+    TEST_CHECK(config.multi_buffer_gcm == defaults.multi_buffer_gcm);
+
+    config.multi_buffer_sha512 = 0;
+    cecies_set_config(&config);
+    cecies_get_config(&config);
+    TEST_CHECK(config.multi_buffer_sha512 == 0 && config.parallel_gcm_thread_count == 3);
+
+    cecies_set_config(NULL);
+    cecies_get_config(&config);
+    TEST_CHECK(config.parallel_gcm_threshold == defaults.parallel_gcm_threshold && config.parallel_gcm_thread_count == defaults.parallel_gcm_thread_count);
+    TEST_CHECK(config.multi_buffer_sha512 == defaults.multi_buffer_sha512 && config.simd_x25519_max_lanes == defaults.simd_x25519_max_lanes);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     PARALLEL GCM
+
+static uint8_t* parallel_gcm_test_payload(const size_t length)
+{
+    uint8_t* payload = malloc(length);
+    if (payload != NULL)
+    {
+        cecies_dev_urandom(payload, length);
+    }
+    return payload;
+}
+
+static void cecies_parallel_gcm_encrypt_decrypts_single_threaded()
+{
+    static const size_t lengths[] = { 1024 * 1024 + 7, 3 * 1024 * 1024, 600 * 1024 + 1 };
+
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l)
+    {
+        uint8_t* payload = parallel_gcm_test_payload(lengths[l]);
+        TEST_ASSERT(payload != NULL);
+        uint8_t* encrypted = NULL;
+        size_t encrypted_length = 0;
+        uint8_t* decrypted = NULL;
+        size_t decrypted_length = 0;
+
+        cecies_set_parallel_gcm(1, 4);
+        TEST_CHECK(0 == cecies_curve448_encrypt_ext(payload, lengths[l], 0, TEST_CURVE448_PUBLIC_KEY, l % 2 ? CECIES_HEADER_FLAG_KEY_ID : 0, &encrypted, &encrypted_length, 0));
+
+        cecies_set_parallel_gcm(0, 0);
+        TEST_CHECK(0 == cecies_curve448_decrypt(encrypted, encrypted_length, 0, TEST_CURVE448_PRIVATE_KEY, &decrypted, &decrypted_length));
+        TEST_CHECK(decrypted_length == lengths[l]);
+        TEST_CHECK(decrypted != NULL && 0 == memcmp(decrypted, payload, lengths[l]));
+
+        free(payload);
+        free(encrypted);
+        free(decrypted);
+    }
+
+    cecies_set_parallel_gcm(CECIES_PARALLEL_GCM_DEFAULT_THRESHOLD, 0);
+}
+
+static void cecies_parallel_gcm_decrypt_single_threaded_ciphertext_succeeds()
+{
+    const size_t length = 2 * 1024 * 1024 + 15;
+    uint8_t* payload = parallel_gcm_test_payload(length);
+    TEST_ASSERT(payload != NULL);
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+    uint8_t* decrypted = NULL;
+    size_t decrypted_length = 0;
+
+    cecies_set_parallel_gcm(0, 0);
+    TEST_CHECK(0 == cecies_curve25519_encrypt_ext(payload, length, 0, TEST_CURVE25519_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_COMMITMENT, &encrypted, &encrypted_length, 0));
+
+    for (size_t thread_count = 2; thread_count <= 8; thread_count += 3)
+    {
+        cecies_set_parallel_gcm(1, thread_count);
+        TEST_CHECK(0 == cecies_curve25519_decrypt(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted, &decrypted_length));
+        TEST_CHECK(decrypted_length == length);
+        TEST_CHECK(decrypted != NULL && 0 == memcmp(decrypted, payload, length));
+        free(decrypted);
+        decrypted = NULL;
+    }
+
+    cecies_set_parallel_gcm(CECIES_PARALLEL_GCM_DEFAULT_THRESHOLD, 0);
+
+    free(payload);
+    free(encrypted);
+}
+
+static void cecies_parallel_gcm_decrypt_tampered_ciphertext_fails()
+{
+    const size_t length = 1024 * 1024;
+    uint8_t* payload = parallel_gcm_test_payload(length);
+    TEST_ASSERT(payload != NULL);
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+    uint8_t* decrypted = NULL;
+    size_t decrypted_length = 0;
+
+    cecies_set_parallel_gcm(1, 4);
+    TEST_CHECK(0 == cecies_curve25519_encrypt(payload, length, 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+
+    encrypted[encrypted_length / 2] ^= 0x80;
+
+    TEST_CHECK(0 != cecies_curve25519_decrypt(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted, &decrypted_length));
+    TEST_CHECK(decrypted == NULL);
+
+    cecies_set_parallel_gcm(CECIES_PARALLEL_GCM_DEFAULT_THRESHOLD, 0);
+
+    free(payload);
+    free(encrypted);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     PARALLEL COMPRESSION
+
+static uint8_t* parallel_compression_test_payload(const size_t length)
+{
+    uint8_t* payload = malloc(length);
+    if (payload != NULL)
+    {
+        // Log-like data: compressible, but not trivially so.
+        for (size_t i = 0; i < length; ++i)
+        {
+            payload[i] = (uint8_t)TEST_STRING[(i * 7 + i / 4096) % (sizeof(TEST_STRING) - 1)];
+        }
+    }
+    return payload;
+}
+
+static void cecies_parallel_compression_encrypt_decrypt_succeeds()
+{
+    static const size_t lengths[] = { 3 * 1024 * 1024 + 123, 256 * 1024, 128 * 1024 + 1 };
+
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l)
+    {
+        uint8_t* payload = parallel_compression_test_payload(lengths[l]);
+        TEST_ASSERT(payload != NULL);
+        uint8_t* encrypted = NULL;
+        size_t encrypted_length = 0;
+        uint8_t* decrypted = NULL;
+        size_t decrypted_length = 0;
+
+        cecies_set_parallel_compression(1, 3);
+        TEST_CHECK(0 == cecies_curve25519_encrypt(payload, lengths[l], 8, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+        TEST_CHECK(encrypted_length < lengths[l] / 2);
+
+        TEST_CHECK(0 == cecies_curve25519_decrypt(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted, &decrypted_length));
+        TEST_CHECK(decrypted_length == lengths[l]);
+        TEST_CHECK(decrypted != NULL && 0 == memcmp(decrypted, payload, lengths[l]));
+
+        free(payload);
+        free(encrypted);
+        free(decrypted);
+    }
+
+    cecies_set_parallel_compression(CECIES_PARALLEL_COMPRESSION_DEFAULT_THRESHOLD, 0);
+}
+
+static void cecies_parallel_compression_all_levels_decrypt_succeeds()
+{
+    const size_t length = 512 * 1024 + 77;
+    uint8_t* payload = parallel_compression_test_payload(length);
+    TEST_ASSERT(payload != NULL);
+
+    cecies_set_parallel_compression(1, 4);
+
+    for (int level = 1; level <= 9; ++level)
+    {
+        uint8_t* encrypted = NULL;
+        size_t encrypted_length = 0;
+        uint8_t* decrypted = NULL;
+        size_t decrypted_length = 0;
+
+        TEST_CHECK(0 == cecies_curve448_encrypt(payload, length, level, TEST_CURVE448_PUBLIC_KEY, &encrypted, &encrypted_length, 1));
+        TEST_CHECK(0 == cecies_curve448_decrypt(encrypted, encrypted_length, 1, TEST_CURVE448_PRIVATE_KEY, &decrypted, &decrypted_length));
+        TEST_CHECK(decrypted_length == length);
+        TEST_CHECK(decrypted != NULL && 0 == memcmp(decrypted, payload, length));
+        TEST_MSG("Compression level: %d", level);
+
+        free(encrypted);
+        free(decrypted);
+    }
+
+    cecies_set_parallel_compression(CECIES_PARALLEL_COMPRESSION_DEFAULT_THRESHOLD, 0);
+    free(payload);
+}
+
+static void cecies_compression_incompressible_and_tiny_inputs_decrypt_succeeds()
+{
+    static const size_t lengths[] = { 1, 31, 64, 5553, 2 * 1024 * 1024 + 3 };
+
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l)
+    {
+        uint8_t* payload = malloc(lengths[l]);
+        TEST_ASSERT(payload != NULL);
+        cecies_dev_urandom(payload, lengths[l]);
+
+        uint8_t* encrypted = NULL;
+        size_t encrypted_length = 0;
+        uint8_t* decrypted = NULL;
+        size_t decrypted_length = 0;
+
+        TEST_CHECK(0 == cecies_curve25519_encrypt(payload, lengths[l], 6, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+        TEST_CHECK(0 == cecies_curve25519_decrypt(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted, &decrypted_length));
+        TEST_CHECK(decrypted_length == lengths[l]);
+        TEST_CHECK(decrypted != NULL && 0 == memcmp(decrypted, payload, lengths[l]));
+        TEST_MSG("Length: %zu", lengths[l]);
+
+        free(payload);
+        free(encrypted);
+        free(decrypted);
+    }
+}
+
+static void cecies_compression_all_levels_inflate_the_same_with_zlib()
+{
+    // Log-like data with an incompressible stretch and a long run in between: every block type gets to show up.
+    const size_t length = 600 * 1024 + 5;
+    uint8_t* payload = parallel_compression_test_payload(length);
+    TEST_ASSERT(payload != NULL);
+    cecies_dev_urandom(payload + 100 * 1024, 70 * 1024);
+    memset(payload + 300 * 1024, 'x', 40 * 1024);
+
+    for (int parallel = 0; parallel < 2; ++parallel)
+    {
+        if (parallel)
+        {
+            cecies_set_parallel_compression(1, 3);
+        }
+
+        for (int level = 1; level <= 9; ++level)
+        {
+            uint8_t* encrypted = NULL;
+            size_t encrypted_length = 0;
+            uint8_t* decrypted = NULL;
+            size_t decrypted_length = 0;
+            uint8_t window[4096];
+            size_t window_length = 0;
+            size_t total = 0;
+            int equal = 1;
+            cecies_reader* reader = NULL;
+
+            TEST_CHECK(0 == cecies_curve25519_encrypt(payload, length, level, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+            TEST_CHECK(encrypted_length < length);
+
+            // One-shot decryption inflates in-tree...
+            TEST_CHECK(0 == cecies_curve25519_decrypt(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted, &decrypted_length));
+            TEST_CHECK(decrypted_length == length && decrypted != NULL && 0 == memcmp(decrypted, payload, length));
+
+            // ...while the reader goes through zlib's inflate.
+            TEST_CHECK(0 == cecies_curve25519_decrypt_reader(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, &reader));
+            TEST_ASSERT(reader != NULL);
+
+            do
+            {
+                TEST_ASSERT(0 == cecies_reader_read(reader, window, sizeof(window), &window_length));
+                TEST_ASSERT(total + window_length <= length);
+                equal &= 0 == memcmp(window, payload + total, window_length);
+                total += window_length;
+            } while (window_length != 0);
+
+            TEST_CHECK(equal && total == length);
+            TEST_MSG("Compression level: %d, parallel: %d", level, parallel);
+
+            cecies_reader_free(reader);
+            free(encrypted);
+            free(decrypted);
+        }
+    }
+
+    cecies_set_parallel_compression(CECIES_PARALLEL_COMPRESSION_DEFAULT_THRESHOLD, 0);
+    free(payload);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     READER
+
+static void cecies_reader_compressed_payload_read_in_small_windows_succeeds()
+{
+    const size_t length = 1024 * 1024 + 321;
+    uint8_t* payload = parallel_compression_test_payload(length);
+    TEST_ASSERT(payload != NULL);
+
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+    uint8_t window[1000];
+    size_t window_length = 0;
+    size_t total = 0;
+    int equal = 1;
+    cecies_reader* reader = NULL;
+
+    TEST_CHECK(0 == cecies_curve448_encrypt(payload, length, 6, TEST_CURVE448_PUBLIC_KEY, &encrypted, &encrypted_length, 1));
+    TEST_CHECK(0 == cecies_curve448_decrypt_reader(encrypted, encrypted_length, 1, TEST_CURVE448_PRIVATE_KEY, &reader));
+    TEST_ASSERT(reader != NULL);
+
+    do
+    {
+        TEST_ASSERT(0 == cecies_reader_read(reader, window, sizeof(window), &window_length));
+        TEST_ASSERT(total + window_length <= length);
+        equal &= 0 == memcmp(window, payload + total, window_length);
+        total += window_length;
+    } while (window_length != 0);
+
+    TEST_CHECK(equal);
+    TEST_CHECK(total == length);
+
+    cecies_reader_free(reader);
+    free(encrypted);
+    free(payload);
+}
+
+static void cecies_reader_uncompressed_payload_passes_through()
+{
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+    uint8_t output[512];
+    size_t output_length = 0;
+    cecies_reader* reader = NULL;
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+    TEST_CHECK(0 == cecies_curve25519_decrypt_reader(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, &reader));
+
+    TEST_CHECK(0 == cecies_reader_read(reader, output, 100, &output_length));
+    TEST_CHECK(output_length == 100);
+    TEST_CHECK(0 == cecies_reader_read(reader, output + 100, sizeof(output) - 100, &output_length));
+    TEST_CHECK(output_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR - 100);
+    TEST_CHECK(0 == memcmp(output, TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+    TEST_CHECK(0 == cecies_reader_read(reader, output, sizeof(output), &output_length));
+    TEST_CHECK(output_length == 0);
+
+    cecies_reader_free(reader);
+    free(encrypted);
+}
+
+static void cecies_reader_data_resembling_zlib_header_returned_as_is()
+{
+    const uint8_t test_data[] = { 0x78, 0x5E, 0x32, 0x55, 0x99, 0x11, 0xF4, 0x00, 0x22, 0x45, 0xBD, 0xDD };
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+    uint8_t output[64];
+    size_t output_length = 0;
+    cecies_reader* reader = NULL;
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt(test_data, sizeof(test_data), 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+    TEST_CHECK(0 == cecies_curve25519_decrypt_reader(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, &reader));
+    TEST_CHECK(0 == cecies_reader_read(reader, output, sizeof(output), &output_length));
+    TEST_CHECK(output_length == sizeof(test_data));
+    TEST_CHECK(0 == memcmp(output, test_data, sizeof(test_data)));
+
+    cecies_reader_free(reader);
+    free(encrypted);
+}
+
+static void cecies_reader_stop_early_and_free_succeeds()
+{
+    const size_t length = 256 * 1024;
+    uint8_t* payload = parallel_compression_test_payload(length);
+    TEST_ASSERT(payload != NULL);
+
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+    uint8_t output[4096];
+    size_t output_length = 0;
+    cecies_reader* reader = NULL;
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt(payload, length, 9, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+    TEST_CHECK(0 == cecies_curve25519_decrypt_reader(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, &reader));
+    TEST_CHECK(0 == cecies_reader_read(reader, output, sizeof(output), &output_length));
+    TEST_CHECK(output_length == sizeof(output));
+    TEST_CHECK(0 == memcmp(output, payload, sizeof(output)));
+
+    cecies_reader_free(reader);
+    free(encrypted);
+    free(payload);
+}
+
+static void cecies_reader_tampered_ciphertext_or_wrong_key_fails()
+{
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+    cecies_reader* reader = NULL;
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 8, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+
+    TEST_CHECK(0 != cecies_curve25519_decrypt_reader(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY2, &reader));
+    TEST_CHECK(reader == NULL);
+
+    encrypted[encrypted_length - 1] ^= 0x01;
+    TEST_CHECK(0 != cecies_curve25519_decrypt_reader(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, &reader));
+    TEST_CHECK(reader == NULL);
+
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_NULL_ARG == cecies_curve25519_decrypt_reader(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, NULL));
+
+    free(encrypted);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     IOVEC
+
+/*
+ * Splits a buffer into segments of the given lengths (the last segment gets whatever's left).
+ */
+static void iov_test_split(uint8_t* buffer, const size_t buffer_length, const size_t* lengths, const size_t count, cecies_iovec* iov)
+{
+    size_t offset = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        iov[i].iov_base = buffer + offset;
+        iov[i].iov_len = i == count - 1 ? buffer_length - offset : CECIES_MIN(lengths[i], buffer_length - offset);
+        offset += iov[i].iov_len;
+    }
+}
+
+static void cecies_curve25519_encrypt_iov_decrypts_with_one_shot_decrypt()
+{
+    static const size_t data_lengths[] = { 5, 0, 37, 221 };
+    static const size_t output_lengths[] = { 1, 50, 7, 0, 33 };
+
+    cecies_iovec data[4];
+    cecies_iovec output[5];
+    uint8_t buffer[512];
+    size_t output_length = 0;
+    uint8_t* decrypted = NULL;
+    size_t decrypted_length = 0;
+
+    iov_test_split((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, data_lengths, 4, data);
+    iov_test_split(buffer, sizeof(buffer), output_lengths, 5, output);
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt_iov(data, 4, 0, TEST_CURVE25519_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID, output, 5, &output_length));
+    TEST_CHECK(output_length == cecies_curve25519_calc_output_buffer_needed_size(TEST_STRING_LENGTH_WITH_NUL_TERMINATOR) + cecies_calc_ext_header_length(CECIES_HEADER_FLAG_KEY_ID));
+
+    TEST_CHECK(0 == cecies_curve25519_decrypt(buffer, output_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted, &decrypted_length));
+    TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+    TEST_CHECK(decrypted != NULL && 0 == memcmp(decrypted, TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+
+    free(decrypted);
+}
+
+static void cecies_curve448_encrypt_iov_compressed_decrypt_iov_succeeds()
+{
+    const size_t length = 300 * 1024 + 11;
+    uint8_t* payload = malloc(length);
+    TEST_ASSERT(payload != NULL);
+
+    // Random 3-bit symbols: compressible, but not so much that the compressed payload would be tiny.
+    cecies_dev_urandom(payload, length);
+    for (size_t i = 0; i < length; ++i)
+    {
+        payload[i] &= 0x07;
+    }
+
+    const size_t output_size = cecies_curve448_calc_output_buffer_needed_size(length);
+    uint8_t* buffer = malloc(output_size);
+    uint8_t* decrypted = malloc(length);
+    TEST_ASSERT(buffer != NULL && decrypted != NULL);
+
+    static const size_t data_lengths[] = { 64, 1000 * 17, 3 };
+    static const size_t output_lengths[] = { 3, 70, 100, 4096 + 5 };
+    static const size_t decrypted_lengths[] = { 15, 16, 17, 1024 * 100, 1 };
+
+    cecies_iovec data[4];
+    cecies_iovec output[5];
+    cecies_iovec plaintext[5];
+    size_t output_length = 0;
+    size_t decrypted_length = 0;
+
+    iov_test_split(payload, length, data_lengths, 4, data);
+    iov_test_split(buffer, output_size, output_lengths, 4, output);
+    iov_test_split(decrypted, length, decrypted_lengths, 5, plaintext);
+
+    TEST_CHECK(0 == cecies_curve448_encrypt_iov(data, 4, 6, TEST_CURVE448_PUBLIC_KEY, 0, output, 4, &output_length));
+    TEST_CHECK(output_length < length / 2);
+
+    // The ciphertext segments don't need to line up with the ones that it was written into.
+    iov_test_split(buffer, output_length, decrypted_lengths, 5, output);
+
+    cecies_alloc_stats stats;
+    cecies_reset_alloc_stats();
+
+    TEST_CHECK(0 == cecies_curve448_decrypt_iov(output, 5, TEST_CURVE448_PRIVATE_KEY, plaintext, 5, &decrypted_length));
+    TEST_CHECK(decrypted_length == length);
+    TEST_CHECK(0 == memcmp(decrypted, payload, length));
+
+    // The payload is inflated as it's decrypted: only zlib's own state is allocated, never a copy of the compressed payload.
+    cecies_get_alloc_stats(&stats);
+    TEST_CHECK(stats.bytes_allocated < 64 * 1024);
+    TEST_MSG("%llu bytes allocated for a %zu bytes long ciphertext", (unsigned long long)stats.bytes_allocated, output_length);
+
+    free(payload);
+    free(buffer);
+    free(decrypted);
+}
+
+static void cecies_curve25519_decrypt_iov_one_shot_ciphertext_succeeds()
+{
+    static const size_t encrypted_lengths[] = { 2, 29, 17, 48, 1 };
+    static const size_t output_lengths[] = { 100, 1, 1, 16 };
+
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+    uint8_t buffer[1024];
+    size_t output_length = 0;
+
+    cecies_iovec input[5];
+    cecies_iovec output[4];
+
+    for (int compress = 0; compress <= 8; compress += 8)
+    {
+        TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, compress, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+
+        iov_test_split(encrypted, encrypted_length, encrypted_lengths, 5, input);
+        iov_test_split(buffer, sizeof(buffer), output_lengths, 4, output);
+
+        TEST_CHECK(0 == cecies_curve25519_decrypt_iov(input, 5, TEST_CURVE25519_PRIVATE_KEY, output, 4, &output_length));
+        TEST_CHECK(output_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+        TEST_CHECK(0 == memcmp(buffer, TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+        TEST_MSG("Compression: %d", compress);
+
+        free(encrypted);
+        encrypted = NULL;
+    }
+
+    // Plaintext that only happens to start with a zlib header is returned as it is.
+    static const uint8_t fake_zlib[] = { 0x78, 0x9C, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0x02, 0x03, 0x04, 0x05 };
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt(fake_zlib, sizeof(fake_zlib), 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+
+    iov_test_split(encrypted, encrypted_length, encrypted_lengths, 5, input);
+    iov_test_split(buffer, sizeof(buffer), output_lengths, 4, output);
+
+    TEST_CHECK(0 == cecies_curve25519_decrypt_iov(input, 5, TEST_CURVE25519_PRIVATE_KEY, output, 4, &output_length));
+    TEST_CHECK(output_length == sizeof(fake_zlib));
+    TEST_CHECK(0 == memcmp(buffer, fake_zlib, sizeof(fake_zlib)));
+
+    free(encrypted);
+}
+
+static void cecies_iov_insufficient_output_or_tampered_ciphertext_fails()
+{
+    cecies_iovec data = { .iov_base = (void*)TEST_STRING, .iov_len = TEST_STRING_LENGTH_WITH_NUL_TERMINATOR };
+    uint8_t buffer[512];
+    uint8_t plaintext[512];
+    cecies_iovec output = { .iov_base = buffer, .iov_len = cecies_curve25519_calc_output_buffer_needed_size(TEST_STRING_LENGTH_WITH_NUL_TERMINATOR) - 1 };
+    cecies_iovec plaintext_iov = { .iov_base = plaintext, .iov_len = TEST_STRING_LENGTH_WITH_NUL_TERMINATOR - 1 };
+    size_t output_length = 0;
+
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE == cecies_curve25519_encrypt_iov(&data, 1, 0, TEST_CURVE25519_PUBLIC_KEY, 0, &output, 1, &output_length));
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_NULL_ARG == cecies_curve25519_encrypt_iov(NULL, 1, 0, TEST_CURVE25519_PUBLIC_KEY, 0, &output, 1, &output_length));
+
+    output.iov_len++;
+    TEST_CHECK(0 == cecies_curve25519_encrypt_iov(&data, 1, 0, TEST_CURVE25519_PUBLIC_KEY, 0, &output, 1, &output_length));
+    output.iov_len = output_length;
+
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE == cecies_curve25519_decrypt_iov(&output, 1, TEST_CURVE25519_PRIVATE_KEY, &plaintext_iov, 1, &output_length));
+
+    plaintext_iov.iov_len = sizeof(plaintext);
+    buffer[output.iov_len - 1] ^= 0x01;
+    memset(plaintext, 0xAB, sizeof(plaintext));
+
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_VERIFICATION_FAILED == cecies_curve25519_decrypt_iov(&output, 1, TEST_CURVE25519_PRIVATE_KEY, &plaintext_iov, 1, &output_length));
+
+    // Unauthenticated plaintext is wiped from the output segments.
+    int wiped = 1;
+    for (size_t i = 0; i < sizeof(plaintext); ++i)
+    {
+        wiped &= plaintext[i] == 0x00;
+    }
+    TEST_CHECK(wiped);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     ALLOCATOR
+
+static size_t test_allocator_allocations = 0;
+static size_t test_allocator_frees = 0;
+
+static void* test_allocator_malloc(size_t size)
+{
+    test_allocator_allocations++;
+    return malloc(size);
+}
+
+static void* test_allocator_calloc(size_t count, size_t size)
+{
+    test_allocator_allocations++;
+    return calloc(count, size);
+}
+
+static void test_allocator_free(void* mem)
+{
+    test_allocator_frees++;
+    free(mem);
+}
+
+static void cecies_set_allocator_routes_all_allocations()
+{
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+    uint8_t* decrypted = NULL;
+    size_t decrypted_length = 0;
+
+    test_allocator_allocations = test_allocator_frees = 0;
+    cecies_set_allocator(test_allocator_malloc, test_allocator_calloc, test_allocator_free);
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 8, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 1));
+    TEST_CHECK(0 == cecies_curve25519_decrypt(encrypted, encrypted_length, 1, TEST_CURVE25519_PRIVATE_KEY, &decrypted, &decrypted_length));
+    TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+    TEST_CHECK(decrypted != NULL && 0 == memcmp(decrypted, TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+
+    cecies_free(encrypted);
+    cecies_free(decrypted);
+
+    TEST_CHECK(test_allocator_allocations > 2);
+    TEST_CHECK(test_allocator_allocations == test_allocator_frees);
+
+    cecies_set_allocator(NULL, NULL, NULL);
+}
+
+static void cecies_free_returns_blocks_to_their_allocator()
+{
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+    uint8_t* decrypted = NULL;
+    size_t decrypted_length = 0;
+
+    // A block of the default allocator stays a block of the default allocator, even if a custom one is set by the time it's freed.
+    TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+
+    test_allocator_allocations = test_allocator_frees = 0;
+    cecies_set_allocator(test_allocator_malloc, test_allocator_calloc, test_allocator_free);
+    cecies_free(encrypted);
+    TEST_CHECK(test_allocator_frees == 0);
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+
+    // Switching allocators while the ciphertext is still alive: it's freed by the allocator it came from, and the new one frees its own blocks.
+    cecies_use_pool_allocator(0);
+    TEST_CHECK(0 == cecies_curve25519_decrypt(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted, &decrypted_length));
+    cecies_set_allocator(NULL, NULL, NULL);
+
+    const size_t frees = test_allocator_frees;
+    cecies_free(encrypted);
+    TEST_CHECK(test_allocator_frees == frees + 1);
+    TEST_CHECK(test_allocator_allocations == test_allocator_frees);
+
+    TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR && 0 == memcmp(decrypted, TEST_STRING, decrypted_length));
+    cecies_free(decrypted);
+    TEST_CHECK(test_allocator_frees == frees + 1);
+}
+
+static void cecies_pool_allocator_encrypt_decrypt_succeeds()
+{
+    static const size_t lengths[] = { 1, 263, 64 * 1024 - 100, 512 * 1024 + 3 };
+
+    for (int lock_pages = 0; lock_pages <= 1; ++lock_pages)
+    {
+        cecies_use_pool_allocator(lock_pages);
+
+        for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l)
+        {
+            uint8_t* payload = parallel_compression_test_payload(lengths[l]);
+            TEST_ASSERT(payload != NULL);
+
+            uint8_t* encrypted = NULL;
+            size_t encrypted_length = 0;
+            uint8_t* decrypted = NULL;
+            size_t decrypted_length = 0;
+
+            TEST_CHECK(0 == cecies_curve448_encrypt(payload, lengths[l], (int)(l % 2) * 6, TEST_CURVE448_PUBLIC_KEY, &encrypted, &encrypted_length, (int)l % 2));
+            TEST_CHECK(0 == cecies_curve448_decrypt(encrypted, encrypted_length, (int)l % 2, TEST_CURVE448_PRIVATE_KEY, &decrypted, &decrypted_length));
+            TEST_CHECK(decrypted_length == lengths[l]);
+            TEST_CHECK(decrypted != NULL && 0 == memcmp(decrypted, payload, lengths[l]));
+            TEST_MSG("Length: %zu, locked pages: %d", lengths[l], lock_pages);
+
+            cecies_free(encrypted);
+            cecies_free(decrypted);
+            free(payload);
+        }
+    }
+
+    cecies_set_allocator(NULL, NULL, NULL);
+}
+
+static void cecies_alloc_stats_count_per_thread_and_reset()
+{
+    cecies_alloc_stats stats;
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+
+    cecies_reset_alloc_stats();
+    cecies_get_alloc_stats(&stats);
+    TEST_CHECK(stats.allocations == 0 && stats.frees == 0 && stats.bytes_allocated == 0);
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+
+    cecies_get_alloc_stats(&stats);
+    TEST_CHECK(stats.allocations >= 1);
+    TEST_CHECK(stats.bytes_allocated >= encrypted_length);
+
+    cecies_free(encrypted);
+
+    cecies_get_alloc_stats(&stats);
+    TEST_CHECK(stats.frees >= 1);
+
+    cecies_reset_alloc_stats();
+    cecies_get_alloc_stats(&stats);
+    TEST_CHECK(stats.allocations == 0 && stats.frees == 0 && stats.bytes_allocated == 0);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     TO BUFFER
+
+static void cecies_curve25519_encrypt_to_buffer_roundtrip_interoperates()
+{
+    uint8_t encrypted[512];
+    size_t encrypted_length = 0;
+    uint8_t decrypted[512];
+    size_t decrypted_length = 0;
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt_to_buffer((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, TEST_CURVE25519_PUBLIC_KEY, 0, encrypted, sizeof(encrypted), &encrypted_length));
+    TEST_CHECK(encrypted_length == cecies_curve25519_calc_output_buffer_needed_size(TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+
+    TEST_CHECK(0 == cecies_curve25519_decrypt_to_buffer(encrypted, encrypted_length, TEST_CURVE25519_PRIVATE_KEY, decrypted, sizeof(decrypted), &decrypted_length));
+    TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+    TEST_CHECK(0 == memcmp(decrypted, TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+
+    // The output is a regular ciphertext, and vice versa.
+    uint8_t* allocated = NULL;
+    size_t allocated_length = 0;
+
+    TEST_CHECK(0 == cecies_curve25519_decrypt(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, &allocated, &allocated_length));
+    TEST_CHECK(allocated_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR && 0 == memcmp(allocated, TEST_STRING, allocated_length));
+    cecies_free(allocated);
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID | CECIES_HEADER_FLAG_KEY_COMMITMENT, &allocated, &allocated_length, 0));
+    TEST_CHECK(0 == cecies_curve25519_decrypt_to_buffer(allocated, allocated_length, TEST_CURVE25519_PRIVATE_KEY, decrypted, sizeof(decrypted), &decrypted_length));
+    TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR && 0 == memcmp(decrypted, TEST_STRING, decrypted_length));
+    cecies_free(allocated);
+}
+
+static void cecies_curve448_encrypt_to_buffer_roundtrip_with_ext_header()
+{
+    const int flags = CECIES_HEADER_FLAG_KEY_ID | CECIES_HEADER_FLAG_KEY_COMMITMENT;
+
+    uint8_t encrypted[512];
+    size_t encrypted_length = 0;
+    uint8_t decrypted[512];
+    size_t decrypted_length = 0;
+
+    TEST_CHECK(0 == cecies_curve448_encrypt_to_buffer((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, TEST_CURVE448_PUBLIC_KEY, flags, encrypted, sizeof(encrypted), &encrypted_length));
+    TEST_CHECK(encrypted_length == cecies_calc_ext_header_length(flags) + cecies_curve448_calc_output_buffer_needed_size(TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+
+    TEST_CHECK(0 == cecies_curve448_decrypt_to_buffer(encrypted, encrypted_length, TEST_CURVE448_PRIVATE_KEY, decrypted, sizeof(decrypted), &decrypted_length));
+    TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR && 0 == memcmp(decrypted, TEST_STRING, decrypted_length));
+
+    uint8_t* allocated = NULL;
+    size_t allocated_length = 0;
+
+    TEST_CHECK(0 == cecies_curve448_decrypt(encrypted, encrypted_length, 0, TEST_CURVE448_PRIVATE_KEY, &allocated, &allocated_length));
+    TEST_CHECK(allocated_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR && 0 == memcmp(allocated, TEST_STRING, allocated_length));
+    cecies_free(allocated);
+
+    // Wrong private key (caught by the key commitment).
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_WRONG_KEY == cecies_curve448_decrypt_to_buffer(encrypted, encrypted_length, TEST_CURVE448_PRIVATE_KEY2, decrypted, sizeof(decrypted), &decrypted_length));
+}
+
+static void cecies_encrypt_to_buffer_insufficient_or_tampered_fails()
+{
+    uint8_t encrypted[512];
+    size_t encrypted_length = 0;
+    uint8_t decrypted[512];
+    size_t decrypted_length = 0;
+
+    const size_t needed = cecies_curve25519_calc_output_buffer_needed_size(TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE == cecies_curve25519_encrypt_to_buffer((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, TEST_CURVE25519_PUBLIC_KEY, 0, encrypted, needed - 1, &encrypted_length));
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_NULL_ARG == cecies_curve25519_encrypt_to_buffer(NULL, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, TEST_CURVE25519_PUBLIC_KEY, 0, encrypted, sizeof(encrypted), &encrypted_length));
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt_to_buffer((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, TEST_CURVE25519_PUBLIC_KEY, 0, encrypted, needed, &encrypted_length));
+
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE == cecies_curve25519_decrypt_to_buffer(encrypted, encrypted_length, TEST_CURVE25519_PRIVATE_KEY, decrypted, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR - 1, &decrypted_length));
+    TEST_CHECK(0 != cecies_curve448_decrypt_to_buffer(encrypted, encrypted_length, TEST_CURVE448_PRIVATE_KEY, decrypted, sizeof(decrypted), &decrypted_length));
+
+    encrypted[encrypted_length - 7] ^= 0x01;
+    TEST_CHECK(0 != cecies_curve25519_decrypt_to_buffer(encrypted, encrypted_length, TEST_CURVE25519_PRIVATE_KEY, decrypted, sizeof(decrypted), &decrypted_length));
+    TEST_CHECK(0 != memcmp(decrypted, TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+}
+
+static void cecies_decrypt_to_buffer_rejects_compressed_payloads()
+{
+    static const uint8_t payload[4096] = { 0x00 };
+
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+    uint8_t decrypted[8192];
+    size_t decrypted_length = 0;
+
+    // Flagged as compressed in the extended header.
+    TEST_CHECK(0 == cecies_curve448_encrypt_ext(payload, sizeof(payload), 6, TEST_CURVE448_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID, &encrypted, &encrypted_length, 0));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_COMPRESSED == cecies_curve448_decrypt_to_buffer(encrypted, encrypted_length, TEST_CURVE448_PRIVATE_KEY, decrypted, sizeof(decrypted), &decrypted_length));
+    TEST_CHECK(decrypted_length < sizeof(payload) && decrypted[0] == 0x78);
+    cecies_free(encrypted);
+
+    // Plain ciphertexts are sniffed.
+    decrypted_length = 0;
+    TEST_CHECK(0 == cecies_curve25519_encrypt(payload, sizeof(payload), 6, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_COMPRESSED == cecies_curve25519_decrypt_to_buffer(encrypted, encrypted_length, TEST_CURVE25519_PRIVATE_KEY, decrypted, sizeof(decrypted), &decrypted_length));
+    TEST_CHECK(decrypted_length < sizeof(payload) && decrypted[0] == 0x78);
+    cecies_free(encrypted);
+
+    // An extended header without the flag means "not compressed", whatever the payload looks like.
+    static const uint8_t zlib_lookalike[] = { 0x78, 0x9C, 'h', 'i' };
+    TEST_CHECK(0 == cecies_curve25519_encrypt_ext(zlib_lookalike, sizeof(zlib_lookalike), 0, TEST_CURVE25519_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID, &encrypted, &encrypted_length, 0));
+    TEST_CHECK(0 == cecies_curve25519_decrypt_to_buffer(encrypted, encrypted_length, TEST_CURVE25519_PRIVATE_KEY, decrypted, sizeof(decrypted), &decrypted_length));
+    TEST_CHECK(decrypted_length == sizeof(zlib_lookalike) && 0 == memcmp(decrypted, zlib_lookalike, sizeof(zlib_lookalike)));
+    cecies_free(encrypted);
+}
+
+static void cecies_encrypt_to_buffer_does_not_allocate()
+{
+    cecies_alloc_stats stats;
+
+    uint8_t encrypted[512];
+    size_t encrypted_length = 0;
+    uint8_t decrypted[512];
+    size_t decrypted_length = 0;
+
+    cecies_reset_alloc_stats();
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt_to_buffer((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, TEST_CURVE25519_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_COMMITMENT, encrypted, sizeof(encrypted), &encrypted_length));
+    TEST_CHECK(0 == cecies_curve25519_decrypt_to_buffer(encrypted, encrypted_length, TEST_CURVE25519_PRIVATE_KEY, decrypted, sizeof(decrypted), &decrypted_length));
+
+    // Whatever was allocated (only MbedTLS' bignums, if it's built with MBEDTLS_PLATFORM_MEMORY) came from the stack arena and was given back.
+    cecies_get_alloc_stats(&stats);
+    TEST_CHECK(stats.allocations == stats.frees);
+    TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR && 0 == memcmp(decrypted, TEST_STRING, decrypted_length));
+
+    cecies_reset_alloc_stats();
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     RESTARTABLE
+
+static int restartable_run(cecies_restartable* ctx, uint8_t** output, size_t* output_length, size_t* steps)
+{
+    int ret;
+    *steps = 0;
+    do
+    {
+        ret = cecies_restartable_step(ctx, output, output_length);
+        ++*steps;
+    } while (ret == CECIES_RESTARTABLE_IN_PROGRESS);
+    return ret;
+}
+
+static void cecies_curve25519_restartable_roundtrip_succeeds()
+{
+    cecies_restartable* ctx = NULL;
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+    uint8_t* decrypted = NULL;
+    size_t decrypted_length = 0;
+    size_t steps = 0;
+
+    TEST_ASSERT(0 == cecies_curve25519_encrypt_restartable_init(&ctx, (uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, TEST_CURVE25519_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_COMMITMENT, 64, 0));
+    TEST_CHECK(0 == restartable_run(ctx, &encrypted, &encrypted_length, &steps));
+    cecies_restartable_free(ctx);
+
+    // Setup, keygen, ECDH, KDF and ceil(263 / 64) GCM steps.
+    TEST_CHECK(steps == 4 + 5);
+    TEST_MSG("Steps: %zu", steps);
+
+    TEST_CHECK(0 == cecies_curve25519_decrypt(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted, &decrypted_length));
+    TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR && 0 == memcmp(decrypted, TEST_STRING, decrypted_length));
+    cecies_free(decrypted);
+
+    TEST_ASSERT(0 == cecies_curve25519_decrypt_restartable_init(&ctx, encrypted, encrypted_length, TEST_CURVE25519_PRIVATE_KEY, 16, 0));
+    TEST_CHECK(0 == restartable_run(ctx, &decrypted, &decrypted_length, &steps));
+    cecies_restartable_free(ctx);
+
+    TEST_CHECK(steps == 3 + 17);
+    TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR && 0 == memcmp(decrypted, TEST_STRING, decrypted_length));
+
+    cecies_free(encrypted);
+    cecies_free(decrypted);
+}
+
+static void cecies_curve448_restartable_decrypts_compressed_ciphertext()
+{
+    cecies_restartable* ctx = NULL;
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+    uint8_t* decrypted = NULL;
+    size_t decrypted_length = 0;
+    size_t steps = 0;
+
+    const size_t payload_length = 300 * 1024;
+    uint8_t* payload = parallel_compression_test_payload(payload_length);
+    TEST_ASSERT(payload != NULL);
+
+    TEST_CHECK(0 == cecies_curve448_encrypt(payload, payload_length, 6, TEST_CURVE448_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+
+    TEST_ASSERT(0 == cecies_curve448_decrypt_restartable_init(&ctx, encrypted, encrypted_length, TEST_CURVE448_PRIVATE_KEY, 16 * 1024, 0));
+    TEST_CHECK(0 == restartable_run(ctx, &decrypted, &decrypted_length, &steps));
+    cecies_restartable_free(ctx);
+
+    // Setup, ECDH, KDF, at least one GCM step and then the decompression: 16 KiB of output per step.
+    TEST_CHECK(steps >= 3 + 1 + (payload_length + 16 * 1024 - 1) / (16 * 1024));
+    TEST_MSG("Steps: %zu", steps);
+
+    TEST_CHECK(decrypted_length == payload_length && 0 == memcmp(decrypted, payload, payload_length));
+    cecies_free(encrypted);
+    cecies_free(decrypted);
+
+    TEST_ASSERT(0 == cecies_curve448_encrypt_restartable_init(&ctx, payload, payload_length, TEST_CURVE448_PUBLIC_KEY, 0, 0, 0));
+    TEST_CHECK(0 == restartable_run(ctx, &encrypted, &encrypted_length, &steps));
+    cecies_restartable_free(ctx);
+
+    TEST_CHECK(steps == 4 + (payload_length + CECIES_RESTARTABLE_DEFAULT_GCM_CHUNK_SIZE - 1) / CECIES_RESTARTABLE_DEFAULT_GCM_CHUNK_SIZE);
+    TEST_CHECK(encrypted_length == cecies_curve448_calc_output_buffer_needed_size(payload_length) + cecies_calc_ext_header_length(CECIES_HEADER_FLAG_CURVE448));
+
+    TEST_CHECK(0 == cecies_curve448_decrypt(encrypted, encrypted_length, 0, TEST_CURVE448_PRIVATE_KEY, &decrypted, &decrypted_length));
+    TEST_CHECK(decrypted_length == payload_length && 0 == memcmp(decrypted, payload, payload_length));
+
+    cecies_free(encrypted);
+    cecies_free(decrypted);
+    free(payload);
+}
+
+static void cecies_ext_header_payload_starting_with_zlib_header_is_not_inflated()
+{
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+    uint8_t* decrypted = NULL;
+    size_t decrypted_length = 0;
+
+    // A real zlib stream (it inflates to TEST_STRING), taken from a compressed plain ciphertext.
+    uint8_t zlib_stream[1024];
+    size_t zlib_stream_length = 0;
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 9, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_COMPRESSED == cecies_curve25519_decrypt_to_buffer(encrypted, encrypted_length, TEST_CURVE25519_PRIVATE_KEY, zlib_stream, sizeof(zlib_stream), &zlib_stream_length));
+    TEST_ASSERT(zlib_stream_length > 2 && zlib_stream[0] == 0x78);
+    free(encrypted);
+
+    // Encrypted uncompressed as the plaintext itself into a ciphertext with an extended header: no flag, no inflating.
+    TEST_CHECK(0 == cecies_curve25519_encrypt_ext(zlib_stream, zlib_stream_length, 0, TEST_CURVE25519_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID, &encrypted, &encrypted_length, 0));
+
+    TEST_CHECK(0 == cecies_curve25519_decrypt(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted, &decrypted_length));
+    TEST_CHECK(decrypted_length == zlib_stream_length && 0 == memcmp(decrypted, zlib_stream, zlib_stream_length));
+    free(decrypted);
+    decrypted = NULL;
+
+    cecies_decrypt_stream* stream = NULL;
+    TEST_CHECK(0 == cecies_curve25519_decrypt_stream_init(&stream, TEST_CURVE25519_PRIVATE_KEY));
+    TEST_CHECK(0 == cecies_decrypt_stream_update(stream, encrypted, encrypted_length));
+    TEST_CHECK(0 == cecies_decrypt_stream_finish(stream, &decrypted, &decrypted_length));
+    TEST_CHECK(decrypted_length == zlib_stream_length && 0 == memcmp(decrypted, zlib_stream, zlib_stream_length));
+    cecies_decrypt_stream_free(stream);
+    free(decrypted);
+    decrypted = NULL;
+
+    uint8_t buffer[1024];
+    size_t buffer_length = 0;
+
+    cecies_reader* reader = NULL;
+    TEST_CHECK(0 == cecies_curve25519_decrypt_reader(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, &reader));
+    TEST_CHECK(0 == cecies_reader_read(reader, buffer, sizeof(buffer), &buffer_length));
+    TEST_CHECK(buffer_length == zlib_stream_length && 0 == memcmp(buffer, zlib_stream, zlib_stream_length));
+    cecies_reader_free(reader);
+
+    const cecies_iovec input = { .iov_base = encrypted, .iov_len = encrypted_length };
+    const cecies_iovec output = { .iov_base = buffer, .iov_len = sizeof(buffer) };
+    TEST_CHECK(0 == cecies_curve25519_decrypt_iov(&input, 1, TEST_CURVE25519_PRIVATE_KEY, &output, 1, &buffer_length));
+    TEST_CHECK(buffer_length == zlib_stream_length && 0 == memcmp(buffer, zlib_stream, zlib_stream_length));
+
+    free(encrypted);
+
+    cecies_restartable* ctx = NULL;
+    size_t steps = 0;
+
+    TEST_ASSERT(0 == cecies_curve448_encrypt_restartable_init(&ctx, zlib_stream, zlib_stream_length, TEST_CURVE448_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID, 0, 0));
+    TEST_CHECK(0 == restartable_run(ctx, &encrypted, &encrypted_length, &steps));
+    cecies_restartable_free(ctx);
+
+    TEST_ASSERT(0 == cecies_curve448_decrypt_restartable_init(&ctx, encrypted, encrypted_length, TEST_CURVE448_PRIVATE_KEY, 0, 0));
+    TEST_CHECK(0 == restartable_run(ctx, &decrypted, &decrypted_length, &steps));
+    TEST_CHECK(decrypted_length == zlib_stream_length && 0 == memcmp(decrypted, zlib_stream, zlib_stream_length));
+    cecies_restartable_free(ctx);
+    cecies_free(encrypted);
+    cecies_free(decrypted);
+
+    // The same plaintext in a legacy ciphertext can only be sniffed: it's inflated.
+    TEST_CHECK(0 == cecies_curve25519_encrypt(zlib_stream, zlib_stream_length, 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+    TEST_CHECK(0 == cecies_curve25519_decrypt(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted, &decrypted_length));
+    TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR && 0 == memcmp(decrypted, TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+    free(encrypted);
+    free(decrypted);
+}
+
+static void cecies_zlib_stream_followed_by_trailing_bytes_is_not_inflated()
+{
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+    uint8_t* decrypted = NULL;
+    size_t decrypted_length = 0;
+
+    // A complete zlib stream (it inflates to TEST_STRING) with some more bytes after its Adler-32 trailer.
+    uint8_t zlib_stream[1024];
+    size_t zlib_stream_length = 0;
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 9, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_COMPRESSED == cecies_curve25519_decrypt_to_buffer(encrypted, encrypted_length, TEST_CURVE25519_PRIVATE_KEY, zlib_stream, sizeof(zlib_stream) - 8, &zlib_stream_length));
+    TEST_ASSERT(zlib_stream_length > 2 && zlib_stream[0] == 0x78);
+    free(encrypted);
+
+    memcpy(zlib_stream + zlib_stream_length, "trailing", 8);
+    zlib_stream_length += 8;
+
+    // Legacy ciphertexts are sniffed: the stream isn't valid as a whole, so the plaintext is returned as it is.
+    TEST_CHECK(0 == cecies_curve25519_encrypt(zlib_stream, zlib_stream_length, 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+
+    TEST_CHECK(0 == cecies_curve25519_decrypt(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted, &decrypted_length));
+    TEST_CHECK(decrypted_length == zlib_stream_length && 0 == memcmp(decrypted, zlib_stream, zlib_stream_length));
+    free(decrypted);
+
+    uint8_t buffer[1024];
+    size_t buffer_length = 0;
+
+    cecies_reader* reader = NULL;
+    TEST_CHECK(0 == cecies_curve25519_decrypt_reader(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, &reader));
+    TEST_CHECK(0 == cecies_reader_read(reader, buffer, sizeof(buffer), &buffer_length));
+    TEST_CHECK(buffer_length == zlib_stream_length && 0 == memcmp(buffer, zlib_stream, zlib_stream_length));
+    cecies_reader_free(reader);
+
+    const cecies_iovec input = { .iov_base = encrypted, .iov_len = encrypted_length };
+    const cecies_iovec output = { .iov_base = buffer, .iov_len = sizeof(buffer) };
+    TEST_CHECK(0 == cecies_curve25519_decrypt_iov(&input, 1, TEST_CURVE25519_PRIVATE_KEY, &output, 1, &buffer_length));
+    TEST_CHECK(buffer_length == zlib_stream_length && 0 == memcmp(buffer, zlib_stream, zlib_stream_length));
+
+    free(encrypted);
+
+    cecies_restartable* ctx = NULL;
+    size_t steps = 0;
+
+    TEST_ASSERT(0 == cecies_curve448_encrypt_restartable_init(&ctx, zlib_stream, zlib_stream_length, TEST_CURVE448_PUBLIC_KEY, 0, 0, 0));
+    TEST_CHECK(0 == restartable_run(ctx, &encrypted, &encrypted_length, &steps));
+    cecies_restartable_free(ctx);
+
+    TEST_ASSERT(0 == cecies_curve448_decrypt_restartable_init(&ctx, encrypted, encrypted_length, TEST_CURVE448_PRIVATE_KEY, 0, 0));
+    TEST_CHECK(0 == restartable_run(ctx, &decrypted, &decrypted_length, &steps));
+    TEST_CHECK(decrypted_length == zlib_stream_length && 0 == memcmp(decrypted, zlib_stream, zlib_stream_length));
+    cecies_restartable_free(ctx);
+    cecies_free(encrypted);
+    cecies_free(decrypted);
+}
+
+static void cecies_restartable_tampered_or_wrong_key_fails_and_sticks()
+{
+    cecies_restartable* ctx = NULL;
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+    uint8_t* decrypted = NULL;
+    size_t decrypted_length = 0;
+    size_t steps = 0;
+
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_NULL_ARG == cecies_curve25519_encrypt_restartable_init(&ctx, NULL, 10, TEST_CURVE25519_PUBLIC_KEY, 0, 0, 0));
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG == cecies_curve25519_encrypt_restartable_init(&ctx, (uint8_t*)TEST_STRING, 0, TEST_CURVE25519_PUBLIC_KEY, 0, 0, 0));
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG == cecies_curve25519_encrypt_restartable_init(&ctx, (uint8_t*)TEST_STRING, 10, TEST_CURVE25519_PUBLIC_KEY, 0x80, 0, 0));
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt_ext((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_COMMITMENT, &encrypted, &encrypted_length, 0));
+
+    TEST_CHECK(0 != cecies_curve448_decrypt_restartable_init(&ctx, encrypted, encrypted_length, TEST_CURVE448_PRIVATE_KEY, 0, 0));
+
+    TEST_ASSERT(0 == cecies_curve25519_decrypt_restartable_init(&ctx, encrypted, encrypted_length, TEST_CURVE25519_PRIVATE_KEY2, 0, 0));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_WRONG_KEY == restartable_run(ctx, &decrypted, &decrypted_length, &steps));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_WRONG_KEY == cecies_restartable_step(ctx, &decrypted, &decrypted_length));
+    TEST_CHECK(decrypted == NULL);
+    cecies_restartable_free(ctx);
+
+    encrypted[encrypted_length - 1] ^= 0x80;
+
+    TEST_ASSERT(0 == cecies_curve25519_decrypt_restartable_init(&ctx, encrypted, encrypted_length, TEST_CURVE25519_PRIVATE_KEY, 32, 0));
+    TEST_CHECK(MBEDTLS_ERR_GCM_AUTH_FAILED == restartable_run(ctx, &decrypted, &decrypted_length, &steps));
+    TEST_CHECK(decrypted == NULL);
+    cecies_restartable_free(ctx);
+
+    cecies_free(encrypted);
+}
+
+static void cecies_restartable_splits_scalar_multiplications()
+{
+    cecies_restartable* ctx = NULL;
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+    uint8_t* decrypted = NULL;
+    size_t decrypted_length = 0;
+    size_t steps = 0;
+
+    TEST_ASSERT(0 == cecies_curve448_encrypt_restartable_init(&ctx, (uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, TEST_CURVE448_PUBLIC_KEY, 0, 64, 16));
+    TEST_CHECK(0 == restartable_run(ctx, &encrypted, &encrypted_length, &steps));
+    cecies_restartable_free(ctx);
+
+    // Setup, 448 / 16 keygen steps, as many ECDH steps, KDF and ceil(263 / 64) GCM steps.
+    TEST_CHECK(steps == 1 + 28 + 28 + 1 + 5);
+    TEST_MSG("Steps: %zu", steps);
+
+    TEST_CHECK(0 == cecies_curve448_decrypt(encrypted, encrypted_length, 0, TEST_CURVE448_PRIVATE_KEY, &decrypted, &decrypted_length));
+    TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR && 0 == memcmp(decrypted, TEST_STRING, decrypted_length));
+    cecies_free(decrypted);
+    decrypted = NULL;
+
+    TEST_ASSERT(0 == cecies_curve448_decrypt_restartable_init(&ctx, encrypted, encrypted_length, TEST_CURVE448_PRIVATE_KEY, 0, 100));
+    TEST_CHECK(0 == restartable_run(ctx, &decrypted, &decrypted_length, &steps));
+    cecies_restartable_free(ctx);
+
+    TEST_CHECK(steps == 1 + 5 + 1 + 1);
+    TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR && 0 == memcmp(decrypted, TEST_STRING, decrypted_length));
+    cecies_free(encrypted);
+    cecies_free(decrypted);
+    decrypted = NULL;
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+
+    TEST_ASSERT(0 == cecies_curve25519_decrypt_restartable_init(&ctx, encrypted, encrypted_length, TEST_CURVE25519_PRIVATE_KEY, 0, 1));
+    TEST_CHECK(0 == restartable_run(ctx, &decrypted, &decrypted_length, &steps));
+    cecies_restartable_free(ctx);
+
+    // One step per bit of the 255-bit scalar.
+    TEST_CHECK(steps == 1 + 255 + 1 + 1);
+    TEST_MSG("Steps: %zu", steps);
+    TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR && 0 == memcmp(decrypted, TEST_STRING, decrypted_length));
+
+    cecies_free(encrypted);
+    cecies_free(decrypted);
+}
+
+static void cecies_restartable_free_cancels_midway()
+{
+    cecies_restartable* ctx = NULL;
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+
+    cecies_restartable_free(NULL);
+
+    TEST_ASSERT(0 == cecies_curve448_encrypt_restartable_init(&ctx, (uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, TEST_CURVE448_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID, 16, 0));
+
+    for (int i = 0; i < 6; ++i)
+    {
+        TEST_CHECK(CECIES_RESTARTABLE_IN_PROGRESS == cecies_restartable_step(ctx, &encrypted, &encrypted_length));
+    }
+
+    TEST_CHECK(encrypted == NULL);
+    cecies_restartable_free(ctx);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     ASYNC
+
+static void async_decrypt_callback(cecies_async_job* job, void* user_data)
+{
+    uint8_t* decrypted = NULL;
+    size_t decrypted_length = 0;
+    *(int*)user_data = cecies_async_job_get_result(job, &decrypted, &decrypted_length) == 0 && decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR && memcmp(decrypted, TEST_STRING, decrypted_length) == 0;
+    cecies_free(decrypted);
+}
+
+static void cecies_async_encrypt_and_decrypt_many_jobs_succeeds()
+{
+    enum
+    {
+        JOB_COUNT = 64
+    };
+
+    cecies_async_pool* pool = NULL;
+    cecies_async_job* jobs[JOB_COUNT];
+    int results[JOB_COUNT];
+
+    TEST_CHECK(0 == cecies_async_pool_create(&pool, 4, 16, -1));
+
+    for (int i = 0; i < JOB_COUNT; ++i)
+    {
+        int ret;
+        if (i % 2 == 0)
+        {
+            // The queue is smaller than the batch: retry whenever it's full.
+            while ((ret = cecies_curve25519_encrypt_async(pool, (uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, i % 4 == 0 ? 6 : 0, TEST_CURVE25519_PUBLIC_KEY, 0, i % 3 == 0, NULL, NULL, &jobs[i])) == CECIES_ASYNC_ERROR_CODE_QUEUE_FULL)
+                ;
+        }
+        else
+        {
+            while ((ret = cecies_curve448_encrypt_async(pool, (uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE448_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_COMMITMENT, i % 3 == 0, NULL, NULL, &jobs[i])) == CECIES_ASYNC_ERROR_CODE_QUEUE_FULL)
+                ;
+        }
+        TEST_CHECK(ret == 0);
+    }
+
+    uint8_t* encrypted[JOB_COUNT];
+    size_t encrypted_length[JOB_COUNT];
+
+    for (int i = 0; i < JOB_COUNT; ++i)
+    {
+        TEST_CHECK(0 == cecies_async_job_wait(jobs[i]));
+        TEST_CHECK(cecies_async_job_is_done(jobs[i]));
+        TEST_CHECK(0 == cecies_async_job_get_result(jobs[i], &encrypted[i], &encrypted_length[i]));
+        cecies_async_job_free(jobs[i]);
+    }
+
+    for (int i = 0; i < JOB_COUNT; ++i)
+    {
+        results[i] = 0;
+        int ret;
+        if (i % 2 == 0)
+        {
+            while ((ret = cecies_curve25519_decrypt_async(pool, encrypted[i], encrypted_length[i], i % 3 == 0, TEST_CURVE25519_PRIVATE_KEY, async_decrypt_callback, &results[i], &jobs[i])) == CECIES_ASYNC_ERROR_CODE_QUEUE_FULL)
+                ;
+        }
+        else
+        {
+            while ((ret = cecies_curve448_decrypt_async(pool, encrypted[i], encrypted_length[i], i % 3 == 0, TEST_CURVE448_PRIVATE_KEY, async_decrypt_callback, &results[i], &jobs[i])) == CECIES_ASYNC_ERROR_CODE_QUEUE_FULL)
+                ;
+        }
+        TEST_CHECK(ret == 0);
+    }
+
+    for (int i = 0; i < JOB_COUNT; ++i)
+    {
+        TEST_CHECK(0 == cecies_async_job_wait(jobs[i]));
+        TEST_CHECK(results[i] == 1);
+        cecies_async_job_free(jobs[i]);
+        cecies_free(encrypted[i]);
+    }
+
+    cecies_async_pool_free(pool);
+}
+
+static void cecies_async_self_freeing_jobs_notify_eventfd_and_complete_before_pool_free()
+{
+    cecies_async_pool* pool = NULL;
+    int results[8] = { 0 };
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+
+#ifdef __linux__
+    const int efd = eventfd(0, 0);
+    TEST_CHECK(efd >= 0);
+#else
+    const int efd = -1;
+#endif
+
+    TEST_CHECK(0 == cecies_async_pool_create(&pool, 0, 0, efd));
+
+    for (int i = 0; i < 8; ++i)
+    {
+        // No job handle: the jobs free themselves after their callbacks.
+        TEST_CHECK(0 == cecies_curve25519_decrypt_async(pool, encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, async_decrypt_callback, &results[i], NULL));
+    }
+
+#ifdef __linux__
+    uint64_t completions = 0;
+    while (completions < 8)
+    {
+        uint64_t count = 0;
+        TEST_CHECK(read(efd, &count, sizeof(count)) == sizeof(count));
+        completions += count;
+    }
+    TEST_CHECK(completions == 8);
+    close(efd);
+#endif
+
+    cecies_async_pool_free(pool);
+
+    for (int i = 0; i < 8; ++i)
+    {
+        TEST_CHECK(results[i] == 1);
+    }
+
+    cecies_free(encrypted);
+}
+
+static void cecies_async_encrypt_file_roundtrip_succeeds()
+{
+    const char* input_path = "cecies_test_async_input.bin";
+    const char* output_25519_path = "cecies_test_async_output_25519.bin";
+    const char* output_448_path = "cecies_test_async_output_448.bin";
+
+    // A few chunks plus an odd tail, so that the read-ahead, the slot reuse and the held back GCM bytes are all exercised.
+    const size_t input_length = 6 * CECIES_ASYNC_FILE_CHUNK_SIZE + 12345;
+    uint8_t* input = malloc(input_length);
+    TEST_ASSERT(input != NULL);
+
+    for (size_t i = 0; i < input_length; ++i)
+    {
+        input[i] = (uint8_t)(i * 31 + (i >> 13));
+    }
+
+    FILE* file = fopen(input_path, "wb");
+    TEST_ASSERT(file != NULL);
+    TEST_CHECK(fwrite(input, 1, input_length, file) == input_length);
+    fclose(file);
+
+    cecies_async_pool* pool = NULL;
+    cecies_async_job* job_25519 = NULL;
+    cecies_async_job* job_448 = NULL;
+
+    TEST_CHECK(0 == cecies_async_pool_create(&pool, 2, 0, -1));
+    TEST_CHECK(0 == cecies_curve25519_encrypt_file_async(pool, input_path, output_25519_path, TEST_CURVE25519_PUBLIC_KEY, CECIES_HEADER_FLAG_KEY_ID, NULL, NULL, &job_25519));
+    TEST_CHECK(0 == cecies_curve448_encrypt_file_async(pool, input_path, output_448_path, TEST_CURVE448_PUBLIC_KEY, 0, NULL, NULL, &job_448));
+    TEST_CHECK(0 == cecies_async_job_wait(job_25519));
+    TEST_CHECK(0 == cecies_async_job_wait(job_448));
+    cecies_async_job_free(job_25519);
+    cecies_async_job_free(job_448);
+    cecies_async_pool_free(pool);
+
+    const char* output_paths[2] = { output_25519_path, output_448_path };
+
+    for (int i = 0; i < 2; ++i)
+    {
+        file = fopen(output_paths[i], "rb");
+        TEST_ASSERT(file != NULL);
+        fseek(file, 0, SEEK_END);
+        const size_t encrypted_length = (size_t)ftell(file);
+        fseek(file, 0, SEEK_SET);
+
+        uint8_t* encrypted = malloc(encrypted_length);
+        TEST_ASSERT(encrypted != NULL);
+        TEST_CHECK(fread(encrypted, 1, encrypted_length, file) == encrypted_length);
+        fclose(file);
+
+        uint8_t* decrypted = NULL;
+        size_t decrypted_length = 0;
+
+        const int ret = i == 0 ? cecies_curve25519_decrypt(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, &decrypted, &decrypted_length) : cecies_curve448_decrypt(encrypted, encrypted_length, 0, TEST_CURVE448_PRIVATE_KEY, &decrypted, &decrypted_length);
+        TEST_CHECK(ret == 0);
+        TEST_CHECK(decrypted_length == input_length);
+        TEST_CHECK(decrypted != NULL && memcmp(decrypted, input, input_length) == 0);
+
+        cecies_free(decrypted);
+        free(encrypted);
+        remove(output_paths[i]);
+    }
+
+    free(input);
+    remove(input_path);
+}
+
+static void cecies_async_invalid_args_and_missing_files_fail()
+{
+    cecies_async_pool* pool = NULL;
+    cecies_async_job* job = NULL;
+
+    TEST_CHECK(CECIES_ASYNC_ERROR_CODE_NULL_ARG == cecies_async_pool_create(NULL, 1, 0, -1));
+    TEST_CHECK(0 == cecies_async_pool_create(&pool, 1, 2, -1));
+
+    TEST_CHECK(CECIES_ASYNC_ERROR_CODE_NULL_ARG == cecies_curve25519_encrypt_async(NULL, (uint8_t*)TEST_STRING, 16, 0, TEST_CURVE25519_PUBLIC_KEY, 0, 0, NULL, NULL, &job));
+    TEST_CHECK(CECIES_ASYNC_ERROR_CODE_NULL_ARG == cecies_curve25519_encrypt_async(pool, NULL, 16, 0, TEST_CURVE25519_PUBLIC_KEY, 0, 0, NULL, NULL, &job));
+    TEST_CHECK(CECIES_ASYNC_ERROR_CODE_INVALID_ARG == cecies_curve25519_encrypt_async(pool, (uint8_t*)TEST_STRING, 0, 0, TEST_CURVE25519_PUBLIC_KEY, 0, 0, NULL, NULL, &job));
+    TEST_CHECK(CECIES_ASYNC_ERROR_CODE_INVALID_ARG == cecies_curve448_encrypt_async(pool, (uint8_t*)TEST_STRING, 16, 10, TEST_CURVE448_PUBLIC_KEY, 0, 0, NULL, NULL, &job));
+    TEST_CHECK(CECIES_ASYNC_ERROR_CODE_NULL_ARG == cecies_curve25519_decrypt_async(pool, NULL, 16, 0, TEST_CURVE25519_PRIVATE_KEY, NULL, NULL, &job));
+    TEST_CHECK(CECIES_ASYNC_ERROR_CODE_INVALID_ARG == cecies_curve25519_encrypt_file_async(pool, "same.bin", "same.bin", TEST_CURVE25519_PUBLIC_KEY, 0, NULL, NULL, &job));
+
+    // Errors of the en-/decryption itself are reported through the job.
+    TEST_CHECK(0 == cecies_curve25519_encrypt_async(pool, (uint8_t*)TEST_STRING, 16, 0, TEST_CURVE25519_PUBLIC_KEY, 0x80, 0, NULL, NULL, &job));
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG == cecies_async_job_wait(job));
+    cecies_async_job_free(job);
+
+    TEST_CHECK(0 == cecies_curve25519_decrypt_async(pool, (uint8_t*)TEST_STRING, 16, 0, TEST_CURVE25519_PRIVATE_KEY, NULL, NULL, &job));
+    TEST_CHECK(0 != cecies_async_job_wait(job));
+    cecies_async_job_free(job);
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt_file_async(pool, "cecies_test_async_nonexistent.bin", "cecies_test_async_nonexistent.out", TEST_CURVE25519_PUBLIC_KEY, 0, NULL, NULL, &job));
+    TEST_CHECK(CECIES_ASYNC_ERROR_CODE_FILE_ACCESS_FAILED == cecies_async_job_wait(job));
+    cecies_async_job_free(job);
+
+    TEST_CHECK(NULL == fopen("cecies_test_async_nonexistent.out", "rb"));
+
+    cecies_async_pool_free(pool);
+}
+
+static void async_release_in_callback(cecies_async_job* job, void* user_data)
+{
+    async_decrypt_callback(job, user_data);
+
+    // Releasing from within the callback must neither block nor free the job under the worker's feet.
+    cecies_async_job_release(job);
+}
+
+static void cecies_async_cancel_skips_pending_jobs_and_release_never_blocks()
+{
+    enum
+    {
+        JOB_COUNT = 64
+    };
+
+    cecies_async_pool* pool = NULL;
+    cecies_async_job* jobs[JOB_COUNT];
+    int results[JOB_COUNT] = { 0 };
+    uint8_t* encrypted = NULL;
+    size_t encrypted_length = 0;
+    int cancelled = 0;
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+    TEST_CHECK(CECIES_ASYNC_ERROR_CODE_NULL_ARG == cecies_async_job_cancel(NULL));
+    cecies_async_job_release(NULL);
+
+    // One worker for many jobs: most of them are still queued up when they get cancelled.
+    TEST_CHECK(0 == cecies_async_pool_create(&pool, 1, JOB_COUNT, -1));
+
+    for (int i = 0; i < JOB_COUNT; ++i)
+    {
+        TEST_CHECK(0 == cecies_curve25519_decrypt_async(pool, encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, NULL, NULL, &jobs[i]));
+    }
+
+    for (int i = 0; i < JOB_COUNT; ++i)
+    {
+        TEST_CHECK(0 == cecies_async_job_cancel(jobs[i]));
+    }
+
+    for (int i = 0; i < JOB_COUNT; ++i)
+    {
+        uint8_t* decrypted = NULL;
+        size_t decrypted_length = 0;
+
+        const int r = cecies_async_job_wait(jobs[i]);
+        TEST_CHECK(r == 0 || r == CECIES_ASYNC_ERROR_CODE_CANCELLED);
+        TEST_CHECK(r == cecies_async_job_get_result(jobs[i], &decrypted, &decrypted_length));
+        TEST_CHECK(r == 0 ? decrypted != NULL : decrypted == NULL);
+
+        cancelled += r == CECIES_ASYNC_ERROR_CODE_CANCELLED;
+        cecies_free(decrypted);
+
+        // Releasing a job that's done frees it right away.
+        cecies_async_job_release(jobs[i]);
+    }
+
+    TEST_CHECK(cancelled > 0);
+    TEST_MSG("%d out of %d jobs cancelled", cancelled, JOB_COUNT);
+
+    for (int i = 0; i < JOB_COUNT; ++i)
+    {
+        TEST_CHECK(0 == cecies_curve25519_decrypt_async(pool, encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, async_release_in_callback, &results[i], &jobs[i]));
+    }
+
+    cecies_async_pool_free(pool);
+
+    for (int i = 0; i < JOB_COUNT; ++i)
+    {
+        TEST_CHECK(results[i] == 1);
+    }
+
+    cecies_free(encrypted);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     INTEROP
+
+static void cecies_curve25519_context_into_roundtrip_interoperates()
+{
+    cecies_context* context = NULL;
+
+    uint8_t public_key[CECIES_X25519_KEY_SIZE + 1];
+    size_t public_key_length = 0;
+    TEST_CHECK(0 == cecies_hexstr2bin(TEST_CURVE25519_PUBLIC_KEY.hexstring, CECIES_X25519_KEY_SIZE * 2, public_key, sizeof(public_key), &public_key_length));
+
+    // Raw public key, hex-encoded private key (without NUL-terminator).
+    TEST_CHECK(0 == cecies_curve25519_context_create(&context, public_key, CECIES_X25519_KEY_SIZE, (const uint8_t*)TEST_CURVE25519_PRIVATE_KEY.hexstring, CECIES_X25519_KEY_SIZE * 2, 0));
+    TEST_CHECK(cecies_context_get_curve(context) == 0);
+
+    uint8_t encrypted[512];
+    size_t encrypted_length = 0;
+    uint8_t decrypted[512];
+    size_t decrypted_length = 0;
+
+    const size_t encrypted_size = cecies_context_get_encrypted_size(context, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+    TEST_CHECK(encrypted_size == cecies_curve25519_calc_output_buffer_needed_size(TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+    TEST_CHECK(encrypted_size == cecies_context_get_encrypted_size(context, 0) + TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+
+    // Reusing the context for more than one message.
+    for (int i = 0; i < 3; ++i)
+    {
+        TEST_CHECK(0 == cecies_context_encrypt_into(context, (uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, encrypted, encrypted_size, &encrypted_length));
+        TEST_CHECK(encrypted_length == encrypted_size);
+        TEST_CHECK(cecies_context_get_decrypted_size(context, encrypted, encrypted_length) == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+
+        TEST_CHECK(0 == cecies_context_decrypt_into(context, encrypted, encrypted_length, decrypted, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, &decrypted_length));
+        TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR && 0 == memcmp(decrypted, TEST_STRING, decrypted_length));
+    }
+
+    // The output is a regular ciphertext, and vice versa.
+    uint8_t* allocated = NULL;
+    size_t allocated_length = 0;
+
+    TEST_CHECK(0 == cecies_curve25519_decrypt(encrypted, encrypted_length, 0, TEST_CURVE25519_PRIVATE_KEY, &allocated, &allocated_length));
+    TEST_CHECK(allocated_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR && 0 == memcmp(allocated, TEST_STRING, allocated_length));
+    cecies_free(allocated);
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, &allocated, &allocated_length, 0));
+    TEST_CHECK(0 == cecies_context_decrypt_into(context, allocated, allocated_length, decrypted, sizeof(decrypted), &decrypted_length));
+    TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR && 0 == memcmp(decrypted, TEST_STRING, decrypted_length));
+    cecies_free(allocated);
+
+    cecies_context_free(context);
+}
+
+static void cecies_curve448_context_with_ext_header_and_single_purpose_contexts()
+{
+    const int flags = CECIES_HEADER_FLAG_KEY_ID | CECIES_HEADER_FLAG_KEY_COMMITMENT;
+
+    cecies_context* encryptor = NULL;
+    cecies_context* decryptor = NULL;
+    cecies_context* wrong_key = NULL;
+
+    TEST_CHECK(0 == cecies_curve448_context_create(&encryptor, (const uint8_t*)TEST_CURVE448_PUBLIC_KEY.hexstring, CECIES_X448_KEY_SIZE * 2, NULL, 0, flags));
+    TEST_CHECK(0 == cecies_curve448_context_create(&decryptor, NULL, 0, (const uint8_t*)TEST_CURVE448_PRIVATE_KEY.hexstring, CECIES_X448_KEY_SIZE * 2, 0));
+    TEST_CHECK(0 == cecies_curve448_context_create(&wrong_key, NULL, 0, (const uint8_t*)TEST_CURVE448_PRIVATE_KEY2.hexstring, CECIES_X448_KEY_SIZE * 2, 0));
+    TEST_CHECK(cecies_context_get_curve(encryptor) == 1);
+
+    uint8_t encrypted[512];
+    size_t encrypted_length = 0;
+    uint8_t decrypted[512];
+    size_t decrypted_length = 0;
+
+    TEST_CHECK(0 == cecies_context_encrypt_into(encryptor, (uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, encrypted, sizeof(encrypted), &encrypted_length));
+    TEST_CHECK(encrypted_length == cecies_calc_ext_header_length(flags) + cecies_curve448_calc_output_buffer_needed_size(TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+    TEST_CHECK(encrypted_length == cecies_context_get_encrypted_size(encryptor, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+
+    // Each context can only do what it has a key for.
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_INVALID_ARG == cecies_context_decrypt_into(encryptor, encrypted, encrypted_length, decrypted, sizeof(decrypted), &decrypted_length));
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG == cecies_context_encrypt_into(decryptor, (uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, encrypted, sizeof(encrypted), &encrypted_length));
+
+    TEST_CHECK(0 == cecies_context_decrypt_into(decryptor, encrypted, encrypted_length, decrypted, sizeof(decrypted), &decrypted_length));
+    TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR && 0 == memcmp(decrypted, TEST_STRING, decrypted_length));
+
+    // Wrong private key (caught by the key commitment).
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_WRONG_KEY == cecies_context_decrypt_into(wrong_key, encrypted, encrypted_length, decrypted, sizeof(decrypted), &decrypted_length));
+
+    cecies_context_free(encryptor);
+    cecies_context_free(decryptor);
+    cecies_context_free(wrong_key);
+}
+
+static void cecies_context_invalid_args_fail()
+{
+    cecies_context* context = NULL;
+
+    TEST_CHECK(CECIES_CONTEXT_ERROR_CODE_NULL_ARG == cecies_curve25519_context_create(NULL, (const uint8_t*)TEST_CURVE25519_PUBLIC_KEY.hexstring, CECIES_X25519_KEY_SIZE * 2, NULL, 0, 0));
+    TEST_CHECK(CECIES_CONTEXT_ERROR_CODE_INVALID_ARG == cecies_curve25519_context_create(&context, NULL, 0, NULL, 0, 0));
+    TEST_CHECK(CECIES_CONTEXT_ERROR_CODE_INVALID_ARG == cecies_curve25519_context_create(&context, (const uint8_t*)TEST_CURVE25519_PUBLIC_KEY.hexstring, CECIES_X25519_KEY_SIZE * 2 - 1, NULL, 0, 0));
+    TEST_CHECK(CECIES_CONTEXT_ERROR_CODE_INVALID_ARG == cecies_curve25519_context_create(&context, (const uint8_t*)"zz", 2, NULL, 0, 0));
+    TEST_CHECK(CECIES_CONTEXT_ERROR_CODE_INVALID_ARG == cecies_curve448_context_create(&context, (const uint8_t*)TEST_CURVE25519_PUBLIC_KEY.hexstring, CECIES_X25519_KEY_SIZE * 2, NULL, 0, 0));
+    TEST_CHECK(CECIES_CONTEXT_ERROR_CODE_INVALID_ARG == cecies_curve25519_context_create(&context, (const uint8_t*)TEST_CURVE25519_PUBLIC_KEY.hexstring, CECIES_X25519_KEY_SIZE * 2, NULL, 0, 0x80));
+    TEST_CHECK(context == NULL);
+
+    TEST_CHECK(cecies_context_get_curve(NULL) == -1);
+    TEST_CHECK(cecies_context_get_encrypted_size(NULL, 64) == 0);
+    cecies_context_free(NULL);
+
+    TEST_CHECK(0 == cecies_curve25519_context_create(&context, (const uint8_t*)TEST_CURVE25519_PUBLIC_KEY.hexstring, CECIES_X25519_KEY_SIZE * 2, (const uint8_t*)TEST_CURVE25519_PRIVATE_KEY.hexstring, CECIES_X25519_KEY_SIZE * 2, 0));
+
+    uint8_t encrypted[512];
+    size_t encrypted_length = 0;
+    uint8_t decrypted[512];
+    size_t decrypted_length = 0;
+
+    const size_t needed = cecies_context_get_encrypted_size(context, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_NULL_ARG == cecies_context_encrypt_into(context, NULL, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, encrypted, sizeof(encrypted), &encrypted_length));
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG == cecies_context_encrypt_into(context, (uint8_t*)TEST_STRING, 0, encrypted, sizeof(encrypted), &encrypted_length));
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE == cecies_context_encrypt_into(context, (uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, encrypted, needed - 1, &encrypted_length));
+
+    TEST_CHECK(0 == cecies_context_encrypt_into(context, (uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, encrypted, needed, &encrypted_length));
+
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE == cecies_context_decrypt_into(context, encrypted, encrypted_length, decrypted, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR - 1, &decrypted_length));
+    TEST_CHECK(cecies_context_get_decrypted_size(context, encrypted, 16) == 0);
+
+    encrypted[encrypted_length - 7] ^= 0x01;
+    TEST_CHECK(0 != cecies_context_decrypt_into(context, encrypted, encrypted_length, decrypted, sizeof(decrypted), &decrypted_length));
+
+    cecies_context_free(context);
+}
+
+static void cecies_context_batch_roundtrip_and_per_item_results()
+{
+#define BATCH_COUNT 64
+
+    cecies_context* context = NULL;
+    TEST_CHECK(0 == cecies_curve25519_context_create(&context, (const uint8_t*)TEST_CURVE25519_PUBLIC_KEY.hexstring, CECIES_X25519_KEY_SIZE * 2, (const uint8_t*)TEST_CURVE25519_PRIVATE_KEY.hexstring, CECIES_X25519_KEY_SIZE * 2, CECIES_HEADER_FLAG_KEY_COMMITMENT));
+
+    // Messages of varying lengths, back to back.
+    size_t input_lengths[BATCH_COUNT];
+    size_t input_size = 0;
+
+    for (int i = 0; i < BATCH_COUNT; ++i)
+    {
+        input_lengths[i] = 1 + (size_t)i * 7;
+        input_size += input_lengths[i];
+    }
+
+    uint8_t* input = malloc(input_size);
+    cecies_dev_urandom(input, input_size);
+
+    const size_t encrypted_size = input_size + BATCH_COUNT * cecies_context_get_encrypted_size(context, 0);
+    uint8_t* encrypted = malloc(encrypted_size);
+    uint8_t* decrypted = malloc(encrypted_size);
+
+    size_t encrypted_lengths[BATCH_COUNT];
+    size_t decrypted_lengths[BATCH_COUNT];
+    int results[BATCH_COUNT];
+
+    TEST_CHECK(0 == cecies_context_encrypt_batch(context, input, input_lengths, BATCH_COUNT, encrypted, encrypted_size, encrypted_lengths, results));
+
+    size_t total = 0;
+    for (int i = 0; i < BATCH_COUNT; ++i)
+    {
+        TEST_CHECK(results[i] == 0);
+        TEST_CHECK(encrypted_lengths[i] == cecies_context_get_encrypted_size(context, input_lengths[i]));
+        total += encrypted_lengths[i];
+    }
+    TEST_CHECK(total == encrypted_size);
+
+    TEST_CHECK(0 == cecies_context_decrypt_batch(context, encrypted, encrypted_lengths, BATCH_COUNT, decrypted, encrypted_size, decrypted_lengths, NULL));
+
+    size_t offset = 0;
+    for (int i = 0; i < BATCH_COUNT; ++i)
+    {
+        TEST_CHECK(decrypted_lengths[i] == input_lengths[i]);
+        offset += decrypted_lengths[i];
+    }
+    TEST_CHECK(offset == input_size && 0 == memcmp(decrypted, input, input_size));
+
+    // One tampered ciphertext fails on its own: the others still decrypt, packed without a gap.
+    size_t tampered_offset = 0;
+    for (int i = 0; i < 5; ++i)
+    {
+        tampered_offset += encrypted_lengths[i];
+    }
+    encrypted[tampered_offset + encrypted_lengths[5] - 1] ^= 0x01;
+
+    TEST_CHECK(MBEDTLS_ERR_GCM_AUTH_FAILED == cecies_context_decrypt_batch(context, encrypted, encrypted_lengths, BATCH_COUNT, decrypted, encrypted_size, decrypted_lengths, results));
+    TEST_CHECK(results[5] == MBEDTLS_ERR_GCM_AUTH_FAILED && decrypted_lengths[5] == 0);
+
+    offset = 0;
+    for (int i = 0, in = 0; i < BATCH_COUNT; in += input_lengths[i++])
+    {
+        if (i != 5)
+        {
+            TEST_CHECK(results[i] == 0 && decrypted_lengths[i] == input_lengths[i]);
+            TEST_CHECK(0 == memcmp(decrypted + offset, input + in, input_lengths[i]));
+        }
+        offset += decrypted_lengths[i];
+    }
+
+    // Running out of output space only fails the messages that don't fit anymore.
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE == cecies_context_encrypt_batch(context, input, input_lengths, BATCH_COUNT, encrypted, encrypted_size / 2, encrypted_lengths, results));
+    TEST_CHECK(results[0] == 0 && results[BATCH_COUNT - 1] == CECIES_ENCRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE && encrypted_lengths[BATCH_COUNT - 1] == 0);
+
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_NULL_ARG == cecies_context_encrypt_batch(context, input, NULL, BATCH_COUNT, encrypted, encrypted_size, encrypted_lengths, results));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_NULL_ARG == cecies_context_decrypt_batch(context, encrypted, encrypted_lengths, BATCH_COUNT, decrypted, encrypted_size, NULL, results));
+
+    cecies_context_free(context);
+    free(input);
+    free(encrypted);
+    free(decrypted);
+
+#undef BATCH_COUNT
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     MULTI-BUFFER GCM
+
+static void cecies_multi_buffer_gcm_batches_interoperate_with_single_message_path()
+{
+    static const size_t counts[] = { 1, 3, 8, 9, 21 };
+
+    cecies_context* context = NULL;
+    TEST_CHECK(0 == cecies_curve448_context_create(&context, (const uint8_t*)TEST_CURVE448_PUBLIC_KEY.hexstring, CECIES_X448_KEY_SIZE * 2, (const uint8_t*)TEST_CURVE448_PRIVATE_KEY.hexstring, CECIES_X448_KEY_SIZE * 2, CECIES_HEADER_FLAG_KEY_ID));
+
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+    {
+        const size_t count = counts[c];
+
+        // Lengths all over the place (partial blocks, exact blocks, very different lengths within the same group of lanes).
+        size_t input_lengths[21];
+        size_t input_size = 0;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            input_lengths[i] = 1 + (i * 37 + c * 13) % 300 + (i % 4 == 3 ? 1024 : 0);
+            input_size += input_lengths[i];
+        }
+
+        uint8_t* input = malloc(input_size);
+        cecies_dev_urandom(input, input_size);
+
+        const size_t encrypted_size = input_size + count * cecies_context_get_encrypted_size(context, 0);
+        uint8_t* encrypted = malloc(encrypted_size);
+        uint8_t* decrypted = malloc(encrypted_size);
+
+        size_t encrypted_lengths[21];
+        size_t decrypted_lengths[21];
+
+        // Multi-buffer encryption, one-at-a-time decryption and the other way around: the output is the same either way.
+        for (int enabled = 0; enabled < 2; ++enabled)
+        {
+            cecies_set_multi_buffer_gcm(enabled);
+            TEST_CHECK(0 == cecies_context_encrypt_batch(context, input, input_lengths, count, encrypted, encrypted_size, encrypted_lengths, NULL));
+
+            cecies_set_multi_buffer_gcm(!enabled);
+            memset(decrypted, 0x00, encrypted_size);
+            TEST_CHECK(0 == cecies_context_decrypt_batch(context, encrypted, encrypted_lengths, count, decrypted, encrypted_size, decrypted_lengths, NULL));
+            TEST_CHECK(0 == memcmp(decrypted, input, input_size));
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                TEST_CHECK(decrypted_lengths[i] == input_lengths[i]);
+            }
+        }
+
+        // Batch ciphertexts are regular ciphertexts.
+        uint8_t* allocated = NULL;
+        size_t allocated_length = 0;
+
+        TEST_CHECK(0 == cecies_curve448_decrypt(encrypted, encrypted_lengths[0], 0, TEST_CURVE448_PRIVATE_KEY, &allocated, &allocated_length));
+        TEST_CHECK(allocated_length == input_lengths[0] && 0 == memcmp(allocated, input, allocated_length));
+        cecies_free(allocated);
+
+        free(input);
+        free(encrypted);
+        free(decrypted);
+    }
+
+    cecies_set_multi_buffer_gcm(1);
+    cecies_context_free(context);
+}
+
+static void cecies_multi_buffer_gcm_tampered_lanes_fail_on_their_own()
+{
+#define BATCH_COUNT 16
+
+    cecies_context* context = NULL;
+    TEST_CHECK(0 == cecies_curve25519_context_create(&context, (const uint8_t*)TEST_CURVE25519_PUBLIC_KEY.hexstring, CECIES_X25519_KEY_SIZE * 2, (const uint8_t*)TEST_CURVE25519_PRIVATE_KEY.hexstring, CECIES_X25519_KEY_SIZE * 2, 0));
+
+    size_t input_lengths[BATCH_COUNT];
+    size_t input_size = 0;
+
+    for (int i = 0; i < BATCH_COUNT; ++i)
+    {
+        input_lengths[i] = 64 + (size_t)i;
+        input_size += input_lengths[i];
+    }
+
+    uint8_t* input = malloc(input_size);
+    cecies_dev_urandom(input, input_size);
+
+    const size_t encrypted_size = input_size + BATCH_COUNT * cecies_context_get_encrypted_size(context, 0);
+    uint8_t* encrypted = malloc(encrypted_size);
+    uint8_t* decrypted = malloc(encrypted_size);
+
+    size_t encrypted_lengths[BATCH_COUNT];
+    size_t decrypted_lengths[BATCH_COUNT];
+    int results[BATCH_COUNT];
+
+    TEST_CHECK(0 == cecies_context_encrypt_batch(context, input, input_lengths, BATCH_COUNT, encrypted, encrypted_size, encrypted_lengths, NULL));
+
+    // Tamper with a tag in the first group of lanes and with a ciphertext byte in the second one.
+    size_t offsets[BATCH_COUNT];
+    for (int i = 0, offset = 0; i < BATCH_COUNT; offset += (int)encrypted_lengths[i++])
+    {
+        offsets[i] = (size_t)offset;
+    }
+
+    encrypted[offsets[3] + encrypted_lengths[3] - input_lengths[3] - 1] ^= 0x80;
+    encrypted[offsets[8] + encrypted_lengths[8] - 1] ^= 0x01;
+
+    for (int enabled = 1; enabled >= 0; --enabled)
+    {
+        cecies_set_multi_buffer_gcm(enabled);
+
+        TEST_CHECK(MBEDTLS_ERR_GCM_AUTH_FAILED == cecies_context_decrypt_batch(context, encrypted, encrypted_lengths, BATCH_COUNT, decrypted, encrypted_size, decrypted_lengths, results));
+
+        size_t out = 0;
+        for (int i = 0, in = 0; i < BATCH_COUNT; in += (int)input_lengths[i++])
+        {
+            if (i == 3 || i == 8)
+            {
+                TEST_CHECK(results[i] == MBEDTLS_ERR_GCM_AUTH_FAILED && decrypted_lengths[i] == 0);
+                continue;
+            }
+
+            TEST_CHECK(results[i] == 0 && decrypted_lengths[i] == input_lengths[i]);
+            TEST_CHECK(0 == memcmp(decrypted + out, input + in, input_lengths[i]));
+            out += decrypted_lengths[i];
+        }
+    }
+
+    cecies_set_multi_buffer_gcm(1);
+    cecies_context_free(context);
+    free(input);
+    free(encrypted);
+    free(decrypted);
+
+#undef BATCH_COUNT
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     MULTI-LANE X25519
+
+static void cecies_multi_lane_x25519_batches_interoperate_with_mbedtls()
+{
+    static const size_t counts[] = { 1, 3, 4, 5, 8, 9, 17 };
+    static const size_t lanes[] = { 8, 4, 0 };
+
+    cecies_context* context = NULL;
+    TEST_CHECK(0 == cecies_curve25519_context_create(&context, (const uint8_t*)TEST_CURVE25519_PUBLIC_KEY.hexstring, CECIES_X25519_KEY_SIZE * 2, (const uint8_t*)TEST_CURVE25519_PRIVATE_KEY.hexstring, CECIES_X25519_KEY_SIZE * 2, CECIES_HEADER_FLAG_KEY_COMMITMENT));
+
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+    {
+        const size_t count = counts[c];
+
+        size_t input_lengths[17];
+        size_t input_size = 0;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            input_lengths[i] = 16 + (i * 29 + c * 7) % 200;
+            input_size += input_lengths[i];
+        }
+
+        uint8_t* input = malloc(input_size);
+        cecies_dev_urandom(input, input_size);
+
+        const size_t encrypted_size = input_size + count * cecies_context_get_encrypted_size(context, 0);
+        uint8_t* encrypted = malloc(encrypted_size);
+        uint8_t* decrypted = malloc(encrypted_size);
+
+        size_t encrypted_lengths[17];
+        size_t decrypted_lengths[17];
+
+        // Whatever the width the keys were agreed upon with when encrypting, any other width (including MbedTLS alone) decrypts it.
+        for (size_t e = 0; e < sizeof(lanes) / sizeof(lanes[0]); ++e)
+        {
+            cecies_set_simd_x25519(lanes[e]);
+            TEST_CHECK(0 == cecies_context_encrypt_batch(context, input, input_lengths, count, encrypted, encrypted_size, encrypted_lengths, NULL));
+
+            for (size_t d = 0; d < sizeof(lanes) / sizeof(lanes[0]); ++d)
+            {
+                cecies_set_simd_x25519(lanes[d]);
+                memset(decrypted, 0x00, encrypted_size);
+                TEST_CHECK(0 == cecies_context_decrypt_batch(context, encrypted, encrypted_lengths, count, decrypted, encrypted_size, decrypted_lengths, NULL));
+                TEST_CHECK(0 == memcmp(decrypted, input, input_size));
+            }
+
+            // Every single one of them is a regular ciphertext for the one-shot API too.
+            size_t offset = 0, in = 0;
+            for (size_t i = 0; i < count; in += input_lengths[i], offset += encrypted_lengths[i++])
+            {
+                uint8_t* allocated = NULL;
+                size_t allocated_length = 0;
+
+                TEST_CHECK(0 == cecies_curve25519_decrypt(encrypted + offset, encrypted_lengths[i], 0, TEST_CURVE25519_PRIVATE_KEY, &allocated, &allocated_length));
+                TEST_CHECK(allocated_length == input_lengths[i] && 0 == memcmp(allocated, input + in, allocated_length));
+                cecies_free(allocated);
+            }
+        }
+
+        // And ciphertexts from the one-shot API decrypt in a batch.
+        uint8_t* single = NULL;
+        size_t single_length = 0;
+
+        TEST_CHECK(0 == cecies_curve25519_encrypt(input, input_lengths[0], 0, TEST_CURVE25519_PUBLIC_KEY, &single, &single_length, false));
+
+        cecies_set_simd_x25519(8);
+        TEST_CHECK(0 == cecies_context_decrypt_batch(context, single, &single_length, 1, decrypted, encrypted_size, decrypted_lengths, NULL));
+        TEST_CHECK(decrypted_lengths[0] == input_lengths[0] && 0 == memcmp(decrypted, input, input_lengths[0]));
+
+        cecies_free(single);
+        free(input);
+        free(encrypted);
+        free(decrypted);
+    }
+
+    cecies_set_simd_x25519(8);
+    cecies_context_free(context);
+}
+
+static void cecies_multi_lane_x25519_wrong_key_and_bad_ephemeral_keys_fail_on_their_own()
+{
+#define BATCH_COUNT 11
+
+    cecies_context* context = NULL;
+    TEST_CHECK(0 == cecies_curve25519_context_create(&context, (const uint8_t*)TEST_CURVE25519_PUBLIC_KEY.hexstring, CECIES_X25519_KEY_SIZE * 2, (const uint8_t*)TEST_CURVE25519_PRIVATE_KEY.hexstring, CECIES_X25519_KEY_SIZE * 2, CECIES_HEADER_FLAG_KEY_COMMITMENT));
+
+    cecies_curve25519_keypair other;
+    TEST_CHECK(0 == cecies_generate_curve25519_keypair(&other, NULL, 0));
+
+    cecies_context* wrong = NULL;
+    TEST_CHECK(0 == cecies_curve25519_context_create(&wrong, NULL, 0, (const uint8_t*)other.private_key.hexstring, CECIES_X25519_KEY_SIZE * 2, 0));
+
+    size_t input_lengths[BATCH_COUNT];
+    for (int i = 0; i < BATCH_COUNT; ++i)
+    {
+        input_lengths[i] = 48;
+    }
+
+    uint8_t input[BATCH_COUNT * 48];
+    cecies_dev_urandom(input, sizeof(input));
+
+    const size_t encrypted_size = sizeof(input) + BATCH_COUNT * cecies_context_get_encrypted_size(context, 0);
+    uint8_t* encrypted = malloc(encrypted_size);
+    uint8_t* decrypted = malloc(encrypted_size);
+
+    size_t encrypted_lengths[BATCH_COUNT];
+    size_t decrypted_lengths[BATCH_COUNT];
+    int results[BATCH_COUNT];
+    int reference[BATCH_COUNT];
+
+    TEST_CHECK(0 == cecies_context_encrypt_batch(context, input, input_lengths, BATCH_COUNT, encrypted, encrypted_size, encrypted_lengths, NULL));
+
+    // Swap the ephemeral public keys of two messages for small-order points (u = 0 and u = 1).
+    const size_t encrypted_length = encrypted_lengths[0];
+    const size_t R_offset = encrypted_length - 48 - 16 - CECIES_X25519_KEY_SIZE;
+
+    memset(encrypted + 2 * encrypted_length + R_offset, 0x00, CECIES_X25519_KEY_SIZE);
+    memset(encrypted + 9 * encrypted_length + R_offset, 0x00, CECIES_X25519_KEY_SIZE);
+    encrypted[9 * encrypted_length + R_offset] = 0x01;
+
+    static const size_t lanes[] = { 0, 4, 8 };
+
+    for (size_t l = 0; l < sizeof(lanes) / sizeof(lanes[0]); ++l)
+    {
+        cecies_set_simd_x25519(lanes[l]);
+
+        TEST_CHECK(0 != cecies_context_decrypt_batch(context, encrypted, encrypted_lengths, BATCH_COUNT, decrypted, encrypted_size, decrypted_lengths, results));
+
+        size_t out = 0;
+        for (int i = 0; i < BATCH_COUNT; ++i)
+        {
+            if (i == 2 || i == 9)
+            {
+                TEST_CHECK(results[i] != 0 && decrypted_lengths[i] == 0);
+                continue;
+            }
+
+            TEST_CHECK(results[i] == 0 && decrypted_lengths[i] == 48);
+            TEST_CHECK(0 == memcmp(decrypted + out, input + i * 48, 48));
+            out += 48;
+        }
+
+        // The same messages fail the same way no matter how the key agreement was computed.
+        if (l == 0)
+        {
+            memcpy(reference, results, sizeof(results));
+        }
+        else
+        {
+            TEST_CHECK(0 == memcmp(reference, results, sizeof(results)));
+        }
+
+        TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_WRONG_KEY == cecies_context_decrypt_batch(wrong, encrypted, encrypted_lengths, BATCH_COUNT, decrypted, encrypted_size, decrypted_lengths, results));
+
+        for (int i = 0; i < BATCH_COUNT; ++i)
+        {
+            TEST_CHECK(decrypted_lengths[i] == 0);
+            TEST_CHECK(i == 2 || i == 9 || results[i] == CECIES_DECRYPT_ERROR_CODE_WRONG_KEY);
+        }
+    }
+
+    cecies_set_simd_x25519(8);
+    mbedtls_platform_zeroize(&other, sizeof(other));
+    cecies_context_free(context);
+    cecies_context_free(wrong);
+    free(encrypted);
+    free(decrypted);
+
+#undef BATCH_COUNT
+}
+
+static void cecies_multi_lane_x25519_long_queue_matches_serial_decryption()
+{
+#define BATCH_COUNT 75
+
+    cecies_context* context = NULL;
+    TEST_CHECK(0 == cecies_curve25519_context_create(&context, (const uint8_t*)TEST_CURVE25519_PUBLIC_KEY.hexstring, CECIES_X25519_KEY_SIZE * 2, (const uint8_t*)TEST_CURVE25519_PRIVATE_KEY.hexstring, CECIES_X25519_KEY_SIZE * 2, 0));
+
+    size_t input_lengths[BATCH_COUNT];
+    size_t input_size = 0;
+
+    for (int i = 0; i < BATCH_COUNT; ++i)
+    {
+        input_lengths[i] = 1 + (size_t)(i * 53 % 97);
+        input_size += input_lengths[i];
+    }
+
+    uint8_t* input = malloc(input_size);
+    cecies_dev_urandom(input, input_size);
+
+    const size_t encrypted_size = input_size + BATCH_COUNT * cecies_context_get_encrypted_size(context, 0);
+    uint8_t* encrypted = malloc(encrypted_size);
+    uint8_t* decrypted = malloc(encrypted_size);
+
+    size_t encrypted_lengths[BATCH_COUNT];
+    size_t decrypted_lengths[BATCH_COUNT];
+    int results[BATCH_COUNT];
+
+    TEST_CHECK(0 == cecies_context_encrypt_batch(context, input, input_lengths, BATCH_COUNT, encrypted, encrypted_size, encrypted_lengths, NULL));
+
+    // Small-order ephemeral keys spread over the queue: within the multi-lane X25519 these share their field inversion with valid messages,
+    // so they must neither fail anything else nor be let through themselves.
+    for (size_t i = 0, offset = 0; i < BATCH_COUNT; offset += encrypted_lengths[i++])
+    {
+        if (i % 11 == 5)
+        {
+            uint8_t* R = encrypted + offset + encrypted_lengths[i] - input_lengths[i] - 16 - CECIES_X25519_KEY_SIZE;
+            memset(R, 0x00, CECIES_X25519_KEY_SIZE);
+            R[0] = (uint8_t)(i & 1);
+        }
+    }
+
+    static const size_t lanes[] = { 8, 4 };
+
+    for (size_t l = 0; l < sizeof(lanes) / sizeof(lanes[0]); ++l)
+    {
+        cecies_set_simd_x25519(lanes[l]);
+        memset(decrypted, 0x00, encrypted_size);
+
+        TEST_CHECK(0 != cecies_context_decrypt_batch(context, encrypted, encrypted_lengths, BATCH_COUNT, decrypted, encrypted_size, decrypted_lengths, results));
+
+        // Message for message, exactly what decrypting them one by one through MbedTLS gives.
+        size_t out = 0;
+        for (size_t i = 0, offset = 0; i < BATCH_COUNT; offset += encrypted_lengths[i++])
+        {
+            uint8_t* allocated = NULL;
+            size_t allocated_length = 0;
+
+            const int ret = cecies_curve25519_decrypt(encrypted + offset, encrypted_lengths[i], 0, TEST_CURVE25519_PRIVATE_KEY, &allocated, &allocated_length);
+            TEST_CHECK((ret == 0) == (results[i] == 0));
+            TEST_CHECK((ret == 0) == (i % 11 != 5));
+
+            if (ret == 0)
+            {
+                TEST_CHECK(decrypted_lengths[i] == allocated_length && 0 == memcmp(decrypted + out, allocated, allocated_length));
+                out += decrypted_lengths[i];
+            }
+
+            cecies_free(allocated);
+        }
+    }
+
+    cecies_set_simd_x25519(8);
+    cecies_context_free(context);
+    free(input);
+    free(encrypted);
+    free(decrypted);
+
+#undef BATCH_COUNT
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     MULTI-BUFFER SHA-512
+
+static void cecies_multi_buffer_sha512_batches_interoperate_with_mbedtls_hkdf()
+{
+#define BATCH_COUNT 37
+
+    const int flags = CECIES_HEADER_FLAG_KEY_ID | CECIES_HEADER_FLAG_KEY_COMMITMENT;
+
+    cecies_context* context = NULL;
+    TEST_CHECK(0 == cecies_curve25519_context_create(&context, (const uint8_t*)TEST_CURVE25519_PUBLIC_KEY.hexstring, CECIES_X25519_KEY_SIZE * 2, (const uint8_t*)TEST_CURVE25519_PRIVATE_KEY.hexstring, CECIES_X25519_KEY_SIZE * 2, flags));
+
+    cecies_context* wrong = NULL;
+    TEST_CHECK(0 == cecies_curve25519_context_create(&wrong, NULL, 0, (const uint8_t*)TEST_CURVE25519_PRIVATE_KEY2.hexstring, CECIES_X25519_KEY_SIZE * 2, 0));
+
+    size_t input_lengths[BATCH_COUNT];
+    size_t input_size = 0;
+
+    for (int i = 0; i < BATCH_COUNT; ++i)
+    {
+        input_lengths[i] = 8 + (size_t)(i * 31 % 120);
+        input_size += input_lengths[i];
+    }
+
+    uint8_t* input = malloc(input_size);
+    cecies_dev_urandom(input, input_size);
+
+    const size_t encrypted_size = input_size + BATCH_COUNT * cecies_context_get_encrypted_size(context, 0);
+    uint8_t* encrypted = malloc(encrypted_size);
+    uint8_t* decrypted = malloc(encrypted_size);
+
+    size_t encrypted_lengths[BATCH_COUNT];
+    size_t decrypted_lengths[BATCH_COUNT];
+    int results[BATCH_COUNT];
+
+    // Keys derived by the multi-buffer HKDF on one end and by MbedTLS on the other (and vice versa) have to match byte for byte, key commitment included.
+    for (int e = 0; e < 2; ++e)
+    {
+        cecies_set_multi_buffer_sha512(e);
+        TEST_CHECK(0 == cecies_context_encrypt_batch(context, input, input_lengths, BATCH_COUNT, encrypted, encrypted_size, encrypted_lengths, NULL));
+
+        for (int d = 0; d < 2; ++d)
+        {
+            cecies_set_multi_buffer_sha512(d);
+            memset(decrypted, 0x00, encrypted_size);
+            TEST_CHECK(0 == cecies_context_decrypt_batch(context, encrypted, encrypted_lengths, BATCH_COUNT, decrypted, encrypted_size, decrypted_lengths, NULL));
+            TEST_CHECK(0 == memcmp(decrypted, input, input_size));
+
+            TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_WRONG_KEY == cecies_context_decrypt_batch(wrong, encrypted, encrypted_lengths, BATCH_COUNT, decrypted, encrypted_size, decrypted_lengths, results));
+
+            for (int i = 0; i < BATCH_COUNT; ++i)
+            {
+                TEST_CHECK(results[i] == CECIES_DECRYPT_ERROR_CODE_WRONG_KEY && decrypted_lengths[i] == 0);
+            }
+        }
+
+        size_t offset = 0, in = 0;
+        for (int i = 0; i < BATCH_COUNT; in += input_lengths[i], offset += encrypted_lengths[i++])
+        {
+            uint8_t* allocated = NULL;
+            size_t allocated_length = 0;
+
+            TEST_CHECK(0 == cecies_curve25519_decrypt(encrypted + offset, encrypted_lengths[i], 0, TEST_CURVE25519_PRIVATE_KEY, &allocated, &allocated_length));
+            TEST_CHECK(allocated_length == input_lengths[i] && 0 == memcmp(allocated, input + in, allocated_length));
+            cecies_free(allocated);
+        }
+    }
+
+    // A batch of ciphertexts with and without key commitment mixed together.
+    uint8_t* plain = NULL;
+    size_t plain_length = 0;
+
+    TEST_CHECK(0 == cecies_curve25519_encrypt(input, input_lengths[0], 0, TEST_CURVE25519_PUBLIC_KEY, &plain, &plain_length, false));
+
+    uint8_t* mixed = malloc(encrypted_lengths[0] + plain_length + encrypted_lengths[1]);
+    memcpy(mixed, encrypted, encrypted_lengths[0]);
+    memcpy(mixed + encrypted_lengths[0], plain, plain_length);
+    memcpy(mixed + encrypted_lengths[0] + plain_length, encrypted + encrypted_lengths[0], encrypted_lengths[1]);
+
+    const size_t mixed_lengths[] = { encrypted_lengths[0], plain_length, encrypted_lengths[1] };
+
+    TEST_CHECK(0 == cecies_context_decrypt_batch(context, mixed, mixed_lengths, 3, decrypted, encrypted_size, decrypted_lengths, NULL));
+    TEST_CHECK(0 == memcmp(decrypted, input, input_lengths[0]));
+    TEST_CHECK(0 == memcmp(decrypted + input_lengths[0], input, input_lengths[0]));
+    TEST_CHECK(0 == memcmp(decrypted + 2 * input_lengths[0], input + input_lengths[0], input_lengths[1]));
+
+    cecies_set_multi_buffer_sha512(1);
+    cecies_free(plain);
+    cecies_context_free(context);
+    cecies_context_free(wrong);
+    free(mixed);
+    free(input);
+    free(encrypted);
+    free(decrypted);
+
+#undef BATCH_COUNT
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     FIXED-BASE KEY GENERATION
+
+static void cecies_fixed_base_keygen_public_keys_match_their_private_keys()
+{
+    // Public keys (and the ephemeral keys of every encryption) come out of the precomputed base point tables, while decryption multiplies through MbedTLS' ladder: any mismatch fails the round trip.
+    for (int i = 0; i < 8; ++i)
+    {
+        cecies_curve25519_keypair keypair25519;
+        TEST_CHECK(0 == cecies_generate_curve25519_keypair(&keypair25519, NULL, 0));
+
+        cecies_curve448_keypair keypair448;
+        TEST_CHECK(0 == cecies_generate_curve448_keypair(&keypair448, NULL, 0));
+
+        uint8_t* encrypted = NULL;
+        uint8_t* decrypted = NULL;
+        size_t encrypted_length = 0;
+        size_t decrypted_length = 0;
+
+        TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, keypair25519.public_key, &encrypted, &encrypted_length, 0));
+        TEST_CHECK(0 == cecies_curve25519_decrypt(encrypted, encrypted_length, 0, keypair25519.private_key, &decrypted, &decrypted_length));
+        TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR && 0 == memcmp(TEST_STRING, decrypted, decrypted_length));
+
+        free(encrypted);
+        free(decrypted);
+        encrypted = decrypted = NULL;
+
+        TEST_CHECK(0 == cecies_curve448_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, keypair448.public_key, &encrypted, &encrypted_length, 0));
+        TEST_CHECK(0 == cecies_curve448_decrypt(encrypted, encrypted_length, 0, keypair448.private_key, &decrypted, &decrypted_length));
+        TEST_CHECK(decrypted_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR && 0 == memcmp(TEST_STRING, decrypted, decrypted_length));
+
+        free(encrypted);
+        free(decrypted);
+    }
+}
+
+#ifndef CECIES_DLL
+
+// Internal (see src/internal.h), but run_tests links the static library: that way the fixed-base tables can be checked against MbedTLS scalar by scalar.
+int cecies_curve25519_fixed_base(const uint8_t scalar[32], uint8_t u[32]);
+int cecies_curve448_fixed_base(const uint8_t scalar[56], uint8_t u[56]);
+
+static int cecies_fixed_base_test_rng(void* ctx, unsigned char* output, size_t output_length)
+{
+    (void)ctx;
+    cecies_dev_urandom(output, output_length);
+    return 0;
+}
+
+/*
+ * Writes the u-coordinate of k * G as computed by mbedtls_ecp_mul() into u, for any little-endian scalar k (Curve25519 ignores the top bit, just like X25519).
+ * mbedtls_ecp_mul() only takes clamped private keys though, so k is swapped for a clamped scalar d that's congruent to k or -k modulo the group order
+ * (both give the same u-coordinate). For the few k where no such d exists (e.g. 2 on Curve448), it goes through P = c * G for some clamped c first and multiplies P by d = k / c instead.
+ * Zero (the neutral element) comes out as all zeros, just like X25519 and X448 return.
+ */
+static int cecies_fixed_base_reference(const mbedtls_ecp_group_id group_id, const uint8_t* k, const size_t length, uint8_t* u)
+{
+    int ret;
+    const int cofactor = group_id == MBEDTLS_ECP_DP_CURVE25519 ? 8 : 4;
+
+    uint8_t scalar[56];
+    memcpy(scalar, k, length);
+
+    if (group_id == MBEDTLS_ECP_DP_CURVE25519)
+    {
+        scalar[31] &= 0x7f;
+    }
+
+    mbedtls_ecp_group group;
+    mbedtls_ecp_group_init(&group);
+
+    mbedtls_ecp_point P, Q;
+    mbedtls_ecp_point_init(&P);
+    mbedtls_ecp_point_init(&Q);
+
+    mbedtls_mpi r, c, e, d;
+    mbedtls_mpi_init(&r);
+    mbedtls_mpi_init(&c);
+    mbedtls_mpi_init(&e);
+    mbedtls_mpi_init(&d);
+
+    if ((ret = mbedtls_ecp_group_load(&group, group_id)) != 0 || (ret = mbedtls_mpi_read_binary_le(&r, scalar, length)) != 0 || (ret = mbedtls_mpi_mod_mpi(&r, &r, &group.N)) != 0)
+    {
+        goto exit;
+    }
+
+    if (mbedtls_mpi_cmp_int(&r, 0) == 0)
+    {
+        memset(u, 0x00, length);
+        goto exit;
+    }
+
+    for (int j = 0; j < 16; ++j)
+    {
+        if (j == 0)
+        {
+            // P = G (c = 1).
+            ret = mbedtls_ecp_copy(&P, &group.G);
+            ret = ret != 0 ? ret : mbedtls_mpi_lset(&c, 1);
+        }
+        else
+        {
+            // P = c * G, with c = cofactor * (2^(nbits - log2(cofactor)) + j): a clamped scalar.
+            ret = mbedtls_mpi_lset(&c, 0);
+            ret = ret != 0 ? ret : mbedtls_mpi_set_bit(&c, group.nbits - (cofactor == 8 ? 3 : 2), 1);
+            ret = ret != 0 ? ret : mbedtls_mpi_add_int(&c, &c, j);
+            ret = ret != 0 ? ret : mbedtls_mpi_mul_int(&c, &c, cofactor);
+            ret = ret != 0 ? ret : mbedtls_ecp_mul(&group, &P, &c, &group.G, &cecies_fixed_base_test_rng, NULL);
+        }
+
+        // e = k / (cofactor * c) (mod N), so that d = cofactor * e (or cofactor * (N - e) for -k) times P is k * G.
+        ret = ret != 0 ? ret : mbedtls_mpi_mul_int(&c, &c, cofactor);
+        ret = ret != 0 ? ret : mbedtls_mpi_inv_mod(&e, &c, &group.N);
+        ret = ret != 0 ? ret : mbedtls_mpi_mul_mpi(&e, &e, &r);
+        ret = ret != 0 ? ret : mbedtls_mpi_mod_mpi(&e, &e, &group.N);
+
+        for (int negate = 0; ret == 0 && negate <= 1; ++negate)
+        {
+            ret = negate ? mbedtls_mpi_sub_mpi(&e, &group.N, &e) : 0;
+            ret = ret != 0 ? ret : mbedtls_mpi_mul_int(&d, &e, cofactor);
+
+            if (ret == 0 && mbedtls_ecp_check_privkey(&group, &d) == 0)
+            {
+                size_t u_length;
+                ret = mbedtls_ecp_mul(&group, &Q, &d, &P, &cecies_fixed_base_test_rng, NULL);
+                ret = ret != 0 ? ret : mbedtls_ecp_point_write_binary(&group, &Q, MBEDTLS_ECP_PF_UNCOMPRESSED, &u_length, u, length);
+                goto exit;
+            }
+        }
+
+        if (ret != 0)
+        {
+            goto exit;
+        }
+    }
+
+    ret = MBEDTLS_ERR_ECP_INVALID_KEY;
+
+exit:
+    mbedtls_mpi_free(&r);
+    mbedtls_mpi_free(&c);
+    mbedtls_mpi_free(&e);
+    mbedtls_mpi_free(&d);
+    mbedtls_ecp_point_free(&P);
+    mbedtls_ecp_point_free(&Q);
+    mbedtls_ecp_group_free(&group);
+    return ret;
+}
+
+static void cecies_fixed_base_matches_mbedtls_ecp_mul_on_edge_and_random_scalars()
+{
+#define RANDOM_SCALARS 64
+
+    const mbedtls_ecp_group_id group_ids[] = { MBEDTLS_ECP_DP_CURVE25519, MBEDTLS_ECP_DP_CURVE448 };
+
+    for (size_t c = 0; c < sizeof(group_ids) / sizeof(group_ids[0]); ++c)
+    {
+        const int curve25519 = group_ids[c] == MBEDTLS_ECP_DP_CURVE25519;
+        const size_t length = curve25519 ? 32 : 56;
+
+        mbedtls_ecp_group group;
+        mbedtls_ecp_group_init(&group);
+        TEST_CHECK(0 == mbedtls_ecp_group_load(&group, group_ids[c]));
+
+        mbedtls_mpi n;
+        mbedtls_mpi_init(&n);
+
+        // 0, 1, 2, N - 1, N, N + 1, all ones, the smallest and the largest clamped scalar and then random ones; every one of them is also tried clamped.
+        uint8_t scalars[9 + RANDOM_SCALARS][56];
+        memset(scalars, 0x00, sizeof(scalars));
+
+        scalars[1][0] = 1;
+        scalars[2][0] = 2;
+
+        for (int i = -1; i <= 1; ++i)
+        {
+            TEST_CHECK(0 == mbedtls_mpi_add_int(&n, &group.N, i));
+            TEST_CHECK(0 == mbedtls_mpi_write_binary_le(&n, scalars[4 + i], length));
+        }
+
+        memset(scalars[6], 0xff, length);
+
+        scalars[7][length - 1] = curve25519 ? 0x40 : 0x80;
+
+        memset(scalars[8], 0xff, length);
+        scalars[8][0] = curve25519 ? 0xf8 : 0xfc;
+        scalars[8][length - 1] = curve25519 ? 0x7f : 0xff;
+
+        for (size_t i = 9; i < 9 + RANDOM_SCALARS; ++i)
+        {
+            cecies_dev_urandom(scalars[i], length);
+        }
+
+        for (size_t i = 0; i < 9 + RANDOM_SCALARS; ++i)
+        {
+            for (int clamp = 0; clamp <= 1; ++clamp)
+            {
+                uint8_t k[56], u[56], expected_u[56];
+                memcpy(k, scalars[i], length);
+
+                if (clamp)
+                {
+                    k[0] &= curve25519 ? 0xf8 : 0xfc;
+                    k[length - 1] = curve25519 ? (uint8_t)((k[31] & 0x7f) | 0x40) : (uint8_t)(k[55] | 0x80);
+                }
+
+#ifndef __SIZEOF_INT128__
+                // Without 128-bit integers, Curve448 keys are generated by MbedTLS itself.
+                if (!curve25519)
+                {
+                    TEST_CHECK(MBEDTLS_ERR_ECP_FEATURE_UNAVAILABLE == cecies_curve448_fixed_base(k, u));
+                    continue;
+                }
+#endif
+
+                TEST_CHECK(0 == (curve25519 ? cecies_curve25519_fixed_base(k, u) : cecies_curve448_fixed_base(k, u)));
+                TEST_CHECK(0 == cecies_fixed_base_reference(group_ids[c], k, length, expected_u));
+
+                if (!TEST_CHECK(0 == memcmp(u, expected_u, length)))
+                {
+                    TEST_MSG("Curve%s, scalar #%zu, clamped: %d", curve25519 ? "25519" : "448", i, clamp);
+                }
+            }
+        }
+
+        mbedtls_mpi_free(&n);
+        mbedtls_ecp_group_free(&group);
+    }
+
+#undef RANDOM_SCALARS
+}
+
+#endif
+
+// -----------------------------------------------------------------------------------------------------------------------     KEY ENCAPSULATION
+
+static void cecies_kem_encapsulated_keys_decapsulate_to_the_same_key()
+{
+    uint8_t R25519[CECIES_X25519_KEY_SIZE], R448[CECIES_X448_KEY_SIZE];
+    uint8_t salt[CECIES_KEM_SALT_SIZE];
+    uint8_t key[CECIES_KEM_KEY_SIZE], decapsulated_key[CECIES_KEM_KEY_SIZE];
+
+    TEST_CHECK(0 == cecies_curve25519_encapsulate(TEST_CURVE25519_PUBLIC_KEY, R25519, salt, key));
+    TEST_CHECK(0 == cecies_curve25519_decapsulate(TEST_CURVE25519_PRIVATE_KEY, R25519, salt, decapsulated_key));
+    TEST_CHECK(0 == memcmp(key, decapsulated_key, sizeof(key)));
+
+    // A wrong key just derives something else.
+    TEST_CHECK(0 == cecies_curve25519_decapsulate(TEST_CURVE25519_PRIVATE_KEY2, R25519, salt, decapsulated_key));
+    TEST_CHECK(0 != memcmp(key, decapsulated_key, sizeof(key)));
+
+    salt[0] ^= 0x01;
+    TEST_CHECK(0 == cecies_curve25519_decapsulate(TEST_CURVE25519_PRIVATE_KEY, R25519, salt, decapsulated_key));
+    TEST_CHECK(0 != memcmp(key, decapsulated_key, sizeof(key)));
+
+    TEST_CHECK(0 == cecies_curve448_encapsulate(TEST_CURVE448_PUBLIC_KEY, R448, salt, key));
+    TEST_CHECK(0 == cecies_curve448_decapsulate(TEST_CURVE448_PRIVATE_KEY, R448, salt, decapsulated_key));
+    TEST_CHECK(0 == memcmp(key, decapsulated_key, sizeof(key)));
+
+    TEST_CHECK(0 == cecies_curve448_decapsulate(TEST_CURVE448_PRIVATE_KEY2, R448, salt, decapsulated_key));
+    TEST_CHECK(0 != memcmp(key, decapsulated_key, sizeof(key)));
+
+    // Every encapsulation comes with a fresh ephemeral key and salt.
+    uint8_t R448_2[CECIES_X448_KEY_SIZE], salt2[CECIES_KEM_SALT_SIZE];
+    TEST_CHECK(0 == cecies_curve448_encapsulate(TEST_CURVE448_PUBLIC_KEY, R448_2, salt2, decapsulated_key));
+    TEST_CHECK(0 != memcmp(R448, R448_2, sizeof(R448)) && 0 != memcmp(salt, salt2, sizeof(salt)) && 0 != memcmp(key, decapsulated_key, sizeof(key)));
+}
+
+static void cecies_kem_invalid_args_fail_and_zero_the_key()
+{
+    uint8_t R[CECIES_X25519_KEY_SIZE];
+    uint8_t salt[CECIES_KEM_SALT_SIZE];
+    uint8_t key[CECIES_KEM_KEY_SIZE];
+    uint8_t zeros[CECIES_KEM_KEY_SIZE] = { 0x00 };
+
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_NULL_ARG == cecies_curve25519_encapsulate(TEST_CURVE25519_PUBLIC_KEY, NULL, salt, key));
+    TEST_CHECK(CECIES_ENCRYPT_ERROR_CODE_NULL_ARG == cecies_curve25519_encapsulate(TEST_CURVE25519_PUBLIC_KEY, R, salt, NULL));
+    TEST_CHECK(CECIES_DECRYPT_ERROR_CODE_NULL_ARG == cecies_curve25519_decapsulate(TEST_CURVE25519_PRIVATE_KEY, R, NULL, key));
+
+    TEST_CHECK(0 == cecies_curve25519_encapsulate(TEST_CURVE25519_PUBLIC_KEY, R, salt, key));
+
+    // Not a clamped Curve25519 scalar (the lowest 3 bits are set).
+    cecies_curve25519_key invalid_key = TEST_CURVE25519_PRIVATE_KEY;
+    invalid_key.hexstring[63] = '7';
+
+    TEST_CHECK(0 != cecies_curve25519_decapsulate(invalid_key, R, salt, key));
+    TEST_CHECK(0 == memcmp(key, zeros, sizeof(key)));
+}
+
+static void cecies_kem_decapsulated_key_decrypts_regular_ciphertexts()
+{
+    // cecies_*_encrypt() derives its AES key exactly like the KEM does: decapsulating a ciphertext's R and salt gives the key to open its AES-GCM payload with.
+    for (int curve = 0; curve < 2; ++curve)
+    {
+        uint8_t* encrypted = NULL;
+        size_t encrypted_length = 0;
+
+        if (curve == 0)
+        {
+            TEST_CHECK(0 == cecies_curve25519_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE25519_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+        }
+        else
+        {
+            TEST_CHECK(0 == cecies_curve448_encrypt((uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR, 0, TEST_CURVE448_PUBLIC_KEY, &encrypted, &encrypted_length, 0));
+        }
+
+        cecies_ciphertext_info info;
+        TEST_CHECK(0 == cecies_inspect(encrypted, encrypted_length, 0, curve, &info));
+
+        uint8_t key[CECIES_KEM_KEY_SIZE];
+        if (curve == 0)
+        {
+            TEST_CHECK(0 == cecies_curve25519_decapsulate(TEST_CURVE25519_PRIVATE_KEY, encrypted + info.ephemeral_public_key_offset, encrypted + info.salt_offset, key));
+        }
+        else
+        {
+            TEST_CHECK(0 == cecies_curve448_decapsulate(TEST_CURVE448_PRIVATE_KEY, encrypted + info.ephemeral_public_key_offset, encrypted + info.salt_offset, key));
+        }
+
+        uint8_t decrypted[512];
+        TEST_CHECK(info.payload_length == TEST_STRING_LENGTH_WITH_NUL_TERMINATOR);
+
+        mbedtls_gcm_context gcm;
+        mbedtls_gcm_init(&gcm);
+        TEST_CHECK(0 == mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, key, 256));
+        TEST_CHECK(0 == mbedtls_gcm_auth_decrypt(&gcm, info.payload_length, encrypted + info.iv_offset, 16, NULL, 0, encrypted + info.tag_offset, 16, encrypted + info.payload_offset, decrypted));
+        TEST_CHECK(0 == memcmp(decrypted, TEST_STRING, TEST_STRING_LENGTH_WITH_NUL_TERMINATOR));
+        mbedtls_gcm_free(&gcm);
+
+        free(encrypted);
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------     ED25519
+
+static void cecies_ed25519_rfc8032_test_vectors_match()
+{
+    // RFC 8032 section 7.1, tests 1 to 3: { seed, public key, message, signature }.
+    static const char* vectors[3][4] = {
+        { "9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60", "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a", "", "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e065224901555fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b" },
+        { "4ccd089b28ff96da9db6c346ec114e0f5b8a319f35aba624da8cf6ed4fb8a6fb", "3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c", "72", "92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00" },
+        { "c5aa8df43f9f837bedb7442f31dcb7b166d38535076f094b85ce3a2e0b4458f7", "fc51cd8e6218a1a38da47ed00230f0580816ed13ba3303ac5deb911548908025", "af82", "6291d657deec24024827e69c3abe01a30ce548a284743a445e3680d7db5ac3ac18ff9b538d16f290ae67f760984dc6594a7c15e9716ed28dc027beceea1ec40a" },
+    };
+
+    for (int i = 0; i < 3; ++i)
+    {
+        // cecies_hexstr2bin() NUL-terminates its output.
+        uint8_t seed[CECIES_ED25519_SEED_SIZE + 1], expected_public_key[CECIES_ED25519_PUBLIC_KEY_SIZE + 1], message[3], expected_signature[CECIES_ED25519_SIGNATURE_SIZE + 1];
+        uint8_t public_key[CECIES_ED25519_PUBLIC_KEY_SIZE], private_key[CECIES_ED25519_PRIVATE_KEY_SIZE], signature[CECIES_ED25519_SIGNATURE_SIZE];
+        size_t message_length = 0;
+
+        TEST_CHECK(0 == cecies_hexstr2bin(vectors[i][0], 64, seed, sizeof(seed), NULL));
+        TEST_CHECK(0 == cecies_hexstr2bin(vectors[i][1], 64, expected_public_key, sizeof(expected_public_key), NULL));
+        TEST_CHECK(0 == cecies_hexstr2bin(vectors[i][3], 128, expected_signature, sizeof(expected_signature), NULL));
+
+        if (i > 0)
+        {
+            TEST_CHECK(0 == cecies_hexstr2bin(vectors[i][2], strlen(vectors[i][2]), message, sizeof(message), &message_length));
+        }
+
+        TEST_CHECK(0 == cecies_ed25519_keypair_from_seed(seed, public_key, private_key));
+        TEST_CHECK(0 == memcmp(public_key, expected_public_key, sizeof(public_key)));
+        TEST_CHECK(0 == memcmp(private_key, seed, CECIES_ED25519_SEED_SIZE) && 0 == memcmp(private_key + 32, public_key, sizeof(public_key)));
+
+        TEST_CHECK(0 == cecies_ed25519_sign(message, message_length, private_key, signature));
+        TEST_CHECK(0 == memcmp(signature, expected_signature, sizeof(signature)));
+        TEST_CHECK(0 == cecies_ed25519_verify(message, message_length, expected_signature, public_key));
+    }
+}
+
+static void cecies_ed25519_tampered_or_malformed_signatures_fail()
+{
+    uint8_t public_key[CECIES_ED25519_PUBLIC_KEY_SIZE], private_key[CECIES_ED25519_PRIVATE_KEY_SIZE];
+    uint8_t public_key2[CECIES_ED25519_PUBLIC_KEY_SIZE], private_key2[CECIES_ED25519_PRIVATE_KEY_SIZE];
+    uint8_t signature[CECIES_ED25519_SIGNATURE_SIZE], tampered[CECIES_ED25519_SIGNATURE_SIZE];
+
+    TEST_CHECK(0 == cecies_generate_ed25519_keypair(public_key, private_key, (const uint8_t*)"test", 4));
+    TEST_CHECK(0 == cecies_generate_ed25519_keypair(public_key2, private_key2, NULL, 0));
+    TEST_CHECK(0 != memcmp(public_key, public_key2, sizeof(public_key)));
+
+    TEST_CHECK(0 == cecies_ed25519_sign((const uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITHOUT_NUL_TERMINATOR, private_key, signature));
+    TEST_CHECK(0 == cecies_ed25519_verify((const uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITHOUT_NUL_TERMINATOR, signature, public_key));
+
+    // Wrong key, wrong message, flipped bits in R or S.
+    TEST_CHECK(CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE == cecies_ed25519_verify((const uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITHOUT_NUL_TERMINATOR, signature, public_key2));
+    TEST_CHECK(CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE == cecies_ed25519_verify((const uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITHOUT_NUL_TERMINATOR - 1, signature, public_key));
+
+    for (size_t i = 0; i < sizeof(signature); i += 21)
+    {
+        memcpy(tampered, signature, sizeof(signature));
+        tampered[i] ^= 0x04;
+        TEST_CHECK(CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE == cecies_ed25519_verify((const uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITHOUT_NUL_TERMINATOR, tampered, public_key));
+    }
+
+    // S + l would satisfy the verification equation too, but isn't canonical.
+    static const uint8_t l[32] = { 0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x10 };
+    memcpy(tampered, signature, sizeof(signature));
+    unsigned int carry = 0;
+    for (int i = 0; i < 32; ++i)
+    {
+        carry += tampered[32 + i] + l[i];
+        tampered[32 + i] = (uint8_t)carry;
+        carry >>= 8;
+    }
+    TEST_CHECK(CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE == cecies_ed25519_verify((const uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITHOUT_NUL_TERMINATOR, tampered, public_key));
+
+    // Small-order public keys (the neutral element here) are rejected, whatever the signature.
+    uint8_t neutral[CECIES_ED25519_PUBLIC_KEY_SIZE] = { 0x01 };
+    TEST_CHECK(CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE == cecies_ed25519_verify((const uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITHOUT_NUL_TERMINATOR, signature, neutral));
+
+    TEST_CHECK(CECIES_ED25519_ERROR_CODE_NULL_ARG == cecies_ed25519_sign(NULL, 1, private_key, signature));
+    TEST_CHECK(CECIES_ED25519_ERROR_CODE_NULL_ARG == cecies_ed25519_sign((const uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITHOUT_NUL_TERMINATOR, NULL, signature));
+    TEST_CHECK(CECIES_ED25519_ERROR_CODE_NULL_ARG == cecies_ed25519_verify((const uint8_t*)TEST_STRING, TEST_STRING_LENGTH_WITHOUT_NUL_TERMINATOR, NULL, public_key));
+    TEST_CHECK(CECIES_ED25519_ERROR_CODE_NULL_ARG == cecies_generate_ed25519_keypair(NULL, private_key, NULL, 0));
+}
+
+static void cecies_ed25519_batch_verification_finds_the_invalid_signatures()
+{
+    // 80 signatures are enough for the multi-scalar multiplication to take Pippenger's path, the first 8 of them take Straus'.
+    enum
+    {
+        count = 80
+    };
+
+    uint8_t public_keys[count][CECIES_ED25519_PUBLIC_KEY_SIZE];
+    uint8_t private_key[CECIES_ED25519_PRIVATE_KEY_SIZE];
+    uint8_t signatures[count][CECIES_ED25519_SIGNATURE_SIZE];
+    uint8_t messages[count][16];
+
+    const uint8_t* message_pointers[count];
+    const uint8_t* signature_pointers[count];
+    const uint8_t* public_key_pointers[count];
+    size_t message_lengths[count];
+    int results[count];
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        TEST_CHECK(0 == cecies_generate_ed25519_keypair(public_keys[i], private_key, NULL, 0));
+        cecies_dev_urandom(messages[i], sizeof(messages[i]));
+
+        // Varying lengths (including empty messages).
+        message_lengths[i] = i % sizeof(messages[i]);
+        TEST_CHECK(0 == cecies_ed25519_sign(messages[i], message_lengths[i], private_key, signatures[i]));
+
+        message_pointers[i] = messages[i];
+        signature_pointers[i] = signatures[i];
+        public_key_pointers[i] = public_keys[i];
+        results[i] = -1;
+    }
+
+    TEST_CHECK(0 == cecies_ed25519_verify_batch(message_pointers, message_lengths, signature_pointers, public_key_pointers, count, results));
+    for (size_t i = 0; i < count; ++i)
+    {
+        TEST_CHECK(0 == results[i]);
+    }
+
+    TEST_CHECK(0 == cecies_ed25519_verify_batch(message_pointers, message_lengths, signature_pointers, public_key_pointers, 8, NULL));
+    TEST_CHECK(0 == cecies_ed25519_verify_batch(message_pointers, message_lengths, signature_pointers, public_key_pointers, 1, NULL));
+    TEST_CHECK(0 == cecies_ed25519_verify_batch(NULL, NULL, NULL, NULL, 0, NULL));
+
+    // A tampered-with message, a swapped public key and a non-canonical S: only those three must fail.
+    messages[5][0] ^= 0x01;
+    public_key_pointers[17] = public_keys[18];
+    signatures[30][63] |= 0xf0;
+
+    TEST_CHECK(CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE == cecies_ed25519_verify_batch(message_pointers, message_lengths, signature_pointers, public_key_pointers, count, results));
+    for (size_t i = 0; i < count; ++i)
+    {
+        TEST_CHECK((i == 5 || i == 17 || i == 30) == (CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE == results[i]));
+        TEST_CHECK((i == 5 || i == 17 || i == 30) == (0 != cecies_ed25519_verify(messages[i], message_lengths[i], signatures[i], public_key_pointers[i])));
+    }
+
+    TEST_CHECK(CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE == cecies_ed25519_verify_batch(message_pointers, message_lengths, signature_pointers, public_key_pointers, count, NULL));
+    TEST_CHECK(CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE == cecies_ed25519_verify_batch(message_pointers, message_lengths, signature_pointers, public_key_pointers, 8, NULL));
+
+    signature_pointers[3] = NULL;
+    TEST_CHECK(CECIES_ED25519_ERROR_CODE_NULL_ARG == cecies_ed25519_verify_batch(message_pointers, message_lengths, signature_pointers, public_key_pointers, count, results));
+}
+
+static void cecies_ed25519_batch_verification_agrees_with_verify_on_keys_with_torsion()
+{
+    // A' = aB + T (T being a point of order 8) and signatures made with a: R = rB, S = r + k * a, k = H(R || A' || M).
+    // [S]B - [k]A' = R - [k]T only matches R exactly for k = 0 (mod 8), which is "Message #19" but none of the others: comparing R without the cofactor (like libsodium does) rejects the rest.
+    // The cofactored equation accepts all of them, and cecies_ed25519_verify() has to agree with the batch on that, both one by one and when one of them is invalid.
+    static const char public_key_hex[] = "111a4cd32df5b3fcb2329bf37cf9720d276d7e20b468201f8df2ad7bc687dac5";
+    static const char* vectors[8][2] = {
+        { "Message #0", "47f42ed988a1a2abd7e30afea5f325e48e663931c0f2c6c32a132d8c397381a3f3e2cbe5539f7183ccb2cc8054418070b8cd4ca94db22a76337523d037d06007" },
+        { "Message #1", "7b704ac067a60994e16599aa36bb1bb8c2e18467bf0a68eed2e148b06520fd1167506716dfbc73b42bffcab6d6800e371b199405973ad8f2ba6e5775858b9b04" },
+        { "Message #2", "54b34367665d11c576409c1481c3c46243618c46c78c75af890586de197f569c8e356903750d01edddeb08df0179b72e0ef203f194ba3c52554fff185413ea00" },
+        { "Message #3", "5af34b01bcab7462b8f058b0c8ae099d6719a8465e05a976e4b04097d61fb7f6123ee228740d6870706d486a7d6c02e77eaf95d2a134228cef218920d87d010e" },
+        { "Message #4", "32e02777aef8894581674fe62b3b75606964e97ee4aef9558c97441199391eb62e7b6a61efc8d76db649c1dc335500ff68e6c158b9e850416fdea629f2de8a05" },
+        { "Message #5", "ee998245606039684032c6acedbe9bfa0d0ece4997e5d862ec7ef7a02c673178c8680566068d2723124c2e33069ec4092651bc89a1d157ccdce7103629bf3b09" },
+        { "Message #6", "411680d2511bd0da42f295f0af0592cafb44206cb335d2229993d6a7c5e3fe6d0cd2b2ccd7f0f4134416b3a2e178a3140ff7feb373e00ce0f80b7ffe25d91e0a" },
+        { "Message #19", "0aacc5a14b0b9cf1f6c2efb0db0059cf9a634c49cc0069f534428e3675028f2e1d3aba8bc165227d6c4bc9d777c51091407dc8cd324af1530eadf5613e710b09" },
+    };
+
+    // cecies_hexstr2bin() NUL-terminates its output.
+    uint8_t public_key[CECIES_ED25519_PUBLIC_KEY_SIZE + 1];
+    uint8_t signatures[8][CECIES_ED25519_SIGNATURE_SIZE + 1];
+
+    const uint8_t* message_pointers[8];
+    const uint8_t* signature_pointers[8];
+    const uint8_t* public_key_pointers[8];
+    size_t message_lengths[8];
+    int results[8];
+    int expected[8];
+
+    TEST_CHECK(0 == cecies_hexstr2bin(public_key_hex, 64, public_key, sizeof(public_key), NULL));
+
+    for (size_t i = 0; i < 8; ++i)
+    {
+        TEST_CHECK(0 == cecies_hexstr2bin(vectors[i][1], 128, signatures[i], sizeof(signatures[i]), NULL));
+
+        message_pointers[i] = (const uint8_t*)vectors[i][0];
+        message_lengths[i] = strlen(vectors[i][0]);
+        signature_pointers[i] = signatures[i];
+        public_key_pointers[i] = public_key;
+        results[i] = -1;
+
+        TEST_CHECK(0 == cecies_ed25519_verify(message_pointers[i], message_lengths[i], signature_pointers[i], public_key));
+    }
+
+    TEST_CHECK(0 == cecies_ed25519_verify_batch(message_pointers, message_lengths, signature_pointers, public_key_pointers, 8, results));
+    for (size_t i = 0; i < 8; ++i)
+    {
+        TEST_CHECK(0 == results[i]);
+    }
+
+    TEST_CHECK(0 == cecies_ed25519_verify_batch(message_pointers, message_lengths, signature_pointers, public_key_pointers, 8, NULL));
+    TEST_CHECK(0 == cecies_ed25519_verify_batch(message_pointers, message_lengths, signature_pointers, public_key_pointers, 1, NULL));
+
+    // Signing "Message #" instead of "Message #3" and "Message #1" instead of "Message #19" makes those two invalid (the latter being the one with k = 0 mod 8).
+    message_lengths[3] -= 1;
+    message_lengths[7] -= 1;
+
+    TEST_CHECK(CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE == cecies_ed25519_verify_batch(message_pointers, message_lengths, signature_pointers, public_key_pointers, 8, results));
+    for (size_t i = 0; i < 8; ++i)
+    {
+        expected[i] = cecies_ed25519_verify(message_pointers[i], message_lengths[i], signature_pointers[i], public_key);
+        TEST_CHECK(expected[i] == (i == 3 || i == 7 ? CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE : 0));
+        TEST_CHECK(expected[i] == results[i]);
+    }
+
+    TEST_CHECK(CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE == cecies_ed25519_verify_batch(message_pointers, message_lengths, signature_pointers, public_key_pointers, 8, NULL));
+    TEST_CHECK(CECIES_ED25519_ERROR_CODE_INVALID_SIGNATURE == cecies_ed25519_verify_batch(message_pointers + 2, message_lengths + 2, signature_pointers + 2, public_key_pointers + 2, 2, NULL));
+    TEST_CHECK(0 == cecies_ed25519_verify_batch(message_pointers + 4, message_lengths + 4, signature_pointers + 4, public_key_pointers + 4, 3, NULL));
+}
+
 // --------------------------------------------------------------------------------------------------------------
 
 TEST_LIST = {
@@ -1572,6 +5179,116 @@ TEST_LIST = {
     { "cecies_curve448_encrypt_base64_decrypt_different_key_always_fails", cecies_curve448_encrypt_base64_decrypt_different_key_always_fails }, //
     { "cecies_curve448_encrypt_base64_decrypt_base64_lengths_identical", cecies_curve448_encrypt_base64_decrypt_base64_lengths_identical }, //
     { "cecies_curve448_encrypt_base64_decrypt_base64_compression_reduces_size", cecies_curve448_encrypt_base64_decrypt_base64_compression_reduces_size }, //
+    // ------------------------------------------------------    Keyring
+    { "cecies_curve25519_encrypt_ext_key_id_decrypts_successfully", cecies_curve25519_encrypt_ext_key_id_decrypts_successfully }, //
+    { "cecies_curve448_encrypt_ext_key_id_decrypts_successfully", cecies_curve448_encrypt_ext_key_id_decrypts_successfully }, //
+    { "cecies_encrypt_ext_without_flags_output_identical_format", cecies_encrypt_ext_without_flags_output_identical_format }, //
+    { "cecies_encrypt_ext_invalid_header_flags_fails_returns_CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG", cecies_encrypt_ext_invalid_header_flags_fails_returns_CECIES_ENCRYPT_ERROR_CODE_INVALID_ARG }, //
+    { "cecies_encrypt_ext_tampered_ext_header_fails", cecies_encrypt_ext_tampered_ext_header_fails }, //
+    { "cecies_encrypt_ext_decrypt_with_other_curve_fails_returns_CECIES_DECRYPT_ERROR_CODE_INVALID_ARG", cecies_encrypt_ext_decrypt_with_other_curve_fails_returns_CECIES_DECRYPT_ERROR_CODE_INVALID_ARG }, //
+    { "cecies_curve25519_keyring_write_open_find_and_decrypt_succeeds", cecies_curve25519_keyring_write_open_find_and_decrypt_succeeds }, //
+    { "cecies_curve448_keyring_write_open_and_decrypt_succeeds", cecies_curve448_keyring_write_open_and_decrypt_succeeds }, //
+    { "cecies_keyring_decrypt_without_key_id_hint_fails_returns_CECIES_KEYRING_ERROR_CODE_KEY_NOT_FOUND", cecies_keyring_decrypt_without_key_id_hint_fails_returns_CECIES_KEYRING_ERROR_CODE_KEY_NOT_FOUND }, //
+    { "cecies_keyring_write_duplicate_keys_fails_returns_CECIES_KEYRING_ERROR_CODE_INVALID_ARG", cecies_keyring_write_duplicate_keys_fails_returns_CECIES_KEYRING_ERROR_CODE_INVALID_ARG }, //
+    { "cecies_keyring_open_invalid_file_fails", cecies_keyring_open_invalid_file_fails }, //
+    // ------------------------------------------------------    Trial decryption
+    { "cecies_curve25519_decrypt_trial_finds_matching_key_and_decrypts_successfully", cecies_curve25519_decrypt_trial_finds_matching_key_and_decrypts_successfully }, //
+    { "cecies_curve448_decrypt_trial_finds_matching_key_and_decrypts_successfully", cecies_curve448_decrypt_trial_finds_matching_key_and_decrypts_successfully }, //
+    { "cecies_decrypt_trial_no_matching_key_fails_returns_CECIES_DECRYPT_ERROR_CODE_KEY_NOT_FOUND", cecies_decrypt_trial_no_matching_key_fails_returns_CECIES_DECRYPT_ERROR_CODE_KEY_NOT_FOUND }, //
+    // ------------------------------------------------------    Verify
+    { "cecies_curve25519_verify_authentic_ciphertext_succeeds", cecies_curve25519_verify_authentic_ciphertext_succeeds }, //
+    { "cecies_curve448_verify_authentic_ciphertext_succeeds", cecies_curve448_verify_authentic_ciphertext_succeeds }, //
+    { "cecies_verify_tampered_ciphertext_or_wrong_key_fails_returns_CECIES_DECRYPT_ERROR_CODE_VERIFICATION_FAILED", cecies_verify_tampered_ciphertext_or_wrong_key_fails_returns_CECIES_DECRYPT_ERROR_CODE_VERIFICATION_FAILED }, //
+    // ------------------------------------------------------    Key commitment
+    { "cecies_encrypt_ext_key_commitment_decrypts_successfully", cecies_encrypt_ext_key_commitment_decrypts_successfully }, //
+    { "cecies_encrypt_ext_key_commitment_wrong_key_fails_returns_CECIES_DECRYPT_ERROR_CODE_WRONG_KEY", cecies_encrypt_ext_key_commitment_wrong_key_fails_returns_CECIES_DECRYPT_ERROR_CODE_WRONG_KEY }, //
+    // ------------------------------------------------------    Inspect
+    { "cecies_inspect_plain_ciphertext_returns_correct_layout", cecies_inspect_plain_ciphertext_returns_correct_layout }, //
+    { "cecies_inspect_base64_ext_ciphertext_returns_same_as_binary", cecies_inspect_base64_ext_ciphertext_returns_same_as_binary }, //
+    { "cecies_inspect_compressed_ciphertext_has_no_plaintext_length_bound", cecies_inspect_compressed_ciphertext_has_no_plaintext_length_bound }, //
+    { "cecies_inspect_invalid_args_fails", cecies_inspect_invalid_args_fails }, //
+    // ------------------------------------------------------    Stream
+    { "cecies_encrypt_stream_chunked_decrypts_with_one_shot_decrypt", cecies_encrypt_stream_chunked_decrypts_with_one_shot_decrypt }, //
+    { "cecies_decrypt_stream_chunked_one_shot_ciphertext_succeeds", cecies_decrypt_stream_chunked_one_shot_ciphertext_succeeds }, //
+    { "cecies_decrypt_stream_length_hint_allocates_payload_once", cecies_decrypt_stream_length_hint_allocates_payload_once }, //
+    { "cecies_decrypt_stream_compressed_ciphertext_decompresses", cecies_decrypt_stream_compressed_ciphertext_decompresses }, //
+    { "cecies_decrypt_stream_tampered_ciphertext_releases_nothing", cecies_decrypt_stream_tampered_ciphertext_releases_nothing }, //
+    { "cecies_encrypt_stream_finish_file_patches_tag", cecies_encrypt_stream_finish_file_patches_tag }, //
+    { "cecies_encrypt_stream_invalid_args_fails", cecies_encrypt_stream_invalid_args_fails }, //
+    // ------------------------------------------------------    Parallel GCM
+    { "cecies_config_setters_change_only_their_own_fields", cecies_config_setters_change_only_their_own_fields }, //
+    { "cecies_parallel_gcm_encrypt_decrypts_single_threaded", cecies_parallel_gcm_encrypt_decrypts_single_threaded }, //
+    { "cecies_parallel_gcm_decrypt_single_threaded_ciphertext_succeeds", cecies_parallel_gcm_decrypt_single_threaded_ciphertext_succeeds }, //
+    { "cecies_parallel_gcm_decrypt_tampered_ciphertext_fails", cecies_parallel_gcm_decrypt_tampered_ciphertext_fails }, //
+    // ------------------------------------------------------    Parallel compression
+    { "cecies_parallel_compression_encrypt_decrypt_succeeds", cecies_parallel_compression_encrypt_decrypt_succeeds }, //
+    { "cecies_parallel_compression_all_levels_decrypt_succeeds", cecies_parallel_compression_all_levels_decrypt_succeeds }, //
+    { "cecies_compression_incompressible_and_tiny_inputs_decrypt_succeeds", cecies_compression_incompressible_and_tiny_inputs_decrypt_succeeds }, //
+    { "cecies_compression_all_levels_inflate_the_same_with_zlib", cecies_compression_all_levels_inflate_the_same_with_zlib }, //
+    // ------------------------------------------------------    Reader
+    { "cecies_reader_compressed_payload_read_in_small_windows_succeeds", cecies_reader_compressed_payload_read_in_small_windows_succeeds }, //
+    { "cecies_reader_uncompressed_payload_passes_through", cecies_reader_uncompressed_payload_passes_through }, //
+    { "cecies_reader_data_resembling_zlib_header_returned_as_is", cecies_reader_data_resembling_zlib_header_returned_as_is }, //
+    { "cecies_reader_stop_early_and_free_succeeds", cecies_reader_stop_early_and_free_succeeds }, //
+    { "cecies_reader_tampered_ciphertext_or_wrong_key_fails", cecies_reader_tampered_ciphertext_or_wrong_key_fails }, //
+    // ------------------------------------------------------    Iovec
+    { "cecies_curve25519_encrypt_iov_decrypts_with_one_shot_decrypt", cecies_curve25519_encrypt_iov_decrypts_with_one_shot_decrypt }, //
+    { "cecies_curve448_encrypt_iov_compressed_decrypt_iov_succeeds", cecies_curve448_encrypt_iov_compressed_decrypt_iov_succeeds }, //
+    { "cecies_curve25519_decrypt_iov_one_shot_ciphertext_succeeds", cecies_curve25519_decrypt_iov_one_shot_ciphertext_succeeds }, //
+    { "cecies_iov_insufficient_output_or_tampered_ciphertext_fails", cecies_iov_insufficient_output_or_tampered_ciphertext_fails }, //
+    // ------------------------------------------------------    Allocator
+    { "cecies_set_allocator_routes_all_allocations", cecies_set_allocator_routes_all_allocations }, //
+    { "cecies_free_returns_blocks_to_their_allocator", cecies_free_returns_blocks_to_their_allocator }, //
+    { "cecies_pool_allocator_encrypt_decrypt_succeeds", cecies_pool_allocator_encrypt_decrypt_succeeds }, //
+    { "cecies_alloc_stats_count_per_thread_and_reset", cecies_alloc_stats_count_per_thread_and_reset }, //
+    // ------------------------------------------------------    To buffer
+    { "cecies_curve25519_encrypt_to_buffer_roundtrip_interoperates", cecies_curve25519_encrypt_to_buffer_roundtrip_interoperates }, //
+    { "cecies_curve448_encrypt_to_buffer_roundtrip_with_ext_header", cecies_curve448_encrypt_to_buffer_roundtrip_with_ext_header }, //
+    { "cecies_encrypt_to_buffer_insufficient_or_tampered_fails", cecies_encrypt_to_buffer_insufficient_or_tampered_fails }, //
+    { "cecies_decrypt_to_buffer_rejects_compressed_payloads", cecies_decrypt_to_buffer_rejects_compressed_payloads }, //
+    { "cecies_encrypt_to_buffer_does_not_allocate", cecies_encrypt_to_buffer_does_not_allocate }, //
+    // ------------------------------------------------------    Restartable
+    { "cecies_curve25519_restartable_roundtrip_succeeds", cecies_curve25519_restartable_roundtrip_succeeds }, //
+    { "cecies_curve448_restartable_decrypts_compressed_ciphertext", cecies_curve448_restartable_decrypts_compressed_ciphertext }, //
+    { "cecies_ext_header_payload_starting_with_zlib_header_is_not_inflated", cecies_ext_header_payload_starting_with_zlib_header_is_not_inflated }, //
+    { "cecies_zlib_stream_followed_by_trailing_bytes_is_not_inflated", cecies_zlib_stream_followed_by_trailing_bytes_is_not_inflated }, //
+    { "cecies_restartable_tampered_or_wrong_key_fails_and_sticks", cecies_restartable_tampered_or_wrong_key_fails_and_sticks }, //
+    { "cecies_restartable_splits_scalar_multiplications", cecies_restartable_splits_scalar_multiplications }, //
+    { "cecies_restartable_free_cancels_midway", cecies_restartable_free_cancels_midway }, //
+    // ------------------------------------------------------    Async
+    { "cecies_async_encrypt_and_decrypt_many_jobs_succeeds", cecies_async_encrypt_and_decrypt_many_jobs_succeeds }, //
+    { "cecies_async_self_freeing_jobs_notify_eventfd_and_complete_before_pool_free", cecies_async_self_freeing_jobs_notify_eventfd_and_complete_before_pool_free }, //
+    { "cecies_async_encrypt_file_roundtrip_succeeds", cecies_async_encrypt_file_roundtrip_succeeds }, //
+    { "cecies_async_invalid_args_and_missing_files_fail", cecies_async_invalid_args_and_missing_files_fail }, //
+    { "cecies_async_cancel_skips_pending_jobs_and_release_never_blocks", cecies_async_cancel_skips_pending_jobs_and_release_never_blocks }, //
+    // ------------------------------------------------------    Interop
+    { "cecies_curve25519_context_into_roundtrip_interoperates", cecies_curve25519_context_into_roundtrip_interoperates }, //
+    { "cecies_curve448_context_with_ext_header_and_single_purpose_contexts", cecies_curve448_context_with_ext_header_and_single_purpose_contexts }, //
+    { "cecies_context_invalid_args_fail", cecies_context_invalid_args_fail }, //
+    { "cecies_context_batch_roundtrip_and_per_item_results", cecies_context_batch_roundtrip_and_per_item_results }, //
+    // ------------------------------------------------------    Multi-buffer GCM
+    { "cecies_multi_buffer_gcm_batches_interoperate_with_single_message_path", cecies_multi_buffer_gcm_batches_interoperate_with_single_message_path }, //
+    { "cecies_multi_buffer_gcm_tampered_lanes_fail_on_their_own", cecies_multi_buffer_gcm_tampered_lanes_fail_on_their_own }, //
+    // ------------------------------------------------------    Multi-lane X25519
+    { "cecies_multi_lane_x25519_batches_interoperate_with_mbedtls", cecies_multi_lane_x25519_batches_interoperate_with_mbedtls }, //
+    { "cecies_multi_lane_x25519_wrong_key_and_bad_ephemeral_keys_fail_on_their_own", cecies_multi_lane_x25519_wrong_key_and_bad_ephemeral_keys_fail_on_their_own }, //
+    { "cecies_multi_lane_x25519_long_queue_matches_serial_decryption", cecies_multi_lane_x25519_long_queue_matches_serial_decryption }, //
+    // ------------------------------------------------------    Multi-buffer SHA-512
+    { "cecies_multi_buffer_sha512_batches_interoperate_with_mbedtls_hkdf", cecies_multi_buffer_sha512_batches_interoperate_with_mbedtls_hkdf }, //
+    // ------------------------------------------------------    FIXED-BASE KEY GENERATION
+    { "cecies_fixed_base_keygen_public_keys_match_their_private_keys", cecies_fixed_base_keygen_public_keys_match_their_private_keys }, //
+#ifndef CECIES_DLL
+    { "cecies_fixed_base_matches_mbedtls_ecp_mul_on_edge_and_random_scalars", cecies_fixed_base_matches_mbedtls_ecp_mul_on_edge_and_random_scalars }, //
+#endif
+    // ------------------------------------------------------    KEY ENCAPSULATION
+    { "cecies_kem_encapsulated_keys_decapsulate_to_the_same_key", cecies_kem_encapsulated_keys_decapsulate_to_the_same_key }, //
+    { "cecies_kem_invalid_args_fail_and_zero_the_key", cecies_kem_invalid_args_fail_and_zero_the_key }, //
+    { "cecies_kem_decapsulated_key_decrypts_regular_ciphertexts", cecies_kem_decapsulated_key_decrypts_regular_ciphertexts }, //
+    // ------------------------------------------------------    ED25519
+    { "cecies_ed25519_rfc8032_test_vectors_match", cecies_ed25519_rfc8032_test_vectors_match }, //
+    { "cecies_ed25519_tampered_or_malformed_signatures_fail", cecies_ed25519_tampered_or_malformed_signatures_fail }, //
+    { "cecies_ed25519_batch_verification_finds_the_invalid_signatures", cecies_ed25519_batch_verification_finds_the_invalid_signatures }, //
+    { "cecies_ed25519_batch_verification_agrees_with_verify_on_keys_with_torsion", cecies_ed25519_batch_verification_agrees_with_verify_on_keys_with_torsion }, //
     //
     // ----------------------------------------------------------------------------------------------------------
     //
@@ -0,0 +1,449 @@
+/*
+   Copyright 2020 Raphael Beck
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/*
+ * Tests for the header-only C++ wrapper (cecies.hpp).
+ * These use a minimal runner instead of acutest (whose runner catches C++ exceptions), so that they can also be built with -fno-exceptions.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <array>
+#include <algorithm>
+#include <vector>
+#include <string>
+
+#include <cecies/cecies.hpp>
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>) && __has_include(<stop_token>)
+#include <deque>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <exception>
+#include <condition_variable>
+#include <cecies/coro.hpp>
+#define CECIES_TESTS_CORO 1
+#endif
+#endif
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                 \
+    do                                                                              \
+    {                                                                               \
+        if (!(cond))                                                                \
+        {                                                                           \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++failures;                                                             \
+        }                                                                           \
+    } while (0)
+
+static const std::string_view TEST_STRING = "Still, I am not one to squander my investments... and I remain confident she was worth far more than the initial... appraisal.";
+
+static const std::string_view TEST_CURVE25519_PUBLIC_KEY = "87981c92ede838b434e5fcd9eec9cd45ceaade59f3b72bb9e2088927c50dee07";
+static const std::string_view TEST_CURVE25519_PRIVATE_KEY = "72dcda48cacaf2969d4faecdbdf1e080a269ccc3c4ce16238050fa95052ad110";
+
+template <typename Curve>
+static void roundtrip(const cecies::public_key<Curve>& public_key, const cecies::private_key<Curve>& private_key)
+{
+    const cecies::byte_span plaintext = cecies::as_bytes(TEST_STRING);
+
+    // Allocated by the C core, compressed, with an extended header.
+    cecies::result<cecies::buffer> encrypted = cecies::encrypt(plaintext, public_key, cecies::encrypt_options{ 6, CECIES_HEADER_FLAG_KEY_COMMITMENT });
+    CHECK(encrypted.ok());
+    CHECK(0 == cecies::verify(encrypted->bytes(), private_key));
+
+    cecies::result<cecies::buffer> decrypted = cecies::decrypt(encrypted->bytes(), private_key);
+    CHECK(decrypted.ok());
+    CHECK(decrypted->as_string_view() == TEST_STRING);
+
+    // Base64 in, base64 out.
+    cecies::result<cecies::buffer> encrypted_base64 = cecies::encrypt_base64(plaintext, public_key);
+    CHECK(encrypted_base64.ok());
+    CHECK(encrypted_base64->as_string_view().find('\0') == std::string_view::npos);
+
+    decrypted = cecies::decrypt_base64(encrypted_base64->as_string_view(), private_key);
+    CHECK(decrypted.ok());
+    CHECK(decrypted->as_string_view() == TEST_STRING);
+
+    // Caller-provided buffers.
+    std::vector<std::uint8_t> ciphertext(cecies::encrypted_size<Curve>(plaintext.size(), CECIES_HEADER_FLAG_KEY_ID));
+    cecies::result<std::size_t> ciphertext_length = cecies::encrypt_to(plaintext, public_key, ciphertext, CECIES_HEADER_FLAG_KEY_ID);
+    CHECK(ciphertext_length.ok());
+    CHECK(*ciphertext_length == ciphertext.size());
+
+    std::array<std::uint8_t, 256> output{};
+    cecies::result<std::size_t> output_length = cecies::decrypt_to(ciphertext, private_key, output);
+    CHECK(output_length.ok());
+    CHECK(*output_length == plaintext.size() && std::memcmp(output.data(), plaintext.data(), plaintext.size()) == 0);
+
+    std::array<std::uint8_t, 8> too_small{};
+    CHECK(CECIES_DECRYPT_ERROR_CODE_INSUFFICIENT_OUTPUT_BUFFER_SIZE == cecies::decrypt_to(ciphertext, private_key, too_small).error());
+
+    ciphertext[ciphertext.size() - 1] ^= 0x01;
+    CHECK(!cecies::decrypt(ciphertext, private_key).ok());
+
+#ifdef CECIES_HPP_PMR
+    // Memory resources: the output lands inside the arena directly.
+    std::array<std::uint8_t, 4096> arena;
+    std::pmr::monotonic_buffer_resource resource(arena.data(), arena.size(), std::pmr::null_memory_resource());
+
+    cecies::result<std::pmr::vector<std::uint8_t>> pmr_encrypted = cecies::encrypt(plaintext, public_key, &resource);
+    CHECK(pmr_encrypted.ok());
+    CHECK(pmr_encrypted->data() >= arena.data() && pmr_encrypted->data() < arena.data() + arena.size());
+
+    cecies::result<std::pmr::vector<std::uint8_t>> pmr_decrypted = cecies::decrypt(*pmr_encrypted, private_key, &resource);
+    CHECK(pmr_decrypted.ok());
+    CHECK(pmr_decrypted->size() == plaintext.size() && std::memcmp(pmr_decrypted->data(), plaintext.data(), plaintext.size()) == 0);
+#endif
+}
+
+static void cecies_hpp_keys_roundtrip()
+{
+    cecies::result<cecies::public_key<cecies::curve25519>> public_key = cecies::public_key<cecies::curve25519>::from_hex(TEST_CURVE25519_PUBLIC_KEY);
+    cecies::result<cecies::private_key<cecies::curve25519>> private_key = cecies::private_key<cecies::curve25519>::from_hex(TEST_CURVE25519_PRIVATE_KEY);
+    CHECK(public_key.ok() && private_key.ok());
+    CHECK(public_key->hex() == TEST_CURVE25519_PUBLIC_KEY);
+
+    roundtrip(*public_key, *private_key);
+
+    // The C API wipes the private key copies it gets: the wrapper's key must survive that.
+    CHECK(private_key->hex() == TEST_CURVE25519_PRIVATE_KEY);
+
+    cecies::result<cecies::keypair<cecies::curve448>> keypair = cecies::generate_keypair<cecies::curve448>(cecies::as_bytes("additional entropy"));
+    CHECK(keypair.ok());
+    CHECK(keypair->public_key.hex().size() == CECIES_X448_KEY_SIZE * 2);
+
+    roundtrip(keypair->public_key, keypair->private_key);
+}
+
+static void cecies_hpp_key_parsing_and_moves()
+{
+    CHECK(CECIES_KEYGEN_ERROR_CODE_INVALID_ARG == cecies::public_key<cecies::curve25519>::from_hex("abcd").error());
+    CHECK(CECIES_KEYGEN_ERROR_CODE_INVALID_ARG == cecies::private_key<cecies::curve25519>::from_hex(std::string(64, 'x')).error());
+    CHECK(CECIES_KEYGEN_ERROR_CODE_INVALID_ARG == cecies::public_key<cecies::curve448>::from_hex(TEST_CURVE25519_PUBLIC_KEY).error());
+
+    std::array<std::uint8_t, CECIES_X25519_KEY_SIZE + 1> raw{};
+    CHECK(0 == cecies_hexstr2bin(TEST_CURVE25519_PRIVATE_KEY.data(), TEST_CURVE25519_PRIVATE_KEY.size(), raw.data(), raw.size(), nullptr));
+
+    const cecies::byte_span raw_key(raw.data(), CECIES_X25519_KEY_SIZE);
+    cecies::result<cecies::private_key<cecies::curve25519>> from_bytes = cecies::private_key<cecies::curve25519>::from_bytes(raw_key);
+    CHECK(from_bytes.ok());
+    CHECK(from_bytes->hex() == TEST_CURVE25519_PRIVATE_KEY);
+    CHECK(!cecies::private_key<cecies::curve448>::from_bytes(raw_key).ok());
+
+    static_assert(!std::is_copy_constructible_v<cecies::private_key<cecies::curve25519>>, "keys are move-only");
+    static_assert(!std::is_copy_constructible_v<cecies::buffer>, "buffers are move-only");
+    static_assert(!std::is_copy_constructible_v<cecies::encrypt_stream>, "contexts are move-only");
+
+    cecies::private_key<cecies::curve25519> moved = std::move(*from_bytes);
+    CHECK(moved.hex() == TEST_CURVE25519_PRIVATE_KEY);
+    CHECK(from_bytes->hex().empty());
+
+    cecies::private_key<cecies::curve25519> copy = moved.clone();
+    CHECK(copy.hex() == moved.hex());
+}
+
+static void cecies_hpp_encrypt_stream_roundtrip()
+{
+    cecies::result<cecies::public_key<cecies::curve25519>> public_key = cecies::public_key<cecies::curve25519>::from_hex(TEST_CURVE25519_PUBLIC_KEY);
+    cecies::result<cecies::private_key<cecies::curve25519>> private_key = cecies::private_key<cecies::curve25519>::from_hex(TEST_CURVE25519_PRIVATE_KEY);
+
+    cecies::result<cecies::encrypt_stream> stream = cecies::encrypt_stream::create(*public_key, CECIES_HEADER_FLAG_KEY_ID);
+    CHECK(stream.ok());
+
+    cecies::encrypt_stream s = std::move(*stream);
+
+    std::vector<std::uint8_t> ciphertext(s.header().begin(), s.header().end());
+    std::array<std::uint8_t, 64> chunk{};
+
+    const cecies::byte_span plaintext = cecies::as_bytes(TEST_STRING);
+    for (std::size_t offset = 0; offset < plaintext.size(); offset += 37)
+    {
+        const std::size_t n = std::min<std::size_t>(37, plaintext.size() - offset);
+        cecies::result<std::size_t> written = s.update(plaintext.subspan(offset, n), chunk);
+        CHECK(written.ok());
+        ciphertext.insert(ciphertext.end(), chunk.begin(), chunk.begin() + *written);
+    }
+
+    cecies::result<std::size_t> written = s.finish(chunk);
+    CHECK(written.ok());
+    ciphertext.insert(ciphertext.end(), chunk.begin(), chunk.begin() + *written);
+    std::memcpy(ciphertext.data(), s.header().data(), s.header().size());
+
+    cecies::result<cecies::buffer> decrypted = cecies::decrypt(ciphertext, *private_key);
+    CHECK(decrypted.ok());
+    CHECK(decrypted->as_string_view() == TEST_STRING);
+}
+
+#ifdef CECIES_TESTS_CORO
+
+/*
+ * Fire-and-forget coroutine: starts right away, frees itself when done.
+ */
+struct test_task
+{
+    struct promise_type
+    {
+        test_task get_return_object() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void() noexcept
+        {
+        }
+
+        void unhandled_exception() noexcept
+        {
+            std::terminate();
+        }
+    };
+};
+
+/*
+ * Executor that queues coroutines up for the thread that calls run().
+ */
+class run_loop
+{
+public:
+    void post(const std::coroutine_handle<> handle)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(handle);
+        cv_.notify_one();
+    }
+
+    void run(const int& remaining)
+    {
+        while (remaining > 0)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return !queue_.empty(); });
+            const std::coroutine_handle<> handle = queue_.front();
+            queue_.pop_front();
+            lock.unlock();
+            handle.resume();
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::coroutine_handle<>> queue_;
+};
+
+template <typename Curve>
+static test_task coro_roundtrip(const cecies::async_context context, const cecies::public_key<Curve>& public_key, const cecies::private_key<Curve>& private_key, const std::thread::id loop_thread, int& remaining)
+{
+    const cecies::byte_span plaintext = cecies::as_bytes(TEST_STRING);
+
+    cecies::result<cecies::buffer> encrypted = co_await cecies::encrypt(context, plaintext, public_key, cecies::encrypt_options{ 6, CECIES_HEADER_FLAG_KEY_ID });
+    CHECK(encrypted.ok());
+    CHECK(std::this_thread::get_id() == loop_thread);
+
+    cecies::result<cecies::buffer> decrypted = co_await cecies::decrypt(context, encrypted->bytes(), private_key);
+    CHECK(decrypted.ok());
+    CHECK(decrypted->as_string_view() == TEST_STRING);
+    CHECK(std::this_thread::get_id() == loop_thread);
+
+    encrypted->data()[encrypted->size() - 1] ^= 0x01;
+    decrypted = co_await cecies::decrypt(context, encrypted->bytes(), private_key);
+    CHECK(!decrypted.ok());
+
+    --remaining;
+}
+
+static void cecies_hpp_coro_roundtrip_resumes_on_executor()
+{
+    cecies::result<cecies::async_pool> pool = cecies::async_pool::create(2);
+    CHECK(pool.ok());
+
+    cecies::result<cecies::public_key<cecies::curve25519>> public_key = cecies::public_key<cecies::curve25519>::from_hex(TEST_CURVE25519_PUBLIC_KEY);
+    cecies::result<cecies::private_key<cecies::curve25519>> private_key = cecies::private_key<cecies::curve25519>::from_hex(TEST_CURVE25519_PRIVATE_KEY);
+    cecies::result<cecies::keypair<cecies::curve448>> keypair = cecies::generate_keypair<cecies::curve448>();
+
+    run_loop loop;
+    const cecies::async_context context{ pool->c(), cecies::executor_ref(loop), {} };
+
+    int remaining = 8;
+    for (int i = 0; i < 4; ++i)
+    {
+        coro_roundtrip(context, *public_key, *private_key, std::this_thread::get_id(), remaining);
+        coro_roundtrip(context, keypair->public_key, keypair->private_key, std::this_thread::get_id(), remaining);
+    }
+
+    loop.run(remaining);
+    CHECK(remaining == 0);
+}
+
+static test_task coro_batch(const cecies::async_context context, const cecies::public_key<cecies::curve25519>& public_key, const cecies::private_key<cecies::curve25519>& private_key, std::atomic<int>& remaining)
+{
+    std::vector<std::string> messages;
+    std::vector<cecies::byte_span> plaintexts;
+    for (int i = 0; i < 16; ++i)
+    {
+        messages.push_back(std::string(TEST_STRING) + std::to_string(i));
+    }
+    for (const std::string& message : messages)
+    {
+        plaintexts.push_back(cecies::as_bytes(message));
+    }
+
+    std::vector<cecies::result<cecies::buffer>> encrypted = co_await cecies::encrypt_batch(context, cecies::span<const cecies::byte_span>(plaintexts), public_key);
+    CHECK(encrypted.size() == messages.size());
+
+    std::vector<cecies::byte_span> ciphertexts;
+    for (const cecies::result<cecies::buffer>& e : encrypted)
+    {
+        CHECK(e.ok());
+        ciphertexts.push_back(e->bytes());
+    }
+
+    std::vector<cecies::result<cecies::buffer>> decrypted = co_await cecies::decrypt_batch(context, cecies::span<const cecies::byte_span>(ciphertexts), private_key);
+    CHECK(decrypted.size() == messages.size());
+
+    for (std::size_t i = 0; i < decrypted.size(); ++i)
+    {
+        CHECK(decrypted[i].ok() && decrypted[i]->as_string_view() == messages[i]);
+    }
+
+    CHECK((co_await cecies::decrypt_batch(context, cecies::span<const cecies::byte_span>(), private_key)).empty());
+
+    --remaining;
+}
+
+static test_task coro_batch_overflowing_queue(const cecies::async_context context, const cecies::public_key<cecies::curve25519>& public_key, std::atomic<int>& remaining)
+{
+    std::vector<cecies::byte_span> plaintexts(16, cecies::as_bytes(TEST_STRING));
+    int queue_full = 0;
+
+    for (const cecies::result<cecies::buffer>& e : co_await cecies::encrypt_batch(context, cecies::span<const cecies::byte_span>(plaintexts), public_key))
+    {
+        CHECK(e.ok() || e.error() == CECIES_ASYNC_ERROR_CODE_QUEUE_FULL);
+        queue_full += e.error() == CECIES_ASYNC_ERROR_CODE_QUEUE_FULL;
+    }
+
+    CHECK(queue_full > 0);
+    --remaining;
+}
+
+static void cecies_hpp_coro_batch_roundtrip()
+{
+    cecies::result<cecies::public_key<cecies::curve25519>> public_key = cecies::public_key<cecies::curve25519>::from_hex(TEST_CURVE25519_PUBLIC_KEY);
+    cecies::result<cecies::private_key<cecies::curve25519>> private_key = cecies::private_key<cecies::curve25519>::from_hex(TEST_CURVE25519_PRIVATE_KEY);
+
+    // Inline executor: the coroutines resume on the worker that completed the last job of each batch.
+    std::atomic<int> remaining = 2;
+
+    cecies::result<cecies::async_pool> pool = cecies::async_pool::create();
+    coro_batch(cecies::async_context{ pool->c(), {}, {} }, *public_key, *private_key, remaining);
+
+    // One worker and room for 8 queued jobs: a batch of 16 doesn't fit, the rest reports QUEUE_FULL.
+    cecies::result<cecies::async_pool> small_pool = cecies::async_pool::create(1, 8);
+    coro_batch_overflowing_queue(cecies::async_context{ small_pool->c(), {}, {} }, *public_key, remaining);
+
+    while (remaining.load() > 0)
+    {
+        std::this_thread::yield();
+    }
+}
+
+static test_task coro_stopped_before_start(const cecies::async_context context, const cecies::public_key<cecies::curve25519>& public_key, int& remaining)
+{
+    std::vector<cecies::byte_span> plaintexts(4, cecies::as_bytes(TEST_STRING));
+
+    CHECK(CECIES_ASYNC_ERROR_CODE_CANCELLED == (co_await cecies::encrypt(context, plaintexts[0], public_key)).error());
+    CHECK(CECIES_ASYNC_ERROR_CODE_NULL_ARG == (co_await cecies::encrypt(cecies::async_context{}, plaintexts[0], public_key)).error());
+
+    for (const cecies::result<cecies::buffer>& e : co_await cecies::encrypt_batch(context, cecies::span<const cecies::byte_span>(plaintexts), public_key))
+    {
+        CHECK(e.error() == CECIES_ASYNC_ERROR_CODE_CANCELLED);
+    }
+
+    --remaining;
+}
+
+static test_task coro_stopped_while_suspended(const cecies::async_context context, const cecies::public_key<cecies::curve25519>& public_key, int& cancelled, int& remaining)
+{
+    std::vector<cecies::byte_span> plaintexts(64, cecies::as_bytes(TEST_STRING));
+
+    for (const cecies::result<cecies::buffer>& e : co_await cecies::encrypt_batch(context, cecies::span<const cecies::byte_span>(plaintexts), public_key))
+    {
+        CHECK(e.ok() || e.error() == CECIES_ASYNC_ERROR_CODE_CANCELLED);
+        cancelled += e.error() == CECIES_ASYNC_ERROR_CODE_CANCELLED;
+    }
+
+    --remaining;
+}
+
+static void cecies_hpp_coro_cancellation()
+{
+    cecies::result<cecies::async_pool> pool = cecies::async_pool::create(1);
+    cecies::result<cecies::public_key<cecies::curve25519>> public_key = cecies::public_key<cecies::curve25519>::from_hex(TEST_CURVE25519_PUBLIC_KEY);
+
+    // Already stopped: nothing is submitted and the coroutine never suspends.
+    std::stop_source stopped;
+    stopped.request_stop();
+
+    int remaining = 1;
+    coro_stopped_before_start(cecies::async_context{ pool->c(), {}, stopped.get_token() }, *public_key, remaining);
+    CHECK(remaining == 0);
+
+    // Stopped while suspended: one worker for 64 jobs, so most of them are still queued up.
+    run_loop loop;
+    std::stop_source stop_source;
+    int cancelled = 0;
+
+    remaining = 1;
+    coro_stopped_while_suspended(cecies::async_context{ pool->c(), cecies::executor_ref(loop), stop_source.get_token() }, *public_key, cancelled, remaining);
+
+    stop_source.request_stop();
+    loop.run(remaining);
+    CHECK(cancelled > 0);
+}
+
+#endif // CECIES_TESTS_CORO
+
+int main()
+{
+    cecies_disable_fprintf();
+
+    cecies_hpp_keys_roundtrip();
+    cecies_hpp_key_parsing_and_moves();
+    cecies_hpp_encrypt_stream_roundtrip();
+
+#ifdef CECIES_TESTS_CORO
+    cecies_hpp_coro_roundtrip_resumes_on_executor();
+    cecies_hpp_coro_batch_roundtrip();
+    cecies_hpp_coro_cancellation();
+#endif
+
+    std::printf("%s: %d failed checks\n", failures == 0 ? "SUCCESS" : "FAILURE", failures);
+    return failures == 0 ? 0 : 1;
+}